@@ -6,9 +6,12 @@
  * Real SDK writes to __AIRegs (0xCC006C00) and __DSPRegs (0xCC005000).
  * We model these as observable arrays for trace test parity.
  * __AI_SRC_INIT (hardware timing calibration loop) is a no-op.
+ * With the virtual clock enabled, a started DMA raises the DMA callback once
+ * per block played, for as long as the start bit stays set.
  */
 #include <stdint.h>
 #include "ai.h"
+#include "../gc_clock.h"
 
 uint32_t gc_ai_regs[4];
 uint16_t gc_ai_dsp_regs[4];
@@ -30,10 +33,33 @@ void AIInitDMA(uint32_t addr, uint32_t length)
     gc_ai_dsp_regs[3] = (uint16_t)((gc_ai_dsp_regs[3] & ~0x7FFF) | (uint16_t)((length >> 5) & 0xFFFF));
 }
 
+static uint32_t s_ai_dma_event;
+
+static uint32_t ai_dma_bytes(void)
+{
+    return (uint32_t)(gc_ai_dsp_regs[3] & 0x7FFF) << 5;
+}
+
+/* Block done: the DSP reloads the same address/length and interrupts. */
+static void ai_clock_dma(void *ctx, uint32_t arg)
+{
+    (void)ctx;
+    (void)arg;
+    s_ai_dma_event = 0;
+    if ((gc_ai_dsp_regs[3] & 0x8000) == 0 || ai_dma_bytes() == 0) return;
+    s_ai_dma_event = gc_clock_schedule(GC_CLOCK_AI, gc_clock_now() + GC_CLOCK_AI_TICKS(ai_dma_bytes()),
+                                       0, ai_clock_dma, 0, 0);
+    if (gc_ai_dma_cb_ptr) ((AIDCallback)gc_ai_dma_cb_ptr)();
+}
+
 /* AIStartDMA (ai.c:47-50) — Set DMA start bit. */
 void AIStartDMA(void)
 {
     gc_ai_dsp_regs[3] |= 0x8000;
+    if (gc_clock_enabled() && !gc_clock_pending(s_ai_dma_event) && ai_dma_bytes() != 0) {
+        s_ai_dma_event = gc_clock_schedule(GC_CLOCK_AI, gc_clock_now() + GC_CLOCK_AI_TICKS(ai_dma_bytes()),
+                                           0, ai_clock_dma, 0, 0);
+    }
 }
 
 /* AIGetDMAStartAddr (ai.c:57-60) — Read DMA start address from DSP regs. */
@@ -5,10 +5,12 @@
  *
  * Same logic as decomp, but ARQRequest structs live in gc_mem (big-endian).
  * Queue pointers are GC addresses (u32, 0 = NULL).
- * ARStartDMA is mocked: records DMA params in a log.
+ * ARStartDMA is mocked: records DMA params in a log. With the virtual clock
+ * attached, it also schedules the completion interrupt.
  */
 #include <stdint.h>
 #include "arq.h"
+#include "../gc_clock.h"
 #include "../gc_mem.h"
 
 /* ── Big-endian u32 helpers ── */
@@ -42,6 +44,14 @@ static inline void req_set(uint32_t req, int field, uint32_t val)
 
 /* ── Mock ARStartDMA ── */
 
+static void arq_clock_done(void *ctx, uint32_t arg)
+{
+    port_ARQState *st = (port_ARQState *)ctx;
+    (void)arg;
+    st->dma_event = 0;
+    port_ARQInterruptServiceRoutine(st);
+}
+
 static void port_ARStartDMA(port_ARQState *st, uint32_t type,
                              uint32_t mainmem, uint32_t aram, uint32_t length)
 {
@@ -52,6 +62,20 @@ static void port_ARStartDMA(port_ARQState *st, uint32_t type,
         st->dma_log[st->dma_count].length  = length;
         st->dma_count++;
     }
+    if (st->clocked && gc_clock_enabled()) {
+        st->dma_event = gc_clock_schedule(GC_CLOCK_ARQ,
+                                          gc_clock_now() + GC_CLOCK_ARAM_TICKS(length),
+                                          0, arq_clock_done, st, 0);
+    }
+}
+
+void port_ARQAttachClock(port_ARQState *st, int on)
+{
+    st->clocked = on ? 1 : 0;
+    if (!st->clocked) {
+        gc_clock_cancel(st->dma_event);
+        st->dma_event = 0;
+    }
 }
 
 /* ── Init ── */
@@ -66,6 +90,8 @@ void port_ARQInit(port_ARQState *st)
     st->chunkSize = PORT_ARQ_CHUNK_SIZE_DEFAULT;
     st->dma_count = 0;
     st->callback_count = 0;
+    st->clocked = 0;
+    st->dma_event = 0;
 }
 
 /* ────────────────────────────────────────────────────────────────────
@@ -51,9 +51,15 @@ typedef struct {
     port_DMARecord dma_log[PORT_MAX_DMA];
     int            dma_count;
     int            callback_count;
+    /* Virtual clock (gc_clock.h): when set and the clock is enabled, every
+     * DMA schedules __ARQInterruptServiceRoutine for when it completes. */
+    int            clocked;
+    uint32_t       dma_event;
 } port_ARQState;
 
 void port_ARQInit(port_ARQState *st);
+/* After port_ARQInit; detaching cancels the DMA completion in flight. */
+void port_ARQAttachClock(port_ARQState *st, int on);
 void port_ARQPostRequest(port_ARQState *st, uint32_t req_addr,
                          uint32_t owner, uint32_t type, uint32_t priority,
                          uint32_t source, uint32_t dest,
@@ -9,6 +9,7 @@ typedef int32_t s32;
 // RAM-backed state (big-endian in MEM1) for dump comparability.
 #include "../sdk_state.h"
 #include "../gc_mem.h"
+#include "../gc_clock.h"
 
 u32 gc_dvd_initialized;
 u32 gc_dvd_drive_status;
@@ -238,13 +239,76 @@ int DVDRead(DVDFileInfo *file, void *addr, int len, int offset) {
     return (int)n;
 }
 
+// Virtual clock (gc_clock.h): async reads go through a one-command-at-a-time
+// drive. Each finishes GC_CLOCK_DVD_LATENCY plus transfer time after the
+// previous one; the copy and the callback happen at completion.
+enum { DVD_CLOCK_SLOTS = 16 };
+
+typedef struct {
+    DVDFileInfo *file;
+    void *addr;
+    s32 len;
+    s32 offset;
+    DVDCallback cb;
+    u32 event;
+} GcDvdPending;
+
+static GcDvdPending g_dvd_pending[DVD_CLOCK_SLOTS];
+static uint64_t g_dvd_drive_free;
+static u32 g_dvd_clock_epoch;
+
+static void dvd_clock_done(void *ctx, u32 slot) {
+    GcDvdPending *p = &g_dvd_pending[slot];
+    DVDFileInfo *file = p->file;
+    DVDCallback cb = p->cb;
+    int n;
+
+    (void)ctx;
+    p->file = 0;
+    n = DVDRead(file, p->addr, (int)p->len, (int)p->offset);
+    file->cb.state = 0;
+    if (cb) {
+        cb((n < 0) ? (s32)-1 : (s32)n, file);
+    }
+}
+
+static int dvd_clock_queue(DVDFileInfo *file, void *addr, s32 len, s32 offset, DVDCallback cb) {
+    uint64_t start, done;
+    u32 i;
+
+    if (g_dvd_clock_epoch != gc_clock_epoch()) {
+        g_dvd_clock_epoch = gc_clock_epoch();
+        g_dvd_drive_free = 0;
+    }
+    for (i = 0; i < DVD_CLOCK_SLOTS; i++) {
+        GcDvdPending *p = &g_dvd_pending[i];
+        if (p->file && gc_clock_pending(p->event)) continue;
+        start = gc_clock_now() > g_dvd_drive_free ? gc_clock_now() : g_dvd_drive_free;
+        done = start + GC_CLOCK_DVD_LATENCY + GC_CLOCK_DVD_TICKS(len > 0 ? len : 0);
+        p->event = gc_clock_schedule(GC_CLOCK_DVD, done, 0, dvd_clock_done, 0, i);
+        if (!p->event) return 0;
+        p->file = file;
+        p->addr = addr;
+        p->len = len;
+        p->offset = offset;
+        p->cb = cb;
+        g_dvd_drive_free = done;
+        return 1;
+    }
+    return 0;
+}
+
 // SDK signature: s32 DVDReadAsync(DVDFileInfo*, void*, s32, s32, DVDCallback)
 s32 DVDReadAsync(DVDFileInfo *file, void *addr, s32 len, s32 offset, DVDCallback cb) {
     if (!file || !addr) return 0;
 
-    // Mark "busy", do the copy immediately, then mark idle.
     file->cb.state = 1;
     gc_dvd_async_busy_seen = 1;
+    if (gc_clock_enabled() && dvd_clock_queue(file, addr, len, offset, cb)) {
+        return 1;
+    }
+
+    // Without the clock: do the copy immediately, then mark idle.
     int n = DVDRead(file, addr, (int)len, (int)offset);
     file->cb.state = 0;
 
@@ -283,7 +347,14 @@ s32 DVDCancel(DVDCommandBlock *block) {
         return 0;
     }
 
-    // Minimal deterministic port: force canceled state.
+    // Minimal deterministic port: force canceled state. A read still queued
+    // on the virtual clock is dropped without its callback.
+    for (u32 i = 0; i < DVD_CLOCK_SLOTS; i++) {
+        if (g_dvd_pending[i].file && &g_dvd_pending[i].file->cb == block &&
+            gc_clock_cancel(g_dvd_pending[i].event)) {
+            g_dvd_pending[i].file = 0;
+        }
+    }
     block->state = 10;
     return 0;
 }
@@ -3,6 +3,8 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "../gc_clock.h"
+
 // Minimal, deterministic EXI model for host testing.
 //
 // Scope: enough state/behavior for CARD stack unit tests and replay harnesses.
@@ -79,6 +81,9 @@ typedef struct GcExiControl {
 
 static GcExiControl s_ecb[MAX_CHAN];
 
+// Transfer-complete events of DMAs in flight on the virtual clock.
+static u32 s_exi_dma_event[MAX_CHAN];
+
 typedef struct GcExiCardProto {
   uint8_t cmd0;
   u32 addr;
@@ -124,6 +129,10 @@ EXICallback EXISetExiCallback(s32 channel, EXICallback callback) {
 }
 
 void EXIInit(void) {
+  for (int i = 0; i < MAX_CHAN; i++) {
+    gc_clock_cancel(s_exi_dma_event[i]);
+    s_exi_dma_event[i] = 0;
+  }
   memset(gc_exi_regs, 0, sizeof(gc_exi_regs));
   memset(s_ecb, 0, sizeof(s_ecb));
   memset(s_card, 0, sizeof(s_card));
@@ -323,6 +332,18 @@ BOOL EXIImmEx(s32 channel, void* buffer, s32 length, u32 type) {
   return TRUE;
 }
 
+static void exi_clock_tc(void* ctx, u32 channel) {
+  GcExiControl* exi = &s_ecb[channel];
+  (void)ctx;
+  s_exi_dma_event[channel] = 0;
+  exi->state &= ~EXI_STATE_DMA;
+  if (exi->tc_cb) {
+    EXICallback cb = exi->tc_cb;
+    exi->tc_cb = 0;
+    cb((s32)channel, 0);
+  }
+}
+
 BOOL EXIDma(s32 channel, void* buffer, s32 length, u32 type, EXICallback callback) {
   if (channel < 0 || channel >= MAX_CHAN) return FALSE;
   if (!buffer || length <= 0) return FALSE;
@@ -341,8 +362,19 @@ BOOL EXIDma(s32 channel, void* buffer, s32 length, u32 type, EXICallback callbac
   *regp(channel, 3) = exi_0cr(1u, 1u, type ? 1u : 0u, 0u);
 
   int ok = gc_exi_dma_hook(channel, s_card[channel].addr, buffer, length, type);
+  if (!ok) {
+    exi->state &= ~EXI_STATE_DMA;
+    return FALSE;
+  }
+
+  // With the virtual clock, the channel stays busy for the transfer time and
+  // the callback comes from the transfer-complete event.
+  if (gc_clock_enabled()) {
+    s_exi_dma_event[channel] = gc_clock_schedule(GC_CLOCK_EXI, gc_clock_now() + GC_CLOCK_EXI_TICKS(length),
+                                                 0, exi_clock_tc, 0, (u32)channel);
+    if (s_exi_dma_event[channel]) return TRUE;
+  }
   exi->state &= ~EXI_STATE_DMA;
-  if (!ok) return FALSE;
 
   // Deliver callback immediately (deterministic host model).
   if (exi->tc_cb) {
@@ -358,6 +390,9 @@ BOOL EXISync(s32 channel) {
     return FALSE;
   }
   GcExiControl* exi = &s_ecb[channel];
+  // A DMA in flight on the virtual clock: wait for its transfer-complete event.
+  while ((exi->state & EXI_STATE_DMA) && gc_clock_pending(s_exi_dma_event[channel]) && gc_clock_step()) {
+  }
   if ((exi->state & EXI_STATE_BUSY) == 0 && (exi->state & EXI_STATE_IMM) == 0) {
     // In our model, Sync without a pending transfer is OK.
     return TRUE;
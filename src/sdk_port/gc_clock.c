@@ -0,0 +1,296 @@
+#include "gc_clock.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Events live in a pool; a binary min-heap over (when, seq) orders the
+// queued ones. Ids carry the pool slot plus a generation so a stale id
+// never cancels a reused slot.
+
+enum { CLOCK_SLOT_BITS = 20, CLOCK_SLOT_MASK = (1u << CLOCK_SLOT_BITS) - 1u };
+
+typedef struct {
+    uint64_t when;
+    uint64_t seq;
+    uint64_t period;
+    gc_clock_fn fn;
+    void *ctx;
+    uint32_t arg;
+    uint32_t kind;
+    uint32_t gen;
+    int32_t pos; // heap position, -1 when not queued
+} ClockEvent;
+
+static int s_enabled;
+static uint32_t s_epoch;
+static uint64_t s_now;
+static uint64_t s_seq;
+
+static ClockEvent *s_ev;
+static uint32_t s_ev_cap;
+static uint32_t *s_free; // free pool slots (stack)
+static uint32_t s_free_count;
+static uint32_t *s_heap;
+static uint32_t s_heap_count;
+
+static gc_clock_source s_src[GC_CLOCK_MAX_SOURCES];
+static uint32_t s_src_count;
+
+static gc_clock_stats s_stats;
+
+static int ev_before(uint32_t a, uint32_t b) {
+    if (s_ev[a].when != s_ev[b].when) return s_ev[a].when < s_ev[b].when;
+    return s_ev[a].seq < s_ev[b].seq;
+}
+
+static void heap_set(uint32_t pos, uint32_t slot) {
+    s_heap[pos] = slot;
+    s_ev[slot].pos = (int32_t)pos;
+}
+
+static void heap_up(uint32_t pos) {
+    const uint32_t slot = s_heap[pos];
+    while (pos > 0) {
+        const uint32_t parent = (pos - 1u) / 2u;
+        if (!ev_before(slot, s_heap[parent])) break;
+        heap_set(pos, s_heap[parent]);
+        pos = parent;
+    }
+    heap_set(pos, slot);
+}
+
+static void heap_down(uint32_t pos) {
+    const uint32_t slot = s_heap[pos];
+    for (;;) {
+        uint32_t child = pos * 2u + 1u;
+        if (child >= s_heap_count) break;
+        if (child + 1u < s_heap_count && ev_before(s_heap[child + 1u], s_heap[child])) child++;
+        if (!ev_before(s_heap[child], slot)) break;
+        heap_set(pos, s_heap[child]);
+        pos = child;
+    }
+    heap_set(pos, slot);
+}
+
+static void heap_push(uint32_t slot) {
+    heap_set(s_heap_count++, slot);
+    heap_up(s_heap_count - 1u);
+    if (s_heap_count > s_stats.peak) s_stats.peak = s_heap_count;
+}
+
+static void heap_remove(uint32_t slot) {
+    const uint32_t pos = (uint32_t)s_ev[slot].pos;
+    const uint32_t last = s_heap[--s_heap_count];
+
+    s_ev[slot].pos = -1;
+    if (last == slot) return;
+    heap_set(pos, last);
+    heap_up(pos);
+    heap_down((uint32_t)s_ev[last].pos);
+}
+
+static void slot_release(uint32_t slot) {
+    s_ev[slot].gen = (s_ev[slot].gen + 1u) & (0xFFFFFFFFu >> CLOCK_SLOT_BITS);
+    s_free[s_free_count++] = slot;
+}
+
+static int pool_grow(void) {
+    const uint32_t cap = s_ev_cap ? s_ev_cap * 2u : 64u;
+    ClockEvent *ev;
+    uint32_t *fr, *hp, i;
+
+    if (cap > CLOCK_SLOT_MASK) return 0;
+    ev = (ClockEvent *)realloc(s_ev, cap * sizeof(*ev));
+    if (!ev) return 0;
+    s_ev = ev;
+    fr = (uint32_t *)realloc(s_free, cap * sizeof(*fr));
+    if (!fr) return 0;
+    s_free = fr;
+    hp = (uint32_t *)realloc(s_heap, cap * sizeof(*hp));
+    if (!hp) return 0;
+    s_heap = hp;
+    for (i = cap; i > s_ev_cap; i--) {
+        memset(&s_ev[i - 1u], 0, sizeof(*s_ev));
+        s_ev[i - 1u].pos = -1;
+        s_free[s_free_count++] = i - 1u;
+    }
+    s_ev_cap = cap;
+    return 1;
+}
+
+static int id_slot(uint32_t id, uint32_t *slot) {
+    const uint32_t s = (id & CLOCK_SLOT_MASK) - 1u;
+    if (id == 0 || s >= s_ev_cap) return 0;
+    if (s_ev[s].gen != id >> CLOCK_SLOT_BITS || s_ev[s].pos < 0) return 0;
+    *slot = s;
+    return 1;
+}
+
+static void drop_all(void) {
+    while (s_heap_count) {
+        const uint32_t slot = s_heap[s_heap_count - 1u];
+        heap_remove(slot);
+        slot_release(slot);
+    }
+    s_stats.queued = 0;
+}
+
+int gc_clock_enabled(void) { return s_enabled; }
+
+void gc_clock_enable(uint64_t start) {
+    drop_all();
+    s_enabled = 1;
+    s_epoch++;
+    s_now = start;
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+void gc_clock_disable(void) {
+    drop_all();
+    s_enabled = 0;
+    s_epoch++;
+}
+
+uint32_t gc_clock_epoch(void) { return s_epoch; }
+
+uint64_t gc_clock_now(void) { return s_now; }
+
+uint32_t gc_clock_schedule(uint32_t kind, uint64_t when, uint64_t period,
+                           gc_clock_fn fn, void *ctx, uint32_t arg) {
+    ClockEvent *e;
+    uint32_t slot;
+
+    if (!s_enabled || !fn) return 0;
+    if (!s_free_count && !pool_grow()) return 0;
+    slot = s_free[--s_free_count];
+    e = &s_ev[slot];
+    e->when = when < s_now ? s_now : when;
+    e->seq = s_seq++;
+    e->period = period;
+    e->fn = fn;
+    e->ctx = ctx;
+    e->arg = arg;
+    e->kind = kind < GC_CLOCK_KINDS ? kind : GC_CLOCK_USER;
+    heap_push(slot);
+    s_stats.queued = s_heap_count;
+    return (e->gen << CLOCK_SLOT_BITS) | (slot + 1u);
+}
+
+int gc_clock_cancel(uint32_t id) {
+    uint32_t slot;
+    if (!id_slot(id, &slot)) return 0;
+    heap_remove(slot);
+    slot_release(slot);
+    s_stats.queued = s_heap_count;
+    return 1;
+}
+
+int gc_clock_pending(uint32_t id) {
+    uint32_t slot;
+    return id_slot(id, &slot);
+}
+
+int gc_clock_add_source(const gc_clock_source *src) {
+    if (!src || !src->next || !src->fire) return -1;
+    gc_clock_remove_source(src->ctx);
+    if (s_src_count >= GC_CLOCK_MAX_SOURCES) return -1;
+    s_src[s_src_count++] = *src;
+    return 0;
+}
+
+void gc_clock_remove_source(void *ctx) {
+    uint32_t i;
+    for (i = 0; i < s_src_count; i++) {
+        if (s_src[i].ctx == ctx) {
+            s_src[i] = s_src[--s_src_count];
+            return;
+        }
+    }
+}
+
+// Earliest source due time; *which gets its index (or -1).
+static uint64_t source_next(int *which) {
+    uint64_t best = GC_CLOCK_NEVER;
+    uint32_t i;
+
+    *which = -1;
+    for (i = 0; i < s_src_count; i++) {
+        uint64_t t = s_src[i].next(s_src[i].ctx);
+        if (t < s_now) t = s_now;
+        if (t < best) {
+            best = t;
+            *which = (int)i;
+        }
+    }
+    return best;
+}
+
+uint64_t gc_clock_next(void) {
+    int which;
+    const uint64_t src = source_next(&which);
+    const uint64_t ev = s_heap_count ? s_ev[s_heap[0]].when : GC_CLOCK_NEVER;
+    return ev <= src ? ev : src;
+}
+
+// Fire the first thing due at or before `limit`. Queued events win ties.
+static int fire_one(uint64_t limit) {
+    int which;
+    uint64_t src, ev;
+
+    if (!s_enabled) return 0;
+    src = source_next(&which);
+    ev = s_heap_count ? s_ev[s_heap[0]].when : GC_CLOCK_NEVER;
+    if (s_heap_count && ev <= src && ev <= limit) {
+        const uint32_t slot = s_heap[0];
+        ClockEvent *e = &s_ev[slot];
+        const gc_clock_fn fn = e->fn;
+        void *ctx = e->ctx;
+        const uint32_t arg = e->arg;
+
+        s_now = ev;
+        s_stats.steps++;
+        s_stats.fired[e->kind]++;
+        if (e->period) {
+            e->when += e->period;
+            e->seq = s_seq++;
+            heap_down(0);
+        } else {
+            heap_remove(slot);
+            slot_release(slot);
+        }
+        s_stats.queued = s_heap_count;
+        fn(ctx, arg);
+        return 1;
+    }
+    if (which >= 0 && src <= limit) {
+        const gc_clock_source s = s_src[which];
+        s_now = src;
+        s_stats.steps++;
+        s_stats.fired[s.kind < GC_CLOCK_KINDS ? s.kind : GC_CLOCK_USER]++;
+        s.fire(s.ctx, src);
+        return 1;
+    }
+    return 0;
+}
+
+int gc_clock_step(void) {
+    return fire_one(GC_CLOCK_NEVER);
+}
+
+uint32_t gc_clock_run_until(uint64_t when) {
+    uint32_t n = 0;
+
+    if (!s_enabled) return 0;
+    while (fire_one(when)) n++;
+    if (s_enabled && when > s_now) s_now = when;
+    return n;
+}
+
+uint32_t gc_clock_advance(uint64_t ticks) {
+    const uint64_t when = s_now + ticks < s_now ? GC_CLOCK_NEVER : s_now + ticks;
+    return gc_clock_run_until(when);
+}
+
+void gc_clock_get_stats(gc_clock_stats *out) {
+    if (out) *out = s_stats;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stdint.h>
+
+// Virtual timebase and discrete-event scheduler for sdk_port.
+//
+// One clock at the console's timer rate (bus clock / 4) stands in for
+// OSGetTime / __OSGetSystemTime, and one event queue completes everything
+// the ports used to finish on the spot: alarms, VI retrace, SI polling,
+// DVD / ARQ / AI DMA and EXI transfers.
+//
+// The clock is off by default, and every port keeps its old deterministic
+// fake (counting stopwatch ticks, PAD time 0, the SI time seed, immediate
+// callbacks), so the retail-trace scenarios are unaffected. gc_clock_enable
+// switches the ports over. Time then only moves when the host says so
+// (gc_clock_advance / gc_clock_run_until) or when a port waits for
+// something (VIWaitForRetrace, EXISync); either way the clock jumps straight
+// to the next event instead of counting ticks.
+//
+// Events due at the same tick fire in the order they were scheduled. A
+// source (a port-owned ordered queue such as the OSAlarm list, polled for
+// its next due time) fires after the queued events of that tick.
+
+#define GC_CLOCK_HZ    (162000000u / 4u) // 40,500,000 ticks per second
+#define GC_CLOCK_NEVER UINT64_MAX
+
+#define GC_CLOCK_MS_TO_TICKS(ms) ((uint64_t)(ms) * (GC_CLOCK_HZ / 1000u))
+#define GC_CLOCK_US_TO_TICKS(us) ((uint64_t)(us) * (GC_CLOCK_HZ / 125000u) / 8u)
+
+// Modeled device rates. These set when a completion lands, not what it
+// produces; they are round figures for retail hardware, not cycle counts.
+#define GC_CLOCK_VI_FIELD_NTSC ((uint64_t)GC_CLOCK_HZ * 1001u / 60000u) // 59.94 Hz
+#define GC_CLOCK_VI_FIELD_PAL  ((uint64_t)GC_CLOCK_HZ / 50u)
+#define GC_CLOCK_DVD_LATENCY   GC_CLOCK_MS_TO_TICKS(1)                     // command + seek
+#define GC_CLOCK_DVD_TICKS(n)  ((uint64_t)(n) * 27u / 2u)                  // ~3 MB/s
+#define GC_CLOCK_ARAM_TICKS(n) (((uint64_t)(n) + 1u) / 2u)                 // ~81 MB/s
+#define GC_CLOCK_EXI_TICKS(n)  ((uint64_t)(n) * 81u / 4u)                  // 16 MHz serial, ~2 MB/s
+#define GC_CLOCK_AI_TICKS(n)   ((uint64_t)(n) * GC_CLOCK_HZ / 128000u)     // 32 kHz stereo s16
+
+// Event kinds, for statistics.
+enum {
+    GC_CLOCK_USER,
+    GC_CLOCK_ALARM,
+    GC_CLOCK_VI,
+    GC_CLOCK_SI,
+    GC_CLOCK_DVD,
+    GC_CLOCK_ARQ,
+    GC_CLOCK_AI,
+    GC_CLOCK_EXI,
+    GC_CLOCK_KINDS
+};
+
+typedef void (*gc_clock_fn)(void *ctx, uint32_t arg);
+
+int gc_clock_enabled(void);
+// Start the clock at tick `start`. Drops all queued events; sources stay.
+void gc_clock_enable(uint64_t start);
+// Back to the per-port fakes. Queued events are dropped without firing.
+void gc_clock_disable(void);
+// Bumped by every enable/disable, so ports can tell their queued events
+// were dropped and need re-arming.
+uint32_t gc_clock_epoch(void);
+
+uint64_t gc_clock_now(void);
+
+// Queue fn(ctx, arg) at tick `when` (clamped to now). A nonzero period
+// re-queues the event every period ticks until cancelled. Returns an event
+// id, or 0 if the clock is off or out of memory.
+uint32_t gc_clock_schedule(uint32_t kind, uint64_t when, uint64_t period,
+                           gc_clock_fn fn, void *ctx, uint32_t arg);
+// Returns 1 if the event was still queued.
+int gc_clock_cancel(uint32_t id);
+int gc_clock_pending(uint32_t id);
+
+// A source owns an ordered queue of its own. next() returns its earliest
+// due tick (GC_CLOCK_NEVER when idle); fire() runs everything due at `now`.
+typedef struct {
+    uint32_t kind;
+    uint64_t (*next)(void *ctx);
+    void (*fire)(void *ctx, uint64_t now);
+    void *ctx;
+} gc_clock_source;
+
+#define GC_CLOCK_MAX_SOURCES 4
+
+int gc_clock_add_source(const gc_clock_source *src); // 0, or -1 if full
+void gc_clock_remove_source(void *ctx);
+
+// Earliest due tick over events and sources (GC_CLOCK_NEVER if none).
+uint64_t gc_clock_next(void);
+// Jump to the earliest due tick and fire the first thing due there (one
+// event, or one source firing). Returns 0 when nothing is pending; time
+// does not move then.
+int gc_clock_step(void);
+// Fire everything due up to `when` in order, then leave the clock at `when`.
+// Returns the number of events and source firings.
+uint32_t gc_clock_run_until(uint64_t when);
+uint32_t gc_clock_advance(uint64_t ticks);
+
+typedef struct {
+    uint64_t fired[GC_CLOCK_KINDS]; // per kind; sources count one per firing
+    uint64_t steps;                 // jumps to a due tick
+    uint64_t queued;                // events currently queued
+    uint64_t peak;                  // most events ever queued at once
+} gc_clock_stats;
+
+void gc_clock_get_stats(gc_clock_stats *out);
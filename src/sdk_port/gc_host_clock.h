@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+// Host monotonic time in nanoseconds, for profiling hooks that measure what
+// the port itself costs (thread traces, stopwatch and overlay timings). It
+// has nothing to do with the console timebase in gc_clock.h.
+static inline uint64_t gc_host_ns(void) {
+  struct timespec ts;
+#if defined(_WIN32)
+  timespec_get(&ts, TIME_UTC);
+#else
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
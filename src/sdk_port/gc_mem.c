@@ -4,10 +4,18 @@ static uint32_t g_base;
 static size_t g_size;
 static uint8_t *g_buf;
 
+enum { GC_MEM_MAX_WRITE_HOOKS = 4 };
+static gc_mem_write_hook g_write_hooks[GC_MEM_MAX_WRITE_HOOKS];
+static int g_write_hook_count;
+
+int (*gc_mem_write_defer)(uint32_t addr, size_t len);
+
 void gc_mem_set(uint32_t base, size_t size, uint8_t *buf) {
     g_base = base;
     g_size = size;
     g_buf = buf;
+    // A new backing buffer invalidates anything derived from the old one.
+    gc_mem_notify_write(base, size);
 }
 
 uint8_t *gc_mem_ptr(uint32_t addr, size_t len) {
@@ -18,3 +26,26 @@ uint8_t *gc_mem_ptr(uint32_t addr, size_t len) {
     return &g_buf[off];
 }
 
+int gc_mem_add_write_hook(gc_mem_write_hook fn) {
+    int i;
+    if (!fn) return -1;
+    for (i = 0; i < g_write_hook_count; i++) {
+        if (g_write_hooks[i] == fn) return 0;
+    }
+    if (g_write_hook_count >= GC_MEM_MAX_WRITE_HOOKS) return -1;
+    g_write_hooks[g_write_hook_count++] = fn;
+    return 0;
+}
+
+void gc_mem_notify_write(uint32_t addr, size_t len) {
+    if (len == 0) return;
+    if (gc_mem_write_defer && gc_mem_write_defer(addr, len)) return;
+    gc_mem_run_write_hooks(addr, len);
+}
+
+void gc_mem_run_write_hooks(uint32_t addr, size_t len) {
+    int i;
+    for (i = 0; i < g_write_hook_count; i++) {
+        g_write_hooks[i](addr, len);
+    }
+}
@@ -9,3 +9,17 @@
 void gc_mem_set(uint32_t base, size_t size, uint8_t *buf);
 uint8_t *gc_mem_ptr(uint32_t addr, size_t len);
 
+// Write notification for host-side caches derived from RAM contents (e.g. the
+// GX display list cache). We cannot trap plain stores into the backing buffer,
+// so producers of "the GP may now see new bytes" events (DCFlushRange,
+// DCStoreRangeNoSync, DCInvalidateRange, GX display list writes) report the
+// touched range here.
+typedef void (*gc_mem_write_hook)(uint32_t addr, size_t len);
+
+int gc_mem_add_write_hook(gc_mem_write_hook fn);
+void gc_mem_notify_write(uint32_t addr, size_t len);
+
+// Set while a GP consumer thread runs (gx_fifo.c): it may take a notification
+// (return nonzero) and run the hooks itself, in command-stream order.
+extern int (*gc_mem_write_defer)(uint32_t addr, size_t len);
+void gc_mem_run_write_hooks(uint32_t addr, size_t len);
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Array-backed treap shared by the host-side indexes of sdk_port (OSAlloc's
+// free-cell index, OSAlarm's queue index).
+//
+// Nodes live in one caller-owned array and name each other by index (-1 =
+// none), so the array can be realloc'd and node numbers stay valid. Each
+// node embeds a gc_treap_link; the gc_treap describes where it sits and how
+// nodes are ordered. Split and merge keep heap order on prio and call pull
+// (if set) on every node whose children changed, for subtree aggregates.
+
+typedef struct {
+  uint32_t prio;
+  int32_t left;
+  int32_t right;
+} gc_treap_link;
+
+typedef struct {
+  uint8_t *nodes; // node array; refresh after growing it
+  size_t stride;  // bytes per node
+  size_t link;    // offset of the gc_treap_link in a node
+  // Nonzero if node sorts before key (key is whatever the caller splits on).
+  int (*before)(const void *node, const void *key);
+  void (*pull)(void *nodes, int32_t t);
+} gc_treap;
+
+static inline gc_treap_link *gc_treap_at(const gc_treap *tr, int32_t t) {
+  return (gc_treap_link *)(tr->nodes + (size_t)t * tr->stride + tr->link);
+}
+
+// Well-mixed priority from a per-node seed (address, sequence number).
+static inline uint32_t gc_treap_prio(uint32_t seed) {
+  uint32_t h = seed * 0x9E3779B1u;
+  h ^= h >> 15;
+  h *= 0x85EBCA77u;
+  h ^= h >> 13;
+  return h;
+}
+
+// Split t into nodes before key (*l) and the rest (*r).
+static inline void gc_treap_split(const gc_treap *tr, int32_t t, const void *key, int32_t *l, int32_t *r) {
+  if (t < 0) {
+    *l = *r = -1;
+    return;
+  }
+  gc_treap_link *n = gc_treap_at(tr, t);
+  if (tr->before(tr->nodes + (size_t)t * tr->stride, key)) {
+    gc_treap_split(tr, n->right, key, &n->right, r);
+    *l = t;
+  } else {
+    gc_treap_split(tr, n->left, key, l, &n->left);
+    *r = t;
+  }
+  if (tr->pull) tr->pull(tr->nodes, t);
+}
+
+// Join two treaps where every node of a sorts before every node of b.
+static inline int32_t gc_treap_merge(const gc_treap *tr, int32_t a, int32_t b) {
+  if (a < 0) return b;
+  if (b < 0) return a;
+  gc_treap_link *na = gc_treap_at(tr, a), *nb = gc_treap_at(tr, b);
+  if (na->prio > nb->prio) {
+    na->right = gc_treap_merge(tr, na->right, b);
+    if (tr->pull) tr->pull(tr->nodes, a);
+    return a;
+  }
+  nb->left = gc_treap_merge(tr, a, nb->left);
+  if (tr->pull) tr->pull(tr->nodes, b);
+  return b;
+}
@@ -59,6 +59,18 @@ typedef enum {
 // RAM-backed state (big-endian in MEM1) for dump comparability.
 #include "../sdk_state.h"
 
+#include <stdlib.h>
+#include "gx_gp.h"
+#include "gx_dl.h"
+#include "gx_state.h"
+#include "gx_vtx.h"
+#include "gx_raster.h"
+#include "gx_texcopy.h"
+#include "gx_xfb.h"
+#include "gx_tmem.h"
+#include "gx_trace.h"
+#include "gx_fifo.h"
+
 // Minimal GX state mirror. We only model fields asserted by our deterministic tests.
 u32 gc_gx_in_disp_list;
 u32 gc_gx_dl_save_context;
@@ -121,8 +133,14 @@ u32 gc_gx_copy_filter_aa;
 u32 gc_gx_copy_filter_vf;
 u32 gc_gx_copy_filter_sample_hash;
 u32 gc_gx_copy_filter_vfilter_hash;
+// Display copy inputs consumed by GXCopyDisp (gx_xfb.c).
+u8 gc_gx_copy_vfilter[7] = { 0, 0, 21, 22, 21, 0, 0 };
+u32 gc_gx_copy_yscale = 0x100u;
+u32 gc_gx_copy_clamp;
 u32 gc_gx_pixel_fmt;
 u32 gc_gx_z_fmt;
+u32 gc_gx_dst_alpha_enable;
+u32 gc_gx_dst_alpha;
 u32 gc_gx_copy_disp_dest;
 u32 gc_gx_copy_disp_clear;
 u32 gc_gx_copy_gamma;
@@ -139,8 +157,8 @@ u32 gc_gx_copy_clear_reg2;
 // Current matrix index observable (GXSetCurrentMtx updates matIdxA + XF reg 24).
 u32 gc_gx_mat_idx_a;
 
-// Draw-done shim (GXSetDrawDone/GXWaitDrawDone). We do not emulate PE finish interrupts,
-// only the observable register writes and a deterministic completion flag for tests.
+// Draw-done state (GXSetDrawDone/GXWaitDrawDone). The PE finish interrupt latches in the
+// FIFO (gx_fifo.c) and sets the flag when the CPU syncs with the GP (gx_sync).
 u32 gc_gx_set_draw_done_calls;
 u32 gc_gx_wait_draw_done_calls;
 u32 gc_gx_draw_done_flag;
@@ -156,11 +174,14 @@ u32 gc_gx_fogclr;
 u32 gc_gx_proj_type;
 u32 gc_gx_proj_mtx_bits[6];
 
-// GX metric state (software mirror). Real hardware accumulates counters; for now we model
-// only what our deterministic tests assert and what MP4 callsites depend on.
+// GX metric state (GXPerf.c). perf0/perf1 and vcache_sel are the selected
+// metrics; the rest are the counters the GXRead*Metric calls return, fed
+// from the pipeline's running totals (see gx_perf_sync).
 u32 gc_gx_gp_perf0;
 u32 gc_gx_gp_perf1;
 u32 gc_gx_vcache_sel;
+u32 gc_gx_gp_metric[2];
+u32 gc_gx_vcache_metrics[3];    // check, miss, stall
 u32 gc_gx_pix_metrics[6];
 u32 gc_gx_mem_metrics[10];
 
@@ -234,6 +255,7 @@ u32 gc_gx_texcoord2s16_t;
 
 // Token / draw sync state (GXManage).
 uintptr_t gc_gx_token_cb_ptr;
+uintptr_t gc_gx_draw_done_cb_ptr;
 u32 gc_gx_last_draw_sync_token;
 
 // Minimal FIFO write mirror for deterministic transform tests.
@@ -283,8 +305,18 @@ u32 gc_gx_dl_count;
 u32 gc_gx_call_dl_list;
 u32 gc_gx_call_dl_nbytes;
 
+// GXFifo.c:__GXFifoObj layout; GXInit fills it from the FIFO (gx_fifo.c).
 typedef struct {
-    uint8_t _dummy;
+    void *base;
+    void *top;
+    u32 size;
+    u32 hiWatermark;
+    u32 loWatermark;
+    void *rdPtr;
+    void *wrPtr;
+    s32 count;
+    u8 bind_cpu;
+    u8 bind_gp;
 } GXFifoObj;
 
 static GXFifoObj s_fifo_obj;
@@ -295,12 +327,358 @@ static inline u32 set_field(u32 reg, u32 size, u32 shift, u32 v) {
     return (reg & ~mask) | ((v << shift) & mask);
 }
 
+// -----------------------------------------------------------------------------
+// Command stream (GX_WRITE_* macros in __gx.h)
+//
+// Register writes and vertex data are serialized into the same big-endian byte
+// stream the SDK puts in the FIFO. Inside GXBeginDisplayList the bytes go into
+// the list buffer in RAM; otherwise they go into the CPU/GP FIFO (gx_fifo.c),
+// which hands them to the GP model (gx_gp.c) at GXEnd and at flush points.
+// -----------------------------------------------------------------------------
+
+static u32 s_gx_in_begin;
+static u32 s_gx_dl_overflow;
+
+// Trace recorder (gx_trace.c); NULL unless a recording is running.
+void (*gc_gx_trace_hook)(uint32_t type, const void *data, uint32_t size);
+
+static void gx_fifo_bytes(const u8 *p, u32 n) {
+    if (gc_gx_in_disp_list) {
+        u8 *dst;
+        if (s_gx_dl_overflow || gc_gx_dl_count + n > gc_gx_dl_size) {
+            s_gx_dl_overflow = 1;
+            return;
+        }
+        dst = gc_mem_ptr(gc_gx_dl_base + gc_gx_dl_count, n);
+        if (!dst) {
+            s_gx_dl_overflow = 1;
+            return;
+        }
+        __builtin_memcpy(dst, p, n);
+        gc_gx_dl_count += n;
+        return;
+    }
+    gc_gx_fifo_write(p, n);
+}
+
+static inline void gx_fifo_u8(u32 v) {
+    const u8 b = (u8)v;
+    gx_fifo_bytes(&b, 1);
+}
+
+static inline void gx_fifo_u16(u32 v) {
+    const u8 b[2] = { (u8)(v >> 8), (u8)v };
+    gx_fifo_bytes(b, 2);
+}
+
+static inline void gx_fifo_u32(u32 v) {
+    const u8 b[4] = { (u8)(v >> 24), (u8)(v >> 16), (u8)(v >> 8), (u8)v };
+    gx_fifo_bytes(b, 4);
+}
+
+static inline void gx_fifo_f32(f32 f) {
+    u32 u;
+    __builtin_memcpy(&u, &f, sizeof(u));
+    gx_fifo_u32(u);
+}
+
+static inline void gx_fifo_cp(u32 addr, u32 v) {
+    const u8 b[6] = { 0x08u, (u8)addr, (u8)(v >> 24), (u8)(v >> 16), (u8)(v >> 8), (u8)v };
+    gx_fifo_bytes(b, 6);
+}
+
+static inline void gx_fifo_xf(u32 addr, u32 v) {
+    const u8 b[9] = { 0x10u, 0x00u, 0x00u, (u8)(addr >> 8), (u8)addr,
+                      (u8)(v >> 24), (u8)(v >> 16), (u8)(v >> 8), (u8)v };
+    gx_fifo_bytes(b, 9);
+}
+
+// -----------------------------------------------------------------------------
+// Dirty state (GXInit.c:__GXSetDirtyState, see gx_state.h)
+//
+// BP/XF state registers are staged per register and flushed only when a draw,
+// list boundary or state-consuming command needs them. s_gx_*_sent is what the
+// stream currently carries; a register whose "known" bit is clear is always
+// resent (start of a display list, after one is called, after GXInit).
+// -----------------------------------------------------------------------------
+
+u32 gc_gx_state_coalesce = 1;
+u32 gc_gx_state_writes;
+u32 gc_gx_state_elim;
+u32 gc_gx_bp_elim[256];
+u32 gc_gx_xf_elim[GC_GX_XF_REG_COUNT];
+
+#define GX_XF_WORDS ((GC_GX_XF_REG_COUNT + 31u) / 32u)
+
+static u32 s_gx_bp_pend[256];
+static u32 s_gx_bp_sent[256];
+static u32 s_gx_bp_dirty[8];
+static u32 s_gx_bp_known[8];
+static u32 s_gx_bp_masked;
+static u32 s_gx_xf_pend[GC_GX_XF_REG_COUNT];
+static u32 s_gx_xf_sent[GC_GX_XF_REG_COUNT];
+static u32 s_gx_xf_dirty[GX_XF_WORDS];
+static u32 s_gx_xf_known[GX_XF_WORDS];
+
+// Vertex loader state last serialized into the stream. GXBegin/GXCallDisplayList
+// send only what changed since (the SDK uses dirtyState bits for this; our
+// dirtyState mirror is asserted by tests, so the stream keeps its own copy).
+static u32 s_gx_sent_valid;
+static u32 s_gx_sent_vcd_lo;
+static u32 s_gx_sent_vcd_hi;
+static u32 s_gx_sent_vat[8][3];
+
+void gc_gx_state_reset_counters(void) {
+    gc_gx_state_writes = 0;
+    gc_gx_state_elim = 0;
+    __builtin_memset(gc_gx_bp_elim, 0, sizeof(gc_gx_bp_elim));
+    __builtin_memset(gc_gx_xf_elim, 0, sizeof(gc_gx_xf_elim));
+}
+
+// Forget what the stream carries; every register is resent on next use.
+static void gx_state_forget(void) {
+    __builtin_memset(s_gx_bp_known, 0, sizeof(s_gx_bp_known));
+    __builtin_memset(s_gx_xf_known, 0, sizeof(s_gx_xf_known));
+    s_gx_sent_valid = 0;
+}
+
+// BP registers that act as commands rather than state: they must reach the
+// stream in program order, after everything staged before them.
+static inline u32 gx_bp_is_command(u32 id) {
+    switch (id) {
+    case 0x0Fu:             // IND_IMASK (SDK uses it as a pipe flush around loads)
+    case 0x45u:             // PE_DONE
+    case 0x47u:             // PE_TOKEN_INT
+    case 0x48u:             // PE_TOKEN
+    case 0x52u:             // PE_COPY_EXECUTE
+    case 0x55u: case 0x56u: // bounding box reset
+    case 0x63u:             // TMEM preload trigger
+    case 0x64u: case 0x65u: // TLUT load
+    case 0x66u:             // texture cache invalidate
+    case 0x67u:             // perf metric select/clear
+    case 0xFEu:             // BP write mask
+        return 1;
+    default:
+        // TEV color/konst registers share ids and the SDK repeats BG writes
+        // as a hardware workaround; never merge them.
+        return id >= 0xE0u && id <= 0xE7u;
+    }
+}
+
+static inline void gx_bp_emit(u32 v) {
+    const u8 b[5] = { 0x61u, (u8)(v >> 24), (u8)(v >> 16), (u8)(v >> 8), (u8)v };
+    gx_fifo_bytes(b, 5);
+}
+
+static void gx_bp_stage(u32 v) {
+    const u32 id = v >> 24;
+    const u32 bit = 1u << (id & 31u);
+    u32 *dirty = &s_gx_bp_dirty[id >> 5];
+
+    gc_gx_state_writes++;
+    if (!gc_gx_state_coalesce) {
+        gx_bp_emit(v);
+        s_gx_bp_sent[id] = v;
+        s_gx_bp_known[id >> 5] |= bit;
+        return;
+    }
+    if (*dirty & bit) {
+        // The pending value never reaches the stream.
+        gc_gx_bp_elim[id]++;
+        gc_gx_state_elim++;
+        *dirty &= ~bit;
+    }
+    if ((s_gx_bp_known[id >> 5] & bit) && s_gx_bp_sent[id] == v) {
+        gc_gx_bp_elim[id]++;
+        gc_gx_state_elim++;
+        return;
+    }
+    s_gx_bp_pend[id] = v;
+    *dirty |= bit;
+}
+
+// A mirror that carries its id went out through its setter already.
+static void gx_bp_stage_unstamped(u32 id, u32 mirror) {
+    if ((mirror >> 24) != id) gx_bp_stage((id << 24) | (mirror & 0xFFFFFFu));
+}
+
+static void gx_xf_stage(u32 idx, u32 v) {
+    const u32 bit = 1u << (idx & 31u);
+    u32 *dirty = &s_gx_xf_dirty[idx >> 5];
+
+    gc_gx_state_writes++;
+    if (!gc_gx_state_coalesce) {
+        gx_fifo_xf(0x1000u + idx, v);
+        s_gx_xf_sent[idx] = v;
+        s_gx_xf_known[idx >> 5] |= bit;
+        return;
+    }
+    if (*dirty & bit) {
+        gc_gx_xf_elim[idx]++;
+        gc_gx_state_elim++;
+        *dirty &= ~bit;
+    }
+    if ((s_gx_xf_known[idx >> 5] & bit) && s_gx_xf_sent[idx] == v) {
+        gc_gx_xf_elim[idx]++;
+        gc_gx_state_elim++;
+        return;
+    }
+    s_gx_xf_pend[idx] = v;
+    *dirty |= bit;
+}
+
+static void gx_flush_regs(void) {
+    u32 w;
+
+    for (w = 0; w < 8u; w++) {
+        u32 m = s_gx_bp_dirty[w];
+        s_gx_bp_dirty[w] = 0;
+        s_gx_bp_known[w] |= m;
+        while (m != 0) {
+            const u32 id = w * 32u + (u32)__builtin_ctz(m);
+            m &= m - 1u;
+            gx_bp_emit(s_gx_bp_pend[id]);
+            s_gx_bp_sent[id] = s_gx_bp_pend[id];
+        }
+    }
+
+    // Runs of consecutive dirty XF registers go out as one multi-word load.
+    for (w = 0; w < GC_GX_XF_REG_COUNT;) {
+        u32 first, n, i;
+        if (!((s_gx_xf_dirty[w >> 5] >> (w & 31u)) & 1u)) {
+            w++;
+            continue;
+        }
+        first = w;
+        while (w < GC_GX_XF_REG_COUNT && ((s_gx_xf_dirty[w >> 5] >> (w & 31u)) & 1u)) {
+            s_gx_xf_dirty[w >> 5] &= ~(1u << (w & 31u));
+            s_gx_xf_known[w >> 5] |= 1u << (w & 31u);
+            s_gx_xf_sent[w] = s_gx_xf_pend[w];
+            w++;
+        }
+        n = w - first;
+        {
+            const u32 hdr = ((n - 1u) << 16) | (0x1000u + first);
+            const u8 b[5] = { 0x10u, (u8)(hdr >> 24), (u8)(hdr >> 16), (u8)(hdr >> 8), (u8)hdr };
+            gx_fifo_bytes(b, 5);
+        }
+        for (i = first; i < w; i++) {
+            gx_fifo_u32(s_gx_xf_sent[i]);
+        }
+    }
+}
+
 static inline void gx_write_ras_reg(u32 v) {
     // Deterministic mirror of "last written" BP/RAS register value.
     gc_gx_last_ras_reg = v;
+    const u32 id = v >> 24;
+    if (s_gx_bp_masked) {
+        // Must directly follow the mask write. Only some bits change, so the
+        // full register value is no longer known.
+        gx_bp_emit(v);
+        s_gx_bp_known[id >> 5] &= ~(1u << (id & 31u));
+        s_gx_bp_masked = 0;
+    } else if (gx_bp_is_command(id)) {
+        gx_flush_regs();
+        gx_bp_emit(v);
+        s_gx_bp_masked = (id == 0xFEu);
+    } else {
+        gx_bp_stage(v);
+    }
+}
+
+static void gx_flush_vtx_state(void) {
+    u32 i;
+    if (!s_gx_sent_valid || s_gx_sent_vcd_lo != gc_gx_vcd_lo || s_gx_sent_vcd_hi != gc_gx_vcd_hi) {
+        // GXAttr.c:__GXSetVCD + __GXXfVtxSpecs.
+        u32 n_cols = 0, n_nrm, n_tex = 0;
+        gx_fifo_cp(0x50u, gc_gx_vcd_lo);
+        gx_fifo_cp(0x60u, gc_gx_vcd_hi);
+        if ((gc_gx_vcd_lo >> 13) & 3u) n_cols++;
+        if ((gc_gx_vcd_lo >> 15) & 3u) n_cols++;
+        n_nrm = gc_gx_has_binrms ? 2u : (gc_gx_has_nrms ? 1u : 0u);
+        for (i = 0; i < 8; i++) {
+            if ((gc_gx_vcd_hi >> (i * 2u)) & 3u) n_tex++;
+        }
+        gx_fifo_xf(0x1008u, n_cols | (n_nrm << 2) | (n_tex << 4));
+        s_gx_sent_vcd_lo = gc_gx_vcd_lo;
+        s_gx_sent_vcd_hi = gc_gx_vcd_hi;
+    }
+    for (i = 0; i < 8; i++) {
+        if (!s_gx_sent_valid || s_gx_sent_vat[i][0] != gc_gx_vat_a[i] ||
+            s_gx_sent_vat[i][1] != gc_gx_vat_b[i] || s_gx_sent_vat[i][2] != gc_gx_vat_c[i]) {
+            // GXAttr.c:__GXSetVAT.
+            gx_fifo_cp(0x70u + i, gc_gx_vat_a[i]);
+            gx_fifo_cp(0x80u + i, gc_gx_vat_b[i]);
+            gx_fifo_cp(0x90u + i, gc_gx_vat_c[i]);
+            s_gx_sent_vat[i][0] = gc_gx_vat_a[i];
+            s_gx_sent_vat[i][1] = gc_gx_vat_b[i];
+            s_gx_sent_vat[i][2] = gc_gx_vat_c[i];
+        }
+    }
+    s_gx_sent_valid = 1;
+}
+
+// Everything the next draw depends on. genMode, TEV order and zmode are only
+// mirrored by their setters (the SDK defers them via dirtyState), so they are
+// staged here; unchanged ones are dropped by gx_bp_stage.
+static void gx_flush_dirty_state(void) {
+    u32 i, n;
+    gx_bp_stage(gc_gx_gen_mode & 0xFFFFFFu);
+    for (i = 0; i < 8; i++) {
+        gx_bp_stage(((0x28u + i) << 24) | (gc_gx_tref[i] & 0xFFFFFFu));
+    }
+    gx_bp_stage((0x40u << 24) | (gc_gx_zmode & 0xFFFFFFu));
+    // The TEV combiner, konst select and cmode0 mirrors keep no register id
+    // until their setter stamps one, and pixel format, dst alpha and scissor
+    // are mirror-only. Stage them with their ids so the GP rasterizes under
+    // the same state.
+    n = ((gc_gx_gen_mode >> 10) & 15u) + 1u;
+    for (i = 0; i < n; i++) {
+        gx_bp_stage_unstamped(0xC0u + i * 2u, gc_gx_tevc[i]);
+        gx_bp_stage_unstamped(0xC1u + i * 2u, gc_gx_teva[i]);
+    }
+    for (i = 0; i < 8; i++) gx_bp_stage_unstamped(0xF6u + i, gc_gx_tev_ksel[i]);
+    gx_bp_stage_unstamped(0x41u, gc_gx_cmode0);
+    gx_bp_stage((0x42u << 24) | ((gc_gx_dst_alpha_enable & 1u) << 8) | (gc_gx_dst_alpha & 0xFFu));
+    gx_bp_stage((0x43u << 24) | (gc_gx_pe_ctrl & 0xFFFFC0u) | (gc_gx_pixel_fmt & 7u) |
+                ((gc_gx_z_fmt & 7u) << 3));
+    if (gc_gx_su_scis1 != 0) {
+        gx_bp_stage((0x20u << 24) | (gc_gx_su_scis0 & 0xFFFFFFu));
+        gx_bp_stage((0x21u << 24) | (gc_gx_su_scis1 & 0xFFFFFFu));
+    }
+    if (gc_gx_scissor_box_offset_reg != 0) gx_bp_stage(gc_gx_scissor_box_offset_reg);
+    // XF numColors / numTexGens follow genMode[4..6] / genMode[0..3].
+    gx_xf_stage(0x09u, (gc_gx_gen_mode >> 4) & 7u);
+    gx_xf_stage(0x3Fu, gc_gx_gen_mode & 15u);
+    gx_flush_regs();
+    gx_flush_vtx_state();
+}
+
+void GXFlush(void) {
+    // GXMisc.c:GXFlush runs __GXSetDirtyState before kicking the FIFO.
+    gx_flush_dirty_state();
+    gc_gx_fifo_kick();
 }
 
 typedef void (*GXDrawSyncCallback)(u16 token);
+typedef void (*GXDrawDoneCallback)(void);
+
+// Wait for the GP, then run the callbacks for the PE interrupts it raised
+// (draw sync token, draw done). This is the only place they run: GXDrawDone,
+// GXWaitDrawDone, GXReadDrawSync and GXCopyDisp, in FIFO order.
+static u16 gx_sync(void) {
+    u16 token = 0;
+    const u32 ints = gc_gx_fifo_sync(&token);
+    if ((ints & GC_GX_FIFO_INT_TOKEN) && gc_gx_token_cb_ptr) {
+        ((GXDrawSyncCallback)gc_gx_token_cb_ptr)(token);
+    }
+    if (ints & GC_GX_FIFO_INT_DONE) {
+        gc_gx_draw_done_flag = 1;
+        if (gc_gx_draw_done_cb_ptr) ((GXDrawDoneCallback)gc_gx_draw_done_cb_ptr)();
+    }
+    return token;
+}
 
 GXDrawSyncCallback GXSetDrawSyncCallback(GXDrawSyncCallback cb) {
     GXDrawSyncCallback old = (GXDrawSyncCallback)gc_gx_token_cb_ptr;
@@ -316,10 +694,20 @@ void GXSetDrawSync(u16 token) {
     gx_write_ras_reg(reg);
     gx_write_ras_reg(reg);
     gc_gx_last_draw_sync_token = token;
-    // GXFlush() is a no-op in this host model; we only keep the bpSentNot mirror.
+    GXFlush();
     gc_gx_bp_sent_not = 0;
 }
 
+u16 GXReadDrawSync(void) {
+    return gx_sync();
+}
+
+GXDrawDoneCallback GXSetDrawDoneCallback(GXDrawDoneCallback cb) {
+    GXDrawDoneCallback old = (GXDrawDoneCallback)gc_gx_draw_done_cb_ptr;
+    gc_gx_draw_done_cb_ptr = (uintptr_t)cb;
+    return old;
+}
+
 // -----------------------------------------------------------------------------
 // GXLight (SDK behavior, mirrored for deterministic testing)
 //
@@ -496,6 +884,19 @@ void GXLoadLightObjImm(GXLightObj *lt_obj, u32 light) {
     u32 idx = light_id_to_idx(light);
     gc_gx_light_loaded[idx] = *lt_obj;
     gc_gx_light_loaded_mask |= (1u << idx);
+
+    // GXLight.c: 16 XF words at 0x600 + idx*16 (3 reserved, color, a[3], k[3], pos, dir).
+    u32 i;
+    gx_fifo_u8(0x10u);
+    gx_fifo_u32((0x600u + idx * 16u) | (0xFu << 16));
+    gx_fifo_u32(0);
+    gx_fifo_u32(0);
+    gx_fifo_u32(0);
+    gx_fifo_u32(lt_obj->Color);
+    for (i = 0; i < 3; i++) gx_fifo_f32(lt_obj->a[i]);
+    for (i = 0; i < 3; i++) gx_fifo_f32(lt_obj->k[i]);
+    for (i = 0; i < 3; i++) gx_fifo_f32(lt_obj->lpos[i]);
+    for (i = 0; i < 3; i++) gx_fifo_f32(lt_obj->ldir[i]);
     gc_gx_bp_sent_not = 1;
 }
 
@@ -506,18 +907,39 @@ void GXLoadLightObjImm(GXLightObj *lt_obj, u32 light) {
 // -----------------------------------------------------------------------------
 
 void GXBeginDisplayList(void *list, u32 size) {
-    // We do not model the real FIFO switching; we only mirror the observable mode.
+    // Pending immediate-mode state goes to the GP first; everything after this
+    // point is written into the list buffer (see gx_fifo_bytes). The list may be
+    // called with any GP state, so it starts with nothing known.
+    gx_flush_dirty_state();
+    gc_gx_fifo_kick();
+    gx_state_forget();
     gc_gx_dl_base = (u32)(uintptr_t)list;
     gc_gx_dl_size = size;
     gc_gx_dl_count = 0;
     gc_gx_in_disp_list = 1;
+    s_gx_dl_overflow = 0;
 }
 
 u32 GXEndDisplayList(void) {
-    // Real SDK validates overflow and returns byte count written. Our sdk_port does not
-    // emit real FIFO bytes yet, so count remains 0 for now.
-    u32 count = gc_gx_dl_count;
+    // Real SDK returns the byte count written (padded to 32 bytes), or 0 on overflow.
+    u32 count;
+    gx_flush_regs();
+    count = gc_gx_dl_count;
+    if (count != 0 && !s_gx_dl_overflow) {
+        while ((gc_gx_dl_count & 31u) != 0 && !s_gx_dl_overflow) {
+            gx_fifo_u8(0x00u);
+        }
+        count = gc_gx_dl_count;
+    }
     gc_gx_in_disp_list = 0;
+    if (s_gx_dl_overflow) {
+        count = 0;
+    } else if (count != 0) {
+        // The GP may have cached an older decode of this buffer.
+        gc_mem_notify_write(gc_gx_dl_base, count);
+    }
+    // State written into the list never reached the GP; resend on next use.
+    gx_state_forget();
     return count;
 }
 
@@ -525,12 +947,129 @@ void GXCallDisplayList(const void *list, u32 nbytes) {
     // Mirror the FIFO command payload (list pointer + byte count).
     gc_gx_call_dl_list = (u32)(uintptr_t)list;
     gc_gx_call_dl_nbytes = nbytes;
+
+    gx_flush_dirty_state();
+    gx_fifo_u8(0x40u);
+    gx_fifo_u32(gc_gx_call_dl_list & 0x3FFFFFFFu);
+    gx_fifo_u32(nbytes);
+    if (!gc_gx_in_disp_list) gc_gx_fifo_kick();
+    // The list may have rewritten any register behind our back.
+    gx_state_forget();
 }
 
 static inline void gx_write_xf_reg(u32 idx, u32 v) {
     if (idx < (sizeof(gc_gx_xf_regs) / sizeof(gc_gx_xf_regs[0]))) {
         gc_gx_xf_regs[idx] = v;
     }
+    if (idx < GC_GX_XF_REG_COUNT) {
+        gx_xf_stage(idx, v);
+    } else {
+        gx_fifo_xf(0x1000u + idx, v);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// GXPerf: modeled GP counters
+//
+// The pipeline keeps running totals (gc_gx_gp, gc_gx_raster_stats, the
+// vertex cache model in gx_vtx, copies, TMEM). Each metric call first adds
+// what happened since the previous call to the counters it reads, under the
+// selection that was active meanwhile. Events the port does not model
+// (XF/TX clocks, stalls, CPU/DSP/VI/refresh traffic) count 0.
+// -----------------------------------------------------------------------------
+
+enum {
+    GX_PERF0_VERTICES = 0,
+    GX_PERF0_TRIANGLES = 11,
+    GX_PERF0_TRIANGLES_CULLED = 12,
+    GX_PERF0_TRIANGLES_PASSED = 13,
+    GX_PERF0_TRIANGLES_SCISSORED = 14,
+    GX_PERF1_TEXELS = 0,
+    GX_PERF1_TC_MISS = 8,
+    GX_PERF1_VERTICES = 16,
+    GX_PERF1_VC_MISS_REQ = 19,
+    GX_VC_ALL = 15,
+};
+
+// Running totals of every counter source, under the current selections.
+typedef struct {
+    uint64_t gp[2];
+    uint64_t vc[2];     // check, miss
+    uint64_t pix[6];
+    uint64_t cp_req, tc_req, pe_req;
+} GxPerfTotals;
+
+static GxPerfTotals s_gx_perf_seen;
+
+static uint64_t gx_perf_vc(u32 sel, const u32 *counts) {
+    uint64_t n = 0;
+    if (sel < GC_GX_VTX_VC_ATTRS) return counts[sel];
+    if (sel != GX_VC_ALL) return 0;
+    for (u32 i = 0; i < GC_GX_VTX_VC_ATTRS; i++) n += counts[i];
+    return n;
+}
+
+static uint64_t gx_perf_event0(u32 sel) {
+    const GcGxRasterStats *r = &gc_gx_raster_stats;
+    switch (sel) {
+    case GX_PERF0_VERTICES: return gc_gx_gp.verts;
+    case GX_PERF0_TRIANGLES: return r->tris;
+    case GX_PERF0_TRIANGLES_CULLED: return r->culled;
+    case GX_PERF0_TRIANGLES_PASSED: return r->tris > r->culled ? r->tris - r->culled : 0;
+    case GX_PERF0_TRIANGLES_SCISSORED: return r->clipped;
+    default: return 0;
+    }
+}
+
+static uint64_t gx_perf_event1(u32 sel) {
+    switch (sel) {
+    case GX_PERF1_TEXELS: return gc_gx_raster_stats.texels;
+    case GX_PERF1_TC_MISS: return (uint64_t)gc_gx_tmem_total.misses + gc_gx_tmem_frame.misses;
+    case GX_PERF1_VERTICES: return gc_gx_gp.verts;
+    case GX_PERF1_VC_MISS_REQ: return gx_perf_vc(GX_VC_ALL, gc_gx_vtx_vc_misses);
+    default: return 0;
+    }
+}
+
+static void gx_perf_totals(GxPerfTotals *t) {
+    const GcGxRasterStats *r = &gc_gx_raster_stats;
+    t->gp[0] = gx_perf_event0(gc_gx_gp_perf0);
+    t->gp[1] = gx_perf_event1(gc_gx_gp_perf1);
+    t->vc[0] = gx_perf_vc(gc_gx_vcache_sel, gc_gx_vtx_vc_checks);
+    t->vc[1] = gx_perf_vc(gc_gx_vcache_sel, gc_gx_vtx_vc_misses);
+    t->pix[0] = r->top_in;
+    t->pix[1] = r->top_out;
+    t->pix[2] = r->bot_in;
+    t->pix[3] = r->bot_out;
+    t->pix[4] = r->written;
+    // One copy clock per EFB source pixel.
+    t->pix[5] = (uint64_t)gc_gx_texcopy_pixels + gc_gx_xfb_pixels;
+    // 32-byte requests: vertex array line fills, TMEM line fills, copy writes.
+    t->cp_req = gx_perf_vc(GX_VC_ALL, gc_gx_vtx_vc_misses);
+    t->tc_req = (uint64_t)gc_gx_tmem_total.misses + gc_gx_tmem_frame.misses;
+    t->pe_req = ((uint64_t)gc_gx_texcopy_bytes + gc_gx_xfb_bytes) >> 5;
+}
+
+// Start counting from the current totals (GXInit, selection changes).
+static void gx_perf_rebase(void) {
+    gx_perf_totals(&s_gx_perf_seen);
+}
+
+static void gx_perf_sync(void) {
+    GxPerfTotals now;
+    const GxPerfTotals *was = &s_gx_perf_seen;
+
+    // Draws still in the FIFO or the raster bins count as done.
+    if (!gc_gx_in_disp_list && !s_gx_in_begin) gc_gx_fifo_drain();
+    gc_gx_raster_flush();
+    gx_perf_totals(&now);
+    for (u32 i = 0; i < 2; i++) gc_gx_gp_metric[i] += (u32)(now.gp[i] - was->gp[i]);
+    for (u32 i = 0; i < 2; i++) gc_gx_vcache_metrics[i] += (u32)(now.vc[i] - was->vc[i]);
+    for (u32 i = 0; i < 6; i++) gc_gx_pix_metrics[i] += (u32)(now.pix[i] - was->pix[i]);
+    gc_gx_mem_metrics[0] += (u32)(now.cp_req - was->cp_req);
+    gc_gx_mem_metrics[1] += (u32)(now.tc_req - was->tc_req);
+    gc_gx_mem_metrics[7] += (u32)(now.pe_req - was->pe_req);
+    s_gx_perf_seen = now;
 }
 
 // ---- Texture objects / regions (GXTexture.c + GXInit.c) ----
@@ -609,10 +1148,10 @@ static const u8 gc_gx_tex_image0_ids[8] = { 0x88, 0x89, 0x8A, 0x8B, 0xA8, 0xA9,
 static const u8 gc_gx_tex_image1_ids[8] = { 0x8C, 0x8D, 0x8E, 0x8F, 0xAC, 0xAD, 0xAE, 0xAF };
 static const u8 gc_gx_tex_image2_ids[8] = { 0x90, 0x91, 0x92, 0x93, 0xB0, 0xB1, 0xB2, 0xB3 };
 static const u8 gc_gx_tex_image3_ids[8] = { 0x94, 0x95, 0x96, 0x97, 0xB4, 0xB5, 0xB6, 0xB7 };
+static const u8 gc_gx_tex_tlut_ids[8] = { 0x98, 0x99, 0x9A, 0x9B, 0xB8, 0xB9, 0xBA, 0xBB };
 
 GXFifoObj *GXInit(void *base, u32 size) {
-    (void)base;
-    (void)size;
+    GcGxFifoInfo fi;
     gc_gx_in_disp_list = 0;
     gc_gx_dl_save_context = 1;
     gc_gx_gen_mode = 0;
@@ -713,6 +1252,34 @@ GXFifoObj *GXInit(void *base, u32 size) {
     gc_gx_tlut_load0_last = 0;
     gc_gx_tlut_load1_last = 0;
 
+    // GP side: the FIFO in [base, base + size), fresh register files, empty
+    // display list/loader caches, resend state.
+    gc_gx_fifo_init(base, size);
+    s_gx_in_begin = 0;
+    __builtin_memset(s_gx_bp_dirty, 0, sizeof(s_gx_bp_dirty));
+    __builtin_memset(s_gx_xf_dirty, 0, sizeof(s_gx_xf_dirty));
+    s_gx_bp_masked = 0;
+    gx_state_forget();
+    gc_gx_state_reset_counters();
+    gc_gx_gp_reset();
+    gc_gx_dl_cache_reset();
+    gc_gx_vtx_reset();
+    gc_gx_raster_reset();
+    gc_gx_tmem_reset();
+    gx_perf_rebase();
+    if (gc_gx_trace_hook) gc_gx_trace_hook(GC_GX_TRACE_RESET, 0, 0);
+
+    gc_gx_fifo_info(&fi);
+    s_fifo_obj.base = fi.base ? (void *)(uintptr_t)fi.base : base;
+    s_fifo_obj.size = fi.size;
+    s_fifo_obj.top = s_fifo_obj.base ? (u8 *)s_fifo_obj.base + fi.size - 4u : 0;
+    s_fifo_obj.hiWatermark = fi.hi;
+    s_fifo_obj.loWatermark = fi.lo;
+    s_fifo_obj.rdPtr = s_fifo_obj.base;
+    s_fifo_obj.wrPtr = s_fifo_obj.base;
+    s_fifo_obj.count = 0;
+    s_fifo_obj.bind_cpu = 1;
+    s_fifo_obj.bind_gp = 1;
     return &s_fifo_obj;
 }
 
@@ -757,6 +1324,8 @@ void GXLoadPosMtxImm(float mtx[3][4], u32 id) {
 
     gc_gx_fifo_u8_last = 0x10u;
     gc_gx_fifo_u32_last = reg;
+    gx_fifo_u8(0x10u);
+    gx_fifo_u32(reg);
 
     u32 i = 0;
     u32 r, c;
@@ -767,6 +1336,7 @@ void GXLoadPosMtxImm(float mtx[3][4], u32 id) {
                 u32 u;
             } u = { mtx[r][c] };
             gc_gx_fifo_mtx_words[i++] = u.u;
+            gx_fifo_u32(u.u);
         }
     }
 }
@@ -779,6 +1349,8 @@ void GXLoadNrmMtxImm(float mtx[3][4], u32 id) {
 
     gc_gx_fifo_u8_last = 0x10u;
     gc_gx_fifo_u32_last = reg;
+    gx_fifo_u8(0x10u);
+    gx_fifo_u32(reg);
 
     u32 i = 0;
     u32 r, c;
@@ -789,6 +1361,7 @@ void GXLoadNrmMtxImm(float mtx[3][4], u32 id) {
                 u32 u;
             } u = { mtx[r][c] };
             gc_gx_fifo_mtx_words[i++] = u.u;
+            gx_fifo_u32(u.u);
         }
     }
     for (; i < 12; i++) {
@@ -813,6 +1386,8 @@ void GXLoadTexMtxImm(float mtx[][4], u32 id, u32 type) {
 
     gc_gx_fifo_u8_last = 0x10u;
     gc_gx_fifo_u32_last = reg;
+    gx_fifo_u8(0x10u);
+    gx_fifo_u32(reg);
 
     u32 i = 0;
     u32 r, c;
@@ -839,6 +1414,9 @@ void GXLoadTexMtxImm(float mtx[][4], u32 id, u32 type) {
             }
         }
     }
+    for (r = 0; r < count; r++) {
+        gx_fifo_u32(gc_gx_fifo_mtx_words[r]);
+    }
     for (; i < 12; i++) {
         gc_gx_fifo_mtx_words[i] = 0;
     }
@@ -853,6 +1431,19 @@ void GXSetViewportJitter(float left, float top, float wd, float ht, float nearz,
     gc_gx_vp_ht = ht;
     gc_gx_vp_nearz = nearz;
     gc_gx_vp_farz = farz;
+
+    // GXTransform.c:GXSetViewportJitter XF 0x101A..0x101F (zScale = 2^24 - 1).
+    {
+        const f32 zmax = 16777215.0f;
+        gx_fifo_u8(0x10u);
+        gx_fifo_u32(0x101Au | (5u << 16));
+        gx_fifo_f32(wd * 0.5f);
+        gx_fifo_f32(-ht * 0.5f);
+        gx_fifo_f32((farz - nearz) * zmax);
+        gx_fifo_f32(left + wd * 0.5f + 342.0f);
+        gx_fifo_f32(top + ht * 0.5f + 342.0f);
+        gx_fifo_f32(farz * zmax);
+    }
     gc_gx_bp_sent_not = 1;
 }
 
@@ -918,10 +1509,18 @@ void GXBegin(u8 type, u8 vtxfmt, u16 nverts) {
     // Mirror decomp_mario_party_4/src/dolphin/gx/GXGeometry.c:GXBegin observable FIFO header writes.
     gc_gx_fifo_begin_u8 = (u32)(vtxfmt | type);
     gc_gx_fifo_begin_u16 = (u32)nverts;
+
+    gx_flush_dirty_state();
+    gx_fifo_u8(vtxfmt | type);
+    gx_fifo_u16(nverts);
+    s_gx_in_begin = 1;
 }
 
 void GXEnd(void) {
-    // In the SDK this is a macro barrier; deterministic host model: no-op.
+    // In the SDK this is a macro barrier. Here it marks the end of the vertex data,
+    // so the staged primitive can be handed to the GP model.
+    s_gx_in_begin = 0;
+    if (!gc_gx_in_disp_list) gc_gx_fifo_kick();
 }
 
 void GXSetTexCoordGen2(u8 dst_coord, u32 func, u32 src_param, u32 mtx, u32 normalize, u32 postmtx) {
@@ -976,11 +1575,13 @@ void GXSetTexCoordGen2(u8 dst_coord, u32 func, u32 src_param, u32 mtx, u32 norma
     }
 
     gc_gx_xf_texcoordgen_40[dst_coord] = reg;
+    gx_write_xf_reg(0x40u + dst_coord, reg);
 
     reg = 0;
     reg = set_field(reg, 6, 0, (postmtx - 64u) & 0x3Fu);
     reg = set_field(reg, 1, 8, (u32)(normalize != 0));
     gc_gx_xf_texcoordgen_50[dst_coord] = reg;
+    gx_write_xf_reg(0x50u + dst_coord, reg);
 
     // Matrix index update matches GXAttr.c switch over dst_coord.
     if (dst_coord <= 3u) {
@@ -1088,6 +1689,7 @@ u32 GXSetDispCopyYScale(float vscale) {
 
     // Track cpDisp bit 10 (check) so tests can observe it.
     gc_gx_cp_disp = set_field(gc_gx_cp_disp, 1, 10, check);
+    gc_gx_copy_yscale = scale;
 
     // Height is derived from cpDispSize bits [10..19] + 1. Our mirror uses the same packing.
     u32 height = ((gc_gx_cp_disp_size >> 10) & 0x3FFu) + 1u;
@@ -1137,6 +1739,14 @@ void GXSetCopyFilter(u8 aa, const u8 sample_pattern[12][2], u8 vf, const u8 vfil
     gc_gx_copy_filter_vf = (u32)vf;
     gc_gx_copy_filter_sample_hash = hash_bytes(sample_pattern, 12u * 2u);
     gc_gx_copy_filter_vfilter_hash = hash_bytes(vfilter, 7u);
+
+    // GXFrameBuf.c: without vf the filter is 0, 0, 21, 22, 21, 0, 0.
+    if (vf) {
+        __builtin_memcpy(gc_gx_copy_vfilter, vfilter, 7u);
+    } else {
+        static const u8 k_default[7] = { 0, 0, 21, 22, 21, 0, 0 };
+        __builtin_memcpy(gc_gx_copy_vfilter, k_default, 7u);
+    }
 }
 
 void GXSetPixelFmt(u32 pix_fmt, u32 z_fmt) {
@@ -1145,8 +1755,36 @@ void GXSetPixelFmt(u32 pix_fmt, u32 z_fmt) {
 }
 
 void GXCopyDisp(void *dest, u8 clear) {
+    GcGxTraceCopyDisp t;
+    GcGxXfbCopy *c = &t.copy;
+    const u32 r0 = gc_gx_copy_clear_reg0, r1 = gc_gx_copy_clear_reg1;
+    u32 i;
+
     gc_sdk_state_store_u32_mirror(GC_SDK_OFF_GX_COPY_DISP_DEST, &gc_gx_copy_disp_dest, (u32)(uintptr_t)dest);
     gc_gx_copy_disp_clear = (u32)clear;
+    gx_sync();
+    gc_gx_tmem_end_frame();
+    gc_gx_raster_end_frame();
+
+    __builtin_memset(&t, 0, sizeof(t));
+    c->x = gc_gx_cp_disp_src & 0x3FFu;
+    c->y = (gc_gx_cp_disp_src >> 10) & 0x3FFu;
+    c->w = (gc_gx_cp_disp_size & 0x3FFu) + 1u;
+    c->h = ((gc_gx_cp_disp_size >> 10) & 0x3FFu) + 1u;
+    c->stride = (gc_gx_cp_disp_stride & 0x3FFu) << 5;
+    c->yscale = gc_gx_copy_yscale ? gc_gx_copy_yscale : 0x100u;
+    c->lines = __GXGetNumXfbLines(c->h, c->yscale);
+    for (i = 0; i < 7u; i++) c->vfilter[i] = gc_gx_copy_vfilter[i];
+    c->gamma = gc_gx_copy_gamma;
+    c->clamp = gc_gx_copy_clamp;
+    t.addr = ((u32)(uintptr_t)dest & 0x3FFFFFFFu) | 0x80000000u;
+    t.clear = (u32)clear;
+    t.clear_rgba = ((r0 & 0xFFu) << 24) | (((r1 >> 8) & 0xFFu) << 16) | ((r1 & 0xFFu) << 8) |
+                   ((r0 >> 8) & 0xFFu);
+    t.clear_z = gc_gx_copy_clear_reg2 & 0xFFFFFFu;
+    if (gc_gx_trace_hook) gc_gx_trace_hook(GC_GX_TRACE_COPY_DISP, &t, sizeof(t));
+    // Convert the EFB into the XFB once something has been drawn (see GXCopyTex).
+    gc_gx_xfb_display_copy(c, t.addr, t.clear, t.clear_rgba, t.clear_z);
 }
 
 void GXSetDispCopyGamma(u32 gamma) {
@@ -1155,16 +1793,12 @@ void GXSetDispCopyGamma(u32 gamma) {
 
 // ---- GXInit tail setters (used by MP4 init chain after GXSetDither) ----
 
-u32 gc_gx_dst_alpha_enable;
-u32 gc_gx_dst_alpha;
-
 u32 gc_gx_field_mask_even;
 u32 gc_gx_field_mask_odd;
 
 u32 gc_gx_field_mode_field_mode;
 u32 gc_gx_field_mode_half_aspect;
 
-u32 gc_gx_copy_clamp;
 u32 gc_gx_copy_frame2field;
 
 u32 gc_gx_clear_bounding_box_calls;
@@ -1213,7 +1847,28 @@ void GXSetDispCopyFrame2Field(u32 mode) {
 }
 
 void GXClearBoundingBox(void) {
+    // GXMisc.c: left = top = 0x3FF, right = bottom = 0.
     gc_gx_clear_bounding_box_calls++;
+    gx_write_ras_reg(0x550003FFu);
+    gx_write_ras_reg(0x560003FFu);
+    gc_gx_bp_sent_not = 0;
+}
+
+// CPU access to GP results (bounding box, EFB) sees every register set and
+// command issued so far, including the pixel format the pokes use.
+static void gx_cpu_efb_sync(void) {
+    if (gc_gx_in_disp_list || s_gx_in_begin) return;
+    gx_flush_dirty_state();
+    gc_gx_fifo_drain();
+}
+
+void GXReadBoundingBox(u16 *left, u16 *top, u16 *right, u16 *bottom) {
+    gx_cpu_efb_sync();
+    gc_gx_raster_flush();
+    *left = (u16)gc_gx_raster_bbox.left;
+    *top = (u16)gc_gx_raster_bbox.top;
+    *right = (u16)gc_gx_raster_bbox.right;
+    *bottom = (u16)gc_gx_raster_bbox.bottom;
 }
 
 void GXPokeColorUpdate(u8 enable) {
@@ -1255,16 +1910,65 @@ void GXPokeZMode(u8 enable, u32 func, u8 update_enable) {
     gc_gx_poke_zmode_update_enable = (u32)update_enable;
 }
 
+// The PE poke registers (PE_ZMODE, PE_CMODE0/1, PE_ALPHA_MODE, PE_ALPHA_READ)
+// as GXPoke* leaves them. Dither has no effect on the host EFB.
+static GcGxPokeMode gx_poke_mode(void) {
+    const u32 type = gc_gx_poke_blend_type;
+    GcGxPokeMode m;
+
+    m.zmode = (gc_gx_poke_zmode_enable & 1u) | ((gc_gx_poke_zmode_func & 7u) << 1) |
+              ((gc_gx_poke_zmode_update_enable & 1u) << 4);
+    m.cmode0 = (u32)(type == 1u || type == 3u) | ((u32)(type == 2u) << 1) |
+               ((gc_gx_poke_dither_enable & 1u) << 2) |
+               ((gc_gx_poke_color_update_enable & 1u) << 3) |
+               ((gc_gx_poke_alpha_update_enable & 1u) << 4) | ((gc_gx_poke_blend_dst & 7u) << 5) |
+               ((gc_gx_poke_blend_src & 7u) << 8) | ((u32)(type == 3u) << 11) |
+               ((gc_gx_poke_blend_op & 15u) << 12);
+    m.cmode1 = (gc_gx_poke_dst_alpha & 0xFFu) | ((gc_gx_poke_dst_alpha_enable & 1u) << 8);
+    m.amode = ((gc_gx_poke_alpha_mode_func & 7u) << 8) | (gc_gx_poke_alpha_mode_thresh & 0xFFu);
+    m.aread = gc_gx_poke_alpha_read_mode & 3u;
+    return m;
+}
+
+// GXMisc.c: CPU EFB access through the 0xC8000000 window, x and y 10 bits.
+void GXPokeARGB(u16 x, u16 y, u32 color) {
+    const GcGxPokeMode m = gx_poke_mode();
+    gx_cpu_efb_sync();
+    gc_gx_raster_poke_argb(&gc_gx_efb, x & 0x3FFu, y & 0x3FFu, color, &m, &gc_gx_gp);
+}
+
+void GXPeekARGB(u16 x, u16 y, u32 *color) {
+    const GcGxPokeMode m = gx_poke_mode();
+    gx_cpu_efb_sync();
+    *color = gc_gx_raster_peek_argb(&gc_gx_efb, x & 0x3FFu, y & 0x3FFu, &m);
+}
+
+void GXPokeZ(u16 x, u16 y, u32 z) {
+    const GcGxPokeMode m = gx_poke_mode();
+    gx_cpu_efb_sync();
+    gc_gx_raster_poke_z(&gc_gx_efb, x & 0x3FFu, y & 0x3FFu, z, &m);
+}
+
+void GXPeekZ(u16 x, u16 y, u32 *z) {
+    gx_cpu_efb_sync();
+    *z = gc_gx_raster_peek_z(&gc_gx_efb, x & 0x3FFu, y & 0x3FFu);
+}
+
 void GXInvalidateVtxCache(void) {
     gc_gx_invalidate_vtx_cache_calls++;
+    gx_fifo_u8(0x48u);
 }
 
 void GXInvalidateTexAll(void) {
     gc_gx_invalidate_tex_all_calls++;
+    if (gc_gx_trace_hook) gc_gx_trace_hook(GC_GX_TRACE_TMEM_INVAL, 0, 0);
+    gc_gx_tmem_invalidate();
 }
 
 void GXDrawDone(void) {
     gc_gx_draw_done_calls++;
+    GXFlush();
+    gx_sync();
 }
 
 void GXSetTexCopySrc(u16 left, u16 top, u16 wd, u16 ht) {
@@ -1516,6 +2220,21 @@ void GXLoadTexObjPreLoaded(GXTexObj *obj, GXTexRegion *region, u32 id) {
     gx_write_ras_reg(region->image1);
     gx_write_ras_reg(region->image2);
     gx_write_ras_reg(obj->image3);
+    if (gc_gx_trace_hook) {
+        const u32 w[6] = { obj->image0, obj->image3, obj->mode1, obj->flags & 1u, region->image1, region->image2 };
+        gc_gx_trace_hook(GC_GX_TRACE_TMEM_LOAD, w, sizeof(w));
+    }
+    gc_gx_tmem_load_tex(obj->image0, obj->image3, obj->mode1, obj->flags & 1u, region->image1, region->image2);
+
+    // CI textures also point the map at their TLUT (offset + format).
+    if (!(obj->flags & 2u)) {
+        if (!gc_gx_tlut_region_cb) gc_gx_tlut_region_cb = gc__gx_default_tlut_region_cb;
+        GXTlutRegion *tlr = gc_gx_tlut_region_cb(obj->tlutName);
+        if (tlr) {
+            tlr->tlutObj.tlut = set_field(tlr->tlutObj.tlut, 8, 24, gc_gx_tex_tlut_ids[id]);
+            gx_write_ras_reg(tlr->tlutObj.tlut);
+        }
+    }
 }
 
 void GXLoadTexObj(GXTexObj *obj, u32 id) {
@@ -1525,6 +2244,47 @@ void GXLoadTexObj(GXTexObj *obj, u32 id) {
     GXLoadTexObjPreLoaded(obj, r, id);
 }
 
+GXTexRegionCallback GXSetTexRegionCallback(GXTexRegionCallback f) {
+    // Mirror GXTexture.c:GXSetTexRegionCallback.
+    GXTexRegionCallback old = gc_gx_tex_region_cb;
+    if (!old) old = gc__gx_default_tex_region_cb;
+    gc_gx_tex_region_cb = f;
+    return old;
+}
+
+GXTlutRegionCallback GXSetTlutRegionCallback(GXTlutRegionCallback f) {
+    // Mirror GXTexture.c:GXSetTlutRegionCallback.
+    GXTlutRegionCallback old = gc_gx_tlut_region_cb;
+    if (!old) old = gc__gx_default_tlut_region_cb;
+    gc_gx_tlut_region_cb = f;
+    return old;
+}
+
+void GXInitTexPreLoadRegion(GXTexRegion *region, u32 tmem_even, u32 size_even, u32 tmem_odd, u32 size_odd) {
+    // Mirror GXTexture.c:GXInitTexPreLoadRegion: bases only, preloaded bit set.
+    if (!region) return;
+    region->image1 = 0;
+    region->image1 = set_field(region->image1, 15, 0, tmem_even >> 5);
+    region->image1 = set_field(region->image1, 1, 21, 1);
+    region->image2 = 0;
+    region->image2 = set_field(region->image2, 15, 0, tmem_odd >> 5);
+    region->sizeEven = (u16)(size_even >> 5);
+    region->sizeOdd = (u16)(size_odd >> 5);
+    region->is32bMipmap = 0;
+    region->isCached = 0;
+}
+
+void GXPreLoadEntireTexture(GXTexObj *obj, GXTexRegion *region) {
+    // The TMEM load commands (BP 0x60..0x64) are not mirrored; only the
+    // TMEM simulator sees the preload.
+    if (!obj || !region) return;
+    if (gc_gx_trace_hook) {
+        const u32 w[6] = { obj->image0, obj->image3, obj->mode1, obj->flags & 1u, region->image1, region->image2 };
+        gc_gx_trace_hook(GC_GX_TRACE_TMEM_PRELOAD, w, sizeof(w));
+    }
+    gc_gx_tmem_preload(obj->image0, obj->image3, obj->mode1, obj->flags & 1u, region->image1, region->image2);
+}
+
 void GXInitTexObjCI(GXTexObj *obj, void *image_ptr, u16 width, u16 height, u32 format, u32 wrap_s, u32 wrap_t, u8 mipmap, u32 tlut_name) {
     // Mirror GXTexture.c:GXInitTexObjCI: call GXInitTexObj, clear CI flag, set tlutName.
     GXInitTexObj(obj, image_ptr, width, height, format, wrap_s, wrap_t, mipmap);
@@ -1572,6 +2332,8 @@ void GXLoadTlut(GXTlutObj *tlut_obj, u32 tlut_name) {
 
     gc_gx_tlut_load0_last = tlut_obj->loadTlut0;
     gc_gx_tlut_load1_last = r->loadTlut1;
+    if (gc_gx_trace_hook) gc_gx_trace_hook(GC_GX_TRACE_TMEM_TLUT, &r->loadTlut1, sizeof(u32));
+    gc_gx_tmem_load_tlut(r->loadTlut1);
 
     u32 tlut_offset = r->loadTlut1 & 0x3FFu;
     tlut_obj->tlut = set_field(tlut_obj->tlut, 10, 0, tlut_offset);
@@ -1650,7 +2412,7 @@ void GXSetTexCopyDst(u16 wd, u16 ht, u32 fmt, u32 mipmap) {
 void GXCopyTex(void *dest, u32 clear) {
     // Mirror GXFrameBuf.c:GXCopyTex observable packing/writes for deterministic tests.
     // We track the packed address reg (0x4B) and the cpTex reg write (0x52).
-    u32 reg;
+    u32 reg, pe_ctrl, pe_z;
     u32 phyAddr = ((u32)(uintptr_t)dest) & 0x3FFFFFFFu;
 
     // Address BP reg 0x4B with phyAddr>>5 in low 21 bits.
@@ -1668,6 +2430,12 @@ void GXCopyTex(void *dest, u32 clear) {
     // Observable write ordering in the SDK includes cpTexSrc/cpTexSize/cpTexStride first.
     // For our deterministic oracle, we preserve those regs and update "last RAS reg" to
     // the last written register in the sequence.
+    // Z copies read the depth buffer: the PE pixel format is switched to Z24
+    // for the copy and peCtrl is restored afterwards.
+    pe_z = gc_gx_cp_tex_z != 0 && (gc_gx_pixel_fmt & 7u) != 3u;
+    pe_ctrl = (0x43u << 24) | (gc_gx_pe_ctrl & 0xFFFFC0u) | ((gc_gx_z_fmt & 7u) << 3);
+    if (pe_z) gx_write_ras_reg(pe_ctrl | 3u);
+
     gx_write_ras_reg(gc_gx_cp_tex_src);
     gx_write_ras_reg(gc_gx_cp_tex_size);
     gx_write_ras_reg(gc_gx_cp_tex_stride);
@@ -1684,6 +2452,7 @@ void GXCopyTex(void *dest, u32 clear) {
         cmode_clear = set_field(cmode_clear, 8, 24, 0x42u);
         gx_write_ras_reg(cmode_clear);
     }
+    if (pe_z) gx_write_ras_reg(pe_ctrl | (gc_gx_pixel_fmt & 7u));
 
     gc_gx_bp_sent_not = 0;
 }
@@ -1795,15 +2564,17 @@ void GXSetCurrentMtx(u32 id) {
 
 void GXSetDrawDone(void) {
     // Mirror GXMisc.c:GXSetDrawDone observable write.
-    // Real SDK also touches interrupt state + DrawDone flag; we keep it deterministic.
+    // The flag is set again once the GP has reached the write (GXWaitDrawDone).
     gc_gx_set_draw_done_calls++;
     gx_write_ras_reg(0x45000002u);
+    GXFlush();
     gc_gx_draw_done_flag = 0;
 }
 
 void GXWaitDrawDone(void) {
-    // Deterministic completion: don't block, just mark "done".
+    // Waits for the GP to reach the draw done set by GXSetDrawDone.
     gc_gx_wait_draw_done_calls++;
+    gx_sync();
     gc_gx_draw_done_flag = 1;
 }
 
@@ -2248,39 +3019,49 @@ void GXSetDither(u8 dither) {
 }
 
 void GXSetGPMetric(u32 perf0, u32 perf1) {
+    gx_perf_sync();
     gc_gx_gp_perf0 = perf0;
     gc_gx_gp_perf1 = perf1;
+    gx_perf_rebase();
 }
 
 void GXClearGPMetric(void) {
-    gc_gx_gp_perf0 = 0;
-    gc_gx_gp_perf1 = 0;
+    gx_perf_sync();
+    gc_gx_gp_metric[0] = 0;
+    gc_gx_gp_metric[1] = 0;
 }
 
 void GXReadGPMetric(u32 *met0, u32 *met1) {
-    if (met0) *met0 = gc_gx_gp_perf0;
-    if (met1) *met1 = gc_gx_gp_perf1;
+    gx_perf_sync();
+    if (met0) *met0 = gc_gx_gp_metric[0];
+    if (met1) *met1 = gc_gx_gp_metric[1];
 }
 
 void GXSetVCacheMetric(u32 attr) {
+    gx_perf_sync();
     gc_gx_vcache_sel = attr;
+    gx_perf_rebase();
 }
 
 void GXClearVCacheMetric(void) {
-    gc_gx_vcache_sel = 0;
+    gx_perf_sync();
+    for (u32 i = 0; i < 3; i++) gc_gx_vcache_metrics[i] = 0;
 }
 
 void GXReadVCacheMetric(u32 *check, u32 *miss, u32 *stall) {
-    if (check) *check = gc_gx_vcache_sel;
-    if (miss) *miss = 0;
-    if (stall) *stall = 0;
+    gx_perf_sync();
+    if (check) *check = gc_gx_vcache_metrics[0];
+    if (miss) *miss = gc_gx_vcache_metrics[1];
+    if (stall) *stall = gc_gx_vcache_metrics[2];
 }
 
 void GXClearPixMetric(void) {
+    gx_perf_sync();
     for (u32 i = 0; i < 6; i++) gc_gx_pix_metrics[i] = 0;
 }
 
 void GXReadPixMetric(u32 *top_in, u32 *top_out, u32 *bot_in, u32 *bot_out, u32 *clr_in, u32 *copy_clks) {
+    gx_perf_sync();
     if (top_in) *top_in = gc_gx_pix_metrics[0];
     if (top_out) *top_out = gc_gx_pix_metrics[1];
     if (bot_in) *bot_in = gc_gx_pix_metrics[2];
@@ -2290,11 +3071,13 @@ void GXReadPixMetric(u32 *top_in, u32 *top_out, u32 *bot_in, u32 *bot_out, u32 *
 }
 
 void GXClearMemMetric(void) {
+    gx_perf_sync();
     for (u32 i = 0; i < 10; i++) gc_gx_mem_metrics[i] = 0;
 }
 
 void GXReadMemMetric(u32 *cp_req, u32 *tc_req, u32 *cpu_rd_req, u32 *cpu_wr_req,
                      u32 *dsp_req, u32 *io_req, u32 *vi_req, u32 *pe_req, u32 *rf_req, u32 *fi_req) {
+    gx_perf_sync();
     if (cp_req) *cp_req = gc_gx_mem_metrics[0];
     if (tc_req) *tc_req = gc_gx_mem_metrics[1];
     if (cpu_rd_req) *cpu_rd_req = gc_gx_mem_metrics[2];
@@ -2469,6 +3252,8 @@ void GXSetArray(u32 attr, const void *base_ptr, u8 stride) {
     u32 phy_addr = (u32)(uintptr_t)base_ptr & 0x3FFFFFFFu;
     gc_gx_array_base[cp_attr] = phy_addr;
     gc_gx_array_stride[cp_attr] = (u32)stride;
+    gx_fifo_cp(0xA0u + cp_attr, phy_addr);
+    gx_fifo_cp(0xB0u + cp_attr, (u32)stride);
 }
 
 static inline u32 f32_bits(float f) {
@@ -2481,10 +3266,14 @@ void GXPosition3f32(float x, float y, float z) {
     gc_gx_pos3f32_x_bits = f32_bits(x);
     gc_gx_pos3f32_y_bits = f32_bits(y);
     gc_gx_pos3f32_z_bits = f32_bits(z);
+    gx_fifo_u32(gc_gx_pos3f32_x_bits);
+    gx_fifo_u32(gc_gx_pos3f32_y_bits);
+    gx_fifo_u32(gc_gx_pos3f32_z_bits);
 }
 
 void GXPosition1x16(u16 x) {
     gc_gx_pos1x16_last = (u32)x;
+    gx_fifo_u16(x);
 }
 
 void GXPosition2s16(s16 x, s16 y) {
@@ -2493,12 +3282,16 @@ void GXPosition2s16(s16 x, s16 y) {
     // promote s16 when doing comparisons/logging).
     gc_gx_pos2s16_x = (u32)(s32)x;
     gc_gx_pos2s16_y = (u32)(s32)y;
+    gx_fifo_u16((u16)x);
+    gx_fifo_u16((u16)y);
 }
 
 void GXPosition2u16(u16 x, u16 y) {
     // Deterministic host model: keep last written values (zero-extended).
     gc_gx_pos2u16_x = (u32)x;
     gc_gx_pos2u16_y = (u32)y;
+    gx_fifo_u16(x);
+    gx_fifo_u16(y);
 }
 
 void GXPosition3s16(s16 x, s16 y, s16 z) {
@@ -2506,55 +3299,75 @@ void GXPosition3s16(s16 x, s16 y, s16 z) {
     gc_gx_pos3s16_x = (u32)(s32)x;
     gc_gx_pos3s16_y = (u32)(s32)y;
     gc_gx_pos3s16_z = (u32)(s32)z;
+    gx_fifo_u16((u16)x);
+    gx_fifo_u16((u16)y);
+    gx_fifo_u16((u16)z);
 }
 
 void GXPosition2f32(float x, float y) {
     // Deterministic host model: keep last written values as raw f32 bits.
     gc_gx_pos2f32_x_bits = f32_bits(x);
     gc_gx_pos2f32_y_bits = f32_bits(y);
+    gx_fifo_u32(gc_gx_pos2f32_x_bits);
+    gx_fifo_u32(gc_gx_pos2f32_y_bits);
 }
 
 void GXTexCoord2f32(float s, float t) {
     // Deterministic host model: keep last written values as raw f32 bits.
     gc_gx_texcoord2f32_s_bits = f32_bits(s);
     gc_gx_texcoord2f32_t_bits = f32_bits(t);
+    gx_fifo_u32(gc_gx_texcoord2f32_s_bits);
+    gx_fifo_u32(gc_gx_texcoord2f32_t_bits);
 }
 
 void GXColor1x8(u8 c) {
     // Deterministic host model: record last 8-bit color value.
     gc_gx_color1x8_last = (u32)c;
+    gx_fifo_u8(c);
 }
 
 void GXColor3u8(u8 r, u8 g, u8 b) {
     // Deterministic host model: record last RGB triple packed as 0x00RRGGBB.
     gc_gx_color3u8_last = ((u32)r << 16) | ((u32)g << 8) | (u32)b;
+    gx_fifo_u8(r);
+    gx_fifo_u8(g);
+    gx_fifo_u8(b);
 }
 
 void GXColor1x16(u16 index) {
     gc_gx_color1x16_last = (u32)index;
+    gx_fifo_u16(index);
 }
 
 void GXColor4u8(u8 r, u8 g, u8 b, u8 a) {
     gc_gx_color4u8_last = ((u32)r << 24) | ((u32)g << 16) | ((u32)b << 8) | (u32)a;
+    gx_fifo_u32(gc_gx_color4u8_last);
 }
 
 void GXNormal1x16(u16 index) {
     gc_gx_normal1x16_last = (u32)index;
+    gx_fifo_u16(index);
 }
 
 void GXNormal3s16(s16 x, s16 y, s16 z) {
     gc_gx_normal3s16_x = (u32)(s32)x;
     gc_gx_normal3s16_y = (u32)(s32)y;
     gc_gx_normal3s16_z = (u32)(s32)z;
+    gx_fifo_u16((u16)x);
+    gx_fifo_u16((u16)y);
+    gx_fifo_u16((u16)z);
 }
 
 void GXTexCoord1x16(u16 index) {
     gc_gx_texcoord1x16_last = (u32)index;
+    gx_fifo_u16(index);
 }
 
 void GXTexCoord2s16(s16 s, s16 t) {
     gc_gx_texcoord2s16_s = (u32)(s32)s;
     gc_gx_texcoord2s16_t = (u32)(s32)t;
+    gx_fifo_u16((u16)s);
+    gx_fifo_u16((u16)t);
 }
 
 void GXSetTevColorIn(u32 stage, u32 a, u32 b, u32 c, u32 d) {
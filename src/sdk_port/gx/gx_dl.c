@@ -0,0 +1,359 @@
+/*
+ * sdk_port/gx/gx_dl.c --- Display list pre-decoder and replay cache.
+ *
+ * See gx_dl.h. The decoder walks the list exactly like gc_gx_gp_run, but
+ * records what each command does instead of doing it. NOPs (display lists are
+ * padded to 32 bytes with them) decode to nothing.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gx_dl.h"
+#include "gx_gp.h"
+#include "../gc_mem.h"
+
+uint32_t gc_gx_dl_cache_hits;
+uint32_t gc_gx_dl_cache_misses;
+uint32_t gc_gx_dl_cache_revalidations;
+uint32_t gc_gx_dl_cache_invalidations;
+uint32_t gc_gx_dl_cache_evictions;
+
+uint32_t gc_gx_dl_cache_enable = 1;
+uint32_t gc_gx_dl_cache_verify;
+
+enum {
+    DL_OP_BP,
+    DL_OP_CP,
+    DL_OP_XF,       /* a = xf addr, n = word count, b = offset into data */
+    DL_OP_XF_INDX,  /* cmd = opcode, a = payload */
+    DL_OP_DRAW,     /* cmd = prim|fmt, n = nverts, b = offset into data */
+    DL_OP_INVAL,
+    DL_OP_TAIL,     /* b = offset: parse the rest of the list live */
+};
+
+typedef struct {
+    uint8_t kind;
+    uint8_t cmd;
+    uint16_t n;
+    uint32_t a;
+    uint32_t b;
+} GcGxDlOp;
+
+typedef struct {
+    uint32_t addr;
+    uint32_t size;
+    uint32_t hash;
+    uint32_t vtx_key;
+    uint32_t lru;
+    uint8_t valid;
+    uint8_t stale;
+    uint8_t pinned;     /* replay in progress (nested CALL must not evict it) */
+    GcGxDlOp *ops;
+    uint32_t nops;
+    uint32_t cap;
+    uint32_t bad_opcodes;
+    uint8_t *data;      /* private copy of the list bytes */
+} GcGxDlEntry;
+
+static GcGxDlEntry s_entries[GC_GX_DL_CACHE_ENTRIES];
+static uint32_t s_lru_tick;
+static uint32_t s_depth;
+static int s_hook_registered;
+
+static inline uint32_t dl_rd16be(const uint8_t *p) {
+    return ((uint32_t)p[0] << 8) | (uint32_t)p[1];
+}
+
+static inline uint32_t dl_rd32be(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+// FNV-1a, same constants as GX.c:hash_bytes.
+static uint32_t dl_hash(const uint8_t *p, uint32_t n) {
+    uint32_t h = 2166136261u;
+    uint32_t i;
+    for (i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static uint32_t dl_vtx_key(const uint32_t *cp) {
+    uint32_t h = 2166136261u;
+    uint32_t i;
+    h = (h ^ cp[GC_GX_CP_VCD_LO]) * 16777619u;
+    h = (h ^ cp[GC_GX_CP_VCD_HI]) * 16777619u;
+    for (i = 0; i < 8; i++) {
+        h = (h ^ cp[GC_GX_CP_VAT_A + i]) * 16777619u;
+        h = (h ^ cp[GC_GX_CP_VAT_B + i]) * 16777619u;
+        h = (h ^ cp[GC_GX_CP_VAT_C + i]) * 16777619u;
+    }
+    return h;
+}
+
+static void dl_entry_free(GcGxDlEntry *e) {
+    free(e->ops);
+    free(e->data);
+    memset(e, 0, sizeof(*e));
+}
+
+void gc_gx_dl_cache_reset(void) {
+    uint32_t i;
+    for (i = 0; i < GC_GX_DL_CACHE_ENTRIES; i++) {
+        dl_entry_free(&s_entries[i]);
+    }
+    s_lru_tick = 0;
+    s_depth = 0;
+    gc_gx_dl_cache_hits = 0;
+    gc_gx_dl_cache_misses = 0;
+    gc_gx_dl_cache_revalidations = 0;
+    gc_gx_dl_cache_invalidations = 0;
+    gc_gx_dl_cache_evictions = 0;
+}
+
+void gc_gx_dl_invalidate_range(uint32_t addr, size_t len) {
+    const uint64_t lo = addr;
+    const uint64_t hi = (uint64_t)addr + len;
+    uint32_t i;
+    for (i = 0; i < GC_GX_DL_CACHE_ENTRIES; i++) {
+        GcGxDlEntry *e = &s_entries[i];
+        if (!e->valid || e->stale) continue;
+        if ((uint64_t)e->addr < hi && lo < (uint64_t)e->addr + e->size) {
+            e->stale = 1;
+            gc_gx_dl_cache_invalidations++;
+        }
+    }
+}
+
+// ---- Decoder ----
+
+static GcGxDlOp *dl_push(GcGxDlEntry *e) {
+    if (e->nops == e->cap) {
+        uint32_t cap = e->cap ? e->cap * 2u : 16u;
+        GcGxDlOp *ops = (GcGxDlOp *)realloc(e->ops, cap * sizeof(*ops));
+        if (!ops) return 0;
+        e->ops = ops;
+        e->cap = cap;
+    }
+    return &e->ops[e->nops++];
+}
+
+static int dl_decode(GcGxDlEntry *e, const uint8_t *src, uint32_t size) {
+    uint32_t cp[256];
+    uint32_t pos = 0;
+    uint8_t *data = (uint8_t *)realloc(e->data, size);
+
+    if (!data) return 0;
+    e->data = data;
+    memcpy(data, src, size);
+    e->nops = 0;
+    e->bad_opcodes = 0;
+
+    // Draw sizes follow CP writes made by the list itself.
+    memcpy(cp, gc_gx_gp.cp, sizeof(cp));
+
+    while (pos < size) {
+        const uint8_t *p = data + pos;
+        const uint32_t avail = size - pos;
+        const uint32_t cmd = p[0];
+        GcGxDlOp *op;
+        uint32_t len;
+
+        switch (cmd) {
+        case GC_GX_CMD_NOP:
+            pos += 1;
+            continue;
+        case GC_GX_CMD_LOAD_CP_REG:
+            len = 6;
+            if (avail < len) return 1;
+            if (!(op = dl_push(e))) return 0;
+            op->kind = DL_OP_CP;
+            op->a = p[1];
+            op->b = dl_rd32be(p + 2);
+            cp[p[1]] = op->b;
+            break;
+        case GC_GX_CMD_LOAD_XF_REG: {
+            if (avail < 5) return 1;
+            const uint32_t v = dl_rd32be(p + 1);
+            const uint32_t cnt = (v >> 16) + 1u;
+            len = 5u + cnt * 4u;
+            if (avail < len) return 1;
+            if (!(op = dl_push(e))) return 0;
+            op->kind = DL_OP_XF;
+            op->n = (uint16_t)cnt;
+            op->a = v & 0xFFFFu;
+            op->b = pos + 5u;
+            break;
+        }
+        case GC_GX_CMD_LOAD_INDX_A:
+        case GC_GX_CMD_LOAD_INDX_B:
+        case GC_GX_CMD_LOAD_INDX_C:
+        case GC_GX_CMD_LOAD_INDX_D:
+            len = 5;
+            if (avail < len) return 1;
+            if (!(op = dl_push(e))) return 0;
+            op->kind = DL_OP_XF_INDX;
+            op->cmd = (uint8_t)cmd;
+            op->a = dl_rd32be(p + 1);
+            break;
+        case GC_GX_CMD_CALL_DL:
+            // A nested list can change VCD/VAT behind our back, so sizes of the
+            // draws after it are only known at run time. Real hardware does not
+            // support nesting anyway; hand the remainder to the live parser.
+            if (!(op = dl_push(e))) return 0;
+            op->kind = DL_OP_TAIL;
+            op->b = pos;
+            return 1;
+        case GC_GX_CMD_INVAL_VTX:
+            len = 1;
+            if (!(op = dl_push(e))) return 0;
+            op->kind = DL_OP_INVAL;
+            break;
+        case GC_GX_CMD_LOAD_BP_REG:
+            len = 5;
+            if (avail < len) return 1;
+            if (!(op = dl_push(e))) return 0;
+            op->kind = DL_OP_BP;
+            op->a = dl_rd32be(p + 1);
+            break;
+        default:
+            if (cmd >= GC_GX_CMD_DRAW_FIRST && cmd <= GC_GX_CMD_DRAW_LAST) {
+                if (avail < 3) return 1;
+                const uint32_t nverts = dl_rd16be(p + 1);
+                len = 3u + nverts * gc_gx_gp_vertex_size_cp(cp, cmd);
+                if (avail < len) return 1;
+                if (!(op = dl_push(e))) return 0;
+                op->kind = DL_OP_DRAW;
+                op->cmd = (uint8_t)cmd;
+                op->n = (uint16_t)nverts;
+                op->b = pos + 3u;
+            } else {
+                // Keep the uncached path's behavior for bad bytes: skip one.
+                e->bad_opcodes++;
+                len = 1;
+            }
+            break;
+        }
+        pos += len;
+    }
+    return 1;
+}
+
+// ---- Replay ----
+
+static void dl_replay(const GcGxDlEntry *e) {
+    const GcGxDlOp *op = e->ops;
+    const GcGxDlOp *end = e->ops + e->nops;
+
+    gc_gx_gp.bad_opcodes += e->bad_opcodes;
+    for (; op != end; op++) {
+        switch (op->kind) {
+        case DL_OP_BP:      gc_gx_gp_write_bp(op->a); break;
+        case DL_OP_CP:      gc_gx_gp_write_cp(op->a, op->b); break;
+        case DL_OP_XF:      gc_gx_gp_write_xf(op->a, op->n, e->data + op->b); break;
+        case DL_OP_XF_INDX: gc_gx_gp_load_indexed(op->cmd, op->a); break;
+        case DL_OP_DRAW:    gc_gx_gp_draw(op->cmd, op->n, e->data + op->b); break;
+        case DL_OP_INVAL:   gc_gx_gp_invalidate_vtx(); break;
+        case DL_OP_TAIL:    gc_gx_gp_run(e->data + op->b, e->size - op->b); break;
+        default: break;
+        }
+    }
+}
+
+static GcGxDlEntry *dl_find(uint32_t addr, uint32_t size, uint32_t vtx_key) {
+    uint32_t i;
+    for (i = 0; i < GC_GX_DL_CACHE_ENTRIES; i++) {
+        GcGxDlEntry *e = &s_entries[i];
+        if (e->valid && e->addr == addr && e->size == size && e->vtx_key == vtx_key) {
+            return e;
+        }
+    }
+    return 0;
+}
+
+static GcGxDlEntry *dl_alloc(void) {
+    GcGxDlEntry *victim = 0;
+    uint32_t i;
+    for (i = 0; i < GC_GX_DL_CACHE_ENTRIES; i++) {
+        GcGxDlEntry *e = &s_entries[i];
+        if (e->pinned) continue;
+        if (!e->valid) return e;
+        if (!victim || e->lru < victim->lru) victim = e;
+    }
+    if (victim) {
+        gc_gx_dl_cache_evictions++;
+        victim->valid = 0;
+    }
+    return victim;
+}
+
+void gc_gx_dl_call(uint32_t addr, uint32_t size) {
+    const uint8_t *src = gc_mem_ptr(addr, size);
+    GcGxDlEntry *e;
+    GcGxDlEntry *reuse = 0;
+    uint32_t vtx_key;
+
+    if (!src || size == 0) return;
+    if (s_depth >= GC_GX_DL_MAX_DEPTH) return;
+    if (gc_gx_gp_mem_hook) gc_gx_gp_mem_hook(addr, size, 0);
+    s_depth++;
+
+    if (!gc_gx_dl_cache_enable) {
+        gc_gx_gp_run(src, size);
+        s_depth--;
+        return;
+    }
+    if (!s_hook_registered) {
+        s_hook_registered = gc_mem_add_write_hook(gc_gx_dl_invalidate_range) == 0;
+    }
+
+    vtx_key = dl_vtx_key(gc_gx_gp.cp);
+    e = dl_find(addr, size, vtx_key);
+    if (e && (e->stale || gc_gx_dl_cache_verify)) {
+        if (dl_hash(src, size) == e->hash) {
+            if (e->stale) gc_gx_dl_cache_revalidations++;
+            else gc_gx_dl_cache_hits++;
+            e->stale = 0;
+        } else if (e->pinned) {
+            // The list rewrote itself while an outer call is still replaying it.
+            gc_gx_dl_cache_misses++;
+            gc_gx_gp_run(src, size);
+            s_depth--;
+            return;
+        } else {
+            gc_gx_dl_cache_misses++;
+            e->valid = 0;
+            reuse = e;
+            e = 0;
+        }
+    } else if (e) {
+        gc_gx_dl_cache_hits++;
+    } else {
+        gc_gx_dl_cache_misses++;
+    }
+
+    if (!e) {
+        e = reuse ? reuse : dl_alloc();
+        if (!e || !dl_decode(e, src, size)) {
+            // Out of slots (every entry pinned by nested calls) or out of memory.
+            if (e) dl_entry_free(e);
+            gc_gx_gp_run(src, size);
+            s_depth--;
+            return;
+        }
+        e->addr = addr;
+        e->size = size;
+        e->hash = dl_hash(src, size);
+        e->vtx_key = vtx_key;
+        e->valid = 1;
+        e->stale = 0;
+    }
+
+    e->lru = ++s_lru_tick;
+    e->pinned++;
+    dl_replay(e);
+    e->pinned--;
+    s_depth--;
+}
@@ -0,0 +1,37 @@
+/*
+ * sdk_port/gx/gx_dl.h --- Display list pre-decoder and replay cache.
+ *
+ * GXCallDisplayList (and CALL_DL commands in the stream) land here. The first
+ * call for a given list decodes its bytes once into a compact op array; later
+ * calls replay the ops straight into gx_gp without re-parsing the stream.
+ *
+ * Entries are keyed by list address + size + the CP vertex state at call time
+ * (draw sizes depend on VCD/VAT), and validated by a content hash. Ranges
+ * reported through gc_mem_notify_write mark overlapping entries stale; a stale
+ * entry is rehashed on its next call and reused if the bytes did not change.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define GC_GX_DL_CACHE_ENTRIES 64
+#define GC_GX_DL_MAX_DEPTH     8
+
+/* Cache counters (reset by gc_gx_dl_cache_reset). */
+extern uint32_t gc_gx_dl_cache_hits;
+extern uint32_t gc_gx_dl_cache_misses;
+extern uint32_t gc_gx_dl_cache_revalidations;
+extern uint32_t gc_gx_dl_cache_invalidations;
+extern uint32_t gc_gx_dl_cache_evictions;
+
+/* 0 = always parse the raw bytes (reference path). Default 1. */
+extern uint32_t gc_gx_dl_cache_enable;
+/* 1 = rehash list bytes on every hit (catches writes nobody reported). */
+extern uint32_t gc_gx_dl_cache_verify;
+
+void gc_gx_dl_cache_reset(void);
+void gc_gx_dl_invalidate_range(uint32_t addr, size_t len);
+
+/* Execute the display list at GC address addr (size bytes) on gx_gp. */
+void gc_gx_dl_call(uint32_t addr, uint32_t size);
@@ -0,0 +1,406 @@
+/*
+ * sdk_port/gx/gx_fifo.c --- CPU/GP command FIFO.
+ *
+ * See gx_fifo.h. The producer (CPU thread) owns the write pointer and the
+ * bytes written since the last kick; the GP side owns the read pointer and
+ * the staging buffer. count (kicked, not yet read) is shared: the producer
+ * adds to it on a kick and the GP subtracts as it reads.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gx_fifo.h"
+#include "gx_gp.h"
+#include "gx_trace.h"
+#include "../gc_mem.h"
+
+#ifdef GC_GX_FIFO_THREADS
+#include <pthread.h>
+#endif
+
+GcGxFifoStats gc_gx_fifo_stats;
+uint32_t gc_gx_fifo_threaded = 1;
+
+static GcGxFifoInfo s_fi;           // count = kicked bytes not yet read
+static uint8_t *s_fi_ring;
+static uint8_t *s_fi_host;          // ring allocated here (no usable base)
+static uint32_t s_fi_pending;       // written since the last kick
+static uint64_t s_fi_written;       // stream offsets
+static uint64_t s_fi_read;
+
+static uint8_t *s_fi_stage;         // command cut by the ring end or a kick
+static uint32_t s_fi_stage_len;
+static uint32_t s_fi_stage_cap;
+
+static uint32_t s_fi_ints;          // latched PE interrupts
+static uint16_t s_fi_token;
+
+#ifdef GC_GX_FIFO_THREADS
+// RAM write notices from the CPU thread, applied at stream offset pos.
+typedef struct {
+    uint64_t pos;
+    uint32_t addr;
+    uint32_t len;
+} FiNotice;
+
+#define FI_NOTICES 256u
+
+static pthread_mutex_t s_fi_mu = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_fi_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t s_fi_room = PTHREAD_COND_INITIALIZER;
+static pthread_t s_fi_tid;
+static int s_fi_running;
+static int s_fi_quit;
+static int s_fi_busy;
+static uint32_t s_fi_avail;         // kicked bytes the thread has not taken yet
+static FiNotice s_fi_notice[FI_NOTICES];
+static uint32_t s_fi_nhead;
+static uint32_t s_fi_ntail;
+static __thread int s_fi_on_gp;
+
+#define FI_LOCK()   pthread_mutex_lock(&s_fi_mu)
+#define FI_UNLOCK() pthread_mutex_unlock(&s_fi_mu)
+// s_fi.count changes under the lock but fi_count reads it without; keep
+// the writes atomic so that read is not a race.
+#define FI_COUNT_ADD(n) __atomic_add_fetch(&s_fi.count, (n), __ATOMIC_RELAXED)
+#define FI_COUNT_SUB(n) __atomic_sub_fetch(&s_fi.count, (n), __ATOMIC_RELAXED)
+#else
+#define FI_LOCK()   ((void)0)
+#define FI_UNLOCK() ((void)0)
+#define FI_COUNT_ADD(n) (s_fi.count += (n))
+#define FI_COUNT_SUB(n) (s_fi.count -= (n))
+#endif
+
+// ---- GP side ----
+
+static void fi_pe(uint32_t id, uint32_t val) {
+    if (id == 0x45u) {
+        s_fi_ints |= GC_GX_FIFO_INT_DONE;
+        return;
+    }
+    s_fi_token = (uint16_t)val;
+    if (id == 0x48u) s_fi_ints |= GC_GX_FIFO_INT_TOKEN;
+}
+
+static void fi_stage(const uint8_t *p, uint32_t n) {
+    if (s_fi_stage_len + n > s_fi_stage_cap) {
+        uint32_t cap = s_fi_stage_cap ? s_fi_stage_cap * 2u : 0x1000u;
+        uint8_t *buf;
+        while (cap < s_fi_stage_len + n) cap *= 2u;
+        buf = (uint8_t *)realloc(s_fi_stage, cap);
+        if (!buf) return;
+        s_fi_stage = buf;
+        s_fi_stage_cap = cap;
+    }
+    memcpy(s_fi_stage + s_fi_stage_len, p, n);
+    s_fi_stage_len += n;
+    gc_gx_fifo_stats.staged += n;
+}
+
+// Run the whole commands in p[0..n); keep a trailing partial one.
+static void fi_run(const uint8_t *p, uint32_t n) {
+    uint32_t done;
+
+    if (s_fi_stage_len) {
+        fi_stage(p, n);
+        p = s_fi_stage;
+        n = s_fi_stage_len;
+    }
+    done = gc_gx_gp_run(p, n);
+    if (gc_gx_trace_hook && done) gc_gx_trace_hook(GC_GX_TRACE_CMD, p, done);
+    if (p == s_fi_stage) {
+        memmove(s_fi_stage, s_fi_stage + done, n - done);
+        s_fi_stage_len = n - done;
+    } else if (done < n) {
+        fi_stage(p + done, n - done);
+    }
+}
+
+#ifdef GC_GX_FIFO_THREADS
+// Apply the notices due at the current read offset; returns how far the GP
+// may read before the next one.
+static uint32_t fi_notices(uint32_t seg) {
+    FI_LOCK();
+    while (s_fi_nhead != s_fi_ntail && s_fi_notice[s_fi_nhead % FI_NOTICES].pos <= s_fi_read) {
+        const FiNotice *e = &s_fi_notice[s_fi_nhead % FI_NOTICES];
+        gc_mem_run_write_hooks(e->addr, e->len);
+        s_fi_nhead++;
+    }
+    if (s_fi_nhead != s_fi_ntail) {
+        const uint64_t next = s_fi_notice[s_fi_nhead % FI_NOTICES].pos;
+        if (next < s_fi_read + seg) seg = (uint32_t)(next - s_fi_read);
+    }
+    FI_UNLOCK();
+    return seg;
+}
+#endif
+
+// Read n kicked bytes from the read pointer.
+static void fi_consume(uint32_t n) {
+    for (;;) {
+        uint32_t seg = s_fi.size - s_fi.rp;
+        if (seg > n) seg = n;
+#ifdef GC_GX_FIFO_THREADS
+        if (s_fi_running) seg = fi_notices(seg);
+#endif
+        if (!n) break;
+        fi_run(s_fi_ring + s_fi.rp, seg);
+        n -= seg;
+        FI_LOCK();
+        s_fi.rp += seg;
+        if (s_fi.rp == s_fi.size) s_fi.rp = 0;
+        s_fi_read += seg;
+        FI_COUNT_SUB(seg);
+        gc_gx_fifo_stats.consumed += seg;
+#ifdef GC_GX_FIFO_THREADS
+        if (s_fi.count <= s_fi.lo) pthread_cond_broadcast(&s_fi_room);
+#endif
+        FI_UNLOCK();
+    }
+}
+
+// ---- Consumer thread ----
+
+#ifdef GC_GX_FIFO_THREADS
+static int fi_notice_due(void) {
+    return s_fi_nhead != s_fi_ntail && s_fi_notice[s_fi_nhead % FI_NOTICES].pos <= s_fi_read;
+}
+
+static void *fi_thread(void *arg) {
+    (void)arg;
+    s_fi_on_gp = 1;
+    FI_LOCK();
+    for (;;) {
+        uint32_t n;
+        while (!s_fi_quit && !s_fi_avail && !fi_notice_due()) pthread_cond_wait(&s_fi_work, &s_fi_mu);
+        if (!s_fi_avail && !fi_notice_due()) break;
+        n = s_fi_avail;
+        s_fi_avail = 0;
+        s_fi_busy = 1;
+        FI_UNLOCK();
+        fi_consume(n);
+        FI_LOCK();
+        s_fi_busy = 0;
+        pthread_cond_broadcast(&s_fi_room);
+    }
+    FI_UNLOCK();
+    return NULL;
+}
+
+static void fi_wait_idle(void) {
+    if (!s_fi_running) return;
+    FI_LOCK();
+    while (s_fi_avail || s_fi_busy || fi_notice_due()) pthread_cond_wait(&s_fi_room, &s_fi_mu);
+    FI_UNLOCK();
+}
+
+// CPU-side RAM writes reach the GP caches in stream order; the GP's own
+// writes (EFB copies) and writes while it is idle apply at once.
+static int fi_defer_write(uint32_t addr, size_t len) {
+    if (s_fi_on_gp) return 0;
+    FI_LOCK();
+    if (!s_fi_busy && !s_fi_avail && s_fi_nhead == s_fi_ntail) {
+        FI_UNLOCK();
+        return 0;
+    }
+    if (s_fi_ntail - s_fi_nhead == FI_NOTICES) {
+        FI_UNLOCK();
+        gc_gx_fifo_kick();
+        fi_wait_idle();
+        return 0;
+    }
+    s_fi_notice[s_fi_ntail % FI_NOTICES].pos = s_fi_written;
+    s_fi_notice[s_fi_ntail % FI_NOTICES].addr = addr;
+    s_fi_notice[s_fi_ntail % FI_NOTICES].len = (uint32_t)len;
+    s_fi_ntail++;
+    gc_gx_fifo_stats.deferred++;
+    pthread_cond_signal(&s_fi_work);
+    FI_UNLOCK();
+    return 1;
+}
+
+static void fi_stop(void) {
+    if (!s_fi_running) return;
+    FI_LOCK();
+    s_fi_quit = 1;
+    pthread_cond_signal(&s_fi_work);
+    FI_UNLOCK();
+    pthread_join(s_fi_tid, NULL);
+    s_fi_running = 0;
+    s_fi_quit = 0;
+    gc_mem_write_defer = 0;
+    // Notices past the kicked bytes go first, as they would without the thread.
+    while (s_fi_nhead != s_fi_ntail) {
+        const FiNotice *e = &s_fi_notice[s_fi_nhead++ % FI_NOTICES];
+        gc_mem_run_write_hooks(e->addr, e->len);
+    }
+}
+
+static int fi_start(void) {
+    if (s_fi_running) return 1;
+    if (pthread_create(&s_fi_tid, NULL, fi_thread, NULL) != 0) return 0;
+    s_fi_running = 1;
+    gc_mem_write_defer = fi_defer_write;
+    return 1;
+}
+#else
+static void fi_wait_idle(void) {}
+#endif
+
+// Kicked bytes go to the consumer thread unless it is off or a trace is
+// being recorded (trace records must follow the CPU's order).
+static int fi_async(void) {
+#ifdef GC_GX_FIFO_THREADS
+    if (gc_gx_fifo_threaded && !gc_gx_trace_hook) return fi_start();
+    fi_stop();
+#endif
+    return 0;
+}
+
+// ---- CPU side ----
+
+void gc_gx_fifo_kick(void) {
+    const int async = fi_async();
+    const uint32_t n = s_fi_pending;
+
+    if (!n) return;
+    s_fi_pending = 0;
+    gc_gx_fifo_stats.kicks++;
+    FI_LOCK();
+    FI_COUNT_ADD(n);
+    if (s_fi.count > gc_gx_fifo_stats.max_count) gc_gx_fifo_stats.max_count = s_fi.count;
+#ifdef GC_GX_FIFO_THREADS
+    if (async) {
+        s_fi_avail += n;
+        gc_gx_fifo_stats.threaded++;
+        pthread_cond_signal(&s_fi_work);
+        FI_UNLOCK();
+        return;
+    }
+#else
+    (void)async;
+#endif
+    FI_UNLOCK();
+    fi_consume(n);
+}
+
+// Hi watermark: let the GP read down to the lo watermark.
+static void fi_overflow(void) {
+    gc_gx_fifo_stats.overflows++;
+    gc_gx_fifo_kick();
+#ifdef GC_GX_FIFO_THREADS
+    FI_LOCK();
+    while (s_fi.count > s_fi.lo) pthread_cond_wait(&s_fi_room, &s_fi_mu);
+    FI_UNLOCK();
+#endif
+}
+
+static uint32_t fi_count(void) {
+#ifdef GC_GX_FIFO_THREADS
+    return __atomic_load_n(&s_fi.count, __ATOMIC_RELAXED);
+#else
+    return s_fi.count;
+#endif
+}
+
+void gc_gx_fifo_write(const uint8_t *p, uint32_t n) {
+    if (!s_fi_ring) gc_gx_fifo_init(0, 0);
+    while (n) {
+        uint32_t chunk = s_fi.size - s_fi.wp;
+
+        if (fi_count() + s_fi_pending >= s_fi.hi) fi_overflow();
+        if (chunk > n) chunk = n;
+        if (chunk > s_fi.size - (fi_count() + s_fi_pending)) {
+            chunk = s_fi.size - (fi_count() + s_fi_pending);
+        }
+        memcpy(s_fi_ring + s_fi.wp, p, chunk);
+        s_fi.wp += chunk;
+        if (s_fi.wp == s_fi.size) {
+            s_fi.wp = 0;
+            gc_gx_fifo_stats.wraps++;
+        }
+        s_fi_pending += chunk;
+        s_fi_written += chunk;
+        gc_gx_fifo_stats.written += chunk;
+        p += chunk;
+        n -= chunk;
+    }
+    if (s_fi_pending >= GC_GX_FIFO_KICK_BYTES) gc_gx_fifo_kick();
+}
+
+void gc_gx_fifo_drain(void) {
+    gc_gx_fifo_kick();
+    fi_wait_idle();
+}
+
+uint32_t gc_gx_fifo_sync(uint16_t *token) {
+    uint32_t ints;
+
+    gc_gx_fifo_drain();
+    ints = s_fi_ints;
+    s_fi_ints = 0;
+    if (token) *token = s_fi_token;
+    gc_gx_fifo_stats.syncs++;
+    if (ints & GC_GX_FIFO_INT_TOKEN) gc_gx_fifo_stats.tokens++;
+    if (ints & GC_GX_FIFO_INT_DONE) gc_gx_fifo_stats.draw_dones++;
+    return ints;
+}
+
+void gc_gx_fifo_init(void *base, uint32_t size) {
+    const uint32_t addr = (uint32_t)(uintptr_t)base;
+    uint8_t *ring = 0;
+
+    // Finish what the GP already has; drop what was never kicked.
+    fi_wait_idle();
+#ifdef GC_GX_FIFO_THREADS
+    if (s_fi_running) {
+        FI_LOCK();
+        while (s_fi_nhead != s_fi_ntail) {
+            const FiNotice *e = &s_fi_notice[s_fi_nhead++ % FI_NOTICES];
+            gc_mem_run_write_hooks(e->addr, e->len);
+        }
+        FI_UNLOCK();
+    }
+#endif
+    size &= ~31u;
+    memset(&s_fi, 0, sizeof(s_fi));
+    if (size >= GC_GX_FIFO_MIN_SIZE) {
+        ring = gc_mem_ptr(addr, size);
+        if (ring) {
+            s_fi.base = addr;
+        } else if (base && ((uintptr_t)base != (uintptr_t)addr || addr < 0x80000000u)) {
+            // A host pointer rather than a GC address: the caller's own buffer.
+            ring = (uint8_t *)base;
+        }
+    }
+    if (ring) {
+        s_fi.size = size;
+    } else {
+        if (!s_fi_host) s_fi_host = (uint8_t *)malloc(GC_GX_FIFO_MIN_SIZE);
+        ring = s_fi_host;
+        s_fi.size = GC_GX_FIFO_MIN_SIZE;
+    }
+    s_fi.hi = s_fi.size - GC_GX_FIFO_HI_GAP;
+    s_fi.lo = (s_fi.size >> 1) & ~31u;
+    s_fi_ring = ring;
+    s_fi_pending = 0;
+    s_fi_written = 0;
+    s_fi_read = 0;
+    s_fi_stage_len = 0;
+    s_fi_ints = 0;
+    s_fi_token = 0;
+    gc_gx_gp_pe_hook = fi_pe;
+}
+
+void gc_gx_fifo_info(GcGxFifoInfo *info) {
+    FI_LOCK();
+    *info = s_fi;
+    FI_UNLOCK();
+    info->count += s_fi_pending;
+}
+
+void gc_gx_fifo_shutdown(void) {
+#ifdef GC_GX_FIFO_THREADS
+    fi_stop();
+#endif
+}
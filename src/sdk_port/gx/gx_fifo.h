@@ -0,0 +1,97 @@
+/*
+ * sdk_port/gx/gx_fifo.h --- CPU/GP command FIFO.
+ *
+ * GXInit(base, size) places the FIFO: a ring of size bytes in emulated RAM
+ * at base, in the caller's buffer when base is not a GC address, or in a
+ * 64K host buffer for GXInit(0, 0). GX.c is the producer: gc_gx_fifo_write
+ * appends at the write pointer and gc_gx_fifo_kick hands everything written
+ * so far to the GP (GXEnd, GXFlush, and every GC_GX_FIFO_KICK_BYTES). The GP
+ * side reads from the read pointer and runs whole commands through
+ * gc_gx_gp_run; a command cut by the end of the ring or by a kick is carried
+ * over in a staging buffer.
+ *
+ * Watermarks follow GXInitFifoBase: hi = size - 16K, lo = size / 2. When
+ * the bytes in flight reach hi the producer stops until the GP has read
+ * them down to lo (an overflow: on hardware the FIFO interrupt suspends the
+ * writing thread).
+ *
+ * Builds that define GC_GX_FIFO_THREADS (and link pthreads) run the GP side
+ * on a consumer thread while gc_gx_fifo_threaded is set, so CPU-side game
+ * work overlaps command processing; otherwise a kick runs it inline. While
+ * the consumer thread owns the GP:
+ *   - gc_mem_notify_write calls from the CPU thread are queued and reach
+ *     the GP caches between the commands written before and after them;
+ *   - the CPU reads GP results (EFB, counters, PE token) only after
+ *     gc_gx_fifo_sync, which waits for the FIFO to drain.
+ * Commands run inline while a trace (gx_trace.c) is being recorded.
+ *
+ * PE tokens and draw done: BP 0x47 and 0x48 set the token register, and
+ * BP 0x48 / BP 0x45 also raise the token / finish interrupt. Interrupts
+ * latch like PE_INTRPT and are only handed to the CPU by gc_gx_fifo_sync,
+ * so callbacks run at the same points with or without the thread.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define GC_GX_FIFO_MIN_SIZE    0x10000u
+#define GC_GX_FIFO_HI_GAP      0x4000u     /* hi watermark = size - this */
+#define GC_GX_FIFO_KICK_BYTES  0x4000u
+
+/* Latched PE interrupts returned by gc_gx_fifo_sync. */
+#define GC_GX_FIFO_INT_TOKEN  1u
+#define GC_GX_FIFO_INT_DONE   2u
+
+typedef struct {
+    uint32_t base;           /* GC address of the ring, 0 for a host buffer */
+    uint32_t size;
+    uint32_t hi;             /* watermarks, in bytes in flight */
+    uint32_t lo;
+    uint32_t wp;             /* ring offsets */
+    uint32_t rp;
+    uint32_t count;          /* written, not yet read by the GP */
+} GcGxFifoInfo;
+
+typedef struct {
+    uint64_t written;        /* bytes produced */
+    uint64_t consumed;       /* bytes read by the GP */
+    uint64_t staged;         /* bytes copied to the staging buffer */
+    uint32_t kicks;
+    uint32_t wraps;          /* write pointer wrapped */
+    uint32_t overflows;      /* producer stopped at the hi watermark */
+    uint32_t max_count;      /* peak bytes in flight */
+    uint32_t syncs;
+    uint32_t tokens;         /* token interrupts handed to the CPU */
+    uint32_t draw_dones;     /* finish interrupts handed to the CPU */
+    uint32_t deferred;       /* RAM write notices queued for the GP */
+    uint32_t threaded;       /* kicks taken by the consumer thread */
+} GcGxFifoStats;
+
+extern GcGxFifoStats gc_gx_fifo_stats;
+
+/* Consumer thread on/off (GC_GX_FIFO_THREADS builds only). Default 1. */
+extern uint32_t gc_gx_fifo_threaded;
+
+/*
+ * Place the FIFO (GXInit). Waits for the GP to finish what was kicked;
+ * bytes written but not kicked are dropped, as is any latched interrupt.
+ */
+void gc_gx_fifo_init(void *base, uint32_t size);
+
+void gc_gx_fifo_write(const uint8_t *p, uint32_t n);
+void gc_gx_fifo_kick(void);
+
+/* Kick and wait until the GP has run every command written so far. */
+void gc_gx_fifo_drain(void);
+
+/*
+ * gc_gx_fifo_drain, then hand over the PE interrupts: returns
+ * the interrupts latched since the last sync (GC_GX_FIFO_INT_*) and clears
+ * them; *token receives the PE token register.
+ */
+uint32_t gc_gx_fifo_sync(uint16_t *token);
+
+void gc_gx_fifo_info(GcGxFifoInfo *info);
+
+/* Stop the consumer thread (it restarts on the next kick). */
+void gc_gx_fifo_shutdown(void);
@@ -0,0 +1,277 @@
+/*
+ * sdk_port/gx/gx_gp.c --- Host-side model of the GP command processor.
+ *
+ * Consumes the big-endian command stream produced by GX.c (immediate mode)
+ * or stored in RAM (display lists). See gx_gp.h.
+ */
+#include <stdint.h>
+#include <string.h>
+#include "gx_gp.h"
+#include "gx_dl.h"
+#include "gx_vtx.h"
+#include "gx_xf.h"
+#include "gx_raster.h"
+#include "gx_texdec.h"
+#include "gx_texcopy.h"
+#include "../gc_mem.h"
+
+GcGxGpState gc_gx_gp;
+void (*gc_gx_gp_mem_hook)(uint32_t addr, uint32_t size, int write);
+void (*gc_gx_gp_pe_hook)(uint32_t id, uint32_t val);
+
+static inline uint32_t gp_rd16be(const uint8_t *p) {
+    return ((uint32_t)p[0] << 8) | (uint32_t)p[1];
+}
+
+static inline uint32_t gp_rd32be(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+void gc_gx_gp_reset(void) {
+    memset(&gc_gx_gp, 0, sizeof(gc_gx_gp));
+    gc_gx_gp.bp_mask = 0xFFFFFFu;
+}
+
+// ---- Register files ----
+
+void gc_gx_gp_write_bp(uint32_t v) {
+    const uint32_t id = v >> 24;
+    const uint32_t val = v & 0xFFFFFFu;
+
+    gc_gx_gp.bp_writes++;
+    if (id == 0xFEu) {
+        // BP mask applies to the next BP write only.
+        gc_gx_gp.bp_mask = val;
+        return;
+    }
+    gc_gx_gp.bp[id] = (gc_gx_gp.bp[id] & ~gc_gx_gp.bp_mask) | (val & gc_gx_gp.bp_mask);
+    gc_gx_gp.bp_mask = 0xFFFFFFu;
+
+    switch (id) {
+    case 0xE0u: case 0xE1u: case 0xE2u: case 0xE3u:
+    case 0xE4u: case 0xE5u: case 0xE6u: case 0xE7u:
+        // TEV registers and konst colors share addresses; bit 23 picks the file.
+        if ((gc_gx_gp.bp[id] >> 23) & 1u) gc_gx_gp.tev_konst[id - 0xE0u] = gc_gx_gp.bp[id];
+        else gc_gx_gp.tev_reg[id - 0xE0u] = gc_gx_gp.bp[id];
+        break;
+    case 0x65u:  // TLUT load: RAM address in 0x64, TMEM offset 0..9, 16-entry count 10..20
+        if (gc_gx_gp_mem_hook) {
+            gc_gx_gp_mem_hook(((gc_gx_gp.bp[0x64] & 0x1FFFFFu) << 5) | 0x80000000u,
+                              ((val >> 10) & 0x7FFu) * 32u, 0);
+        }
+        gc_gx_texdec_load_tlut((gc_gx_gp.bp[0x64] & 0x1FFFFFu) << 5, val & 0x3FFu,
+                               (val >> 10) & 0x7FFu);
+        break;
+    case 0x45u:  // PE_DONE
+        gc_gx_raster_flush();
+        if (gc_gx_gp_pe_hook) gc_gx_gp_pe_hook(id, val);
+        break;
+    case 0x47u:  // PE_TOKEN
+    case 0x48u:  // PE_TOKEN_INT
+        if (gc_gx_gp_pe_hook) gc_gx_gp_pe_hook(id, val & 0xFFFFu);
+        break;
+    case 0x52u:  // copy execute; bit 11 clears the source rectangle after the copy
+        gc_gx_raster_flush();
+        gc_gx_texcopy_run(&gc_gx_efb, &gc_gx_gp);
+        if ((val >> 11) & 1u) gc_gx_raster_copy_clear(&gc_gx_efb, &gc_gx_gp);
+        break;
+    case 0x55u:  // bounding box left / right
+    case 0x56u:  // bounding box top / bottom
+        gc_gx_raster_bbox_write(id, val);
+        break;
+    default:
+        break;
+    }
+}
+
+void gc_gx_gp_write_cp(uint32_t addr, uint32_t v) {
+    gc_gx_gp.cp_writes++;
+    gc_gx_gp.cp[addr & 0xFFu] = v;
+}
+
+void gc_gx_gp_write_xf(uint32_t addr, uint32_t n, const uint8_t *words) {
+    uint32_t i;
+    gc_gx_gp.xf_writes += n;
+    for (i = 0; i < n; i++, addr++) {
+        const uint32_t v = gp_rd32be(words + i * 4u);
+        if (addr < GC_GX_XF_MEM_SIZE) {
+            gc_gx_gp.xf_mem[addr] = v;
+        } else if (addr >= GC_GX_XF_REG_BASE && addr < GC_GX_XF_REG_BASE + GC_GX_XF_REG_COUNT) {
+            gc_gx_gp.xf_regs[addr - GC_GX_XF_REG_BASE] = v;
+        }
+        // Other XF addresses are unmapped on hardware; drop them.
+    }
+}
+
+void gc_gx_gp_load_indexed(uint32_t cmd, uint32_t v) {
+    // Payload: index (16) | (count-1) (4) | xf addr (12). Source array is
+    // CP array 12..15 selected by the opcode.
+    const uint32_t array = 12u + ((cmd - GC_GX_CMD_LOAD_INDX_A) >> 3);
+    const uint32_t index = v >> 16;
+    const uint32_t n = ((v >> 12) & 0xFu) + 1u;
+    const uint32_t addr = v & 0xFFFu;
+    const uint32_t base = gc_gx_gp.cp[GC_GX_CP_ARRAY_BASE + array];
+    const uint32_t stride = gc_gx_gp.cp[GC_GX_CP_ARRAY_STRIDE + array];
+
+    // CP array bases are physical; GC RAM is mapped at 0x80000000.
+    const uint8_t *src = gc_mem_ptr((base | 0x80000000u) + index * stride, n * 4u);
+    if (!src) return;
+    if (gc_gx_gp_mem_hook) gc_gx_gp_mem_hook((base | 0x80000000u) + index * stride, n * 4u, 0);
+    gc_gx_gp_write_xf(addr, n, src);
+}
+
+void gc_gx_gp_invalidate_vtx(void) {
+    gc_gx_gp.vtx_inval++;
+    gc_gx_vtx_vc_invalidate();
+}
+
+void gc_gx_gp_draw(uint32_t cmd, uint32_t nverts, const uint8_t *data) {
+    gc_gx_gp.draws++;
+    gc_gx_gp.verts += nverts;
+    if (gc_gx_vtx_enable &&
+        gc_gx_vtx_decode(&gc_gx_vtx, gc_gx_gp.cp, cmd & 7u, nverts, data) &&
+        gc_gx_xf_enable &&
+        gc_gx_xf_run(&gc_gx_xf, &gc_gx_vtx, gc_gx_gp.xf_mem, gc_gx_gp.xf_regs) &&
+        gc_gx_raster_enable) {
+        gc_gx_raster_draw(&gc_gx_efb, &gc_gx_xf, cmd, &gc_gx_gp);
+    }
+}
+
+// ---- Vertex sizing (VCD/VAT) ----
+
+// GXCompType: U8, S8, U16, S16, F32.
+static const uint8_t k_comp_size[8] = { 1, 1, 2, 2, 4, 0, 0, 0 };
+// GXCompType for colors: RGB565, RGB8, RGBX8, RGBA4, RGBA6, RGBA8.
+static const uint8_t k_clr_size[8] = { 2, 3, 4, 2, 3, 4, 0, 0 };
+
+// VAT location of texcoord n: which VAT word (0=A, 1=B, 2=C) and the bit of
+// its cnt field (the 3-bit fmt field follows immediately).
+static const uint8_t k_tex_vat_word[8] = { 0, 1, 1, 1, 1, 2, 2, 2 };
+static const uint8_t k_tex_vat_shift[8] = { 21, 0, 9, 18, 27, 5, 14, 23 };
+
+static inline uint32_t attr_size(uint32_t mode, uint32_t direct_size) {
+    switch (mode) {
+    case 1: return direct_size;  // GX_DIRECT
+    case 2: return 1;            // GX_INDEX8
+    case 3: return 2;            // GX_INDEX16
+    default: return 0;           // GX_NONE
+    }
+}
+
+uint32_t gc_gx_gp_vertex_size_cp(const uint32_t *cp, uint32_t vtxfmt) {
+    const uint32_t f = vtxfmt & 7u;
+    const uint32_t vcd_lo = cp[GC_GX_CP_VCD_LO];
+    const uint32_t vcd_hi = cp[GC_GX_CP_VCD_HI];
+    const uint32_t vat[3] = { cp[GC_GX_CP_VAT_A + f], cp[GC_GX_CP_VAT_B + f], cp[GC_GX_CP_VAT_C + f] };
+    uint32_t size = 0;
+    uint32_t i, mode;
+
+    // PNMTXIDX + TEX0..7MTXIDX: one byte each, always direct.
+    for (i = 0; i < 9; i++) {
+        size += (vcd_lo >> i) & 1u;
+    }
+
+    mode = (vcd_lo >> 9) & 3u;
+    size += attr_size(mode, ((vat[0] & 1u) ? 3u : 2u) * k_comp_size[(vat[0] >> 1) & 7u]);
+
+    mode = (vcd_lo >> 11) & 3u;
+    if (mode != 0) {
+        const uint32_t nbt = (vat[0] >> 9) & 1u;
+        const uint32_t nbt3 = (vat[0] >> 31) & 1u;
+        if (mode == 1u) {
+            size += (nbt ? 9u : 3u) * k_comp_size[(vat[0] >> 10) & 7u];
+        } else {
+            size += (nbt && nbt3 ? 3u : 1u) * (mode == 2u ? 1u : 2u);
+        }
+    }
+
+    mode = (vcd_lo >> 13) & 3u;
+    size += attr_size(mode, k_clr_size[(vat[0] >> 14) & 7u]);
+    mode = (vcd_lo >> 15) & 3u;
+    size += attr_size(mode, k_clr_size[(vat[0] >> 18) & 7u]);
+
+    for (i = 0; i < 8; i++) {
+        mode = (vcd_hi >> (i * 2u)) & 3u;
+        if (mode != 0) {
+            const uint32_t w = vat[k_tex_vat_word[i]] >> k_tex_vat_shift[i];
+            size += attr_size(mode, ((w & 1u) ? 2u : 1u) * k_comp_size[(w >> 1) & 7u]);
+        }
+    }
+    return size;
+}
+
+uint32_t gc_gx_gp_vertex_size(uint32_t vtxfmt) {
+    return gc_gx_gp_vertex_size_cp(gc_gx_gp.cp, vtxfmt);
+}
+
+// ---- Stream parser ----
+
+uint32_t gc_gx_gp_run(const uint8_t *buf, uint32_t n) {
+    uint32_t pos = 0;
+
+    while (pos < n) {
+        const uint8_t *p = buf + pos;
+        const uint32_t avail = n - pos;
+        const uint32_t cmd = p[0];
+        uint32_t len;
+
+        switch (cmd) {
+        case GC_GX_CMD_NOP:
+            len = 1;
+            break;
+        case GC_GX_CMD_LOAD_CP_REG:
+            len = 6;
+            if (avail < len) return pos;
+            gc_gx_gp_write_cp(p[1], gp_rd32be(p + 2));
+            break;
+        case GC_GX_CMD_LOAD_XF_REG: {
+            if (avail < 5) return pos;
+            const uint32_t v = gp_rd32be(p + 1);
+            const uint32_t cnt = (v >> 16) + 1u;
+            len = 5u + cnt * 4u;
+            if (avail < len) return pos;
+            gc_gx_gp_write_xf(v & 0xFFFFu, cnt, p + 5);
+            break;
+        }
+        case GC_GX_CMD_LOAD_INDX_A:
+        case GC_GX_CMD_LOAD_INDX_B:
+        case GC_GX_CMD_LOAD_INDX_C:
+        case GC_GX_CMD_LOAD_INDX_D:
+            len = 5;
+            if (avail < len) return pos;
+            gc_gx_gp_load_indexed(cmd, gp_rd32be(p + 1));
+            break;
+        case GC_GX_CMD_CALL_DL:
+            len = 9;
+            if (avail < len) return pos;
+            // CALL_DL carries a physical address.
+            gc_gx_dl_call(gp_rd32be(p + 1) | 0x80000000u, gp_rd32be(p + 5));
+            break;
+        case GC_GX_CMD_INVAL_VTX:
+            len = 1;
+            gc_gx_gp_invalidate_vtx();
+            break;
+        case GC_GX_CMD_LOAD_BP_REG:
+            len = 5;
+            if (avail < len) return pos;
+            gc_gx_gp_write_bp(gp_rd32be(p + 1));
+            break;
+        default:
+            if (cmd >= GC_GX_CMD_DRAW_FIRST && cmd <= GC_GX_CMD_DRAW_LAST) {
+                if (avail < 3) return pos;
+                const uint32_t nverts = gp_rd16be(p + 1);
+                len = 3u + nverts * gc_gx_gp_vertex_size(cmd);
+                if (avail < len) return pos;
+                gc_gx_gp_draw(cmd, nverts, p + 3);
+            } else {
+                // Real hardware would hang; skip the byte so the model keeps going.
+                gc_gx_gp.bad_opcodes++;
+                len = 1;
+            }
+            break;
+        }
+        pos += len;
+    }
+    return pos;
+}
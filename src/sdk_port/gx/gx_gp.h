@@ -0,0 +1,100 @@
+/*
+ * sdk_port/gx/gx_gp.h --- Host-side model of the GP command processor.
+ *
+ * GX.c produces the same big-endian command stream the SDK writes into the
+ * CPU FIFO (or into a display list buffer). This module is the consumer side:
+ * it parses that stream and applies it to shadow copies of the BP, CP and XF
+ * register files. Draw commands are sized from the CP VCD/VAT state and
+ * handed to gc_gx_gp_draw(), which runs the vertex loader (gx_vtx.c), the
+ * XF stage (gx_xf.c) and the rasterizer (gx_raster.c).
+ *
+ * Source of truth for opcodes/register numbering:
+ *   external/mp4-decomp/src/dolphin/gx/__gx.h (GX_WRITE_* macros)
+ */
+#pragma once
+
+#include <stdint.h>
+
+/* FIFO opcodes (GXFifo.h / __gx.h). */
+#define GC_GX_CMD_NOP           0x00u
+#define GC_GX_CMD_LOAD_CP_REG   0x08u
+#define GC_GX_CMD_LOAD_XF_REG   0x10u
+#define GC_GX_CMD_LOAD_INDX_A   0x20u  /* position matrices (array 12) */
+#define GC_GX_CMD_LOAD_INDX_B   0x28u  /* normal matrices   (array 13) */
+#define GC_GX_CMD_LOAD_INDX_C   0x30u  /* texture matrices  (array 14) */
+#define GC_GX_CMD_LOAD_INDX_D   0x38u  /* light objects     (array 15) */
+#define GC_GX_CMD_CALL_DL       0x40u
+#define GC_GX_CMD_INVAL_VTX     0x48u
+#define GC_GX_CMD_LOAD_BP_REG   0x61u
+#define GC_GX_CMD_DRAW_FIRST    0x80u  /* 0x80..0xBF: primitive | vtxfmt */
+#define GC_GX_CMD_DRAW_LAST     0xBFu
+
+/* CP register numbers used by the vertex loader state. */
+#define GC_GX_CP_VCD_LO     0x50u
+#define GC_GX_CP_VCD_HI     0x60u
+#define GC_GX_CP_VAT_A      0x70u
+#define GC_GX_CP_VAT_B      0x80u
+#define GC_GX_CP_VAT_C      0x90u
+#define GC_GX_CP_ARRAY_BASE 0xA0u
+#define GC_GX_CP_ARRAY_STRIDE 0xB0u
+
+/* XF address space: 0x0000..0x067F matrix/light memory, 0x1000..0x1057 regs. */
+#define GC_GX_XF_MEM_SIZE   0x680u
+#define GC_GX_XF_REG_BASE   0x1000u
+#define GC_GX_XF_REG_COUNT  0x58u
+
+typedef struct {
+    uint32_t bp[256];
+    uint32_t bp_mask;                       /* BP 0xFE one-shot write mask */
+    uint32_t tev_reg[8];                    /* BP 0xE0..0xE7 register writes */
+    uint32_t tev_konst[8];                  /* BP 0xE0..0xE7 konst writes (bit 23) */
+    uint32_t cp[256];
+    uint32_t xf_mem[GC_GX_XF_MEM_SIZE];
+    uint32_t xf_regs[GC_GX_XF_REG_COUNT];
+
+    /* Stream counters (monotonic until gc_gx_gp_reset). */
+    uint32_t bp_writes;
+    uint32_t cp_writes;
+    uint32_t xf_writes;
+    uint32_t draws;
+    uint32_t verts;
+    uint32_t vtx_inval;
+    uint32_t bad_opcodes;
+} GcGxGpState;
+
+extern GcGxGpState gc_gx_gp;
+
+void gc_gx_gp_reset(void);
+
+/*
+ * Called, when set, with each RAM range the GP reads (write = 0: display
+ * lists, vertex and matrix arrays, textures, TLUTs) or writes (write = 1:
+ * EFB copies). The trace recorder (gx_trace.c) sets it.
+ */
+extern void (*gc_gx_gp_mem_hook)(uint32_t addr, uint32_t size, int write);
+
+/*
+ * Called, when set, for the PE sync registers: BP 0x45 (draw done, after
+ * the pending raster work), 0x47 (token) and 0x48 (token + interrupt) with
+ * the 16-bit token. The FIFO (gx_fifo.c) sets it.
+ */
+extern void (*gc_gx_gp_pe_hook)(uint32_t id, uint32_t val);
+
+void gc_gx_gp_write_bp(uint32_t v);
+void gc_gx_gp_write_cp(uint32_t addr, uint32_t v);
+/* words points at n big-endian u32 values (as they appear in the stream). */
+void gc_gx_gp_write_xf(uint32_t addr, uint32_t n, const uint8_t *words);
+void gc_gx_gp_load_indexed(uint32_t cmd, uint32_t v);
+void gc_gx_gp_invalidate_vtx(void);
+void gc_gx_gp_draw(uint32_t cmd, uint32_t nverts, const uint8_t *data);
+
+/* Bytes per vertex for vtxfmt under the current (or a given) CP state. */
+uint32_t gc_gx_gp_vertex_size(uint32_t vtxfmt);
+uint32_t gc_gx_gp_vertex_size_cp(const uint32_t *cp, uint32_t vtxfmt);
+
+/*
+ * Parse and execute n bytes of command stream. Returns the number of bytes
+ * consumed; a trailing incomplete command is left unconsumed so the caller can
+ * retry once more bytes are available.
+ */
+uint32_t gc_gx_gp_run(const uint8_t *buf, uint32_t n);
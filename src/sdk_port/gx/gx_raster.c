@@ -0,0 +1,1798 @@
+/*
+ * sdk_port/gx/gx_raster.c --- Headless software rasterizer. See gx_raster.h.
+ *
+ * BP layouts follow the packing in GX.c (GXTev.c / GXPixel.c):
+ *   0x28+i     TEV order pair: map 0..2, coord 3..5, enable 6, rasc 7..9
+ *              (odd stage at +12)
+ *   0xC0+2s    color env: d 0..3, c 4..7, b 8..11, a 12..15, bias 16..17,
+ *              sub 18, clamp 19, scale 20..21, dest 22..23
+ *   0xC1+2s    alpha env: ras swap 0..1, tex swap 2..3, d 4..6, c 7..9,
+ *              b 10..12, a 13..15, then as the color env
+ *   0xE0..0xE7 PREV/REG0..2 (s11) or K0..K3 (bit 23) as RA/BG pairs
+ *   0xF6+i     swap table half 0..3, kcsel/kasel of stage 2i at 4/9 and of
+ *              stage 2i+1 at 14/19
+ *   0x80+m     texture mode0: wrap s 0..1, wrap t 2..3, mag linear 4; image0
+ *              (+8) w-1 0..9, h-1 10..19, format 20..23; image3 (+0x14)
+ *              address >> 5; TLUT (+0x18). Maps 4..7 start at 0xA0.
+ *
+ * TEV arithmetic is the hardware integer model: a/b/c are 8-bit, d and the
+ * registers are s11, and c is widened to 0..256 before the lerp.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gx_raster.h"
+#include "gx_texdec.h"
+
+#ifdef GC_GX_RASTER_THREADS
+#include <pthread.h>
+#endif
+
+GcGxEfb gc_gx_efb;
+GcGxRasterStats gc_gx_raster_stats;
+GcGxRasterBBox gc_gx_raster_bbox = { 0x3FFu, 0x3FFu, 0u, 0u };
+uint32_t gc_gx_raster_enable = 1;
+uint32_t gc_gx_raster_threads = 4;
+
+#define RAS_W      GC_GX_EFB_WIDTH
+#define RAS_H      GC_GX_EFB_HEIGHT
+#define RAS_TILE   GC_GX_RASTER_TILE
+#define RAS_TX     GC_GX_RASTER_TILES_X
+#define RAS_TY     GC_GX_RASTER_TILES_Y
+#define RAS_TILES  (RAS_TX * RAS_TY)
+
+#define RAS_MAX_PENDING 8192u   // binned triangles that force a flush before the next draw
+#define RAS_PAR_MIN     64u     // triangles per flush before threads pay off
+
+// Attribute planes: color0 rgba, color1 rgba, then s, t, q per texcoord.
+#define RAS_ATTR_CLR0 0u
+#define RAS_ATTR_CLR1 4u
+#define RAS_ATTR_TEX0 8u
+#define RAS_ATTRS     32u
+
+// TEV operand bank: registers, then this stage's inputs, then constants.
+enum {
+    RAS_PREV, RAS_REG0, RAS_REG1, RAS_REG2,
+    RAS_TEX, RAS_RAS, RAS_KONST,
+    RAS_ONE, RAS_HALF, RAS_ZERO,
+    RAS_SLOTS
+};
+typedef int32_t RasBank[RAS_SLOTS][4];
+
+typedef struct RasStage RasStage;
+typedef void (*RasCombFn)(const RasStage *st, RasBank b, int32_t out[4]);
+
+struct RasStage {
+    RasCombFn cfn;
+    RasCombFn afn;
+    uint8_t cin[4];          // bank slot of color operands a, b, c, d
+    uint8_t cch[4][3];       // channel read per operand (3 = alpha broadcast)
+    uint8_t ain[4];
+    uint8_t cdst, adst;
+    uint8_t cclamp, aclamp;
+    int32_t cbias, clsh, crsh;
+    int32_t abias, alsh, arsh;
+    uint8_t ras;             // RasPixIn.clr row: color0, color1, zero
+    uint8_t ras_swap[4];
+    uint8_t tex_swap[4];
+    uint8_t tex_en, texmap, texcoord;
+};
+
+// TEV stages, orders and selects, then z mode, blend, dst alpha, PE control,
+// alpha compare and the fog mode.
+#define RAS_KEY_WORDS (1u + 16u + 16u + 8u + 8u + 6u)
+
+// A pipeline state: the TEV and PE configuration resolved into a plan.
+// Stages whose result is never read are dropped; stages whose inputs are
+// all constant for a draw (registers, konst, ONE/HALF/ZERO, no texture or
+// rasterized color) run once per draw into its bank; the rest run per pixel.
+typedef struct {
+    uint32_t valid;
+    uint32_t hash;
+    uint32_t nkey;
+    uint32_t key[RAS_KEY_WORDS];
+    uint32_t stamp;
+    uint32_t frame;          // last frame drawn with this state
+    uint32_t nstages;
+    uint32_t attr_mask;
+    uint8_t cout, aout;
+    uint8_t nfold, nrun;
+    uint8_t fold[16];        // stage indices, in order
+    uint8_t run[16];
+    uint32_t apass[8];       // alpha compare result for each alpha value
+    RasStage st[16];
+} RasProg;
+
+// A texture map as the draw sees it: the decoded base level and its sampler.
+typedef struct {
+    const uint32_t *texels;  // NULL reads as opaque white
+    uint32_t w, h;
+    uint8_t wrap_s, wrap_t, linear;
+} RasTex;
+
+// Everything a pixel of one draw needs, copied out of the BP state.
+typedef struct {
+    const RasProg *prog;
+    uint32_t attr_mask;
+    uint32_t nstages;
+    uint32_t ntex;                                   // stages sampling a texture
+    uint32_t tevc[16], teva[16], tref[8], ksel[8];   // raw, for the interpreter
+    int32_t kcolor[4][4];
+    int32_t konst[16][4];                            // per-stage konst operand
+    RasBank bank;                                    // registers + constants after folded stages
+    uint32_t zmode, cmode0, cmode1, pectrl, acmp;
+    uint32_t fog_type, fog_proj, fog_bmag, fog_bshift;
+    float fog_a, fog_c;
+    int32_t fog_color[3];
+    int32_t sx0, sy0, sx1, sy1;                      // scissor, EFB pixels, inclusive
+    float soffx, soffy;                              // window -> EFB
+    float vp[6];
+    uint32_t cull;
+    RasTex tex[8];
+} RasDraw;
+
+typedef struct {
+    double e[3][3];          // edge A, B, C: inside when A*x + B*y + C > 0
+    uint8_t tl[3];           // centers exactly on the edge belong to it
+    uint8_t persp;
+    int16_t x0, y0, x1, y1;  // pixel bbox, inclusive
+    uint32_t draw;
+    float ox, oy;
+    float z[3];              // planes: value at (ox, oy), d/dx, d/dy
+    float iw[3];
+    float a[RAS_ATTRS][3];
+} RasTri;
+
+typedef struct {
+    float cx, cy, cz, cw;
+    float x, y, z;
+    float a[RAS_ATTRS];
+} RasVtx;
+
+typedef struct {
+    int32_t clr[3][4];
+    float st[8][2];
+} RasPixIn;
+
+typedef struct {
+    uint64_t pixels;
+    uint64_t written;
+    uint64_t top_in, top_out;    // early depth test
+    uint64_t bot_in, bot_out;    // late depth test
+    uint64_t texels;
+    uint32_t left, top, right, bottom;   // bounding box of the pixels drawn
+} RasCount;
+
+static void ras_count_init(RasCount *c) {
+    memset(c, 0, sizeof(*c));
+    c->left = c->top = 0x3FFu;
+}
+
+static void ras_count_stats(const RasCount *c) {
+    GcGxRasterStats *st = &gc_gx_raster_stats;
+    GcGxRasterBBox *bb = &gc_gx_raster_bbox;
+    if (c->left < bb->left) bb->left = c->left;
+    if (c->top < bb->top) bb->top = c->top;
+    if (c->right > bb->right) bb->right = c->right;
+    if (c->bottom > bb->bottom) bb->bottom = c->bottom;
+    st->pixels += c->pixels;
+    st->written += c->written;
+    st->top_in += c->top_in;
+    st->top_out += c->top_out;
+    st->bot_in += c->bot_in;
+    st->bot_out += c->bot_out;
+    st->texels += c->texels;
+}
+
+typedef struct {
+    uint32_t *idx;
+    uint32_t n;
+    uint32_t cap;
+} RasBin;
+
+static RasProg s_ras_cache[GC_GX_RASTER_TEV_CACHE];
+static uint32_t s_ras_stamp;
+static uint32_t s_ras_frame = 1;
+
+static RasTri *s_ras_tris;
+static uint32_t s_ras_ntris;
+static uint32_t s_ras_tri_cap;
+static RasDraw *s_ras_draws;
+static uint32_t s_ras_ndraws;
+static uint32_t s_ras_draw_cap;
+static RasBin s_ras_bin[RAS_TILES];
+static GcGxEfb *s_ras_target;
+
+// ---- Helpers ----
+
+static inline int32_t ras_clampi(int32_t v, int32_t lo, int32_t hi) {
+    return v < lo ? lo : v > hi ? hi : v;
+}
+
+static inline float ras_u2f(uint32_t u) {
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static inline int32_t ras_s11(uint32_t v) {
+    return (int32_t)(v << 21) >> 21;
+}
+
+static inline int32_t ras_to8(float c) {
+    if (!(c > 0.0f)) return 0;
+    if (c >= 1.0f) return 255;
+    return (int32_t)(c * 255.0f + 0.5f);
+}
+
+static inline uint32_t ras_hash(const uint32_t *w, uint32_t n) {
+    uint32_t h = 2166136261u;
+    uint32_t i;
+    for (i = 0; i < n; i++) {
+        h ^= w[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// 2^x for x <= 0, without libm: exponent bits plus a polynomial on the fraction.
+static float ras_exp2(float x) {
+    int32_t i;
+    float f, p;
+    uint32_t bits;
+    if (x < -126.0f) return 0.0f;
+    i = (int32_t)x;
+    if ((float)i > x) i--;
+    f = x - (float)i;
+    p = 1.0f + f * (0.6931472f + f * (0.2402265f + f * (0.0555041f + f * (0.0096181f + f * 0.0013334f))));
+    bits = (uint32_t)(i + 127) << 23;
+    return p * ras_u2f(bits);
+}
+
+// ---- Texture sampling (base level, 7-bit subtexel precision) ----
+
+static inline int32_t ras_tex_wrap(int32_t i, int32_t n, uint32_t mode) {
+    int32_t m;
+    switch (mode) {
+    case 1:
+        m = i % n;
+        return m < 0 ? m + n : m;
+    case 2:
+        m = i % (2 * n);
+        if (m < 0) m += 2 * n;
+        return m < n ? m : 2 * n - 1 - m;
+    default:
+        return ras_clampi(i, 0, n - 1);
+    }
+}
+
+// Normalized coordinate -> texel units * 128, floored.
+static inline int32_t ras_tex_fix(float c, uint32_t n) {
+    float u = c * (float)n * 128.0f;
+    int32_t i;
+    if (!(u > -1.0e8f)) u = -1.0e8f;
+    if (u > 1.0e8f) u = 1.0e8f;
+    i = (int32_t)u;
+    if ((float)i > u) i--;
+    return i;
+}
+
+static inline void ras_tex_unpack(uint32_t px, int32_t out[4]) {
+    out[0] = (int32_t)(px >> 24);
+    out[1] = (int32_t)((px >> 16) & 0xFFu);
+    out[2] = (int32_t)((px >> 8) & 0xFFu);
+    out[3] = (int32_t)(px & 0xFFu);
+}
+
+static inline void ras_tex_sample(const RasTex *tx, float s, float t, int32_t out[4]) {
+    const int32_t w = (int32_t)tx->w, h = (int32_t)tx->h;
+    int32_t u, v;
+
+    if (!tx->texels) {
+        out[0] = out[1] = out[2] = out[3] = 255;
+        return;
+    }
+    u = ras_tex_fix(s, tx->w);
+    v = ras_tex_fix(t, tx->h);
+    if (!tx->linear) {
+        ras_tex_unpack(tx->texels[ras_tex_wrap(v >> 7, h, tx->wrap_t) * w +
+                                  ras_tex_wrap(u >> 7, w, tx->wrap_s)], out);
+    } else {
+        const int32_t fu = (u - 64) & 127, fv = (v - 64) & 127;
+        const int32_t x0 = ras_tex_wrap((u - 64) >> 7, w, tx->wrap_s);
+        const int32_t x1 = ras_tex_wrap(((u - 64) >> 7) + 1, w, tx->wrap_s);
+        const int32_t y0 = ras_tex_wrap((v - 64) >> 7, h, tx->wrap_t) * w;
+        const int32_t y1 = ras_tex_wrap(((v - 64) >> 7) + 1, h, tx->wrap_t) * w;
+        int32_t c00[4], c10[4], c01[4], c11[4];
+        uint32_t i;
+        ras_tex_unpack(tx->texels[y0 + x0], c00);
+        ras_tex_unpack(tx->texels[y0 + x1], c10);
+        ras_tex_unpack(tx->texels[y1 + x0], c01);
+        ras_tex_unpack(tx->texels[y1 + x1], c11);
+        for (i = 0; i < 4; i++) {
+            out[i] = ((c00[i] * (128 - fu) + c10[i] * fu) * (128 - fv) +
+                      (c01[i] * (128 - fu) + c11[i] * fu) * fv + 8192) >> 14;
+        }
+    }
+}
+
+// ---- TEV decode shared by the compiler and the interpreter ----
+
+static const int32_t k_ras_bias[4] = { 0, 128, -128, 0 };
+static const int32_t k_ras_lsh[4] = { 0, 1, 2, 0 };
+static const int32_t k_ras_rsh[4] = { 0, 0, 0, 1 };
+static const int32_t k_ras_kfrac[8] = { 255, 223, 191, 159, 128, 96, 64, 32 };
+
+// Swap table t: source component for output component i.
+static inline uint32_t ras_swap(const uint32_t *ksel, uint32_t t, uint32_t i) {
+    return (ksel[t * 2u + (i >> 1)] >> ((i & 1u) * 2u)) & 3u;
+}
+
+static void ras_konst(const int32_t kc[4][4], uint32_t csel, uint32_t asel, int32_t out[4]) {
+    uint32_t i;
+    if (csel < 8u) {
+        out[0] = out[1] = out[2] = k_ras_kfrac[csel];
+    } else if (csel >= 0x0Cu && csel <= 0x0Fu) {
+        for (i = 0; i < 3; i++) out[i] = kc[csel - 0x0Cu][i];
+    } else if (csel >= 0x10u) {
+        out[0] = out[1] = out[2] = kc[csel & 3u][(csel - 0x10u) >> 2];
+    } else {
+        out[0] = out[1] = out[2] = 0;
+    }
+    if (asel < 8u) out[3] = k_ras_kfrac[asel];
+    else if (asel >= 0x10u) out[3] = kc[asel & 3u][(asel - 0x10u) >> 2];
+    else out[3] = 0;
+}
+
+static inline uint32_t ras_order(const uint32_t *tref, uint32_t s) {
+    return (tref[s >> 1] >> ((s & 1u) ? 12u : 0u)) & 0xFFFu;
+}
+
+static inline uint32_t ras_kcsel(const uint32_t *ksel, uint32_t s) {
+    return (ksel[s >> 1] >> ((s & 1u) ? 14u : 4u)) & 31u;
+}
+
+static inline uint32_t ras_kasel(const uint32_t *ksel, uint32_t s) {
+    return (ksel[s >> 1] >> ((s & 1u) ? 19u : 9u)) & 31u;
+}
+
+static inline int32_t ras_lerp(int32_t a, int32_t b, int32_t c, int32_t d,
+                               int32_t bias, int32_t lsh, int32_t rsh, int sub) {
+    const int32_t c8 = c & 255;
+    const int32_t cw = c8 + (c8 >> 7);
+    int32_t t = ((a & 255) * (256 - cw) + (b & 255) * cw) * (1 << lsh);
+    t = (t + (rsh ? 0 : sub ? 127 : 128)) >> 8;
+    if (sub) t = -t;
+    return ((d + bias) * (1 << lsh) + t) >> rsh;
+}
+
+static inline int32_t ras_tev_clamp(int32_t v, int clamp) {
+    return clamp ? ras_clampi(v, 0, 255) : ras_clampi(v, -1024, 1023);
+}
+
+// Compare key for modes R8 / GR16 / BGR24 over an operand's r, g, b.
+static inline uint32_t ras_cmp_key(int32_t r, int32_t g, int32_t b, uint32_t mode) {
+    switch (mode) {
+    case 0:  return (uint32_t)(r & 255);
+    case 1:  return ((uint32_t)(g & 255) << 8) | (uint32_t)(r & 255);
+    default: return ((uint32_t)(b & 255) << 16) | ((uint32_t)(g & 255) << 8) | (uint32_t)(r & 255);
+    }
+}
+
+// ---- Compiled combiners ----
+//
+// One function per operation class; SUB/CLAMP/MODE are constants, so each
+// instance compiles to a straight-line combiner.
+
+#define RAS_CPTR(st, b, k, ch) ((b)[(st)->cin[k]][(st)->cch[k][ch]])
+
+#define RAS_COLOR_LERP(name, SUB, CLAMP)                                              \
+    static void name(const RasStage *st, RasBank b, int32_t out[4]) {                 \
+        int ch;                                                                       \
+        for (ch = 0; ch < 3; ch++) {                                                  \
+            out[ch] = ras_tev_clamp(ras_lerp(RAS_CPTR(st, b, 0, ch), RAS_CPTR(st, b, 1, ch), \
+                                             RAS_CPTR(st, b, 2, ch), RAS_CPTR(st, b, 3, ch), \
+                                             st->cbias, st->clsh, st->crsh, SUB), CLAMP); \
+        }                                                                             \
+    }
+
+#define RAS_COLOR_PASS(name, CLAMP)                                                   \
+    static void name(const RasStage *st, RasBank b, int32_t out[4]) {                 \
+        int ch;                                                                       \
+        for (ch = 0; ch < 3; ch++) {                                                  \
+            out[ch] = ras_tev_clamp(((RAS_CPTR(st, b, 3, ch) + st->cbias) * (1 << st->clsh)) \
+                                        >> st->crsh, CLAMP);                          \
+        }                                                                             \
+    }
+
+#define RAS_COLOR_CMP(name, MODE, EQ)                                                 \
+    static void name(const RasStage *st, RasBank b, int32_t out[4]) {                 \
+        int ch;                                                                       \
+        if (MODE == 3) {                                                              \
+            for (ch = 0; ch < 3; ch++) {                                              \
+                const int32_t x = RAS_CPTR(st, b, 0, ch) & 255;                       \
+                const int32_t y = RAS_CPTR(st, b, 1, ch) & 255;                       \
+                const int hit = EQ ? x == y : x > y;                                  \
+                out[ch] = ras_tev_clamp(RAS_CPTR(st, b, 3, ch) +                      \
+                                        (hit ? RAS_CPTR(st, b, 2, ch) & 255 : 0), st->cclamp); \
+            }                                                                         \
+        } else {                                                                      \
+            const uint32_t x = ras_cmp_key(RAS_CPTR(st, b, 0, 0), RAS_CPTR(st, b, 0, 1), \
+                                           RAS_CPTR(st, b, 0, 2), MODE);              \
+            const uint32_t y = ras_cmp_key(RAS_CPTR(st, b, 1, 0), RAS_CPTR(st, b, 1, 1), \
+                                           RAS_CPTR(st, b, 1, 2), MODE);              \
+            const int hit = EQ ? x == y : x > y;                                      \
+            for (ch = 0; ch < 3; ch++) {                                              \
+                out[ch] = ras_tev_clamp(RAS_CPTR(st, b, 3, ch) +                      \
+                                        (hit ? RAS_CPTR(st, b, 2, ch) & 255 : 0), st->cclamp); \
+            }                                                                         \
+        }                                                                             \
+    }
+
+RAS_COLOR_LERP(ras_c_add, 0, 0)
+RAS_COLOR_LERP(ras_c_add_clamp, 0, 1)
+RAS_COLOR_LERP(ras_c_sub, 1, 0)
+RAS_COLOR_LERP(ras_c_sub_clamp, 1, 1)
+RAS_COLOR_PASS(ras_c_pass, 0)
+RAS_COLOR_PASS(ras_c_pass_clamp, 1)
+RAS_COLOR_CMP(ras_c_gt_r8, 0, 0)
+RAS_COLOR_CMP(ras_c_eq_r8, 0, 1)
+RAS_COLOR_CMP(ras_c_gt_gr16, 1, 0)
+RAS_COLOR_CMP(ras_c_eq_gr16, 1, 1)
+RAS_COLOR_CMP(ras_c_gt_bgr24, 2, 0)
+RAS_COLOR_CMP(ras_c_eq_bgr24, 2, 1)
+RAS_COLOR_CMP(ras_c_gt_rgb8, 3, 0)
+RAS_COLOR_CMP(ras_c_eq_rgb8, 3, 1)
+
+// a = ZERO, d = ZERO, add, no bias, scale 1: b * c.
+static void ras_c_mod(const RasStage *st, RasBank b, int32_t out[4]) {
+    int ch;
+    for (ch = 0; ch < 3; ch++) {
+        const int32_t c8 = RAS_CPTR(st, b, 2, ch) & 255;
+        out[ch] = ((RAS_CPTR(st, b, 1, ch) & 255) * (c8 + (c8 >> 7)) + 128) >> 8;
+    }
+}
+
+#define RAS_AOP(st, b, k) ((b)[(st)->ain[k]][3])
+
+#define RAS_ALPHA_LERP(name, SUB, CLAMP)                                              \
+    static void name(const RasStage *st, RasBank b, int32_t out[4]) {                 \
+        out[3] = ras_tev_clamp(ras_lerp(RAS_AOP(st, b, 0), RAS_AOP(st, b, 1),         \
+                                        RAS_AOP(st, b, 2), RAS_AOP(st, b, 3),         \
+                                        st->abias, st->alsh, st->arsh, SUB), CLAMP);  \
+    }
+
+#define RAS_ALPHA_PASS(name, CLAMP)                                                   \
+    static void name(const RasStage *st, RasBank b, int32_t out[4]) {                 \
+        out[3] = ras_tev_clamp(((RAS_AOP(st, b, 3) + st->abias) * (1 << st->alsh)) >> st->arsh, \
+                               CLAMP);                                                \
+    }
+
+// Modes R8/GR16/BGR24 compare the color operands a and b; A8 the alpha ones.
+#define RAS_ALPHA_CMP(name, MODE, EQ)                                                 \
+    static void name(const RasStage *st, RasBank b, int32_t out[4]) {                 \
+        uint32_t x, y;                                                                \
+        int hit;                                                                      \
+        if (MODE == 3) {                                                              \
+            x = (uint32_t)(RAS_AOP(st, b, 0) & 255);                                  \
+            y = (uint32_t)(RAS_AOP(st, b, 1) & 255);                                  \
+        } else {                                                                      \
+            x = ras_cmp_key(RAS_CPTR(st, b, 0, 0), RAS_CPTR(st, b, 0, 1),             \
+                            RAS_CPTR(st, b, 0, 2), MODE);                             \
+            y = ras_cmp_key(RAS_CPTR(st, b, 1, 0), RAS_CPTR(st, b, 1, 1),             \
+                            RAS_CPTR(st, b, 1, 2), MODE);                             \
+        }                                                                             \
+        hit = EQ ? x == y : x > y;                                                    \
+        out[3] = ras_tev_clamp(RAS_AOP(st, b, 3) + (hit ? RAS_AOP(st, b, 2) & 255 : 0), \
+                               st->aclamp);                                           \
+    }
+
+RAS_ALPHA_LERP(ras_a_add, 0, 0)
+RAS_ALPHA_LERP(ras_a_add_clamp, 0, 1)
+RAS_ALPHA_LERP(ras_a_sub, 1, 0)
+RAS_ALPHA_LERP(ras_a_sub_clamp, 1, 1)
+RAS_ALPHA_PASS(ras_a_pass, 0)
+RAS_ALPHA_PASS(ras_a_pass_clamp, 1)
+RAS_ALPHA_CMP(ras_a_gt_r8, 0, 0)
+RAS_ALPHA_CMP(ras_a_eq_r8, 0, 1)
+RAS_ALPHA_CMP(ras_a_gt_gr16, 1, 0)
+RAS_ALPHA_CMP(ras_a_eq_gr16, 1, 1)
+RAS_ALPHA_CMP(ras_a_gt_bgr24, 2, 0)
+RAS_ALPHA_CMP(ras_a_eq_bgr24, 2, 1)
+RAS_ALPHA_CMP(ras_a_gt_a8, 3, 0)
+RAS_ALPHA_CMP(ras_a_eq_a8, 3, 1)
+
+static const RasCombFn k_ras_c_cmp[8] = {
+    ras_c_gt_r8, ras_c_eq_r8, ras_c_gt_gr16, ras_c_eq_gr16,
+    ras_c_gt_bgr24, ras_c_eq_bgr24, ras_c_gt_rgb8, ras_c_eq_rgb8,
+};
+static const RasCombFn k_ras_a_cmp[8] = {
+    ras_a_gt_r8, ras_a_eq_r8, ras_a_gt_gr16, ras_a_eq_gr16,
+    ras_a_gt_bgr24, ras_a_eq_bgr24, ras_a_gt_a8, ras_a_eq_a8,
+};
+
+// GXTevColorArg -> bank slot, and whether the operand is the slot's alpha.
+static const uint8_t k_ras_cslot[16] = {
+    RAS_PREV, RAS_PREV, RAS_REG0, RAS_REG0, RAS_REG1, RAS_REG1, RAS_REG2, RAS_REG2,
+    RAS_TEX, RAS_TEX, RAS_RAS, RAS_RAS, RAS_ONE, RAS_HALF, RAS_KONST, RAS_ZERO,
+};
+static const uint8_t k_ras_csplat[16] = { 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 0, 0, 0 };
+// GXTevAlphaArg -> bank slot.
+static const uint8_t k_ras_aslot[8] = {
+    RAS_PREV, RAS_REG0, RAS_REG1, RAS_REG2, RAS_TEX, RAS_RAS, RAS_KONST, RAS_ZERO,
+};
+
+static void ras_compile_stage(RasStage *st, uint32_t cc, uint32_t ac, uint32_t order,
+                              const uint32_t *ksel) {
+    uint32_t k, ch, i;
+    const uint32_t csel[4] = { (cc >> 12) & 15u, (cc >> 8) & 15u, (cc >> 4) & 15u, cc & 15u };
+    const uint32_t asel[4] = { (ac >> 13) & 7u, (ac >> 10) & 7u, (ac >> 7) & 7u, (ac >> 4) & 7u };
+    const uint32_t cbias = (cc >> 16) & 3u, cscale = (cc >> 20) & 3u, csub = (cc >> 18) & 1u;
+    const uint32_t abias = (ac >> 16) & 3u, ascale = (ac >> 20) & 3u, asub = (ac >> 18) & 1u;
+    const uint32_t rasc = (order >> 7) & 7u;
+
+    memset(st, 0, sizeof(*st));
+    for (k = 0; k < 4; k++) {
+        st->cin[k] = k_ras_cslot[csel[k]];
+        for (ch = 0; ch < 3; ch++) st->cch[k][ch] = k_ras_csplat[csel[k]] ? 3u : (uint8_t)ch;
+        st->ain[k] = k_ras_aslot[asel[k]];
+    }
+    st->cdst = (uint8_t)((cc >> 22) & 3u);
+    st->adst = (uint8_t)((ac >> 22) & 3u);
+    st->cclamp = (uint8_t)((cc >> 19) & 1u);
+    st->aclamp = (uint8_t)((ac >> 19) & 1u);
+    st->cbias = k_ras_bias[cbias];
+    st->clsh = k_ras_lsh[cscale];
+    st->crsh = k_ras_rsh[cscale];
+    st->abias = k_ras_bias[abias];
+    st->alsh = k_ras_lsh[ascale];
+    st->arsh = k_ras_rsh[ascale];
+
+    if (cbias == 3u) {
+        st->cfn = k_ras_c_cmp[cscale * 2u + csub];
+    } else if (csel[0] == 15u && csel[2] == 15u) {
+        st->cfn = st->cclamp ? ras_c_pass_clamp : ras_c_pass;
+    } else if (csel[0] == 15u && csel[3] == 15u && cbias == 0u && cscale == 0u && !csub) {
+        st->cfn = ras_c_mod;
+    } else if (csub) {
+        st->cfn = st->cclamp ? ras_c_sub_clamp : ras_c_sub;
+    } else {
+        st->cfn = st->cclamp ? ras_c_add_clamp : ras_c_add;
+    }
+    if (abias == 3u) {
+        st->afn = k_ras_a_cmp[ascale * 2u + asub];
+    } else if (asel[0] == 7u && asel[2] == 7u) {
+        st->afn = st->aclamp ? ras_a_pass_clamp : ras_a_pass;
+    } else if (asub) {
+        st->afn = st->aclamp ? ras_a_sub_clamp : ras_a_sub;
+    } else {
+        st->afn = st->aclamp ? ras_a_add_clamp : ras_a_add;
+    }
+
+    st->ras = rasc <= 1u ? (uint8_t)rasc : 2u;
+    st->tex_en = (uint8_t)((order >> 6) & 1u);
+    st->texmap = (uint8_t)(order & 7u);
+    st->texcoord = (uint8_t)((order >> 3) & 7u);
+    for (i = 0; i < 4; i++) {
+        st->ras_swap[i] = (uint8_t)ras_swap(ksel, ac & 3u, i);
+        st->tex_swap[i] = (uint8_t)ras_swap(ksel, (ac >> 2) & 3u, i);
+    }
+}
+
+// Register halves the plan tracks: bit 2*slot is the color, 2*slot+1 the
+// alpha of PREV..REG2.
+static inline uint32_t ras_part(uint32_t slot, uint32_t alpha) {
+    return slot <= RAS_REG2 ? (alpha ? 2u : 1u) << (slot * 2u) : 0u;
+}
+
+// Register halves stage st reads (every operand, which covers the color
+// operands read by the alpha compare modes); *pix is set when it reads the
+// texture or the rasterized color, the inputs that change from pixel to pixel.
+static uint32_t ras_stage_reads(const RasStage *st, uint8_t *pix) {
+    uint32_t k, reads = 0;
+    *pix = 0;
+    for (k = 0; k < 4u; k++) {
+        const uint32_t cs = st->cin[k], as = st->ain[k];
+        reads |= ras_part(cs, st->cch[k][0] == 3u) | ras_part(as, 1u);
+        *pix |= (uint8_t)((cs == RAS_TEX && st->tex_en) || (cs == RAS_RAS && st->ras < 2u));
+        *pix |= (uint8_t)((as == RAS_TEX && st->tex_en) || (as == RAS_RAS && st->ras < 2u));
+    }
+    return reads;
+}
+
+static void ras_plan(RasProg *p) {
+    uint32_t reads[16], live, varying = 0, touched = 0, s;
+    uint8_t keep[16], pix[16];
+
+    // Backward: a stage stays when the output or a later stage reads what it writes.
+    live = ras_part(p->cout, 0) | ras_part(p->aout, 1);
+    for (s = p->nstages; s-- > 0;) {
+        const RasStage *st = &p->st[s];
+        const uint32_t wr = ras_part(st->cdst, 0) | ras_part(st->adst, 1);
+        reads[s] = ras_stage_reads(st, &pix[s]);
+        keep[s] = (uint8_t)((live & wr) != 0u);
+        if (keep[s]) live = (live & ~wr) | reads[s];
+    }
+    // Forward: a stage folds when nothing it reads comes from a per-pixel
+    // stage and no earlier per-pixel stage reads or writes what it writes.
+    p->nfold = 0;
+    p->nrun = 0;
+    p->attr_mask = 0;
+    for (s = 0; s < p->nstages; s++) {
+        const RasStage *st = &p->st[s];
+        const uint32_t wr = ras_part(st->cdst, 0) | ras_part(st->adst, 1);
+        if (!keep[s]) continue;
+        if (!pix[s] && !(reads[s] & varying) && !(wr & touched)) {
+            p->fold[p->nfold++] = (uint8_t)s;
+            continue;
+        }
+        p->run[p->nrun++] = (uint8_t)s;
+        varying |= wr;
+        touched |= wr | reads[s];
+        if (st->ras == 0u) p->attr_mask |= 0xFu << RAS_ATTR_CLR0;
+        if (st->ras == 1u) p->attr_mask |= 0xFu << RAS_ATTR_CLR1;
+        if (st->tex_en) p->attr_mask |= 0x7u << (RAS_ATTR_TEX0 + st->texcoord * 3u);
+    }
+    gc_gx_raster_stats.tev_folded += p->nfold;
+    gc_gx_raster_stats.tev_dropped += p->nstages - p->nfold - p->nrun;
+}
+
+static inline int ras_alpha_test(uint32_t acmp, int32_t a);
+
+static void ras_compile(RasProg *p, const RasDraw *d) {
+    uint32_t s, a;
+    p->nstages = d->nstages;
+    for (s = 0; s < d->nstages; s++) {
+        ras_compile_stage(&p->st[s], d->tevc[s], d->teva[s], ras_order(d->tref, s), d->ksel);
+    }
+    p->cout = p->st[d->nstages - 1u].cdst;
+    p->aout = p->st[d->nstages - 1u].adst;
+    ras_plan(p);
+    memset(p->apass, 0, sizeof(p->apass));
+    for (a = 0; a < 256u; a++) {
+        if (ras_alpha_test(d->acmp, (int32_t)a)) p->apass[a >> 5] |= 1u << (a & 31u);
+    }
+}
+
+// Count the states drawn in this frame.
+static inline void ras_prog_seen(RasProg *p) {
+    if (p->frame == s_ras_frame) return;
+    p->frame = s_ras_frame;
+    gc_gx_raster_stats.tev_states++;
+}
+
+// Find or compile the pipeline state for d.
+static const RasProg *ras_prog_lookup(const RasDraw *d) {
+    uint32_t key[RAS_KEY_WORDS];
+    uint32_t n = 0, s, h, i, slot, victim;
+
+    key[n++] = d->nstages;
+    for (s = 0; s < d->nstages; s++) key[n++] = d->tevc[s];
+    for (s = 0; s < d->nstages; s++) key[n++] = d->teva[s];
+    for (s = 0; s < (d->nstages + 1u) / 2u; s++) key[n++] = d->tref[s];
+    for (s = 0; s < 8u; s++) key[n++] = d->ksel[s];
+    key[n++] = d->zmode;
+    key[n++] = d->cmode0;
+    key[n++] = d->cmode1;
+    key[n++] = d->pectrl;
+    key[n++] = d->acmp;
+    key[n++] = d->fog_type << 1 | d->fog_proj;
+    h = ras_hash(key, n);
+
+    // 4-way set: the hash picks a group, LRU within it.
+    slot = (h & (GC_GX_RASTER_TEV_CACHE / 4u - 1u)) * 4u;
+    victim = slot;
+    for (i = slot; i < slot + 4u; i++) {
+        RasProg *p = &s_ras_cache[i];
+        if (p->valid && p->hash == h && p->nkey == n && memcmp(p->key, key, n * 4u) == 0) {
+            p->stamp = ++s_ras_stamp;
+            gc_gx_raster_stats.tev_hits++;
+            ras_prog_seen(p);
+            return p;
+        }
+        if (!p->valid || (s_ras_cache[victim].valid && p->stamp < s_ras_cache[victim].stamp)) {
+            victim = i;
+        }
+    }
+    // Binned triangles may still point at the victim.
+    if (s_ras_cache[victim].valid) {
+        if (s_ras_ntris) gc_gx_raster_flush();
+        gc_gx_raster_stats.tev_evictions++;
+    }
+    gc_gx_raster_stats.tev_misses++;
+    {
+        RasProg *p = &s_ras_cache[victim];
+        p->valid = 1;
+        p->hash = h;
+        p->nkey = n;
+        memcpy(p->key, key, n * 4u);
+        p->stamp = ++s_ras_stamp;
+        p->frame = 0;
+        ras_compile(p, d);
+        ras_prog_seen(p);
+        return p;
+    }
+}
+
+static inline void ras_stage_inputs(const RasStage *st, const int32_t *konst, const RasTex *tex,
+                                    const RasPixIn *in, RasBank b) {
+    const int32_t *r = in->clr[st->ras];
+    uint32_t i;
+    if (st->tex_en) {
+        int32_t t[4];
+        ras_tex_sample(&tex[st->texmap], in->st[st->texcoord][0], in->st[st->texcoord][1], t);
+        for (i = 0; i < 4; i++) b[RAS_TEX][i] = t[st->tex_swap[i]];
+    } else {
+        b[RAS_TEX][0] = b[RAS_TEX][1] = b[RAS_TEX][2] = b[RAS_TEX][3] = 0;
+    }
+    for (i = 0; i < 4; i++) b[RAS_RAS][i] = r[st->ras_swap[i]];
+    memcpy(b[RAS_KONST], konst, sizeof(b[RAS_KONST]));
+}
+
+static inline void ras_stage_exec(const RasStage *st, RasBank b) {
+    int32_t out[4];
+    st->cfn(st, b, out);
+    st->afn(st, b, out);
+    b[st->cdst][0] = out[0];
+    b[st->cdst][1] = out[1];
+    b[st->cdst][2] = out[2];
+    b[st->adst][3] = out[3];
+}
+
+// Run the folded stages into the draw's bank: their texture and rasterized
+// inputs are unused or zero.
+static void ras_prog_fold(const RasProg *p, RasDraw *d) {
+    uint32_t i;
+    memset(d->bank[RAS_TEX], 0, sizeof(d->bank[RAS_TEX]));
+    memset(d->bank[RAS_RAS], 0, sizeof(d->bank[RAS_RAS]));
+    for (i = 0; i < p->nfold; i++) {
+        memcpy(d->bank[RAS_KONST], d->konst[p->fold[i]], sizeof(d->bank[RAS_KONST]));
+        ras_stage_exec(&p->st[p->fold[i]], d->bank);
+    }
+}
+
+static void ras_prog_run(const RasProg *p, const RasDraw *d, const RasPixIn *in, int32_t rgba[4]) {
+    RasBank b;
+    uint32_t i;
+    memcpy(b, d->bank, sizeof(b));
+    for (i = 0; i < p->nrun; i++) {
+        const RasStage *st = &p->st[p->run[i]];
+        ras_stage_inputs(st, d->konst[p->run[i]], d->tex, in, b);
+        ras_stage_exec(st, b);
+    }
+    rgba[0] = b[p->cout][0] & 255;
+    rgba[1] = b[p->cout][1] & 255;
+    rgba[2] = b[p->cout][2] & 255;
+    rgba[3] = b[p->aout][3] & 255;
+}
+
+// ---- Reference TEV: decode the raw registers at every pixel ----
+
+static int32_t ras_ref_carg(uint32_t sel, uint32_t ch, const int32_t r[4][4], const int32_t *tex,
+                            const int32_t *ras, const int32_t *kon) {
+    switch (sel) {
+    case 0: return r[0][ch];
+    case 1: return r[0][3];
+    case 2: return r[1][ch];
+    case 3: return r[1][3];
+    case 4: return r[2][ch];
+    case 5: return r[2][3];
+    case 6: return r[3][ch];
+    case 7: return r[3][3];
+    case 8: return tex[ch];
+    case 9: return tex[3];
+    case 10: return ras[ch];
+    case 11: return ras[3];
+    case 12: return 255;
+    case 13: return 128;
+    case 14: return kon[ch];
+    default: return 0;
+    }
+}
+
+static int32_t ras_ref_aarg(uint32_t sel, const int32_t r[4][4], const int32_t *tex,
+                            const int32_t *ras, const int32_t *kon) {
+    switch (sel) {
+    case 0: return r[0][3];
+    case 1: return r[1][3];
+    case 2: return r[2][3];
+    case 3: return r[3][3];
+    case 4: return tex[3];
+    case 5: return ras[3];
+    case 6: return kon[3];
+    default: return 0;
+    }
+}
+
+static void ras_tev_interp(const RasDraw *d, const RasPixIn *in, int32_t rgba[4]) {
+    int32_t r[4][4];
+    uint32_t s, i, k, ch, cdst = 0, adst = 0;
+
+    for (i = 0; i < 4; i++) {
+        for (ch = 0; ch < 4; ch++) r[i][ch] = d->bank[i][ch];
+    }
+    for (s = 0; s < d->nstages; s++) {
+        const uint32_t cc = d->tevc[s], ac = d->teva[s];
+        const uint32_t order = ras_order(d->tref, s);
+        const uint32_t rasc = (order >> 7) & 7u;
+        int32_t tex[4] = { 0, 0, 0, 0 }, ras[4] = { 0, 0, 0, 0 }, kon[4], raw[4];
+        int32_t cv[4][3], av[4], out[4];
+        const uint32_t cbias = (cc >> 16) & 3u, cscale = (cc >> 20) & 3u, csub = (cc >> 18) & 1u;
+        const uint32_t abias = (ac >> 16) & 3u, ascale = (ac >> 20) & 3u, asub = (ac >> 18) & 1u;
+
+        if ((order >> 6) & 1u) {
+            const uint32_t tc = (order >> 3) & 7u;
+            ras_tex_sample(&d->tex[order & 7u], in->st[tc][0], in->st[tc][1], raw);
+            for (i = 0; i < 4; i++) tex[i] = raw[ras_swap(d->ksel, (ac >> 2) & 3u, i)];
+        }
+        if (rasc <= 1u) {
+            for (i = 0; i < 4; i++) ras[i] = in->clr[rasc][ras_swap(d->ksel, ac & 3u, i)];
+        }
+        ras_konst(d->kcolor, ras_kcsel(d->ksel, s), ras_kasel(d->ksel, s), kon);
+
+        for (k = 0; k < 4; k++) {
+            const uint32_t csel = (cc >> (12u - 4u * k)) & 15u;
+            const uint32_t asel = (ac >> (13u - 3u * k)) & 7u;
+            for (ch = 0; ch < 3; ch++) cv[k][ch] = ras_ref_carg(csel, ch, r, tex, ras, kon);
+            av[k] = ras_ref_aarg(asel, r, tex, ras, kon);
+        }
+
+        if (cbias == 3u) {
+            if (cscale == 3u) {
+                for (ch = 0; ch < 3; ch++) {
+                    const int32_t x = cv[0][ch] & 255, y = cv[1][ch] & 255;
+                    const int hit = csub ? x == y : x > y;
+                    out[ch] = ras_tev_clamp(cv[3][ch] + (hit ? cv[2][ch] & 255 : 0), (cc >> 19) & 1u);
+                }
+            } else {
+                const uint32_t x = ras_cmp_key(cv[0][0], cv[0][1], cv[0][2], cscale);
+                const uint32_t y = ras_cmp_key(cv[1][0], cv[1][1], cv[1][2], cscale);
+                const int hit = csub ? x == y : x > y;
+                for (ch = 0; ch < 3; ch++) {
+                    out[ch] = ras_tev_clamp(cv[3][ch] + (hit ? cv[2][ch] & 255 : 0), (cc >> 19) & 1u);
+                }
+            }
+        } else {
+            for (ch = 0; ch < 3; ch++) {
+                out[ch] = ras_tev_clamp(ras_lerp(cv[0][ch], cv[1][ch], cv[2][ch], cv[3][ch],
+                                                 k_ras_bias[cbias], k_ras_lsh[cscale],
+                                                 k_ras_rsh[cscale], (int)csub),
+                                        (cc >> 19) & 1u);
+            }
+        }
+
+        if (abias == 3u) {
+            uint32_t x, y;
+            int hit;
+            if (ascale == 3u) {
+                x = (uint32_t)(av[0] & 255);
+                y = (uint32_t)(av[1] & 255);
+            } else {
+                x = ras_cmp_key(cv[0][0], cv[0][1], cv[0][2], ascale);
+                y = ras_cmp_key(cv[1][0], cv[1][1], cv[1][2], ascale);
+            }
+            hit = asub ? x == y : x > y;
+            out[3] = ras_tev_clamp(av[3] + (hit ? av[2] & 255 : 0), (ac >> 19) & 1u);
+        } else {
+            out[3] = ras_tev_clamp(ras_lerp(av[0], av[1], av[2], av[3], k_ras_bias[abias],
+                                            k_ras_lsh[ascale], k_ras_rsh[ascale], (int)asub),
+                                   (ac >> 19) & 1u);
+        }
+
+        cdst = (cc >> 22) & 3u;
+        adst = (ac >> 22) & 3u;
+        for (ch = 0; ch < 3; ch++) r[cdst][ch] = out[ch];
+        r[adst][3] = out[3];
+    }
+    rgba[0] = r[cdst][0] & 255;
+    rgba[1] = r[cdst][1] & 255;
+    rgba[2] = r[cdst][2] & 255;
+    rgba[3] = r[adst][3] & 255;
+}
+
+// ---- Draw state ----
+
+static void ras_tex_setup(RasTex *t, const uint32_t *bp, uint32_t map) {
+    const uint32_t base = map < 4u ? map : 0x20u + map - 4u;
+    const uint32_t mode0 = bp[0x80u + base], image0 = bp[0x88u + base];
+    const uint32_t image3 = bp[0x94u + base], tlut = bp[0x98u + base];
+
+    t->w = (image0 & 0x3FFu) + 1u;
+    t->h = ((image0 >> 10) & 0x3FFu) + 1u;
+    t->wrap_s = (uint8_t)(mode0 & 3u);
+    t->wrap_t = (uint8_t)((mode0 >> 2) & 3u);
+    t->linear = (uint8_t)((mode0 >> 4) & 1u);
+    if (gc_gx_gp_mem_hook) {
+        gc_gx_gp_mem_hook(((image3 & 0x1FFFFFu) << 5) | 0x80000000u,
+                          gc_gx_texdec_size(t->w, t->h, (image0 >> 20) & 15u), 0);
+    }
+    t->texels = gc_gx_texdec_get(((image3 & 0x1FFFFFu) << 5) | 0x80000000u, t->w, t->h,
+                                 (image0 >> 20) & 15u, tlut);
+}
+
+static void ras_draw_setup(RasDraw *d, const GcGxGpState *gp) {
+    const uint32_t *bp = gp->bp;
+    uint32_t i, s, maps = 0;
+    uint32_t scis0, scis1, soff;
+
+    memset(d, 0, sizeof(*d));
+    d->nstages = ((bp[0x00] >> 10) & 15u) + 1u;
+    d->cull = (bp[0x00] >> 14) & 3u;
+    for (s = 0; s < 16u; s++) {
+        d->tevc[s] = s < d->nstages ? bp[0xC0u + s * 2u] & 0xFFFFFFu : 0u;
+        d->teva[s] = s < d->nstages ? bp[0xC1u + s * 2u] & 0xFFFFFFu : 0u;
+    }
+    for (i = 0; i < 8u; i++) {
+        d->tref[i] = i < (d->nstages + 1u) / 2u ? bp[0x28u + i] & 0xFFFFFFu : 0u;
+        d->ksel[i] = bp[0xF6u + i] & 0xFFFFFFu;
+    }
+    for (i = 0; i < 4u; i++) {
+        const uint32_t ra = gp->tev_reg[i * 2u], bg = gp->tev_reg[i * 2u + 1u];
+        const uint32_t kra = gp->tev_konst[i * 2u], kbg = gp->tev_konst[i * 2u + 1u];
+        d->bank[i][0] = ras_s11(ra);
+        d->bank[i][3] = ras_s11(ra >> 12);
+        d->bank[i][2] = ras_s11(bg);
+        d->bank[i][1] = ras_s11(bg >> 12);
+        d->kcolor[i][0] = (int32_t)(kra & 0xFFu);
+        d->kcolor[i][3] = (int32_t)((kra >> 12) & 0xFFu);
+        d->kcolor[i][2] = (int32_t)(kbg & 0xFFu);
+        d->kcolor[i][1] = (int32_t)((kbg >> 12) & 0xFFu);
+    }
+    for (i = 0; i < 4u; i++) {
+        d->bank[RAS_ONE][i] = 255;
+        d->bank[RAS_HALF][i] = 128;
+        d->bank[RAS_ZERO][i] = 0;
+    }
+    for (s = 0; s < d->nstages; s++) {
+        const uint32_t order = ras_order(d->tref, s);
+        ras_konst(d->kcolor, ras_kcsel(d->ksel, s), ras_kasel(d->ksel, s), d->konst[s]);
+        if ((order >> 6) & 1u) {
+            maps |= 1u << (order & 7u);
+            d->ntex++;
+        }
+    }
+    // Binned draws keep pointers into the decoded-texture cache until the
+    // next flush, so the cache flushes them before it reuses an image.
+    gc_gx_texdec_release_hook = gc_gx_raster_flush;
+    for (i = 0; i < 8u; i++) {
+        if ((maps >> i) & 1u) ras_tex_setup(&d->tex[i], bp, i);
+    }
+
+    d->zmode = bp[0x40];
+    d->cmode0 = bp[0x41];
+    d->cmode1 = bp[0x42];
+    d->pectrl = bp[0x43];
+    d->acmp = bp[0xF3];
+
+    // Fog: A and C are floats with an 11-bit mantissa.
+    d->fog_a = ras_u2f(((bp[0xEE] >> 19) & 1u) << 31 | ((bp[0xEE] >> 11) & 0xFFu) << 23 |
+                       (bp[0xEE] & 0x7FFu) << 12);
+    d->fog_bmag = bp[0xEF] & 0xFFFFFFu;
+    d->fog_bshift = bp[0xF0] & 31u;
+    d->fog_c = ras_u2f(((bp[0xF1] >> 19) & 1u) << 31 | ((bp[0xF1] >> 11) & 0xFFu) << 23 |
+                       (bp[0xF1] & 0x7FFu) << 12);
+    d->fog_proj = (bp[0xF1] >> 20) & 1u;
+    d->fog_type = (bp[0xF1] >> 21) & 7u;
+    d->fog_color[0] = (int32_t)((bp[0xF2] >> 16) & 0xFFu);
+    d->fog_color[1] = (int32_t)((bp[0xF2] >> 8) & 0xFFu);
+    d->fog_color[2] = (int32_t)(bp[0xF2] & 0xFFu);
+
+    // Window coordinates carry +342; the box offset (in units of 2) moves
+    // the EFB under them. Registers never written mean GXInit defaults.
+    soff = bp[0x59];
+    d->soffx = soff ? (float)((soff & 0x3FFu) * 2u) : 342.0f;
+    d->soffy = soff ? (float)(((soff >> 10) & 0x3FFu) * 2u) : 342.0f;
+    scis0 = bp[0x20];
+    scis1 = bp[0x21];
+    if (scis1 == 0u) {
+        d->sx0 = 0;
+        d->sy0 = 0;
+        d->sx1 = (int32_t)RAS_W - 1;
+        d->sy1 = (int32_t)RAS_H - 1;
+    } else {
+        d->sx0 = (int32_t)((scis0 >> 12) & 0x7FFu) - (int32_t)d->soffx;
+        d->sy0 = (int32_t)(scis0 & 0x7FFu) - (int32_t)d->soffy;
+        d->sx1 = (int32_t)((scis1 >> 12) & 0x7FFu) - (int32_t)d->soffx;
+        d->sy1 = (int32_t)(scis1 & 0x7FFu) - (int32_t)d->soffy;
+        d->sx0 = ras_clampi(d->sx0, 0, (int32_t)RAS_W);
+        d->sy0 = ras_clampi(d->sy0, 0, (int32_t)RAS_H);
+        d->sx1 = ras_clampi(d->sx1, -1, (int32_t)RAS_W - 1);
+        d->sy1 = ras_clampi(d->sy1, -1, (int32_t)RAS_H - 1);
+    }
+    for (i = 0; i < 6u; i++) d->vp[i] = ras_u2f(gp->xf_regs[0x1Au + i]);
+}
+
+// ---- Pixel pipeline ----
+
+static inline int ras_compare(uint32_t func, uint32_t a, uint32_t b) {
+    switch (func & 7u) {
+    case 0: return 0;
+    case 1: return a < b;
+    case 2: return a == b;
+    case 3: return a <= b;
+    case 4: return a > b;
+    case 5: return a != b;
+    case 6: return a >= b;
+    default: return 1;
+    }
+}
+
+static inline int ras_alpha_test(uint32_t acmp, int32_t a) {
+    const int p0 = ras_compare((acmp >> 16) & 7u, (uint32_t)a, acmp & 0xFFu);
+    const int p1 = ras_compare((acmp >> 19) & 7u, (uint32_t)a, (acmp >> 8) & 0xFFu);
+    switch ((acmp >> 22) & 3u) {
+    case 0: return p0 && p1;
+    case 1: return p0 || p1;
+    case 2: return p0 != p1;
+    default: return p0 == p1;
+    }
+}
+
+static inline void ras_fog(const RasDraw *d, uint32_t z, int32_t rgba[4]) {
+    float ze, f;
+    int32_t fi, ch;
+    if (d->fog_proj) {
+        ze = d->fog_a * ((float)z / 16777215.0f);
+    } else {
+        const int32_t den = (int32_t)d->fog_bmag - (int32_t)(z >> d->fog_bshift);
+        ze = den ? d->fog_a * 16777215.0f / (float)den : 0.0f;
+    }
+    ze -= d->fog_c;
+    f = ze < 0.0f ? 0.0f : ze > 1.0f ? 1.0f : ze;
+    switch (d->fog_type) {
+    case 2: break;
+    case 4: f = 1.0f - ras_exp2(-8.0f * f); break;
+    case 5: f = 1.0f - ras_exp2(-8.0f * f * f); break;
+    case 6: f = 1.0f - f; f = ras_exp2(-8.0f * f); break;
+    case 7: f = 1.0f - f; f = ras_exp2(-8.0f * f * f); break;
+    default: return;
+    }
+    fi = (int32_t)(f * 256.0f);
+    for (ch = 0; ch < 3; ch++) {
+        rgba[ch] = (rgba[ch] * (256 - fi) + d->fog_color[ch] * fi) >> 8;
+    }
+}
+
+static inline int32_t ras_blend_factor(uint32_t f, int dst_side, const int32_t *s,
+                                       const int32_t *dc, int ch) {
+    switch (f & 7u) {
+    case 0: return 0;
+    case 1: return 255;
+    case 2: return dst_side ? s[ch] : dc[ch];
+    case 3: return 255 - (dst_side ? s[ch] : dc[ch]);
+    case 4: return s[3];
+    case 5: return 255 - s[3];
+    case 6: return dc[3];
+    default: return 255 - dc[3];
+    }
+}
+
+static inline int32_t ras_logic(uint32_t op, int32_t s, int32_t d) {
+    switch (op & 15u) {
+    case 0: return 0;
+    case 1: return s & d;
+    case 2: return s & ~d;
+    case 3: return s;
+    case 4: return ~s & d;
+    case 5: return d;
+    case 6: return s ^ d;
+    case 7: return s | d;
+    case 8: return ~(s | d);
+    case 9: return ~(s ^ d);
+    case 10: return ~d;
+    case 11: return s | ~d;
+    case 12: return ~s;
+    case 13: return ~s | d;
+    case 14: return ~(s & d);
+    default: return 255;
+    }
+}
+
+// Blend / logic op (cm = BP 0x41), dst alpha (cm1 = 0x42) and the pixel
+// format's precision (pectrl = 0x43) for a pixel write.
+static inline void ras_write_color(uint32_t cm, uint32_t cm1, uint32_t pectrl, uint32_t *px,
+                                   int32_t s[4]) {
+    const uint32_t old = *px;
+    const uint32_t fmt = pectrl & 7u;
+    int32_t dc[4], o[4];
+    int ch;
+
+    dc[0] = (int32_t)(old >> 24);
+    dc[1] = (int32_t)((old >> 16) & 0xFFu);
+    dc[2] = (int32_t)((old >> 8) & 0xFFu);
+    dc[3] = (int32_t)(old & 0xFFu);
+
+    if (cm & 1u) {
+        for (ch = 0; ch < 4; ch++) {
+            const int32_t fs = ras_blend_factor((cm >> 8) & 7u, 0, s, dc, ch);
+            const int32_t fd = ras_blend_factor((cm >> 5) & 7u, 1, s, dc, ch);
+            if ((cm >> 11) & 1u) {
+                o[ch] = ras_clampi(dc[ch] - s[ch], 0, 255);
+            } else {
+                o[ch] = (s[ch] * (fs + (fs >> 7)) + dc[ch] * (fd + (fd >> 7))) >> 8;
+                o[ch] = ras_clampi(o[ch], 0, 255);
+            }
+        }
+    } else if ((cm >> 1) & 1u) {
+        for (ch = 0; ch < 4; ch++) o[ch] = ras_logic((cm >> 12) & 15u, s[ch], dc[ch]) & 255;
+    } else {
+        for (ch = 0; ch < 4; ch++) o[ch] = s[ch];
+    }
+    if ((cm1 >> 8) & 1u) o[3] = (int32_t)(cm1 & 0xFFu);
+
+    if (fmt == 1u) {
+        // RGBA6: 6 bits per channel, expanded back to 8.
+        for (ch = 0; ch < 4; ch++) o[ch] = ((o[ch] >> 2) << 2) | (o[ch] >> 6);
+    } else if (fmt == 2u) {
+        o[0] = ((o[0] >> 3) << 3) | (o[0] >> 5);
+        o[1] = ((o[1] >> 2) << 2) | (o[1] >> 6);
+        o[2] = ((o[2] >> 3) << 3) | (o[2] >> 5);
+    }
+    if (!((cm >> 3) & 1u)) {
+        o[0] = dc[0];
+        o[1] = dc[1];
+        o[2] = dc[2];
+    }
+    if (fmt != 1u) o[3] = 255;
+    else if (!((cm >> 4) & 1u)) o[3] = dc[3];
+    *px = ((uint32_t)o[0] << 24) | ((uint32_t)o[1] << 16) | ((uint32_t)o[2] << 8) | (uint32_t)o[3];
+}
+
+static inline float ras_plane(const float *p, float dx, float dy) {
+    return p[0] + p[1] * dx + p[2] * dy;
+}
+
+static inline int ras_covered(const RasTri *t, double px, double py) {
+    uint32_t i;
+    for (i = 0; i < 3; i++) {
+        const double e = t->e[i][0] * px + t->e[i][1] * py + t->e[i][2];
+        if (e < 0.0 || (e == 0.0 && !t->tl[i])) return 0;
+    }
+    return 1;
+}
+
+static inline void ras_shade(GcGxEfb *efb, const RasDraw *d, const RasTri *t, uint32_t mask,
+                             int32_t x, int32_t y, int ref, RasCount *cnt) {
+    const float dx = ((float)x + 0.5f) - t->ox;
+    const float dy = ((float)y + 0.5f) - t->oy;
+    const uint32_t at = (uint32_t)y * RAS_W + (uint32_t)x;
+    const uint32_t zmode = d->zmode;
+    const int early = (d->pectrl >> 6) & 1u;
+    const float zf = ras_plane(t->z, dx, dy);
+    const uint32_t z = !(zf > 0.0f) ? 0u : zf >= 16777215.0f ? 0xFFFFFFu : (uint32_t)zf;
+    RasPixIn in;
+    int32_t rgba[4];
+    float iw = 1.0f;
+    uint32_t k;
+
+    cnt->pixels++;
+    if (early) {
+        cnt->top_in++;
+        if (zmode & 1u) {
+            if (!ras_compare(zmode >> 1, z, efb->depth[at])) return;
+            if ((zmode >> 4) & 1u) efb->depth[at] = z;
+        }
+        cnt->top_out++;
+    }
+
+    if (t->persp) iw = 1.0f / ras_plane(t->iw, dx, dy);
+    memset(&in, 0, sizeof(in));
+    for (k = 0; k < 8u; k++) {
+        if ((mask >> k) & 1u) in.clr[k >> 2][k & 3u] = ras_to8(ras_plane(t->a[k], dx, dy) * iw);
+    }
+    for (k = 0; k < 8u; k++) {
+        const uint32_t a = RAS_ATTR_TEX0 + k * 3u;
+        if ((mask >> a) & 1u) {
+            const float s = ras_plane(t->a[a], dx, dy) * iw;
+            const float tt = ras_plane(t->a[a + 1u], dx, dy) * iw;
+            const float q = ras_plane(t->a[a + 2u], dx, dy) * iw;
+            in.st[k][0] = q != 0.0f ? s / q : s;
+            in.st[k][1] = q != 0.0f ? tt / q : tt;
+        }
+    }
+
+    if (ref) ras_tev_interp(d, &in, rgba);
+    else ras_prog_run(d->prog, d, &in, rgba);
+    cnt->texels += d->ntex;
+
+    if (ref ? !ras_alpha_test(d->acmp, rgba[3])
+            : !((d->prog->apass[rgba[3] >> 5] >> (rgba[3] & 31)) & 1u)) {
+        return;
+    }
+    // The PE bounding box counts whole 2x2 quads.
+    if ((uint32_t)x < cnt->left) cnt->left = (uint32_t)x & ~1u;
+    if ((uint32_t)x > cnt->right) cnt->right = (uint32_t)x | 1u;
+    if ((uint32_t)y < cnt->top) cnt->top = (uint32_t)y & ~1u;
+    if ((uint32_t)y > cnt->bottom) cnt->bottom = (uint32_t)y | 1u;
+    if (d->fog_type) ras_fog(d, z, rgba);
+    if (!early) {
+        cnt->bot_in++;
+        if (zmode & 1u) {
+            if (!ras_compare(zmode >> 1, z, efb->depth[at])) return;
+            if ((zmode >> 4) & 1u) efb->depth[at] = z;
+        }
+        cnt->bot_out++;
+    }
+    ras_write_color(d->cmode0, d->cmode1, d->pectrl, &efb->color[at], rgba);
+    cnt->written++;
+}
+
+// ---- Setup ----
+
+static void ras_load_vtx(RasVtx *v, const GcGxXfBuf *xf, const RasDraw *d, uint32_t i,
+                         uint32_t mask) {
+    uint32_t k;
+    v->cx = xf->f[GC_GX_XF_CLIP + 0][i];
+    v->cy = xf->f[GC_GX_XF_CLIP + 1][i];
+    v->cz = xf->f[GC_GX_XF_CLIP + 2][i];
+    v->cw = xf->f[GC_GX_XF_CLIP + 3][i];
+    v->x = xf->f[GC_GX_XF_WIN + 0][i] - d->soffx;
+    v->y = xf->f[GC_GX_XF_WIN + 1][i] - d->soffy;
+    v->z = xf->f[GC_GX_XF_WIN + 2][i];
+    for (k = 0; k < RAS_ATTRS; k++) {
+        const uint32_t plane = k < RAS_ATTR_TEX0 ? GC_GX_XF_CLR0 + k : GC_GX_XF_TEX0 + (k - RAS_ATTR_TEX0);
+        v->a[k] = ((mask >> k) & 1u) && ((xf->mask >> plane) & 1u) ? xf->f[plane][i] : 0.0f;
+    }
+}
+
+static void ras_clip_lerp(RasVtx *o, const RasVtx *a, const RasVtx *b, float t,
+                          const RasDraw *d) {
+    uint32_t k;
+    float inv;
+    o->cx = a->cx + (b->cx - a->cx) * t;
+    o->cy = a->cy + (b->cy - a->cy) * t;
+    o->cz = a->cz + (b->cz - a->cz) * t;
+    o->cw = a->cw + (b->cw - a->cw) * t;
+    for (k = 0; k < RAS_ATTRS; k++) o->a[k] = a->a[k] + (b->a[k] - a->a[k]) * t;
+    inv = 1.0f / o->cw;
+    o->x = o->cx * inv * d->vp[0] + d->vp[3] - d->soffx;
+    o->y = o->cy * inv * d->vp[1] + d->vp[4] - d->soffy;
+    o->z = o->cz * inv * d->vp[2] + d->vp[5];
+}
+
+static void ras_plane_setup(float *p, float v0, float v1, float v2,
+                            float dx1, float dy1, float dx2, float dy2, float inv) {
+    p[0] = v0;
+    p[1] = ((v1 - v0) * dy2 - (v2 - v0) * dy1) * inv;
+    p[2] = ((v2 - v0) * dx1 - (v1 - v0) * dx2) * inv;
+}
+
+// Set up one clipped triangle. Returns 0 when it is culled or scissored.
+static int ras_tri_setup(RasTri *t, const RasVtx *a, const RasVtx *b, const RasVtx *c,
+                         const RasDraw *d, uint32_t mask) {
+    const RasVtx *v[3];
+    float area, inv, dx1, dy1, dx2, dy2;
+    float minx, maxx, miny, maxy;
+    uint32_t i, k;
+
+    area = (b->x - a->x) * (c->y - a->y) - (c->x - a->x) * (b->y - a->y);
+    // Clockwise on screen is front-facing; genMode cull 1 = back, 2 = front.
+    if (area == 0.0f || d->cull == 3u || (d->cull == 1u && area < 0.0f) ||
+        (d->cull == 2u && area > 0.0f)) {
+        gc_gx_raster_stats.culled++;
+        return 0;
+    }
+    v[0] = a;
+    v[1] = area > 0.0f ? b : c;
+    v[2] = area > 0.0f ? c : b;
+
+    minx = maxx = v[0]->x;
+    miny = maxy = v[0]->y;
+    for (i = 1; i < 3; i++) {
+        if (v[i]->x < minx) minx = v[i]->x;
+        if (v[i]->x > maxx) maxx = v[i]->x;
+        if (v[i]->y < miny) miny = v[i]->y;
+        if (v[i]->y > maxy) maxy = v[i]->y;
+    }
+    minx = minx < -1.0f ? -1.0f : minx > (float)RAS_W ? (float)RAS_W : minx;
+    maxx = maxx < -1.0f ? -1.0f : maxx > (float)RAS_W ? (float)RAS_W : maxx;
+    miny = miny < -1.0f ? -1.0f : miny > (float)RAS_H ? (float)RAS_H : miny;
+    maxy = maxy < -1.0f ? -1.0f : maxy > (float)RAS_H ? (float)RAS_H : maxy;
+    t->x0 = (int16_t)ras_clampi((int32_t)(minx + 1.0f) - 1, d->sx0, (int32_t)RAS_W);
+    t->y0 = (int16_t)ras_clampi((int32_t)(miny + 1.0f) - 1, d->sy0, (int32_t)RAS_H);
+    t->x1 = (int16_t)ras_clampi((int32_t)(maxx + 1.0f), -1, d->sx1);
+    t->y1 = (int16_t)ras_clampi((int32_t)(maxy + 1.0f), -1, d->sy1);
+    if (t->x0 > t->x1 || t->y0 > t->y1) {
+        gc_gx_raster_stats.clipped++;
+        return 0;
+    }
+
+    // Edge (va -> vb): cross(vb - va, p - va), positive inside. The products
+    // are exact in double, so an edge shared by two triangles evaluates to
+    // exactly opposite values and the tie rule gives each center to one side.
+    for (i = 0; i < 3; i++) {
+        const RasVtx *va = v[i], *vb = v[(i + 1u) % 3u];
+        const double ea = (double)va->y - (double)vb->y;
+        const double eb = (double)vb->x - (double)va->x;
+        t->e[i][0] = ea;
+        t->e[i][1] = eb;
+        t->e[i][2] = (double)va->x * (double)vb->y - (double)vb->x * (double)va->y;
+        t->tl[i] = (uint8_t)(ea > 0.0 || (ea == 0.0 && eb > 0.0));
+    }
+
+    dx1 = v[1]->x - v[0]->x;
+    dy1 = v[1]->y - v[0]->y;
+    dx2 = v[2]->x - v[0]->x;
+    dy2 = v[2]->y - v[0]->y;
+    inv = 1.0f / (dx1 * dy2 - dx2 * dy1);
+    t->ox = v[0]->x;
+    t->oy = v[0]->y;
+    ras_plane_setup(t->z, v[0]->z, v[1]->z, v[2]->z, dx1, dy1, dx2, dy2, inv);
+    t->persp = (uint8_t)(v[0]->cw != 1.0f || v[1]->cw != 1.0f || v[2]->cw != 1.0f);
+    if (t->persp) {
+        const float w0 = 1.0f / v[0]->cw, w1 = 1.0f / v[1]->cw, w2 = 1.0f / v[2]->cw;
+        ras_plane_setup(t->iw, w0, w1, w2, dx1, dy1, dx2, dy2, inv);
+        for (k = 0; k < RAS_ATTRS; k++) {
+            if ((mask >> k) & 1u) {
+                ras_plane_setup(t->a[k], v[0]->a[k] * w0, v[1]->a[k] * w1, v[2]->a[k] * w2,
+                                dx1, dy1, dx2, dy2, inv);
+            }
+        }
+    } else {
+        for (k = 0; k < RAS_ATTRS; k++) {
+            if ((mask >> k) & 1u) {
+                ras_plane_setup(t->a[k], v[0]->a[k], v[1]->a[k], v[2]->a[k],
+                                dx1, dy1, dx2, dy2, inv);
+            }
+        }
+    }
+    return 1;
+}
+
+typedef void (*RasEmitFn)(GcGxEfb *efb, const RasTri *t, const RasDraw *d, uint32_t mask);
+
+// Near-plane clip (clip z >= -w) and set up. Up to two triangles come out.
+static void ras_triangle(GcGxEfb *efb, const RasVtx *a, const RasVtx *b, const RasVtx *c,
+                         const RasDraw *d, uint32_t draw, uint32_t mask, RasEmitFn emit) {
+    const RasVtx *in[3] = { a, b, c };
+    RasVtx tmp[2];
+    const RasVtx *poly[4];
+    uint32_t n = 0, ntmp = 0, i;
+    RasTri t;
+
+    gc_gx_raster_stats.tris++;
+    if (a->cz + a->cw >= 0.0f && b->cz + b->cw >= 0.0f && c->cz + c->cw >= 0.0f) {
+        poly[0] = a;
+        poly[1] = b;
+        poly[2] = c;
+        n = 3;
+    } else {
+        for (i = 0; i < 3; i++) {
+            const RasVtx *p = in[i], *q = in[(i + 1u) % 3u];
+            const float dp = p->cz + p->cw, dq = q->cz + q->cw;
+            if (dp >= 0.0f) poly[n++] = p;
+            if ((dp >= 0.0f) != (dq >= 0.0f)) {
+                ras_clip_lerp(&tmp[ntmp], p, q, dp / (dp - dq), d);
+                poly[n++] = &tmp[ntmp++];
+            }
+        }
+        if (n < 3) {
+            gc_gx_raster_stats.clipped++;
+            return;
+        }
+    }
+    for (i = 1; i + 1u < n; i++) {
+        if (poly[0]->cw <= 0.0f || poly[i]->cw <= 0.0f || poly[i + 1u]->cw <= 0.0f) {
+            gc_gx_raster_stats.clipped++;
+            continue;
+        }
+        if (!ras_tri_setup(&t, poly[0], poly[i], poly[i + 1u], d, mask)) continue;
+        t.draw = draw;
+        emit(efb, &t, d, mask);
+    }
+}
+
+// Walk cmd's primitive over xf and hand each triangle to emit.
+static void ras_assemble(GcGxEfb *efb, const GcGxXfBuf *xf, uint32_t cmd, const RasDraw *d,
+                         uint32_t draw, uint32_t mask, RasEmitFn emit) {
+    const uint32_t n = xf->count;
+    uint32_t i;
+    RasVtx v[4];
+
+    switch (cmd & 0xF8u) {
+    case 0x80u:  // quads
+    case 0x88u:
+        for (i = 0; i + 3u < n; i += 4u) {
+            ras_load_vtx(&v[0], xf, d, i, mask);
+            ras_load_vtx(&v[1], xf, d, i + 1u, mask);
+            ras_load_vtx(&v[2], xf, d, i + 2u, mask);
+            ras_load_vtx(&v[3], xf, d, i + 3u, mask);
+            ras_triangle(efb, &v[0], &v[1], &v[2], d, draw, mask, emit);
+            ras_triangle(efb, &v[0], &v[2], &v[3], d, draw, mask, emit);
+        }
+        break;
+    case 0x90u:  // triangles
+        for (i = 0; i + 2u < n; i += 3u) {
+            ras_load_vtx(&v[0], xf, d, i, mask);
+            ras_load_vtx(&v[1], xf, d, i + 1u, mask);
+            ras_load_vtx(&v[2], xf, d, i + 2u, mask);
+            ras_triangle(efb, &v[0], &v[1], &v[2], d, draw, mask, emit);
+        }
+        break;
+    case 0x98u:  // strip: odd triangles swap their first two vertices
+        for (i = 0; i + 2u < n; i++) {
+            ras_load_vtx(&v[0], xf, d, i + (i & 1u), mask);
+            ras_load_vtx(&v[1], xf, d, i + 1u - (i & 1u), mask);
+            ras_load_vtx(&v[2], xf, d, i + 2u, mask);
+            ras_triangle(efb, &v[0], &v[1], &v[2], d, draw, mask, emit);
+        }
+        break;
+    case 0xA0u:  // fan
+        if (n >= 3u) ras_load_vtx(&v[0], xf, d, 0, mask);
+        for (i = 1; i + 1u < n; i++) {
+            ras_load_vtx(&v[1], xf, d, i, mask);
+            ras_load_vtx(&v[2], xf, d, i + 1u, mask);
+            ras_triangle(efb, &v[0], &v[1], &v[2], d, draw, mask, emit);
+        }
+        break;
+    case 0xA8u:
+        gc_gx_raster_stats.skipped += n / 2u;
+        break;
+    case 0xB0u:
+        gc_gx_raster_stats.skipped += n > 0u ? n - 1u : 0u;
+        break;
+    default:
+        gc_gx_raster_stats.skipped += n;
+        break;
+    }
+}
+
+// ---- Binning and tile shading ----
+
+static int ras_bin_push(RasBin *bin, uint32_t idx) {
+    if (bin->n == bin->cap) {
+        const uint32_t cap = bin->cap ? bin->cap * 2u : 64u;
+        uint32_t *p = (uint32_t *)realloc(bin->idx, cap * sizeof(*p));
+        if (!p) return 0;
+        bin->idx = p;
+        bin->cap = cap;
+    }
+    bin->idx[bin->n++] = idx;
+    return 1;
+}
+
+static int s_ras_oom;
+
+static void ras_emit_binned(GcGxEfb *efb, const RasTri *t, const RasDraw *d, uint32_t mask) {
+    uint32_t tx, ty, idx;
+    (void)efb;
+    (void)d;
+    (void)mask;
+    if (s_ras_ntris == s_ras_tri_cap) {
+        const uint32_t cap = s_ras_tri_cap ? s_ras_tri_cap * 2u : 1024u;
+        RasTri *p = (RasTri *)realloc(s_ras_tris, cap * sizeof(*p));
+        if (!p) {
+            s_ras_oom = 1;
+            return;
+        }
+        s_ras_tris = p;
+        s_ras_tri_cap = cap;
+    }
+    idx = s_ras_ntris++;
+    s_ras_tris[idx] = *t;
+    for (ty = (uint32_t)t->y0 / RAS_TILE; ty <= (uint32_t)t->y1 / RAS_TILE; ty++) {
+        for (tx = (uint32_t)t->x0 / RAS_TILE; tx <= (uint32_t)t->x1 / RAS_TILE; tx++) {
+            if (!ras_bin_push(&s_ras_bin[ty * RAS_TX + tx], idx)) s_ras_oom = 1;
+        }
+    }
+}
+
+static void ras_shade_tile(uint32_t tile, RasCount *cnt) {
+    const RasBin *bin = &s_ras_bin[tile];
+    const int32_t tx0 = (int32_t)((tile % RAS_TX) * RAS_TILE);
+    const int32_t ty0 = (int32_t)((tile / RAS_TX) * RAS_TILE);
+    const int32_t tx1 = tx0 + (int32_t)RAS_TILE - 1;
+    const int32_t ty1 = ty0 + (int32_t)RAS_TILE - 1;
+    uint32_t k;
+
+    for (k = 0; k < bin->n; k++) {
+        const RasTri *t = &s_ras_tris[bin->idx[k]];
+        const RasDraw *d = &s_ras_draws[t->draw];
+        const int32_t x0 = t->x0 > tx0 ? t->x0 : tx0, x1 = t->x1 < tx1 ? t->x1 : tx1;
+        const int32_t y0 = t->y0 > ty0 ? t->y0 : ty0, y1 = t->y1 < ty1 ? t->y1 : ty1;
+        int32_t x, y;
+        for (y = y0; y <= y1; y++) {
+            for (x = x0; x <= x1; x++) {
+                if (ras_covered(t, (double)x + 0.5, (double)y + 0.5)) {
+                    ras_shade(s_ras_target, d, t, d->attr_mask, x, y, 0, cnt);
+                }
+            }
+        }
+    }
+}
+
+#ifdef GC_GX_RASTER_THREADS
+typedef struct {
+    uint32_t *next;
+    RasCount cnt;
+} RasWorker;
+
+static void *ras_worker(void *arg) {
+    RasWorker *w = (RasWorker *)arg;
+    uint32_t tile;
+    while ((tile = __atomic_fetch_add(w->next, 1u, __ATOMIC_RELAXED)) < RAS_TILES) {
+        if (s_ras_bin[tile].n) ras_shade_tile(tile, &w->cnt);
+    }
+    return NULL;
+}
+
+static void ras_count_add(RasCount *total, const RasCount *c) {
+    total->pixels += c->pixels;
+    total->written += c->written;
+    total->top_in += c->top_in;
+    total->top_out += c->top_out;
+    total->bot_in += c->bot_in;
+    total->bot_out += c->bot_out;
+    total->texels += c->texels;
+    if (c->left < total->left) total->left = c->left;
+    if (c->top < total->top) total->top = c->top;
+    if (c->right > total->right) total->right = c->right;
+    if (c->bottom > total->bottom) total->bottom = c->bottom;
+}
+
+// Workers pull tiles off a shared counter; the caller works too.
+static int ras_flush_parallel(uint32_t nthreads, RasCount *total) {
+    pthread_t tid[GC_GX_RASTER_MAX_THREADS];
+    RasWorker w[GC_GX_RASTER_MAX_THREADS];
+    uint32_t next = 0, t, started = 0;
+
+    for (t = 0; t < nthreads; t++) {
+        w[t].next = &next;
+        ras_count_init(&w[t].cnt);
+    }
+    for (t = 1; t < nthreads; t++) {
+        if (pthread_create(&tid[started], NULL, ras_worker, &w[t]) != 0) break;
+        started++;
+    }
+    ras_worker(&w[0]);
+    for (t = 0; t < started; t++) pthread_join(tid[t], NULL);
+    for (t = 0; t <= started; t++) ras_count_add(total, &w[t].cnt);
+    return started != 0;
+}
+#endif
+
+void gc_gx_raster_flush(void) {
+    RasCount cnt;
+    uint32_t tile;
+
+    if (s_ras_ntris) {
+        ras_count_init(&cnt);
+        gc_gx_raster_stats.flushes++;
+#ifdef GC_GX_RASTER_THREADS
+        if (gc_gx_raster_threads > 1u && s_ras_ntris >= RAS_PAR_MIN) {
+            const uint32_t nt = gc_gx_raster_threads < GC_GX_RASTER_MAX_THREADS
+                                    ? gc_gx_raster_threads : GC_GX_RASTER_MAX_THREADS;
+            if (ras_flush_parallel(nt, &cnt)) gc_gx_raster_stats.parallel_flushes++;
+        } else
+#endif
+        {
+            for (tile = 0; tile < RAS_TILES; tile++) {
+                if (s_ras_bin[tile].n) ras_shade_tile(tile, &cnt);
+            }
+        }
+        ras_count_stats(&cnt);
+        for (tile = 0; tile < RAS_TILES; tile++) s_ras_bin[tile].n = 0;
+    }
+    s_ras_ntris = 0;
+    s_ras_ndraws = 0;
+}
+
+// ---- Public API ----
+
+int gc_gx_raster_efb_init(GcGxEfb *efb) {
+    efb->color = (uint32_t *)malloc(RAS_W * RAS_H * sizeof(uint32_t));
+    efb->depth = (uint32_t *)malloc(RAS_W * RAS_H * sizeof(uint32_t));
+    if (!efb->color || !efb->depth) {
+        gc_gx_raster_efb_free(efb);
+        return 0;
+    }
+    if (s_ras_target == efb) s_ras_target = NULL;
+    gc_gx_raster_clear(efb, 0u, 0xFFFFFFu);
+    return 1;
+}
+
+void gc_gx_raster_efb_free(GcGxEfb *efb) {
+    if (s_ras_target == efb) {
+        gc_gx_raster_flush();
+        s_ras_target = NULL;
+    }
+    free(efb->color);
+    free(efb->depth);
+    efb->color = NULL;
+    efb->depth = NULL;
+}
+
+static void ras_fill(GcGxEfb *efb, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1,
+                     uint32_t rgba, uint32_t z) {
+    uint32_t x, y;
+    for (y = y0; y < y1; y++) {
+        uint32_t *c = efb->color + y * RAS_W;
+        uint32_t *dp = efb->depth + y * RAS_W;
+        for (x = x0; x < x1; x++) {
+            c[x] = rgba;
+            dp[x] = z & 0xFFFFFFu;
+        }
+    }
+}
+
+void gc_gx_raster_clear(GcGxEfb *efb, uint32_t rgba, uint32_t z) {
+    if (s_ras_target == efb) gc_gx_raster_flush();
+    if (!efb->color) return;
+    ras_fill(efb, 0, 0, RAS_W, RAS_H, rgba, z);
+}
+
+void gc_gx_raster_clear_rect(GcGxEfb *efb, uint32_t x, uint32_t y, uint32_t w, uint32_t h,
+                             uint32_t rgba, uint32_t z) {
+    uint32_t x1 = x + w, y1 = y + h;
+
+    if (s_ras_target == efb) gc_gx_raster_flush();
+    if (!efb->color || x >= RAS_W || y >= RAS_H) return;
+    if (x1 > RAS_W) x1 = RAS_W;
+    if (y1 > RAS_H) y1 = RAS_H;
+    ras_fill(efb, x, y, x1, y1, rgba, z);
+}
+
+void gc_gx_raster_copy_clear(GcGxEfb *efb, const GcGxGpState *gp) {
+    const uint32_t src = gp->bp[0x49], size = gp->bp[0x4A];
+    const uint32_t ar = gp->bp[0x4F], gb = gp->bp[0x50];
+    const uint32_t rgba = ((ar & 0xFFu) << 24) | (((gb >> 8) & 0xFFu) << 16) |
+                          ((gb & 0xFFu) << 8) | ((ar >> 8) & 0xFFu);
+
+    gc_gx_raster_clear_rect(efb, src & 0x3FFu, (src >> 10) & 0x3FFu, (size & 0x3FFu) + 1u,
+                            ((size >> 10) & 0x3FFu) + 1u, rgba, gp->bp[0x51]);
+}
+
+void gc_gx_raster_bbox_write(uint32_t id, uint32_t val) {
+    GcGxRasterBBox *bb = &gc_gx_raster_bbox;
+    gc_gx_raster_flush();
+    if (id == 0x55u) {
+        bb->left = val & 0x3FFu;
+        bb->right = (val >> 10) & 0x3FFu;
+    } else {
+        bb->top = val & 0x3FFu;
+        bb->bottom = (val >> 10) & 0x3FFu;
+    }
+}
+
+// CPU access to (x, y): shade the pending triangles of that pixel's tile
+// only. Tiles are independent, so the later flush gives the same EFB.
+// Returns the pixel's index, or -1 outside the EFB.
+static int32_t ras_cpu_access(GcGxEfb *efb, uint32_t x, uint32_t y) {
+    const uint32_t tile = (y / RAS_TILE) * RAS_TX + x / RAS_TILE;
+    RasCount cnt;
+
+    if (x >= RAS_W || y >= RAS_H) return -1;
+    if (!efb->color && !gc_gx_raster_efb_init(efb)) return -1;
+    if (s_ras_target == efb && s_ras_bin[tile].n) {
+        ras_count_init(&cnt);
+        ras_shade_tile(tile, &cnt);
+        ras_count_stats(&cnt);
+        s_ras_bin[tile].n = 0;
+        gc_gx_raster_stats.tile_flushes++;
+    }
+    return (int32_t)(y * RAS_W + x);
+}
+
+uint32_t gc_gx_raster_peek_argb(GcGxEfb *efb, uint32_t x, uint32_t y, const GcGxPokeMode *m) {
+    const int32_t at = ras_cpu_access(efb, x, y);
+    uint32_t px, a;
+
+    gc_gx_raster_stats.peeks++;
+    if (at < 0) return 0;
+    px = efb->color[at];
+    switch (m->aread & 3u) {
+    case 0: a = 0x00u; break;
+    case 1: a = 0xFFu; break;
+    default: a = px & 0xFFu; break;
+    }
+    return a << 24 | px >> 8;
+}
+
+uint32_t gc_gx_raster_peek_z(GcGxEfb *efb, uint32_t x, uint32_t y) {
+    const int32_t at = ras_cpu_access(efb, x, y);
+    gc_gx_raster_stats.peeks++;
+    return at < 0 ? 0u : efb->depth[at];
+}
+
+void gc_gx_raster_poke_argb(GcGxEfb *efb, uint32_t x, uint32_t y, uint32_t argb,
+                            const GcGxPokeMode *m, const GcGxGpState *gp) {
+    const int32_t at = ras_cpu_access(efb, x, y);
+    int32_t s[4];
+
+    gc_gx_raster_stats.pokes++;
+    if (at < 0) return;
+    s[0] = (int32_t)((argb >> 16) & 0xFFu);
+    s[1] = (int32_t)((argb >> 8) & 0xFFu);
+    s[2] = (int32_t)(argb & 0xFFu);
+    s[3] = (int32_t)(argb >> 24);
+    if (!ras_compare(m->amode >> 8, (uint32_t)s[3], m->amode & 0xFFu)) return;
+    ras_write_color(m->cmode0, m->cmode1, gp->bp[0x43], &efb->color[at], s);
+}
+
+void gc_gx_raster_poke_z(GcGxEfb *efb, uint32_t x, uint32_t y, uint32_t z, const GcGxPokeMode *m) {
+    const int32_t at = ras_cpu_access(efb, x, y);
+
+    gc_gx_raster_stats.pokes++;
+    if (at < 0 || !(m->zmode & 1u)) return;
+    z &= 0xFFFFFFu;
+    if (!ras_compare(m->zmode >> 1, z, efb->depth[at])) return;
+    if ((m->zmode >> 4) & 1u) efb->depth[at] = z;
+}
+
+static int ras_push_draw(const RasDraw *d) {
+    if (s_ras_ndraws == s_ras_draw_cap) {
+        const uint32_t cap = s_ras_draw_cap ? s_ras_draw_cap * 2u : 64u;
+        RasDraw *p = (RasDraw *)realloc(s_ras_draws, cap * sizeof(*p));
+        if (!p) return 0;
+        s_ras_draws = p;
+        s_ras_draw_cap = cap;
+    }
+    s_ras_draws[s_ras_ndraws++] = *d;
+    return 1;
+}
+
+int gc_gx_raster_draw(GcGxEfb *efb, const GcGxXfBuf *xf, uint32_t cmd, const GcGxGpState *gp) {
+    RasDraw d;
+
+    if (!((xf->mask >> GC_GX_XF_WIN) & 1u)) return 1;
+    if (!efb->color && !gc_gx_raster_efb_init(efb)) return 0;
+    if (s_ras_target != efb || s_ras_ntris >= RAS_MAX_PENDING) gc_gx_raster_flush();
+    s_ras_target = efb;
+    ras_draw_setup(&d, gp);
+    d.prog = ras_prog_lookup(&d);
+    d.attr_mask = d.prog->attr_mask;
+    ras_prog_fold(d.prog, &d);
+    if (!ras_push_draw(&d)) return 0;
+    s_ras_oom = 0;
+    ras_assemble(efb, xf, cmd, &d, s_ras_ndraws - 1u, d.attr_mask, ras_emit_binned);
+    return !s_ras_oom;
+}
+
+// Reference: each triangle is shaded as soon as it is set up, straight from
+// the raw TEV registers.
+static void ras_emit_ref(GcGxEfb *efb, const RasTri *t, const RasDraw *d, uint32_t mask) {
+    RasCount cnt;
+    int32_t x, y;
+    ras_count_init(&cnt);
+    for (y = t->y0; y <= t->y1; y++) {
+        for (x = t->x0; x <= t->x1; x++) {
+            if (ras_covered(t, (double)x + 0.5, (double)y + 0.5)) {
+                ras_shade(efb, d, t, mask, x, y, 1, &cnt);
+            }
+        }
+    }
+    ras_count_stats(&cnt);
+}
+
+int gc_gx_raster_draw_ref(GcGxEfb *efb, const GcGxXfBuf *xf, uint32_t cmd, const GcGxGpState *gp) {
+    RasDraw d;
+
+    if (!((xf->mask >> GC_GX_XF_WIN) & 1u)) return 1;
+    if (!efb->color && !gc_gx_raster_efb_init(efb)) return 0;
+    if (s_ras_target == efb) gc_gx_raster_flush();
+    ras_draw_setup(&d, gp);
+    ras_assemble(efb, xf, cmd, &d, 0, 0xFFFFFFFFu, ras_emit_ref);
+    return 1;
+}
+
+void gc_gx_raster_reset(void) {
+    uint32_t tile;
+    for (tile = 0; tile < RAS_TILES; tile++) s_ras_bin[tile].n = 0;
+    s_ras_ntris = 0;
+    s_ras_ndraws = 0;
+    s_ras_target = NULL;
+    memset(s_ras_cache, 0, sizeof(s_ras_cache));
+    s_ras_stamp = 0;
+    s_ras_frame = 1;
+    memset(&gc_gx_raster_stats, 0, sizeof(gc_gx_raster_stats));
+    gc_gx_raster_bbox.left = gc_gx_raster_bbox.top = 0x3FFu;
+    gc_gx_raster_bbox.right = gc_gx_raster_bbox.bottom = 0u;
+}
+
+void gc_gx_raster_end_frame(void) {
+    GcGxRasterStats *st = &gc_gx_raster_stats;
+    st->tev_states_last = st->tev_states;
+    if (st->tev_states > st->tev_states_max) st->tev_states_max = st->tev_states;
+    st->tev_states = 0;
+    s_ras_frame++;
+}
@@ -0,0 +1,164 @@
+/*
+ * sdk_port/gx/gx_raster.h --- Headless software rasterizer (setup, TEV, PE).
+ *
+ * Runs after the XF stage (gx_xf.h) under the BP state the draw executes
+ * with (gc_gx_gp) and writes a 640x528 EFB in host memory:
+ *
+ *   - Quads, triangles, strips and fans are drawn; lines and points are
+ *     counted in stats.skipped only.
+ *   - genMode[14..15] culling, near-plane clipping, scissor (BP 0x20/0x21
+ *     with the 0x59 box offset).
+ *   - TEV: genMode[10..13] stages with orders (0x28..), combiners (0xC0..),
+ *     registers/konst colors (0xE0..0xE7) and konst/swap selects (0xF6..).
+ *   - PE: alpha compare (0xF3), fog (0xEE..0xF2), z mode (0x40), blend and
+ *     logic op (0x41), dst alpha (0x42), pixel format / z location (0x43).
+ *   - BP 0x52 with the clear bit clears the copy source rectangle.
+ *   - PE bounding box: the 2x2 quads holding pixels that passed the alpha
+ *     test widen it; BP 0x55/0x56 set it (GXClearBoundingBox).
+ *
+ * TEV texture inputs sample the base level of the map's image, decoded
+ * through the texture cache (gx_texdec.h), with the map's wrap modes and
+ * nearest or bilinear filtering from its mag filter. Images that cannot be
+ * read or decoded sample as opaque white.
+ *
+ * gc_gx_raster_draw sets triangles up and bins them into 32x32 tiles;
+ * shading happens in gc_gx_raster_flush (PE_DONE, copies, clears, or when
+ * the bins fill up). Each tile keeps its triangles in submission order, so
+ * tiles are independent: builds that define GC_GX_RASTER_THREADS (and link
+ * pthreads) shade them on gc_gx_raster_threads threads with the same result
+ * as a serial flush.
+ *
+ * Each pipeline state (TEV stages, orders, swap and konst selects, plus z
+ * mode, blend, dst alpha, PE control, alpha compare and fog mode) is
+ * compiled once into a plan: per-stage combiner functions specialized for
+ * their operation, without the stages whose result is never read, with the
+ * stages that only read per-draw constants run once per draw, and the alpha
+ * compare as a 256-entry table. Plans are cached by a hash of the state in
+ * GC_GX_RASTER_TEV_CACHE entries, 4-way LRU. gc_gx_raster_end_frame
+ * (GXCopyDisp) closes the per-frame count of distinct states.
+ * gc_gx_raster_draw_ref draws immediately with a per-pixel TEV interpreter
+ * and is the test oracle.
+ *
+ * CPU EFB access (GXPeek*, GXPoke*) goes through gc_gx_raster_peek_* and
+ * gc_gx_raster_poke_*, which shade the pending triangles of the accessed
+ * pixel's tile only, so a peek between draws costs one tile instead of a
+ * full flush. Color pokes run the poke alpha threshold, blend / logic op,
+ * update masks and dst alpha of GcGxPokeMode with the current pixel
+ * format; Z pokes run the poke z mode. The EFB itself stays row-major for
+ * the copy paths (gx_texcopy.h, gx_xfb.h).
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "gx_gp.h"
+#include "gx_xf.h"
+
+#define GC_GX_EFB_WIDTH   640u
+#define GC_GX_EFB_HEIGHT  528u
+
+#define GC_GX_RASTER_TILE         32u
+#define GC_GX_RASTER_TILES_X      20u
+#define GC_GX_RASTER_TILES_Y      17u
+#define GC_GX_RASTER_TEV_CACHE    64u
+#define GC_GX_RASTER_MAX_THREADS  8u
+
+typedef struct {
+    uint32_t *color;   /* r << 24 | g << 16 | b << 8 | a */
+    uint32_t *depth;   /* 24-bit */
+} GcGxEfb;
+
+typedef struct {
+    uint32_t tris;            /* triangles assembled */
+    uint32_t culled;
+    uint32_t clipped;         /* outside the near plane or the scissor box */
+    uint32_t skipped;         /* line/point primitives (not rasterized) */
+    uint64_t pixels;          /* covered pixels */
+    uint64_t written;         /* pixels that passed every test */
+    uint64_t top_in;          /* pixels into / out of the early depth test */
+    uint64_t top_out;
+    uint64_t bot_in;          /* pixels into / out of the late depth test */
+    uint64_t bot_out;
+    uint64_t texels;          /* texture samples taken by TEV stages */
+    uint32_t tev_hits;
+    uint32_t tev_misses;
+    uint32_t tev_evictions;
+    uint32_t tev_folded;      /* stages run per draw instead of per pixel, in compiled plans */
+    uint32_t tev_dropped;     /* stages never read, removed from compiled plans */
+    uint32_t tev_states;      /* distinct pipeline states drawn this frame */
+    uint32_t tev_states_last; /* ... in the last completed frame */
+    uint32_t tev_states_max;  /* ... in any completed frame */
+    uint32_t flushes;
+    uint32_t parallel_flushes;
+    uint32_t tile_flushes;    /* tiles shaded ahead of a flush for CPU EFB access */
+    uint32_t peeks;
+    uint32_t pokes;
+} GcGxRasterStats;
+
+/* PE bounding box, inclusive. Cleared it is left = top = 0x3FF, right = bottom = 0. */
+typedef struct {
+    uint32_t left, top, right, bottom;
+} GcGxRasterBBox;
+
+/* PE poke modes (GXPoke*) in the layout of the matching BP registers. */
+typedef struct {
+    uint32_t zmode;    /* as 0x40: enable | func << 1 | update << 4 */
+    uint32_t cmode0;   /* as 0x41: blend / logic op, dither, update masks */
+    uint32_t cmode1;   /* as 0x42: alpha | enable << 8 */
+    uint32_t amode;    /* alpha threshold: func << 8 | threshold */
+    uint32_t aread;    /* alpha of color peeks: 0 = 0x00, 1 = 0xFF, 2 = as stored */
+} GcGxPokeMode;
+
+/* EFB the GP draws into; allocated by the first draw. */
+extern GcGxEfb gc_gx_efb;
+extern GcGxRasterStats gc_gx_raster_stats;
+extern GcGxRasterBBox gc_gx_raster_bbox;
+
+/* 0 = draws stop after the XF stage. Default 1. */
+extern uint32_t gc_gx_raster_enable;
+
+/* Worker count for flushes (GC_GX_RASTER_THREADS builds only). Default 4. */
+extern uint32_t gc_gx_raster_threads;
+
+/* Allocate an EFB cleared to color 0 / depth 0xFFFFFF. Returns 0 on failure. */
+int gc_gx_raster_efb_init(GcGxEfb *efb);
+void gc_gx_raster_efb_free(GcGxEfb *efb);
+
+/* Fill the whole EFB (pending triangles are shaded first). */
+void gc_gx_raster_clear(GcGxEfb *efb, uint32_t rgba, uint32_t z);
+
+/* Fill an EFB rectangle (clipped to the EFB; pending triangles are shaded first). */
+void gc_gx_raster_clear_rect(GcGxEfb *efb, uint32_t x, uint32_t y, uint32_t w, uint32_t h,
+                             uint32_t rgba, uint32_t z);
+
+/* BP 0x52 with the clear bit: clear the 0x49/0x4A rectangle to 0x4F..0x51. */
+void gc_gx_raster_copy_clear(GcGxEfb *efb, const GcGxGpState *gp);
+
+/* BP 0x55 (left / right) or 0x56 (top / bottom); pending triangles are shaded first. */
+void gc_gx_raster_bbox_write(uint32_t id, uint32_t val);
+
+/*
+ * CPU EFB access. Colors are ARGB. Peeks outside the EFB read 0 and pokes
+ * there are dropped. gp supplies the pixel format (BP 0x43).
+ */
+uint32_t gc_gx_raster_peek_argb(GcGxEfb *efb, uint32_t x, uint32_t y, const GcGxPokeMode *m);
+uint32_t gc_gx_raster_peek_z(GcGxEfb *efb, uint32_t x, uint32_t y);
+void gc_gx_raster_poke_argb(GcGxEfb *efb, uint32_t x, uint32_t y, uint32_t argb,
+                            const GcGxPokeMode *m, const GcGxGpState *gp);
+void gc_gx_raster_poke_z(GcGxEfb *efb, uint32_t x, uint32_t y, uint32_t z, const GcGxPokeMode *m);
+
+/*
+ * Draw the primitive cmd (GC_GX_CMD_DRAW_FIRST..LAST) from xf. Returns 0 on
+ * allocation failure.
+ */
+int gc_gx_raster_draw(GcGxEfb *efb, const GcGxXfBuf *xf, uint32_t cmd, const GcGxGpState *gp);
+int gc_gx_raster_draw_ref(GcGxEfb *efb, const GcGxXfBuf *xf, uint32_t cmd, const GcGxGpState *gp);
+
+/* Shade every binned triangle. */
+void gc_gx_raster_flush(void);
+
+/* Drop binned triangles, the TEV cache and stats; clear the bounding box. The EFB is kept. */
+void gc_gx_raster_reset(void);
+
+/* End of frame for the tev_states counters. */
+void gc_gx_raster_end_frame(void);
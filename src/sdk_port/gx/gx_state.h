@@ -0,0 +1,34 @@
+/*
+ * sdk_port/gx/gx_state.h --- Dirty-state layer between GX setters and the stream.
+ *
+ * GX setters update their gc_gx_* mirrors immediately (tests assert those),
+ * but BP and XF register *state* is staged here instead of being written to
+ * the command stream right away. Staged registers are flushed at draw time
+ * (GXBegin, GXCallDisplayList), at display list boundaries, at GXFlush, and
+ * before any BP command that consumes state (copy/load/token/draw-done).
+ *
+ * A staged value that equals what the stream already carries is dropped, and
+ * a staged value that is overwritten before the flush is dropped too. Every
+ * dropped write is counted per register so redundant state churn in game
+ * code can be reported.
+ *
+ * Implementation lives in GX.c (it shares the FIFO writer).
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "gx_gp.h"
+
+/* 0 = write-through (every state write hits the stream). Default 1. */
+extern uint32_t gc_gx_state_coalesce;
+
+/* State-class writes seen / dropped since GXInit (or gc_gx_state_reset_counters). */
+extern uint32_t gc_gx_state_writes;
+extern uint32_t gc_gx_state_elim;
+
+/* Dropped writes per BP register id and per XF register (0x1000 + index). */
+extern uint32_t gc_gx_bp_elim[256];
+extern uint32_t gc_gx_xf_elim[GC_GX_XF_REG_COUNT];
+
+void gc_gx_state_reset_counters(void);
@@ -0,0 +1,325 @@
+/*
+ * sdk_port/gx/gx_texcopy.c --- EFB to texture copy encoder.
+ *
+ * See gx_texcopy.h. Output blocks use the same layouts gx_texdec.c reads:
+ *   8x8  4-bit   R4
+ *   8x4  8-bit   R8, RA4, A8, G8, B8
+ *   4x4  16-bit  RA8, RGB565, RGB5A3, RG8, GB8
+ *   4x4  32-bit  RGBA8 (64-byte blocks, AR texels then GB texels)
+ */
+#include <stdint.h>
+#include <string.h>
+#include "gx_texcopy.h"
+#include "../gc_mem.h"
+
+uint32_t gc_gx_texcopy_copies;
+uint32_t gc_gx_texcopy_bytes;
+uint32_t gc_gx_texcopy_pixels;
+
+typedef uint32_t tc_u4 __attribute__((vector_size(16)));
+
+#define TC_W GC_GX_EFB_WIDTH
+#define TC_H GC_GX_EFB_HEIGHT
+
+// Source rectangle clamped to the EFB, last pixel inclusive.
+typedef struct {
+    const uint32_t *buf;
+    uint32_t x0, y0, x1, y1;
+    uint32_t half, depth;
+} TcSrc;
+
+static int tc_block(uint32_t fmt, uint32_t *bw, uint32_t *bh, uint32_t *bits) {
+    switch (fmt) {
+    case GC_GX_CPF_R4:
+        *bw = 8u; *bh = 8u; *bits = 4u; return 1;
+    case GC_GX_CPF_R8_1: case GC_GX_CPF_RA4: case GC_GX_CPF_A8:
+    case GC_GX_CPF_R8: case GC_GX_CPF_G8: case GC_GX_CPF_B8:
+        *bw = 8u; *bh = 4u; *bits = 8u; return 1;
+    case GC_GX_CPF_RA8: case GC_GX_CPF_RGB565: case GC_GX_CPF_RGB5A3:
+    case GC_GX_CPF_RG8: case GC_GX_CPF_GB8:
+        *bw = 4u; *bh = 4u; *bits = 16u; return 1;
+    case GC_GX_CPF_RGBA8:
+        *bw = 4u; *bh = 4u; *bits = 32u; return 1;
+    default:
+        return 0;
+    }
+}
+
+int gc_gx_texcopy_setup(GcGxTexCopy *c, const GcGxGpState *gp) {
+    const uint32_t cp = gp->bp[0x52];
+    uint32_t bw, bh, bits;
+
+    if ((cp >> 14) & 1u) return 0;  // display copy
+    c->x = gp->bp[0x49] & 0x3FFu;
+    c->y = (gp->bp[0x49] >> 10) & 0x3FFu;
+    c->w = (gp->bp[0x4A] & 0x3FFu) + 1u;
+    c->h = ((gp->bp[0x4A] >> 10) & 0x3FFu) + 1u;
+    c->fmt = ((cp >> 4) & 7u) | (((cp >> 3) & 1u) << 3);
+    c->half = (cp >> 9) & 1u;
+    c->depth = (gp->bp[0x43] & 7u) == 3u;
+    c->intensity = !c->depth && ((cp >> 15) & 1u) && c->fmt <= GC_GX_CPF_RA8;
+    // GX_TF_Z16 reaches the PE as 0xB from the SDK; 0x3 is the same copy.
+    if (c->depth && c->fmt == GC_GX_CPF_RA8) c->fmt = GC_GX_CPF_RG8;
+    return tc_block(c->fmt, &bw, &bh, &bits);
+}
+
+void gc_gx_texcopy_dims(const GcGxTexCopy *c, uint32_t *w, uint32_t *h) {
+    *w = c->half ? (c->w + 1u) >> 1 : c->w;
+    *h = c->half ? (c->h + 1u) >> 1 : c->h;
+}
+
+uint32_t gc_gx_texcopy_size(const GcGxTexCopy *c) {
+    uint32_t bw, bh, bits, w, h;
+    if (!tc_block(c->fmt, &bw, &bh, &bits)) return 0;
+    gc_gx_texcopy_dims(c, &w, &h);
+    return ((w + bw - 1u) / bw) * ((h + bh - 1u) / bh) * (bits == 32u ? 64u : 32u);
+}
+
+static int tc_src(TcSrc *s, const GcGxEfb *efb, const GcGxTexCopy *c) {
+    if (c->x >= TC_W || c->y >= TC_H || !c->w || !c->h) return 0;
+    s->buf = c->depth ? efb->depth : efb->color;
+    if (!s->buf) return 0;
+    s->x0 = c->x;
+    s->y0 = c->y;
+    s->x1 = c->x + c->w - 1u < TC_W - 1u ? c->x + c->w - 1u : TC_W - 1u;
+    s->y1 = c->y + c->h - 1u < TC_H - 1u ? c->y + c->h - 1u : TC_H - 1u;
+    s->half = c->half;
+    s->depth = c->depth;
+    return 1;
+}
+
+static inline uint32_t tc_min(uint32_t a, uint32_t b) { return a < b ? a : b; }
+
+// ---- Reference path: one texel at a time ----
+
+static uint32_t tc_fetch_ref(const TcSrc *s, uint32_t x, uint32_t y) {
+    uint32_t p;
+    if (!s->half) {
+        p = s->buf[tc_min(s->y0 + y, s->y1) * TC_W + tc_min(s->x0 + x, s->x1)];
+    } else {
+        const uint32_t xa = tc_min(s->x0 + 2u * x, s->x1), xb = tc_min(s->x0 + 2u * x + 1u, s->x1);
+        const uint32_t ya = tc_min(s->y0 + 2u * y, s->y1), yb = tc_min(s->y0 + 2u * y + 1u, s->y1);
+        const uint32_t q[4] = { s->buf[ya * TC_W + xa], s->buf[ya * TC_W + xb],
+                                s->buf[yb * TC_W + xa], s->buf[yb * TC_W + xb] };
+        uint32_t i, sh;
+        if (s->depth) {
+            p = (q[0] + q[1] + q[2] + q[3] + 2u) >> 2;
+        } else {
+            p = 0;
+            for (sh = 0; sh < 32u; sh += 8u) {
+                uint32_t sum = 2u;
+                for (i = 0; i < 4u; i++) sum += (q[i] >> sh) & 0xFFu;
+                p |= (sum >> 2) << sh;
+            }
+        }
+    }
+    return s->depth ? ((p & 0xFFFFFFu) << 8) | 0xFFu : p;
+}
+
+static uint32_t tc_texel_ref(const GcGxTexCopy *c, uint32_t p) {
+    uint32_t r = p >> 24, g = (p >> 16) & 0xFFu, b = (p >> 8) & 0xFFu, a = p & 0xFFu;
+    if (c->intensity) r = ((66u * r + 129u * g + 25u * b + 128u) >> 8) + 16u;
+    switch (c->fmt) {
+    case GC_GX_CPF_R4: return r >> 4;
+    case GC_GX_CPF_R8_1: case GC_GX_CPF_R8: return r;
+    case GC_GX_CPF_RA4: return (a & 0xF0u) | (r >> 4);
+    case GC_GX_CPF_RA8: return (a << 8) | r;
+    case GC_GX_CPF_RGB565: return ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+    case GC_GX_CPF_RGB5A3:
+        if ((a >> 5) == 7u) return 0x8000u | ((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3);
+        return ((a >> 5) << 12) | ((r >> 4) << 8) | ((g >> 4) << 4) | (b >> 4);
+    case GC_GX_CPF_RGBA8: return (a << 24) | (r << 16) | (g << 8) | b;
+    case GC_GX_CPF_A8: return a;
+    case GC_GX_CPF_G8: return g;
+    case GC_GX_CPF_B8: return b;
+    case GC_GX_CPF_RG8: return (r << 8) | g;
+    case GC_GX_CPF_GB8: return (g << 8) | b;
+    default: return 0;
+    }
+}
+
+int gc_gx_texcopy_encode_ref(uint8_t *dst, const GcGxEfb *efb, const GcGxTexCopy *c) {
+    uint32_t bw, bh, bits, w, h, cols, rows, x, y;
+    TcSrc s;
+
+    if (!tc_block(c->fmt, &bw, &bh, &bits) || !tc_src(&s, efb, c)) return 0;
+    gc_gx_texcopy_dims(c, &w, &h);
+    cols = (w + bw - 1u) / bw;
+    rows = (h + bh - 1u) / bh;
+    for (y = 0; y < rows * bh; y++) {
+        for (x = 0; x < cols * bw; x++) {
+            const uint32_t v = tc_texel_ref(c, tc_fetch_ref(&s, x, y));
+            const uint32_t i = (y % bh) * bw + x % bw;
+            uint8_t *blk = dst + ((y / bh) * cols + x / bw) * (bits == 32u ? 64u : 32u);
+            switch (bits) {
+            case 4u:
+                if (i & 1u) blk[i >> 1] = (uint8_t)((blk[i >> 1] & 0xF0u) | v);
+                else blk[i >> 1] = (uint8_t)((blk[i >> 1] & 0x0Fu) | (v << 4));
+                break;
+            case 8u:
+                blk[i] = (uint8_t)v;
+                break;
+            case 16u:
+                blk[i * 2u] = (uint8_t)(v >> 8);
+                blk[i * 2u + 1u] = (uint8_t)v;
+                break;
+            default:
+                blk[i * 2u] = (uint8_t)(v >> 24);
+                blk[i * 2u + 1u] = (uint8_t)(v >> 16);
+                blk[32u + i * 2u] = (uint8_t)(v >> 8);
+                blk[32u + i * 2u + 1u] = (uint8_t)v;
+                break;
+            }
+        }
+    }
+    return 1;
+}
+
+// ---- Vector path: four texels of one block row at a time ----
+
+static inline tc_u4 tc_ld4(const uint32_t *row, uint32_t x, uint32_t x1, uint32_t step) {
+    tc_u4 v;
+    if (step == 1u && x + 3u <= x1) {
+        memcpy(&v, row + x, sizeof(v));
+    } else {
+        v = (tc_u4){ row[tc_min(x, x1)], row[tc_min(x + step, x1)],
+                     row[tc_min(x + 2u * step, x1)], row[tc_min(x + 3u * step, x1)] };
+    }
+    return v;
+}
+
+static inline tc_u4 tc_fetch4(const TcSrc *s, uint32_t x, uint32_t y) {
+    tc_u4 p;
+    if (!s->half) {
+        p = tc_ld4(s->buf + tc_min(s->y0 + y, s->y1) * TC_W, s->x0 + x, s->x1, 1u);
+    } else {
+        const uint32_t *ra = s->buf + tc_min(s->y0 + 2u * y, s->y1) * TC_W;
+        const uint32_t *rb = s->buf + tc_min(s->y0 + 2u * y + 1u, s->y1) * TC_W;
+        const uint32_t xa = s->x0 + 2u * x;
+        tc_u4 q0, q1, q2, q3;
+        if (xa + 7u <= s->x1) {
+            tc_u4 a0, a1, b0, b1;
+            const tc_u4 even = { 0, 2, 4, 6 }, odd = { 1, 3, 5, 7 };
+            memcpy(&a0, ra + xa, sizeof(a0));
+            memcpy(&a1, ra + xa + 4u, sizeof(a1));
+            memcpy(&b0, rb + xa, sizeof(b0));
+            memcpy(&b1, rb + xa + 4u, sizeof(b1));
+            q0 = __builtin_shuffle(a0, a1, even);
+            q1 = __builtin_shuffle(a0, a1, odd);
+            q2 = __builtin_shuffle(b0, b1, even);
+            q3 = __builtin_shuffle(b0, b1, odd);
+        } else {
+            q0 = tc_ld4(ra, xa, s->x1, 2u);
+            q1 = tc_ld4(ra, xa + 1u, s->x1, 2u);
+            q2 = tc_ld4(rb, xa, s->x1, 2u);
+            q3 = tc_ld4(rb, xa + 1u, s->x1, 2u);
+        }
+        if (s->depth) {
+            p = (q0 + q1 + q2 + q3 + 2u) >> 2;
+        } else {
+            // Two 8-bit channels per 16-bit lane half; sums stay below 0x400.
+            const uint32_t m = 0x00FF00FFu;
+            const tc_u4 lo = (q0 & m) + (q1 & m) + (q2 & m) + (q3 & m) + 0x00020002u;
+            const tc_u4 hi = ((q0 >> 8) & m) + ((q1 >> 8) & m) + ((q2 >> 8) & m) +
+                             ((q3 >> 8) & m) + 0x00020002u;
+            p = ((lo >> 2) & m) | (((hi >> 2) & m) << 8);
+        }
+    }
+    return s->depth ? ((p & 0xFFFFFFu) << 8) | 0xFFu : p;
+}
+
+static inline tc_u4 tc_texel4(const GcGxTexCopy *c, tc_u4 p) {
+    tc_u4 r = p >> 24;
+    const tc_u4 g = (p >> 16) & 0xFFu, b = (p >> 8) & 0xFFu, a = p & 0xFFu;
+    if (c->intensity) r = ((66u * r + 129u * g + 25u * b + 128u) >> 8) + 16u;
+    switch (c->fmt) {
+    case GC_GX_CPF_R4: return r >> 4;
+    case GC_GX_CPF_R8_1: case GC_GX_CPF_R8: return r;
+    case GC_GX_CPF_RA4: return (a & 0xF0u) | (r >> 4);
+    case GC_GX_CPF_RA8: return (a << 8) | r;
+    case GC_GX_CPF_RGB565: return ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+    case GC_GX_CPF_RGB5A3: {
+        const tc_u4 opaque = (tc_u4)((a >> 5) == 7u);
+        const tc_u4 v1 = 0x8000u | ((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3);
+        const tc_u4 v0 = ((a >> 5) << 12) | ((r >> 4) << 8) | ((g >> 4) << 4) | (b >> 4);
+        return (v1 & opaque) | (v0 & ~opaque);
+    }
+    case GC_GX_CPF_RGBA8: return (a << 24) | (r << 16) | (g << 8) | b;
+    case GC_GX_CPF_A8: return a;
+    case GC_GX_CPF_G8: return g;
+    case GC_GX_CPF_B8: return b;
+    case GC_GX_CPF_RG8: return (r << 8) | g;
+    case GC_GX_CPF_GB8: return (g << 8) | b;
+    default: return (tc_u4){ 0, 0, 0, 0 };
+    }
+}
+
+// Four big-endian 16-bit texels from the low halves of v.
+static inline void tc_st16x4(uint8_t *d, tc_u4 v) {
+    d[0] = (uint8_t)(v[0] >> 8); d[1] = (uint8_t)v[0];
+    d[2] = (uint8_t)(v[1] >> 8); d[3] = (uint8_t)v[1];
+    d[4] = (uint8_t)(v[2] >> 8); d[5] = (uint8_t)v[2];
+    d[6] = (uint8_t)(v[3] >> 8); d[7] = (uint8_t)v[3];
+}
+
+int gc_gx_texcopy_encode(uint8_t *dst, const GcGxEfb *efb, const GcGxTexCopy *c) {
+    uint32_t bw, bh, bits, w, h, cols, rows, bx, by, ly, lx;
+    uint32_t bytes;
+    TcSrc s;
+
+    if (!tc_block(c->fmt, &bw, &bh, &bits) || !tc_src(&s, efb, c)) return 0;
+    gc_gx_texcopy_dims(c, &w, &h);
+    cols = (w + bw - 1u) / bw;
+    rows = (h + bh - 1u) / bh;
+    bytes = bits == 32u ? 64u : 32u;
+    for (by = 0; by < rows; by++) {
+        for (bx = 0; bx < cols; bx++, dst += bytes) {
+            for (ly = 0; ly < bh; ly++) {
+                for (lx = 0; lx < bw; lx += 4u) {
+                    const tc_u4 v = tc_texel4(c, tc_fetch4(&s, bx * bw + lx, by * bh + ly));
+                    uint8_t *d;
+                    switch (bits) {
+                    case 4u:
+                        d = dst + ly * 4u + (lx >> 1);
+                        d[0] = (uint8_t)((v[0] << 4) | v[1]);
+                        d[1] = (uint8_t)((v[2] << 4) | v[3]);
+                        break;
+                    case 8u:
+                        d = dst + ly * 8u + lx;
+                        d[0] = (uint8_t)v[0]; d[1] = (uint8_t)v[1];
+                        d[2] = (uint8_t)v[2]; d[3] = (uint8_t)v[3];
+                        break;
+                    case 16u:
+                        d = dst + ly * 8u;
+                        tc_st16x4(d, v);
+                        break;
+                    default:
+                        d = dst + ly * 8u;
+                        tc_st16x4(d, v >> 16);
+                        tc_st16x4(d + 32u, v);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return 1;
+}
+
+void gc_gx_texcopy_run(GcGxEfb *efb, const GcGxGpState *gp) {
+    GcGxTexCopy c;
+    uint32_t addr, size;
+    uint8_t *dst;
+
+    // Nothing has been drawn if the EFB was never allocated (see copy_clear).
+    if (!efb->color || !gc_gx_texcopy_setup(&c, gp)) return;
+    addr = ((gp->bp[0x4B] & 0x1FFFFFu) << 5) | 0x80000000u;
+    size = gc_gx_texcopy_size(&c);
+    dst = gc_mem_ptr(addr, size);
+    if (!dst || !gc_gx_texcopy_encode(dst, efb, &c)) return;
+    gc_gx_texcopy_copies++;
+    gc_gx_texcopy_bytes += size;
+    gc_gx_texcopy_pixels += c.w * c.h;
+    if (gc_gx_gp_mem_hook) gc_gx_gp_mem_hook(addr, size, 1);
+    gc_mem_notify_write(addr, size);
+}
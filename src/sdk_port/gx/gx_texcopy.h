@@ -0,0 +1,72 @@
+/*
+ * sdk_port/gx/gx_texcopy.h --- EFB to texture copy encoder (GXCopyTex).
+ *
+ * BP 0x52 with bit 14 clear copies the EFB rectangle in BP 0x49/0x4A to
+ * the RAM address in BP 0x4B, encoded as a tiled GX texture. The copy
+ * format is cpTex bits 3..6 (bit 3 is format bit 3, bits 4..6 format bits
+ * 0..2); bit 9 selects the 2x2 box filter (half-size output, used for mip
+ * levels) and bit 15 converts R/RA formats to intensity (BT.601 Y).
+ *
+ * While the PE pixel format (BP 0x43 bits 0..2) is Z24 the copy reads the
+ * depth buffer instead. Depth is copied as a color with r = z[23:16],
+ * g = z[15:8], b = z[7:0] and a = 0xFF, so GX_CTF_Z4/Z8 are R4/R8,
+ * Z8M/Z8L are G8/B8, Z16 is RG8, Z16L is GB8 and Z24X8 is RGBA8.
+ *
+ * The destination row pitch is derived from the copy width and format
+ * block size; it is what GXSetTexCopyDst programs into BP 0x4D for SDK
+ * callers, and does not depend on the port's GX_CTF_* numbering.
+ *
+ * gc_gx_texcopy_encode converts four texels per vector operation and writes
+ * whole block rows; gc_gx_texcopy_encode_ref converts and stores one texel
+ * at a time and is the test oracle.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "gx_raster.h"
+
+/* Copy formats (cpTex bits 3..6 reassembled). */
+#define GC_GX_CPF_R4     0x0u   /* I4 with intensity; Z4 from depth */
+#define GC_GX_CPF_R8_1   0x1u   /* I8 with intensity; Z8 from depth */
+#define GC_GX_CPF_RA4    0x2u   /* IA4 with intensity */
+#define GC_GX_CPF_RA8    0x3u   /* IA8 with intensity; Z16 from depth */
+#define GC_GX_CPF_RGB565 0x4u
+#define GC_GX_CPF_RGB5A3 0x5u
+#define GC_GX_CPF_RGBA8  0x6u   /* Z24X8 from depth */
+#define GC_GX_CPF_A8     0x7u
+#define GC_GX_CPF_R8     0x8u
+#define GC_GX_CPF_G8     0x9u   /* Z8M from depth */
+#define GC_GX_CPF_B8     0xAu   /* Z8L from depth */
+#define GC_GX_CPF_RG8    0xBu   /* Z16 from depth */
+#define GC_GX_CPF_GB8    0xCu   /* Z16L from depth */
+
+typedef struct {
+    uint32_t x, y, w, h;    /* source rectangle in EFB pixels */
+    uint32_t fmt;           /* GC_GX_CPF_* */
+    uint32_t intensity;     /* R/RA formats store Y instead of R */
+    uint32_t depth;         /* read the depth buffer */
+    uint32_t half;          /* 2x2 box filter; output is ceil(w/2) x ceil(h/2) */
+} GcGxTexCopy;
+
+/* Copies executed by gc_gx_texcopy_run, bytes written to RAM and EFB pixels read. */
+extern uint32_t gc_gx_texcopy_copies;
+extern uint32_t gc_gx_texcopy_bytes;
+extern uint32_t gc_gx_texcopy_pixels;
+
+/* Decode the copy registers. Returns 0 for display copies or unknown formats. */
+int gc_gx_texcopy_setup(GcGxTexCopy *c, const GcGxGpState *gp);
+
+/* Output texture size and the bytes it occupies (whole blocks). 0 if unknown. */
+void gc_gx_texcopy_dims(const GcGxTexCopy *c, uint32_t *w, uint32_t *h);
+uint32_t gc_gx_texcopy_size(const GcGxTexCopy *c);
+
+/*
+ * Encode the copy into dst (gc_gx_texcopy_size bytes). Source pixels
+ * outside the rectangle or the EFB are clamped to its edge. Returns 0 if
+ * the rectangle starts outside the EFB or the format is unknown.
+ */
+int gc_gx_texcopy_encode(uint8_t *dst, const GcGxEfb *efb, const GcGxTexCopy *c);
+int gc_gx_texcopy_encode_ref(uint8_t *dst, const GcGxEfb *efb, const GcGxTexCopy *c);
+
+/* BP 0x52: encode into RAM and report the write through gc_mem_notify_write. */
+void gc_gx_texcopy_run(GcGxEfb *efb, const GcGxGpState *gp);
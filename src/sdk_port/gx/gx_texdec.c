@@ -0,0 +1,584 @@
+/*
+ * sdk_port/gx/gx_texdec.c --- Texture decoder and decoded-texture cache.
+ *
+ * See gx_texdec.h. Images are rows of blocks; each block is 32 bytes
+ * (RGBA8: 64, AR texels then GB texels) and covers
+ *   8x8  I4, C4, CMPR (four 4x4 DXT1-style sub-blocks, Z order)
+ *   8x4  I8, IA4, C8
+ *   4x4  IA8, RGB565, RGB5A3, RGBA8, C14X2
+ * Partial blocks at the right and bottom edges are stored in full.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gx_texdec.h"
+#include "../gc_mem.h"
+
+uint32_t gc_gx_texdec_hits;
+uint32_t gc_gx_texdec_misses;
+uint32_t gc_gx_texdec_revalidations;
+uint32_t gc_gx_texdec_invalidations;
+uint32_t gc_gx_texdec_evictions;
+
+uint32_t gc_gx_texdec_cache_enable = 1;
+uint32_t gc_gx_texdec_cache_verify;
+
+void (*gc_gx_texdec_release_hook)(void);
+
+// Decoded bytes the cache keeps before it evicts even with free slots.
+#define TD_CACHE_BUDGET (64u << 20)
+
+typedef uint32_t td_u4 __attribute__((vector_size(16)));
+
+typedef struct {
+    uint32_t addr;
+    uint32_t w, h, fmt;
+    uint32_t tlut_reg;
+    uint32_t size;          // image bytes in RAM
+    uint32_t hash;
+    uint32_t tlut_hash;
+    uint32_t tlut_gen;
+    uint32_t lru;
+    uint8_t valid;
+    uint8_t stale;
+    uint32_t *texels;
+} TdEntry;
+
+static TdEntry s_td_entries[GC_GX_TEXDEC_CACHE_ENTRIES];
+static uint32_t s_td_lru_tick;
+static uint32_t s_td_bytes;
+static int s_td_hook_registered;
+
+// TLUT half of TMEM, plus room for a C14X2 lookup past the last offset.
+static uint8_t s_td_tmem[GC_GX_TEXDEC_TLUT_BYTES + 0x8000u];
+static uint32_t s_td_tlut_gen = 1;
+
+static inline uint32_t td_rd16be(const uint8_t *p) {
+    return ((uint32_t)p[0] << 8) | (uint32_t)p[1];
+}
+
+// FNV-1a, same constants as GX.c:hash_bytes.
+static uint32_t td_hash(const uint8_t *p, uint32_t n) {
+    uint32_t h = 2166136261u;
+    uint32_t i;
+    for (i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static int td_block(uint32_t fmt, uint32_t *bw, uint32_t *bh, uint32_t *bytes) {
+    *bytes = 32u;
+    switch (fmt) {
+    case GC_GX_TF_I4: case GC_GX_TF_C4: case GC_GX_TF_CMPR:
+        *bw = 8u; *bh = 8u; return 1;
+    case GC_GX_TF_I8: case GC_GX_TF_IA4: case GC_GX_TF_C8:
+        *bw = 8u; *bh = 4u; return 1;
+    case GC_GX_TF_IA8: case GC_GX_TF_RGB565: case GC_GX_TF_RGB5A3: case GC_GX_TF_C14X2:
+        *bw = 4u; *bh = 4u; return 1;
+    case GC_GX_TF_RGBA8:
+        *bw = 4u; *bh = 4u; *bytes = 64u; return 1;
+    default:
+        return 0;
+    }
+}
+
+// Index bits of a CI format, 0 for direct formats.
+static inline uint32_t td_ci_bits(uint32_t fmt) {
+    switch (fmt) {
+    case GC_GX_TF_C4: return 4u;
+    case GC_GX_TF_C8: return 8u;
+    case GC_GX_TF_C14X2: return 14u;
+    default: return 0u;
+    }
+}
+
+uint32_t gc_gx_texdec_size(uint32_t w, uint32_t h, uint32_t fmt) {
+    uint32_t bw, bh, bytes;
+    if (!td_block(fmt, &bw, &bh, &bytes)) return 0;
+    if (w == 0 || h == 0 || w > GC_GX_TEXDEC_MAX_DIM || h > GC_GX_TEXDEC_MAX_DIM) return 0;
+    return ((w + bw - 1u) / bw) * ((h + bh - 1u) / bh) * bytes;
+}
+
+// ---- Scalar texel conversions (reference path and palettes) ----
+
+static inline uint32_t td_rgba(uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+    return (r << 24) | (g << 16) | (b << 8) | a;
+}
+
+static inline uint32_t td_x5(uint32_t v) { return (v << 3) | (v >> 2); }
+static inline uint32_t td_x6(uint32_t v) { return (v << 2) | (v >> 4); }
+
+static uint32_t td_rgb565(uint32_t v) {
+    return td_rgba(td_x5((v >> 11) & 31u), td_x6((v >> 5) & 63u), td_x5(v & 31u), 255u);
+}
+
+static uint32_t td_rgb5a3(uint32_t v) {
+    uint32_t a;
+    if (v & 0x8000u) {
+        return td_rgba(td_x5((v >> 10) & 31u), td_x5((v >> 5) & 31u), td_x5(v & 31u), 255u);
+    }
+    a = (v >> 12) & 7u;
+    return td_rgba(((v >> 8) & 15u) * 0x11u, ((v >> 4) & 15u) * 0x11u, (v & 15u) * 0x11u,
+                   (a << 5) | (a << 2) | (a >> 1));
+}
+
+static uint32_t td_ia8(uint32_t v) {
+    return (v & 0xFFu) * 0x01010100u | (v >> 8);
+}
+
+static uint32_t td_tlut_entry(uint32_t v, uint32_t tlut_fmt) {
+    switch (tlut_fmt) {
+    case GC_GX_TL_RGB565: return td_rgb565(v);
+    case GC_GX_TL_RGB5A3: return td_rgb5a3(v);
+    default: return td_ia8(v);
+    }
+}
+
+// CMPR sub-block palette: two 565 endpoints, then either two 3/8-5/8
+// blends (c0 > c1) or their average and a transparent entry.
+static void td_cmpr_palette(const uint8_t *sub, uint32_t pal[4]) {
+    const uint32_t c0 = td_rd16be(sub), c1 = td_rd16be(sub + 2);
+    const uint32_t r0 = td_x5(c0 >> 11), g0 = td_x6((c0 >> 5) & 63u), b0 = td_x5(c0 & 31u);
+    const uint32_t r1 = td_x5(c1 >> 11), g1 = td_x6((c1 >> 5) & 63u), b1 = td_x5(c1 & 31u);
+    pal[0] = td_rgba(r0, g0, b0, 255u);
+    pal[1] = td_rgba(r1, g1, b1, 255u);
+    if (c0 > c1) {
+        pal[2] = td_rgba((r1 * 3u + r0 * 5u) >> 3, (g1 * 3u + g0 * 5u) >> 3,
+                         (b1 * 3u + b0 * 5u) >> 3, 255u);
+        pal[3] = td_rgba((r0 * 3u + r1 * 5u) >> 3, (g0 * 3u + g1 * 5u) >> 3,
+                         (b0 * 3u + b1 * 5u) >> 3, 255u);
+    } else {
+        pal[2] = td_rgba((r0 + r1) >> 1, (g0 + g1) >> 1, (b0 + b1) >> 1, 255u);
+        pal[3] = pal[2] & 0xFFFFFF00u;
+    }
+}
+
+// ---- Reference: one texel at a time from its tiled address ----
+
+static uint32_t td_texel_ref(const uint8_t *src, uint32_t w, uint32_t x, uint32_t y,
+                             uint32_t fmt, const uint8_t *tlut, uint32_t tlut_fmt) {
+    uint32_t bw, bh, bytes;
+    const uint8_t *blk;
+    uint32_t lx, ly, v, pal[4];
+
+    td_block(fmt, &bw, &bh, &bytes);
+    blk = src + ((y / bh) * ((w + bw - 1u) / bw) + x / bw) * bytes;
+    lx = x % bw;
+    ly = y % bh;
+    switch (fmt) {
+    case GC_GX_TF_I4:
+        v = (blk[ly * 4u + lx / 2u] >> ((lx & 1u) ? 0u : 4u)) & 15u;
+        return v * 0x11u * 0x01010101u;
+    case GC_GX_TF_I8:
+        return blk[ly * 8u + lx] * 0x01010101u;
+    case GC_GX_TF_IA4:
+        v = blk[ly * 8u + lx];
+        return (v & 15u) * 0x11u * 0x01010100u | (v >> 4) * 0x11u;
+    case GC_GX_TF_IA8:
+        return td_ia8(td_rd16be(blk + (ly * 4u + lx) * 2u));
+    case GC_GX_TF_RGB565:
+        return td_rgb565(td_rd16be(blk + (ly * 4u + lx) * 2u));
+    case GC_GX_TF_RGB5A3:
+        return td_rgb5a3(td_rd16be(blk + (ly * 4u + lx) * 2u));
+    case GC_GX_TF_RGBA8:
+        v = (ly * 4u + lx) * 2u;
+        return td_rgba(blk[v + 1u], blk[32u + v], blk[33u + v], blk[v]);
+    case GC_GX_TF_C4:
+        v = (blk[ly * 4u + lx / 2u] >> ((lx & 1u) ? 0u : 4u)) & 15u;
+        return td_tlut_entry(td_rd16be(tlut + v * 2u), tlut_fmt);
+    case GC_GX_TF_C8:
+        v = blk[ly * 8u + lx];
+        return td_tlut_entry(td_rd16be(tlut + v * 2u), tlut_fmt);
+    case GC_GX_TF_C14X2:
+        v = td_rd16be(blk + (ly * 4u + lx) * 2u) & 0x3FFFu;
+        return td_tlut_entry(td_rd16be(tlut + v * 2u), tlut_fmt);
+    case GC_GX_TF_CMPR: {
+        const uint8_t *sub = blk + ((ly / 4u) * 2u + lx / 4u) * 8u;
+        td_cmpr_palette(sub, pal);
+        return pal[(sub[4u + ly % 4u] >> (6u - 2u * (lx % 4u))) & 3u];
+    }
+    default:
+        return 0;
+    }
+}
+
+int gc_gx_texdec_decode_ref(uint32_t *dst, const uint8_t *src, uint32_t w, uint32_t h,
+                            uint32_t fmt, const uint8_t *tlut, uint32_t tlut_fmt) {
+    uint32_t x, y;
+    if (!gc_gx_texdec_size(w, h, fmt)) return 0;
+    if (td_ci_bits(fmt) && !tlut) return 0;
+    for (y = 0; y < h; y++) {
+        for (x = 0; x < w; x++) dst[y * w + x] = td_texel_ref(src, w, x, y, fmt, tlut, tlut_fmt);
+    }
+    return 1;
+}
+
+// ---- Vector decoder: four texels per operation, one block at a time ----
+
+typedef void (*TdBlockFn)(const uint8_t *blk, uint32_t *d, uint32_t pitch, const uint32_t *pal);
+
+static inline void td_st4(uint32_t *d, td_u4 v) { memcpy(d, &v, sizeof(v)); }
+
+static inline td_u4 td_ld8x4(const uint8_t *p) {
+    return (td_u4){ p[0], p[1], p[2], p[3] };
+}
+
+static inline td_u4 td_ld16x4(const uint8_t *p) {
+    return (td_u4){ td_rd16be(p), td_rd16be(p + 2), td_rd16be(p + 4), td_rd16be(p + 6) };
+}
+
+// Four 4-bit texels from two bytes, high nibble first.
+static inline td_u4 td_nib4(const uint8_t *p) {
+    const td_u4 v = { p[0], p[0], p[1], p[1] };
+    return (v >> (td_u4){ 4, 0, 4, 0 }) & 15u;
+}
+
+static inline td_u4 td_vx5(td_u4 v) { return (v << 3) | (v >> 2); }
+
+static inline td_u4 td_v565(td_u4 v) {
+    const td_u4 g = (v >> 5) & 63u;
+    return td_vx5(v >> 11) << 24 | ((g << 2) | (g >> 4)) << 16 | td_vx5(v & 31u) << 8 | 255u;
+}
+
+static inline td_u4 td_v5a3(td_u4 v) {
+    const td_u4 m = (td_u4)((v & 0x8000u) != 0u);
+    const td_u4 a = (v >> 12) & 7u;
+    const td_u4 opaque = td_vx5((v >> 10) & 31u) << 24 | td_vx5((v >> 5) & 31u) << 16 |
+                         td_vx5(v & 31u) << 8 | 255u;
+    const td_u4 trans = ((v >> 8) & 15u) * 0x11000000u | ((v >> 4) & 15u) * 0x110000u |
+                        (v & 15u) * 0x1100u | (a << 5) | (a << 2) | (a >> 1);
+    return (opaque & m) | (trans & ~m);
+}
+
+static inline td_u4 td_gather(const uint32_t *pal, td_u4 i) {
+    return (td_u4){ pal[i[0]], pal[i[1]], pal[i[2]], pal[i[3]] };
+}
+
+static void td_blk_i4(const uint8_t *blk, uint32_t *d, uint32_t pitch, const uint32_t *pal) {
+    uint32_t y;
+    (void)pal;
+    for (y = 0; y < 8u; y++, blk += 4, d += pitch) {
+        td_st4(d, td_nib4(blk) * 0x11111111u);
+        td_st4(d + 4, td_nib4(blk + 2) * 0x11111111u);
+    }
+}
+
+static void td_blk_i8(const uint8_t *blk, uint32_t *d, uint32_t pitch, const uint32_t *pal) {
+    uint32_t y;
+    (void)pal;
+    for (y = 0; y < 4u; y++, blk += 8, d += pitch) {
+        td_st4(d, td_ld8x4(blk) * 0x01010101u);
+        td_st4(d + 4, td_ld8x4(blk + 4) * 0x01010101u);
+    }
+}
+
+static void td_blk_ia4(const uint8_t *blk, uint32_t *d, uint32_t pitch, const uint32_t *pal) {
+    uint32_t y, k;
+    (void)pal;
+    for (y = 0; y < 4u; y++, blk += 8, d += pitch) {
+        for (k = 0; k < 8u; k += 4u) {
+            const td_u4 v = td_ld8x4(blk + k);
+            td_st4(d + k, (v & 15u) * 0x11111100u | (v >> 4) * 0x11u);
+        }
+    }
+}
+
+static void td_blk_ia8(const uint8_t *blk, uint32_t *d, uint32_t pitch, const uint32_t *pal) {
+    uint32_t y;
+    (void)pal;
+    for (y = 0; y < 4u; y++, blk += 8, d += pitch) {
+        const td_u4 v = td_ld16x4(blk);
+        td_st4(d, (v & 255u) * 0x01010100u | (v >> 8));
+    }
+}
+
+static void td_blk_rgb565(const uint8_t *blk, uint32_t *d, uint32_t pitch, const uint32_t *pal) {
+    uint32_t y;
+    (void)pal;
+    for (y = 0; y < 4u; y++, blk += 8, d += pitch) td_st4(d, td_v565(td_ld16x4(blk)));
+}
+
+static void td_blk_rgb5a3(const uint8_t *blk, uint32_t *d, uint32_t pitch, const uint32_t *pal) {
+    uint32_t y;
+    (void)pal;
+    for (y = 0; y < 4u; y++, blk += 8, d += pitch) td_st4(d, td_v5a3(td_ld16x4(blk)));
+}
+
+static void td_blk_rgba8(const uint8_t *blk, uint32_t *d, uint32_t pitch, const uint32_t *pal) {
+    uint32_t y;
+    (void)pal;
+    for (y = 0; y < 4u; y++, blk += 8, d += pitch) {
+        const td_u4 ar = td_ld16x4(blk), gb = td_ld16x4(blk + 32);
+        td_st4(d, (ar & 255u) << 24 | gb << 8 | (ar >> 8));
+    }
+}
+
+static void td_blk_c4(const uint8_t *blk, uint32_t *d, uint32_t pitch, const uint32_t *pal) {
+    uint32_t y;
+    for (y = 0; y < 8u; y++, blk += 4, d += pitch) {
+        td_st4(d, td_gather(pal, td_nib4(blk)));
+        td_st4(d + 4, td_gather(pal, td_nib4(blk + 2)));
+    }
+}
+
+static void td_blk_c8(const uint8_t *blk, uint32_t *d, uint32_t pitch, const uint32_t *pal) {
+    uint32_t y;
+    for (y = 0; y < 4u; y++, blk += 8, d += pitch) {
+        td_st4(d, td_gather(pal, td_ld8x4(blk)));
+        td_st4(d + 4, td_gather(pal, td_ld8x4(blk + 4)));
+    }
+}
+
+static void td_blk_c14x2(const uint8_t *blk, uint32_t *d, uint32_t pitch, const uint32_t *pal) {
+    uint32_t y;
+    for (y = 0; y < 4u; y++, blk += 8, d += pitch) {
+        td_st4(d, td_gather(pal, td_ld16x4(blk) & 0x3FFFu));
+    }
+}
+
+static void td_blk_cmpr(const uint8_t *blk, uint32_t *d, uint32_t pitch, const uint32_t *unused) {
+    static const td_u4 k_shift = { 6, 4, 2, 0 };
+    uint32_t sb, y, pal[4];
+    (void)unused;
+    for (sb = 0; sb < 4u; sb++, blk += 8) {
+        uint32_t *o = d + (sb >> 1) * 4u * pitch + (sb & 1u) * 4u;
+        td_cmpr_palette(blk, pal);
+        for (y = 0; y < 4u; y++, o += pitch) {
+            const td_u4 idx = ((td_u4){ blk[4 + y], blk[4 + y], blk[4 + y], blk[4 + y] } >> k_shift) & 3u;
+            td_st4(o, td_gather(pal, idx));
+        }
+    }
+}
+
+static TdBlockFn td_block_fn(uint32_t fmt) {
+    switch (fmt) {
+    case GC_GX_TF_I4: return td_blk_i4;
+    case GC_GX_TF_I8: return td_blk_i8;
+    case GC_GX_TF_IA4: return td_blk_ia4;
+    case GC_GX_TF_IA8: return td_blk_ia8;
+    case GC_GX_TF_RGB565: return td_blk_rgb565;
+    case GC_GX_TF_RGB5A3: return td_blk_rgb5a3;
+    case GC_GX_TF_RGBA8: return td_blk_rgba8;
+    case GC_GX_TF_C4: return td_blk_c4;
+    case GC_GX_TF_C8: return td_blk_c8;
+    case GC_GX_TF_C14X2: return td_blk_c14x2;
+    case GC_GX_TF_CMPR: return td_blk_cmpr;
+    default: return 0;
+    }
+}
+
+int gc_gx_texdec_decode(uint32_t *dst, const uint8_t *src, uint32_t w, uint32_t h,
+                        uint32_t fmt, const uint8_t *tlut, uint32_t tlut_fmt) {
+    uint32_t bw, bh, bytes, bxn, byn, pw, ph, bx, by, i, npal;
+    uint32_t pal_small[256];
+    uint32_t *pal = pal_small;
+    uint32_t *out = dst;
+    TdBlockFn fn = td_block_fn(fmt);
+
+    if (!fn || !gc_gx_texdec_size(w, h, fmt)) return 0;
+    td_block(fmt, &bw, &bh, &bytes);
+    bxn = (w + bw - 1u) / bw;
+    byn = (h + bh - 1u) / bh;
+    pw = bxn * bw;
+    ph = byn * bh;
+
+    npal = td_ci_bits(fmt) ? 1u << td_ci_bits(fmt) : 0u;
+    if (npal) {
+        if (!tlut) return 0;
+        if (npal > 256u) {
+            pal = (uint32_t *)malloc(npal * sizeof(*pal));
+            if (!pal) return 0;
+        }
+        for (i = 0; i < npal; i++) pal[i] = td_tlut_entry(td_rd16be(tlut + i * 2u), tlut_fmt);
+    }
+    // Edge blocks are decoded whole, so unaligned images go through a padded copy.
+    if (pw != w || ph != h) {
+        out = (uint32_t *)malloc((size_t)pw * ph * sizeof(*out));
+        if (!out) {
+            if (pal != pal_small) free(pal);
+            return 0;
+        }
+    }
+
+    for (by = 0; by < byn; by++) {
+        for (bx = 0; bx < bxn; bx++, src += bytes) fn(src, out + by * bh * pw + bx * bw, pw, pal);
+    }
+
+    if (out != dst) {
+        for (i = 0; i < h; i++) memcpy(dst + i * w, out + i * pw, w * sizeof(*dst));
+        free(out);
+    }
+    if (pal != pal_small) free(pal);
+    return 1;
+}
+
+// ---- TMEM TLUTs ----
+
+void gc_gx_texdec_load_tlut(uint32_t ram_addr, uint32_t tmem_offset, uint32_t count) {
+    const uint32_t off = (tmem_offset & 0x3FFu) << 9;
+    uint32_t len = count * 32u;
+    const uint8_t *src;
+
+    if (len > GC_GX_TEXDEC_TLUT_BYTES - off) len = GC_GX_TEXDEC_TLUT_BYTES - off;
+    src = gc_mem_ptr(ram_addr | 0x80000000u, len);
+    if (!src || len == 0) return;
+    memcpy(s_td_tmem + off, src, len);
+    s_td_tlut_gen++;
+}
+
+const uint8_t *gc_gx_texdec_tlut(uint32_t tmem_offset) {
+    return s_td_tmem + ((tmem_offset & 0x3FFu) << 9);
+}
+
+// ---- Cache ----
+
+static void td_release(void) {
+    if (gc_gx_texdec_release_hook) gc_gx_texdec_release_hook();
+}
+
+static void td_entry_free(TdEntry *e) {
+    if (e->texels) s_td_bytes -= e->w * e->h * 4u;
+    free(e->texels);
+    memset(e, 0, sizeof(*e));
+}
+
+void gc_gx_texdec_cache_reset(void) {
+    uint32_t i;
+    td_release();
+    for (i = 0; i < GC_GX_TEXDEC_CACHE_ENTRIES; i++) td_entry_free(&s_td_entries[i]);
+    s_td_lru_tick = 0;
+    s_td_bytes = 0;
+    gc_gx_texdec_hits = 0;
+    gc_gx_texdec_misses = 0;
+    gc_gx_texdec_revalidations = 0;
+    gc_gx_texdec_invalidations = 0;
+    gc_gx_texdec_evictions = 0;
+}
+
+void gc_gx_texdec_invalidate_range(uint32_t addr, size_t len) {
+    const uint64_t lo = addr;
+    const uint64_t hi = (uint64_t)addr + len;
+    uint32_t i;
+    for (i = 0; i < GC_GX_TEXDEC_CACHE_ENTRIES; i++) {
+        TdEntry *e = &s_td_entries[i];
+        if (!e->valid || e->stale) continue;
+        if ((uint64_t)e->addr < hi && lo < (uint64_t)e->addr + e->size) {
+            e->stale = 1;
+            gc_gx_texdec_invalidations++;
+        }
+    }
+}
+
+static TdEntry *td_find(uint32_t addr, uint32_t w, uint32_t h, uint32_t fmt, uint32_t tlut_reg) {
+    uint32_t i;
+    for (i = 0; i < GC_GX_TEXDEC_CACHE_ENTRIES; i++) {
+        TdEntry *e = &s_td_entries[i];
+        if (e->valid && e->addr == addr && e->w == w && e->h == h && e->fmt == fmt &&
+            e->tlut_reg == tlut_reg) {
+            return e;
+        }
+    }
+    return 0;
+}
+
+static TdEntry *td_lru(void) {
+    TdEntry *victim = 0;
+    uint32_t i;
+    for (i = 0; i < GC_GX_TEXDEC_CACHE_ENTRIES; i++) {
+        TdEntry *e = &s_td_entries[i];
+        if (e->valid && (!victim || e->lru < victim->lru)) victim = e;
+    }
+    return victim;
+}
+
+// A free slot for `need` decoded bytes, evicting LRU entries for slots or budget.
+static TdEntry *td_alloc(uint32_t need) {
+    TdEntry *slot = 0;
+    uint32_t i;
+    for (i = 0; i < GC_GX_TEXDEC_CACHE_ENTRIES && !slot; i++) {
+        if (!s_td_entries[i].valid) slot = &s_td_entries[i];
+    }
+    if (slot && s_td_bytes + need <= TD_CACHE_BUDGET) return slot;
+
+    td_release();
+    while (!slot || (s_td_bytes + need > TD_CACHE_BUDGET && s_td_bytes)) {
+        TdEntry *victim = td_lru();
+        if (!victim) break;
+        gc_gx_texdec_evictions++;
+        td_entry_free(victim);
+        if (!slot) slot = victim;
+    }
+    return slot;
+}
+
+const uint32_t *gc_gx_texdec_get(uint32_t addr, uint32_t w, uint32_t h, uint32_t fmt,
+                                 uint32_t tlut_reg) {
+    const uint32_t size = gc_gx_texdec_size(w, h, fmt);
+    const uint32_t ci_bits = td_ci_bits(fmt);
+    const uint8_t *src = size ? gc_mem_ptr(addr, size) : 0;
+    const uint8_t *tlut = 0;
+    uint32_t tlut_bytes = 0, tlut_hash = 0, hash;
+    TdEntry *e;
+
+    if (!src) return 0;
+    if (!s_td_hook_registered) {
+        s_td_hook_registered = gc_mem_add_write_hook(gc_gx_texdec_invalidate_range) == 0;
+    }
+    tlut_reg = ci_bits ? tlut_reg & 0xFFFu : 0u;
+    if (ci_bits) {
+        tlut = gc_gx_texdec_tlut(tlut_reg);
+        tlut_bytes = 2u << ci_bits;
+    }
+
+    e = td_find(addr, w, h, fmt, tlut_reg);
+    if (e && gc_gx_texdec_cache_enable) {
+        int ok = 1;
+        const int rehash = e->stale || gc_gx_texdec_cache_verify;
+        if (rehash && td_hash(src, size) != e->hash) ok = 0;
+        if (ok && ci_bits && e->tlut_gen != s_td_tlut_gen) {
+            // A TLUT load happened somewhere; only a change to ours matters.
+            if (td_hash(tlut, tlut_bytes) != e->tlut_hash) ok = 0;
+            else e->tlut_gen = s_td_tlut_gen;
+        }
+        if (ok) {
+            if (e->stale) gc_gx_texdec_revalidations++;
+            else gc_gx_texdec_hits++;
+            e->stale = 0;
+            e->lru = ++s_td_lru_tick;
+            return e->texels;
+        }
+    }
+    gc_gx_texdec_misses++;
+
+    hash = td_hash(src, size);
+    if (ci_bits) tlut_hash = td_hash(tlut, tlut_bytes);
+    if (e) {
+        // Same key, new bytes: decode over the old image once its users are done.
+        td_release();
+    } else {
+        e = td_alloc(w * h * 4u);
+        if (!e) return 0;
+        e->texels = (uint32_t *)malloc((size_t)w * h * sizeof(uint32_t));
+        if (!e->texels) return 0;
+        s_td_bytes += w * h * 4u;
+    }
+    e->addr = addr;
+    e->w = w;
+    e->h = h;
+    e->fmt = fmt;
+    if (!gc_gx_texdec_decode(e->texels, src, w, h, fmt, tlut, (tlut_reg >> 10) & 3u)) {
+        td_entry_free(e);
+        return 0;
+    }
+    e->tlut_reg = tlut_reg;
+    e->size = size;
+    e->hash = hash;
+    e->tlut_hash = tlut_hash;
+    e->tlut_gen = s_td_tlut_gen;
+    e->valid = 1;
+    e->stale = 0;
+    e->lru = ++s_td_lru_tick;
+    return e->texels;
+}
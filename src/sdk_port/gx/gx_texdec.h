@@ -0,0 +1,93 @@
+/*
+ * sdk_port/gx/gx_texdec.h --- Texture decoder and decoded-texture cache.
+ *
+ * Decodes tiled GX texture images (big-endian, as GXInitTexObj describes
+ * them) into linear RGBA8 words, r << 24 | g << 16 | b << 8 | a, the same
+ * packing as the EFB. Every GX_TF_* format is covered: I4, I8, IA4, IA8,
+ * RGB565, RGB5A3, RGBA8, CMPR and the C4/C8/C14X2 color-index formats,
+ * which look their entries up in the TLUT half of TMEM.
+ *
+ * TMEM TLUTs are filled by BP 0x65 (GXLoadTlut) from the RAM address in BP
+ * 0x64. A texture's BP 0x98.. register picks the TLUT offset and format.
+ *
+ * gc_gx_texdec_get keeps decoded images in a cache keyed by image address,
+ * format, size and (for CI formats) the TLUT contents, validated by a hash
+ * of the image bytes. Like the display list cache, ranges reported through
+ * gc_mem_notify_write mark overlapping entries stale; a stale entry is
+ * rehashed on its next use and decoded again only if the bytes changed.
+ *
+ * gc_gx_texdec_decode converts four texels per vector operation (GCC
+ * vector extensions); gc_gx_texdec_decode_ref decodes one texel at a time
+ * from its tiled address and is the test oracle.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define GC_GX_TF_I4     0x0u
+#define GC_GX_TF_I8     0x1u
+#define GC_GX_TF_IA4    0x2u
+#define GC_GX_TF_IA8    0x3u
+#define GC_GX_TF_RGB565 0x4u
+#define GC_GX_TF_RGB5A3 0x5u
+#define GC_GX_TF_RGBA8  0x6u
+#define GC_GX_TF_C4     0x8u
+#define GC_GX_TF_C8     0x9u
+#define GC_GX_TF_C14X2  0xAu
+#define GC_GX_TF_CMPR   0xEu
+
+/* TLUT entry formats (BP 0x98 bits 10..11). */
+#define GC_GX_TL_IA8    0x0u
+#define GC_GX_TL_RGB565 0x1u
+#define GC_GX_TL_RGB5A3 0x2u
+
+#define GC_GX_TEXDEC_CACHE_ENTRIES 64u
+#define GC_GX_TEXDEC_TLUT_BYTES    0x80000u   /* upper half of TMEM */
+#define GC_GX_TEXDEC_MAX_DIM       1024u
+
+/* Cache counters (reset by gc_gx_texdec_cache_reset). */
+extern uint32_t gc_gx_texdec_hits;
+extern uint32_t gc_gx_texdec_misses;
+extern uint32_t gc_gx_texdec_revalidations;
+extern uint32_t gc_gx_texdec_invalidations;
+extern uint32_t gc_gx_texdec_evictions;
+
+/* 0 = decode on every lookup (reference path). Default 1. */
+extern uint32_t gc_gx_texdec_cache_enable;
+/* 1 = rehash image bytes on every hit (catches writes nobody reported). */
+extern uint32_t gc_gx_texdec_cache_verify;
+
+/*
+ * Called before a cached image is overwritten or freed, so users holding
+ * texel pointers (the rasterizer's binned draws) can finish with them.
+ */
+extern void (*gc_gx_texdec_release_hook)(void);
+
+/* Bytes a w x h image of fmt occupies in RAM (whole blocks). 0 if unknown. */
+uint32_t gc_gx_texdec_size(uint32_t w, uint32_t h, uint32_t fmt);
+
+/*
+ * Decode a w x h image into dst (w * h words, row-major). tlut points at the
+ * big-endian 16-bit TLUT entries for CI formats (ignored otherwise). Returns
+ * 0 for an unknown format or size.
+ */
+int gc_gx_texdec_decode(uint32_t *dst, const uint8_t *src, uint32_t w, uint32_t h,
+                        uint32_t fmt, const uint8_t *tlut, uint32_t tlut_fmt);
+int gc_gx_texdec_decode_ref(uint32_t *dst, const uint8_t *src, uint32_t w, uint32_t h,
+                            uint32_t fmt, const uint8_t *tlut, uint32_t tlut_fmt);
+
+/* BP 0x65: copy count * 16 entries from RAM into TMEM at offset * 512. */
+void gc_gx_texdec_load_tlut(uint32_t ram_addr, uint32_t tmem_offset, uint32_t count);
+const uint8_t *gc_gx_texdec_tlut(uint32_t tmem_offset);
+
+/*
+ * Decoded image for GC address addr, or NULL if it cannot be read/decoded.
+ * tlut_reg is the texture's BP 0x98.. value (CI formats only). The pointer
+ * stays valid until gc_gx_texdec_release_hook runs.
+ */
+const uint32_t *gc_gx_texdec_get(uint32_t addr, uint32_t w, uint32_t h, uint32_t fmt,
+                                 uint32_t tlut_reg);
+
+void gc_gx_texdec_cache_reset(void);
+void gc_gx_texdec_invalidate_range(uint32_t addr, size_t len);
@@ -0,0 +1,174 @@
+/*
+ * sdk_port/gx/gx_tmem.c --- TMEM and texture cache simulator.
+ *
+ * See gx_tmem.h. Each TMEM line holds a tag: 0 when empty, the RAM line
+ * address + 1 for a cached texture line, TM_TLUT or TM_PRELOAD.
+ */
+#include <stdint.h>
+#include <string.h>
+#include "gx_tmem.h"
+#include "gx_texdec.h"
+
+GcGxTmemStats gc_gx_tmem_frame;
+GcGxTmemStats gc_gx_tmem_last;
+GcGxTmemStats gc_gx_tmem_total;
+uint32_t gc_gx_tmem_frames;
+uint32_t gc_gx_tmem_enable = 1u;
+void (*gc_gx_tmem_frame_hook)(const GcGxTmemStats *frame);
+
+#define TM_TLUT    0x80000000u
+#define TM_PRELOAD 0x40000000u
+
+static uint32_t tm_tags[GC_GX_TMEM_LINES];
+
+// One cache bank: first line and line count (0 = absent).
+typedef struct {
+    uint32_t base, lines;
+} TmBank;
+
+void gc_gx_tmem_reset(void) {
+    memset(tm_tags, 0, sizeof(tm_tags));
+    memset(&gc_gx_tmem_frame, 0, sizeof(gc_gx_tmem_frame));
+    memset(&gc_gx_tmem_last, 0, sizeof(gc_gx_tmem_last));
+    memset(&gc_gx_tmem_total, 0, sizeof(gc_gx_tmem_total));
+    gc_gx_tmem_frames = 0;
+}
+
+// image1/image2: TMEM line in bits 0..14, size exponent in bits 15..17
+// (3 = 32K, 4 = 128K, 5 = 512K, 0 = none).
+static TmBank tm_bank(uint32_t image) {
+    const uint32_t exp = (image >> 15) & 7u;
+    TmBank b;
+    b.base = image & 0x7FFFu;
+    b.lines = (exp >= 3u && exp <= 5u) ? (1u << (2u * exp + 9u)) >> 5 : 0u;
+    if (b.base + b.lines > GC_GX_TMEM_LINES) b.lines = GC_GX_TMEM_LINES - b.base;
+    return b;
+}
+
+static void tm_touch(const TmBank *b, uint32_t key, uint32_t ram_line) {
+    const uint32_t idx = b->base + key % b->lines;
+    const uint32_t tag = tm_tags[idx];
+    GcGxTmemStats *s = &gc_gx_tmem_frame;
+
+    if (tag == ram_line + 1u) {
+        s->hits++;
+        return;
+    }
+    s->misses++;
+    s->slot_misses[idx >> 10]++;
+    if (tag == TM_TLUT) {
+        s->tlut_clobbers++;
+    } else if (tag == TM_PRELOAD) {
+        s->preload_clobbers++;
+    } else if (tag) {
+        s->evictions++;
+        s->slot_evictions[idx >> 10]++;
+    }
+    tm_tags[idx] = ram_line + 1u;
+}
+
+// Walk the image's levels: fn(bank 0/1, index of the line in its bank's
+// stream, RAM line) for every 32-byte line, in load order.
+typedef void (*TmLineFn)(void *ctx, uint32_t bank, uint32_t key, uint32_t ram_line);
+
+static void tm_walk(uint32_t image0, uint32_t image3, uint32_t mode1, uint32_t mipmap, TmLineFn fn,
+                    void *ctx) {
+    const uint32_t fmt = (image0 >> 20) & 0xFu;
+    uint32_t w = (image0 & 0x3FFu) + 1u, h = ((image0 >> 10) & 0x3FFu) + 1u;
+    uint32_t line = image3 & 0x1FFFFFu;
+    uint32_t levels = 1u, level, i;
+
+    if (mipmap) levels = ((mode1 >> 8) & 0xFFu) / 16u + 1u;
+    for (level = 0; level < levels; level++) {
+        const uint32_t n = gc_gx_texdec_size(w, h, fmt) >> 5;
+        if (!n) break;
+        if (fmt == GC_GX_TF_RGBA8) {
+            for (i = 0; i < n; i++) fn(ctx, i & 1u, (line + i) >> 1, line + i);
+        } else {
+            for (i = 0; i < n; i++) fn(ctx, level & 1u, line + i, line + i);
+        }
+        line += n;
+        if (w == 1u && h == 1u) break;
+        w = w > 1u ? w >> 1 : 1u;
+        h = h > 1u ? h >> 1 : 1u;
+    }
+}
+
+static void tm_cache_line(void *ctx, uint32_t bank, uint32_t key, uint32_t ram_line) {
+    const TmBank *b = (const TmBank *)ctx;
+    tm_touch(&b[bank], key, ram_line);
+}
+
+void gc_gx_tmem_load_tex(uint32_t image0, uint32_t image3, uint32_t mode1, uint32_t mipmap,
+                         uint32_t image1, uint32_t image2) {
+    TmBank b[2];
+
+    if (!gc_gx_tmem_enable) return;
+    gc_gx_tmem_frame.loads++;
+    if (image1 & (1u << 21)) {
+        gc_gx_tmem_frame.preloaded++;
+        return;
+    }
+    b[0] = tm_bank(image1);
+    b[1] = tm_bank(image2);
+    if (!b[0].lines) return;
+    if (!b[1].lines) b[1] = b[0];
+    tm_walk(image0, image3, mode1, mipmap, tm_cache_line, b);
+}
+
+// Preloads fill each bank from its base, one line after another.
+static void tm_preload_line(void *ctx, uint32_t bank, uint32_t key, uint32_t ram_line) {
+    uint32_t *next = (uint32_t *)ctx;
+    (void)key;
+    (void)ram_line;
+    if (next[bank] < GC_GX_TMEM_LINES) tm_tags[next[bank]++] = TM_PRELOAD;
+}
+
+void gc_gx_tmem_preload(uint32_t image0, uint32_t image3, uint32_t mode1, uint32_t mipmap,
+                        uint32_t image1, uint32_t image2) {
+    const uint32_t fmt = (image0 >> 20) & 0xFu;
+    uint32_t next[2];
+
+    if (!gc_gx_tmem_enable) return;
+    gc_gx_tmem_frame.preloads++;
+    next[0] = image1 & 0x7FFFu;
+    next[1] = image2 & 0x7FFFu;
+    // Without split data (no mipmaps, not RGBA8) the odd base is unused.
+    if (!mipmap && fmt != GC_GX_TF_RGBA8) next[1] = next[0];
+    tm_walk(image0, image3, mode1, mipmap, tm_preload_line, next);
+}
+
+// loadTlut1: TMEM offset in 512-byte units in bits 0..9, size in 16-entry
+// (32-byte) units in bits 10..20. TLUTs live in the upper half of TMEM.
+void gc_gx_tmem_load_tlut(uint32_t load_tlut1) {
+    const uint32_t first = (GC_GX_TMEM_BYTES >> 6) + ((load_tlut1 & 0x3FFu) << 4);
+    uint32_t n = (load_tlut1 >> 10) & 0x7FFu, i;
+
+    if (!gc_gx_tmem_enable) return;
+    gc_gx_tmem_frame.tlut_loads++;
+    if (first >= GC_GX_TMEM_LINES) return;
+    if (n > GC_GX_TMEM_LINES - first) n = GC_GX_TMEM_LINES - first;
+    for (i = 0; i < n; i++) tm_tags[first + i] = TM_TLUT;
+}
+
+void gc_gx_tmem_invalidate(void) {
+    uint32_t i;
+    if (!gc_gx_tmem_enable) return;
+    gc_gx_tmem_frame.invalidates++;
+    for (i = 0; i < GC_GX_TMEM_LINES; i++) {
+        if (!(tm_tags[i] & (TM_TLUT | TM_PRELOAD))) tm_tags[i] = 0;
+    }
+}
+
+void gc_gx_tmem_end_frame(void) {
+    const uint32_t *src = (const uint32_t *)(const void *)&gc_gx_tmem_frame;
+    uint32_t *dst = (uint32_t *)(void *)&gc_gx_tmem_total;
+    uint32_t i;
+
+    if (!gc_gx_tmem_enable) return;
+    for (i = 0; i < sizeof(GcGxTmemStats) / sizeof(uint32_t); i++) dst[i] += src[i];
+    gc_gx_tmem_last = gc_gx_tmem_frame;
+    memset(&gc_gx_tmem_frame, 0, sizeof(gc_gx_tmem_frame));
+    gc_gx_tmem_frames++;
+    if (gc_gx_tmem_frame_hook) gc_gx_tmem_frame_hook(&gc_gx_tmem_last);
+}
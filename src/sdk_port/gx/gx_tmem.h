@@ -0,0 +1,87 @@
+/*
+ * sdk_port/gx/gx_tmem.h --- TMEM and texture cache simulator.
+ *
+ * Models the 1 MiB of texture memory as 32768 lines of 32 bytes and
+ * replays what each texture load would do to it, so scenes can be checked
+ * for texture thrashing and region callbacks tuned.
+ *
+ * A texture region (GXInitTexCacheRegion / the image1 and image2 registers
+ * of GXLoadTexObjPreLoaded) is an even bank at image1 and an odd bank at
+ * image2, each 32K, 128K or 512K (or none for odd). Each bank is modelled
+ * as a direct-mapped cache of 32-byte lines indexed by the RAM line
+ * address. A load touches every line of the image:
+ *   - RGBA8 tiles are 64 bytes, AR in the even bank and GB in the odd
+ *     bank;
+ *   - mipmap levels alternate between the banks, level 0 in the even one;
+ *   - when the odd bank is absent everything goes to the even bank.
+ * Regions with image1 bit 21 set are preloaded and cause no cache traffic.
+ * GXPreLoadEntireTexture writes the image into such a region, the banks
+ * filled in order from their base; a cache fill landing on preloaded
+ * lines counts as a preload clobber.
+ *
+ * GXLoadTlut marks its TMEM lines as TLUT; a texture fill landing there
+ * counts as a TLUT clobber. GXInvalidateTexAll empties the cache lines
+ * (TLUTs and preloaded textures stay).
+ * GXCopyDisp ends a frame: gc_gx_tmem_frame moves to gc_gx_tmem_last, is
+ * added into gc_gx_tmem_total and gc_gx_tmem_frame_hook (if set) sees it.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define GC_GX_TMEM_BYTES  0x100000u
+#define GC_GX_TMEM_LINES  (GC_GX_TMEM_BYTES >> 5)
+#define GC_GX_TMEM_SLOTS  32u          /* 32K slots for the per-area counters */
+
+typedef struct {
+    uint32_t loads;          /* texture loads (GXLoadTexObj / PreLoaded) */
+    uint32_t preloaded;      /* loads from preloaded regions */
+    uint32_t hits;           /* lines already resident */
+    uint32_t misses;         /* line fills */
+    uint32_t evictions;      /* fills replacing another texture line */
+    uint32_t tlut_loads;
+    uint32_t tlut_clobbers;  /* fills replacing a loaded TLUT line */
+    uint32_t preloads;       /* GXPreLoadEntireTexture calls */
+    uint32_t preload_clobbers; /* fills replacing a preloaded line */
+    uint32_t invalidates;
+    uint32_t slot_misses[GC_GX_TMEM_SLOTS];     /* by TMEM 32K slot */
+    uint32_t slot_evictions[GC_GX_TMEM_SLOTS];
+} GcGxTmemStats;
+
+extern GcGxTmemStats gc_gx_tmem_frame;   /* current frame */
+extern GcGxTmemStats gc_gx_tmem_last;    /* last completed frame */
+extern GcGxTmemStats gc_gx_tmem_total;   /* completed frames */
+extern uint32_t gc_gx_tmem_frames;
+
+/* 0 = skip the simulation (counters stay at zero). Default 1. */
+extern uint32_t gc_gx_tmem_enable;
+
+/* Called by gc_gx_tmem_end_frame with the frame just completed. */
+extern void (*gc_gx_tmem_frame_hook)(const GcGxTmemStats *frame);
+
+/* Empty TMEM and clear every counter (GXInit). */
+void gc_gx_tmem_reset(void);
+
+/*
+ * A texture load with the map registers GXLoadTexObjPreLoaded writes:
+ * image0 (size, format), image3 (RAM address), mode1 (max LOD) and the
+ * region's image1/image2. mipmap is the texture object's mipmap flag.
+ */
+void gc_gx_tmem_load_tex(uint32_t image0, uint32_t image3, uint32_t mode1, uint32_t mipmap,
+                         uint32_t image1, uint32_t image2);
+
+/*
+ * GXPreLoadEntireTexture: same registers, image1/image2 from a preload
+ * region (base only; the image decides how many lines it takes).
+ */
+void gc_gx_tmem_preload(uint32_t image0, uint32_t image3, uint32_t mode1, uint32_t mipmap,
+                        uint32_t image1, uint32_t image2);
+
+/* GXLoadTlut with the region's loadTlut1 register. */
+void gc_gx_tmem_load_tlut(uint32_t load_tlut1);
+
+/* GXInvalidateTexAll. */
+void gc_gx_tmem_invalidate(void);
+
+/* GXCopyDisp. */
+void gc_gx_tmem_end_frame(void);
@@ -0,0 +1,301 @@
+/*
+ * sdk_port/gx/gx_trace.c --- GX command trace (.gxtrace) capture and replay.
+ *
+ * See gx_trace.h. The recorder keeps a shadow of RAM as the trace holds it
+ * (one known bit per 32-byte line) so repeated reads of unchanged arrays,
+ * display lists and textures cost nothing after their first MEM record.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gx_trace.h"
+#include "gx_gp.h"
+#include "gx_dl.h"
+#include "gx_vtx.h"
+#include "gx_raster.h"
+#include "gx_tmem.h"
+#include "gx_fifo.h"
+#include "../gc_mem.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define TR_LINES (GC_GX_TRACE_RAM_SIZE >> 5)
+
+// GP_STATE payload: GcGxGpState up to its stream counters.
+#define TR_GP_REGS ((uint32_t)offsetof(GcGxGpState, bp_writes))
+
+GcGxTraceStats gc_gx_trace_recorded;
+
+static FILE *s_tr_file;
+static int s_tr_own_file;
+static uint8_t *s_tr_shadow;
+static uint32_t *s_tr_known;
+
+// ---- Recording ----
+
+static void tr_put(uint32_t type, const void *head, uint32_t head_size, const void *data,
+                   uint32_t size) {
+    static const uint8_t k_pad[4];
+    const uint32_t h[2] = { type, head_size + size };
+    fwrite(h, sizeof(h), 1, s_tr_file);
+    if (head_size) fwrite(head, head_size, 1, s_tr_file);
+    if (size) fwrite(data, size, 1, s_tr_file);
+    fwrite(k_pad, (4u - ((head_size + size) & 3u)) & 3u, 1, s_tr_file);
+    gc_gx_trace_recorded.records++;
+}
+
+static void tr_event(uint32_t type, const void *data, uint32_t size) {
+    tr_put(type, 0, 0, data, size);
+    if (type == GC_GX_TRACE_CMD) gc_gx_trace_recorded.cmd_bytes += size;
+    if (type == GC_GX_TRACE_RESET) gc_gx_trace_recorded.resets++;
+    if (type == GC_GX_TRACE_COPY_DISP) gc_gx_trace_recorded.frames++;
+}
+
+static void tr_mem_run(uint32_t first, uint32_t n) {
+    const uint32_t addr = GC_GX_TRACE_RAM_BASE + (first << 5);
+    const uint8_t *src = gc_mem_ptr(addr, n << 5);
+    if (!src) return;
+    tr_put(GC_GX_TRACE_MEM, &addr, sizeof(addr), src, n << 5);
+    gc_gx_trace_recorded.mem_bytes += n << 5;
+}
+
+static inline int tr_known(uint32_t line) { return (s_tr_known[line >> 5] >> (line & 31u)) & 1u; }
+
+// Reads store the lines the trace does not hold yet; GP writes (EFB copies)
+// update the shadow, since a replay produces the same bytes.
+static void tr_mem(uint32_t addr, uint32_t size, int write) {
+    uint32_t off, end, line, last, run = 0, run_n = 0;
+
+    addr |= GC_GX_TRACE_RAM_BASE;
+    if (!size || addr - GC_GX_TRACE_RAM_BASE >= GC_GX_TRACE_RAM_SIZE) return;
+    off = addr - GC_GX_TRACE_RAM_BASE;
+    end = size > GC_GX_TRACE_RAM_SIZE - off ? GC_GX_TRACE_RAM_SIZE : off + size;
+    last = (end - 1u) >> 5;
+    for (line = off >> 5; line <= last; line++) {
+        const uint8_t *ram = gc_mem_ptr(GC_GX_TRACE_RAM_BASE + (line << 5), 32u);
+        uint8_t *sh = s_tr_shadow + (line << 5);
+        const uint32_t bit = 1u << (line & 31u);
+
+        if (!ram) break;
+        if (write) {
+            // A line only partly written still holds bytes the trace may not have.
+            if ((line << 5) >= off && (line << 5) + 32u <= end) {
+                memcpy(sh, ram, 32u);
+                s_tr_known[line >> 5] |= bit;
+            } else {
+                s_tr_known[line >> 5] &= ~bit;
+            }
+            continue;
+        }
+        if (tr_known(line) && memcmp(sh, ram, 32u) == 0) {
+            if (run_n) tr_mem_run(run, run_n);
+            run_n = 0;
+            continue;
+        }
+        memcpy(sh, ram, 32u);
+        s_tr_known[line >> 5] |= bit;
+        if (!run_n) run = line;
+        run_n++;
+    }
+    if (run_n) tr_mem_run(run, run_n);
+}
+
+int gc_gx_trace_record_start(FILE *f) {
+    const uint32_t header[4] = { GC_GX_TRACE_MAGIC, GC_GX_TRACE_VERSION, GC_GX_TRACE_RAM_BASE,
+                                 GC_GX_TRACE_RAM_SIZE };
+
+    if (!f || s_tr_file) return -1;
+    s_tr_shadow = (uint8_t *)malloc(GC_GX_TRACE_RAM_SIZE);
+    s_tr_known = (uint32_t *)calloc(TR_LINES / 32u, sizeof(uint32_t));
+    if (!s_tr_shadow || !s_tr_known) {
+        free(s_tr_shadow);
+        free(s_tr_known);
+        s_tr_shadow = 0;
+        s_tr_known = 0;
+        return -1;
+    }
+    // Commands already in the FIFO belong before the GP_STATE snapshot.
+    gc_gx_fifo_drain();
+    s_tr_file = f;
+    memset(&gc_gx_trace_recorded, 0, sizeof(gc_gx_trace_recorded));
+    fwrite(header, sizeof(header), 1, f);
+    tr_put(GC_GX_TRACE_GP_STATE, 0, 0, &gc_gx_gp, TR_GP_REGS);
+    gc_gx_trace_hook = tr_event;
+    gc_gx_gp_mem_hook = tr_mem;
+    return 0;
+}
+
+int gc_gx_trace_record_open(const char *path) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return -1;
+    if (gc_gx_trace_record_start(f) != 0) {
+        fclose(f);
+        return -1;
+    }
+    s_tr_own_file = 1;
+    return 0;
+}
+
+void gc_gx_trace_record_stop(void) {
+    if (!s_tr_file) return;
+    gc_gx_trace_hook = 0;
+    gc_gx_gp_mem_hook = 0;
+    if (s_tr_own_file) fclose(s_tr_file);
+    else fflush(s_tr_file);
+    s_tr_file = 0;
+    s_tr_own_file = 0;
+    free(s_tr_shadow);
+    free(s_tr_known);
+    s_tr_shadow = 0;
+    s_tr_known = 0;
+}
+
+// ---- Replay ----
+
+static uint32_t tr_rd32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static void tr_tmem(uint32_t type, const uint8_t *p, uint32_t size) {
+    uint32_t w[6] = { 0 };
+    memcpy(w, p, size < sizeof(w) ? size : sizeof(w));
+    switch (type) {
+    case GC_GX_TRACE_TMEM_LOAD: gc_gx_tmem_load_tex(w[0], w[1], w[2], w[3], w[4], w[5]); break;
+    case GC_GX_TRACE_TMEM_PRELOAD: gc_gx_tmem_preload(w[0], w[1], w[2], w[3], w[4], w[5]); break;
+    case GC_GX_TRACE_TMEM_TLUT: gc_gx_tmem_load_tlut(w[0]); break;
+    default: gc_gx_tmem_invalidate(); break;
+    }
+}
+
+int gc_gx_trace_replay(const uint8_t *data, size_t size, GcGxTraceStats *st) {
+    GcGxTraceStats s;
+    size_t pos = 16;
+
+    memset(&s, 0, sizeof(s));
+    if (st) *st = s;
+    if (!data || size < 16 || tr_rd32(data) != GC_GX_TRACE_MAGIC ||
+        tr_rd32(data + 4) != GC_GX_TRACE_VERSION) {
+        return 0;
+    }
+    while (pos < size) {
+        const uint8_t *p = data + pos + 8;
+        uint32_t type, len;
+
+        if (size - pos < 8) break;
+        type = tr_rd32(data + pos);
+        len = tr_rd32(data + pos + 4);
+        if (size - pos - 8 < len) break;
+        pos += 8 + ((len + 3u) & ~(size_t)3u);
+        s.records++;
+        switch (type) {
+        case GC_GX_TRACE_CMD:
+            gc_gx_gp_run(p, len);
+            s.cmd_bytes += len;
+            break;
+        case GC_GX_TRACE_MEM: {
+            uint8_t *dst;
+            uint32_t addr;
+            if (len < 4u) break;
+            addr = tr_rd32(p);
+            dst = gc_mem_ptr(addr, len - 4u);
+            if (!dst) break;
+            memcpy(dst, p + 4, len - 4u);
+            gc_mem_notify_write(addr, len - 4u);
+            s.mem_bytes += len - 4u;
+            break;
+        }
+        case GC_GX_TRACE_RESET:
+            // GXInit's GP-side resets.
+            gc_gx_gp_reset();
+            gc_gx_dl_cache_reset();
+            gc_gx_vtx_reset();
+            gc_gx_raster_reset();
+            gc_gx_tmem_reset();
+            s.resets++;
+            break;
+        case GC_GX_TRACE_COPY_DISP: {
+            GcGxTraceCopyDisp t;
+            if (len != sizeof(t)) break;
+            memcpy(&t, p, sizeof(t));
+            gc_gx_tmem_end_frame();
+            gc_gx_raster_end_frame();
+            gc_gx_xfb_display_copy(&t.copy, t.addr, t.clear, t.clear_rgba, t.clear_z);
+            s.frames++;
+            break;
+        }
+        case GC_GX_TRACE_TMEM_LOAD:
+        case GC_GX_TRACE_TMEM_PRELOAD:
+        case GC_GX_TRACE_TMEM_TLUT:
+        case GC_GX_TRACE_TMEM_INVAL:
+            tr_tmem(type, p, len);
+            break;
+        case GC_GX_TRACE_GP_STATE:
+            // Registers only: the stream counters keep counting.
+            if (len == TR_GP_REGS) memcpy(&gc_gx_gp, p, TR_GP_REGS);
+            break;
+        default:
+            // Unknown records are skipped.
+            break;
+        }
+    }
+    if (st) *st = s;
+    return pos == size;
+}
+
+// ---- Mapping ----
+
+const uint8_t *gc_gx_trace_map(const char *path, size_t *size) {
+#ifndef _WIN32
+    struct stat sb;
+    void *p;
+    const int fd = open(path, O_RDONLY);
+
+    if (fd < 0) return 0;
+    if (fstat(fd, &sb) != 0 || sb.st_size <= 0) {
+        close(fd);
+        return 0;
+    }
+    p = mmap(0, (size_t)sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return 0;
+#ifdef MADV_SEQUENTIAL
+    madvise(p, (size_t)sb.st_size, MADV_SEQUENTIAL);
+#endif
+    *size = (size_t)sb.st_size;
+    return (const uint8_t *)p;
+#else
+    FILE *f = fopen(path, "rb");
+    uint8_t *p = 0;
+    long n;
+
+    if (!f) return 0;
+    if (fseek(f, 0, SEEK_END) == 0 && (n = ftell(f)) > 0 && fseek(f, 0, SEEK_SET) == 0) {
+        p = (uint8_t *)malloc((size_t)n);
+        if (p && fread(p, 1, (size_t)n, f) != (size_t)n) {
+            free(p);
+            p = 0;
+        }
+        *size = (size_t)n;
+    }
+    fclose(f);
+    return p;
+#endif
+}
+
+void gc_gx_trace_unmap(const uint8_t *data, size_t size) {
+    if (!data) return;
+#ifndef _WIN32
+    munmap((void *)(uintptr_t)data, size);
+#else
+    (void)size;
+    free((void *)(uintptr_t)data);
+#endif
+}
@@ -0,0 +1,90 @@
+/*
+ * sdk_port/gx/gx_trace.h --- GX command trace (.gxtrace) capture and replay.
+ *
+ * A trace holds everything the GP model consumed during a session, so it
+ * can be run again through gx_gp / gx_vtx / gx_xf / gx_raster without the
+ * game (reproducible benchmark input):
+ *   - CMD:  command stream bytes, as GX.c hands them to gc_gx_gp_run;
+ *   - MEM:  RAM the GP read (display lists, vertex and matrix arrays,
+ *           textures, TLUTs), written before the CMD record that reads it.
+ *           Only 32-byte lines whose content differs from what the trace
+ *           already holds are stored; lines the GP wrote itself (EFB copies)
+ *           count as already held;
+ *   - GX-side work that does not go through the stream: GXInit (RESET),
+ *     GXCopyDisp (COPY_DISP) and the TMEM simulator hooks.
+ * The first record holds the GP register files, so a recording may start
+ * mid-session; the EFB is not stored, so it should start at GXInit or right
+ * after a clearing GXCopyDisp.
+ *
+ * File layout, host byte order (the magic tells a reader the order):
+ *   header  u32 magic, version, ram_base, ram_size
+ *   records u32 type, u32 size, size bytes of payload, zero padding to 4
+ *
+ * Recording is host-only (stdio); GX.c and the GP modules only call the
+ * hooks, which stay NULL unless a recorder is running.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "gx_xfb.h"
+
+#define GC_GX_TRACE_MAGIC    0x52545847u   /* "GXTR" read as little-endian */
+#define GC_GX_TRACE_VERSION  1u
+#define GC_GX_TRACE_RAM_BASE 0x80000000u
+#define GC_GX_TRACE_RAM_SIZE 0x02000000u   /* MEM1 and the host runner's RAM */
+
+enum {
+    GC_GX_TRACE_CMD = 1,           /* stream bytes */
+    GC_GX_TRACE_MEM = 2,           /* u32 address, bytes */
+    GC_GX_TRACE_RESET = 3,         /* GXInit */
+    GC_GX_TRACE_COPY_DISP = 4,     /* GcGxTraceCopyDisp */
+    GC_GX_TRACE_TMEM_LOAD = 5,     /* u32 image0, image3, mode1, mipmap, image1, image2 */
+    GC_GX_TRACE_TMEM_PRELOAD = 6,  /* same words */
+    GC_GX_TRACE_TMEM_TLUT = 7,     /* u32 loadTlut1 */
+    GC_GX_TRACE_TMEM_INVAL = 8,
+    GC_GX_TRACE_GP_STATE = 9,      /* GcGxGpState registers (up to bp_writes) at the start */
+};
+
+typedef struct {
+    uint32_t addr;                 /* XFB address */
+    uint32_t clear;
+    uint32_t clear_rgba, clear_z;
+    GcGxXfbCopy copy;
+} GcGxTraceCopyDisp;
+
+/* Set while recording; GX.c reports its events through it. */
+extern void (*gc_gx_trace_hook)(uint32_t type, const void *data, uint32_t size);
+
+/*
+ * Start writing a trace to f (or to a new file at path); RAM must be mapped
+ * with gc_mem_set. Returns 0 on success. Stop flushes and, for path,
+ * closes the file.
+ */
+int gc_gx_trace_record_start(FILE *f);
+int gc_gx_trace_record_open(const char *path);
+void gc_gx_trace_record_stop(void);
+
+typedef struct {
+    uint32_t records;
+    uint32_t frames;               /* COPY_DISP records */
+    uint32_t resets;
+    uint64_t cmd_bytes;
+    uint64_t mem_bytes;
+} GcGxTraceStats;
+
+/* Recorder totals for the current or last recording. */
+extern GcGxTraceStats gc_gx_trace_recorded;
+
+/*
+ * Run a trace held in memory (e.g. mapped with gc_gx_trace_map) through the
+ * GP model. RAM must be mapped over the header's range. Returns 0 if the
+ * header is not a trace of this version or a record is truncated; the
+ * records before it have run. st (optional) receives the counts.
+ */
+int gc_gx_trace_replay(const uint8_t *data, size_t size, GcGxTraceStats *st);
+
+/* Map a trace file read-only (read into memory where mmap is missing). */
+const uint8_t *gc_gx_trace_map(const char *path, size_t *size);
+void gc_gx_trace_unmap(const uint8_t *data, size_t size);
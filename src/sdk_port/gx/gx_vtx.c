@@ -0,0 +1,637 @@
+/*
+ * sdk_port/gx/gx_vtx.c --- Software vertex loader. See gx_vtx.h.
+ *
+ * Layout source of truth: GXAttr.c (__GXSetVCD/__GXSetVAT field packing) and
+ * the CP register numbering in gx_gp.h.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gx_vtx.h"
+#include "gx_gp.h"
+#include "../gc_mem.h"
+
+GcGxVtxBuf gc_gx_vtx;
+uint32_t gc_gx_vtx_enable = 1;
+uint32_t gc_gx_vtx_loader_hits;
+uint32_t gc_gx_vtx_loader_misses;
+uint32_t gc_gx_vtx_loader_evictions;
+uint32_t gc_gx_vtx_vc_checks[GC_GX_VTX_VC_ATTRS];
+uint32_t gc_gx_vtx_vc_misses[GC_GX_VTX_VC_ATTRS];
+
+// Attributes in stream order after the matrix indices. The value doubles as
+// the CP array number for indexed data.
+enum { VTX_POS = 0, VTX_NRM = 1, VTX_CLR0 = 2, VTX_CLR1 = 3, VTX_TEX0 = 4 };
+
+static const uint8_t k_vtx_comp_size[8] = { 1, 1, 2, 2, 4, 0, 0, 0 };
+static const uint8_t k_vtx_clr_size[8] = { 2, 3, 4, 2, 3, 4, 0, 0 };
+// NRM/NBT fixed-point scale exponent per GXCompType (U8, S8, U16, S16).
+static const uint8_t k_vtx_nrm_frac[8] = { 7, 6, 15, 14, 0, 0, 0, 0 };
+
+// Read in place of unmapped array elements.
+static const uint8_t s_vtx_zero[36];
+
+static inline uint32_t vtx_rd16be(const uint8_t *p) {
+    return ((uint32_t)p[0] << 8) | (uint32_t)p[1];
+}
+
+static inline uint32_t vtx_rd32be(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline float vtx_f32be(const uint8_t *p) {
+    const uint32_t u = vtx_rd32be(p);
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static inline float vtx_unorm8(uint32_t x) {
+    return (float)x / 255.0f;
+}
+
+// VCD mode (0 none, 1 direct, 2 index8, 3 index16) of POS..TEX7.
+static inline uint32_t vtx_vcd_mode(uint32_t vcd_lo, uint32_t vcd_hi, uint32_t attr) {
+    if (attr >= VTX_TEX0) return (vcd_hi >> ((attr - VTX_TEX0) * 2u)) & 3u;
+    return (vcd_lo >> (9u + attr * 2u)) & 3u;
+}
+
+// VAT fields of POS..TEX7 (GXAttr.c:__GXSetVAT packing).
+static void vtx_vat_fields(const uint32_t vat[3], uint32_t attr,
+                           uint32_t *cnt, uint32_t *type, uint32_t *frac) {
+    static const uint8_t word[8] = { 0, 1, 1, 1, 1, 2, 2, 2 };
+    static const uint8_t shift[8] = { 21, 0, 9, 18, 27, 5, 14, 23 };
+    switch (attr) {
+    case VTX_POS:
+        *cnt = vat[0] & 1u;
+        *type = (vat[0] >> 1) & 7u;
+        *frac = (vat[0] >> 4) & 31u;
+        return;
+    case VTX_NRM:
+        *cnt = (vat[0] >> 9) & 1u;
+        *type = (vat[0] >> 10) & 7u;
+        *frac = (vat[0] >> 31) & 1u;  // no frac; reports NBT3 (one index per N/B/T)
+        return;
+    case VTX_CLR0:
+    case VTX_CLR1: {
+        const uint32_t s = attr == VTX_CLR0 ? 13u : 17u;
+        *cnt = (vat[0] >> s) & 1u;
+        *type = (vat[0] >> (s + 1u)) & 7u;
+        *frac = 0;
+        return;
+    }
+    default: {
+        const uint32_t n = attr - VTX_TEX0;
+        const uint32_t w = vat[word[n]] >> shift[n];
+        *cnt = w & 1u;
+        *type = (w >> 1) & 7u;
+        // TEX4 frac does not fit in VAT B and lives in VAT C[0..4].
+        *frac = n == 4u ? (vat[2] & 31u) : ((w >> 4) & 31u);
+        return;
+    }
+    }
+}
+
+static inline const uint8_t *vtx_array_ptr(const uint32_t *cp, uint32_t array,
+                                           uint32_t idx, uint32_t len) {
+    // CP array bases are physical; GC RAM is mapped at 0x80000000.
+    const uint32_t addr = (cp[GC_GX_CP_ARRAY_BASE + array] | 0x80000000u) +
+                          idx * cp[GC_GX_CP_ARRAY_STRIDE + array];
+    const uint8_t *p = gc_mem_ptr(addr, len);
+    if (!p) return s_vtx_zero;
+    if (gc_gx_gp_mem_hook) gc_gx_gp_mem_hook(addr, len, 0);
+    return p;
+}
+
+// Vertex cache: line address + 1 (0 = empty) and last-use stamp per way.
+static uint32_t s_vtx_vc_tag[GC_GX_VTX_VC_SETS][GC_GX_VTX_VC_WAYS];
+static uint32_t s_vtx_vc_use[GC_GX_VTX_VC_SETS][GC_GX_VTX_VC_WAYS];
+static uint32_t s_vtx_vc_stamp;
+
+static int vtx_vc_line(uint32_t line) {
+    uint32_t *tag = s_vtx_vc_tag[line % GC_GX_VTX_VC_SETS];
+    uint32_t *use = s_vtx_vc_use[line % GC_GX_VTX_VC_SETS];
+    uint32_t w, victim = 0;
+
+    for (w = 0; w < GC_GX_VTX_VC_WAYS; w++) {
+        if (tag[w] == line + 1u) {
+            use[w] = ++s_vtx_vc_stamp;
+            return 1;
+        }
+        if (use[w] < use[victim]) victim = w;
+    }
+    tag[victim] = line + 1u;
+    use[victim] = ++s_vtx_vc_stamp;
+    return 0;
+}
+
+static void vtx_vc_fetch(const uint32_t *cp, uint32_t array, uint32_t idx, uint32_t len) {
+    const uint32_t addr = cp[GC_GX_CP_ARRAY_BASE + array] + idx * cp[GC_GX_CP_ARRAY_STRIDE + array];
+    // Zero-sized elements (reserved VAT formats) still touch one line; a
+    // wrapped end address clamps to the top of the address space.
+    uint32_t end = addr, line = addr >> 5, hit = 1;
+
+    if (len > 1u) {
+        end = addr + len - 1u;
+        if (end < addr) end = 0xFFFFFFFFu;
+    }
+
+    for (; line <= end >> 5; line++) hit &= (uint32_t)vtx_vc_line(line);
+    gc_gx_vtx_vc_checks[array]++;
+    if (!hit) gc_gx_vtx_vc_misses[array]++;
+}
+
+void gc_gx_vtx_vc_invalidate(void) {
+    memset(s_vtx_vc_tag, 0, sizeof(s_vtx_vc_tag));
+}
+
+static int vtx_reserve(GcGxVtxBuf *out, uint32_t n) {
+    uint32_t cap, i;
+    if (n <= out->cap) return 1;
+    cap = out->cap ? out->cap : 64u;
+    while (cap < n) cap *= 2u;
+    for (i = 0; i < GC_GX_VTX_PLANES; i++) {
+        float *p = (float *)realloc(out->f[i], cap * sizeof(float));
+        if (!p) return 0;
+        out->f[i] = p;
+    }
+    for (i = 0; i < GC_GX_VTX_MTX_PLANES; i++) {
+        uint8_t *p = (uint8_t *)realloc(out->mtx[i], cap);
+        if (!p) return 0;
+        out->mtx[i] = p;
+    }
+    out->cap = cap;
+    return 1;
+}
+
+void gc_gx_vtx_free(GcGxVtxBuf *buf) {
+    uint32_t i;
+    for (i = 0; i < GC_GX_VTX_PLANES; i++) free(buf->f[i]);
+    for (i = 0; i < GC_GX_VTX_MTX_PLANES; i++) free(buf->mtx[i]);
+    memset(buf, 0, sizeof(*buf));
+}
+
+// -----------------------------------------------------------------------------
+// Loader steps
+//
+// A loader is the VCD/VAT configuration compiled into one step per attribute.
+// Each step decodes its attribute for all vertices at once from a list of
+// per-vertex source pointers (stream data or array elements), so integer
+// dequantization runs four vertices per vector op.
+// -----------------------------------------------------------------------------
+
+typedef struct GcGxVtxStep GcGxVtxStep;
+typedef void (*vtx_step_fn)(const GcGxVtxStep *st, const uint8_t *const *src,
+                            uint32_t n, GcGxVtxBuf *out);
+
+struct GcGxVtxStep {
+    vtx_step_fn fn;
+    float scale;       // 1/2^frac for integer components
+    uint16_t off;      // byte offset within the vertex
+    uint8_t mode;      // 1 direct, 2 index8, 3 index16
+    uint8_t array;     // CP array for indexed data
+    uint8_t elem;      // bytes read per vertex (direct data or one array element)
+    uint8_t ncomp;
+    uint8_t plane;     // first output plane
+    uint8_t zfill;     // POS XY: clear the Z plane
+};
+
+#define VTX_MAX_STEPS 24
+
+typedef struct {
+    uint32_t key[5];   // vcd_lo, vcd_hi, VAT A/B/C
+    uint32_t valid;
+    uint32_t stamp;
+    uint32_t vsize;
+    uint32_t nsteps;
+    uint32_t mtx_mask;
+    uint64_t mask;
+    GcGxVtxStep steps[VTX_MAX_STEPS];
+} GcGxVtxLoader;
+
+static GcGxVtxLoader s_vtx_loaders[GC_GX_VTX_LOADER_CACHE];
+static uint32_t s_vtx_stamp;
+static uint32_t s_vtx_last;
+static const uint8_t **s_vtx_src;
+static uint32_t s_vtx_src_cap;
+
+#if defined(__GNUC__) || defined(__clang__)
+typedef int32_t vtx_v4i __attribute__((vector_size(16)));
+typedef float vtx_v4f __attribute__((vector_size(16)));
+#define VTX_SIMD_LOOP(LOAD)                                                      \
+    {                                                                            \
+        const vtx_v4f k = { st->scale, st->scale, st->scale, st->scale };        \
+        for (; i + 4u <= n; i += 4u) {                                           \
+            const vtx_v4i v = { LOAD(src[i] + o), LOAD(src[i + 1u] + o),         \
+                                LOAD(src[i + 2u] + o), LOAD(src[i + 3u] + o) };  \
+            const vtx_v4f f = __builtin_convertvector(v, vtx_v4f) * k;           \
+            memcpy(dst + i, &f, sizeof(f));                                      \
+        }                                                                        \
+    }
+#else
+#define VTX_SIMD_LOOP(LOAD)
+#endif
+
+#define VTX_LD_U8(p)  ((int32_t)(p)[0])
+#define VTX_LD_S8(p)  ((int32_t)(int8_t)(p)[0])
+#define VTX_LD_U16(p) ((int32_t)vtx_rd16be(p))
+#define VTX_LD_S16(p) ((int32_t)(int16_t)vtx_rd16be(p))
+
+#define VTX_DEFINE_INT_STEP(name, LOAD, SZ)                                      \
+    static void name(const GcGxVtxStep *st, const uint8_t *const *src,           \
+                     uint32_t n, GcGxVtxBuf *out) {                              \
+        uint32_t c;                                                              \
+        for (c = 0; c < st->ncomp; c++) {                                        \
+            float *dst = out->f[st->plane + c];                                  \
+            const uint32_t o = c * (SZ);                                         \
+            uint32_t i = 0;                                                      \
+            VTX_SIMD_LOOP(LOAD)                                                  \
+            for (; i < n; i++) dst[i] = (float)LOAD(src[i] + o) * st->scale;     \
+        }                                                                        \
+    }
+
+VTX_DEFINE_INT_STEP(vtx_step_u8, VTX_LD_U8, 1u)
+VTX_DEFINE_INT_STEP(vtx_step_s8, VTX_LD_S8, 1u)
+VTX_DEFINE_INT_STEP(vtx_step_u16, VTX_LD_U16, 2u)
+VTX_DEFINE_INT_STEP(vtx_step_s16, VTX_LD_S16, 2u)
+
+static void vtx_step_f32(const GcGxVtxStep *st, const uint8_t *const *src,
+                         uint32_t n, GcGxVtxBuf *out) {
+    uint32_t c, i;
+    for (c = 0; c < st->ncomp; c++) {
+        float *dst = out->f[st->plane + c];
+        for (i = 0; i < n; i++) dst[i] = vtx_f32be(src[i] + c * 4u);
+    }
+}
+
+// Invalid component types carry no data (see gc_gx_gp_vertex_size_cp).
+static void vtx_step_zero(const GcGxVtxStep *st, const uint8_t *const *src,
+                          uint32_t n, GcGxVtxBuf *out) {
+    uint32_t c, i;
+    (void)src;
+    for (c = 0; c < st->ncomp; c++) {
+        for (i = 0; i < n; i++) out->f[st->plane + c][i] = 0.0f;
+    }
+}
+
+static void vtx_step_mtx(const GcGxVtxStep *st, const uint8_t *const *src,
+                         uint32_t n, GcGxVtxBuf *out) {
+    uint8_t *dst = out->mtx[st->plane];
+    uint32_t i;
+    for (i = 0; i < n; i++) dst[i] = src[i][0];
+}
+
+// Colors: expand to 8 bits per channel like the hardware, then normalize.
+static inline void vtx_put_clr(GcGxVtxBuf *out, uint32_t plane, uint32_t i,
+                               uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+    out->f[plane + 0u][i] = vtx_unorm8(r);
+    out->f[plane + 1u][i] = vtx_unorm8(g);
+    out->f[plane + 2u][i] = vtx_unorm8(b);
+    out->f[plane + 3u][i] = vtx_unorm8(a);
+}
+
+static void vtx_decode_clr(GcGxVtxBuf *out, uint32_t plane, uint32_t i,
+                           uint32_t fmt, const uint8_t *p) {
+    uint32_t v, r, g, b, a;
+    switch (fmt) {
+    case 0:  // RGB565
+        v = vtx_rd16be(p);
+        r = (v >> 11) & 31u; g = (v >> 5) & 63u; b = v & 31u;
+        vtx_put_clr(out, plane, i, (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255u);
+        return;
+    case 1:  // RGB8
+    case 2:  // RGBX8
+        vtx_put_clr(out, plane, i, p[0], p[1], p[2], 255u);
+        return;
+    case 3:  // RGBA4
+        v = vtx_rd16be(p);
+        r = (v >> 12) & 15u; g = (v >> 8) & 15u; b = (v >> 4) & 15u; a = v & 15u;
+        vtx_put_clr(out, plane, i, r * 17u, g * 17u, b * 17u, a * 17u);
+        return;
+    case 4:  // RGBA6
+        v = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+        r = (v >> 18) & 63u; g = (v >> 12) & 63u; b = (v >> 6) & 63u; a = v & 63u;
+        vtx_put_clr(out, plane, i, (r << 2) | (r >> 4), (g << 2) | (g >> 4),
+                    (b << 2) | (b >> 4), (a << 2) | (a >> 4));
+        return;
+    case 5:  // RGBA8
+        vtx_put_clr(out, plane, i, p[0], p[1], p[2], p[3]);
+        return;
+    default:
+        vtx_put_clr(out, plane, i, 0, 0, 0, 0);
+        return;
+    }
+}
+
+#define VTX_DEFINE_CLR_STEP(name, FMT)                                           \
+    static void name(const GcGxVtxStep *st, const uint8_t *const *src,           \
+                     uint32_t n, GcGxVtxBuf *out) {                              \
+        uint32_t i;                                                              \
+        for (i = 0; i < n; i++) vtx_decode_clr(out, st->plane, i, (FMT), src[i]); \
+    }
+
+VTX_DEFINE_CLR_STEP(vtx_step_rgb565, 0u)
+VTX_DEFINE_CLR_STEP(vtx_step_rgb8, 1u)
+VTX_DEFINE_CLR_STEP(vtx_step_rgbx8, 2u)
+VTX_DEFINE_CLR_STEP(vtx_step_rgba4, 3u)
+VTX_DEFINE_CLR_STEP(vtx_step_rgba6, 4u)
+VTX_DEFINE_CLR_STEP(vtx_step_rgba8, 5u)
+
+static const vtx_step_fn k_vtx_comp_fn[8] = {
+    vtx_step_u8, vtx_step_s8, vtx_step_u16, vtx_step_s16, vtx_step_f32,
+    vtx_step_zero, vtx_step_zero, vtx_step_zero,
+};
+static const vtx_step_fn k_vtx_clr_fn[8] = {
+    vtx_step_rgb565, vtx_step_rgb8, vtx_step_rgbx8, vtx_step_rgba4,
+    vtx_step_rgba6, vtx_step_rgba8, vtx_step_zero, vtx_step_zero,
+};
+
+static GcGxVtxStep *vtx_add_step(GcGxVtxLoader *ld, uint32_t *off, uint32_t mode,
+                                 uint32_t direct_size) {
+    GcGxVtxStep *st = &ld->steps[ld->nsteps++];
+    memset(st, 0, sizeof(*st));
+    st->off = (uint16_t)*off;
+    st->mode = (uint8_t)mode;
+    st->scale = 1.0f;
+    *off += mode == 1u ? direct_size : (mode == 2u ? 1u : 2u);
+    return st;
+}
+
+static void vtx_build(GcGxVtxLoader *ld, const uint32_t *key) {
+    const uint32_t vcd_lo = key[0], vcd_hi = key[1];
+    const uint32_t *vat = key + 2;
+    uint32_t off = 0, attr, i;
+
+    memcpy(ld->key, key, sizeof(ld->key));
+    ld->nsteps = 0;
+    ld->mask = 0;
+    ld->mtx_mask = 0;
+
+    for (i = 0; i < GC_GX_VTX_MTX_PLANES; i++) {
+        if ((vcd_lo >> i) & 1u) {
+            GcGxVtxStep *st = vtx_add_step(ld, &off, 1u, 1u);
+            st->fn = vtx_step_mtx;
+            st->elem = 1;
+            st->plane = (uint8_t)i;
+            ld->mtx_mask |= 1u << i;
+        }
+    }
+
+    for (attr = VTX_POS; attr < VTX_TEX0 + 8u; attr++) {
+        const uint32_t mode = vtx_vcd_mode(vcd_lo, vcd_hi, attr);
+        uint32_t cnt, type, frac, ncomp, plane, cs;
+        GcGxVtxStep *st;
+        if (mode == 0) continue;
+        vtx_vat_fields(vat, attr, &cnt, &type, &frac);
+        cs = k_vtx_comp_size[type];
+
+        if (attr == VTX_CLR0 || attr == VTX_CLR1) {
+            plane = attr == VTX_CLR0 ? GC_GX_VTX_CLR0 : GC_GX_VTX_CLR1;
+            st = vtx_add_step(ld, &off, mode, k_vtx_clr_size[type]);
+            st->fn = k_vtx_clr_fn[type];
+            st->elem = k_vtx_clr_size[type];
+            st->ncomp = 4;
+            st->array = (uint8_t)attr;
+            st->plane = (uint8_t)plane;
+            ld->mask |= (uint64_t)0xFu << plane;
+            continue;
+        }
+
+        if (attr == VTX_NRM) {
+            const uint32_t nbt = cnt;
+            const float scale = 1.0f / (float)(1u << k_vtx_nrm_frac[type]);
+            ld->mask |= (uint64_t)(nbt ? 0x1FFu : 0x7u) << GC_GX_VTX_NRM;
+            if (nbt && frac && mode != 1u) {
+                // NBT3: three indices, each selecting a 3-component vector.
+                for (i = 0; i < 3u; i++) {
+                    st = vtx_add_step(ld, &off, mode, 0);
+                    st->fn = k_vtx_comp_fn[type];
+                    st->scale = scale;
+                    st->elem = (uint8_t)(3u * cs);
+                    st->ncomp = 3;
+                    st->array = VTX_NRM;
+                    st->plane = (uint8_t)(GC_GX_VTX_NRM + i * 3u);
+                }
+                continue;
+            }
+            ncomp = nbt ? 9u : 3u;
+            st = vtx_add_step(ld, &off, mode, ncomp * cs);
+            st->fn = k_vtx_comp_fn[type];
+            st->scale = scale;
+            st->elem = (uint8_t)(ncomp * cs);
+            st->ncomp = (uint8_t)ncomp;
+            st->array = VTX_NRM;
+            st->plane = GC_GX_VTX_NRM;
+            continue;
+        }
+
+        // POS / TEXn
+        if (attr == VTX_POS) {
+            ncomp = cnt ? 3u : 2u;
+            plane = GC_GX_VTX_POS;
+            ld->mask |= (uint64_t)0x7u << plane;
+        } else {
+            ncomp = cnt ? 2u : 1u;
+            plane = GC_GX_VTX_TEX0 + (attr - VTX_TEX0) * 2u;
+            ld->mask |= (uint64_t)(cnt ? 0x3u : 0x1u) << plane;
+        }
+        st = vtx_add_step(ld, &off, mode, ncomp * cs);
+        st->fn = k_vtx_comp_fn[type];
+        st->scale = type == 4u ? 1.0f : 1.0f / (float)(1u << frac);
+        st->elem = (uint8_t)(ncomp * cs);
+        st->ncomp = (uint8_t)ncomp;
+        st->array = (uint8_t)attr;
+        st->plane = (uint8_t)plane;
+        st->zfill = (uint8_t)(attr == VTX_POS && !cnt);
+    }
+    ld->vsize = off;
+}
+
+static GcGxVtxLoader *vtx_lookup(const uint32_t *key) {
+    GcGxVtxLoader *ld = &s_vtx_loaders[s_vtx_last];
+    GcGxVtxLoader *victim = NULL;
+    uint32_t i;
+
+    if (ld->valid && memcmp(ld->key, key, sizeof(ld->key)) == 0) {
+        gc_gx_vtx_loader_hits++;
+        ld->stamp = ++s_vtx_stamp;
+        return ld;
+    }
+    for (i = 0; i < GC_GX_VTX_LOADER_CACHE; i++) {
+        ld = &s_vtx_loaders[i];
+        if (!ld->valid) {
+            if (!victim || victim->valid) victim = ld;
+            continue;
+        }
+        if (memcmp(ld->key, key, sizeof(ld->key)) == 0) {
+            gc_gx_vtx_loader_hits++;
+            ld->stamp = ++s_vtx_stamp;
+            s_vtx_last = i;
+            return ld;
+        }
+        if (!victim || (victim->valid && ld->stamp < victim->stamp)) victim = ld;
+    }
+
+    gc_gx_vtx_loader_misses++;
+    if (victim->valid) gc_gx_vtx_loader_evictions++;
+    vtx_build(victim, key);
+    victim->valid = 1;
+    victim->stamp = ++s_vtx_stamp;
+    s_vtx_last = (uint32_t)(victim - s_vtx_loaders);
+    return victim;
+}
+
+void gc_gx_vtx_reset(void) {
+    memset(s_vtx_loaders, 0, sizeof(s_vtx_loaders));
+    s_vtx_stamp = 0;
+    s_vtx_last = 0;
+    gc_gx_vtx_loader_hits = 0;
+    gc_gx_vtx_loader_misses = 0;
+    gc_gx_vtx_loader_evictions = 0;
+    memset(s_vtx_vc_tag, 0, sizeof(s_vtx_vc_tag));
+    memset(s_vtx_vc_use, 0, sizeof(s_vtx_vc_use));
+    s_vtx_vc_stamp = 0;
+    memset(gc_gx_vtx_vc_checks, 0, sizeof(gc_gx_vtx_vc_checks));
+    memset(gc_gx_vtx_vc_misses, 0, sizeof(gc_gx_vtx_vc_misses));
+    gc_gx_vtx.count = 0;
+    gc_gx_vtx.mask = 0;
+    gc_gx_vtx.mtx_mask = 0;
+}
+
+int gc_gx_vtx_decode(GcGxVtxBuf *out, const uint32_t *cp, uint32_t vtxfmt,
+                     uint32_t nverts, const uint8_t *data) {
+    const uint32_t f = vtxfmt & 7u;
+    const uint32_t key[5] = {
+        cp[GC_GX_CP_VCD_LO], cp[GC_GX_CP_VCD_HI],
+        cp[GC_GX_CP_VAT_A + f], cp[GC_GX_CP_VAT_B + f], cp[GC_GX_CP_VAT_C + f],
+    };
+    const GcGxVtxLoader *ld = vtx_lookup(key);
+    uint32_t s, i;
+
+    if (!vtx_reserve(out, nverts)) return 0;
+    if (nverts > s_vtx_src_cap) {
+        const uint8_t **p = (const uint8_t **)realloc((void *)s_vtx_src, nverts * sizeof(*p));
+        if (!p) return 0;
+        s_vtx_src = p;
+        s_vtx_src_cap = nverts;
+    }
+    out->count = nverts;
+    out->vtxfmt = f;
+    out->mask = ld->mask;
+    out->mtx_mask = ld->mtx_mask;
+
+    for (s = 0; s < ld->nsteps; s++) {
+        const GcGxVtxStep *st = &ld->steps[s];
+        const uint8_t *p = data + st->off;
+        if (st->mode == 1u) {
+            for (i = 0; i < nverts; i++, p += ld->vsize) s_vtx_src[i] = p;
+        } else {
+            for (i = 0; i < nverts; i++, p += ld->vsize) {
+                const uint32_t idx = st->mode == 2u ? p[0] : vtx_rd16be(p);
+                vtx_vc_fetch(cp, st->array, idx, st->elem);
+                s_vtx_src[i] = vtx_array_ptr(cp, st->array, idx, st->elem);
+            }
+        }
+        st->fn(st, s_vtx_src, nverts, out);
+        if (st->zfill) {
+            float *z = out->f[GC_GX_VTX_POS + 2u];
+            for (i = 0; i < nverts; i++) z[i] = 0.0f;
+        }
+    }
+    return 1;
+}
+
+// -----------------------------------------------------------------------------
+// Reference decoder: one vertex at a time, straight from the VCD/VAT fields.
+// -----------------------------------------------------------------------------
+
+static float vtx_ref_comp(const uint8_t *p, uint32_t type, uint32_t frac) {
+    const float div = (float)(1u << frac);
+    switch (type) {
+    case 0: return (float)p[0] / div;
+    case 1: return (float)(int8_t)p[0] / div;
+    case 2: return (float)vtx_rd16be(p) / div;
+    case 3: return (float)(int16_t)vtx_rd16be(p) / div;
+    case 4: return vtx_f32be(p);
+    default: return 0.0f;
+    }
+}
+
+int gc_gx_vtx_decode_ref(GcGxVtxBuf *out, const uint32_t *cp, uint32_t vtxfmt,
+                         uint32_t nverts, const uint8_t *data) {
+    const uint32_t f = vtxfmt & 7u;
+    const uint32_t vcd_lo = cp[GC_GX_CP_VCD_LO], vcd_hi = cp[GC_GX_CP_VCD_HI];
+    const uint32_t vat[3] = { cp[GC_GX_CP_VAT_A + f], cp[GC_GX_CP_VAT_B + f], cp[GC_GX_CP_VAT_C + f] };
+    const uint8_t *p = data;
+    uint32_t v, attr, i, c;
+
+    if (!vtx_reserve(out, nverts)) return 0;
+    out->count = nverts;
+    out->vtxfmt = f;
+    out->mask = 0;
+
+    out->mtx_mask = vcd_lo & 0x1FFu;
+    for (attr = VTX_POS; attr < VTX_TEX0 + 8u; attr++) {
+        uint32_t cnt, type, frac;
+        if (vtx_vcd_mode(vcd_lo, vcd_hi, attr) == 0) continue;
+        vtx_vat_fields(vat, attr, &cnt, &type, &frac);
+        if (attr == VTX_POS) out->mask |= (uint64_t)0x7u << GC_GX_VTX_POS;
+        else if (attr == VTX_NRM) out->mask |= (uint64_t)(cnt ? 0x1FFu : 0x7u) << GC_GX_VTX_NRM;
+        else if (attr == VTX_CLR0) out->mask |= (uint64_t)0xFu << GC_GX_VTX_CLR0;
+        else if (attr == VTX_CLR1) out->mask |= (uint64_t)0xFu << GC_GX_VTX_CLR1;
+        else out->mask |= (uint64_t)(cnt ? 0x3u : 0x1u) << (GC_GX_VTX_TEX0 + (attr - VTX_TEX0) * 2u);
+    }
+
+    for (v = 0; v < nverts; v++) {
+        for (i = 0; i < GC_GX_VTX_MTX_PLANES; i++) {
+            if ((vcd_lo >> i) & 1u) out->mtx[i][v] = *p++;
+        }
+        for (attr = VTX_POS; attr < VTX_TEX0 + 8u; attr++) {
+            const uint32_t mode = vtx_vcd_mode(vcd_lo, vcd_hi, attr);
+            uint32_t cnt, type, frac, cs, nsrc, ncomp, plane;
+            const uint8_t *src[3];
+            if (mode == 0) continue;
+            vtx_vat_fields(vat, attr, &cnt, &type, &frac);
+            cs = k_vtx_comp_size[type];
+
+            if (attr == VTX_CLR0 || attr == VTX_CLR1) {
+                const uint32_t sz = k_vtx_clr_size[type];
+                plane = attr == VTX_CLR0 ? GC_GX_VTX_CLR0 : GC_GX_VTX_CLR1;
+                if (mode == 1u) { src[0] = p; p += sz; }
+                else if (mode == 2u) { src[0] = vtx_array_ptr(cp, attr, p[0], sz); p += 1; }
+                else { src[0] = vtx_array_ptr(cp, attr, vtx_rd16be(p), sz); p += 2; }
+                vtx_decode_clr(out, plane, v, type, src[0]);
+                continue;
+            }
+
+            if (attr == VTX_NRM) {
+                ncomp = cnt ? 9u : 3u;
+                plane = GC_GX_VTX_NRM;
+                frac = k_vtx_nrm_frac[type];
+                nsrc = (cnt && (vat[0] >> 31) && mode != 1u) ? 3u : 1u;
+            } else if (attr == VTX_POS) {
+                ncomp = cnt ? 3u : 2u;
+                plane = GC_GX_VTX_POS;
+                nsrc = 1;
+            } else {
+                ncomp = cnt ? 2u : 1u;
+                plane = GC_GX_VTX_TEX0 + (attr - VTX_TEX0) * 2u;
+                nsrc = 1;
+            }
+
+            for (i = 0; i < nsrc; i++) {
+                const uint32_t len = (nsrc == 3u ? 3u : ncomp) * cs;
+                if (mode == 1u) { src[i] = p; p += len; }
+                else if (mode == 2u) { src[i] = vtx_array_ptr(cp, attr, p[0], len); p += 1; }
+                else { src[i] = vtx_array_ptr(cp, attr, vtx_rd16be(p), len); p += 2; }
+            }
+            for (c = 0; c < ncomp; c++) {
+                const uint8_t *cp_src = nsrc == 3u ? src[c / 3u] + (c % 3u) * cs : src[0] + c * cs;
+                out->f[plane + c][v] = cs ? vtx_ref_comp(cp_src, type, frac) : 0.0f;
+            }
+            if (attr == VTX_POS && !cnt) out->f[GC_GX_VTX_POS + 2u][v] = 0.0f;
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,87 @@
+/*
+ * sdk_port/gx/gx_vtx.h --- Software vertex loader.
+ *
+ * Decodes the vertex data of a GP draw command into structure-of-arrays float
+ * planes, using the CP vertex state the command executes under: VCD (which
+ * attributes, direct or indexed), VAT (component count/type/frac for the
+ * draw's vtxfmt) and the CP array base/stride registers for indexed data.
+ *
+ * Output conventions (match the XF input stage):
+ *   - POS/TEX integer components are scaled by 1/2^frac; F32 ignores frac.
+ *   - NRM/NBT use the fixed hardware scale (U8 /128, S8 /64, U16 /32768,
+ *     S16 /16384).
+ *   - Colors are expanded to 8 bits per channel and normalized to 0..1;
+ *     formats without alpha produce alpha = 1.
+ *   - POS with only XY produces Z = 0. Matrix indices stay raw bytes.
+ *
+ * gc_gx_vtx_decode builds (and caches) a loader per VCD/VAT configuration and
+ * runs it attribute by attribute over all vertices. gc_gx_vtx_decode_ref is
+ * the straightforward per-vertex decoder used as the test oracle.
+ */
+#pragma once
+
+#include <stdint.h>
+
+/* Float planes. */
+#define GC_GX_VTX_POS      0u   /* x, y, z */
+#define GC_GX_VTX_NRM      3u   /* nx, ny, nz, bx, by, bz, tx, ty, tz */
+#define GC_GX_VTX_CLR0     12u  /* r, g, b, a */
+#define GC_GX_VTX_CLR1     16u
+#define GC_GX_VTX_TEX0     20u  /* s, t per coord; TEXn at TEX0 + 2n */
+#define GC_GX_VTX_PLANES   36u
+
+/* Byte planes: PNMTXIDX, TEX0MTXIDX..TEX7MTXIDX. */
+#define GC_GX_VTX_MTX_PLANES 9u
+
+#define GC_GX_VTX_LOADER_CACHE 32
+
+typedef struct {
+    uint32_t count;          /* vertices decoded by the last draw */
+    uint32_t cap;            /* allocated vertices per plane */
+    uint32_t vtxfmt;
+    uint32_t mtx_mask;       /* bit n: mtx[n] written */
+    uint64_t mask;           /* bit n: f[n] written */
+    float *f[GC_GX_VTX_PLANES];
+    uint8_t *mtx[GC_GX_VTX_MTX_PLANES];
+} GcGxVtxBuf;
+
+/* Output of the draw currently executing on gx_gp. */
+extern GcGxVtxBuf gc_gx_vtx;
+
+/* 0 = draws are only counted. Default 1. */
+extern uint32_t gc_gx_vtx_enable;
+
+/* Loader cache counters (reset by gc_gx_vtx_reset). */
+extern uint32_t gc_gx_vtx_loader_hits;
+extern uint32_t gc_gx_vtx_loader_misses;
+extern uint32_t gc_gx_vtx_loader_evictions;
+
+/*
+ * Vertex cache model (GXSetVCacheMetric / GXReadVCacheMetric). Indexed
+ * attribute fetches of gc_gx_vtx_decode go through a cache of 32-byte lines
+ * of array memory, GC_GX_VTX_VC_SETS sets of GC_GX_VTX_VC_WAYS ways with
+ * LRU replacement. Each fetch is one check for its attribute (POS, NRM,
+ * CLR0, CLR1, TEX0..7: the CP array number) and one miss when any line it
+ * spans was absent. GXInvalidateVtxCache empties the cache.
+ */
+#define GC_GX_VTX_VC_ATTRS 12
+#define GC_GX_VTX_VC_SETS  32
+#define GC_GX_VTX_VC_WAYS  4
+
+extern uint32_t gc_gx_vtx_vc_checks[GC_GX_VTX_VC_ATTRS];
+extern uint32_t gc_gx_vtx_vc_misses[GC_GX_VTX_VC_ATTRS];
+
+void gc_gx_vtx_vc_invalidate(void);
+
+void gc_gx_vtx_reset(void);
+
+/*
+ * Decode nverts vertices laid out as in the command stream at data. cp is a
+ * CP register file (e.g. gc_gx_gp.cp). Returns 0 on allocation failure.
+ */
+int gc_gx_vtx_decode(GcGxVtxBuf *out, const uint32_t *cp, uint32_t vtxfmt,
+                     uint32_t nverts, const uint8_t *data);
+int gc_gx_vtx_decode_ref(GcGxVtxBuf *out, const uint32_t *cp, uint32_t vtxfmt,
+                         uint32_t nverts, const uint8_t *data);
+
+void gc_gx_vtx_free(GcGxVtxBuf *buf);
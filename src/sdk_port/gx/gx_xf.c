@@ -0,0 +1,731 @@
+/*
+ * sdk_port/gx/gx_xf.c --- Software XF stage. See gx_xf.h.
+ *
+ * Register/memory layout source of truth: GXTransform.c, GXLight.c and
+ * GXAttr.c (XF writes), plus the XF address map in gx_gp.h:
+ *   0x000..0x0FF  position/texture matrices (3x4, index * 4)
+ *   0x400..0x45F  normal matrices (3x3, index * 3)
+ *   0x500..0x5FF  post-transform texture matrices (3x4)
+ *   0x600..0x67F  lights (16 words: 3 reserved, color, a[3], k[3], pos, dir)
+ *
+ * Lighting follows the hardware model: per channel, lit = ambient + sum of
+ * enabled lights (color * attenuation * diffuse), clamped, times material.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gx_xf.h"
+#include "gx_gp.h"
+
+#ifdef GC_GX_XF_THREADS
+#include <pthread.h>
+#endif
+
+GcGxXfBuf gc_gx_xf;
+uint32_t gc_gx_xf_enable = 1;
+uint32_t gc_gx_xf_threads = 4;
+uint32_t gc_gx_xf_parallel_batches;
+
+typedef struct {
+    float color[4];
+    float a[3];        // angle (cos) attenuation
+    float k[3];        // distance attenuation
+    float pos[3];
+    float dir[3];
+} XfLight;
+
+// XF registers decoded once per draw.
+typedef struct {
+    const uint32_t *mem;
+    uint32_t pos_idx;        // matIdxA[0..5]
+    uint32_t tex_idx[8];     // matIdxA/B texture matrix fields
+    uint32_t ortho;
+    float proj[6];
+    float vp[6];             // scale x, y, z; offset x, y, z
+    uint32_t nchans;
+    uint32_t ntexgens;
+    uint32_t dualtex;
+    uint32_t ctrl[4];        // color0, color1, alpha0, alpha1
+    float amb[2][4];
+    float mat[2][4];
+    XfLight light[8];
+    uint32_t texgen[8];
+    uint32_t post[8];
+} XfSetup;
+
+static inline float xf_u2f(uint32_t u) {
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static inline float xf_memf(const uint32_t *mem, uint32_t addr) {
+    return xf_u2f(mem[addr % GC_GX_XF_MEM_SIZE]);
+}
+
+static void xf_unpack_rgba(uint32_t v, float out[4]) {
+    out[0] = (float)(v >> 24) / 255.0f;
+    out[1] = (float)((v >> 16) & 0xFFu) / 255.0f;
+    out[2] = (float)((v >> 8) & 0xFFu) / 255.0f;
+    out[3] = (float)(v & 0xFFu) / 255.0f;
+}
+
+static void xf_setup(XfSetup *s, const uint32_t *mem, const uint32_t *regs) {
+    uint32_t i, c;
+
+    s->mem = mem;
+    s->pos_idx = regs[0x18] & 63u;
+    for (i = 0; i < 4; i++) s->tex_idx[i] = (regs[0x18] >> (6u + i * 6u)) & 63u;
+    for (i = 4; i < 8; i++) s->tex_idx[i] = (regs[0x19] >> ((i - 4u) * 6u)) & 63u;
+    for (i = 0; i < 6; i++) {
+        s->proj[i] = xf_u2f(regs[0x20 + i]);
+        s->vp[i] = xf_u2f(regs[0x1A + i]);
+    }
+    s->ortho = regs[0x26] & 1u;
+
+    s->nchans = regs[0x09] & 3u;
+    if (s->nchans > 2u) s->nchans = 2u;
+    s->ntexgens = regs[0x3F] & 15u;
+    if (s->ntexgens > 8u) s->ntexgens = 8u;
+    s->dualtex = regs[0x12] & 1u;
+
+    for (c = 0; c < 2; c++) {
+        xf_unpack_rgba(regs[0x0A + c], s->amb[c]);
+        xf_unpack_rgba(regs[0x0C + c], s->mat[c]);
+    }
+    for (c = 0; c < 4; c++) s->ctrl[c] = regs[0x0E + c];
+
+    for (i = 0; i < 8; i++) {
+        const uint32_t base = 0x600u + i * 16u;
+        XfLight *l = &s->light[i];
+        xf_unpack_rgba(mem[base + 3u], l->color);
+        for (c = 0; c < 3; c++) {
+            l->a[c] = xf_memf(mem, base + 4u + c);
+            l->k[c] = xf_memf(mem, base + 7u + c);
+            l->pos[c] = xf_memf(mem, base + 10u + c);
+            l->dir[c] = xf_memf(mem, base + 13u + c);
+        }
+    }
+    for (i = 0; i < 8; i++) {
+        s->texgen[i] = regs[0x40 + i];
+        s->post[i] = regs[0x50 + i];
+    }
+}
+
+// Chan ctrl light mask: lights 0..3 at bits 2..5, lights 4..7 at bits 11..14.
+static inline uint32_t xf_light_mask(uint32_t ctrl) {
+    return ((ctrl >> 2) & 0xFu) | (((ctrl >> 11) & 0xFu) << 4);
+}
+
+// Reciprocal square root without libm: bit-trick estimate refined by three
+// Newton steps. Returns 0 for x <= 0 (zero-length vectors stay zero).
+static inline float xf_rsqrt1(float x) {
+    int32_t i;
+    float y;
+    if (!(x > 0.0f)) return 0.0f;
+    memcpy(&i, &x, sizeof(i));
+    i = 0x5F3759DF - (i >> 1);
+    memcpy(&y, &i, sizeof(y));
+    y = y * (1.5f - 0.5f * x * y * y);
+    y = y * (1.5f - 0.5f * x * y * y);
+    y = y * (1.5f - 0.5f * x * y * y);
+    return y;
+}
+
+static int xf_reserve(GcGxXfBuf *out, uint32_t n) {
+    uint32_t cap, i;
+    if (n <= out->cap) return 1;
+    cap = out->cap ? out->cap : 64u;
+    while (cap < n) cap *= 2u;
+    for (i = 0; i < GC_GX_XF_PLANES; i++) {
+        float *p = (float *)realloc(out->f[i], cap * sizeof(float));
+        if (!p) return 0;
+        out->f[i] = p;
+    }
+    out->cap = cap;
+    return 1;
+}
+
+void gc_gx_xf_free(GcGxXfBuf *buf) {
+    uint32_t i;
+    for (i = 0; i < GC_GX_XF_PLANES; i++) free(buf->f[i]);
+    memset(buf, 0, sizeof(*buf));
+}
+
+static uint64_t xf_out_mask(const XfSetup *s, const GcGxVtxBuf *in) {
+    uint64_t mask = 0;
+    uint32_t c;
+    if ((in->mask >> GC_GX_VTX_POS) & 1u) mask |= (uint64_t)0x3FFu << GC_GX_XF_EYE;
+    if ((in->mask >> GC_GX_VTX_NRM) & 1u) mask |= (uint64_t)0x7u << GC_GX_XF_NRM;
+    for (c = 0; c < s->nchans; c++) mask |= (uint64_t)0xFu << (GC_GX_XF_CLR0 + c * 4u);
+    for (c = 0; c < s->ntexgens; c++) mask |= (uint64_t)0x7u << (GC_GX_XF_TEX0 + c * 3u);
+    return mask;
+}
+
+// -----------------------------------------------------------------------------
+// Batched path
+//
+// xf_vf holds XF_LANES consecutive vertices. With GCC/Clang vector extensions
+// that is four floats per op; other compilers run the same code one vertex at
+// a time. Output planes are allocated in multiples of four vertices, so the
+// last group may write (and read) past count without leaving the buffers.
+// -----------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined(__clang__)
+typedef float xf_vf __attribute__((vector_size(16)));
+typedef int32_t xf_vi __attribute__((vector_size(16)));
+#define XF_LANES 4u
+static inline xf_vf xf_splat(float x) {
+    const xf_vf v = { x, x, x, x };
+    return v;
+}
+static inline xf_vf xf_sel(xf_vi m, xf_vf a, xf_vf b) {
+    return (xf_vf)(((xf_vi)a & m) | ((xf_vi)b & ~m));
+}
+static inline xf_vf xf_rsqrt(xf_vf x) {
+    const xf_vf h = xf_splat(0.5f), t = xf_splat(1.5f);
+    const xf_vi magic = { 0x5F3759DF, 0x5F3759DF, 0x5F3759DF, 0x5F3759DF };
+    xf_vi i;
+    xf_vf y;
+    memcpy(&i, &x, sizeof(i));
+    i = magic - (i >> 1);
+    memcpy(&y, &i, sizeof(y));
+    y = y * (t - h * x * y * y);
+    y = y * (t - h * x * y * y);
+    y = y * (t - h * x * y * y);
+    return xf_sel(x > xf_splat(0.0f), y, xf_splat(0.0f));
+}
+#else
+typedef float xf_vf;
+typedef int32_t xf_vi;
+#define XF_LANES 1u
+static inline xf_vf xf_splat(float x) { return x; }
+static inline xf_vf xf_sel(xf_vi m, xf_vf a, xf_vf b) { return m ? a : b; }
+static inline xf_vf xf_rsqrt(xf_vf x) { return xf_rsqrt1(x); }
+#endif
+
+static inline xf_vf xf_ld(const float *p) {
+    xf_vf v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void xf_st(float *p, xf_vf v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+static inline xf_vf xf_max0(xf_vf x) {
+    const xf_vf z = xf_splat(0.0f);
+    return xf_sel(x > z, x, z);
+}
+
+static inline xf_vf xf_dot3(const xf_vf a[3], const xf_vf b[3]) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// n / d, or 0 where d == 0.
+static inline xf_vf xf_div0(xf_vf n, xf_vf d) {
+    const xf_vf z = xf_splat(0.0f);
+    const xf_vf q = n / xf_sel(d != z, d, xf_splat(1.0f));
+    return xf_sel(d != z, q, z);
+}
+
+static inline xf_vf xf_in(const GcGxVtxBuf *in, uint32_t plane, uint32_t i, float dflt) {
+    return ((in->mask >> plane) & 1u) ? xf_ld(in->f[plane] + i) : xf_splat(dflt);
+}
+
+// n matrix words for the XF_LANES vertices at i: row address is base + idx *
+// scale with idx from the vertex's matrix index plane, or def without one.
+static void xf_mtx(const uint32_t *mem, const uint8_t *idx, uint32_t def, uint32_t i,
+                   uint32_t base, uint32_t scale, uint32_t imask, uint32_t n, xf_vf *m) {
+    float lane[XF_LANES];
+    uint32_t addr[XF_LANES];
+    uint32_t l, e;
+    for (l = 0; l < XF_LANES; l++) {
+        addr[l] = base + ((idx ? idx[i + l] : def) & imask) * scale;
+    }
+    for (e = 0; e < n; e++) {
+        for (l = 0; l < XF_LANES; l++) lane[l] = xf_memf(mem, addr[l] + e);
+        m[e] = xf_ld(lane);
+    }
+}
+
+// Attenuation * diffuse term of one light (chan ctrl attn/diffuse fields).
+static xf_vf xf_light_term(const XfLight *l, uint32_t ctrl,
+                           const xf_vf eye[3], const xf_vf nrm[3]) {
+    const uint32_t attn_fn = (ctrl >> 9) & 3u;  // 0 none, 1 spec, 2 dir, 3 spot
+    const uint32_t diff_fn = (ctrl >> 7) & 3u;  // 0 none, 1 sign, 2 clamp
+    xf_vf ldir[3], att, d;
+    uint32_t c;
+
+    if (attn_fn == 1u) {
+        // Specular: pos holds a direction, dir the half-angle vector.
+        const float r = xf_rsqrt1(l->pos[0] * l->pos[0] + l->pos[1] * l->pos[1] +
+                                  l->pos[2] * l->pos[2]);
+        xf_vf half[3], nl, nh, cs, ds;
+        for (c = 0; c < 3; c++) {
+            ldir[c] = xf_splat(l->pos[c] * r);
+            half[c] = xf_splat(l->dir[c]);
+        }
+        nl = xf_dot3(ldir, nrm);
+        nh = xf_sel(nl >= xf_splat(0.0f), xf_max0(xf_dot3(half, nrm)), xf_splat(0.0f));
+        cs = xf_splat(l->a[0]) + xf_splat(l->a[1]) * nh + xf_splat(l->a[2]) * nh * nh;
+        ds = xf_splat(l->k[0]) + xf_splat(l->k[1]) * nh + xf_splat(l->k[2]) * nh * nh;
+        att = xf_div0(xf_max0(cs), ds);
+    } else {
+        xf_vf v[3], d2, r;
+        for (c = 0; c < 3; c++) v[c] = xf_splat(l->pos[c]) - eye[c];
+        d2 = xf_dot3(v, v);
+        r = xf_rsqrt(d2);
+        for (c = 0; c < 3; c++) ldir[c] = v[c] * r;
+        if (attn_fn == 3u) {
+            xf_vf spot[3], ca, cs, ds;
+            const xf_vf dist = d2 * r;
+            for (c = 0; c < 3; c++) spot[c] = xf_splat(l->dir[c]);
+            ca = xf_max0(xf_dot3(ldir, spot));
+            cs = xf_splat(l->a[0]) + xf_splat(l->a[1]) * ca + xf_splat(l->a[2]) * ca * ca;
+            ds = xf_splat(l->k[0]) + xf_splat(l->k[1]) * dist + xf_splat(l->k[2]) * d2;
+            att = xf_div0(xf_max0(cs), ds);
+        } else {
+            att = xf_splat(1.0f);
+        }
+    }
+
+    if (diff_fn == 0u) return att;
+    d = xf_dot3(ldir, nrm);
+    return diff_fn == 1u ? att * d : att * xf_max0(d);
+}
+
+// One color (comp 0..2) or alpha (comp 3) pass of channel c.
+static void xf_light_pass(const XfSetup *s, uint32_t c, uint32_t alpha,
+                          const xf_vf vclr[4], const xf_vf eye[3], const xf_vf nrm[3],
+                          xf_vf *res) {
+    const uint32_t ctrl = s->ctrl[c + (alpha ? 2u : 0u)];
+    const uint32_t k0 = alpha ? 3u : 0u, k1 = alpha ? 4u : 3u;
+    xf_vf lit[4];
+    uint32_t k, n, lm;
+
+    for (k = k0; k < k1; k++) {
+        res[k] = (ctrl & 1u) ? vclr[k] : xf_splat(s->mat[c][k]);
+    }
+    if (!(ctrl & 2u)) return;
+
+    for (k = k0; k < k1; k++) {
+        lit[k] = (ctrl & 0x40u) ? vclr[k] : xf_splat(s->amb[c][k]);
+    }
+    lm = xf_light_mask(ctrl);
+    for (n = 0; n < 8; n++) {
+        xf_vf t;
+        if (!((lm >> n) & 1u)) continue;
+        t = xf_light_term(&s->light[n], ctrl, eye, nrm);
+        for (k = k0; k < k1; k++) lit[k] = lit[k] + t * xf_splat(s->light[n].color[k]);
+    }
+    for (k = k0; k < k1; k++) {
+        const xf_vf v = xf_max0(lit[k]);
+        res[k] = res[k] * xf_sel(v > xf_splat(1.0f), xf_splat(1.0f), v);
+    }
+}
+
+static void xf_run_range(const XfSetup *s, const GcGxVtxBuf *in, GcGxXfBuf *out,
+                         uint32_t begin, uint32_t end) {
+    const uint8_t *pidx = (in->mtx_mask & 1u) ? in->mtx[0] : NULL;
+    const int has_nrm = (int)((in->mask >> GC_GX_VTX_NRM) & 1u);
+    xf_vf pm[12], nm[9];
+    uint32_t i, c, n;
+
+    if (!pidx) {
+        xf_mtx(s->mem, NULL, s->pos_idx, 0, 0x000u, 4u, 63u, 12u, pm);
+        xf_mtx(s->mem, NULL, s->pos_idx, 0, 0x400u, 3u, 31u, 9u, nm);
+    }
+
+    for (i = begin; i < end; i += XF_LANES) {
+        xf_vf pos[3], eye[3], nrm[3], clip[4], vclr[2][4], clr[2][4], inv;
+
+        if (pidx) {
+            xf_mtx(s->mem, pidx, 0, i, 0x000u, 4u, 63u, 12u, pm);
+            xf_mtx(s->mem, pidx, 0, i, 0x400u, 3u, 31u, 9u, nm);
+        }
+
+        for (c = 0; c < 3; c++) pos[c] = xf_in(in, GC_GX_VTX_POS + c, i, 0.0f);
+        for (c = 0; c < 3; c++) {
+            eye[c] = pm[c * 4u] * pos[0] + pm[c * 4u + 1u] * pos[1] +
+                     pm[c * 4u + 2u] * pos[2] + pm[c * 4u + 3u];
+            xf_st(out->f[GC_GX_XF_EYE + c] + i, eye[c]);
+        }
+
+        if (s->ortho) {
+            clip[0] = xf_splat(s->proj[0]) * eye[0] + xf_splat(s->proj[1]);
+            clip[1] = xf_splat(s->proj[2]) * eye[1] + xf_splat(s->proj[3]);
+            clip[3] = xf_splat(1.0f);
+        } else {
+            clip[0] = xf_splat(s->proj[0]) * eye[0] + xf_splat(s->proj[1]) * eye[2];
+            clip[1] = xf_splat(s->proj[2]) * eye[1] + xf_splat(s->proj[3]) * eye[2];
+            clip[3] = -eye[2];
+        }
+        clip[2] = xf_splat(s->proj[4]) * eye[2] + xf_splat(s->proj[5]);
+        inv = xf_splat(1.0f) / clip[3];
+        for (c = 0; c < 4; c++) xf_st(out->f[GC_GX_XF_CLIP + c] + i, clip[c]);
+        for (c = 0; c < 3; c++) {
+            xf_st(out->f[GC_GX_XF_WIN + c] + i,
+                  clip[c] * inv * xf_splat(s->vp[c]) + xf_splat(s->vp[3u + c]));
+        }
+
+        for (c = 0; c < 3; c++) pos[c] = xf_in(in, GC_GX_VTX_NRM + c, i, 0.0f);
+        for (c = 0; c < 3; c++) {
+            nrm[c] = nm[c * 3u] * pos[0] + nm[c * 3u + 1u] * pos[1] + nm[c * 3u + 2u] * pos[2];
+        }
+        {
+            const xf_vf r = xf_rsqrt(xf_dot3(nrm, nrm));
+            for (c = 0; c < 3; c++) nrm[c] = nrm[c] * r;
+        }
+        if (has_nrm) {
+            for (c = 0; c < 3; c++) xf_st(out->f[GC_GX_XF_NRM + c] + i, nrm[c]);
+        }
+
+        for (n = 0; n < s->nchans; n++) {
+            for (c = 0; c < 4; c++) {
+                vclr[n][c] = xf_in(in, (n ? GC_GX_VTX_CLR1 : GC_GX_VTX_CLR0) + c, i, 1.0f);
+            }
+            xf_light_pass(s, n, 0, vclr[n], eye, nrm, clr[n]);
+            xf_light_pass(s, n, 1, vclr[n], eye, nrm, clr[n]);
+            for (c = 0; c < 4; c++) xf_st(out->f[GC_GX_XF_CLR0 + n * 4u + c] + i, clr[n][c]);
+        }
+
+        for (n = 0; n < s->ntexgens; n++) {
+            const uint32_t reg = s->texgen[n];
+            const uint32_t type = (reg >> 4) & 7u;
+            float *const *o = out->f + GC_GX_XF_TEX0 + n * 3u;
+            xf_vf st[3];
+
+            st[0] = st[1] = xf_splat(0.0f);
+            st[2] = xf_splat(1.0f);
+            if (type == 0u) {
+                const uint32_t row = (reg >> 7) & 31u;
+                const uint8_t *tidx = ((in->mtx_mask >> (1u + n)) & 1u) ? in->mtx[1u + n] : NULL;
+                xf_vf src[3], tm[12];
+                if (row <= 4u && row != 2u) {
+                    static const uint8_t k_row_plane[5] = {
+                        GC_GX_VTX_POS, GC_GX_VTX_NRM, 0, GC_GX_VTX_NRM + 3u, GC_GX_VTX_NRM + 6u,
+                    };
+                    for (c = 0; c < 3; c++) src[c] = xf_in(in, k_row_plane[row] + c, i, 0.0f);
+                } else if (row == 2u) {
+                    for (c = 0; c < 3; c++) src[c] = xf_in(in, GC_GX_VTX_CLR0 + c, i, 1.0f);
+                } else if (row <= 12u) {
+                    const uint32_t tp = GC_GX_VTX_TEX0 + (row - 5u) * 2u;
+                    src[0] = xf_in(in, tp, i, 0.0f);
+                    src[1] = xf_in(in, tp + 1u, i, 0.0f);
+                    src[2] = xf_splat(1.0f);
+                } else {
+                    src[0] = src[1] = src[2] = xf_splat(0.0f);
+                }
+                if (!((reg >> 2) & 1u)) src[2] = xf_splat(1.0f);  // AB11
+
+                xf_mtx(s->mem, tidx, s->tex_idx[n], i, 0x000u, 4u, 63u, 12u, tm);
+                for (c = 0; c < ((reg >> 1) & 1u ? 3u : 2u); c++) {
+                    st[c] = tm[c * 4u] * src[0] + tm[c * 4u + 1u] * src[1] +
+                            tm[c * 4u + 2u] * src[2] + tm[c * 4u + 3u];
+                }
+                if (s->dualtex) {
+                    const uint32_t post = s->post[n];
+                    xf_vf q[3];
+                    if ((post >> 8) & 1u) {
+                        const xf_vf r = xf_rsqrt(xf_dot3(st, st));
+                        for (c = 0; c < 3; c++) st[c] = st[c] * r;
+                    }
+                    xf_mtx(s->mem, NULL, post & 63u, 0, 0x500u, 4u, 63u, 12u, tm);
+                    for (c = 0; c < 3; c++) {
+                        q[c] = tm[c * 4u] * st[0] + tm[c * 4u + 1u] * st[1] +
+                               tm[c * 4u + 2u] * st[2] + tm[c * 4u + 3u];
+                    }
+                    for (c = 0; c < 3; c++) st[c] = q[c];
+                }
+            } else if (type == 1u) {
+                // Emboss: offset an earlier texgen by the light direction
+                // projected onto the eye-space binormal/tangent.
+                const uint32_t src = (reg >> 12) & 7u;
+                const XfLight *l = &s->light[(reg >> 15) & 7u];
+                xf_vf v[3], b[3], t[3], raw[6], r;
+                for (c = 0; c < 3; c++) v[c] = xf_splat(l->pos[c]) - eye[c];
+                r = xf_rsqrt(xf_dot3(v, v));
+                for (c = 0; c < 3; c++) v[c] = v[c] * r;
+                for (c = 0; c < 6; c++) raw[c] = xf_in(in, GC_GX_VTX_NRM + 3u + c, i, 0.0f);
+                for (c = 0; c < 3; c++) {
+                    b[c] = nm[c * 3u] * raw[0] + nm[c * 3u + 1u] * raw[1] + nm[c * 3u + 2u] * raw[2];
+                    t[c] = nm[c * 3u] * raw[3] + nm[c * 3u + 1u] * raw[4] + nm[c * 3u + 2u] * raw[5];
+                }
+                if (src < n) {
+                    st[0] = xf_ld(out->f[GC_GX_XF_TEX0 + src * 3u] + i);
+                    st[1] = xf_ld(out->f[GC_GX_XF_TEX0 + src * 3u + 1u] + i);
+                }
+                st[0] = st[0] + xf_dot3(v, b);
+                st[1] = st[1] + xf_dot3(v, t);
+            } else if (type == 2u || type == 3u) {
+                // Color texgen: s, t from the lit channel's red and green.
+                const uint32_t ch = type - 2u;
+                if (ch < s->nchans) {
+                    st[0] = clr[ch][0];
+                    st[1] = clr[ch][1];
+                }
+            }
+            for (c = 0; c < 3; c++) xf_st(o[c] + i, st[c]);
+        }
+    }
+}
+
+#ifdef GC_GX_XF_THREADS
+typedef struct {
+    const XfSetup *s;
+    const GcGxVtxBuf *in;
+    GcGxXfBuf *out;
+    uint32_t begin;
+    uint32_t end;
+} XfChunk;
+
+static void *xf_worker(void *arg) {
+    const XfChunk *ch = (const XfChunk *)arg;
+    xf_run_range(ch->s, ch->in, ch->out, ch->begin, ch->end);
+    return NULL;
+}
+
+// Split [0, n) into lane-aligned chunks; the caller runs the last one.
+static int xf_run_parallel(const XfSetup *s, const GcGxVtxBuf *in, GcGxXfBuf *out,
+                           uint32_t n, uint32_t nthreads) {
+    pthread_t tid[GC_GX_XF_MAX_THREADS];
+    XfChunk ch[GC_GX_XF_MAX_THREADS];
+    uint32_t per = (n + nthreads - 1u) / nthreads;
+    uint32_t t, started = 0, begin = 0;
+
+    per = (per + XF_LANES - 1u) / XF_LANES * XF_LANES;
+    for (t = 0; t < nthreads && begin < n; t++) {
+        ch[t].s = s;
+        ch[t].in = in;
+        ch[t].out = out;
+        ch[t].begin = begin;
+        ch[t].end = begin + per < n ? begin + per : n;
+        begin = ch[t].end;
+    }
+    nthreads = t;
+    for (t = 0; t + 1u < nthreads; t++) {
+        if (pthread_create(&tid[t], NULL, xf_worker, &ch[t]) != 0) break;
+        started++;
+    }
+    // Chunks whose thread did not start run here.
+    for (t = started; t < nthreads; t++) xf_worker(&ch[t]);
+    for (t = 0; t < started; t++) pthread_join(tid[t], NULL);
+    return started != 0;
+}
+#endif
+
+int gc_gx_xf_run(GcGxXfBuf *out, const GcGxVtxBuf *in,
+                 const uint32_t *xf_mem, const uint32_t *xf_regs) {
+    const uint32_t n = in->count;
+    XfSetup s;
+
+    if (!xf_reserve(out, n)) return 0;
+    xf_setup(&s, xf_mem, xf_regs);
+    out->count = n;
+    out->nchans = s.nchans;
+    out->ntexgens = s.ntexgens;
+    out->mask = xf_out_mask(&s, in);
+
+#ifdef GC_GX_XF_THREADS
+    if (gc_gx_xf_threads > 1u && n >= GC_GX_XF_PAR_MIN) {
+        const uint32_t nt = gc_gx_xf_threads < GC_GX_XF_MAX_THREADS ? gc_gx_xf_threads
+                                                                     : GC_GX_XF_MAX_THREADS;
+        if (xf_run_parallel(&s, in, out, n, nt)) gc_gx_xf_parallel_batches++;
+        return 1;
+    }
+#endif
+    xf_run_range(&s, in, out, 0, n);
+    return 1;
+}
+
+// -----------------------------------------------------------------------------
+// Reference: one vertex at a time, straight from the register fields.
+// -----------------------------------------------------------------------------
+
+static float xf_ref_in(const GcGxVtxBuf *in, uint32_t plane, uint32_t v, float dflt) {
+    return ((in->mask >> plane) & 1u) ? in->f[plane][v] : dflt;
+}
+
+static float xf_ref_max0(float x) {
+    return x > 0.0f ? x : 0.0f;
+}
+
+static float xf_ref_div0(float n, float d) {
+    return d != 0.0f ? n / d : 0.0f;
+}
+
+static float xf_ref_dot(const float *a, const float *b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// out = M(3 x cols at addr) * (x, y, z[, 1])
+static void xf_ref_xform(const uint32_t *mem, uint32_t addr, uint32_t rows, int affine,
+                         const float *x, float *out) {
+    uint32_t r;
+    const uint32_t cols = affine ? 4u : 3u;
+    for (r = 0; r < rows; r++) {
+        const uint32_t a = addr + r * cols;
+        out[r] = xf_memf(mem, a) * x[0] + xf_memf(mem, a + 1u) * x[1] + xf_memf(mem, a + 2u) * x[2];
+        if (affine) out[r] = out[r] + xf_memf(mem, a + 3u);
+    }
+}
+
+static float xf_ref_light(const XfLight *l, uint32_t ctrl, const float *eye, const float *nrm) {
+    const uint32_t attn_fn = (ctrl >> 9) & 3u;
+    const uint32_t diff_fn = (ctrl >> 7) & 3u;
+    float ldir[3], att, d;
+    uint32_t c;
+
+    if (attn_fn == 1u) {
+        const float r = xf_rsqrt1(xf_ref_dot(l->pos, l->pos));
+        float nh;
+        for (c = 0; c < 3; c++) ldir[c] = l->pos[c] * r;
+        nh = xf_ref_dot(ldir, nrm) >= 0.0f ? xf_ref_max0(xf_ref_dot(l->dir, nrm)) : 0.0f;
+        att = xf_ref_div0(xf_ref_max0(l->a[0] + l->a[1] * nh + l->a[2] * nh * nh),
+                          l->k[0] + l->k[1] * nh + l->k[2] * nh * nh);
+    } else {
+        float v[3], d2, r;
+        for (c = 0; c < 3; c++) v[c] = l->pos[c] - eye[c];
+        d2 = xf_ref_dot(v, v);
+        r = xf_rsqrt1(d2);
+        for (c = 0; c < 3; c++) ldir[c] = v[c] * r;
+        if (attn_fn == 3u) {
+            const float dist = d2 * r;
+            const float ca = xf_ref_max0(xf_ref_dot(ldir, l->dir));
+            att = xf_ref_div0(xf_ref_max0(l->a[0] + l->a[1] * ca + l->a[2] * ca * ca),
+                              l->k[0] + l->k[1] * dist + l->k[2] * d2);
+        } else {
+            att = 1.0f;
+        }
+    }
+    if (diff_fn == 0u) return att;
+    d = xf_ref_dot(ldir, nrm);
+    return diff_fn == 1u ? att * d : att * xf_ref_max0(d);
+}
+
+int gc_gx_xf_run_ref(GcGxXfBuf *out, const GcGxVtxBuf *in,
+                     const uint32_t *xf_mem, const uint32_t *xf_regs) {
+    const uint32_t n = in->count;
+    XfSetup s;
+    uint32_t v, c, k, t, li;
+
+    if (!xf_reserve(out, n)) return 0;
+    xf_setup(&s, xf_mem, xf_regs);
+    out->count = n;
+    out->nchans = s.nchans;
+    out->ntexgens = s.ntexgens;
+    out->mask = xf_out_mask(&s, in);
+
+    for (v = 0; v < n; v++) {
+        const uint32_t pidx = (in->mtx_mask & 1u) ? (in->mtx[0][v] & 63u) : s.pos_idx;
+        float pos[3], eye[3], raw[3], nrm[3], clip[4], clr[2][4], r;
+
+        for (c = 0; c < 3; c++) pos[c] = xf_ref_in(in, GC_GX_VTX_POS + c, v, 0.0f);
+        xf_ref_xform(xf_mem, pidx * 4u, 3, 1, pos, eye);
+        for (c = 0; c < 3; c++) out->f[GC_GX_XF_EYE + c][v] = eye[c];
+
+        if (s.ortho) {
+            clip[0] = s.proj[0] * eye[0] + s.proj[1];
+            clip[1] = s.proj[2] * eye[1] + s.proj[3];
+            clip[3] = 1.0f;
+        } else {
+            clip[0] = s.proj[0] * eye[0] + s.proj[1] * eye[2];
+            clip[1] = s.proj[2] * eye[1] + s.proj[3] * eye[2];
+            clip[3] = -eye[2];
+        }
+        clip[2] = s.proj[4] * eye[2] + s.proj[5];
+        for (c = 0; c < 4; c++) out->f[GC_GX_XF_CLIP + c][v] = clip[c];
+        for (c = 0; c < 3; c++) {
+            out->f[GC_GX_XF_WIN + c][v] = clip[c] * (1.0f / clip[3]) * s.vp[c] + s.vp[3u + c];
+        }
+
+        for (c = 0; c < 3; c++) raw[c] = xf_ref_in(in, GC_GX_VTX_NRM + c, v, 0.0f);
+        xf_ref_xform(xf_mem, 0x400u + (pidx & 31u) * 3u, 3, 0, raw, nrm);
+        r = xf_rsqrt1(xf_ref_dot(nrm, nrm));
+        for (c = 0; c < 3; c++) nrm[c] = nrm[c] * r;
+        if ((in->mask >> GC_GX_VTX_NRM) & 1u) {
+            for (c = 0; c < 3; c++) out->f[GC_GX_XF_NRM + c][v] = nrm[c];
+        }
+
+        for (c = 0; c < s.nchans; c++) {
+            const uint32_t vp = c ? GC_GX_VTX_CLR1 : GC_GX_VTX_CLR0;
+            for (k = 0; k < 4; k++) {
+                const uint32_t ctrl = s.ctrl[c + (k == 3u ? 2u : 0u)];
+                const float vc = xf_ref_in(in, vp + k, v, 1.0f);
+                float mat = (ctrl & 1u) ? vc : s.mat[c][k];
+                if (ctrl & 2u) {
+                    const uint32_t lm = xf_light_mask(ctrl);
+                    float lit = (ctrl & 0x40u) ? vc : s.amb[c][k];
+                    for (li = 0; li < 8; li++) {
+                        if ((lm >> li) & 1u) {
+                            lit = lit + xf_ref_light(&s.light[li], ctrl, eye, nrm) * s.light[li].color[k];
+                        }
+                    }
+                    lit = xf_ref_max0(lit);
+                    mat = mat * (lit > 1.0f ? 1.0f : lit);
+                }
+                clr[c][k] = mat;
+                out->f[GC_GX_XF_CLR0 + c * 4u + k][v] = mat;
+            }
+        }
+
+        for (t = 0; t < s.ntexgens; t++) {
+            const uint32_t reg = s.texgen[t];
+            const uint32_t type = (reg >> 4) & 7u;
+            float st[3] = { 0.0f, 0.0f, 1.0f };
+
+            if (type == 0u) {
+                const uint32_t row = (reg >> 7) & 31u;
+                const uint32_t midx = ((in->mtx_mask >> (1u + t)) & 1u) ? (in->mtx[1u + t][v] & 63u)
+                                                                      : s.tex_idx[t];
+                float src[3] = { 0.0f, 0.0f, 0.0f };
+                if (row == 0u || row == 1u || row == 3u || row == 4u) {
+                    const uint32_t p = row == 0u ? GC_GX_VTX_POS : GC_GX_VTX_NRM + (row == 1u ? 0u : (row - 2u) * 3u);
+                    for (c = 0; c < 3; c++) src[c] = xf_ref_in(in, p + c, v, 0.0f);
+                } else if (row == 2u) {
+                    for (c = 0; c < 3; c++) src[c] = xf_ref_in(in, GC_GX_VTX_CLR0 + c, v, 1.0f);
+                } else if (row <= 12u) {
+                    src[0] = xf_ref_in(in, GC_GX_VTX_TEX0 + (row - 5u) * 2u, v, 0.0f);
+                    src[1] = xf_ref_in(in, GC_GX_VTX_TEX0 + (row - 5u) * 2u + 1u, v, 0.0f);
+                }
+                if (!((reg >> 2) & 1u) || (row >= 5u && row <= 12u)) src[2] = 1.0f;
+                xf_ref_xform(xf_mem, midx * 4u, (reg >> 1) & 1u ? 3u : 2u, 1, src, st);
+                if (s.dualtex) {
+                    float q[3];
+                    if ((s.post[t] >> 8) & 1u) {
+                        r = xf_rsqrt1(xf_ref_dot(st, st));
+                        for (c = 0; c < 3; c++) st[c] = st[c] * r;
+                    }
+                    xf_ref_xform(xf_mem, 0x500u + (s.post[t] & 63u) * 4u, 3, 1, st, q);
+                    for (c = 0; c < 3; c++) st[c] = q[c];
+                }
+            } else if (type == 1u) {
+                const uint32_t src = (reg >> 12) & 7u;
+                const XfLight *l = &s.light[(reg >> 15) & 7u];
+                float ld[3], b[3], tg[3], rb[3], rt[3];
+                for (c = 0; c < 3; c++) ld[c] = l->pos[c] - eye[c];
+                r = xf_rsqrt1(xf_ref_dot(ld, ld));
+                for (c = 0; c < 3; c++) {
+                    ld[c] = ld[c] * r;
+                    rb[c] = xf_ref_in(in, GC_GX_VTX_NRM + 3u + c, v, 0.0f);
+                    rt[c] = xf_ref_in(in, GC_GX_VTX_NRM + 6u + c, v, 0.0f);
+                }
+                xf_ref_xform(xf_mem, 0x400u + (pidx & 31u) * 3u, 3, 0, rb, b);
+                xf_ref_xform(xf_mem, 0x400u + (pidx & 31u) * 3u, 3, 0, rt, tg);
+                if (src < t) {
+                    st[0] = out->f[GC_GX_XF_TEX0 + src * 3u][v];
+                    st[1] = out->f[GC_GX_XF_TEX0 + src * 3u + 1u][v];
+                }
+                st[0] = st[0] + xf_ref_dot(ld, b);
+                st[1] = st[1] + xf_ref_dot(ld, tg);
+            } else if ((type == 2u || type == 3u) && type - 2u < s.nchans) {
+                st[0] = clr[type - 2u][0];
+                st[1] = clr[type - 2u][1];
+            }
+            for (c = 0; c < 3; c++) out->f[GC_GX_XF_TEX0 + t * 3u + c][v] = st[c];
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,76 @@
+/*
+ * sdk_port/gx/gx_xf.h --- Software XF stage (transform, lighting, texgen).
+ *
+ * Runs over the SoA output of the vertex loader (gx_vtx.h) using the XF
+ * matrix/light memory and XF registers the draw executes under (gc_gx_gp):
+ *
+ *   - POS by the position matrix (matIdxA or the vertex PNMTXIDX), then the
+ *     projection (XF 0x20..0x26) and viewport (XF 0x1A..0x1F).
+ *   - NRM by the normal matrix at 0x400 + (pnmtx & 31) * 3, renormalized.
+ *   - XF 0x09 color channels: material/ambient select, up to 8 lights with
+ *     diffuse function and spot/specular attenuation (XF 0x0E..0x11).
+ *   - XF 0x3F texgens: regular (2x4/3x4 matrix, optional normalize + post
+ *     matrix when XF 0x12 enables dual texture transform), emboss, color.
+ *
+ * Output conventions:
+ *   - Window x/y keep the hardware +342 offset; z is in the 24-bit range.
+ *   - Colors are 0..1. A missing vertex color reads as 1, a missing normal
+ *     or texcoord as 0.
+ *   - Texgens always produce s, t, q; 2x4 texgens have q = 1.
+ *
+ * gc_gx_xf_run processes four vertices per vector op. Builds that define
+ * GC_GX_XF_THREADS (and link pthreads) also split batches of at least
+ * GC_GX_XF_PAR_MIN vertices into chunks across gc_gx_xf_threads threads.
+ * gc_gx_xf_run_ref is the per-vertex scalar version used as the test oracle.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "gx_vtx.h"
+
+/* Float planes. */
+#define GC_GX_XF_EYE     0u   /* x, y, z after the position matrix */
+#define GC_GX_XF_CLIP    3u   /* x, y, z, w */
+#define GC_GX_XF_WIN     7u   /* x, y, z after divide + viewport */
+#define GC_GX_XF_NRM     10u  /* eye-space normal */
+#define GC_GX_XF_CLR0    13u  /* r, g, b, a */
+#define GC_GX_XF_CLR1    17u
+#define GC_GX_XF_TEX0    21u  /* s, t, q per texgen; TEXn at TEX0 + 3n */
+#define GC_GX_XF_PLANES  45u
+
+#define GC_GX_XF_PAR_MIN     4096u
+#define GC_GX_XF_MAX_THREADS 8u
+
+typedef struct {
+    uint32_t count;          /* vertices transformed by the last draw */
+    uint32_t cap;            /* allocated vertices per plane */
+    uint32_t nchans;
+    uint32_t ntexgens;
+    uint64_t mask;           /* bit n: f[n] written */
+    float *f[GC_GX_XF_PLANES];
+} GcGxXfBuf;
+
+/* Output of the draw currently executing on gx_gp. */
+extern GcGxXfBuf gc_gx_xf;
+
+/* 0 = draws stop after the vertex loader. Default 1. */
+extern uint32_t gc_gx_xf_enable;
+
+/* Worker count for large batches (GC_GX_XF_THREADS builds only). Default 4. */
+extern uint32_t gc_gx_xf_threads;
+
+/* Batches that were split across threads. */
+extern uint32_t gc_gx_xf_parallel_batches;
+
+/*
+ * Transform in->count vertices. xf_mem/xf_regs are an XF memory and register
+ * file (e.g. gc_gx_gp.xf_mem / gc_gx_gp.xf_regs). Returns 0 on allocation
+ * failure.
+ */
+int gc_gx_xf_run(GcGxXfBuf *out, const GcGxVtxBuf *in,
+                 const uint32_t *xf_mem, const uint32_t *xf_regs);
+int gc_gx_xf_run_ref(GcGxXfBuf *out, const GcGxVtxBuf *in,
+                     const uint32_t *xf_mem, const uint32_t *xf_regs);
+
+void gc_gx_xf_free(GcGxXfBuf *buf);
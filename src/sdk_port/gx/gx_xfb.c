@@ -0,0 +1,376 @@
+/*
+ * sdk_port/gx/gx_xfb.c --- EFB to XFB display copy.
+ *
+ * See gx_xfb.h. Each output line depends only on three EFB lines, so lines
+ * are converted independently: in chunks by worker threads when enabled.
+ */
+#include <stdint.h>
+#include <string.h>
+#include "gx_xfb.h"
+#include "../gc_mem.h"
+
+#ifdef GC_GX_XFB_THREADS
+#include <pthread.h>
+#endif
+
+uint32_t gc_gx_xfb_copies;
+uint32_t gc_gx_xfb_pixels;
+uint32_t gc_gx_xfb_bytes;
+uint32_t gc_gx_xfb_parallel_copies;
+uint32_t gc_gx_xfb_threads = 4u;
+
+typedef uint32_t xfb_u4 __attribute__((vector_size(16)));
+
+#define XFB_W GC_GX_EFB_WIDTH
+#define XFB_H GC_GX_EFB_HEIGHT
+
+// Output lines per work item, and the smallest copy worth splitting.
+#define XFB_CHUNK    16u
+#define XFB_PAR_MIN  64u
+
+// round(255 * (v / 255) ^ (1 / gamma)) for GX_GM_1_7 and GX_GM_2_2.
+static const uint8_t k_xfb_gamma[2][256] = {
+    {
+          0,  10,  15,  19,  22,  25,  28,  31,  33,  36,  38,  40,  42,  44,  46,  48,
+         50,  52,  54,  55,  57,  59,  60,  62,  64,  65,  67,  68,  70,  71,  72,  74,
+         75,  77,  78,  79,  81,  82,  83,  84,  86,  87,  88,  89,  91,  92,  93,  94,
+         95,  97,  98,  99, 100, 101, 102, 103, 105, 106, 107, 108, 109, 110, 111, 112,
+        113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 128,
+        129, 130, 131, 132, 133, 134, 135, 135, 136, 137, 138, 139, 140, 141, 142, 143,
+        144, 144, 145, 146, 147, 148, 149, 150, 150, 151, 152, 153, 154, 155, 156, 156,
+        157, 158, 159, 160, 160, 161, 162, 163, 164, 164, 165, 166, 167, 168, 168, 169,
+        170, 171, 172, 172, 173, 174, 175, 175, 176, 177, 178, 178, 179, 180, 181, 181,
+        182, 183, 184, 184, 185, 186, 187, 187, 188, 189, 190, 190, 191, 192, 192, 193,
+        194, 195, 195, 196, 197, 197, 198, 199, 199, 200, 201, 202, 202, 203, 204, 204,
+        205, 206, 206, 207, 208, 208, 209, 210, 210, 211, 212, 212, 213, 214, 214, 215,
+        216, 216, 217, 218, 218, 219, 220, 220, 221, 222, 222, 223, 224, 224, 225, 226,
+        226, 227, 227, 228, 229, 229, 230, 231, 231, 232, 233, 233, 234, 234, 235, 236,
+        236, 237, 238, 238, 239, 239, 240, 241, 241, 242, 242, 243, 244, 244, 245, 245,
+        246, 247, 247, 248, 248, 249, 250, 250, 251, 251, 252, 253, 253, 254, 254, 255,
+    },
+    {
+          0,  21,  28,  34,  39,  43,  46,  50,  53,  56,  59,  61,  64,  66,  68,  70,
+         72,  74,  76,  78,  80,  82,  84,  85,  87,  89,  90,  92,  93,  95,  96,  98,
+         99, 101, 102, 103, 105, 106, 107, 109, 110, 111, 112, 114, 115, 116, 117, 118,
+        119, 120, 122, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135,
+        136, 137, 138, 139, 140, 141, 142, 143, 144, 144, 145, 146, 147, 148, 149, 150,
+        151, 151, 152, 153, 154, 155, 156, 156, 157, 158, 159, 160, 160, 161, 162, 163,
+        164, 164, 165, 166, 167, 167, 168, 169, 170, 170, 171, 172, 173, 173, 174, 175,
+        175, 176, 177, 178, 178, 179, 180, 180, 181, 182, 182, 183, 184, 184, 185, 186,
+        186, 187, 188, 188, 189, 190, 190, 191, 192, 192, 193, 194, 194, 195, 195, 196,
+        197, 197, 198, 199, 199, 200, 200, 201, 202, 202, 203, 203, 204, 205, 205, 206,
+        206, 207, 207, 208, 209, 209, 210, 210, 211, 212, 212, 213, 213, 214, 214, 215,
+        215, 216, 217, 217, 218, 218, 219, 219, 220, 220, 221, 221, 222, 223, 223, 224,
+        224, 225, 225, 226, 226, 227, 227, 228, 228, 229, 229, 230, 230, 231, 231, 232,
+        232, 233, 233, 234, 234, 235, 235, 236, 236, 237, 237, 238, 238, 239, 239, 240,
+        240, 241, 241, 242, 242, 243, 243, 244, 244, 245, 245, 246, 246, 247, 247, 248,
+        248, 249, 249, 249, 250, 250, 251, 251, 252, 252, 253, 253, 254, 254, 255, 255,
+    },
+};
+
+// Per-copy constants shared by every line.
+typedef struct {
+    const uint32_t *color;
+    uint8_t *dst;
+    uint32_t x0, x1, y0, y1;    // source rectangle clamped to the EFB, inclusive
+    uint32_t w, stride, yscale, lines, clamp;
+    uint32_t cp, cc, cn;        // filter weights for the line above/at/below
+    int narrow;                 // cp + cc + cn <= 257: 16-bit lanes suffice
+    const uint8_t *gamma;       // NULL for 1.0
+} XfbJob;
+
+static inline uint32_t xfb_min(uint32_t a, uint32_t b) { return a < b ? a : b; }
+
+uint32_t gc_gx_xfb_size(const GcGxXfbCopy *c) {
+    const uint32_t line = ((c->w + 1u) >> 1) * 4u;
+    if (!c->w || !c->h || !c->lines || c->stride < line) return 0;
+    return c->stride * (c->lines - 1u) + line;
+}
+
+static int xfb_job(XfbJob *j, uint8_t *dst, const GcGxEfb *efb, const GcGxXfbCopy *c) {
+    const uint8_t *f = c->vfilter;
+    if (!efb->color || c->x >= XFB_W || c->y >= XFB_H || !gc_gx_xfb_size(c)) return 0;
+    j->color = efb->color;
+    j->dst = dst;
+    j->x0 = c->x;
+    j->y0 = c->y;
+    j->x1 = xfb_min(c->x + c->w - 1u, XFB_W - 1u);
+    j->y1 = xfb_min(c->y + c->h - 1u, XFB_H - 1u);
+    j->w = c->w;
+    j->stride = c->stride;
+    j->yscale = c->yscale;
+    j->lines = c->lines;
+    j->clamp = c->clamp;
+    j->cp = (f[0] & 0x3Fu) + (f[1] & 0x3Fu);
+    j->cc = (f[2] & 0x3Fu) + (f[3] & 0x3Fu) + (f[4] & 0x3Fu);
+    j->cn = (f[5] & 0x3Fu) + (f[6] & 0x3Fu);
+    j->narrow = j->cp + j->cc + j->cn <= 257u;
+    j->gamma = c->gamma == 1u ? k_xfb_gamma[0] : c->gamma == 2u ? k_xfb_gamma[1] : NULL;
+    return 1;
+}
+
+// EFB rows feeding output line i: above, at, below.
+static void xfb_rows(const XfbJob *j, uint32_t i, uint32_t *ya, uint32_t *ym, uint32_t *yb) {
+    const uint32_t y = xfb_min(j->y0 + ((i * j->yscale) >> 8), j->y1);
+    const uint32_t top = (j->clamp & 1u) ? j->y0 : 0u;
+    const uint32_t bottom = (j->clamp & 2u) ? j->y1 : XFB_H - 1u;
+    *ym = y;
+    *ya = y > top ? y - 1u : top;
+    *yb = y < bottom ? y + 1u : bottom;
+}
+
+// ---- Reference path: one pixel at a time ----
+
+static void xfb_pixel_ref(const XfbJob *j, uint32_t ya, uint32_t ym, uint32_t yb, uint32_t x,
+                          uint32_t rgb[3]) {
+    const uint32_t xs = xfb_min(j->x0 + x, j->x1);
+    const uint32_t pa = j->color[ya * XFB_W + xs];
+    const uint32_t pm = j->color[ym * XFB_W + xs];
+    const uint32_t pb = j->color[yb * XFB_W + xs];
+    uint32_t ch;
+    for (ch = 0; ch < 3u; ch++) {
+        const uint32_t sh = 24u - ch * 8u;
+        uint32_t v = (j->cp * ((pa >> sh) & 0xFFu) + j->cc * ((pm >> sh) & 0xFFu) +
+                      j->cn * ((pb >> sh) & 0xFFu)) >> 6;
+        if (v > 255u) v = 255u;
+        rgb[ch] = j->gamma ? j->gamma[v] : v;
+    }
+}
+
+int gc_gx_xfb_copy_ref(uint8_t *dst, const GcGxEfb *efb, const GcGxXfbCopy *c) {
+    XfbJob j;
+    uint32_t i, x;
+
+    if (!xfb_job(&j, dst, efb, c)) return 0;
+    for (i = 0; i < j.lines; i++) {
+        uint32_t ya, ym, yb;
+        uint8_t *o = dst + i * j.stride;
+        xfb_rows(&j, i, &ya, &ym, &yb);
+        for (x = 0; x < j.w; x += 2u, o += 4) {
+            uint32_t p0[3], p1[3], r, g, b;
+            xfb_pixel_ref(&j, ya, ym, yb, x, p0);
+            xfb_pixel_ref(&j, ya, ym, yb, x + 1u, p1);
+            r = (p0[0] + p1[0] + 1u) >> 1;
+            g = (p0[1] + p1[1] + 1u) >> 1;
+            b = (p0[2] + p1[2] + 1u) >> 1;
+            o[0] = (uint8_t)(((66u * p0[0] + 129u * p0[1] + 25u * p0[2] + 128u) >> 8) + 16u);
+            o[1] = (uint8_t)((112u * b + 32896u - 38u * r - 74u * g) >> 8);
+            o[2] = (uint8_t)(((66u * p1[0] + 129u * p1[1] + 25u * p1[2] + 128u) >> 8) + 16u);
+            o[3] = (uint8_t)((112u * r + 32896u - 94u * g - 18u * b) >> 8);
+        }
+    }
+    return 1;
+}
+
+// ---- Vector path: four pixels (two YUYV pairs) at a time ----
+//
+// A pixel splits into two 16-bit lane pairs, (B, R) = (p >> 8) & 0x00FF00FF
+// and (A, G) = p & 0x00FF00FF, so the filter and the YUV products run as
+// 16-bit multiplies on eight lanes. That holds while the filter weights sum
+// to at most 257 (255 * 257 = 0xFFFF); heavier filters use 32-bit lanes.
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define XFB_LH(lo, hi) hi, lo
+#define XFB_G_LANE 0u
+#else
+#define XFB_LH(lo, hi) lo, hi
+#define XFB_G_LANE 1u
+#endif
+#define XFB_LH4(lo, hi) XFB_LH(lo, hi), XFB_LH(lo, hi), XFB_LH(lo, hi), XFB_LH(lo, hi)
+
+typedef uint16_t xfb_h8 __attribute__((vector_size(16)));
+
+static inline xfb_u4 xfb_ld4(const uint32_t *row, uint32_t x, uint32_t x1) {
+    xfb_u4 v;
+    if (x + 3u <= x1) {
+        memcpy(&v, row + x, sizeof(v));
+    } else {
+        v = (xfb_u4){ row[xfb_min(x, x1)], row[xfb_min(x + 1u, x1)], row[xfb_min(x + 2u, x1)],
+                      row[xfb_min(x + 3u, x1)] };
+    }
+    return v;
+}
+
+static inline xfb_h8 xfb_filter8(xfb_h8 a, xfb_h8 m, xfb_h8 b, xfb_h8 wp, xfb_h8 wc, xfb_h8 wn) {
+    const xfb_h8 v = (a * wp + m * wc + b * wn) >> 6;
+    return ((xfb_h8)(v > 255u) & 255u) | ((xfb_h8)(v <= 255u) & v);
+}
+
+static inline xfb_u4 xfb_filter4(const XfbJob *j, xfb_u4 a, xfb_u4 m, xfb_u4 b, uint32_t sh) {
+    xfb_u4 v = (j->cp * ((a >> sh) & 0xFFu) + j->cc * ((m >> sh) & 0xFFu) +
+                j->cn * ((b >> sh) & 0xFFu)) >> 6;
+    v = ((xfb_u4)(v > 255u) & 255u) | ((xfb_u4)(v <= 255u) & v);
+    if (j->gamma) {
+        v = (xfb_u4){ j->gamma[v[0]], j->gamma[v[1]], j->gamma[v[2]], j->gamma[v[3]] };
+    }
+    return v;
+}
+
+// Store lanes 0 (and 2) of Y0 | U << 8 | Y1 << 16 | V << 24.
+static inline uint8_t *xfb_store(uint8_t *o, xfb_u4 yuyv, int both) {
+    uint32_t k;
+    for (k = 0; k < (both ? 3u : 1u); k += 2u, o += 4) {
+        o[0] = (uint8_t)yuyv[k];
+        o[1] = (uint8_t)(yuyv[k] >> 8);
+        o[2] = (uint8_t)(yuyv[k] >> 16);
+        o[3] = (uint8_t)(yuyv[k] >> 24);
+    }
+    return o;
+}
+
+// 16-bit lanes. Called with gamma NULL or the table so each case compiles
+// without the other's branch.
+static inline void xfb_line16(const XfbJob *j, uint32_t i, const uint8_t *gamma) {
+    const xfb_u4 swap = { 1, 0, 3, 2 };
+    const xfb_h8 k_y_br = { XFB_LH4(25, 66) }, k_y_ag = { XFB_LH4(0, 129) };
+    const xfb_h8 k_u_br = { XFB_LH4(112, 38) }, k_u_ag = { XFB_LH4(0, 74) };
+    const xfb_h8 k_v_br = { XFB_LH4(18, 112) }, k_v_ag = { XFB_LH4(0, 94) };
+    const xfb_h8 zero = { 0 };
+    const xfb_h8 wp = zero + (uint16_t)j->cp, wc = zero + (uint16_t)j->cc, wn = zero + (uint16_t)j->cn;
+    const uint32_t x0 = j->x0, x1 = j->x1, w = j->w;
+    uint32_t ya, ym, yb, x, k;
+    const uint32_t *ra, *rm, *rb;
+    uint8_t *o = j->dst + i * j->stride;
+
+    xfb_rows(j, i, &ya, &ym, &yb);
+    ra = j->color + ya * XFB_W;
+    rm = j->color + ym * XFB_W;
+    rb = j->color + yb * XFB_W;
+    for (x = 0; x < w; x += 4u) {
+        const xfb_u4 pa = xfb_ld4(ra, x0 + x, x1), pm = xfb_ld4(rm, x0 + x, x1);
+        const xfb_u4 pb = xfb_ld4(rb, x0 + x, x1);
+        xfb_h8 br = xfb_filter8((xfb_h8)((pa >> 8) & 0x00FF00FFu), (xfb_h8)((pm >> 8) & 0x00FF00FFu),
+                                (xfb_h8)((pb >> 8) & 0x00FF00FFu), wp, wc, wn);
+        xfb_h8 ag = xfb_filter8((xfb_h8)(pa & 0x00FF00FFu), (xfb_h8)(pm & 0x00FF00FFu),
+                                (xfb_h8)(pb & 0x00FF00FFu), wp, wc, wn);
+        xfb_h8 br2, ag2;
+        xfb_u4 ty, tu, tu_g, tv, tv_g, y, u, v;
+        if (gamma) {
+            for (k = 0; k < 8u; k++) br[k] = gamma[br[k]];
+            for (k = XFB_G_LANE; k < 8u; k += 2u) ag[k] = gamma[ag[k]];
+        }
+        // Pair averages land in lanes 0 and 2.
+        br2 = (br + (xfb_h8)__builtin_shuffle((xfb_u4)br, swap) + 1u) >> 1;
+        ag2 = (ag + (xfb_h8)__builtin_shuffle((xfb_u4)ag, swap) + 1u) >> 1;
+        ty = (xfb_u4)(br * k_y_br + ag * k_y_ag);
+        tu = (xfb_u4)(br2 * k_u_br);
+        tu_g = (xfb_u4)(ag2 * k_u_ag);
+        tv = (xfb_u4)(br2 * k_v_br);
+        tv_g = (xfb_u4)(ag2 * k_v_ag);
+        y = (((ty >> 16) + (ty & 0xFFFFu) + 128u) >> 8) + 16u;
+        u = ((tu & 0xFFFFu) + 32896u - (tu >> 16) - (tu_g >> 16)) >> 8;
+        v = ((tv >> 16) + 32896u - (tv & 0xFFFFu) - (tv_g >> 16)) >> 8;
+        o = xfb_store(o, y | (u << 8) | (__builtin_shuffle(y, swap) << 16) | (v << 24), x + 2u < w);
+    }
+}
+
+// 32-bit lanes, one channel per vector.
+static void xfb_line32(const XfbJob *j, uint32_t i) {
+    const xfb_u4 swap = { 1, 0, 3, 2 };
+    uint32_t ya, ym, yb, x;
+    const uint32_t *ra, *rm, *rb;
+    uint8_t *o = j->dst + i * j->stride;
+
+    xfb_rows(j, i, &ya, &ym, &yb);
+    ra = j->color + ya * XFB_W;
+    rm = j->color + ym * XFB_W;
+    rb = j->color + yb * XFB_W;
+    for (x = 0; x < j->w; x += 4u) {
+        const uint32_t xs = j->x0 + x;
+        const xfb_u4 pa = xfb_ld4(ra, xs, j->x1), pm = xfb_ld4(rm, xs, j->x1);
+        const xfb_u4 pb = xfb_ld4(rb, xs, j->x1);
+        const xfb_u4 r = xfb_filter4(j, pa, pm, pb, 24u);
+        const xfb_u4 g = xfb_filter4(j, pa, pm, pb, 16u);
+        const xfb_u4 b = xfb_filter4(j, pa, pm, pb, 8u);
+        const xfb_u4 r2 = (r + __builtin_shuffle(r, swap) + 1u) >> 1;
+        const xfb_u4 g2 = (g + __builtin_shuffle(g, swap) + 1u) >> 1;
+        const xfb_u4 b2 = (b + __builtin_shuffle(b, swap) + 1u) >> 1;
+        const xfb_u4 y = ((66u * r + 129u * g + 25u * b + 128u) >> 8) + 16u;
+        const xfb_u4 u = (112u * b2 + 32896u - 38u * r2 - 74u * g2) >> 8;
+        const xfb_u4 v = (112u * r2 + 32896u - 94u * g2 - 18u * b2) >> 8;
+        o = xfb_store(o, y | (u << 8) | (__builtin_shuffle(y, swap) << 16) | (v << 24), x + 2u < j->w);
+    }
+}
+
+static void xfb_line(const XfbJob *j, uint32_t i) {
+    if (!j->narrow) xfb_line32(j, i);
+    else if (j->gamma) xfb_line16(j, i, j->gamma);
+    else xfb_line16(j, i, NULL);
+}
+
+#ifdef GC_GX_XFB_THREADS
+typedef struct {
+    const XfbJob *job;
+    uint32_t *next;
+} XfbWorker;
+
+static void *xfb_worker(void *arg) {
+    const XfbWorker *w = (const XfbWorker *)arg;
+    uint32_t first, i;
+    while ((first = __atomic_fetch_add(w->next, XFB_CHUNK, __ATOMIC_RELAXED)) < w->job->lines) {
+        const uint32_t end = xfb_min(first + XFB_CHUNK, w->job->lines);
+        for (i = first; i < end; i++) xfb_line(w->job, i);
+    }
+    return NULL;
+}
+
+// Workers pull line chunks off a shared counter; the caller works too.
+static int xfb_copy_parallel(const XfbJob *j, uint32_t nthreads) {
+    pthread_t tid[GC_GX_XFB_MAX_THREADS];
+    XfbWorker w = { j, NULL };
+    uint32_t next = 0, t, started = 0;
+
+    w.next = &next;
+    for (t = 1; t < nthreads; t++) {
+        if (pthread_create(&tid[started], NULL, xfb_worker, &w) != 0) break;
+        started++;
+    }
+    xfb_worker(&w);
+    for (t = 0; t < started; t++) pthread_join(tid[t], NULL);
+    return started != 0;
+}
+#endif
+
+static int xfb_copy(uint8_t *dst, const GcGxEfb *efb, const GcGxXfbCopy *c, int *parallel) {
+    XfbJob j;
+    uint32_t i;
+
+    *parallel = 0;
+    if (!xfb_job(&j, dst, efb, c)) return 0;
+#ifdef GC_GX_XFB_THREADS
+    if (gc_gx_xfb_threads > 1u && j.lines >= XFB_PAR_MIN) {
+        const uint32_t nt = xfb_min(gc_gx_xfb_threads, GC_GX_XFB_MAX_THREADS);
+        *parallel = xfb_copy_parallel(&j, nt);
+        return 1;
+    }
+#endif
+    for (i = 0; i < j.lines; i++) xfb_line(&j, i);
+    return 1;
+}
+
+int gc_gx_xfb_copy(uint8_t *dst, const GcGxEfb *efb, const GcGxXfbCopy *c) {
+    int parallel;
+    return xfb_copy(dst, efb, c, &parallel);
+}
+
+void gc_gx_xfb_run(const GcGxEfb *efb, const GcGxXfbCopy *c, uint32_t addr) {
+    const uint32_t size = gc_gx_xfb_size(c);
+    uint8_t *dst = size ? gc_mem_ptr(addr, size) : NULL;
+    int parallel;
+
+    if (!dst || !xfb_copy(dst, efb, c, &parallel)) return;
+    gc_gx_xfb_copies++;
+    gc_gx_xfb_pixels += c->w * c->h;
+    gc_gx_xfb_bytes += size;
+    if (parallel) gc_gx_xfb_parallel_copies++;
+    if (gc_gx_gp_mem_hook) gc_gx_gp_mem_hook(addr, size, 1);
+    gc_mem_notify_write(addr, size);
+}
+
+void gc_gx_xfb_display_copy(const GcGxXfbCopy *c, uint32_t addr, uint32_t clear, uint32_t clear_rgba,
+                            uint32_t clear_z) {
+    gc_gx_raster_flush();
+    if (!gc_gx_efb.color) return;
+    gc_gx_xfb_run(&gc_gx_efb, c, addr);
+    if (clear) gc_gx_raster_clear_rect(&gc_gx_efb, c->x, c->y, c->w, c->h, clear_rgba, clear_z);
+}
@@ -0,0 +1,73 @@
+/*
+ * sdk_port/gx/gx_xfb.h --- EFB to XFB display copy (GXCopyDisp).
+ *
+ * Converts an EFB rectangle into the YUYV external framebuffer the video
+ * interface scans out: Y0 U Y1 V per pixel pair, BT.601 studio range, the
+ * chroma of a pair taken from the average of its two pixels.
+ *
+ * Per output line the copy:
+ *   - picks source line y + (line * yscale >> 8) (GXSetDispCopyYScale);
+ *   - applies the 7-tap vertical filter of GXSetCopyFilter, taps 0..1 on
+ *     the line above, 2..4 on the line itself and 5..6 on the line below
+ *     (6-bit coefficients, a sum of 64 is unity, result clamped to 255).
+ *     Neighbours outside the rectangle clamp to its edge when GXSetCopyClamp
+ *     sets the top/bottom bit, otherwise to the EFB edge;
+ *   - applies the GXSetDispCopyGamma curve (1.0, 1.7 or 2.2);
+ *   - converts RGB to YUV 4:2:2.
+ *
+ * The EFB keeps one sample per pixel, so the AA sample pattern selects
+ * among identical samples and has no effect here.
+ *
+ * gc_gx_xfb_copy converts four pixels per vector operation and, in builds
+ * that define GC_GX_XFB_THREADS (and link pthreads), splits the output
+ * lines across gc_gx_xfb_threads threads; gc_gx_xfb_copy_ref converts one
+ * pixel at a time and is the test oracle.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "gx_raster.h"
+
+#define GC_GX_XFB_MAX_THREADS  8u
+
+typedef struct {
+    uint32_t x, y, w, h;      /* EFB source rectangle */
+    uint32_t stride;          /* XFB bytes per line */
+    uint32_t yscale;          /* source step per output line, 8.8 (0x100 = 1:1) */
+    uint32_t lines;           /* output lines */
+    uint8_t vfilter[7];
+    uint32_t gamma;           /* 0 = 1.0, 1 = 1.7, 2 = 2.2 */
+    uint32_t clamp;           /* bit 0 top, bit 1 bottom */
+} GcGxXfbCopy;
+
+/* Display copies written by gc_gx_xfb_run, and how many ran on threads. */
+extern uint32_t gc_gx_xfb_copies;
+extern uint32_t gc_gx_xfb_parallel_copies;
+
+/* EFB source rectangle pixels and RAM bytes of those copies. */
+extern uint32_t gc_gx_xfb_pixels;
+extern uint32_t gc_gx_xfb_bytes;
+
+/* Worker count (GC_GX_XFB_THREADS builds only). Default 4. */
+extern uint32_t gc_gx_xfb_threads;
+
+/* Bytes the copy spans in RAM: stride * (lines - 1) plus one line. 0 if invalid. */
+uint32_t gc_gx_xfb_size(const GcGxXfbCopy *c);
+
+/*
+ * Convert into dst (gc_gx_xfb_size bytes). Returns 0 if the rectangle
+ * starts outside the EFB or a line does not fit in the stride.
+ */
+int gc_gx_xfb_copy(uint8_t *dst, const GcGxEfb *efb, const GcGxXfbCopy *c);
+int gc_gx_xfb_copy_ref(uint8_t *dst, const GcGxEfb *efb, const GcGxXfbCopy *c);
+
+/* Convert into RAM at GC address addr and report the write. */
+void gc_gx_xfb_run(const GcGxEfb *efb, const GcGxXfbCopy *c, uint32_t addr);
+
+/*
+ * GXCopyDisp once its registers are decoded: shade the pending bins, copy
+ * gc_gx_efb to addr and, with clear, fill the rectangle with clear_rgba /
+ * clear_z. Nothing happens while the EFB has not been allocated.
+ */
+void gc_gx_xfb_display_copy(const GcGxXfbCopy *c, uint32_t addr, uint32_t clear, uint32_t clear_rgba,
+                            uint32_t clear_z);
@@ -0,0 +1,136 @@
+/*
+ * sdk_port/gx/gx_z16.c --- Batch Z16 compression and decompression.
+ *
+ * See gx_z16.h. Each loop handles four values per vector operation; the
+ * n % 4 tail goes through a padded vector.
+ */
+#include <stdint.h>
+#include <string.h>
+#include "gx_z16.h"
+
+typedef uint32_t z16_u4 __attribute__((vector_size(16)));
+typedef int32_t z16_i4 __attribute__((vector_size(16)));
+typedef float z16_f4 __attribute__((vector_size(16)));
+
+// Floating formats: exponent cap, mantissa shift below the cap (base - exp),
+// mantissa shift at the cap, mantissa bits. Index is zfmt - 1.
+typedef struct {
+    uint32_t max, base, smax, mbits;
+} Z16Fmt;
+
+static const Z16Fmt k_z16_fmt[3] = {
+    { 3, 9, 7, 14 },    // GX_ZC_NEAR
+    { 7, 10, 4, 13 },   // GX_ZC_MID
+    { 12, 11, 0, 12 },  // GX_ZC_FAR
+};
+
+static inline z16_u4 z16_blend(z16_u4 mask, z16_u4 a, z16_u4 b) {
+    return (a & mask) | (b & ~mask);
+}
+
+// 2^e for -126 <= e <= 127, as an integer: 0 for negative e.
+static inline z16_u4 z16_pow2(z16_u4 e) {
+    const z16_f4 f = (z16_f4)((e + 127u) << 23);
+    return (z16_u4)__builtin_convertvector(f, z16_i4);
+}
+
+// Leading one bits of a 24-bit value (24 for 0xFFFFFF). ~z converts to a
+// float exactly; its exponent is the index of the highest clear bit of z.
+static inline z16_u4 z16_lead_ones(z16_u4 z) {
+    const z16_f4 f = __builtin_convertvector((z16_i4)(~z & 0xFFFFFFu), z16_f4);
+    return 150u - ((z16_u4)f >> 23);
+}
+
+typedef uint16_t z16_h4 __attribute__((vector_size(8)));
+
+// Format constants for one call. Shift counts stay scalar: a shift by a
+// vector of counts has no SSE2 instruction and would be split per lane.
+typedef struct {
+    z16_u4 max, base, mmask;
+    uint32_t shift_base, smax, mbits;
+} Z16Vec;
+
+static inline Z16Vec z16_vec(uint32_t zfmt) {
+    const Z16Fmt *f = &k_z16_fmt[zfmt - 1u];
+    const z16_u4 zero = { 0 };
+    Z16Vec v;
+    v.max = zero + f->max;
+    v.base = zero + f->base;
+    v.shift_base = f->base;
+    v.smax = f->smax;
+    v.mbits = f->mbits;
+    v.mmask = zero + ((1u << f->mbits) - 1u);
+    return v;
+}
+
+static inline z16_u4 z16_compress4(z16_u4 z, uint32_t zfmt, const Z16Vec *f) {
+    z16_u4 e, top;
+
+    z &= 0xFFFFFFu;
+    if (zfmt == 0u) return z >> 8;
+    e = z16_lead_ones(z);
+    e = z16_blend((z16_u4)(e < f->max), e, f->max);
+    // Below the cap the mantissa starts base - e bits up: (z << e) >> base.
+    top = z16_blend((z16_u4)(e == f->max), z >> f->smax, (z * z16_pow2(e)) >> f->shift_base);
+    return (top & f->mmask) | (e << f->mbits);
+}
+
+static inline z16_u4 z16_decompress4(z16_u4 z, uint32_t zfmt, const Z16Vec *f) {
+    z16_u4 e, m, ones, body;
+
+    if (zfmt == 0u) return (z << 8) & 0xFFFF00u;
+    e = z >> f->mbits;
+    m = z & f->mmask;
+    // e leading ones, then the mantissa at base - e (shifted out past the cap).
+    ones = 0x1000000u - z16_pow2(24u - e);
+    body = z16_blend((z16_u4)(e == f->max), m << f->smax, m * z16_pow2(f->base - e));
+    return (ones | body) & 0xFFFFFFu;
+}
+
+void gc_gx_z16_compress(uint16_t *dst, const uint32_t *src, uint32_t n, uint32_t zfmt) {
+    Z16Vec f;
+    uint32_t i, k;
+    z16_u4 v;
+    z16_h4 h;
+
+    if (zfmt > 3u) {
+        memset(dst, 0, n * sizeof(*dst));
+        return;
+    }
+    if (zfmt) f = z16_vec(zfmt);
+    for (i = 0; i + 4u <= n; i += 4u) {
+        memcpy(&v, src + i, sizeof(v));
+        h = __builtin_convertvector(z16_compress4(v, zfmt, &f), z16_h4);
+        memcpy(dst + i, &h, sizeof(h));
+    }
+    if (i < n) {
+        v = (z16_u4){ 0 };
+        for (k = 0; i + k < n; k++) v[k] = src[i + k];
+        v = z16_compress4(v, zfmt, &f);
+        for (k = 0; i + k < n; k++) dst[i + k] = (uint16_t)v[k];
+    }
+}
+
+void gc_gx_z16_decompress(uint32_t *dst, const uint16_t *src, uint32_t n, uint32_t zfmt) {
+    Z16Vec f;
+    uint32_t i, k;
+    z16_u4 v;
+    z16_h4 h;
+
+    if (zfmt > 3u) {
+        memset(dst, 0, n * sizeof(*dst));
+        return;
+    }
+    if (zfmt) f = z16_vec(zfmt);
+    for (i = 0; i + 4u <= n; i += 4u) {
+        memcpy(&h, src + i, sizeof(h));
+        v = z16_decompress4(__builtin_convertvector(h, z16_u4), zfmt, &f);
+        memcpy(dst + i, &v, sizeof(v));
+    }
+    if (i < n) {
+        v = (z16_u4){ 0 };
+        for (k = 0; i + k < n; k++) v[k] = src[i + k];
+        v = z16_decompress4(v, zfmt, &f);
+        for (k = 0; i + k < n; k++) dst[i + k] = v[k];
+    }
+}
@@ -0,0 +1,26 @@
+/*
+ * sdk_port/gx/gx_z16.h --- Batch GXCompressZ16 / GXDecompressZ16.
+ *
+ * Whole-buffer versions of the scalar functions in GX.c, for Z buffers
+ * being copied or read back in a 16-bit Z format. zfmt is GX_ZC_LINEAR (0),
+ * GX_ZC_NEAR (1), GX_ZC_MID (2) or GX_ZC_FAR (3); other values produce 0
+ * like the scalar functions.
+ *
+ * The floating formats store the count of leading one bits of the 24-bit Z
+ * (capped at 3, 7 or 12) as an exponent above a mantissa. The count is
+ * taken four values at a time from the float exponent of ~z (the int to
+ * float conversion is exact below 2^24), and the per-value shifts become
+ * multiplies by powers of two built the same way.
+ *
+ * Results are bit-exact with GXCompressZ16 / GXDecompressZ16 for every
+ * input, including FAR exponents 13..15 that no compressor produces.
+ */
+#pragma once
+
+#include <stdint.h>
+
+/* dst[i] = GXCompressZ16(src[i], zfmt). Bits above bit 23 are ignored. */
+void gc_gx_z16_compress(uint16_t *dst, const uint32_t *src, uint32_t n, uint32_t zfmt);
+
+/* dst[i] = GXDecompressZ16(src[i], zfmt). */
+void gc_gx_z16_decompress(uint32_t *dst, const uint16_t *src, uint32_t n, uint32_t zfmt);
@@ -5,11 +5,19 @@
  *
  * Same logic as decomp InsertAlarm / OSSetAlarm / OSSetPeriodicAlarm /
  * OSCancelAlarm / DecrementerExceptionCallback (modeled as FireHead).
+ * InsertAlarm finds its insertion point through a host-side index of the
+ * queue (see "Alarm index" below) instead of walking it.
+ * port_OSAlarmAttachClock hands the queue to the virtual clock, which then
+ * drives systemTime and fires alarms as it reaches them.
  * Alarm structs live in gc_mem (big-endian). Hardware interaction
  * (SetTimer, interrupts, PPCMtdec) is stripped.
  */
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 #include "OSAlarm.h"
+#include "../gc_clock.h"
+#include "../gc_treap.h"
 #include "../gc_mem.h"
 
 /* ── Big-endian u32 helpers ── */
@@ -45,6 +53,323 @@ static inline void store_s64be(uint32_t addr, int64_t val)
     store_u32be(addr + 4, (uint32_t)(val & 0xFFFFFFFFu));
 }
 
+/* ── Alarm index ──
+ *
+ * The queue is a doubly linked list in fire-time order; an alarm set for
+ * the same tick as queued ones goes behind them. InsertAlarm's scan for
+ * the first later alarm makes OSSetAlarm, and each re-arm of a periodic
+ * alarm, linear in the queue length. A host-side treap (gc_treap.h) keyed
+ * by (fire time, insertion number) reproduces that order and answers the
+ * scan in O(log n); a hash from alarm address to node lets OSCancelAlarm
+ * and FireHead unlink by address.
+ *
+ * Only next_a comes from the index: the list stores are the SDK's. Before
+ * InsertAlarm uses the answer it checks RAM, where the chosen alarm must
+ * still hold its indexed fire time and follow a predecessor that fires no
+ * later than the new alarm. If that check fails, or queueHead / queueTail
+ * moved without going through this file, the index is refilled by walking
+ * the list once. A list with broken prev links or out of fire-time order
+ * keeps the SDK scan. GC_OSALARM_LINEAR compiles the index out.
+ */
+
+#ifdef GC_OSALARM_LINEAR
+enum { ALARM_INDEX_ENABLED = 0 };
+#else
+enum { ALARM_INDEX_ENABLED = 1 };
+#endif
+enum { ALARM_INDEX_MAX = 1 << 22 };
+
+/* Queue order is fire time, then insertion order among equal times; seq
+ * numbers insertions so the treap sorts exactly like the list. */
+typedef struct {
+    int64_t  fire;
+    uint64_t seq;
+    uint32_t alarm;
+    gc_treap_link link;
+} AlarmNode;
+
+typedef struct {
+    const port_OSAlarmState *st; /* queue mirrored; NULL = not synced */
+    uint32_t   head;             /* st->queueHead / queueTail as last seen */
+    uint32_t   tail;
+    int32_t    root;
+    uint32_t   count;
+    uint64_t   seq;
+    AlarmNode *nodes;
+    int32_t    cap;
+    int32_t    used;
+    int32_t    spare;            /* recycled nodes, chained through .link.left */
+    int32_t   *slots;            /* alarm address -> node + 1 (linear probing) */
+    uint32_t   mask;
+} AlarmIndex;
+
+static AlarmIndex s_alarm_index;
+
+uint32_t gc_os_alarm_index_rebuilds;
+
+typedef struct {
+    int64_t  fire;
+    uint64_t seq;
+} AlarmKey;
+
+static int ai_before(const void *node, const void *key)
+{
+    const AlarmNode *n = (const AlarmNode *)node;
+    const AlarmKey *k = (const AlarmKey *)key;
+    return n->fire < k->fire || (n->fire == k->fire && n->seq < k->seq);
+}
+
+static gc_treap ai_treap(AlarmIndex *ix)
+{
+    const gc_treap tr = {(uint8_t *)ix->nodes, sizeof(AlarmNode),
+                         offsetof(AlarmNode, link), ai_before, NULL};
+    return tr;
+}
+
+static uint32_t ai_slot(uint32_t alarm, uint32_t mask)
+{
+    uint32_t h = (alarm >> 3) * 0x9E3779B1u;
+    return (h ^ (h >> 16)) & mask;
+}
+
+/* Node of alarm, or -1. */
+static int32_t ai_lookup(const AlarmIndex *ix, uint32_t alarm)
+{
+    uint32_t i;
+
+    if (!ix->slots) return -1;
+    for (i = ai_slot(alarm, ix->mask); ix->slots[i] != 0; i = (i + 1u) & ix->mask) {
+        if (ix->nodes[ix->slots[i] - 1].alarm == alarm) return ix->slots[i] - 1;
+    }
+    return -1;
+}
+
+static int ai_map_put(AlarmIndex *ix, int32_t node)
+{
+    uint32_t i;
+
+    if (!ix->slots || 2u * (ix->count + 1u) > ix->mask + 1u) {
+        uint32_t size = ix->slots ? 2u * (ix->mask + 1u) : 256u;
+        int32_t *slots = (int32_t *)calloc(size, sizeof(*slots));
+        if (!slots) return 0;
+        if (ix->slots) {
+            for (i = 0; i <= ix->mask; i++) {
+                uint32_t j;
+                if (ix->slots[i] == 0) continue;
+                j = ai_slot(ix->nodes[ix->slots[i] - 1].alarm, size - 1u);
+                while (slots[j] != 0) j = (j + 1u) & (size - 1u);
+                slots[j] = ix->slots[i];
+            }
+            free(ix->slots);
+        }
+        ix->slots = slots;
+        ix->mask = size - 1u;
+    }
+    i = ai_slot(ix->nodes[node].alarm, ix->mask);
+    while (ix->slots[i] != 0) i = (i + 1u) & ix->mask;
+    ix->slots[i] = node + 1;
+    return 1;
+}
+
+/* Remove alarm's slot, shifting later entries of its probe run back. */
+static void ai_map_del(AlarmIndex *ix, uint32_t alarm)
+{
+    uint32_t i = ai_slot(alarm, ix->mask), j;
+
+    while (ix->nodes[ix->slots[i] - 1].alarm != alarm) i = (i + 1u) & ix->mask;
+    for (j = (i + 1u) & ix->mask; ix->slots[j] != 0; j = (j + 1u) & ix->mask) {
+        uint32_t home = ai_slot(ix->nodes[ix->slots[j] - 1].alarm, ix->mask);
+        /* Move j into the hole at i unless its home lies in (i, j]. */
+        if (((j - home) & ix->mask) >= ((j - i) & ix->mask)) {
+            ix->slots[i] = ix->slots[j];
+            i = j;
+        }
+    }
+    ix->slots[i] = 0;
+}
+
+/* Append alarm (fire) after every indexed alarm with fire time <= fire. */
+static int ai_insert(AlarmIndex *ix, uint32_t alarm, int64_t fire)
+{
+    int32_t i = ix->spare;
+    int32_t l, r;
+    gc_treap tr;
+    AlarmKey key;
+
+    if (ix->count >= ALARM_INDEX_MAX) return 0;
+    if (i >= 0) {
+        ix->spare = ix->nodes[i].link.left;
+    } else {
+        if (ix->used == ix->cap) {
+            int32_t cap = ix->cap ? ix->cap * 2 : 64;
+            AlarmNode *nodes = (AlarmNode *)realloc(ix->nodes, (size_t)cap * sizeof(*nodes));
+            if (!nodes) return 0;
+            ix->nodes = nodes;
+            ix->cap = cap;
+        }
+        i = ix->used++;
+    }
+
+    ix->nodes[i].fire = fire;
+    ix->nodes[i].seq = ix->seq++;
+    ix->nodes[i].alarm = alarm;
+    ix->nodes[i].link.prio = gc_treap_prio((uint32_t)ix->nodes[i].seq);
+    ix->nodes[i].link.left = -1;
+    ix->nodes[i].link.right = -1;
+    if (!ai_map_put(ix, i)) return 0;
+
+    tr = ai_treap(ix);
+    key.fire = fire;
+    key.seq = ix->nodes[i].seq;
+    gc_treap_split(&tr, ix->root, &key, &l, &r);
+    ix->root = gc_treap_merge(&tr, gc_treap_merge(&tr, l, i), r);
+    ix->count++;
+    return 1;
+}
+
+/* Returns 0 if alarm was not indexed. */
+static int ai_erase(AlarmIndex *ix, uint32_t alarm)
+{
+    AlarmNode *n = ix->nodes;
+    const int32_t t = ai_lookup(ix, alarm);
+    const gc_treap tr = ai_treap(ix);
+    AlarmKey key;
+    int32_t l, m, r;
+
+    if (t < 0) return 0;
+    key.fire = n[t].fire;
+    key.seq = n[t].seq;
+    gc_treap_split(&tr, ix->root, &key, &l, &m);
+    key.seq++;
+    gc_treap_split(&tr, m, &key, &m, &r);
+    ix->root = gc_treap_merge(&tr, l, r);
+    ai_map_del(ix, alarm);
+    ix->count--;
+    n[t].link.left = ix->spare;
+    ix->spare = t;
+    return 1;
+}
+
+/* First alarm in queue order firing strictly after fire, or -1. */
+static int32_t ai_after(const AlarmIndex *ix, int64_t fire)
+{
+    const AlarmNode *n = ix->nodes;
+    int32_t t = ix->root, best = -1;
+
+    while (t >= 0) {
+        if (n[t].fire > fire) {
+            best = t;
+            t = n[t].link.left;
+        } else {
+            t = n[t].link.right;
+        }
+    }
+    return best;
+}
+
+static void alarm_index_drop(void)
+{
+    s_alarm_index.st = NULL;
+}
+
+static int alarm_index_rebuild(AlarmIndex *ix, const port_OSAlarmState *st)
+{
+    uint32_t a, prev = 0;
+    int64_t last = INT64_MIN;
+
+    gc_os_alarm_index_rebuilds++;
+    ix->st = NULL;
+    ix->root = -1;
+    ix->count = 0;
+    ix->used = 0;
+    ix->spare = -1;
+    if (ix->slots) memset(ix->slots, 0, (ix->mask + 1u) * sizeof(*ix->slots));
+    for (a = st->queueHead; a != 0; a = load_u32be(a + PORT_ALARM_NEXT)) {
+        int64_t fire = load_s64be(a + PORT_ALARM_FIRE);
+        if (fire < last || load_u32be(a + PORT_ALARM_PREV) != prev) return 0;
+        if (!ai_insert(ix, a, fire)) return 0;
+        last = fire;
+        prev = a;
+    }
+    if (prev != st->queueTail) return 0;
+    ix->st = st;
+    ix->head = st->queueHead;
+    ix->tail = st->queueTail;
+    return 1;
+}
+
+/* The index for st, rebuilt if the queue moved under it; NULL = walk. */
+static AlarmIndex *alarm_index_sync(const port_OSAlarmState *st, int force)
+{
+    AlarmIndex *ix = &s_alarm_index;
+
+    if (!ALARM_INDEX_ENABLED) return NULL;
+    if (!force && ix->st == st && ix->head == st->queueHead && ix->tail == st->queueTail)
+        return ix;
+    return alarm_index_rebuild(ix, st) ? ix : NULL;
+}
+
+/* Where InsertAlarm's walk would stop for fire: *next_a (0 = append at the
+ * tail). Returns NULL when the caller has to walk instead. */
+static AlarmIndex *alarm_index_find(const port_OSAlarmState *st, int64_t fire,
+                                    uint32_t *next_a)
+{
+    int attempt;
+
+    for (attempt = 0; attempt < 2; attempt++) {
+        AlarmIndex *ix = alarm_index_sync(st, attempt);
+        int32_t t;
+        uint32_t a, prev;
+
+        if (!ix) return NULL;
+        t = ai_after(ix, fire);
+        if (t < 0) {
+            if (st->queueTail == 0 || load_s64be(st->queueTail + PORT_ALARM_FIRE) <= fire) {
+                *next_a = 0;
+                return ix;
+            }
+            continue;
+        }
+        a = ix->nodes[t].alarm;
+        prev = load_u32be(a + PORT_ALARM_PREV);
+        if (load_s64be(a + PORT_ALARM_FIRE) == ix->nodes[t].fire &&
+            (prev == 0 ? st->queueHead == a
+                       : load_u32be(prev + PORT_ALARM_NEXT) == a &&
+                         load_s64be(prev + PORT_ALARM_FIRE) <= fire)) {
+            *next_a = a;
+            return ix;
+        }
+    }
+    alarm_index_drop();
+    return NULL;
+}
+
+/* The queue gained alarm (fire): keep the index in step or drop it. */
+static void alarm_index_added(AlarmIndex *ix, const port_OSAlarmState *st,
+                              uint32_t alarm, int64_t fire)
+{
+    if (!ix) return;
+    if (!ai_insert(ix, alarm, fire)) {
+        alarm_index_drop();
+        return;
+    }
+    ix->head = st->queueHead;
+    ix->tail = st->queueTail;
+}
+
+/* The queue lost alarm: keep the index in step or drop it. */
+static void alarm_index_removed(AlarmIndex *ix, const port_OSAlarmState *st,
+                                uint32_t alarm)
+{
+    if (!ix) return;
+    if (!ai_erase(ix, alarm)) {
+        alarm_index_drop();
+        return;
+    }
+    ix->head = st->queueHead;
+    ix->tail = st->queueTail;
+}
+
 /* ── Init ── */
 
 void port_OSAlarmInit(port_OSAlarmState *st)
@@ -52,6 +377,7 @@ void port_OSAlarmInit(port_OSAlarmState *st)
     st->queueHead = 0;
     st->queueTail = 0;
     st->systemTime = 0;
+    alarm_index_drop();
 }
 
 /* ── OSCreateAlarm (OSAlarm.c:26) ── */
@@ -68,6 +394,7 @@ static void InsertAlarm(port_OSAlarmState *st, uint32_t alarm,
 {
     uint32_t next_a;
     uint32_t prev_a;
+    AlarmIndex *ix;
 
     if (0 < load_s64be(alarm + PORT_ALARM_PERIOD)) {
         int64_t time = st->systemTime;
@@ -82,12 +409,21 @@ static void InsertAlarm(port_OSAlarmState *st, uint32_t alarm,
     store_u32be(alarm + PORT_ALARM_HANDLER, handler);
     store_s64be(alarm + PORT_ALARM_FIRE, fire);
 
-    for (next_a = st->queueHead; next_a != 0;
-         next_a = load_u32be(next_a + PORT_ALARM_NEXT)) {
-        int64_t next_fire = load_s64be(next_a + PORT_ALARM_FIRE);
-        if (next_fire <= fire) {
-            continue;
+    ix = alarm_index_find(st, fire, &next_a);
+    if (ix && ai_lookup(ix, alarm) >= 0) {
+        /* Already queued: the list is about to break, leave it to the walk. */
+        alarm_index_drop();
+        ix = NULL;
+    }
+    if (!ix) {
+        for (next_a = st->queueHead; next_a != 0;
+             next_a = load_u32be(next_a + PORT_ALARM_NEXT)) {
+            int64_t next_fire = load_s64be(next_a + PORT_ALARM_FIRE);
+            if (next_fire > fire) break;
         }
+    }
+
+    if (next_a != 0) {
         /* Insert before next_a */
         prev_a = load_u32be(next_a + PORT_ALARM_PREV);
         store_u32be(alarm + PORT_ALARM_PREV, prev_a);
@@ -98,25 +434,96 @@ static void InsertAlarm(port_OSAlarmState *st, uint32_t alarm,
         } else {
             st->queueHead = alarm;
         }
-        return;
+    } else {
+        /* Insert at tail */
+        store_u32be(alarm + PORT_ALARM_NEXT, 0);
+        prev_a = st->queueTail;
+        st->queueTail = alarm;
+        store_u32be(alarm + PORT_ALARM_PREV, prev_a);
+        if (prev_a) {
+            store_u32be(prev_a + PORT_ALARM_NEXT, alarm);
+        } else {
+            st->queueHead = st->queueTail = alarm;
+        }
     }
+    alarm_index_added(ix, st, alarm, fire);
+}
 
-    /* Insert at tail */
-    store_u32be(alarm + PORT_ALARM_NEXT, 0);
-    prev_a = st->queueTail;
-    st->queueTail = alarm;
-    store_u32be(alarm + PORT_ALARM_PREV, prev_a);
-    if (prev_a) {
-        store_u32be(prev_a + PORT_ALARM_NEXT, alarm);
-    } else {
-        st->queueHead = st->queueTail = alarm;
+/* ── Virtual clock ──
+ *
+ * The attached queue is a gc_clock source: its due time is the head's fire
+ * time, and firing it runs FireHead for every alarm due at that tick. */
+
+static port_OSAlarmState *s_clock_st;
+static void (*s_clock_fired)(port_OSAlarmState *st, uint32_t alarm);
+
+static void alarm_clock_time(port_OSAlarmState *st)
+{
+    if (st == s_clock_st && gc_clock_enabled()) {
+        st->systemTime = (int64_t)gc_clock_now();
+    }
+}
+
+static uint64_t alarm_clock_next(void *ctx)
+{
+    port_OSAlarmState *st = (port_OSAlarmState *)ctx;
+    int64_t fire;
+
+    if (st->queueHead == 0) return GC_CLOCK_NEVER;
+    fire = load_s64be(st->queueHead + PORT_ALARM_FIRE);
+    return fire < 0 ? 0 : (uint64_t)fire;
+}
+
+static void alarm_clock_fire(void *ctx, uint64_t now)
+{
+    port_OSAlarmState *st = (port_OSAlarmState *)ctx;
+
+    while (st->queueHead != 0 &&
+           load_s64be(st->queueHead + PORT_ALARM_FIRE) <= (int64_t)now) {
+        uint32_t alarm;
+        /* The decrementer handler reads the time after the alarm came due,
+         * so a periodic alarm whose start is now re-inserts a period on. */
+        st->systemTime = (int64_t)now + 1;
+        alarm = port_OSAlarmFireHead(st);
+        st->systemTime = (int64_t)now;
+        if (alarm == 0) break;
+        if (s_clock_fired) s_clock_fired(st, alarm);
     }
 }
 
+int port_OSAlarmAttachClock(port_OSAlarmState *st,
+                            void (*fired)(port_OSAlarmState *st, uint32_t alarm))
+{
+    gc_clock_source src;
+
+    if (s_clock_st && s_clock_st != st) gc_clock_remove_source(s_clock_st);
+    src.kind = GC_CLOCK_ALARM;
+    src.next = alarm_clock_next;
+    src.fire = alarm_clock_fire;
+    src.ctx = st;
+    if (gc_clock_add_source(&src) != 0) {
+        s_clock_st = NULL;
+        return -1;
+    }
+    s_clock_st = st;
+    s_clock_fired = fired;
+    alarm_clock_time(st);
+    return 0;
+}
+
+void port_OSAlarmDetachClock(port_OSAlarmState *st)
+{
+    if (st != s_clock_st) return;
+    gc_clock_remove_source(st);
+    s_clock_st = NULL;
+    s_clock_fired = NULL;
+}
+
 /* ── OSSetAlarm (OSAlarm.c:85-91) ── */
 
 void port_OSSetAlarm(port_OSAlarmState *st, uint32_t alarmAddr, int64_t tick)
 {
+    alarm_clock_time(st);
     store_s64be(alarmAddr + PORT_ALARM_PERIOD, 0);
     InsertAlarm(st, alarmAddr, st->systemTime + tick, 1);
 }
@@ -126,6 +533,7 @@ void port_OSSetAlarm(port_OSAlarmState *st, uint32_t alarmAddr, int64_t tick)
 void port_OSSetPeriodicAlarm(port_OSAlarmState *st, uint32_t alarmAddr,
                              int64_t start, int64_t period)
 {
+    alarm_clock_time(st);
     store_s64be(alarmAddr + PORT_ALARM_PERIOD, period);
     store_s64be(alarmAddr + PORT_ALARM_START, start);
     InsertAlarm(st, alarmAddr, 0, 1);
@@ -136,9 +544,11 @@ void port_OSSetPeriodicAlarm(port_OSAlarmState *st, uint32_t alarmAddr,
 void port_OSCancelAlarm(port_OSAlarmState *st, uint32_t alarmAddr)
 {
     uint32_t next_a;
+    AlarmIndex *ix;
 
     if (load_u32be(alarmAddr + PORT_ALARM_HANDLER) == 0) return;
 
+    ix = alarm_index_sync(st, 0);
     next_a = load_u32be(alarmAddr + PORT_ALARM_NEXT);
     if (next_a == 0) {
         st->queueTail = load_u32be(alarmAddr + PORT_ALARM_PREV);
@@ -153,6 +563,7 @@ void port_OSCancelAlarm(port_OSAlarmState *st, uint32_t alarmAddr)
         st->queueHead = next_a;
     }
     store_u32be(alarmAddr + PORT_ALARM_HANDLER, 0);
+    alarm_index_removed(ix, st, alarmAddr);
 }
 
 /* ── DecrementerExceptionCallback / FireHead (OSAlarm.c:127-167) ── */
@@ -162,10 +573,12 @@ uint32_t port_OSAlarmFireHead(port_OSAlarmState *st)
     uint32_t alarm = st->queueHead;
     uint32_t next_a;
     uint32_t handler;
+    AlarmIndex *ix;
 
     if (alarm == 0) return 0;
     if (st->systemTime < load_s64be(alarm + PORT_ALARM_FIRE)) return 0;
 
+    ix = alarm_index_sync(st, 0);
     next_a = load_u32be(alarm + PORT_ALARM_NEXT);
     st->queueHead = next_a;
     if (next_a == 0) {
@@ -173,6 +586,7 @@ uint32_t port_OSAlarmFireHead(port_OSAlarmState *st)
     } else {
         store_u32be(next_a + PORT_ALARM_PREV, 0);
     }
+    alarm_index_removed(ix, st, alarm);
 
     handler = load_u32be(alarm + PORT_ALARM_HANDLER);
     store_u32be(alarm + PORT_ALARM_HANDLER, 0);
@@ -35,6 +35,21 @@ void port_OSSetPeriodicAlarm(port_OSAlarmState *st, uint32_t alarmAddr,
                              int64_t start, int64_t period);
 void port_OSCancelAlarm(port_OSAlarmState *st, uint32_t alarmAddr);
 
+/* InsertAlarm looks its insertion point up in a host-side index of the
+ * queue (build with GC_OSALARM_LINEAR to walk the list instead). The index
+ * is rebuilt from RAM whenever the queue changed behind the port's back;
+ * this counts the rebuilds. */
+extern uint32_t gc_os_alarm_index_rebuilds;
+
+/* Hand the queue to the virtual clock (src/sdk_port/gc_clock.h). While the
+ * clock is enabled, OSSetAlarm / OSSetPeriodicAlarm read systemTime from it,
+ * and the clock fires due alarms in time order, calling fired(st, alarm)
+ * after each (fired may be NULL). One queue at a time; returns 0, or -1 if
+ * the clock has no free source slot. */
+int port_OSAlarmAttachClock(port_OSAlarmState *st,
+                            void (*fired)(port_OSAlarmState *st, uint32_t alarm));
+void port_OSAlarmDetachClock(port_OSAlarmState *st);
+
 /* Fire the head alarm if systemTime >= fire.
  * Returns GC addr of fired alarm (0 if nothing to fire).
  * Re-inserts periodic alarms automatically. */
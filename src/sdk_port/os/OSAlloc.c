@@ -1,6 +1,14 @@
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "gc_mem.h"
+#include "gc_treap.h"
+#include "OSAlloc.h"
+
+#ifdef GC_OSALLOC_CHECK_THREADS
+#include <pthread.h>
+#endif
 
 // RAM-backed state (big-endian in MEM1) for dump comparability.
 #include "../sdk_state.h"
@@ -123,17 +131,9 @@ uint32_t port_DLExtract(uint32_t list, uint32_t cell) {
     return list;
 }
 
-// DLInsert: insert cell into address-sorted free list with coalescing.
-uint32_t port_DLInsert(uint32_t list, uint32_t cell) {
-    uint32_t prev = 0;
-    uint32_t next = list;
-
-    while (next != 0) {
-        if (cell <= next) break;
-        prev = next;
-        next = load_u32be(next + 4); // next->next
-    }
-
+// Link cell between prev and next (the neighbours DLInsert's walk stops at)
+// and coalesce. Shared by the list walk and the free-cell index below.
+static uint32_t dl_insert_at(uint32_t list, uint32_t cell, uint32_t prev, uint32_t next) {
     store_u32be(cell + 4, next); // cell->next = next
     store_u32be(cell + 0, prev); // cell->prev = prev
 
@@ -170,6 +170,886 @@ uint32_t port_DLInsert(uint32_t list, uint32_t cell) {
     return cell;
 }
 
+// DLInsert: insert cell into address-sorted free list with coalescing.
+uint32_t port_DLInsert(uint32_t list, uint32_t cell) {
+    uint32_t prev = 0;
+    uint32_t next = list;
+
+    while (next != 0) {
+        if (cell <= next) break;
+        prev = next;
+        next = load_u32be(next + 4); // next->next
+    }
+    return dl_insert_at(list, cell, prev, next);
+}
+
+// ── Free-cell index ──
+//
+// OSAllocFromHeap's first-fit walk and DLInsert's sorted insert both chase the
+// big-endian free list one cell at a time. Each heap keeps a host-side shadow
+// of its free list instead: a treap ordered by cell address where every node
+// also records the largest cell size in its subtree. First fit (on an
+// address-sorted list, the lowest-address cell with size >= req) and
+// DLInsert's prev/next neighbours become O(log n) descents. Cell counts per
+// power-of-two size class ride along for heap statistics.
+//
+// RAM stays the source of truth. Every mutation still performs the stores of
+// the list code above; the index only picks the cells those stores touch. It
+// is trusted while hd->free and the backing buffer are what it last saw and
+// the cells a lookup lands on carry the sizes and links it expects. Otherwise
+// it is rebuilt from RAM, and a list that is not strictly address-sorted is
+// left to the walk. Build with GC_OSALLOC_LINEAR to always walk.
+
+enum { FREE_INDEX_MAX_CELLS = 1 << 20 };
+#ifdef GC_OSALLOC_LINEAR
+enum { FREE_INDEX_ENABLED = 0 };
+#else
+enum { FREE_INDEX_ENABLED = 1 };
+#endif
+
+typedef struct {
+    uint32_t addr;
+    int32_t size;
+    int32_t max;  // largest size in this subtree
+    gc_treap_link link;
+} FreeNode;
+
+typedef struct {
+    uint32_t hd;        // HeapDesc mirrored; 0 = not synced
+    uint32_t head;      // hd->free as last seen
+    const uint8_t *ram; // gc_mem_ptr(hd) as last seen
+    int32_t root;
+    uint32_t count;
+    uint32_t free_bytes;
+    FreeNode *nodes;
+    int32_t cap;
+    int32_t used;
+    int32_t spare;      // recycled nodes, chained through .link.left
+    uint32_t classes[PORT_OSALLOC_CLASSES];
+} FreeIndex;
+
+static FreeIndex *s_free_index;
+static int32_t s_free_index_heaps;
+
+static uint32_t free_index_class(int32_t size) {
+    uint32_t s = (uint32_t)size >> 6;
+    uint32_t c = 0;
+    while (s > 1u && c < PORT_OSALLOC_CLASSES - 1) {
+        s >>= 1;
+        c++;
+    }
+    return c;
+}
+
+static void fi_pull(void *nodes, int32_t t) {
+    FreeNode *n = (FreeNode *)nodes;
+    int32_t m = n[t].size;
+    if (n[t].link.left >= 0 && n[n[t].link.left].max > m) m = n[n[t].link.left].max;
+    if (n[t].link.right >= 0 && n[n[t].link.right].max > m) m = n[n[t].link.right].max;
+    n[t].max = m;
+}
+
+// Treap order: cells below the key address first.
+static int fi_before(const void *node, const void *key) {
+    return ((const FreeNode *)node)->addr < *(const uint32_t *)key;
+}
+
+static gc_treap fi_treap(FreeIndex *ix) {
+    const gc_treap tr = {(uint8_t *)ix->nodes, sizeof(FreeNode), offsetof(FreeNode, link), fi_before, fi_pull};
+    return tr;
+}
+
+static int fi_insert(FreeIndex *ix, uint32_t addr, int32_t size) {
+    int32_t i = ix->spare;
+    if (i >= 0) {
+        ix->spare = ix->nodes[i].link.left;
+    } else {
+        if (ix->used == ix->cap) {
+            int32_t cap = ix->cap ? ix->cap * 2 : 64;
+            FreeNode *nodes = (FreeNode *)realloc(ix->nodes, (size_t)cap * sizeof(*nodes));
+            if (!nodes) return 0;
+            ix->nodes = nodes;
+            ix->cap = cap;
+        }
+        i = ix->used++;
+    }
+
+    FreeNode *n = ix->nodes;
+    n[i].addr = addr;
+    n[i].size = size;
+    n[i].max = size;
+    n[i].link.prio = gc_treap_prio(addr);
+    n[i].link.left = -1;
+    n[i].link.right = -1;
+
+    const gc_treap tr = fi_treap(ix);
+    int32_t l, r;
+    gc_treap_split(&tr, ix->root, &addr, &l, &r);
+    ix->root = gc_treap_merge(&tr, gc_treap_merge(&tr, l, i), r);
+    ix->count++;
+    ix->free_bytes += (uint32_t)size;
+    ix->classes[free_index_class(size)]++;
+    return 1;
+}
+
+static void fi_erase(FreeIndex *ix, uint32_t addr) {
+    FreeNode *n = ix->nodes;
+    const gc_treap tr = fi_treap(ix);
+    const uint32_t next = addr + 1u;
+    int32_t l, m, r;
+    gc_treap_split(&tr, ix->root, &addr, &l, &m);
+    gc_treap_split(&tr, m, &next, &m, &r);
+    if (m >= 0) {
+        ix->count--;
+        ix->free_bytes -= (uint32_t)n[m].size;
+        ix->classes[free_index_class(n[m].size)]--;
+        n[m].link.left = ix->spare;
+        ix->spare = m;
+    }
+    ix->root = gc_treap_merge(&tr, l, r);
+}
+
+// Move/resize the cell at addr in place. new_addr must keep the address order
+// (no cell between the two), so only the subtree maxima on the path change.
+static int fi_update(FreeIndex *ix, uint32_t addr, uint32_t new_addr, int32_t new_size) {
+    FreeNode *n = ix->nodes;
+    int32_t path[64];
+    int depth = 0;
+    int32_t t = ix->root;
+    while (t >= 0 && n[t].addr != addr) {
+        if (depth == 64) return 0;
+        path[depth++] = t;
+        t = addr < n[t].addr ? n[t].link.left : n[t].link.right;
+    }
+    if (t < 0) return 0;
+    ix->free_bytes += (uint32_t)new_size - (uint32_t)n[t].size;
+    ix->classes[free_index_class(n[t].size)]--;
+    ix->classes[free_index_class(new_size)]++;
+    n[t].addr = new_addr;
+    n[t].size = new_size;
+    fi_pull(n, t);
+    while (depth > 0) fi_pull(n, path[--depth]);
+    return 1;
+}
+
+// Lowest-address cell that fits, or -1.
+static int32_t fi_first_fit(const FreeIndex *ix, int32_t req) {
+    const FreeNode *n = ix->nodes;
+    int32_t t = ix->root;
+    if (t < 0 || n[t].max < req) return -1;
+    for (;;) {
+        if (n[t].link.left >= 0 && n[n[t].link.left].max >= req) {
+            t = n[t].link.left;
+        } else if (n[t].size >= req) {
+            return t;
+        } else {
+            t = n[t].link.right;
+        }
+    }
+}
+
+// Nearest cells strictly below key (*below) and at or above it (*above).
+static void fi_around(const FreeIndex *ix, uint32_t key, int32_t *below, int32_t *above) {
+    const FreeNode *n = ix->nodes;
+    int32_t t = ix->root;
+    *below = *above = -1;
+    while (t >= 0) {
+        if (n[t].addr < key) {
+            *below = t;
+            t = n[t].link.right;
+        } else {
+            *above = t;
+            t = n[t].link.left;
+        }
+    }
+}
+
+static void free_index_drop(int heap) {
+    if (heap >= 0 && heap < s_free_index_heaps) s_free_index[heap].hd = 0;
+}
+
+static int free_index_rebuild(FreeIndex *ix, uint32_t hd, uint32_t head, const uint8_t *ram) {
+    ix->hd = 0;
+    ix->root = -1;
+    ix->count = 0;
+    ix->free_bytes = 0;
+    ix->used = 0;
+    ix->spare = -1;
+    memset(ix->classes, 0, sizeof(ix->classes));
+
+    uint32_t prev = 0;
+    for (uint32_t cell = head; cell != 0; cell = load_u32be(cell + 4)) {
+        if (cell <= prev || ix->count >= FREE_INDEX_MAX_CELLS) return 0;
+        if (load_u32be(cell + 0) != prev) return 0;
+        if (!fi_insert(ix, cell, load_i32be(cell + 8))) return 0;
+        prev = cell;
+    }
+    ix->hd = hd;
+    ix->head = head;
+    ix->ram = ram;
+    return 1;
+}
+
+// The heap's index, rebuilt if RAM moved under it; NULL means walk the list.
+static FreeIndex *free_index_sync(int heap, uint32_t hd, int force) {
+    if (!FREE_INDEX_ENABLED) return 0;
+    if (heap >= s_free_index_heaps) {
+        int32_t heaps = heap + 1 > 8 ? heap + 1 : 8;
+        FreeIndex *arr = (FreeIndex *)realloc(s_free_index, (size_t)heaps * sizeof(*arr));
+        if (!arr) return 0;
+        memset(arr + s_free_index_heaps, 0, (size_t)(heaps - s_free_index_heaps) * sizeof(*arr));
+        s_free_index = arr;
+        s_free_index_heaps = heaps;
+    }
+
+    FreeIndex *ix = &s_free_index[heap];
+    const uint8_t *ram = gc_mem_ptr(hd, 4);
+    const uint32_t head = load_u32be(hd + 4);
+    if (!ram) return 0;
+    if (!force && ix->hd == hd && ix->ram == ram && ix->head == head) return ix;
+    return free_index_rebuild(ix, hd, head, ram) ? ix : 0;
+}
+
+// Does the cell at node t still sit in RAM where the index puts it?
+static int free_index_cell_ok(const FreeIndex *ix, int32_t t) {
+    const FreeNode *n = ix->nodes;
+    const uint32_t addr = n[t].addr;
+    int32_t below, above, unused;
+    fi_around(ix, addr, &below, &unused);
+    fi_around(ix, addr + 1u, &unused, &above);
+    if (load_i32be(addr + 8) != n[t].size) return 0;
+    if (load_u32be(addr + 0) != (below >= 0 ? n[below].addr : 0)) return 0;
+    return load_u32be(addr + 4) == (above >= 0 ? n[above].addr : 0);
+}
+
+// First fit through the index: *cell is the pick (0 if nothing fits). Returns
+// NULL when the caller has to walk the list instead.
+static FreeIndex *free_index_first_fit(int heap, uint32_t hd, uint32_t req, uint32_t *cell) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        FreeIndex *ix = free_index_sync(heap, hd, attempt);
+        if (!ix) return 0;
+        int32_t t = fi_first_fit(ix, (int32_t)req);
+        if (t < 0) {
+            *cell = 0;
+            return ix;
+        }
+        if (free_index_cell_ok(ix, t)) {
+            *cell = ix->nodes[t].addr;
+            return ix;
+        }
+    }
+    free_index_drop(heap);
+    return 0;
+}
+
+// OSAllocFromHeap took cell off the free list, leaving rest (0 if none).
+static void free_index_took(FreeIndex *ix, uint32_t hd, uint32_t cell, uint32_t rest) {
+    if (rest == 0) {
+        fi_erase(ix, cell);
+    } else if (!fi_update(ix, cell, rest, load_i32be(rest + 8))) {
+        fi_erase(ix, cell);
+        if (!fi_insert(ix, rest, load_i32be(rest + 8))) {
+            ix->hd = 0;
+            return;
+        }
+    }
+    ix->head = load_u32be(hd + 4);
+}
+
+// port_DLInsert(list, cell) on a heap's free list (list == hd->free).
+static uint32_t free_list_insert(int heap, uint32_t hd, uint32_t list, uint32_t cell) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        FreeIndex *ix = free_index_sync(heap, hd, attempt);
+        if (!ix) break;
+
+        int32_t below, above;
+        fi_around(ix, cell, &below, &above);
+        const FreeNode *n = ix->nodes;
+        if (above >= 0 && n[above].addr == cell) break; // already free: leave it to the walk
+        if (below >= 0 && !free_index_cell_ok(ix, below)) continue;
+        if (above >= 0 && !free_index_cell_ok(ix, above)) continue;
+
+        const uint32_t prev = below >= 0 ? n[below].addr : 0;
+        const uint32_t next = above >= 0 ? n[above].addr : 0;
+        const uint32_t prev_size = below >= 0 ? (uint32_t)n[below].size : 0;
+        const uint32_t cell_size = load_u32be(cell + 8);
+        const uint32_t new_list = dl_insert_at(list, cell, prev, next);
+
+        int ok;
+        if (next != 0 && cell + cell_size == next) fi_erase(ix, next);
+        if (prev != 0 && prev + prev_size == cell) {
+            ok = fi_update(ix, prev, prev, load_i32be(prev + 8));
+        } else {
+            ok = fi_insert(ix, cell, load_i32be(cell + 8));
+        }
+        if (ok) {
+            ix->head = new_list;
+        } else {
+            ix->hd = 0;
+        }
+        return new_list;
+    }
+    free_index_drop(heap);
+    return port_DLInsert(list, cell);
+}
+
+// In-order walk of t against the RAM list starting at *cell.
+static int fi_check(const FreeIndex *ix, int32_t t, uint32_t *cell, uint32_t *count, uint32_t *bytes) {
+    if (t < 0) return 0;
+    const FreeNode *n = ix->nodes;
+    if (fi_check(ix, n[t].link.left, cell, count, bytes) != 0) return -1;
+    if (*cell != n[t].addr || load_i32be(*cell + 8) != n[t].size) return -1;
+    int32_t m = n[t].size;
+    if (n[t].link.left >= 0 && n[n[t].link.left].max > m) m = n[n[t].link.left].max;
+    if (n[t].link.right >= 0 && n[n[t].link.right].max > m) m = n[n[t].link.right].max;
+    if (n[t].max != m) return -1;
+    *cell = load_u32be(*cell + 4);
+    (*count)++;
+    *bytes += (uint32_t)n[t].size;
+    return fi_check(ix, n[t].link.right, cell, count, bytes);
+}
+
+int port_OSAllocIndexCheck(int heap) {
+    const uint32_t heap_array = state_load_u32(GC_SDK_OFF_OSALLOC_HEAP_ARRAY, __gc_osalloc_heap_array);
+    if (heap < 0 || heap >= s_free_index_heaps || heap_array == 0) return 1;
+    const FreeIndex *ix = &s_free_index[heap];
+    const uint32_t hd = heap_array + (uint32_t)heap * (uint32_t)HEAPDESC_SIZE;
+    if (ix->hd != hd || ix->ram != gc_mem_ptr(hd, 4) || ix->head != load_u32be(hd + 4)) return 1;
+
+    uint32_t cell = ix->head;
+    uint32_t count = 0;
+    uint32_t bytes = 0;
+    if (fi_check(ix, ix->root, &cell, &count, &bytes) != 0) return -1;
+    if (cell != 0 || count != ix->count || bytes != ix->free_bytes) return -1;
+    uint32_t classed = 0;
+    for (int c = 0; c < PORT_OSALLOC_CLASSES; c++) classed += ix->classes[c];
+    return classed == count ? 0 : -1;
+}
+
+int port_OSHeapFree(int heap, port_OSHeapFreeStats *out) {
+    const uint32_t heap_array = state_load_u32(GC_SDK_OFF_OSALLOC_HEAP_ARRAY, __gc_osalloc_heap_array);
+    const int32_t num_heaps = state_load_i32(GC_SDK_OFF_OSALLOC_NUM_HEAPS, __gc_osalloc_num_heaps);
+    if (heap_array == 0 || heap < 0 || heap >= num_heaps) return -1;
+
+    const uint32_t hd = heap_array + (uint32_t)heap * (uint32_t)HEAPDESC_SIZE;
+    if (load_i32be(hd + 0) < 0) return -1;
+
+    memset(out, 0, sizeof(*out));
+    const FreeIndex *ix = free_index_sync(heap, hd, 0);
+    if (ix) {
+        out->free_bytes = ix->free_bytes;
+        out->largest = ix->root >= 0 ? (uint32_t)ix->nodes[ix->root].max : 0;
+        out->cells = ix->count;
+        memcpy(out->classes, ix->classes, sizeof(out->classes));
+        return 0;
+    }
+    for (uint32_t cell = load_u32be(hd + 4); cell != 0 && out->cells < FREE_INDEX_MAX_CELLS;
+         cell = load_u32be(cell + 4)) {
+        const int32_t size = load_i32be(cell + 8);
+        out->free_bytes += (uint32_t)size;
+        if ((uint32_t)size > out->largest) out->largest = (uint32_t)size;
+        out->cells++;
+        out->classes[free_index_class(size)]++;
+    }
+    return 0;
+}
+
+// ── Allocation profiler ──
+//
+// Per-heap counters plus an optional append-only log (layout in OSAlloc.h).
+// With the profiler stopped, each hook is one flag test.
+
+typedef struct {
+    int active;
+    FILE *log;
+    uint16_t tag;
+    uint32_t frame;
+    port_OSAllocProfHeap heaps[PORT_OSALLOC_PROF_HEAPS];
+} AllocProf;
+
+static AllocProf s_prof;
+
+static void prof_record(int kind, int heap, uint16_t tag, uint32_t a, uint32_t b, uint32_t c) {
+    if (!s_prof.log) return;
+    const uint32_t w[3] = {a, b, c};
+    uint8_t rec[PORT_OSALLOC_PROF_RECORD];
+    rec[0] = (uint8_t)kind;
+    rec[1] = (heap >= 0 && heap < 0xFF) ? (uint8_t)heap : 0xFFu;
+    rec[2] = (uint8_t)tag;
+    rec[3] = (uint8_t)(tag >> 8);
+    for (int i = 0; i < 3; i++) {
+        rec[4 + i * 4 + 0] = (uint8_t)(w[i] >> 0);
+        rec[4 + i * 4 + 1] = (uint8_t)(w[i] >> 8);
+        rec[4 + i * 4 + 2] = (uint8_t)(w[i] >> 16);
+        rec[4 + i * 4 + 3] = (uint8_t)(w[i] >> 24);
+    }
+    fwrite(rec, sizeof(rec), 1, s_prof.log);
+}
+
+static port_OSAllocProfHeap *prof_heap(int heap) {
+    return (heap >= 0 && heap < PORT_OSALLOC_PROF_HEAPS) ? &s_prof.heaps[heap] : 0;
+}
+
+static void prof_alloc(int kind, int heap, uint32_t size, uint32_t ptr) {
+    const uint32_t cell = ptr != 0 ? load_u32be(ptr - 0x20u + 8) : 0;
+    prof_record(kind, heap, s_prof.tag, ptr, size, cell);
+
+    port_OSAllocProfHeap *h = prof_heap(heap);
+    if (!h) return;
+    if (ptr == 0) {
+        h->failed++;
+        return;
+    }
+    h->allocs++;
+    h->alloc_classes[free_index_class((int32_t)round_up(size + 0x20u, ALIGNMENT))]++;
+    h->live_bytes += cell;
+    h->live_blocks++;
+    if (h->live_bytes > h->peak_bytes) h->peak_bytes = h->live_bytes;
+    if (h->live_blocks > h->peak_blocks) h->peak_blocks = h->live_blocks;
+}
+
+static void prof_free(int heap, uint32_t ptr, uint32_t cell_size) {
+    prof_record(PORT_OSALLOC_PROF_FREE, heap, s_prof.tag, ptr, cell_size, 0);
+    port_OSAllocProfHeap *h = prof_heap(heap);
+    if (!h) return;
+    h->frees++;
+    h->live_bytes = h->live_bytes > cell_size ? h->live_bytes - cell_size : 0;
+    if (h->live_blocks > 0) h->live_blocks--;
+}
+
+int port_OSAllocProfStart(FILE *log) {
+    memset(&s_prof, 0, sizeof(s_prof));
+    if (log) {
+        const uint32_t w[4] = {PORT_OSALLOC_PROF_MAGIC, PORT_OSALLOC_PROF_VERSION, PORT_OSALLOC_PROF_RECORD, 0};
+        uint8_t hdr[16];
+        for (int i = 0; i < 16; i++) hdr[i] = (uint8_t)(w[i / 4] >> ((i % 4) * 8));
+        if (fwrite(hdr, sizeof(hdr), 1, log) != 1) return 0;
+    }
+    s_prof.log = log;
+    s_prof.active = 1;
+    return 1;
+}
+
+void port_OSAllocProfStop(void) {
+    if (s_prof.log) fflush(s_prof.log);
+    s_prof.log = 0;
+    s_prof.active = 0;
+}
+
+void port_OSAllocProfTag(uint16_t tag) {
+    s_prof.tag = tag;
+}
+
+void port_OSAllocProfName(uint16_t tag, const char *name) {
+    if (!s_prof.active || !s_prof.log || !name) return;
+    const size_t len = strlen(name);
+    prof_record(PORT_OSALLOC_PROF_NAME, -1, tag, (uint32_t)len, 0, 0);
+    for (size_t off = 0; off < len; off += PORT_OSALLOC_PROF_RECORD) {
+        uint8_t chunk[PORT_OSALLOC_PROF_RECORD] = {0};
+        const size_t n = len - off < sizeof(chunk) ? len - off : sizeof(chunk);
+        memcpy(chunk, name + off, n);
+        fwrite(chunk, sizeof(chunk), 1, s_prof.log);
+    }
+}
+
+void port_OSAllocProfFrame(void) {
+    if (!s_prof.active) return;
+    const int32_t num_heaps = state_load_i32(GC_SDK_OFF_OSALLOC_NUM_HEAPS, __gc_osalloc_num_heaps);
+    for (int heap = 0; heap < num_heaps && s_prof.log; heap++) {
+        port_OSHeapFreeStats fs;
+        if (port_OSHeapFree(heap, &fs) == 0) {
+            prof_record(PORT_OSALLOC_PROF_HEAP, heap, 0, fs.free_bytes, fs.largest, fs.cells);
+        }
+    }
+    prof_record(PORT_OSALLOC_PROF_FRAME, -1, 0, s_prof.frame++, 0, 0);
+}
+
+int port_OSAllocProfHeapStats(int heap, port_OSAllocProfHeap *out) {
+    const port_OSAllocProfHeap *h = prof_heap(heap);
+    if (!h) return -1;
+    *out = *h;
+    return 0;
+}
+
+// ── Heap checks ──
+//
+// OSCheckHeap walks both lists of a heap, which is too slow to run every
+// frame of a long workload. Two cheaper forms return what it would:
+//
+// - port_OSCheckHeapIncremental keeps, per heap, the list totals and the
+//   cells OSAllocFromHeap / OSFreeToHeap / OSAddToHeap touched since the last
+//   check (the cell itself, its list neighbours, cells coalescing swallowed),
+//   and re-validates only those, sizes included. The first check of a heap, and any check
+//   where something is off (a dirty cell failing, hd->size / hd->free /
+//   hd->allocated not as the allocator left them, a moved backing buffer,
+//   more than CHECK_DIRTY_MAX dirty cells), walks the heap in full and
+//   returns that result. Damage to a cell no call has touched since the last
+//   check is left to the next full walk.
+// - port_OSCheckHeaps walks several heaps, the allocated and free list of
+//   each as separate jobs, spread over gc_os_check_threads threads when built
+//   with GC_OSALLOC_CHECK_THREADS.
+
+enum { CHECK_DIRTY_MAX = 512, CHECK_SEEN_BITS = 10 };
+enum { DIRTY_ALLOC = 1, DIRTY_FREE = 2, DIRTY_GONE = 3 }; // kept in a cell's low bits
+
+typedef struct {
+    uint32_t cell; // | DIRTY_*
+    int32_t size;  // as the allocator left it
+} DirtyCell;
+
+typedef struct {
+    uint32_t hd; // 0: no baseline, the next check walks the heap
+    const uint8_t *ram;
+    int32_t size; // hd->size / hd->free / hd->allocated as the allocator left them
+    uint32_t free_head;
+    uint32_t alloc_head;
+    long alloc_total; // allocated cell bytes
+    long free_total;  // free cell bytes
+    long free_cells;
+    uint32_t dirty_count; // CHECK_DIRTY_MAX + 1: overflowed
+    DirtyCell dirty[CHECK_DIRTY_MAX];
+} HeapCheck;
+
+static HeapCheck *s_heap_check;
+static int32_t s_heap_check_heaps;
+static port_OSCheckHeapStats s_check_stats;
+
+uint32_t gc_os_check_threads = 4;
+uint32_t gc_os_check_parallel_runs;
+
+static void check_drop(int heap) {
+    if (heap >= 0 && heap < s_heap_check_heaps) s_heap_check[heap].hd = 0;
+}
+
+// The heap's check state while it has a baseline to keep up to date.
+static HeapCheck *check_tracked(int heap, uint32_t hd) {
+    if (heap < 0 || heap >= s_heap_check_heaps) return 0;
+    HeapCheck *hc = &s_heap_check[heap];
+    return hc->hd == hd ? hc : 0;
+}
+
+static void check_dirty(HeapCheck *hc, uint32_t cell, uint32_t kind) {
+    if (cell == 0) return;
+    if (hc->dirty_count >= CHECK_DIRTY_MAX || (cell & (ALIGNMENT - 1)) != 0) {
+        hc->dirty_count = CHECK_DIRTY_MAX + 1;
+        return;
+    }
+    hc->dirty[hc->dirty_count].cell = cell | kind;
+    hc->dirty[hc->dirty_count].size = kind == DIRTY_GONE ? 0 : load_i32be(cell + 8);
+    hc->dirty_count++;
+}
+
+static void check_left(HeapCheck *hc, uint32_t hd) {
+    hc->size = load_i32be(hd + 0);
+    hc->free_head = load_u32be(hd + 4);
+    hc->alloc_head = load_u32be(hd + 8);
+}
+
+// OSAllocFromHeap moved cell from between prev and next on the free list
+// (leaving rest there if it split) to the front of the allocated list.
+static void check_took(HeapCheck *hc, uint32_t hd, uint32_t cell, uint32_t prev, uint32_t next, uint32_t rest) {
+    const long size = load_i32be(cell + 8);
+    check_dirty(hc, cell, DIRTY_ALLOC);
+    check_dirty(hc, load_u32be(cell + 4), DIRTY_ALLOC); // old allocated head
+    check_dirty(hc, prev, DIRTY_FREE);
+    check_dirty(hc, next, DIRTY_FREE);
+    if (rest != 0) {
+        check_dirty(hc, rest, DIRTY_FREE);
+    } else {
+        hc->free_cells--;
+    }
+    hc->alloc_total += size;
+    hc->free_total -= size;
+    check_left(hc, hd);
+}
+
+// cell (size bytes) went into the free list: the cell holding it now, that
+// cell's neighbours and whatever coalescing swallowed are dirty.
+static void check_inserted(HeapCheck *hc, uint32_t hd, uint32_t cell, uint32_t size, int was_allocated) {
+    const uint32_t prev = load_u32be(cell + 0);
+    uint32_t keep = cell;
+    long cells = 1;
+    if (prev != 0 && load_u32be(prev + 4) != cell) { // merged into prev
+        check_dirty(hc, cell, DIRTY_GONE);
+        keep = prev;
+        cells--;
+    }
+    if (keep + load_u32be(keep + 8) > cell + size) { // swallowed the next cell
+        check_dirty(hc, cell + size, DIRTY_GONE);
+        cells--;
+    }
+    check_dirty(hc, keep, DIRTY_FREE);
+    check_dirty(hc, load_u32be(keep + 0), DIRTY_FREE);
+    check_dirty(hc, load_u32be(keep + 4), DIRTY_FREE);
+    if (was_allocated) hc->alloc_total -= (long)size;
+    hc->free_total += (long)size;
+    hc->free_cells += cells;
+    check_left(hc, hd);
+}
+
+// Walk one list the way OSCheckHeap does, giving up past limit bytes (so a
+// cycle cannot spin). Returns 0 on the first bad cell.
+static int check_list(uint32_t head, int is_free, long limit, uint32_t lo, uint32_t hi,
+                      long *total, long *cells) {
+    *total = 0;
+    *cells = 0;
+    if (head != 0 && load_u32be(head + 0) != 0) return 0; // head->prev must be NULL
+
+    for (uint32_t cell = head; cell != 0; cell = load_u32be(cell + 4)) {
+        if (cell < lo || cell >= hi) return 0;
+        if ((cell & (ALIGNMENT - 1)) != 0) return 0;
+        uint32_t cell_next = load_u32be(cell + 4);
+        if (cell_next != 0 && load_u32be(cell_next + 0) != cell) return 0;
+        int32_t cell_size = load_i32be(cell + 8);
+        if (cell_size < 0x40) return 0;
+        if ((cell_size & (ALIGNMENT - 1)) != 0) return 0;
+        if (is_free && cell_next != 0 && cell + (uint32_t)cell_size >= cell_next) return 0;
+        *total += cell_size;
+        (*cells)++;
+        if (*total <= 0 || *total > limit) return 0;
+    }
+    return 1;
+}
+
+// One dirty cell against what check_list would require of it on its list,
+// and against the size the running totals counted.
+static int check_cell(uint32_t hd, const DirtyCell *d, uint32_t lo, uint32_t hi) {
+    const uint32_t cell = d->cell & ~(uint32_t)(ALIGNMENT - 1);
+    const uint32_t kind = d->cell & (ALIGNMENT - 1);
+    const uint32_t head = load_u32be(hd + (kind == DIRTY_FREE ? 4u : 8u));
+    const uint32_t prev = load_u32be(cell + 0);
+    const uint32_t next = load_u32be(cell + 4);
+    const int32_t size = load_i32be(cell + 8);
+    if (cell < lo || cell >= hi) return 0;
+    if (size != d->size) return 0;
+    if (size < 0x40 || (size & (ALIGNMENT - 1)) != 0) return 0;
+    if (prev == 0 ? head != cell : load_u32be(prev + 4) != cell) return 0;
+    if (next != 0 && load_u32be(next + 0) != cell) return 0;
+    if (kind == DIRTY_FREE) {
+        if (next != 0 && cell + (uint32_t)size >= next) return 0;
+        if (prev != 0 && prev + load_u32be(prev + 8) >= cell) return 0;
+    }
+    return 1;
+}
+
+// Newest entry per cell wins: a cell freed and then allocated again is
+// checked as allocated.
+static int check_dirty_cells(const HeapCheck *hc, uint32_t hd, uint32_t lo, uint32_t hi) {
+    uint32_t seen[1u << CHECK_SEEN_BITS];
+    uint32_t bits = 4;
+    while ((1u << bits) < 2u * hc->dirty_count) bits++;
+    const uint32_t mask = (1u << bits) - 1u;
+    memset(seen, 0, (mask + 1u) * sizeof(seen[0]));
+    for (uint32_t i = hc->dirty_count; i-- > 0;) {
+        const DirtyCell *d = &hc->dirty[i];
+        const uint32_t cell = d->cell & ~(uint32_t)(ALIGNMENT - 1);
+        uint32_t h = ((cell >> 5) * 2654435761u) >> (32 - bits);
+        while (seen[h] != 0 && seen[h] != cell) h = (h + 1u) & mask;
+        if (seen[h] != 0) continue;
+        seen[h] = cell;
+        s_check_stats.cells++;
+        if ((d->cell & (ALIGNMENT - 1)) != DIRTY_GONE && !check_cell(hd, d, lo, hi)) return 0;
+    }
+    return 1;
+}
+
+// Both lists of a heap, as OSCheckHeap checks them. 0 on the first bad cell.
+static int check_full(uint32_t hd, int32_t hd_size, uint32_t lo, uint32_t hi,
+                      long *alloc_total, long *free_total, long *free_cells) {
+    long alloc_cells;
+    if (!check_list(load_u32be(hd + 8), 0, hd_size, lo, hi, alloc_total, &alloc_cells)) return 0;
+    if (!check_list(load_u32be(hd + 4), 1, hd_size - *alloc_total, lo, hi, free_total, free_cells)) return 0;
+    return *alloc_total + *free_total == hd_size;
+}
+
+long OSCheckHeap(int heap) {
+    const uint32_t heap_array = state_load_u32(GC_SDK_OFF_OSALLOC_HEAP_ARRAY, __gc_osalloc_heap_array);
+    const int32_t num_heaps = state_load_i32(GC_SDK_OFF_OSALLOC_NUM_HEAPS, __gc_osalloc_num_heaps);
+    const uint32_t arena_start = state_load_u32(GC_SDK_OFF_OSALLOC_ARENA_START, __gc_osalloc_arena_start);
+    const uint32_t arena_end = state_load_u32(GC_SDK_OFF_OSALLOC_ARENA_END, __gc_osalloc_arena_end);
+
+    if (heap_array == 0) return -1;
+    if (heap < 0 || heap >= num_heaps) return -1;
+
+    const uint32_t hd = heap_array + (uint32_t)heap * (uint32_t)HEAPDESC_SIZE;
+    int32_t hd_size = load_i32be(hd + 0);
+    if (hd_size < 0) return -1;
+
+    long alloc_total, free_total, free_cells;
+    if (!check_full(hd, hd_size, arena_start, arena_end, &alloc_total, &free_total, &free_cells)) return -1;
+    return free_total - 0x20 * free_cells; // HEADERSIZE per free cell
+}
+
+// Full walk; a clean heap becomes the baseline for incremental checks.
+static long check_baseline(HeapCheck *hc, uint32_t hd, int32_t hd_size, uint32_t lo, uint32_t hi) {
+    long alloc_total, free_total, free_cells;
+    s_check_stats.full++;
+    hc->hd = 0;
+    if (!check_full(hd, hd_size, lo, hi, &alloc_total, &free_total, &free_cells)) return -1;
+
+    hc->hd = hd;
+    hc->ram = gc_mem_ptr(hd, 4);
+    hc->alloc_total = alloc_total;
+    hc->free_total = free_total;
+    hc->free_cells = free_cells;
+    hc->dirty_count = 0;
+    check_left(hc, hd);
+    return free_total - 0x20 * free_cells;
+}
+
+long port_OSCheckHeapIncremental(int heap) {
+    const uint32_t heap_array = state_load_u32(GC_SDK_OFF_OSALLOC_HEAP_ARRAY, __gc_osalloc_heap_array);
+    const int32_t num_heaps = state_load_i32(GC_SDK_OFF_OSALLOC_NUM_HEAPS, __gc_osalloc_num_heaps);
+    const uint32_t arena_start = state_load_u32(GC_SDK_OFF_OSALLOC_ARENA_START, __gc_osalloc_arena_start);
+    const uint32_t arena_end = state_load_u32(GC_SDK_OFF_OSALLOC_ARENA_END, __gc_osalloc_arena_end);
+    if (heap_array == 0 || heap < 0 || heap >= num_heaps) return -1;
+
+    const uint32_t hd = heap_array + (uint32_t)heap * (uint32_t)HEAPDESC_SIZE;
+    const int32_t hd_size = load_i32be(hd + 0);
+    if (hd_size < 0) {
+        check_drop(heap);
+        return -1;
+    }
+
+    if (heap >= s_heap_check_heaps) {
+        int32_t heaps = heap + 1 > 8 ? heap + 1 : 8;
+        HeapCheck *arr = (HeapCheck *)realloc(s_heap_check, (size_t)heaps * sizeof(*arr));
+        if (!arr) return OSCheckHeap(heap);
+        memset(arr + s_heap_check_heaps, 0, (size_t)(heaps - s_heap_check_heaps) * sizeof(*arr));
+        s_heap_check = arr;
+        s_heap_check_heaps = heaps;
+    }
+
+    HeapCheck *hc = &s_heap_check[heap];
+    s_check_stats.checks++;
+    if (hc->hd == hd && hc->ram == gc_mem_ptr(hd, 4) && hc->dirty_count <= CHECK_DIRTY_MAX &&
+        hc->size == hd_size && hc->free_head == load_u32be(hd + 4) && hc->alloc_head == load_u32be(hd + 8) &&
+        hc->alloc_total + hc->free_total == hd_size &&
+        check_dirty_cells(hc, hd, arena_start, arena_end)) {
+        hc->dirty_count = 0;
+        return hc->free_total - 0x20 * hc->free_cells;
+    }
+    return check_baseline(hc, hd, hd_size, arena_start, arena_end);
+}
+
+void port_OSCheckHeapCounters(port_OSCheckHeapStats *out) {
+    *out = s_check_stats;
+}
+
+typedef struct {
+    uint32_t head;
+    int is_free;
+    long limit;
+    uint32_t lo, hi;
+    int ok;
+    long total, cells;
+} CheckJob;
+
+static void check_job(CheckJob *job) {
+    job->ok = check_list(job->head, job->is_free, job->limit, job->lo, job->hi, &job->total, &job->cells);
+}
+
+#ifdef GC_OSALLOC_CHECK_THREADS
+typedef struct {
+    CheckJob *jobs;
+    int count;
+    int first;
+    int stride;
+} CheckWorker;
+
+static void *check_worker(void *arg) {
+    const CheckWorker *w = (const CheckWorker *)arg;
+    for (int i = w->first; i < w->count; i += w->stride) check_job(&w->jobs[i]);
+    return NULL;
+}
+
+// Deal the jobs out round-robin; the caller runs the last share.
+static int check_run_parallel(CheckJob *jobs, int count, uint32_t nthreads) {
+    pthread_t tid[GC_OSALLOC_CHECK_MAX_THREADS];
+    CheckWorker w[GC_OSALLOC_CHECK_MAX_THREADS];
+    uint32_t t, started = 0;
+
+    if (nthreads > (uint32_t)count) nthreads = (uint32_t)count;
+    for (t = 0; t < nthreads; t++) {
+        w[t].jobs = jobs;
+        w[t].count = count;
+        w[t].first = (int)t;
+        w[t].stride = (int)nthreads;
+    }
+    for (t = 0; t + 1u < nthreads; t++) {
+        if (pthread_create(&tid[t], NULL, check_worker, &w[t]) != 0) break;
+        started++;
+    }
+    // Shares whose thread did not start run here.
+    for (t = started; t < nthreads; t++) check_worker(&w[t]);
+    for (t = 0; t < started; t++) pthread_join(tid[t], NULL);
+    return started != 0;
+}
+#endif
+
+int port_OSCheckHeaps(const int *heaps, int count, long *out) {
+    const uint32_t heap_array = state_load_u32(GC_SDK_OFF_OSALLOC_HEAP_ARRAY, __gc_osalloc_heap_array);
+    const int32_t num_heaps = state_load_i32(GC_SDK_OFF_OSALLOC_NUM_HEAPS, __gc_osalloc_num_heaps);
+    const uint32_t arena_start = state_load_u32(GC_SDK_OFF_OSALLOC_ARENA_START, __gc_osalloc_arena_start);
+    const uint32_t arena_end = state_load_u32(GC_SDK_OFF_OSALLOC_ARENA_END, __gc_osalloc_arena_end);
+    if (count <= 0) return 0;
+
+    CheckJob *jobs = (CheckJob *)calloc((size_t)count * 2u, sizeof(*jobs));
+    int32_t *sizes = (int32_t *)calloc((size_t)count, sizeof(*sizes));
+    if (!jobs || !sizes) {
+        free(jobs);
+        free(sizes);
+        int bad = 0;
+        for (int i = 0; i < count; i++) bad += (out[i] = OSCheckHeap(heaps[i])) < 0;
+        return bad;
+    }
+
+    // Job 2i walks heap i's allocated list, job 2i + 1 its free list. The
+    // lists are disjoint, so the walks only read shared RAM.
+    for (int i = 0; i < count; i++) {
+        const int heap = heaps[i];
+        sizes[i] = -1;
+        if (heap_array == 0 || heap < 0 || heap >= num_heaps) continue;
+        const uint32_t hd = heap_array + (uint32_t)heap * (uint32_t)HEAPDESC_SIZE;
+        sizes[i] = load_i32be(hd + 0);
+        if (sizes[i] < 0) continue;
+        for (int l = 0; l < 2; l++) {
+            CheckJob *job = &jobs[2 * i + l];
+            job->head = load_u32be(hd + (l ? 4u : 8u));
+            job->is_free = l;
+            job->limit = sizes[i];
+            job->lo = arena_start;
+            job->hi = arena_end;
+        }
+    }
+
+#ifdef GC_OSALLOC_CHECK_THREADS
+    if (gc_os_check_threads > 1u) {
+        const uint32_t nt = gc_os_check_threads < GC_OSALLOC_CHECK_MAX_THREADS ? gc_os_check_threads
+                                                                               : GC_OSALLOC_CHECK_MAX_THREADS;
+        if (check_run_parallel(jobs, count * 2, nt)) gc_os_check_parallel_runs++;
+    } else
+#endif
+    {
+        for (int j = 0; j < count * 2; j++) check_job(&jobs[j]);
+    }
+
+    int bad = 0;
+    for (int i = 0; i < count; i++) {
+        const CheckJob *a = &jobs[2 * i];
+        const CheckJob *f = &jobs[2 * i + 1];
+        if (sizes[i] >= 0 && a->ok && f->ok && a->total + f->total == sizes[i]) {
+            out[i] = f->total - 0x20 * f->cells;
+        } else {
+            out[i] = -1;
+            bad++;
+        }
+    }
+    free(jobs);
+    free(sizes);
+    return bad;
+}
+
 void *OSInitAlloc(void *arenaStart, void *arenaEnd, int maxHeaps) {
     const uint32_t arena_lo = (uint32_t)(uintptr_t)arenaStart;
     const uint32_t arena_hi = (uint32_t)(uintptr_t)arenaEnd;
@@ -192,6 +1072,8 @@ void *OSInitAlloc(void *arenaStart, void *arenaEnd, int maxHeaps) {
 
     __OSCurrHeap = -1;
     state_store_i32(GC_SDK_OFF_OS_CURR_HEAP, -1);
+    for (int i = 0; i < s_free_index_heaps; i++) free_index_drop(i);
+    for (int i = 0; i < s_heap_check_heaps; i++) check_drop(i);
 
     // arenaStart becomes HeapArray + arraySize, then rounded up to 32 bytes.
     uint32_t new_lo = arena_lo + array_size;
@@ -235,6 +1117,13 @@ int OSCreateHeap(void *start, void *end) {
             // hd->free = start, hd->allocated = 0
             store_u32be(hd + 4, s);
             store_u32be(hd + 8, 0);
+            (void)free_index_sync((int)heap, hd, 1);
+            check_drop((int)heap);
+            if (s_prof.active) {
+                port_OSAllocProfHeap *h = prof_heap((int)heap);
+                if (h) memset(h, 0, sizeof(*h));
+                prof_record(PORT_OSALLOC_PROF_CREATE, (int)heap, s_prof.tag, s, new_size, 0);
+            }
 
             return (int)heap;
         }
@@ -252,7 +1141,7 @@ int OSSetCurrentHeap(int heap) {
     return prev;
 }
 
-void *OSAllocFromHeap(int heap, uint32_t size) {
+static void *alloc_cell(int heap, uint32_t size) {
     // Port of OSAllocFromHeap (OSAlloc.c).
     // We intentionally keep asserts out; expected-vs-actual tests drive correctness.
     if ((int32_t)size <= 0) return (void *)0;
@@ -269,11 +1158,15 @@ void *OSAllocFromHeap(int heap, uint32_t size) {
     uint32_t req = size + 0x20u;
     req = round_up(req, ALIGNMENT);
 
-    uint32_t cell = load_u32be(hd + 4); // hd->free
-    while (cell != 0) {
-        uint32_t cell_size = load_u32be(cell + 8);
-        if ((int32_t)req <= (int32_t)cell_size) break;
-        cell = load_u32be(cell + 4); // next
+    uint32_t cell;
+    FreeIndex *ix = free_index_first_fit(heap, hd, req, &cell);
+    if (!ix) {
+        cell = load_u32be(hd + 4); // hd->free
+        while (cell != 0) {
+            uint32_t cell_size = load_u32be(cell + 8);
+            if ((int32_t)req <= (int32_t)cell_size) break;
+            cell = load_u32be(cell + 4); // next
+        }
     }
     if (cell == 0) return (void *)0;
 
@@ -313,6 +1206,7 @@ void *OSAllocFromHeap(int heap, uint32_t size) {
             store_u32be(hd + 4, new_cell);
         }
     }
+    if (ix) free_index_took(ix, hd, cell, leftover < 0x40u ? 0 : cell + req);
 
     // Add allocated cell to front of allocated list (via DLAddFront).
     uint32_t alloc_head = load_u32be(hd + 8);
@@ -320,9 +1214,23 @@ void *OSAllocFromHeap(int heap, uint32_t size) {
     store_u32be(cell + 12, hd);        // cell->hd = &HeapArray[heap] (emulated address)
     store_u32be(hd + 8, alloc_head);
 
+    HeapCheck *hc = check_tracked(heap, hd);
+    if (hc) check_took(hc, hd, cell, cell_prev, cell_next, leftover < 0x40u ? 0 : cell + req);
+
     return (void *)(uintptr_t)(cell + 0x20u);
 }
 
+// kind (PORT_OSALLOC_PROF_*) is what the profiler records the call as.
+static void *alloc_from_heap(int heap, uint32_t size, int kind) {
+    void *ptr = alloc_cell(heap, size);
+    if (s_prof.active) prof_alloc(kind, heap, size, (uint32_t)(uintptr_t)ptr);
+    return ptr;
+}
+
+void *OSAllocFromHeap(int heap, uint32_t size) {
+    return alloc_from_heap(heap, size, PORT_OSALLOC_PROF_ALLOC);
+}
+
 void *OSAlloc(uint32_t size) {
     // MP4 (and other games) calls OSAlloc(size) which allocates from the
     // current heap.
@@ -342,6 +1250,13 @@ void OSFreeToHeap(int heap, void *ptr) {
 
     uint32_t gc_ptr = (uint32_t)(uintptr_t)ptr;
     uint32_t cell = gc_ptr - 0x20u;
+    const uint32_t cell_size = load_u32be(cell + 8);
+    if (s_prof.active) prof_free(heap, gc_ptr, cell_size);
+    HeapCheck *hc = check_tracked(heap, hd);
+    if (hc) {
+        check_dirty(hc, load_u32be(cell + 0), DIRTY_ALLOC);
+        check_dirty(hc, load_u32be(cell + 4), DIRTY_ALLOC);
+    }
 
     // Remove from allocated list.
     uint32_t alloc_head = load_u32be(hd + 8);
@@ -353,8 +1268,9 @@ void OSFreeToHeap(int heap, void *ptr) {
 
     // Insert into free list (address-sorted, with coalescing).
     uint32_t free_head = load_u32be(hd + 4);
-    uint32_t new_free = port_DLInsert(free_head, cell);
+    uint32_t new_free = free_list_insert(heap, hd, free_head, cell);
     store_u32be(hd + 4, new_free);
+    if (hc) check_inserted(hc, hd, cell, cell_size, 1);
 }
 
 void OSDestroyHeap(int heap) {
@@ -364,6 +1280,9 @@ void OSDestroyHeap(int heap) {
 
     const uint32_t hd = heap_array + (uint32_t)heap * (uint32_t)HEAPDESC_SIZE;
     store_u32be(hd + 0, 0xFFFFFFFFu); // hd->size = -1
+    free_index_drop(heap);
+    check_drop(heap);
+    if (s_prof.active) prof_record(PORT_OSALLOC_PROF_DESTROY, heap, s_prof.tag, 0, 0, 0);
 }
 
 void OSAddToHeap(int heap, void *start, void *end) {
@@ -381,6 +1300,7 @@ void OSAddToHeap(int heap, void *start, void *end) {
     e = round_down(e, ALIGNMENT);
 
     uint32_t cell_size = e - s;
+    if (s_prof.active) prof_record(PORT_OSALLOC_PROF_ADD, heap, s_prof.tag, s, cell_size, 0);
     // cell = start; cell->size = end - start
     store_u32be(s + 8, cell_size);
     store_u32be(s + 12, 0); // hd=0 (free cell)
@@ -391,8 +1311,10 @@ void OSAddToHeap(int heap, void *start, void *end) {
 
     // hd->free = DLInsert(hd->free, cell)
     uint32_t free_head = load_u32be(hd + 4);
-    uint32_t new_free = port_DLInsert(free_head, s);
+    uint32_t new_free = free_list_insert(heap, hd, free_head, s);
     store_u32be(hd + 4, new_free);
+    HeapCheck *hc = check_tracked(heap, hd);
+    if (hc) check_inserted(hc, hd, s, cell_size, 0);
 }
 
 void OSFree(void *ptr) {
@@ -400,61 +1322,6 @@ void OSFree(void *ptr) {
     OSFreeToHeap(curr, ptr);
 }
 
-long OSCheckHeap(int heap) {
-    const uint32_t heap_array = state_load_u32(GC_SDK_OFF_OSALLOC_HEAP_ARRAY, __gc_osalloc_heap_array);
-    const int32_t num_heaps = state_load_i32(GC_SDK_OFF_OSALLOC_NUM_HEAPS, __gc_osalloc_num_heaps);
-    const uint32_t arena_start = state_load_u32(GC_SDK_OFF_OSALLOC_ARENA_START, __gc_osalloc_arena_start);
-    const uint32_t arena_end = state_load_u32(GC_SDK_OFF_OSALLOC_ARENA_END, __gc_osalloc_arena_end);
-
-    if (heap_array == 0) return -1;
-    if (heap < 0 || heap >= num_heaps) return -1;
-
-    const uint32_t hd = heap_array + (uint32_t)heap * (uint32_t)HEAPDESC_SIZE;
-    int32_t hd_size = load_i32be(hd + 0);
-    if (hd_size < 0) return -1;
-
-    long total = 0;
-    long free_bytes = 0;
-
-    // Walk allocated list.
-    uint32_t alloc_head = load_u32be(hd + 8);
-    if (alloc_head != 0 && load_u32be(alloc_head + 0) != 0) return -1; // head->prev must be NULL
-
-    for (uint32_t cell = alloc_head; cell != 0; cell = load_u32be(cell + 4)) {
-        if (cell < arena_start || cell >= arena_end) return -1;
-        if ((cell & (ALIGNMENT - 1)) != 0) return -1;
-        uint32_t cell_next = load_u32be(cell + 4);
-        if (cell_next != 0 && load_u32be(cell_next + 0) != cell) return -1;
-        int32_t cell_size = load_i32be(cell + 8);
-        if (cell_size < 0x40) return -1;
-        if ((cell_size & (ALIGNMENT - 1)) != 0) return -1;
-        total += cell_size;
-        if (total <= 0 || total > hd_size) return -1;
-    }
-
-    // Walk free list.
-    uint32_t free_head = load_u32be(hd + 4);
-    if (free_head != 0 && load_u32be(free_head + 0) != 0) return -1; // head->prev must be NULL
-
-    for (uint32_t cell = free_head; cell != 0; cell = load_u32be(cell + 4)) {
-        if (cell < arena_start || cell >= arena_end) return -1;
-        if ((cell & (ALIGNMENT - 1)) != 0) return -1;
-        uint32_t cell_next = load_u32be(cell + 4);
-        if (cell_next != 0 && load_u32be(cell_next + 0) != cell) return -1;
-        int32_t cell_size = load_i32be(cell + 8);
-        if (cell_size < 0x40) return -1;
-        if ((cell_size & (ALIGNMENT - 1)) != 0) return -1;
-        if (cell_next != 0 && cell + (uint32_t)cell_size >= cell_next) return -1;
-        total += cell_size;
-        free_bytes += cell_size;
-        free_bytes -= 0x20; // HEADERSIZE
-        if (total <= 0 || total > hd_size) return -1;
-    }
-
-    if (total != hd_size) return -1;
-    return free_bytes;
-}
-
 // Minimal extras used by some init paths and debug helpers.
 uint32_t gc_os_alloc_fixed_calls;
 uint32_t gc_os_dump_heap_calls;
@@ -463,7 +1330,8 @@ uint32_t gc_os_alloc_fixed_last_size;
 void *OSAllocFixed(uint32_t size) {
     gc_os_alloc_fixed_calls++;
     gc_os_alloc_fixed_last_size = size;
-    return OSAlloc(size);
+    int curr = (int)state_load_i32(GC_SDK_OFF_OS_CURR_HEAP, __OSCurrHeap);
+    return alloc_from_heap(curr, size, PORT_OSALLOC_PROF_FIXED);
 }
 
 void OSDumpHeap(void) {
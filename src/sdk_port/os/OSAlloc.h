@@ -0,0 +1,141 @@
+/*
+ * sdk_port/os/OSAlloc.h --- Host-side extras of the OSAlloc port.
+ *
+ * The SDK API itself (OSInitAlloc, OSCreateHeap, OSAllocFromHeap, ...) is
+ * declared by the game headers. This header covers what the port adds on
+ * top: heap free-space statistics, incremental and parallel heap checks,
+ * and the allocation profiler.
+ *
+ * Source of truth: external/mp4-decomp/src/dolphin/os/OSAlloc.c
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Power-of-two size classes: class c holds sizes in [64 << c, 128 << c);
+ * the last class is open-ended. */
+#define PORT_OSALLOC_CLASSES 20
+
+/* Heaps with per-heap profiler counters (others are still logged). */
+#define PORT_OSALLOC_PROF_HEAPS 16
+
+/* ── Free-space statistics ── */
+
+typedef struct {
+    uint32_t free_bytes; /* sum of free cell sizes, headers included */
+    uint32_t largest;    /* largest free cell (0 if none) */
+    uint32_t cells;      /* free cells */
+    uint32_t classes[PORT_OSALLOC_CLASSES]; /* free cells per size class */
+} port_OSHeapFreeStats;
+
+/* Fills *out for a live heap. Returns 0, or -1 if the heap does not exist.
+ * Fragmentation is 1 - largest / free_bytes. */
+int port_OSHeapFree(int heap, port_OSHeapFreeStats *out);
+
+/* Property-test hook: 0 if the heap's free-cell index matches its RAM free
+ * list, 1 if the heap is not currently indexed, -1 on a mismatch. */
+int port_OSAllocIndexCheck(int heap);
+
+/* ── Heap checks ──
+ *
+ * Both return what OSCheckHeap would (free bytes, or -1 for a bad heap).
+ *
+ * port_OSCheckHeapIncremental re-validates only the cells allocator calls
+ * touched since the heap's last check and falls back to a full walk on the
+ * first check, on anything suspicious, or when more cells went dirty than
+ * it tracks. Cells no call has touched are not re-read, so damage to them
+ * waits for a full check (OSCheckHeap or port_OSCheckHeaps).
+ *
+ * port_OSCheckHeaps fully checks count heaps into out[], returning how many
+ * failed. Built with GC_OSALLOC_CHECK_THREADS (link with -pthread), the
+ * allocated and free list of every heap are walked on up to
+ * gc_os_check_threads threads; otherwise one after the other.
+ */
+
+#define GC_OSALLOC_CHECK_MAX_THREADS 8u
+
+extern uint32_t gc_os_check_threads;       /* default 4; <= 1 walks inline */
+extern uint32_t gc_os_check_parallel_runs; /* port_OSCheckHeaps calls that used threads */
+
+typedef struct {
+    uint32_t checks; /* port_OSCheckHeapIncremental calls on live heaps */
+    uint32_t full;   /* of those, answered by a full walk */
+    uint32_t cells;  /* dirty cells re-validated */
+} port_OSCheckHeapStats;
+
+long port_OSCheckHeapIncremental(int heap);
+int port_OSCheckHeaps(const int *heaps, int count, long *out);
+/* Running totals since start-up. */
+void port_OSCheckHeapCounters(port_OSCheckHeapStats *out);
+
+/* ── Allocation profiler ──
+ *
+ * While started, every OSAllocFromHeap / OSFreeToHeap / OSAllocFixed /
+ * OSAddToHeap / OSCreateHeap / OSDestroyHeap call is counted per heap and,
+ * if a log file was given, appended to it as one 16-byte record. Summarize
+ * a log with tools/osalloc_prof_summary.py.
+ *
+ * Log layout (all fields little-endian):
+ *   header   "OSAP", u32 version (1), u32 record size (16), u32 reserved
+ *   record   u8 kind, u8 heap (0xFF = none), u16 tag, u32 a, u32 b, u32 c
+ *
+ *   kind      a               b                  c
+ *   ALLOC     user ptr (0 = failed)  size asked  cell taken (0 if failed)
+ *   FIXED     same as ALLOC, for OSAllocFixed
+ *   FREE      user ptr        cell size freed    0
+ *   ADD       region start    region size        0
+ *   CREATE    heap start      heap size          0
+ *   DESTROY   0               0                  0
+ *   HEAP      free bytes      largest free cell  free cells
+ *   FRAME     frame number    0                  0
+ *   NAME      name length     0                  0   (name bytes follow,
+ *                                                     zero-padded to 16)
+ *
+ * The rounded request is round_up(size + 0x20, 32); the cell taken is the
+ * rounded request plus any tail too small to split off (< 0x40 bytes).
+ * port_OSAllocProfFrame writes a HEAP record per live heap, then FRAME:
+ * records before FRAME n belong to frame n.
+ */
+
+enum {
+    PORT_OSALLOC_PROF_ALLOC = 1,
+    PORT_OSALLOC_PROF_FIXED,
+    PORT_OSALLOC_PROF_FREE,
+    PORT_OSALLOC_PROF_ADD,
+    PORT_OSALLOC_PROF_CREATE,
+    PORT_OSALLOC_PROF_DESTROY,
+    PORT_OSALLOC_PROF_HEAP,
+    PORT_OSALLOC_PROF_FRAME,
+    PORT_OSALLOC_PROF_NAME
+};
+
+#define PORT_OSALLOC_PROF_MAGIC   0x5041534Fu /* "OSAP" read little-endian */
+#define PORT_OSALLOC_PROF_VERSION 1u
+#define PORT_OSALLOC_PROF_RECORD  16u
+
+typedef struct {
+    uint32_t allocs;      /* successful allocations (OSAllocFixed included) */
+    uint32_t failed;      /* allocations that returned NULL */
+    uint32_t frees;
+    uint32_t live_bytes;  /* bytes of allocated cells, headers included */
+    uint32_t peak_bytes;
+    uint32_t live_blocks;
+    uint32_t peak_blocks;
+    uint32_t alloc_classes[PORT_OSALLOC_CLASSES]; /* allocations per class of the rounded request */
+} port_OSAllocProfHeap;
+
+/* Start profiling; counters restart from zero. log may be NULL (counters
+ * only); it stays owned by the caller. Returns 1, or 0 if the header could
+ * not be written. */
+int port_OSAllocProfStart(FILE *log);
+/* Stop profiling and flush the log. Counters stay readable. */
+void port_OSAllocProfStop(void);
+/* Tag attributed to the following calls (sticky; 0 = untagged). */
+void port_OSAllocProfTag(uint16_t tag);
+/* Name a tag in the log. */
+void port_OSAllocProfName(uint16_t tag, const char *name);
+/* End of a frame: snapshot the free space of every live heap. */
+void port_OSAllocProfFrame(void);
+/* Copy a heap's counters. Returns 0, or -1 if heap is out of range. */
+int port_OSAllocProfHeapStats(int heap, port_OSAllocProfHeap *out);
@@ -1,7 +1,11 @@
 #include <stdint.h>
 
+#include "../gc_mem.h"
+
 // Minimal cache API surface for deterministic tests.
 // We do not model cache behavior; we only record the call args.
+// Each call also reports its range through gc_mem_notify_write: it is the point
+// where new bytes become visible to non-CPU readers (the GX display list cache).
 
 uint32_t gc_dc_store_last_addr;
 uint32_t gc_dc_store_last_len;
@@ -19,15 +23,18 @@ uint32_t gc_dc_flush_last_len;
 __attribute__((weak)) void DCStoreRangeNoSync(void *addr, uint32_t nbytes) {
     gc_dc_store_last_addr = (uint32_t)(uintptr_t)addr;
     gc_dc_store_last_len = nbytes;
+    gc_mem_notify_write(gc_dc_store_last_addr, nbytes);
 }
 
 // Used by MP4 callsites (dvd.c, thp, gfx code). We record args for deterministic tests.
 __attribute__((weak)) void DCInvalidateRange(void *addr, uint32_t nbytes) {
     gc_dc_inval_last_addr = (uint32_t)(uintptr_t)addr;
     gc_dc_inval_last_len = nbytes;
+    gc_mem_notify_write(gc_dc_inval_last_addr, nbytes);
 }
 
 __attribute__((weak)) void DCFlushRange(void *addr, uint32_t nbytes) {
     gc_dc_flush_last_addr = (uint32_t)(uintptr_t)addr;
     gc_dc_flush_last_len = nbytes;
+    gc_mem_notify_write(gc_dc_flush_last_addr, nbytes);
 }
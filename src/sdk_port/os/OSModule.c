@@ -1,8 +1,16 @@
 #include "dolphin/os.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include "OSModule.h"
+#include "../gc_host_clock.h"
+#include "../gc_mem.h"
+
 // Minimal module linker state used by MP4 objdll path.
-// This is intentionally small: enough queue/link bookkeeping for deterministic
-// host/runtime progression; relocation semantics are handled separately.
+// OSLink / OSUnlink only do queue/link bookkeeping on host structs, enough
+// for deterministic host/runtime progression. Relocation of RAM-resident REL
+// images is port_OSLinkRel / port_OSUnlinkRel below.
 
 OSModuleQueue __OSModuleInfoList = {0};
 const void *__OSStringTable = 0;
@@ -64,3 +72,963 @@ BOOL OSUnlink(OSModuleInfo *oldModule) {
     OSNotifyUnlink();
     return TRUE;
 }
+
+// ── REL linker (OSModule.h) ──
+//
+// port_OSLinkRel / port_OSUnlinkRel follow the SDK's Link / OSUnlink on a
+// big-endian REL image in gc_mem. Relocate and Undo either walk the import's
+// relocation stream (the SDK's way) or apply a decoded fixup plan.
+
+static inline uint32_t rel_ld32(uint32_t addr) {
+    const uint8_t *p = gc_mem_ptr(addr, 4);
+    if (!p) return 0;
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline uint8_t rel_ld8(uint32_t addr) {
+    const uint8_t *p = gc_mem_ptr(addr, 1);
+    return p ? p[0] : 0;
+}
+
+static inline void rel_st32(uint32_t addr, uint32_t val) {
+    uint8_t *p = gc_mem_ptr(addr, 4);
+    if (!p) return;
+    p[0] = (uint8_t)(val >> 24);
+    p[1] = (uint8_t)(val >> 16);
+    p[2] = (uint8_t)(val >> 8);
+    p[3] = (uint8_t)val;
+}
+
+static inline void rel_st16(uint32_t addr, uint32_t val) {
+    uint8_t *p = gc_mem_ptr(addr, 2);
+    if (!p) return;
+    p[0] = (uint8_t)(val >> 8);
+    p[1] = (uint8_t)val;
+}
+
+static inline void rel_mask32(uint32_t addr, uint32_t mask, uint32_t x) {
+    rel_st32(addr, (rel_ld32(addr) & ~mask) | (x & mask));
+}
+
+static inline uint32_t rel_ha(uint32_t x) {
+    return ((x >> 16) + ((x & 0x8000u) ? 1u : 0u)) & 0xFFFFu;
+}
+
+static port_OSLinkStats s_link_stats;
+
+// Section start of a linked module (executable bit stripped).
+static uint32_t rel_section_base(uint32_t module, uint32_t section) {
+    const uint32_t si = rel_ld32(module + PORT_REL_SECTION_INFO);
+    return rel_ld32(si + section * PORT_REL_SECTION_SIZE) & ~PORT_REL_SECTION_EXEC;
+}
+
+// DCFlushRange / ICInvalidateRange of an executable section after patching.
+static void rel_flush_section(uint32_t module, uint32_t section) {
+    const uint32_t si = rel_ld32(module + PORT_REL_SECTION_INFO) + section * PORT_REL_SECTION_SIZE;
+    const uint32_t off = rel_ld32(si);
+    const uint32_t size = rel_ld32(si + 4);
+
+    if ((off & PORT_REL_SECTION_EXEC) && size) {
+        gc_mem_notify_write(off & ~PORT_REL_SECTION_EXEC, size);
+    }
+}
+
+// Address of the relocations `module` imports from module id `id` (0 if
+// none). The module must be linked (absolute import offsets).
+static uint32_t rel_find_import(uint32_t module, uint32_t id) {
+    const uint32_t imp = rel_ld32(module + PORT_REL_IMP_OFFSET);
+    const uint32_t end = imp + rel_ld32(module + PORT_REL_IMP_SIZE);
+    uint32_t p;
+
+    for (p = imp; p < end; p += PORT_REL_IMP_ENTRY_SIZE) {
+        if (rel_ld32(p) == id) return rel_ld32(p + 4);
+    }
+    return 0;
+}
+
+// Unknown relocations met while linking, recorded for the overlay cache
+// as (patching module, type): 0 = main program.
+#define OVERLAY_REPORTS  32
+#define OVERLAY_NOT_SELF 0xFFFFFFFFu // patching another module: not recorded
+
+typedef struct {
+    uint32_t from;
+    uint32_t type;
+} OverlayReport;
+
+static int s_ov_recording;
+static uint32_t s_ov_rec_from;
+static OverlayReport s_ov_rec[OVERLAY_REPORTS];
+static uint32_t s_ov_rec_count; // may exceed OVERLAY_REPORTS: not cacheable
+
+static void rel_unknown(uint32_t type, int undo) {
+    s_link_stats.unknown++;
+    if (s_ov_recording && !undo && s_ov_rec_from != OVERLAY_NOT_SELF) {
+        if (s_ov_rec_count < OVERLAY_REPORTS) {
+            s_ov_rec[s_ov_rec_count].from = s_ov_rec_from;
+            s_ov_rec[s_ov_rec_count].type = type;
+        }
+        s_ov_rec_count++;
+    }
+    if (undo) {
+        OSReport("OSUnlink: unknown relocation type %3d\n", (int)type);
+    } else {
+        OSReport("OSLink: unknown relocation type %3d\n", (int)type);
+    }
+}
+
+// Relocate (undo = 0) or Undo (undo = 1) by walking the stream: patch
+// `module`'s references to `target` (0 = the main program, for Relocate).
+static void rel_walk(uint32_t target, uint32_t module, int undo) {
+    const uint32_t id = target ? rel_ld32(target + PORT_REL_ID) : 0;
+    const uint32_t unresolved = rel_ld32(module + PORT_REL_UNRESOLVED);
+    uint32_t rel = rel_find_import(module, id);
+    uint32_t p = 0;
+    int flush = -1;
+
+    if (!rel) return;
+    for (;; rel += PORT_REL_RELOC_SIZE) {
+        const uint32_t type = rel_ld8(rel + 2);
+        const uint32_t section = rel_ld8(rel + 3);
+        const uint32_t addend = rel_ld32(rel + 4);
+        uint32_t x;
+
+        if (type == PORT_R_DOLPHIN_END) break;
+        p += ((uint32_t)rel_ld8(rel) << 8) | rel_ld8(rel + 1);
+        x = undo ? 0 : (id ? rel_section_base(target, section) : 0) + addend;
+        switch (type) {
+        case PORT_R_PPC_NONE:
+        case PORT_R_DOLPHIN_NOP:
+            continue;
+        case PORT_R_PPC_ADDR32:
+            rel_st32(p, x);
+            break;
+        case PORT_R_PPC_ADDR24:
+            rel_mask32(p, 0x03FFFFFCu, x);
+            break;
+        case PORT_R_PPC_ADDR16:
+        case PORT_R_PPC_ADDR16_LO:
+            rel_st16(p, x & 0xFFFFu);
+            break;
+        case PORT_R_PPC_ADDR16_HI:
+            rel_st16(p, x >> 16);
+            break;
+        case PORT_R_PPC_ADDR16_HA:
+            rel_st16(p, rel_ha(x));
+            break;
+        case PORT_R_PPC_ADDR14:
+        case PORT_R_PPC_ADDR14_BRTAKEN:
+        case PORT_R_PPC_ADDR14_BRNTAKEN:
+            rel_mask32(p, 0x0000FFFCu, x);
+            break;
+        case PORT_R_PPC_REL24:
+            if (!undo) {
+                rel_mask32(p, 0x03FFFFFCu, x - p);
+            } else if (unresolved) {
+                rel_mask32(p, 0x03FFFFFCu, unresolved - p);
+            } else {
+                continue;
+            }
+            break;
+        case PORT_R_PPC_REL14:
+        case PORT_R_PPC_REL14_BRTAKEN:
+        case PORT_R_PPC_REL14_BRNTAKEN:
+            rel_mask32(p, 0x0000FFFCu, undo ? 0 : x - p);
+            break;
+        case PORT_R_DOLPHIN_SECTION:
+            p = rel_section_base(module, section);
+            if (flush >= 0) rel_flush_section(module, (uint32_t)flush);
+            flush = (int)section;
+            continue;
+        default:
+            rel_unknown(type, undo);
+            continue;
+        }
+        s_link_stats.relocs++;
+    }
+    if (flush >= 0) rel_flush_section(module, (uint32_t)flush);
+}
+
+// ── Fixup plans ──
+//
+// A plan is a module's relocation streams decoded once: per import, runs of
+// same-type patches, each patch a (section, offset) to write and a (target
+// section, addend) to write there. Only the section bases are looked up at
+// link time, so one plan serves the module at any load address.
+
+#define PLAN_ABS 0xFFFFu // patch before any R_DOLPHIN_SECTION: p is absolute
+
+typedef struct {
+    uint32_t where; // offset from the section start
+    uint32_t addend;
+    uint16_t sec; // patched section of the module, or PLAN_ABS
+    uint16_t tsec; // section of the imported module
+} PlanOp;
+
+typedef struct {
+    uint32_t type;
+    uint32_t first, count; // ops
+} PlanRun;
+
+typedef struct {
+    uint32_t id;
+    uint32_t first, count; // runs
+    uint32_t sec_first, sec_count; // patched sections, in order (flushes)
+} PlanImport;
+
+typedef struct {
+    uint32_t id;
+    uint64_t hash;
+    uint32_t refs; // linked modules using it
+    uint64_t used; // LRU stamp
+    PlanImport *imports;
+    uint32_t nimports;
+    PlanRun *runs;
+    uint32_t nruns;
+    PlanOp *ops;
+    uint32_t nops;
+    uint16_t *secs;
+    uint32_t nsecs;
+} Plan;
+
+typedef struct {
+    uint32_t module;
+    Plan *plan;
+} LinkedRel;
+
+static Plan **s_plans;
+static uint32_t s_plan_count;
+static LinkedRel *s_linked;
+static uint32_t s_linked_count, s_linked_cap;
+
+static int plan_reserve(void **arr, uint32_t *cap, uint32_t need, size_t elem) {
+    void *p;
+    uint32_t n;
+
+    if (need <= *cap) return 1;
+    n = *cap ? *cap * 2u : 16u;
+    while (n < need) n *= 2u;
+    p = realloc(*arr, (size_t)n * elem);
+    if (!p) return 0;
+    *arr = p;
+    *cap = n;
+    return 1;
+}
+
+static void plan_free(Plan *pl) {
+    if (!pl) return;
+    free(pl->imports);
+    free(pl->runs);
+    free(pl->ops);
+    free(pl->secs);
+    free(pl);
+}
+
+static void linked_set(uint32_t module, Plan *pl) {
+    uint32_t i;
+    for (i = 0; i < s_linked_count; i++) {
+        if (s_linked[i].module == module) {
+            if (s_linked[i].plan) s_linked[i].plan->refs--;
+            if (pl) {
+                s_linked[i].plan = pl;
+                pl->refs++;
+            } else {
+                s_linked[i] = s_linked[--s_linked_count];
+            }
+            return;
+        }
+    }
+    if (!pl || !plan_reserve((void **)&s_linked, &s_linked_cap, s_linked_count + 1u, sizeof(LinkedRel))) return;
+    s_linked[s_linked_count].module = module;
+    s_linked[s_linked_count].plan = pl;
+    s_linked_count++;
+    pl->refs++;
+}
+
+#ifndef GC_OSLINK_NO_PLAN
+// Relocation streams end with R_DOLPHIN_END; a stream this long is junk.
+#define PLAN_MAX_STREAM (1u << 24)
+
+static uint32_t s_plan_cap;
+static uint64_t s_plan_clock;
+
+static inline uint64_t plan_mix(uint64_t h, uint32_t w) {
+    h ^= w;
+    return h * 0x100000001B3ull;
+}
+
+// Hash of an unlinked module's import table and relocation streams.
+static uint64_t plan_hash(uint32_t module) {
+    const uint32_t imp = module + rel_ld32(module + PORT_REL_IMP_OFFSET);
+    const uint32_t size = rel_ld32(module + PORT_REL_IMP_SIZE);
+    uint64_t h = plan_mix(0xCBF29CE484222325ull, rel_ld32(module + PORT_REL_ID));
+    uint32_t i;
+
+    h = plan_mix(h, size);
+    for (i = 0; i < size; i += PORT_REL_IMP_ENTRY_SIZE) {
+        const uint32_t off = rel_ld32(imp + i + 4);
+        const uint8_t *rel;
+        uint32_t n;
+
+        h = plan_mix(plan_mix(h, rel_ld32(imp + i)), off);
+        for (n = 0; n < PLAN_MAX_STREAM; n++) {
+            rel = gc_mem_ptr(module + off + n * PORT_REL_RELOC_SIZE, PORT_REL_RELOC_SIZE);
+            if (!rel) break;
+            h = plan_mix(h, ((uint32_t)rel[0] << 24) | ((uint32_t)rel[1] << 16) |
+                            ((uint32_t)rel[2] << 8) | rel[3]);
+            h = plan_mix(h, ((uint32_t)rel[4] << 24) | ((uint32_t)rel[5] << 16) |
+                            ((uint32_t)rel[6] << 8) | rel[7]);
+            if (rel[2] == PORT_R_DOLPHIN_END) break;
+        }
+    }
+    return h;
+}
+
+// Decode an unlinked module's streams. NULL if out of memory.
+static Plan *plan_build(uint32_t module, uint64_t hash) {
+    const uint32_t imp = module + rel_ld32(module + PORT_REL_IMP_OFFSET);
+    const uint32_t size = rel_ld32(module + PORT_REL_IMP_SIZE);
+    uint32_t cap_imp = 0, cap_run = 0, cap_op = 0, cap_sec = 0;
+    Plan *pl = (Plan *)calloc(1, sizeof(*pl));
+    uint32_t i;
+
+    if (!pl) return NULL;
+    pl->id = rel_ld32(module + PORT_REL_ID);
+    pl->hash = hash;
+    for (i = 0; i < size; i += PORT_REL_IMP_ENTRY_SIZE) {
+        uint32_t rel = module + rel_ld32(imp + i + 4);
+        uint32_t where = 0, n;
+        uint16_t sec = PLAN_ABS;
+        PlanImport *pi;
+
+        if (!plan_reserve((void **)&pl->imports, &cap_imp, pl->nimports + 1u, sizeof(PlanImport))) goto fail;
+        pi = &pl->imports[pl->nimports++];
+        pi->id = rel_ld32(imp + i);
+        pi->first = pl->nruns;
+        pi->count = 0;
+        pi->sec_first = pl->nsecs;
+        pi->sec_count = 0;
+
+        for (n = 0; n < PLAN_MAX_STREAM; n++, rel += PORT_REL_RELOC_SIZE) {
+            const uint8_t *r = gc_mem_ptr(rel, PORT_REL_RELOC_SIZE);
+            uint32_t type;
+            PlanOp *op;
+
+            if (!r || r[2] == PORT_R_DOLPHIN_END) break;
+            type = r[2];
+            where += ((uint32_t)r[0] << 8) | r[1];
+            if (type == PORT_R_PPC_NONE || type == PORT_R_DOLPHIN_NOP) continue;
+            if (type == PORT_R_DOLPHIN_SECTION) {
+                sec = r[3];
+                where = 0;
+                if (!plan_reserve((void **)&pl->secs, &cap_sec, pl->nsecs + 1u, sizeof(uint16_t))) goto fail;
+                pl->secs[pl->nsecs++] = sec;
+                pi->sec_count++;
+                continue;
+            }
+            if (!plan_reserve((void **)&pl->ops, &cap_op, pl->nops + 1u, sizeof(PlanOp))) goto fail;
+            op = &pl->ops[pl->nops++];
+            op->where = where;
+            op->addend = ((uint32_t)r[4] << 24) | ((uint32_t)r[5] << 16) |
+                         ((uint32_t)r[6] << 8) | r[7];
+            op->sec = sec;
+            op->tsec = r[3];
+            if (pi->count == 0 || pl->runs[pl->nruns - 1u].type != type) {
+                if (!plan_reserve((void **)&pl->runs, &cap_run, pl->nruns + 1u, sizeof(PlanRun))) goto fail;
+                pl->runs[pl->nruns].type = type;
+                pl->runs[pl->nruns].first = pl->nops - 1u;
+                pl->runs[pl->nruns].count = 0;
+                pl->nruns++;
+                pi->count++;
+            }
+            pl->runs[pl->nruns - 1u].count++;
+        }
+    }
+    s_link_stats.plan_built++;
+    return pl;
+
+fail:
+    plan_free(pl);
+    return NULL;
+}
+
+// Cached plan for an unlinked module, decoding it on a miss.
+static Plan *plan_get(uint32_t module) {
+    const uint32_t id = rel_ld32(module + PORT_REL_ID);
+    const uint64_t hash = plan_hash(module);
+    Plan *pl;
+    uint32_t i;
+
+    for (i = 0; i < s_plan_count; i++) {
+        if (s_plans[i]->id == id && s_plans[i]->hash == hash) {
+            s_plans[i]->used = ++s_plan_clock;
+            s_link_stats.plan_hits++;
+            return s_plans[i];
+        }
+    }
+    pl = plan_build(module, hash);
+    if (!pl) return NULL;
+    if (!plan_reserve((void **)&s_plans, &s_plan_cap, s_plan_count + 1u, sizeof(Plan *))) {
+        plan_free(pl);
+        return NULL;
+    }
+    pl->used = ++s_plan_clock;
+    s_plans[s_plan_count++] = pl;
+
+    // Evict the least recently used plan no linked module holds.
+    while (s_plan_count > PORT_OSLINK_PLANS) {
+        uint32_t victim = s_plan_count;
+        for (i = 0; i < s_plan_count; i++) {
+            if (s_plans[i]->refs == 0 && s_plans[i] != pl &&
+                (victim == s_plan_count || s_plans[i]->used < s_plans[victim]->used)) {
+                victim = i;
+            }
+        }
+        if (victim == s_plan_count) break;
+        plan_free(s_plans[victim]);
+        s_plans[victim] = s_plans[--s_plan_count];
+    }
+    return pl;
+}
+
+static Plan *linked_plan(uint32_t module) {
+    uint32_t i;
+    for (i = 0; i < s_linked_count; i++) {
+        if (s_linked[i].module == module) return s_linked[i].plan;
+    }
+    return NULL;
+}
+
+// Section bases of a linked module, for the plan loops.
+#define PLAN_BASES 256
+static uint32_t s_base_mod[PLAN_BASES];
+static uint32_t s_base_tgt[PLAN_BASES];
+
+static void plan_bases(uint32_t module, uint32_t *out) {
+    const uint32_t si = rel_ld32(module + PORT_REL_SECTION_INFO);
+    uint32_t n = rel_ld32(module + PORT_REL_NUM_SECTIONS), i;
+
+    if (n > PLAN_BASES) n = PLAN_BASES;
+    for (i = 0; i < n; i++) out[i] = rel_ld32(si + i * PORT_REL_SECTION_SIZE) & ~PORT_REL_SECTION_EXEC;
+    for (; i < PLAN_BASES; i++) out[i] = rel_section_base(module, i);
+}
+
+#define PLAN_P(op) (((op)->sec == PLAN_ABS ? 0u : s_base_mod[(op)->sec]) + (op)->where)
+
+// Relocate / Undo with `module`'s plan: patch its references to `target`.
+static void plan_apply(const Plan *pl, uint32_t target, uint32_t module, int undo) {
+    const uint32_t id = target ? rel_ld32(target + PORT_REL_ID) : 0;
+    const PlanImport *pi = NULL;
+    uint32_t i, r;
+
+    for (i = 0; i < pl->nimports; i++) {
+        if (pl->imports[i].id == id) {
+            pi = &pl->imports[i];
+            break;
+        }
+    }
+    if (!pi) return;
+
+    plan_bases(module, s_base_mod);
+    if (id && !undo) {
+        plan_bases(target, s_base_tgt);
+    } else {
+        memset(s_base_tgt, 0, sizeof(s_base_tgt));
+    }
+
+    for (r = pi->first; r < pi->first + pi->count; r++) {
+        const PlanRun *run = &pl->runs[r];
+        const PlanOp *op = &pl->ops[run->first];
+        const PlanOp *end = op + run->count;
+
+        switch (run->type) {
+        case PORT_R_PPC_ADDR32:
+            for (; op < end; op++) rel_st32(PLAN_P(op), undo ? 0 : s_base_tgt[op->tsec] + op->addend);
+            break;
+        case PORT_R_PPC_ADDR24:
+            for (; op < end; op++) {
+                rel_mask32(PLAN_P(op), 0x03FFFFFCu, undo ? 0 : s_base_tgt[op->tsec] + op->addend);
+            }
+            break;
+        case PORT_R_PPC_ADDR16:
+        case PORT_R_PPC_ADDR16_LO:
+            for (; op < end; op++) rel_st16(PLAN_P(op), undo ? 0 : (s_base_tgt[op->tsec] + op->addend) & 0xFFFFu);
+            break;
+        case PORT_R_PPC_ADDR16_HI:
+            for (; op < end; op++) rel_st16(PLAN_P(op), undo ? 0 : (s_base_tgt[op->tsec] + op->addend) >> 16);
+            break;
+        case PORT_R_PPC_ADDR16_HA:
+            for (; op < end; op++) rel_st16(PLAN_P(op), undo ? 0 : rel_ha(s_base_tgt[op->tsec] + op->addend));
+            break;
+        case PORT_R_PPC_ADDR14:
+        case PORT_R_PPC_ADDR14_BRTAKEN:
+        case PORT_R_PPC_ADDR14_BRNTAKEN:
+            for (; op < end; op++) {
+                rel_mask32(PLAN_P(op), 0x0000FFFCu, undo ? 0 : s_base_tgt[op->tsec] + op->addend);
+            }
+            break;
+        case PORT_R_PPC_REL24:
+            if (undo) {
+                const uint32_t unresolved = rel_ld32(module + PORT_REL_UNRESOLVED);
+                if (!unresolved) continue;
+                for (; op < end; op++) {
+                    const uint32_t p = PLAN_P(op);
+                    rel_mask32(p, 0x03FFFFFCu, unresolved - p);
+                }
+            } else {
+                for (; op < end; op++) {
+                    const uint32_t p = PLAN_P(op);
+                    rel_mask32(p, 0x03FFFFFCu, s_base_tgt[op->tsec] + op->addend - p);
+                }
+            }
+            break;
+        case PORT_R_PPC_REL14:
+        case PORT_R_PPC_REL14_BRTAKEN:
+        case PORT_R_PPC_REL14_BRNTAKEN:
+            for (; op < end; op++) {
+                const uint32_t p = PLAN_P(op);
+                rel_mask32(p, 0x0000FFFCu, undo ? 0 : s_base_tgt[op->tsec] + op->addend - p);
+            }
+            break;
+        default:
+            for (; op < end; op++) rel_unknown(run->type, undo);
+            continue;
+        }
+        s_link_stats.relocs += run->count;
+    }
+    for (i = 0; i < pi->sec_count; i++) rel_flush_section(module, pl->secs[pi->sec_first + i]);
+}
+
+#endif // GC_OSLINK_NO_PLAN
+
+static void rel_relocate(uint32_t target, uint32_t module, int undo) {
+#ifndef GC_OSLINK_NO_PLAN
+    const Plan *pl = linked_plan(module);
+    if (pl) {
+        plan_apply(pl, target, module, undo);
+        return;
+    }
+#endif
+    rel_walk(target, module, undo);
+}
+
+// ── Overlay cache (OSModule.h) ──
+//
+// An entry is the linked image [module, module + size) as port_OSLinkRel
+// left it, plus the linked modules it imports from at that time, in list
+// order. The same modules at the same places (same section tables) make
+// the same relocations, so the image can be restored as is.
+
+#define OVERLAY_DEPS    16
+#define OVERLAY_IMPORTS 64
+
+typedef struct {
+    uint32_t id;
+    uint32_t addr;
+    uint64_t layout; // hash of its section table
+} OverlayDep;
+
+typedef struct {
+    uint32_t id, module, bss; // key
+    uint8_t *image;
+    uint32_t size;
+    uint64_t used;
+    uint64_t plan_hash;
+    int has_plan;
+    uint32_t ndeps;
+    OverlayDep deps[OVERLAY_DEPS];
+    uint32_t nreports;
+    OverlayReport reports[OVERLAY_REPORTS]; // replayed on a hit
+} Overlay;
+
+static Overlay s_ov[PORT_OSOVERLAY_MAX];
+static uint32_t s_ov_count;
+static uint32_t s_ov_budget;
+static uint64_t s_ov_clock;
+static port_OSOverlayStats s_ov_stats;
+
+// Bytes of an unlinked REL that linking reads or patches: header, tables,
+// relocation streams and the sections stored in the file.
+static uint32_t rel_image_size(uint32_t module) {
+    const uint32_t version = rel_ld32(module + PORT_REL_VERSION);
+    const uint32_t si = rel_ld32(module + PORT_REL_SECTION_INFO);
+    const uint32_t n = rel_ld32(module + PORT_REL_NUM_SECTIONS);
+    const uint32_t imp = rel_ld32(module + PORT_REL_IMP_OFFSET);
+    const uint32_t imp_size = rel_ld32(module + PORT_REL_IMP_SIZE);
+    uint32_t end = version >= 3 ? 0x4Cu : version == 2 ? 0x48u : 0x40u;
+    uint32_t i, k;
+
+#define OV_END(x) do { if ((x) > end) end = (x); } while (0)
+    OV_END(si + n * PORT_REL_SECTION_SIZE);
+    OV_END(imp + imp_size);
+    for (i = 0; i < n; i++) {
+        const uint32_t off = rel_ld32(module + si + i * PORT_REL_SECTION_SIZE) & ~PORT_REL_SECTION_EXEC;
+        if (off) OV_END(off + rel_ld32(module + si + i * PORT_REL_SECTION_SIZE + 4));
+    }
+    for (i = 0; i < imp_size; i += PORT_REL_IMP_ENTRY_SIZE) {
+        const uint32_t rel = rel_ld32(module + imp + i + 4);
+        for (k = 0; k < (1u << 24); k++) {
+            const uint8_t *r = gc_mem_ptr(module + rel + k * PORT_REL_RELOC_SIZE, PORT_REL_RELOC_SIZE);
+            if (!r || r[2] == PORT_R_DOLPHIN_END) break;
+        }
+        OV_END(rel + (k + 1u) * PORT_REL_RELOC_SIZE);
+    }
+#undef OV_END
+    return end;
+}
+
+static uint64_t ov_layout(uint32_t module) {
+    const uint32_t si = rel_ld32(module + PORT_REL_SECTION_INFO);
+    const uint32_t n = rel_ld32(module + PORT_REL_NUM_SECTIONS);
+    uint64_t h = 0xCBF29CE484222325ull;
+    uint32_t i;
+
+    for (i = 0; i < n * 2u; i++) h = (h ^ rel_ld32(si + i * 4u)) * 0x100000001B3ull;
+    return h;
+}
+
+// Linked modules (other than `module`) whose id is in ids[], in list order.
+// Returns the count, or -1 if there are more than OVERLAY_DEPS.
+static int ov_deps(const port_OSModuleState *st, uint32_t module, const uint32_t *ids, uint32_t nids,
+                   OverlayDep *out) {
+    uint32_t m, i;
+    int n = 0;
+
+    for (m = st->head; m; m = rel_ld32(m + PORT_REL_NEXT)) {
+        const uint32_t id = rel_ld32(m + PORT_REL_ID);
+        if (m == module) continue;
+        for (i = 0; i < nids && ids[i] != id; i++) {}
+        if (i == nids) continue;
+        if (n == OVERLAY_DEPS) return -1;
+        out[n].id = id;
+        out[n].addr = m;
+        out[n].layout = ov_layout(m);
+        n++;
+    }
+    return n;
+}
+
+static void ov_drop(uint32_t i) {
+    s_ov_stats.bytes -= s_ov[i].size;
+    free(s_ov[i].image);
+    s_ov[i] = s_ov[--s_ov_count];
+    s_ov_stats.entries = s_ov_count;
+}
+
+static Overlay *ov_find(uint32_t id, uint32_t module, uint32_t bss) {
+    uint32_t i;
+    for (i = 0; i < s_ov_count; i++) {
+        if (s_ov[i].id == id && s_ov[i].module == module && s_ov[i].bss == bss) return &s_ov[i];
+    }
+    return NULL;
+}
+
+// Keep a copy of a module port_OSLinkRel just linked.
+static void ov_capture(const port_OSModuleState *st, uint32_t module, uint32_t bss, uint32_t size,
+                       const Plan *pl) {
+    const uint32_t id = rel_ld32(module + PORT_REL_ID);
+    const uint32_t imp = rel_ld32(module + PORT_REL_IMP_OFFSET);
+    const uint32_t nids = rel_ld32(module + PORT_REL_IMP_SIZE) / PORT_REL_IMP_ENTRY_SIZE;
+    const uint8_t *src = gc_mem_ptr(module, size);
+    uint32_t ids[OVERLAY_IMPORTS], i;
+    OverlayDep deps[OVERLAY_DEPS];
+    Overlay *ov;
+    uint8_t *copy;
+    int ndeps;
+
+    // Whatever was cached under this key is out of date now.
+    ov = ov_find(id, module, bss);
+    if (ov) ov_drop((uint32_t)(ov - s_ov));
+
+    if (!src || size > s_ov_budget || nids > OVERLAY_IMPORTS || s_ov_rec_count > OVERLAY_REPORTS) return;
+    for (i = 0; i < nids; i++) ids[i] = rel_ld32(imp + i * PORT_REL_IMP_ENTRY_SIZE);
+    ndeps = ov_deps(st, module, ids, nids, deps);
+    if (ndeps < 0) return;
+
+    while (s_ov_count && (s_ov_count == PORT_OSOVERLAY_MAX || s_ov_stats.bytes + size > s_ov_budget)) {
+        uint32_t victim = 0;
+        for (i = 1; i < s_ov_count; i++) {
+            if (s_ov[i].used < s_ov[victim].used) victim = i;
+        }
+        ov_drop(victim);
+        s_ov_stats.evictions++;
+    }
+    copy = (uint8_t *)malloc(size);
+    if (!copy) return;
+    memcpy(copy, src, size);
+
+    ov = &s_ov[s_ov_count++];
+    ov->id = id;
+    ov->module = module;
+    ov->bss = bss;
+    ov->image = copy;
+    ov->size = size;
+    ov->used = ++s_ov_clock;
+    ov->has_plan = pl != NULL;
+    ov->plan_hash = pl ? pl->hash : 0;
+    ov->ndeps = (uint32_t)ndeps;
+    memcpy(ov->deps, deps, sizeof(OverlayDep) * (size_t)ndeps);
+    ov->nreports = s_ov_rec_count;
+    memcpy(ov->reports, s_ov_rec, sizeof(OverlayReport) * s_ov_rec_count);
+    s_ov_stats.captures++;
+    s_ov_stats.entries = s_ov_count;
+    s_ov_stats.bytes += size;
+}
+
+// Reports the module's own relocations made from `from` at capture.
+static void ov_replay(const Overlay *ov, uint32_t from) {
+    uint32_t i;
+    for (i = 0; i < ov->nreports; i++) {
+        if (ov->reports[i].from == from) rel_unknown(ov->reports[i].type, 0);
+    }
+}
+
+static inline uint32_t ov_img32(const Overlay *ov, uint32_t addr) {
+    const uint8_t *p = ov->image + (addr - ov->module);
+    if (addr < ov->module || addr - ov->module > ov->size - 4u) return 0;
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+void port_OSOverlayCacheInit(uint32_t budget) {
+    while (s_ov_count) ov_drop(s_ov_count - 1u);
+    memset(&s_ov_stats, 0, sizeof(s_ov_stats));
+    s_ov_budget = budget;
+}
+
+int port_OSOverlayLink(port_OSModuleState *st, uint32_t id, uint32_t module, uint32_t bss) {
+    const uint64_t t0 = s_ov_budget ? gc_host_ns() : 0;
+    uint32_t ids[OVERLAY_IMPORTS], nids, imp, i, m;
+    OverlayDep deps[OVERLAY_DEPS];
+    Overlay *ov;
+    uint8_t *dst;
+    int ndeps;
+
+    if (!s_ov_budget) return 0;
+    ov = ov_find(id, module, bss);
+    for (m = st->head; ov && m; m = rel_ld32(m + PORT_REL_NEXT)) {
+        if (m == module) ov = NULL; // already linked there
+    }
+    dst = ov ? gc_mem_ptr(module, ov->size) : NULL;
+    if (!dst) {
+        s_ov_stats.misses++;
+        return 0;
+    }
+
+    // Same linked imports at the same places as at capture?
+    imp = ov_img32(ov, module + PORT_REL_IMP_OFFSET);
+    nids = ov_img32(ov, module + PORT_REL_IMP_SIZE) / PORT_REL_IMP_ENTRY_SIZE;
+    if (nids > OVERLAY_IMPORTS) nids = OVERLAY_IMPORTS;
+    for (i = 0; i < nids; i++) ids[i] = ov_img32(ov, imp + i * PORT_REL_IMP_ENTRY_SIZE);
+    ndeps = ov_deps(st, module, ids, nids, deps);
+    if (ndeps != (int)ov->ndeps || memcmp(deps, ov->deps, sizeof(OverlayDep) * (size_t)ov->ndeps) != 0) {
+        s_ov_stats.stale++;
+        s_ov_stats.misses++;
+        return 0;
+    }
+
+    memcpy(dst, ov->image, ov->size);
+    gc_mem_notify_write(module, ov->size);
+    ov->used = ++s_ov_clock;
+
+    rel_st32(module + PORT_REL_NEXT, 0);
+    rel_st32(module + PORT_REL_PREV, st->tail);
+    if (st->tail) {
+        rel_st32(st->tail + PORT_REL_NEXT, module);
+    } else {
+        st->head = module;
+    }
+    st->tail = module;
+
+#ifndef GC_OSLINK_NO_PLAN
+    if (ov->has_plan) {
+        for (i = 0; i < s_plan_count; i++) {
+            if (s_plans[i]->id == id && s_plans[i]->hash == ov->plan_hash) {
+                s_plans[i]->used = ++s_plan_clock;
+                linked_set(module, s_plans[i]);
+                break;
+            }
+        }
+    }
+#endif
+    // The image already holds its own relocations; the importers of it
+    // were undone when it was unlinked. Link's reports come out in order.
+    ov_replay(ov, 0);
+    for (m = st->head; m; m = rel_ld32(m + PORT_REL_NEXT)) {
+        if (m != module) rel_relocate(module, m, 0);
+        ov_replay(ov, m);
+    }
+
+    {
+        const uint32_t bss_size = rel_ld32(module + PORT_REL_BSS_SIZE);
+        uint8_t *p = bss_size ? gc_mem_ptr(bss, bss_size) : NULL;
+        if (p) memset(p, 0, bss_size);
+    }
+    s_link_stats.links++;
+    s_ov_stats.hits++;
+    s_ov_stats.hit_ns += gc_host_ns() - t0;
+    OSNotifyLink();
+    return 1;
+}
+
+void port_OSOverlayGetStats(port_OSOverlayStats *out) {
+    if (out) *out = s_ov_stats;
+}
+
+void port_OSModuleInit(port_OSModuleState *st) {
+    st->head = 0;
+    st->tail = 0;
+    st->stringTable = 0;
+    while (s_linked_count) linked_set(s_linked[0].module, NULL);
+}
+
+int port_OSLinkRel(port_OSModuleState *st, uint32_t module, uint32_t bss) {
+    const uint32_t version = rel_ld32(module + PORT_REL_VERSION);
+    uint32_t si, n, i, m, bss_next = bss, image_size = 0;
+    uint64_t t0 = 0;
+    Plan *pl = NULL;
+
+    if (PORT_REL_VERSION_MAX < version) return 0;
+    if (2 <= version) {
+        const uint32_t align = rel_ld32(module + PORT_REL_ALIGN);
+        const uint32_t bss_align = rel_ld32(module + PORT_REL_BSS_ALIGN);
+        if ((align && module % align != 0) || (bss_align && bss % bss_align != 0)) return 0;
+    }
+
+    if (s_ov_budget) {
+        t0 = gc_host_ns();
+        image_size = rel_image_size(module);
+    }
+#ifndef GC_OSLINK_NO_PLAN
+    // Decoded (or found) before the offsets below become absolute.
+    pl = plan_get(module);
+#endif
+
+    // EnqueueTail(&__OSModuleList, module, link)
+    rel_st32(module + PORT_REL_NEXT, 0);
+    rel_st32(module + PORT_REL_PREV, st->tail);
+    if (st->tail) {
+        rel_st32(st->tail + PORT_REL_NEXT, module);
+    } else {
+        st->head = module;
+    }
+    st->tail = module;
+
+    rel_st32(module + PORT_REL_SECTION_INFO, rel_ld32(module + PORT_REL_SECTION_INFO) + module);
+    rel_st32(module + PORT_REL_REL_OFFSET, rel_ld32(module + PORT_REL_REL_OFFSET) + module);
+    rel_st32(module + PORT_REL_IMP_OFFSET, rel_ld32(module + PORT_REL_IMP_OFFSET) + module);
+    if (3 <= version) {
+        rel_st32(module + PORT_REL_FIX_SIZE, rel_ld32(module + PORT_REL_FIX_SIZE) + module);
+    }
+
+    si = rel_ld32(module + PORT_REL_SECTION_INFO);
+    n = rel_ld32(module + PORT_REL_NUM_SECTIONS);
+    for (i = 1; i < n; i++) {
+        const uint32_t e = si + i * PORT_REL_SECTION_SIZE;
+        const uint32_t off = rel_ld32(e);
+        const uint32_t size = rel_ld32(e + 4);
+        if (off != 0) {
+            rel_st32(e, off + module);
+        } else if (size != 0) {
+            rel_st32(e, bss_next);
+            bss_next += (size + 31u) & ~31u; // OSRoundUp32B
+        }
+    }
+
+    {
+        const uint32_t imp = rel_ld32(module + PORT_REL_IMP_OFFSET);
+        const uint32_t end = imp + rel_ld32(module + PORT_REL_IMP_SIZE);
+        uint32_t p;
+        for (p = imp; p < end; p += PORT_REL_IMP_ENTRY_SIZE) rel_st32(p + 4, rel_ld32(p + 4) + module);
+    }
+
+    {
+        static const uint32_t fields[3][2] = {
+            {PORT_REL_PROLOG_SECTION, PORT_REL_PROLOG},
+            {PORT_REL_EPILOG_SECTION, PORT_REL_EPILOG},
+            {PORT_REL_UNRES_SECTION, PORT_REL_UNRESOLVED},
+        };
+        for (i = 0; i < 3; i++) {
+            const uint32_t sec = rel_ld8(module + fields[i][0]);
+            if (sec != 0) {
+                rel_st32(module + fields[i][1],
+                         rel_ld32(module + fields[i][1]) + rel_section_base(module, sec));
+            }
+        }
+    }
+    if (st->stringTable) {
+        rel_st32(module + PORT_REL_NAME_OFFSET, rel_ld32(module + PORT_REL_NAME_OFFSET) + st->stringTable);
+    }
+
+    if (pl) linked_set(module, pl);
+    // With the cache on, record the unknown relocations of the module's own
+    // imports (the patches a cache hit skips).
+    s_ov_recording = s_ov_budget != 0;
+    s_ov_rec_count = 0;
+    s_ov_rec_from = 0;
+    rel_relocate(0, module, 0);
+    for (m = st->head; m; m = rel_ld32(m + PORT_REL_NEXT)) {
+        s_ov_rec_from = m == module ? m : OVERLAY_NOT_SELF;
+        rel_relocate(module, m, 0);
+        s_ov_rec_from = m;
+        if (m != module) rel_relocate(m, module, 0);
+    }
+    s_ov_recording = 0;
+
+    {
+        const uint32_t bss_size = rel_ld32(module + PORT_REL_BSS_SIZE);
+        uint8_t *p = bss_size ? gc_mem_ptr(bss, bss_size) : NULL;
+        if (p) memset(p, 0, bss_size);
+    }
+    s_link_stats.links++;
+    if (s_ov_budget) {
+        ov_capture(st, module, bss, image_size, pl);
+        s_ov_stats.link_ns += gc_host_ns() - t0;
+    }
+    OSNotifyLink();
+    return 1;
+}
+
+int port_OSUnlinkRel(port_OSModuleState *st, uint32_t module) {
+    const uint32_t prev = rel_ld32(module + PORT_REL_PREV);
+    const uint32_t next = rel_ld32(module + PORT_REL_NEXT);
+    uint32_t m;
+
+    // Like OSUnlink above: a module that is not on the list fails.
+    if (st->head != module && !prev && !next) return 0;
+
+    if (prev) {
+        rel_st32(prev + PORT_REL_NEXT, next);
+    } else {
+        st->head = next;
+    }
+    if (next) {
+        rel_st32(next + PORT_REL_PREV, prev);
+    } else {
+        st->tail = prev;
+    }
+    rel_st32(module + PORT_REL_PREV, 0);
+    rel_st32(module + PORT_REL_NEXT, 0);
+
+    for (m = st->head; m; m = rel_ld32(m + PORT_REL_NEXT)) rel_relocate(module, m, 1);
+    linked_set(module, NULL);
+    s_link_stats.unlinks++;
+    OSNotifyUnlink();
+    return 1;
+}
+
+void port_OSLinkGetStats(port_OSLinkStats *out) {
+    if (out) *out = s_link_stats;
+}
+
+void port_OSLinkFlushPlans(void) {
+    uint32_t i = 0;
+    while (i < s_plan_count) {
+        if (s_plans[i]->refs == 0) {
+            plan_free(s_plans[i]);
+            s_plans[i] = s_plans[--s_plan_count];
+        } else {
+            i++;
+        }
+    }
+}
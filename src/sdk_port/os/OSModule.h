@@ -0,0 +1,155 @@
+/*
+ * sdk_port/os/OSModule.h --- Host-side REL linker of the OSModule port.
+ *
+ * OSLink / OSUnlink (declared by the game headers) keep the host-struct
+ * module list. port_OSLinkRel / port_OSUnlinkRel link real REL images:
+ * the module, its section and import tables and its relocations live in
+ * gc_mem (big-endian), queue pointers are GC addresses (u32, 0 = NULL),
+ * and relocations are applied to RAM like the SDK's Relocate / Undo.
+ *
+ * Source of truth: external/mp4-decomp/src/dolphin/os/OSLink.c
+ */
+#pragma once
+
+#include <stdint.h>
+
+/* OSModuleHeader field offsets in gc_mem (decomp layout; v1 0x40, v2 0x48,
+ * v3 0x4C bytes) */
+#define PORT_REL_ID              0x00 /* u32 */
+#define PORT_REL_NEXT            0x04 /* u32: GC addr of next module */
+#define PORT_REL_PREV            0x08 /* u32: GC addr of prev module */
+#define PORT_REL_NUM_SECTIONS    0x0C /* u32 */
+#define PORT_REL_SECTION_INFO    0x10 /* u32: offset, absolute once linked */
+#define PORT_REL_NAME_OFFSET     0x14 /* u32 */
+#define PORT_REL_NAME_SIZE       0x18 /* u32 */
+#define PORT_REL_VERSION         0x1C /* u32 */
+#define PORT_REL_BSS_SIZE        0x20 /* u32 */
+#define PORT_REL_REL_OFFSET      0x24 /* u32: offset, absolute once linked */
+#define PORT_REL_IMP_OFFSET      0x28 /* u32: offset, absolute once linked */
+#define PORT_REL_IMP_SIZE        0x2C /* u32: bytes */
+#define PORT_REL_PROLOG_SECTION  0x30 /* u8 */
+#define PORT_REL_EPILOG_SECTION  0x31 /* u8 */
+#define PORT_REL_UNRES_SECTION   0x32 /* u8 */
+#define PORT_REL_BSS_SECTION     0x33 /* u8 */
+#define PORT_REL_PROLOG          0x34 /* u32: offset, absolute once linked */
+#define PORT_REL_EPILOG          0x38 /* u32 */
+#define PORT_REL_UNRESOLVED      0x3C /* u32 */
+#define PORT_REL_ALIGN           0x40 /* u32, version >= 2 */
+#define PORT_REL_BSS_ALIGN       0x44 /* u32, version >= 2 */
+#define PORT_REL_FIX_SIZE        0x48 /* u32, version >= 3 */
+
+#define PORT_REL_VERSION_MAX     3
+
+/* Section info: u32 offset (bit 0 = executable), u32 size. */
+#define PORT_REL_SECTION_SIZE    8
+#define PORT_REL_SECTION_EXEC    1u
+
+/* Import: u32 module id (0 = main program), u32 offset of its relocations. */
+#define PORT_REL_IMP_ENTRY_SIZE  8
+
+/* Relocation: u16 offset (from the previous one), u8 type, u8 section,
+ * u32 addend. */
+#define PORT_REL_RELOC_SIZE      8
+
+enum {
+    PORT_R_PPC_NONE = 0,
+    PORT_R_PPC_ADDR32 = 1,
+    PORT_R_PPC_ADDR24 = 2,
+    PORT_R_PPC_ADDR16 = 3,
+    PORT_R_PPC_ADDR16_LO = 4,
+    PORT_R_PPC_ADDR16_HI = 5,
+    PORT_R_PPC_ADDR16_HA = 6,
+    PORT_R_PPC_ADDR14 = 7,
+    PORT_R_PPC_ADDR14_BRTAKEN = 8,
+    PORT_R_PPC_ADDR14_BRNTAKEN = 9,
+    PORT_R_PPC_REL24 = 10,
+    PORT_R_PPC_REL14 = 11,
+    PORT_R_PPC_REL14_BRTAKEN = 12,
+    PORT_R_PPC_REL14_BRNTAKEN = 13,
+    PORT_R_DOLPHIN_NOP = 201,
+    PORT_R_DOLPHIN_SECTION = 202,
+    PORT_R_DOLPHIN_END = 203
+};
+
+/* Host-side module list (mirrors decomp's __OSModuleList). */
+typedef struct {
+    uint32_t head;        /* GC addr of first linked module (0 = NULL) */
+    uint32_t tail;
+    uint32_t stringTable; /* __OSStringTable (0 = none) */
+} port_OSModuleState;
+
+void port_OSModuleInit(port_OSModuleState *st);
+
+/* OSLink / OSUnlink on a RAM-resident REL. Link fixes up the header's
+ * offsets, places zero-offset sections at bss (32-byte steps), resolves the
+ * new module's imports and every linked module's imports of it, then clears
+ * bssSize bytes at bss. Unlink points the remaining modules' references back at nothing
+ * (branches go to their own `unresolved` stub). Return 1, or 0 like the SDK
+ * (bad version or alignment; unlink of a module that is not linked). */
+int port_OSLinkRel(port_OSModuleState *st, uint32_t module, uint32_t bss);
+int port_OSUnlinkRel(port_OSModuleState *st, uint32_t module);
+
+/* Fixup plans.
+ *
+ * The first link of a module decodes its relocation stream into a plan:
+ * per imported module, the patches as (section, offset, type, target
+ * section, addend), grouped into runs of one type that are applied in a
+ * loop each. Plans are kept by module id and a hash of the module's import
+ * and relocation bytes, so loading the same overlay again (at any address,
+ * with any bss) skips the decode. A module whose bytes changed hashes
+ * differently and gets a fresh plan. Build with GC_OSLINK_NO_PLAN to walk
+ * the stream on every link, as the SDK does. */
+#define PORT_OSLINK_PLANS 32
+
+typedef struct {
+    uint32_t links;      /* successful port_OSLinkRel calls */
+    uint32_t unlinks;
+    uint32_t plan_built; /* plans decoded */
+    uint32_t plan_hits;  /* links that reused a plan */
+    uint64_t relocs;     /* relocations applied or undone */
+    uint32_t unknown;    /* relocations of an unknown type (skipped) */
+} port_OSLinkStats;
+
+void port_OSLinkGetStats(port_OSLinkStats *out);
+/* Drop every cached plan (not those of linked modules). */
+void port_OSLinkFlushPlans(void);
+
+/* Overlay cache.
+ *
+ * Games swap overlays in and out of the same few load addresses: read the
+ * REL from disc, OSLink, run, OSUnlink, repeat. With the cache on, every
+ * port_OSLinkRel keeps a copy of the freshly linked image (before the game
+ * runs any of it), keyed by module id, load address and bss address. A
+ * loader that calls port_OSOverlayLink before reading the REL gets the
+ * image back relocated: a memcpy, the bss clear, the list splice, and the
+ * patches of linked modules that import it. It then skips the read and the
+ * relocation of the module's own imports.
+ *
+ * An entry is only used if every module it imports is linked at the same
+ * place as when it was captured (or still not linked); otherwise it is a
+ * miss. Overlays are assumed not to change on disc for a given id: drop the
+ * cache (port_OSOverlayCacheInit) when they do. Entries live in host memory
+ * under a byte budget and are evicted least recently used first. */
+#define PORT_OSOVERLAY_MAX 64
+
+/* Turn the cache on with a byte budget, dropping every entry; 0 turns it
+ * off. Off by default. */
+void port_OSOverlayCacheInit(uint32_t budget);
+/* Link the cached image of module `id` at `module` / `bss`. Returns 1 if it
+ * was linked from the cache, 0 on a miss (read the REL and call
+ * port_OSLinkRel, which captures it). */
+int port_OSOverlayLink(port_OSModuleState *st, uint32_t id, uint32_t module, uint32_t bss);
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;      /* port_OSOverlayLink calls that found nothing usable */
+    uint32_t stale;       /* of which: entry present but an import moved */
+    uint32_t captures;
+    uint32_t evictions;
+    uint32_t entries;
+    uint32_t bytes;       /* host bytes held */
+    uint64_t hit_ns;      /* host time in port_OSOverlayLink hits */
+    uint64_t link_ns;     /* host time in port_OSLinkRel while the cache is on */
+} port_OSOverlayStats;
+
+void port_OSOverlayGetStats(port_OSOverlayStats *out);
@@ -1,4 +1,11 @@
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "OSStopwatch.h"
+#include "../gc_clock.h"
+#include "../gc_host_clock.h"
 
 typedef uint32_t u32;
 typedef uint64_t u64;
@@ -19,13 +26,146 @@ typedef struct OSStopwatch {
 int OSReport(const char *msg, ...);
 
 // Deterministic OSGetTime() for host scenarios.
-// We intentionally do not model TB frequency here; this is sufficient for
-// MP4 perf bookkeeping and for bit-exact deterministic tests.
+// Without the virtual clock we do not model TB frequency: every read is one
+// tick later, which is sufficient for MP4 perf bookkeeping and for bit-exact
+// deterministic tests. With it (gc_clock.h), reads return the clock.
 static u64 gc_os_time_counter;
 static u64 OSGetTime(void) {
+    if (gc_clock_enabled()) return gc_clock_now();
     return ++gc_os_time_counter;
 }
 
+/* ── Stopwatch profiler (OSStopwatch.h) ──
+ *
+ * Entries live in registration order; a small open-addressed table maps a
+ * stopwatch address to its entry. */
+
+#define PROF_HASH_SIZE (PORT_OSSTOPWATCH_PROF_MAX * 2)
+
+typedef struct {
+    port_OSStopwatchProf pub;
+    uint64_t host_start;
+    int running;
+} ProfEntry;
+
+static ProfEntry s_prof[PORT_OSSTOPWATCH_PROF_MAX];
+static int s_prof_count;
+static int16_t s_prof_hash[PROF_HASH_SIZE]; /* entry + 1, 0 = empty */
+
+#ifdef GC_OSSTOPWATCH_PROFILE
+
+static uint32_t prof_slot(const void *sw) {
+    uintptr_t h = (uintptr_t)sw;
+    h ^= h >> 16;
+    h *= 0x45d9f3bu;
+    h ^= h >> 16;
+    return (uint32_t)h & (PROF_HASH_SIZE - 1u);
+}
+
+static void prof_set_name(ProfEntry *e, const char *name) {
+    if (!name) name = "(null)";
+    strncpy(e->pub.name, name, sizeof(e->pub.name) - 1u);
+    e->pub.name[sizeof(e->pub.name) - 1u] = 0;
+}
+
+/* Entry for sw, registering it if new (NULL once the registry is full). */
+static ProfEntry *prof_entry(const OSStopwatch *sw) {
+    uint32_t slot = prof_slot(sw);
+    ProfEntry *e;
+
+    for (; s_prof_hash[slot]; slot = (slot + 1u) & (PROF_HASH_SIZE - 1u)) {
+        e = &s_prof[s_prof_hash[slot] - 1];
+        if (e->pub.sw == sw) return e;
+    }
+    if (s_prof_count >= PORT_OSSTOPWATCH_PROF_MAX) return NULL;
+    e = &s_prof[s_prof_count++];
+    memset(e, 0, sizeof(*e));
+    e->pub.sw = sw;
+    e->pub.host_min_ns = UINT64_MAX;
+    prof_set_name(e, sw->name);
+    s_prof_hash[slot] = (int16_t)s_prof_count;
+    return e;
+}
+
+static void prof_init(const OSStopwatch *sw) {
+    ProfEntry *e = prof_entry(sw);
+    if (e) {
+        prof_set_name(e, sw->name);
+        e->running = 0;
+    }
+}
+
+static void prof_start(const OSStopwatch *sw) {
+    ProfEntry *e = prof_entry(sw);
+    if (e) {
+        e->running = 1;
+        e->host_start = gc_host_ns();
+    }
+}
+
+static void prof_stop(const OSStopwatch *sw, u64 ticks) {
+    const uint64_t now = gc_host_ns();
+    ProfEntry *e = prof_entry(sw);
+    uint64_t ns;
+
+    if (!e || !e->running) return;
+    ns = now - e->host_start;
+    e->running = 0;
+    e->pub.hits++;
+    e->pub.host_total_ns += ns;
+    if (ns < e->pub.host_min_ns) e->pub.host_min_ns = ns;
+    if (ns > e->pub.host_max_ns) e->pub.host_max_ns = ns;
+    e->pub.ticks += ticks;
+}
+
+#else
+
+#define prof_init(sw) ((void)0)
+#define prof_start(sw) ((void)0)
+#define prof_stop(sw, ticks) ((void)0)
+
+#endif
+
+int port_OSStopwatchProfCount(void) { return s_prof_count; }
+
+int port_OSStopwatchProfGet(int i, port_OSStopwatchProf *out) {
+    if (i < 0 || i >= s_prof_count || !out) return -1;
+    *out = s_prof[i].pub;
+    if (out->hits == 0) out->host_min_ns = 0;
+    return 0;
+}
+
+void port_OSStopwatchProfReset(void) {
+    s_prof_count = 0;
+    memset(s_prof_hash, 0, sizeof(s_prof_hash));
+}
+
+static int prof_by_host_total(const void *a, const void *b) {
+    const port_OSStopwatchProf *x = (const port_OSStopwatchProf *)a;
+    const port_OSStopwatchProf *y = (const port_OSStopwatchProf *)b;
+    if (x->host_total_ns != y->host_total_ns) return x->host_total_ns < y->host_total_ns ? 1 : -1;
+    return strcmp(x->name, y->name);
+}
+
+void port_OSStopwatchProfDump(FILE *out) {
+    port_OSStopwatchProf rows[PORT_OSSTOPWATCH_PROF_MAX];
+    int i;
+
+    for (i = 0; i < s_prof_count; i++) port_OSStopwatchProfGet(i, &rows[i]);
+    qsort(rows, (size_t)s_prof_count, sizeof(rows[0]), prof_by_host_total);
+
+    fprintf(out, "%-24s %8s %12s %10s %10s %10s %14s\n",
+            "stopwatch", "hits", "host ms", "min us", "mean us", "max us", "ticks");
+    for (i = 0; i < s_prof_count; i++) {
+        const port_OSStopwatchProf *r = &rows[i];
+        const uint64_t mean = r->hits ? r->host_total_ns / r->hits : 0;
+        fprintf(out, "%-24s %8u %12.3f %10.1f %10.1f %10.1f %14llu\n",
+                r->name, r->hits, (double)r->host_total_ns / 1e6,
+                (double)r->host_min_ns / 1e3, (double)mean / 1e3,
+                (double)r->host_max_ns / 1e3, (unsigned long long)r->ticks);
+    }
+}
+
 void OSInitStopwatch(OSStopwatch *sw, char *name) {
     sw->name = name;
     sw->total = 0;
@@ -34,11 +174,13 @@ void OSInitStopwatch(OSStopwatch *sw, char *name) {
     sw->max = 0;
     sw->running = 0;
     sw->last = 0;
+    prof_init(sw);
 }
 
 void OSStartStopwatch(OSStopwatch *sw) {
     sw->running = 1;
     sw->last = OSGetTime();
+    prof_start(sw);
 }
 
 void OSStopStopwatch(OSStopwatch *sw) {
@@ -54,6 +196,7 @@ void OSStopStopwatch(OSStopwatch *sw) {
         if ((u64)interval < sw->min) {
             sw->min = (u64)interval;
         }
+        prof_stop(sw, (u64)interval);
     }
 }
 
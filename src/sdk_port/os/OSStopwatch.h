@@ -0,0 +1,53 @@
+/*
+ * sdk_port/os/OSStopwatch.h --- Host-side extras of the OSStopwatch port.
+ *
+ * The SDK API itself (OSInitStopwatch, OSStartStopwatch, ...) is declared by
+ * the game headers. This header covers the stopwatch profiler.
+ *
+ * Source of truth: external/mp4-decomp/src/dolphin/os/OSStopwatch.c
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* ── Stopwatch profiler ──
+ *
+ * Built with GC_OSSTOPWATCH_PROFILE, every stopwatch the game initializes
+ * or starts is entered in a registry, and each start/stop pair also samples
+ * a monotonic host clock. The stopwatch itself is untouched: it still
+ * measures OSGetTime ticks, so scenario output does not change. The
+ * registry keeps counting across OSResetStopwatch, which games call every
+ * frame, so a run ends with per-phase totals from the game's own
+ * instrumentation.
+ *
+ * Entries are keyed by stopwatch address; the name is copied at
+ * OSInitStopwatch. The host runner writes the table to the path in
+ * GC_OS_STOPWATCH_PROFILE (see tools/run_host_scenario.sh).
+ *
+ * Without GC_OSSTOPWATCH_PROFILE the functions below exist but the registry
+ * stays empty.
+ */
+
+#define PORT_OSSTOPWATCH_PROF_MAX  256
+#define PORT_OSSTOPWATCH_PROF_NAME 32
+
+typedef struct {
+    const void *sw;                       /* the OSStopwatch */
+    char name[PORT_OSSTOPWATCH_PROF_NAME];
+    uint32_t hits;                        /* completed start/stop pairs */
+    uint64_t host_total_ns;
+    uint64_t host_min_ns;
+    uint64_t host_max_ns;
+    uint64_t ticks;                       /* OSGetTime ticks over the same pairs */
+} port_OSStopwatchProf;
+
+/* Stopwatches registered so far (at most PORT_OSSTOPWATCH_PROF_MAX; the
+ * rest are not profiled). */
+int port_OSStopwatchProfCount(void);
+/* Copy entry i (registration order). Returns 0, or -1 if out of range. */
+int port_OSStopwatchProfGet(int i, port_OSStopwatchProf *out);
+/* Forget every entry. */
+void port_OSStopwatchProfReset(void);
+/* Write the registry as a table, most host time first. */
+void port_OSStopwatchProfDump(FILE *out);
@@ -6,12 +6,24 @@
  *
  * Same logic as decomp, but thread/mutex structs and queues live in gc_mem
  * (big-endian).  Queue pointers are GC addresses (u32, 0 = NULL).
+ * Threads with a body run on host fibers (see osthread.h).
  */
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "osthread.h"
+#include "../gc_host_clock.h"
 #include "../gc_mem.h"
 
+#if defined(_WIN32)
+#define PORT_FIBER_NONE 1
+#elif (defined(__x86_64__) || defined(__aarch64__)) && !defined(PORT_FIBER_UCONTEXT)
+#define PORT_FIBER_ASM 1
+#else
+#include <ucontext.h>
+#endif
+
 /* ── Big-endian helpers ── */
 
 static inline uint16_t load_u16be(uint32_t addr)
@@ -246,6 +258,196 @@ static int32_t port_OSGetEffectivePriority(uint32_t thread)
     return priority;
 }
 
+/* ────────────────────────────────────────────────────────────────────
+ * Scheduler tracing
+ *
+ * The hooks sit at the thread state transitions and return at once unless
+ * a trace is recording. A slot's open spans (ready, running, blocked) are
+ * host-side flags with their start times; the transition that ends a span
+ * writes it to the slot's ring.
+ * ──────────────────────────────────────────────────────────────────── */
+
+typedef struct {
+    port_OSTraceEvent ring[PORT_TRACE_RING];
+    uint32_t count;                   /* events recorded */
+    uint64_t ready_since, run_since, wait_since;
+    uint32_t wait_queue;
+    uint8_t ready, running, waiting;
+} port_OSTraceSlot;
+
+struct port_OSTrace {
+    int on;
+    port_OSTraceClock clock;
+    void *ctx;
+    uint64_t t0;
+    int hold;                         /* > 0: hooks share one clock read */
+    int held_valid;
+    uint64_t held;
+    port_OSTraceSlot slot[PORT_MAX_THREADS];
+};
+
+static uint64_t port_TraceHostClock(void *ctx)
+{
+    (void)ctx;
+    return gc_host_ns();
+}
+
+static inline int port_Tracing(const port_OSThreadState *st)
+{
+    return st->trace && st->trace->on;
+}
+
+static uint64_t port_TraceNow(port_OSThreadState *st)
+{
+    struct port_OSTrace *tr = st->trace;
+    if (!tr->hold) return tr->clock(tr->ctx) - tr->t0;
+    if (!tr->held_valid) {
+        tr->held = tr->clock(tr->ctx) - tr->t0;
+        tr->held_valid = 1;
+    }
+    return tr->held;
+}
+
+/* At most one clock read for the hooks of one transition. Never held
+ * across a fiber switch: the other fiber would release this hold. */
+static void port_TraceHold(port_OSThreadState *st)
+{
+    if (!port_Tracing(st)) return;
+    if (st->trace->hold++ == 0) st->trace->held_valid = 0;
+}
+
+static void port_TraceRelease(port_OSThreadState *st)
+{
+    if (st->trace && st->trace->hold) st->trace->hold--;
+}
+
+static port_OSTraceSlot *port_TraceSlot(port_OSThreadState *st, uint32_t thread)
+{
+    return &st->trace->slot[thr_get32(thread, PORT_THREAD_ID) % PORT_MAX_THREADS];
+}
+
+static void port_TraceEmit(port_OSTraceSlot *s, uint32_t kind,
+                           uint64_t ts, uint64_t end, uint32_t arg)
+{
+    port_OSTraceEvent *e = &s->ring[s->count++ % PORT_TRACE_RING];
+    e->ts = ts;
+    e->dur = end - ts;
+    e->kind = kind;
+    e->arg = arg;
+}
+
+/* What a blocked thread waits for, from where its queue lives in the block. */
+static uint32_t port_TraceWaitKind(const port_OSThreadState *st,
+                                   uint32_t queue, uint32_t *obj)
+{
+    uint32_t off = queue - st->gc_base;
+
+    *obj = queue;
+    if (off >= PORT_MSGQ_OFFSET && off < PORT_TOTAL_SIZE) {
+        uint32_t field = (off - PORT_MSGQ_OFFSET) % PORT_MSGQ_SIZE;
+        *obj = queue - field;
+        return field == PORT_MSGQ_SEND_HEAD ? PORT_TRACE_MSG_SEND : PORT_TRACE_MSG_RECV;
+    }
+    if (off >= PORT_CONDQ_OFFSET && off < PORT_MSGQ_OFFSET) return PORT_TRACE_COND;
+    if (off >= PORT_MUTEXQ_OFFSET && off < PORT_CONDQ_OFFSET) return PORT_TRACE_MUTEX;
+    if (off >= PORT_THREADS_OFFSET && off < PORT_WAITQ_OFFSET) {
+        *obj = queue - PORT_THREAD_JOIN_HEAD;
+        return PORT_TRACE_JOIN;
+    }
+    return PORT_TRACE_WAIT;
+}
+
+static void port_TraceCloseWait(port_OSThreadState *st, port_OSTraceSlot *s, uint64_t now)
+{
+    uint32_t obj;
+    uint32_t kind = port_TraceWaitKind(st, s->wait_queue, &obj);
+    port_TraceEmit(s, kind, s->wait_since, now, obj);
+    s->waiting = 0;
+}
+
+/* Put on a run queue (a no-op while it stays there). */
+static void port_TraceReady(port_OSThreadState *st, uint32_t thread)
+{
+    port_OSTraceSlot *s;
+    if (!port_Tracing(st)) return;
+    s = port_TraceSlot(st, thread);
+    if (s->ready) return;
+    s->ready = 1;
+    s->ready_since = port_TraceNow(st);
+}
+
+/* Off the run queue without running (suspended, cancelled). */
+static void port_TraceUnready(port_OSThreadState *st, uint32_t thread)
+{
+    port_OSTraceSlot *s;
+    if (!port_Tracing(st)) return;
+    s = port_TraceSlot(st, thread);
+    if (!s->ready) return;
+    port_TraceEmit(s, PORT_TRACE_READY, s->ready_since, port_TraceNow(st),
+                   (uint32_t)thr_gets32(thread, PORT_THREAD_PRIORITY));
+    s->ready = 0;
+}
+
+static void port_TraceSleep(port_OSThreadState *st, uint32_t thread, uint32_t queue)
+{
+    port_OSTraceSlot *s;
+    if (!port_Tracing(st)) return;
+    s = port_TraceSlot(st, thread);
+    s->waiting = 1;
+    s->wait_since = port_TraceNow(st);
+    s->wait_queue = queue;
+}
+
+/* Taken off its wait queue (woken or cancelled). */
+static void port_TraceWake(port_OSThreadState *st, uint32_t thread)
+{
+    port_OSTraceSlot *s;
+    if (!port_Tracing(st)) return;
+    s = port_TraceSlot(st, thread);
+    if (s->waiting) port_TraceCloseWait(st, s, port_TraceNow(st));
+}
+
+/* Selected: the ready span closes as the dispatch latency. */
+static void port_TraceRun(port_OSThreadState *st, uint32_t thread)
+{
+    port_OSTraceSlot *s;
+    uint64_t now;
+    if (!port_Tracing(st)) return;
+    s = port_TraceSlot(st, thread);
+    now = port_TraceNow(st);
+    if (s->ready) {
+        port_TraceEmit(s, PORT_TRACE_READY, s->ready_since, now,
+                       (uint32_t)thr_gets32(thread, PORT_THREAD_PRIORITY));
+        s->ready = 0;
+    }
+    s->running = 1;
+    s->run_since = now;
+}
+
+/* No longer the current thread. */
+static void port_TraceLeave(port_OSThreadState *st, uint32_t thread)
+{
+    port_OSTraceSlot *s;
+    if (!port_Tracing(st)) return;
+    s = port_TraceSlot(st, thread);
+    if (!s->running) return;
+    port_TraceEmit(s, PORT_TRACE_RUN, s->run_since, port_TraceNow(st),
+                   (uint32_t)thr_gets32(thread, PORT_THREAD_PRIORITY));
+    s->running = 0;
+}
+
+static void port_TracePriority(port_OSThreadState *st, uint32_t thread, int32_t priority)
+{
+    int32_t from;
+    uint64_t now;
+    if (!port_Tracing(st)) return;
+    from = thr_gets32(thread, PORT_THREAD_PRIORITY);
+    if (priority >= from) return;
+    now = port_TraceNow(st);
+    port_TraceEmit(port_TraceSlot(st, thread), PORT_TRACE_INVERSION, now, now,
+                   (uint32_t)from << 8 | (uint32_t)priority);
+}
+
 /* ────────────────────────────────────────────────────────────────────
  * SetRun / UnsetRun
  * ──────────────────────────────────────────────────────────────────── */
@@ -258,6 +460,7 @@ static void port_SetRun(port_OSThreadState *st, uint32_t thread)
     port_AddTail(rq, thread, LINK_NEXT, LINK_PREV);
     st->runQueueBits |= 1u << (PORT_OS_PRIORITY_MAX - prio);
     st->runQueueHint = 1;
+    port_TraceReady(st, thread);
 }
 
 static void port_UnsetRun(port_OSThreadState *st, uint32_t thread)
@@ -278,6 +481,7 @@ static uint32_t port_SetEffectivePriority(port_OSThreadState *st,
                                           uint32_t thread, int32_t priority)
 {
     uint16_t state = thr_get16(thread, PORT_THREAD_STATE);
+    port_TracePriority(st, thread, priority);
     switch (state) {
         case PORT_OS_THREAD_STATE_READY:
             port_UnsetRun(st, thread);
@@ -338,7 +542,169 @@ static void port_OSPromoteThread(port_OSThreadState *st,
 }
 
 /* ────────────────────────────────────────────────────────────────────
- * SelectThread (simplified: no context save/load)
+ * Host fibers
+ *
+ * Slot i's stack is bytes [i * PORT_FIBER_STACK_SIZE, +PORT_FIBER_STACK_SIZE)
+ * of one arena. With PORT_FIBER_ASM a context is a saved stack pointer:
+ * port_FiberSwap pushes the callee-saved registers onto the old stack,
+ * stores its stack pointer, loads the new one and pops. A new fiber's
+ * stack is seeded so that the first swap "returns" into port_FiberEntry.
+ * ──────────────────────────────────────────────────────────────────── */
+
+#define PORT_FIBER_CANARY 0x4F535448u   /* "OSTH", at the bottom of each stack */
+
+typedef struct {
+    port_OSThreadFunc func;   /* NULL: no fiber, the host code runs this thread */
+    void *arg;
+#if defined(PORT_FIBER_ASM)
+    void *sp;
+#elif !defined(PORT_FIBER_NONE)
+    ucontext_t uc;
+#endif
+} port_OSFiber;
+
+struct port_OSFibers {
+    port_OSFiber host;
+    port_OSFiber fiber[PORT_MAX_THREADS];
+    uint8_t *arena;
+};
+
+#if defined(PORT_FIBER_ASM)
+/* void port_FiberSwap(void **save_sp, void *load_sp) */
+void port_FiberSwap(void **save_sp, void *load_sp);
+
+#if defined(__APPLE__)
+#define PORT_FIBER_SWAP_SYM "_port_FiberSwap"
+#else
+#define PORT_FIBER_SWAP_SYM "port_FiberSwap"
+#endif
+
+#if defined(__x86_64__)
+/* rbp, rbx, r12-r15, then MXCSR and the x87 control word in one slot. */
+__asm__(
+    ".text\n"
+    ".globl " PORT_FIBER_SWAP_SYM "\n"
+    PORT_FIBER_SWAP_SYM ":\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $8, %rsp\n"
+    "    stmxcsr (%rsp)\n"
+    "    fnstcw 4(%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    ldmxcsr (%rsp)\n"
+    "    fldcw 4(%rsp)\n"
+    "    addq $8, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n");
+#define PORT_FIBER_FRAME 64u
+#else
+/* x19-x30 and d8-d15; x18 (platform register) is left alone. */
+__asm__(
+    ".text\n"
+    ".globl " PORT_FIBER_SWAP_SYM "\n"
+    ".p2align 2\n"
+    PORT_FIBER_SWAP_SYM ":\n"
+    "    sub sp, sp, #160\n"
+    "    stp x19, x20, [sp, #0]\n"
+    "    stp x21, x22, [sp, #16]\n"
+    "    stp x23, x24, [sp, #32]\n"
+    "    stp x25, x26, [sp, #48]\n"
+    "    stp x27, x28, [sp, #64]\n"
+    "    stp x29, x30, [sp, #80]\n"
+    "    stp d8, d9, [sp, #96]\n"
+    "    stp d10, d11, [sp, #112]\n"
+    "    stp d12, d13, [sp, #128]\n"
+    "    stp d14, d15, [sp, #144]\n"
+    "    mov x9, sp\n"
+    "    str x9, [x0]\n"
+    "    mov sp, x1\n"
+    "    ldp x19, x20, [sp, #0]\n"
+    "    ldp x21, x22, [sp, #16]\n"
+    "    ldp x23, x24, [sp, #32]\n"
+    "    ldp x25, x26, [sp, #48]\n"
+    "    ldp x27, x28, [sp, #64]\n"
+    "    ldp x29, x30, [sp, #80]\n"
+    "    ldp d8, d9, [sp, #96]\n"
+    "    ldp d10, d11, [sp, #112]\n"
+    "    ldp d12, d13, [sp, #128]\n"
+    "    ldp d14, d15, [sp, #144]\n"
+    "    add sp, sp, #160\n"
+    "    ret\n");
+#define PORT_FIBER_FRAME 160u
+#endif
+#endif /* PORT_FIBER_ASM */
+
+#if !defined(PORT_FIBER_NONE)
+/* State of the switch in progress, read by a fiber's first instruction. */
+static port_OSThreadState *s_port_fiber_st;
+
+static void port_FiberSwitchTo(port_OSThreadState *st, int32_t to)
+{
+    struct port_OSFibers *fs = st->fibers;
+    const int32_t from = st->running;
+    port_OSFiber *a, *b;
+
+    if (to == from) return;
+    if (from != PORT_FIBER_HOST &&
+        *(uint32_t *)(fs->arena + (uint32_t)from * PORT_FIBER_STACK_SIZE) != PORT_FIBER_CANARY) {
+        fprintf(stderr, "fatal: OSThread fiber %d overflowed its stack\n", (int)from);
+        abort();
+    }
+    a = from == PORT_FIBER_HOST ? &fs->host : &fs->fiber[from];
+    b = to == PORT_FIBER_HOST ? &fs->host : &fs->fiber[to];
+    st->running = to;
+    st->switches++;
+    s_port_fiber_st = st;
+#if defined(PORT_FIBER_ASM)
+    port_FiberSwap(&a->sp, b->sp);
+#else
+    swapcontext(&a->uc, &b->uc);
+#endif
+}
+
+static void port_FiberEntry(void)
+{
+    port_OSThreadState *st = s_port_fiber_st;
+    port_OSFiber *f = &st->fibers->fiber[st->running];
+    void *ret = f->func(f->arg);
+
+    port_OSExitThread(st, (uint32_t)(uintptr_t)ret);
+    /* Still here only with the scheduler disabled: hand over to the host. */
+    port_FiberSwitchTo(st, PORT_FIBER_HOST);
+    abort();
+}
+#endif
+
+/* Continue on the fiber of the thread just selected (0 = none: idle). */
+static void port_FiberSelect(port_OSThreadState *st, uint32_t thread)
+{
+#if defined(PORT_FIBER_NONE)
+    (void)st;
+    (void)thread;
+#else
+    int32_t to = PORT_FIBER_HOST;
+
+    if (!st->fibers) return;
+    if (thread) {
+        uint32_t slot = thr_get32(thread, PORT_THREAD_ID);
+        if (st->fibers->fiber[slot].func) to = (int32_t)slot;
+    }
+    port_FiberSwitchTo(st, to);
+#endif
+}
+
+/* ────────────────────────────────────────────────────────────────────
+ * SelectThread (context switch through the host fibers)
  * ──────────────────────────────────────────────────────────────────── */
 
 static uint32_t port_SelectThread(port_OSThreadState *st, int yield)
@@ -353,6 +719,7 @@ static uint32_t port_SelectThread(port_OSThreadState *st, int yield)
     }
 
     currentThread = st->currentThread;
+    port_TraceHold(st);
 
     if (currentThread) {
         uint16_t state = thr_get16(currentThread, PORT_THREAD_STATE);
@@ -360,18 +727,24 @@ static uint32_t port_SelectThread(port_OSThreadState *st, int yield)
             if (!yield) {
                 priority = (int32_t)port_cntlzw(st->runQueueBits);
                 if (thr_gets32(currentThread, PORT_THREAD_PRIORITY) <= priority) {
+                    port_TraceRelease(st);
                     return 0;
                 }
             }
+            port_TraceLeave(st, currentThread);
             thr_set16(currentThread, PORT_THREAD_STATE,
                       PORT_OS_THREAD_STATE_READY);
             port_SetRun(st, currentThread);
+        } else {
+            port_TraceLeave(st, currentThread);
         }
     }
 
     st->currentThread = 0;
 
     if (st->runQueueBits == 0) {
+        port_TraceRelease(st);
+        port_FiberSelect(st, 0);
         return 0;
     }
 
@@ -386,6 +759,9 @@ static uint32_t port_SelectThread(port_OSThreadState *st, int yield)
     thr_set32(nextThread, PORT_THREAD_QUEUE, 0);
     thr_set16(nextThread, PORT_THREAD_STATE, PORT_OS_THREAD_STATE_RUNNING);
     st->currentThread = nextThread;
+    port_TraceRun(st, nextThread);
+    port_TraceRelease(st);
+    port_FiberSelect(st, nextThread);
     return nextThread;
 }
 
@@ -428,6 +804,10 @@ void port_OSThreadInit(port_OSThreadState *st, uint32_t gc_base)
     st->runQueueBits = 0;
     st->runQueueHint = 0;
     st->reschedule = 0;
+    st->fibers = NULL;
+    st->running = PORT_FIBER_HOST;
+    st->switches = 0;
+    st->trace = NULL;
 
     /* Zero all gc_mem for our region */
     memset(gc_mem_ptr(gc_base, PORT_TOTAL_SIZE), 0, PORT_TOTAL_SIZE);
@@ -490,9 +870,79 @@ int port_OSCreateThread(port_OSThreadState *st, int slot,
 
     /* Add to active queue */
     port_AddTail(PORT_ACTIVEQ_ADDR(st), t, ACT_NEXT, ACT_PREV);
+    if (st->fibers) st->fibers->fiber[slot].func = NULL;
     return 1;
 }
 
+/* ── OSCreateThread with a host fiber ── */
+int port_OSCreateThreadFiber(port_OSThreadState *st, int slot,
+                             port_OSThreadFunc func, void *arg,
+                             int32_t priority, uint16_t attr)
+{
+#if defined(PORT_FIBER_NONE)
+    (void)st; (void)slot; (void)func; (void)arg; (void)priority; (void)attr;
+    return 0;
+#else
+    port_OSFiber *f;
+    uint8_t *stack;
+
+    if (slot <= 0 || slot >= PORT_MAX_THREADS || !func || slot == st->running) return 0;
+    if (!st->fibers) {
+        st->fibers = (struct port_OSFibers *)calloc(1, sizeof(*st->fibers));
+        if (!st->fibers) return 0;
+        st->fibers->arena = (uint8_t *)malloc((size_t)PORT_MAX_THREADS * PORT_FIBER_STACK_SIZE);
+        if (!st->fibers->arena) {
+            free(st->fibers);
+            st->fibers = NULL;
+            return 0;
+        }
+    }
+    if (!port_OSCreateThread(st, slot, priority, attr)) return 0;
+
+    f = &st->fibers->fiber[slot];
+    f->func = func;
+    f->arg = arg;
+    stack = st->fibers->arena + (uint32_t)slot * PORT_FIBER_STACK_SIZE;
+    *(uint32_t *)stack = PORT_FIBER_CANARY;
+#if defined(PORT_FIBER_ASM)
+    {
+        /* Zeroed callee-saved registers with the entry as return address;
+         * the top 16 bytes stand for the entry's own caller frame. */
+        uint8_t *sp = stack + PORT_FIBER_STACK_SIZE - 16u - PORT_FIBER_FRAME;
+        memset(sp, 0, PORT_FIBER_FRAME + 16u);
+#if defined(__x86_64__)
+        sp += 8;   /* enter with rsp + 8 16-byte aligned, as after a call */
+        *(uint32_t *)sp = 0x1F80u;        /* MXCSR default */
+        *(uint16_t *)(sp + 4) = 0x037Fu;  /* x87 control word default */
+        *(void **)(sp + 56) = (void *)port_FiberEntry;
+#else
+        *(void **)(sp + 88) = (void *)port_FiberEntry;   /* x30 */
+#endif
+        f->sp = sp;
+    }
+#else
+    getcontext(&f->uc);
+    f->uc.uc_stack.ss_sp = stack;
+    f->uc.uc_stack.ss_size = PORT_FIBER_STACK_SIZE;
+    f->uc.uc_link = NULL;
+    makecontext(&f->uc, port_FiberEntry, 0);
+#endif
+    return 1;
+#endif
+}
+
+/* ── Fiber arena teardown ── */
+void port_OSThreadShutdown(port_OSThreadState *st)
+{
+    free(st->trace);
+    st->trace = NULL;
+    if (!st->fibers) return;
+    free(st->fibers->arena);
+    free(st->fibers);
+    st->fibers = NULL;
+    st->running = PORT_FIBER_HOST;
+}
+
 /* ── OSResumeThread ── */
 int32_t port_OSResumeThread(port_OSThreadState *st, uint32_t thread)
 {
@@ -552,6 +1002,7 @@ int32_t port_OSSuspendThread(port_OSThreadState *st, uint32_t thread)
                 break;
             case PORT_OS_THREAD_STATE_READY:
                 port_UnsetRun(st, thread);
+                port_TraceUnready(st, thread);
                 break;
             case PORT_OS_THREAD_STATE_WAITING: {
                 uint32_t q = thr_get32(thread, PORT_THREAD_QUEUE);
@@ -580,6 +1031,7 @@ void port_OSSleepThread(port_OSThreadState *st, uint32_t queue_addr)
     thr_set16(ct, PORT_THREAD_STATE, PORT_OS_THREAD_STATE_WAITING);
     thr_set32(ct, PORT_THREAD_QUEUE, queue_addr);
     port_AddPrio(queue_addr, ct, LINK_NEXT, LINK_PREV);
+    port_TraceSleep(st, ct, queue_addr);
     st->runQueueHint = 1;
     port_OSReschedule(st);
 }
@@ -591,10 +1043,13 @@ void port_OSWakeupThread(port_OSThreadState *st, uint32_t queue_addr)
 
     while (q_head(queue_addr)) {
         thread = port_RemoveHead(queue_addr, LINK_NEXT, LINK_PREV);
+        port_TraceHold(st);
+        port_TraceWake(st, thread);
         thr_set16(thread, PORT_THREAD_STATE, PORT_OS_THREAD_STATE_READY);
         if (!(0 < thr_gets32(thread, PORT_THREAD_SUSPEND))) {
             port_SetRun(st, thread);
         }
+        port_TraceRelease(st);
     }
     port_OSReschedule(st);
 }
@@ -615,6 +1070,7 @@ void port_OSCancelThread(port_OSThreadState *st, uint32_t thread)
         case PORT_OS_THREAD_STATE_READY:
             if (!(0 < thr_gets32(thread, PORT_THREAD_SUSPEND))) {
                 port_UnsetRun(st, thread);
+                port_TraceUnready(st, thread);
             }
             break;
         case PORT_OS_THREAD_STATE_RUNNING:
@@ -623,6 +1079,7 @@ void port_OSCancelThread(port_OSThreadState *st, uint32_t thread)
         case PORT_OS_THREAD_STATE_WAITING: {
             uint32_t q = thr_get32(thread, PORT_THREAD_QUEUE);
             port_RemoveItem(q, thread, LINK_NEXT, LINK_PREV);
+            port_TraceWake(st, thread);
             thr_set32(thread, PORT_THREAD_QUEUE, 0);
             if (!(0 < thr_gets32(thread, PORT_THREAD_SUSPEND))) {
                 uint32_t m = thr_get32(thread, PORT_THREAD_MUTEX);
@@ -977,3 +1434,125 @@ void port_ProcessPendingLocks(port_OSThreadState *st)
         }
     }
 }
+
+/* ════════════════════════════════════════════════════════════════════
+ *  Scheduler tracing API
+ * ════════════════════════════════════════════════════════════════════ */
+
+/* ── Start ── */
+int port_OSTraceStart(port_OSThreadState *st, port_OSTraceClock clock, void *ctx)
+{
+    struct port_OSTrace *tr = st->trace;
+    int i;
+
+    if (!tr) {
+        tr = (struct port_OSTrace *)malloc(sizeof(*tr));
+        if (!tr) return 0;
+        st->trace = tr;
+    }
+    memset(tr, 0, sizeof(*tr));
+    tr->clock = clock ? clock : port_TraceHostClock;
+    tr->ctx = ctx;
+    tr->t0 = tr->clock(ctx);
+    tr->on = 1;
+
+    for (i = 0; i < PORT_MAX_THREADS; i++) {
+        uint32_t t = PORT_THREAD_ADDR(st, i);
+        port_OSTraceSlot *s = &tr->slot[i];
+        switch (thr_get16(t, PORT_THREAD_STATE)) {
+            case PORT_OS_THREAD_STATE_RUNNING:
+                s->running = t == st->currentThread;
+                break;
+            case PORT_OS_THREAD_STATE_READY:
+                s->ready = thr_get32(t, PORT_THREAD_QUEUE) != 0;
+                break;
+            case PORT_OS_THREAD_STATE_WAITING:
+                s->waiting = 1;
+                s->wait_queue = thr_get32(t, PORT_THREAD_QUEUE);
+                break;
+        }
+    }
+    return 1;
+}
+
+/* ── Stop ── */
+void port_OSTraceStop(port_OSThreadState *st)
+{
+    struct port_OSTrace *tr = st->trace;
+    uint64_t now;
+    int i;
+
+    if (!port_Tracing(st)) return;
+    now = port_TraceNow(st);
+    for (i = 0; i < PORT_MAX_THREADS; i++) {
+        port_OSTraceSlot *s = &tr->slot[i];
+        int32_t prio = thr_gets32(PORT_THREAD_ADDR(st, i), PORT_THREAD_PRIORITY);
+        if (s->running) port_TraceEmit(s, PORT_TRACE_RUN, s->run_since, now, (uint32_t)prio);
+        if (s->ready) port_TraceEmit(s, PORT_TRACE_READY, s->ready_since, now, (uint32_t)prio);
+        if (s->waiting) port_TraceCloseWait(st, s, now);
+        s->running = s->ready = 0;
+    }
+    tr->on = 0;
+}
+
+/* ── Read one slot's ring ── */
+uint32_t port_OSTraceRead(const port_OSThreadState *st, int slot,
+                          port_OSTraceEvent *out, uint32_t max, uint32_t *dropped)
+{
+    const port_OSTraceSlot *s;
+    uint32_t n, first, i;
+
+    if (dropped) *dropped = 0;
+    if (!st->trace || slot < 0 || slot >= PORT_MAX_THREADS) return 0;
+    s = &st->trace->slot[slot];
+    n = s->count < PORT_TRACE_RING ? s->count : PORT_TRACE_RING;
+    first = s->count - n;
+    if (dropped) *dropped = first;
+    if (n > max) n = max;
+    for (i = 0; i < n; i++) out[i] = s->ring[(first + i) % PORT_TRACE_RING];
+    return n;
+}
+
+/* ── Chrome trace-event JSON ── */
+static const char *const port_trace_names[] = {
+    "", "running", "ready", "wait", "join", "mutex", "cond",
+    "msg send", "msg receive", "inversion"
+};
+
+int port_OSTraceWriteJSON(const port_OSThreadState *st, FILE *f)
+{
+    const char *sep = "";
+    int i;
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", f);
+    for (i = 0; st->trace && i < PORT_MAX_THREADS; i++) {
+        const port_OSTraceSlot *s = &st->trace->slot[i];
+        uint32_t n = s->count < PORT_TRACE_RING ? s->count : PORT_TRACE_RING;
+        uint32_t k;
+
+        if (!n) continue;
+        fprintf(f, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                   "\"args\":{\"name\":\"OSThread %d\"}}", sep, i, i);
+        sep = ",";
+        for (k = s->count - n; k != s->count; k++) {
+            const port_OSTraceEvent *e = &s->ring[k % PORT_TRACE_RING];
+            const char *name = port_trace_names[e->kind];
+
+            if (e->kind == PORT_TRACE_INVERSION) {
+                fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"priority\",\"ph\":\"i\",\"s\":\"t\","
+                           "\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{\"from\":%u,\"to\":%u}}",
+                        name, i, (double)e->ts / 1000.0, e->arg >> 8, e->arg & 0xFFu);
+            } else if (e->kind <= PORT_TRACE_READY) {
+                fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"sched\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                           "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"priority\":%u}}",
+                        name, i, (double)e->ts / 1000.0, (double)e->dur / 1000.0, e->arg);
+            } else {
+                fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"block\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                           "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"object\":\"0x%08X\"}}",
+                        name, i, (double)e->ts / 1000.0, (double)e->dur / 1000.0, e->arg);
+            }
+        }
+    }
+    fputs("\n]}\n", f);
+    return !ferror(f);
+}
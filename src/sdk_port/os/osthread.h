@@ -3,11 +3,30 @@
  *
  * Thread/mutex structs and queues live in gc_mem (big-endian).
  * Queue pointers are GC addresses (u32, 0 = NULL).
- * Context save/load and interrupts are stripped/stubbed.
+ * Interrupts are stripped/stubbed.
+ *
+ * Context switches: threads created with port_OSCreateThreadFiber run host
+ * code on a fiber with its own stack (PORT_FIBER_STACK_SIZE, carved from one
+ * arena allocated by the first such thread). Whenever the scheduler selects
+ * a fiber thread, execution continues on that fiber. Selecting any other
+ * thread (the default thread, or a thread from port_OSCreateThread), or no
+ * thread at all (the SDK's idle loop), continues the host code that first
+ * switched to a fiber. Without fiber threads nothing switches, and the port
+ * is pure scheduler bookkeeping driven by the caller.
+ *
+ * The switch saves only the callee-saved registers (x86-64 SysV, AArch64);
+ * other hosts use ucontext. Fibers are not supported on Windows.
+ *
+ * Tracing: between port_OSTraceStart and port_OSTraceStop each thread slot
+ * records its scheduling spans (running, ready until selected, blocked on
+ * a wait queue / mutex / cond / message queue / join) and the priority
+ * raises of priority inheritance into a ring of its own, for
+ * port_OSTraceWriteJSON to export as Chrome trace events.
  */
 #pragma once
 
 #include <stdint.h>
+#include <stdio.h>
 
 /* ── Constants ── */
 #define PORT_OS_THREAD_STATE_READY    1
@@ -105,6 +124,43 @@
 #define PORT_MSGQ_OFFSET        (PORT_CONDQ_OFFSET + PORT_MAX_CONDS * PORT_COND_SIZE)
 #define PORT_TOTAL_SIZE         (PORT_MSGQ_OFFSET + PORT_MAX_MSGQUEUES * PORT_MSGQ_SIZE)
 
+/* ── Host fibers ── */
+#define PORT_FIBER_STACK_SIZE  0x20000u   /* per thread slot */
+#define PORT_FIBER_HOST        (-1)       /* port_OSThreadState.running: the host code */
+
+/* Thread entry, as OSCreateThread's; the result goes to OSExitThread. */
+typedef void *(*port_OSThreadFunc)(void *arg);
+
+struct port_OSFibers;
+
+/* ── Scheduler tracing ── */
+#define PORT_TRACE_RING  1024u    /* events per thread slot; older ones are overwritten */
+
+enum {
+    PORT_TRACE_RUN = 1,           /* RUNNING; arg = priority */
+    PORT_TRACE_READY,             /* on a run queue until selected; arg = priority */
+    PORT_TRACE_WAIT,              /* OSSleepThread on a wait queue; arg = queue */
+    PORT_TRACE_JOIN,              /* blocked in OSJoinThread; arg = joined thread */
+    PORT_TRACE_MUTEX,             /* blocked on PORT_MUTEX_QUEUE; arg = mutex */
+    PORT_TRACE_COND,              /* OSWaitCond; arg = cond */
+    PORT_TRACE_MSG_SEND,          /* message queue full; arg = message queue */
+    PORT_TRACE_MSG_RECV,          /* message queue empty; arg = message queue */
+    PORT_TRACE_INVERSION          /* instant: priority raised for a waiter; arg = from << 8 | to */
+};
+
+/* A span, recorded when it ends. Times are clock units (ns for the host
+ * clock) since port_OSTraceStart. */
+typedef struct {
+    uint64_t ts;
+    uint64_t dur;
+    uint32_t kind;
+    uint32_t arg;
+} port_OSTraceEvent;
+
+typedef uint64_t (*port_OSTraceClock)(void *ctx);
+
+struct port_OSTrace;
+
 /* ── Port state (host-side) ── */
 typedef struct {
     uint32_t currentThread;   /* GC addr of current thread, 0 = NULL */
@@ -113,6 +169,12 @@ typedef struct {
     int32_t  reschedule;
     /* GC base address for the entire block */
     uint32_t gc_base;
+    /* Fiber contexts and stacks; NULL until the first fiber thread. */
+    struct port_OSFibers *fibers;
+    int32_t  running;         /* slot whose fiber executes, or PORT_FIBER_HOST */
+    uint32_t switches;        /* context switches taken */
+    /* Trace rings; NULL until the first port_OSTraceStart. */
+    struct port_OSTrace *trace;
 } port_OSThreadState;
 
 /* Get GC address of a queue, thread, mutex, or cond from its index */
@@ -135,6 +197,13 @@ typedef struct {
 void port_OSThreadInit(port_OSThreadState *st, uint32_t gc_base);
 int  port_OSCreateThread(port_OSThreadState *st, int slot,
                          int32_t priority, uint16_t attr);
+/* OSCreateThread with a body: func(arg) runs on slot's fiber once resumed.
+ * Returns 0 for slot 0, a bad priority, or when fibers are unavailable. */
+int  port_OSCreateThreadFiber(port_OSThreadState *st, int slot,
+                              port_OSThreadFunc func, void *arg,
+                              int32_t priority, uint16_t attr);
+/* Free the fiber arena and the trace. Call from the host code, not from a fiber. */
+void port_OSThreadShutdown(port_OSThreadState *st);
 int32_t port_OSResumeThread(port_OSThreadState *st, uint32_t thread_addr);
 int32_t port_OSSuspendThread(port_OSThreadState *st, uint32_t thread_addr);
 void    port_OSSleepThread(port_OSThreadState *st, uint32_t queue_addr);
@@ -161,3 +230,18 @@ void port_OSInitMessageQueue(port_OSThreadState *st, uint32_t mq_addr, int32_t m
 int  port_OSSendMessage(port_OSThreadState *st, uint32_t mq_addr, uint32_t msg, int32_t flags);
 int  port_OSReceiveMessage(port_OSThreadState *st, uint32_t mq_addr, uint32_t *msg, int32_t flags);
 int  port_OSJamMessage(port_OSThreadState *st, uint32_t mq_addr, uint32_t msg, int32_t flags);
+
+/* ── Scheduler tracing API ── */
+/* Clear the rings and start recording; clock NULL uses the host's monotonic
+ * nanoseconds. Spans already open (the current thread, ready and blocked
+ * threads) start now. Returns 0 if the rings cannot be allocated. */
+int  port_OSTraceStart(port_OSThreadState *st, port_OSTraceClock clock, void *ctx);
+/* Stop recording and close the open spans; the rings stay readable. */
+void port_OSTraceStop(port_OSThreadState *st);
+/* Copy up to max of slot's events, oldest first. *dropped (if not NULL)
+ * gets the number of events overwritten. */
+uint32_t port_OSTraceRead(const port_OSThreadState *st, int slot,
+                          port_OSTraceEvent *out, uint32_t max, uint32_t *dropped);
+/* Chrome trace-event JSON (chrome://tracing, Perfetto), one track per
+ * thread slot, timestamps taken as nanoseconds. Returns 0 on a write error. */
+int  port_OSTraceWriteJSON(const port_OSThreadState *st, FILE *f);
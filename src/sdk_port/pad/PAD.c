@@ -14,6 +14,7 @@ typedef uint8_t u8;
 
 // RAM-backed state (big-endian in MEM1) for dump comparability.
 #include "../sdk_state.h"
+#include "../gc_clock.h"
 
 u32 gc_pad_initialized;
 u32 gc_pad_si_refresh_calls;
@@ -118,7 +119,7 @@ void PADSetSpec(u32 spec) {
 }
 
 u32 PADGetSpec(void) { return gc_pad_spec; }
-static u64 OSGetTime(void) { return 0; }
+static u64 OSGetTime(void) { return gc_clock_enabled() ? gc_clock_now() : 0; }
 // SI module (sdk_port). PADInit calls this during init.
 void SIRefreshSamplingRate(void);
 static void PAD_SIRefreshSamplingRate(void) { gc_pad_si_refresh_calls++; SIRefreshSamplingRate(); }
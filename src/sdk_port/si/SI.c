@@ -11,6 +11,7 @@ typedef int32_t s32;
 typedef int BOOL;
 
 #include "../sdk_state.h"
+#include "../gc_clock.h"
 #include "gc_mem.h"
 
 // OS interrupt primitives (minimal sdk_port model).
@@ -49,12 +50,35 @@ enum {
 
 static u32 gc_si_sampling_rate;
 
+// Virtual clock (gc_clock.h): the poll unit samples the controllers `count`
+// times per field. Each poll is an event; gc_si_poll_hook (if set) sees it.
+u32 gc_si_poll_count;
+void (*gc_si_poll_hook)(void);
+static u32 s_si_poll_event;
+
+static void si_clock_poll(void *ctx, u32 arg) {
+    (void)ctx;
+    (void)arg;
+    gc_si_poll_count++;
+    if (gc_si_poll_hook) gc_si_poll_hook();
+}
+
+static void si_clock_arm_poll(u32 count) {
+    uint64_t period;
+    if (!gc_clock_enabled() || count == 0) return;
+    gc_clock_cancel(s_si_poll_event);
+    period = (VIGetTvFormat() == VI_PAL ? GC_CLOCK_VI_FIELD_PAL : GC_CLOCK_VI_FIELD_NTSC) / count;
+    s_si_poll_event = gc_clock_schedule(GC_CLOCK_SI, gc_clock_now() + period, period,
+                                        si_clock_poll, 0, 0);
+}
+
 static void SISetXY(u32 line, u8 count) {
     gc_sdk_state_store_u32be(GC_SDK_OFF_SI_SETXY_LINE, line);
     gc_sdk_state_store_u32be(GC_SDK_OFF_SI_SETXY_COUNT, (u32)count);
     u32 calls = gc_sdk_state_load_u32_or(GC_SDK_OFF_SI_SETXY_CALLS, 0);
     calls++;
     gc_sdk_state_store_u32be(GC_SDK_OFF_SI_SETXY_CALLS, calls);
+    si_clock_arm_poll(count);
 }
 
 void SISetSamplingRate(u32 msec) {
@@ -133,6 +157,7 @@ static inline uint64_t load_u64be(uint32_t addr) {
 
 // Deterministic seed used by SITransfer's alarm scheduling in host scenarios.
 // The trace replay harness derives this from the retail alarm fire time.
+// With the virtual clock enabled, __OSGetSystemTime() is the clock instead.
 static u64 gc_os_system_time_seed;
 void gc_os_set_system_time_seed(u64 system_time) { gc_os_system_time_seed = system_time; }
 static u32 gc_os_setalarm_delta;
@@ -167,7 +192,7 @@ BOOL SITransfer(s32 chan, void *output, u32 outputBytes, void *input, u32 inputB
     // - if (now < fire): OSSetAlarm(&Alarm[chan], fire-now, AlarmHandler)
     // - else if (__SITransfer(...) succeeds): return TRUE
     // - queue packet fields + packet->fire = fire; return TRUE
-    u64 now = gc_os_system_time_seed;
+    u64 now = gc_clock_enabled() ? gc_clock_now() : gc_os_system_time_seed;
     u64 fire = now;
     if (delay != 0) {
         u64 xfer = load_u64be(SI_XFER_TIME_BASE + (uint32_t)chan * 8u);
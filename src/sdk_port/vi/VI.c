@@ -5,6 +5,7 @@ typedef uint32_t u32;
 
 // RAM-backed state (big-endian in MEM1) for dump comparability.
 #include "../sdk_state.h"
+#include "../gc_clock.h"
 
 // OS interrupt primitives (sdk_port model).
 int OSDisableInterrupts(void);
@@ -119,25 +120,70 @@ void VIFlush(void) {
     gc_sdk_state_store_u32_mirror(GC_SDK_OFF_VI_FLUSH_CALLS, &gc_vi_flush_calls, v);
 }
 
+static void vi_post_retrace(u32 rc) {
+    if (gc_vi_post_cb_fn) {
+        gc_vi_post_cb_fn(rc);
+        u32 calls = gc_sdk_state_load_u32_or(GC_SDK_OFF_VI_POST_CB_CALLS, gc_vi_post_cb_calls);
+        calls++;
+        gc_sdk_state_store_u32_mirror(GC_SDK_OFF_VI_POST_CB_CALLS, &gc_vi_post_cb_calls, calls);
+        gc_sdk_state_store_u32_mirror(GC_SDK_OFF_VI_POST_CB_LAST_ARG, &gc_vi_post_cb_last_arg, rc);
+    }
+}
+
+static u32 vi_retrace_count(void) {
+    return gc_sdk_state_load_u32_or(GC_SDK_OFF_VI_RETRACE_COUNT, gc_vi_retrace_count);
+}
+
+// Virtual clock (gc_clock.h): one retrace interrupt per field, as a periodic
+// event. The handler runs the pre callback, counts the retrace and runs the
+// post callback, like __VIRetraceHandler.
+static u32 s_vi_clock_event;
+static u32 s_vi_clock_epoch;
+
+static void vi_clock_retrace(void *ctx, u32 arg) {
+    u32 rc = vi_retrace_count();
+    (void)ctx;
+    (void)arg;
+    if (gc_vi_pre_cb_fn) gc_vi_pre_cb_fn(rc);
+    rc++;
+    gc_sdk_state_store_u32_mirror(GC_SDK_OFF_VI_RETRACE_COUNT, &gc_vi_retrace_count, rc);
+    vi_post_retrace(rc);
+}
+
+u32 VIGetTvFormat(void);
+
+static void vi_clock_arm(void) {
+    uint64_t field;
+    if (!gc_clock_enabled()) return;
+    if (s_vi_clock_epoch == gc_clock_epoch() && gc_clock_pending(s_vi_clock_event)) return;
+    field = VIGetTvFormat() == 1u /* VI_PAL */ ? GC_CLOCK_VI_FIELD_PAL : GC_CLOCK_VI_FIELD_NTSC;
+    s_vi_clock_event = gc_clock_schedule(GC_CLOCK_VI, gc_clock_now() + field, field,
+                                         vi_clock_retrace, 0, 0);
+    s_vi_clock_epoch = gc_clock_epoch();
+}
+
 void VIWaitForRetrace(void) {
     u32 v = gc_sdk_state_load_u32_or(GC_SDK_OFF_VI_WAIT_RETRACE_CALLS, gc_vi_wait_retrace_calls);
     v++;
     gc_sdk_state_store_u32_mirror(GC_SDK_OFF_VI_WAIT_RETRACE_CALLS, &gc_vi_wait_retrace_calls, v);
 
+    if (gc_clock_enabled()) {
+        // Sleep until the next retrace: the clock jumps from event to event
+        // (alarms, DMA completions, ...) until the retrace count moves.
+        const u32 start = vi_retrace_count();
+        vi_clock_arm();
+        while (vi_retrace_count() == start && gc_clock_step()) {
+        }
+        return;
+    }
+
     // We do not emulate the actual VI interrupt machinery on host.
     // Instead, model the observable consequence: retraceCount advances and
     // PostRetraceCallback is invoked once per retrace.
-    u32 rc = gc_sdk_state_load_u32_or(GC_SDK_OFF_VI_RETRACE_COUNT, gc_vi_retrace_count);
+    u32 rc = vi_retrace_count();
     rc++;
     gc_sdk_state_store_u32_mirror(GC_SDK_OFF_VI_RETRACE_COUNT, &gc_vi_retrace_count, rc);
-
-    if (gc_vi_post_cb_fn) {
-        gc_vi_post_cb_fn(rc);
-        u32 calls = gc_sdk_state_load_u32_or(GC_SDK_OFF_VI_POST_CB_CALLS, gc_vi_post_cb_calls);
-        calls++;
-        gc_sdk_state_store_u32_mirror(GC_SDK_OFF_VI_POST_CB_CALLS, &gc_vi_post_cb_calls, calls);
-        gc_sdk_state_store_u32_mirror(GC_SDK_OFF_VI_POST_CB_LAST_ARG, &gc_vi_post_cb_last_arg, rc);
-    }
+    vi_post_retrace(rc);
 }
 
 #define VI_DTV_STAT 55
@@ -162,6 +208,7 @@ enum { VI_NTSC = 0 };
 void VIInit(void) {
     s_tv_format = VI_NTSC;
     gc_sdk_state_store_u32_mirror(GC_SDK_OFF_VI_TV_FORMAT, &s_tv_format, s_tv_format);
+    vi_clock_arm();
 }
 u32 VIGetTvFormat(void) {
     s_tv_format = gc_sdk_state_load_u32_or(GC_SDK_OFF_VI_TV_FORMAT, s_tv_format);
@@ -6,6 +6,15 @@
 
 #include "sdk_state.h"
 
+#ifdef GC_HOST_GX_TRACE
+#include "gx/gx_trace.h"
+#endif
+
+#ifdef GC_OSSTOPWATCH_PROFILE
+#include <stdio.h>
+#include "os/OSStopwatch.h"
+#endif
+
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -56,8 +65,37 @@ int main(int argc, char **argv) {
         }
     }
 
+#ifdef GC_HOST_GX_TRACE
+    // Optional GX command trace of the scenario (replay with tools/run_gxtrace_replay.sh).
+    //
+    // Environment variables:
+    // - GC_GX_TRACE: output .gxtrace path
+    const char *env_trace = getenv("GC_GX_TRACE");
+    if (env_trace && *env_trace && gc_gx_trace_record_open(env_trace) != 0) {
+        die("cannot open GC_GX_TRACE");
+    }
+#endif
+
     gc_scenario_run(&ram);
 
+#ifdef GC_HOST_GX_TRACE
+    gc_gx_trace_record_stop();
+#endif
+
+#ifdef GC_OSSTOPWATCH_PROFILE
+    // Per-stopwatch host time of the scenario (src/sdk_port/os/OSStopwatch.h).
+    //
+    // Environment variables:
+    // - GC_OS_STOPWATCH_PROFILE: output path for the table
+    const char *env_swprof = getenv("GC_OS_STOPWATCH_PROFILE");
+    if (env_swprof && *env_swprof) {
+        FILE *f = fopen(env_swprof, "w");
+        if (!f) die("cannot open GC_OS_STOPWATCH_PROFILE");
+        port_OSStopwatchProfDump(f);
+        fclose(f);
+    }
+#endif
+
     // Default dump region matches the Dolphin dumps in tools/run_tests.sh.
     // Some trace-replay scenarios need larger output blobs; allow overriding
     // the main dump window without changing code.
@@ -0,0 +1,266 @@
+/*
+ * gxraster_bench.c — Throughput of the software rasterizer
+ *
+ * Draws synthetic frames shaped like MP4 scenes through the GX SDK
+ * (GXBegin..GXEnd -> vertex loader -> XF -> rasterizer) and reports
+ * Mpixels/s written to the EFB, once with a serial flush and once with
+ * gc_gx_raster_threads workers:
+ *
+ *   fonts  — pfDrawFonts-style glyph quads (8x12, alpha blended, KONST tint)
+ *   model  — perspective triangle mesh, z-buffered, two TEV stages
+ *   wipe   — fullscreen fade quads blended over each other
+ *
+ * Usage: gxraster_bench [--frames=N] [--threads=N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "gc_mem.h"
+#include "gx_raster.h"
+
+/* ── SDK surface (linked from GX.c) ─────────────────────────────── */
+typedef struct { uint8_t r, g, b, a; } GXColor;
+typedef struct { uint8_t _dummy; } GXFifoObj;
+GXFifoObj *GXInit(void *base, uint32_t size);
+void GXClearVtxDesc(void);
+void GXSetVtxDesc(uint32_t attr, uint32_t type);
+void GXSetVtxAttrFmt(uint32_t vtxfmt, uint32_t attr, uint32_t cnt, uint32_t type, uint8_t frac);
+void GXBegin(uint8_t type, uint8_t vtxfmt, uint16_t nverts);
+void GXEnd(void);
+void GXPosition3f32(float x, float y, float z);
+void GXColor4u8(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+void GXLoadPosMtxImm(float mtx[3][4], uint32_t id);
+void GXSetCurrentMtx(uint32_t id);
+void GXSetProjection(float mtx[4][4], uint32_t type);
+void GXSetViewport(float left, float top, float wd, float ht, float nearz, float farz);
+void GXSetScissor(uint32_t left, uint32_t top, uint32_t wd, uint32_t ht);
+void GXSetCullMode(uint32_t mode);
+void GXSetNumChans(uint8_t n);
+void GXSetNumTexGens(uint8_t n);
+void GXSetChanCtrl(uint32_t chan, uint8_t enable, uint32_t amb_src, uint32_t mat_src,
+                   uint32_t light_mask, uint32_t diff_fn, uint32_t attn_fn);
+void GXSetNumTevStages(uint8_t n);
+void GXSetTevOrder(uint32_t stage, uint32_t coord, uint32_t map, uint32_t color);
+void GXSetTevOp(uint32_t stage, uint32_t mode);
+void GXSetTevColorIn(uint32_t stage, uint32_t a, uint32_t b, uint32_t c, uint32_t d);
+void GXSetTevAlphaIn(uint32_t stage, uint32_t a, uint32_t b, uint32_t c, uint32_t d);
+void GXSetTevColorOp(uint32_t stage, uint32_t op, uint32_t bias, uint32_t scale, uint32_t clamp, uint32_t out);
+void GXSetTevAlphaOp(uint32_t stage, uint32_t op, uint32_t bias, uint32_t scale, uint32_t clamp, uint32_t out);
+void GXSetTevColor(uint32_t id, GXColor c);
+void GXSetTevKColor(uint32_t id, GXColor c);
+void GXSetTevKColorSel(uint32_t stage, uint32_t sel);
+void GXSetTevSwapMode(uint32_t stage, uint32_t ras_sel, uint32_t tex_sel);
+void GXSetTevSwapModeTable(uint32_t table, uint32_t r, uint32_t g, uint32_t b, uint32_t a);
+void GXSetZMode(uint8_t enable, uint32_t func, uint8_t update);
+void GXSetBlendMode(uint32_t type, uint32_t src, uint32_t dst, uint32_t op);
+void GXSetColorUpdate(uint8_t enable);
+void GXSetAlphaUpdate(uint8_t enable);
+void GXSetAlphaCompare(uint32_t comp0, uint8_t ref0, uint32_t op, uint32_t comp1, uint8_t ref1);
+void GXSetPixelFmt(uint32_t pix_fmt, uint32_t z_fmt);
+void GXSetDrawDone(void);
+
+#define RAM_BASE  0x80000000u
+#define RAM_SIZE  0x01800000u
+
+static uint32_t g_rng = 1;
+static uint32_t xorshift32(void) {
+    uint32_t x = g_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rng = x;
+    return x;
+}
+
+static float rnd_f(float lo, float hi) {
+    return lo + (hi - lo) * (float)(xorshift32() & 0xFFFFFFu) / 16777216.0f;
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/*
+ * Pixel-exact ortho (window = object + 342) or a 60-degree perspective.
+ * GXInit runs once in main: it resets the rasterizer stats.
+ */
+static void setup(int persp) {
+    float pm[3][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 } };
+    float ortho[4][4] = { { 2.0f / 640.0f, 0, 0, -1 }, { 0, -2.0f / 480.0f, 0, 1 },
+                          { 0, 0, -1, -1 }, { 0, 0, 0, 1 } };
+    float pers[4][4] = { { 1.299f, 0, 0, 0 }, { 0, 1.732f, 0, 0 },
+                         { 0, 0, -0.001f, -1.0f }, { 0, 0, -1, 0 } };
+
+    GXLoadPosMtxImm(pm, 0);
+    GXSetCurrentMtx(0);
+    GXSetProjection(persp ? pers : ortho, persp ? 0u : 1u);
+    GXSetViewport(0.0f, 0.0f, 640.0f, 480.0f, 0.0f, 1.0f);
+    GXSetScissor(0, 0, 640, 480);
+    GXSetNumChans(1);
+    GXSetChanCtrl(4, 0, 0, 1, 0, 0, 2);
+    GXSetNumTexGens(0);
+    GXSetTevSwapModeTable(0, 0, 1, 2, 3);
+    GXSetTevSwapMode(0, 0, 0);
+    GXSetTevSwapMode(1, 0, 0);
+    GXSetColorUpdate(1);
+    GXSetAlphaUpdate(1);
+    GXSetAlphaCompare(7, 0, 0, 7, 0);
+    GXSetPixelFmt(0, 0);
+    GXSetCullMode(0);
+    GXClearVtxDesc();
+    GXSetVtxDesc(9, 1);
+    GXSetVtxDesc(11, 1);
+    GXSetVtxAttrFmt(0, 9, 1, 4, 0);
+    GXSetVtxAttrFmt(0, 11, 1, 5, 0);
+}
+
+static void vtx(float x, float y, float z, uint32_t c) {
+    GXPosition3f32(x, y, z);
+    GXColor4u8((uint8_t)(c >> 24), (uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c);
+}
+
+static void frame_fonts(void) {
+    const GXColor tint = { 255, 220, 120, 255 };
+    uint32_t row, col;
+    setup(0);
+    GXSetNumTevStages(1);
+    GXSetTevOrder(0, 0xFF, 0xFF, 4);
+    GXSetTevKColor(0, tint);
+    GXSetTevKColorSel(0, 0x0C);
+    GXSetTevColorIn(0, 15, 10, 14, 15);  /* RASC * KONST */
+    GXSetTevAlphaIn(0, 7, 7, 7, 5);
+    GXSetTevColorOp(0, 0, 0, 0, 1, 0);
+    GXSetTevAlphaOp(0, 0, 0, 0, 1, 0);
+    GXSetZMode(0, 7, 0);
+    GXSetBlendMode(1, 4, 5, 0);
+    for (row = 0; row < 36; row++) {
+        GXBegin(0x80, 0, 4 * 64);
+        for (col = 0; col < 64; col++) {
+            const float x = 16.0f + (float)col * 9.5f, y = 12.0f + (float)row * 12.5f;
+            const uint32_t c = xorshift32() | 0x80u;
+            vtx(x, y, -0.5f, c);
+            vtx(x + 8.0f, y, -0.5f, c);
+            vtx(x + 8.0f, y + 12.0f, -0.5f, c);
+            vtx(x, y + 12.0f, -0.5f, c);
+        }
+        GXEnd();
+    }
+}
+
+static void frame_model(void) {
+    const GXColor amb = { 60, 60, 80, 255 };
+    uint32_t strip, i;
+    setup(1);
+    GXSetNumTevStages(2);
+    GXSetTevOrder(0, 0xFF, 0xFF, 4);
+    GXSetTevOrder(1, 0xFF, 0xFF, 0xFF);
+    GXSetTevOp(0, 4);
+    GXSetTevColor(1, amb);
+    GXSetTevColorIn(1, 2, 15, 15, 0);    /* CPREV + C0 */
+    GXSetTevAlphaIn(1, 7, 7, 7, 0);
+    GXSetTevColorOp(1, 0, 0, 0, 1, 0);
+    GXSetTevAlphaOp(1, 0, 0, 0, 1, 0);
+    GXSetZMode(1, 3, 1);
+    GXSetBlendMode(0, 4, 5, 0);
+    for (strip = 0; strip < 40; strip++) {
+        const float y0 = -3.0f + (float)strip * 0.15f;
+        GXBegin(0x98, 0, 2 * 80);
+        for (i = 0; i < 80; i++) {
+            const float x = -4.0f + (float)i * 0.1f;
+            const float z = -6.0f - rnd_f(0.0f, 1.0f);
+            vtx(x, y0, z, xorshift32() | 0xFFu);
+            vtx(x, y0 + 0.15f, z, xorshift32() | 0xFFu);
+        }
+        GXEnd();
+    }
+}
+
+static void frame_wipe(void) {
+    uint32_t layer;
+    setup(0);
+    GXSetNumTevStages(1);
+    GXSetTevOrder(0, 0xFF, 0xFF, 4);
+    GXSetTevOp(0, 4);
+    GXSetZMode(0, 7, 0);
+    GXSetBlendMode(1, 4, 5, 0);
+    for (layer = 0; layer < 4; layer++) {
+        const uint32_t c = (xorshift32() & 0xFFFFFF00u) | (0x40u + layer * 0x20u);
+        GXBegin(0x80, 0, 4);
+        vtx(0.0f, 0.0f, -0.5f, c);
+        vtx(640.0f, 0.0f, -0.5f, c);
+        vtx(640.0f, 480.0f, -0.5f, c);
+        vtx(0.0f, 480.0f, -0.5f, c);
+        GXEnd();
+    }
+}
+
+typedef struct {
+    const char *name;
+    void (*draw)(void);
+} Frame;
+
+static const Frame k_frames[] = {
+    { "fonts", frame_fonts },
+    { "model", frame_model },
+    { "wipe", frame_wipe },
+};
+
+static double run(const Frame *f, uint32_t frames, uint32_t threads, uint64_t *written) {
+    const uint64_t before = gc_gx_raster_stats.written;
+    double t0;
+    uint32_t i;
+
+    gc_gx_raster_threads = threads;
+    g_rng = 1;
+    t0 = now_sec();
+    for (i = 0; i < frames; i++) {
+        f->draw();
+        GXSetDrawDone();
+    }
+    *written = gc_gx_raster_stats.written - before;
+    return now_sec() - t0;
+}
+
+int main(int argc, char **argv) {
+    uint32_t frames = 60, threads = 4;
+    uint8_t *ram;
+    size_t i;
+    int a;
+
+    for (a = 1; a < argc; a++) {
+        if (strncmp(argv[a], "--frames=", 9) == 0)
+            frames = (uint32_t)strtoul(argv[a] + 9, NULL, 0);
+        else if (strncmp(argv[a], "--threads=", 10) == 0)
+            threads = (uint32_t)strtoul(argv[a] + 10, NULL, 0);
+        else {
+            fprintf(stderr, "Usage: gxraster_bench [--frames=N] [--threads=N]\n");
+            return 2;
+        }
+    }
+
+    ram = (uint8_t *)calloc(1, RAM_SIZE);
+    if (!ram) return 1;
+    gc_mem_set(RAM_BASE, RAM_SIZE, ram);
+    GXInit(0, 0);
+
+    printf("\n=== GX Rasterizer Bench (%u frames, %u threads) ===\n", frames, threads);
+    printf("%-8s %12s %12s %12s %8s\n", "frame", "Mpix/frame", "serial", "threaded", "speedup");
+    for (i = 0; i < sizeof(k_frames) / sizeof(k_frames[0]); i++) {
+        uint64_t ws, wt;
+        const double ts = run(&k_frames[i], frames, 1, &ws);
+        const double tt = run(&k_frames[i], frames, threads, &wt);
+        printf("%-8s %12.3f %8.1f Mp/s %8.1f Mp/s %7.2fx\n", k_frames[i].name,
+               (double)ws / frames / 1e6, (double)ws / ts / 1e6, (double)wt / tt / 1e6, ts / tt);
+    }
+    printf("\nparallel flushes: %u of %u  tev cache: %u hits / %u misses\n",
+           gc_gx_raster_stats.parallel_flushes, gc_gx_raster_stats.flushes,
+           gc_gx_raster_stats.tev_hits, gc_gx_raster_stats.tev_misses);
+    free(ram);
+    return 0;
+}
@@ -0,0 +1,319 @@
+/*
+ * gxtrace_replay.c — Replay a .gxtrace through the GP model and time it
+ *
+ * Maps a trace recorded from a host scenario (GC_GX_TRACE=path with
+ * tools/run_host_scenario.sh) and runs it through gx_gp / gx_vtx / gx_xf /
+ * gx_raster without the game, --loops times, reporting ms/frame, Mverts/s
+ * and Mpixels/s. The first loop also warms the decoded-texture and display
+ * list caches, so it is reported on its own.
+ *
+ * --demo=PATH records a synthetic session instead (indexed mesh, display
+ * list glyph quads, fullscreen wipe; one GXCopyDisp per frame), to have a
+ * trace when no scenario is at hand.
+ *
+ * Usage: gxtrace_replay FILE [--loops=N] [--threads=N]
+ *        gxtrace_replay --demo=PATH [--frames=N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "gc_mem.h"
+#include "gx_gp.h"
+#include "gx_raster.h"
+#include "gx_trace.h"
+
+/* ── SDK surface (linked from GX.c) ─────────────────────────────── */
+typedef struct { uint8_t _dummy; } GXFifoObj;
+GXFifoObj *GXInit(void *base, uint32_t size);
+void GXClearVtxDesc(void);
+void GXSetVtxDesc(uint32_t attr, uint32_t type);
+void GXSetVtxAttrFmt(uint32_t vtxfmt, uint32_t attr, uint32_t cnt, uint32_t type, uint8_t frac);
+void GXSetArray(uint32_t attr, const void *base_ptr, uint8_t stride);
+void GXBegin(uint8_t type, uint8_t vtxfmt, uint16_t nverts);
+void GXEnd(void);
+void GXPosition1x16(uint16_t idx);
+void GXPosition3f32(float x, float y, float z);
+void GXColor4u8(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+void GXLoadPosMtxImm(float mtx[3][4], uint32_t id);
+void GXSetCurrentMtx(uint32_t id);
+void GXSetProjection(float mtx[4][4], uint32_t type);
+void GXSetViewport(float left, float top, float wd, float ht, float nearz, float farz);
+void GXSetScissor(uint32_t left, uint32_t top, uint32_t wd, uint32_t ht);
+void GXSetCullMode(uint32_t mode);
+void GXSetNumChans(uint8_t n);
+void GXSetNumTexGens(uint8_t n);
+void GXSetChanCtrl(uint32_t chan, uint8_t enable, uint32_t amb_src, uint32_t mat_src,
+                   uint32_t light_mask, uint32_t diff_fn, uint32_t attn_fn);
+void GXSetNumTevStages(uint8_t n);
+void GXSetTevOrder(uint32_t stage, uint32_t coord, uint32_t map, uint32_t color);
+void GXSetTevOp(uint32_t stage, uint32_t mode);
+void GXSetZMode(uint8_t enable, uint32_t func, uint8_t update);
+void GXSetBlendMode(uint32_t type, uint32_t src, uint32_t dst, uint32_t op);
+void GXSetColorUpdate(uint8_t enable);
+void GXSetAlphaCompare(uint32_t comp0, uint8_t ref0, uint32_t op, uint32_t comp1, uint8_t ref1);
+void GXSetPixelFmt(uint32_t pix_fmt, uint32_t z_fmt);
+void GXBeginDisplayList(void *list, uint32_t size);
+uint32_t GXEndDisplayList(void);
+void GXCallDisplayList(const void *list, uint32_t nbytes);
+void GXSetDispCopySrc(uint16_t left, uint16_t top, uint16_t wd, uint16_t ht);
+void GXSetDispCopyDst(uint16_t wd, uint16_t ht);
+uint32_t GXSetDispCopyYScale(float vscale);
+void GXCopyDisp(void *dest, uint8_t clear);
+
+#define RAM_BASE   GC_GX_TRACE_RAM_BASE
+#define RAM_SIZE   GC_GX_TRACE_RAM_SIZE
+#define MESH_ADDR  0x80200000u
+#define DL_ADDR    0x80280000u
+#define XFB_ADDR   0x80600000u
+#define MESH_W     48u
+#define MESH_H     32u
+#define DL_SIZE    0x8000u
+
+static uint32_t g_rng = 1;
+static uint32_t xorshift32(void) {
+    uint32_t x = g_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rng = x;
+    return x;
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* ── Demo session ───────────────────────────────────────────────── */
+
+static void demo_setup(void) {
+    float pm[3][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 } };
+    float ortho[4][4] = { { 2.0f / 640.0f, 0, 0, -1 }, { 0, -2.0f / 480.0f, 0, 1 },
+                          { 0, 0, -1, -1 }, { 0, 0, 0, 1 } };
+
+    GXLoadPosMtxImm(pm, 0);
+    GXSetCurrentMtx(0);
+    GXSetProjection(ortho, 1);
+    GXSetViewport(0.0f, 0.0f, 640.0f, 480.0f, 0.0f, 1.0f);
+    GXSetScissor(0, 0, 640, 480);
+    GXSetNumChans(1);
+    GXSetChanCtrl(4, 0, 0, 1, 0, 0, 2);
+    GXSetNumTexGens(0);
+    GXSetNumTevStages(1);
+    GXSetTevOrder(0, 0xFF, 0xFF, 4);
+    GXSetTevOp(0, 4);
+    GXSetColorUpdate(1);
+    GXSetAlphaCompare(7, 0, 0, 7, 0);
+    GXSetPixelFmt(0, 0);
+    GXSetCullMode(0);
+    GXSetVtxAttrFmt(0, 9, 1, 4, 0);
+    GXSetVtxAttrFmt(0, 11, 1, 5, 0);
+    GXSetVtxAttrFmt(1, 9, 1, 3, 0);
+    GXSetVtxAttrFmt(1, 11, 1, 5, 0);
+    GXSetDispCopySrc(0, 0, 640, 480);
+    GXSetDispCopyDst(640, 480);
+    GXSetDispCopyYScale(1.0f);
+}
+
+static void direct_desc(void) {
+    GXClearVtxDesc();
+    GXSetVtxDesc(9, 1);
+    GXSetVtxDesc(11, 1);
+}
+
+/* S16 positions of a MESH_W x MESH_H grid; the frame moves one row. */
+static void demo_mesh_init(uint32_t frame) {
+    uint8_t *p = gc_mem_ptr(MESH_ADDR, MESH_W * MESH_H * 8u);
+    uint32_t x, y;
+    for (y = 0; y < MESH_H; y++) {
+        for (x = 0; x < MESH_W; x++, p += 8) {
+            const uint32_t px = 20u + x * 12u + (y == frame % MESH_H ? 4u : 0u), py = 20u + y * 14u;
+            const uint32_t pz = 0xFFF0u - (xorshift32() & 7u);
+            p[0] = (uint8_t)(px >> 8); p[1] = (uint8_t)px;
+            p[2] = (uint8_t)(py >> 8); p[3] = (uint8_t)py;
+            p[4] = (uint8_t)(pz >> 8); p[5] = (uint8_t)pz;
+        }
+    }
+}
+
+/* 32 rows x 64 glyph quads, recorded once and called every frame. */
+static uint32_t demo_glyph_list(void) {
+    uint32_t row, col;
+    direct_desc();
+    GXBeginDisplayList((void *)(uintptr_t)DL_ADDR, DL_SIZE);
+    for (row = 0; row < 32u; row++) {
+        GXBegin(0x80, 0, 4 * 64);
+        for (col = 0; col < 64u; col++) {
+            const float x = 16.0f + (float)col * 9.5f, y = 40.0f + (float)row * 12.5f;
+            const uint32_t c = xorshift32() | 0x80u;
+            const float xs[4] = { x, x + 8.0f, x + 8.0f, x }, ys[4] = { y, y, y + 12.0f, y + 12.0f };
+            uint32_t i;
+            for (i = 0; i < 4u; i++) {
+                GXPosition3f32(xs[i], ys[i], -0.5f);
+                GXColor4u8((uint8_t)(c >> 24), (uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c);
+            }
+        }
+        GXEnd();
+    }
+    return GXEndDisplayList();
+}
+
+static void demo_frame(uint32_t frame, uint32_t dl_size) {
+    const uint32_t c = xorshift32() | 0x40u;
+    uint32_t x, y;
+
+    demo_mesh_init(frame);
+    GXSetZMode(1, 3, 1);
+    GXSetBlendMode(0, 4, 5, 0);
+    GXClearVtxDesc();
+    GXSetVtxDesc(9, 3);
+    GXSetVtxDesc(11, 1);
+    GXSetArray(9, (void *)(uintptr_t)MESH_ADDR, 8);
+    for (y = 0; y + 1u < MESH_H; y++) {
+        GXBegin(0x98, 1, (uint16_t)(2u * MESH_W));
+        for (x = 0; x < MESH_W; x++) {
+            GXPosition1x16((uint16_t)(y * MESH_W + x));
+            GXColor4u8((uint8_t)(x * 5u), (uint8_t)(y * 8u), 0x80, 0xFF);
+            GXPosition1x16((uint16_t)((y + 1u) * MESH_W + x));
+            GXColor4u8((uint8_t)(x * 5u), (uint8_t)(y * 8u + 8u), 0x80, 0xFF);
+        }
+        GXEnd();
+    }
+
+    GXSetZMode(0, 7, 0);
+    GXSetBlendMode(1, 4, 5, 0);
+    direct_desc();
+    GXCallDisplayList((void *)(uintptr_t)DL_ADDR, dl_size);
+    GXBegin(0x80, 0, 4);
+    GXPosition3f32(0.0f, 0.0f, -0.5f);
+    GXColor4u8((uint8_t)(c >> 24), (uint8_t)(c >> 16), (uint8_t)(c >> 8), 0x30);
+    GXPosition3f32(640.0f, 0.0f, -0.5f);
+    GXColor4u8((uint8_t)(c >> 24), (uint8_t)(c >> 16), (uint8_t)(c >> 8), 0x30);
+    GXPosition3f32(640.0f, 480.0f, -0.5f);
+    GXColor4u8((uint8_t)(c >> 24), (uint8_t)(c >> 16), (uint8_t)(c >> 8), 0x30);
+    GXPosition3f32(0.0f, 480.0f, -0.5f);
+    GXColor4u8((uint8_t)(c >> 24), (uint8_t)(c >> 16), (uint8_t)(c >> 8), 0x30);
+    GXEnd();
+    GXCopyDisp((void *)(uintptr_t)XFB_ADDR, 1);
+}
+
+static int record_demo(const char *path, uint32_t frames) {
+    uint32_t dl_size, i;
+    if (gc_gx_trace_record_open(path) != 0) {
+        fprintf(stderr, "gxtrace_replay: cannot write %s\n", path);
+        return 1;
+    }
+    GXInit(0, 0);
+    demo_setup();
+    dl_size = demo_glyph_list();
+    for (i = 0; i < frames; i++) demo_frame(i, dl_size);
+    gc_gx_trace_record_stop();
+    printf("recorded %s: %u frames, %u records, %.2f MB commands, %.2f MB RAM\n", path,
+           gc_gx_trace_recorded.frames, gc_gx_trace_recorded.records,
+           (double)gc_gx_trace_recorded.cmd_bytes / 1e6, (double)gc_gx_trace_recorded.mem_bytes / 1e6);
+    return 0;
+}
+
+/* ── Replay ─────────────────────────────────────────────────────── */
+
+typedef struct {
+    double sec;
+    uint32_t frames, draws;
+    uint64_t verts, written;
+} Loop;
+
+static int replay_loop(const uint8_t *data, size_t size, Loop *l) {
+    const uint32_t draws0 = gc_gx_gp.draws, verts0 = gc_gx_gp.verts;
+    const uint64_t written0 = gc_gx_raster_stats.written;
+    GcGxTraceStats st;
+    double t0 = now_sec();
+    int ok = gc_gx_trace_replay(data, size, &st);
+
+    gc_gx_raster_flush();
+    l->sec = now_sec() - t0;
+    l->frames = st.frames;
+    /* A RESET record zeroes the GP and raster counters: count from there. */
+    l->draws = gc_gx_gp.draws - (st.resets ? 0u : draws0);
+    l->verts = gc_gx_gp.verts - (st.resets ? 0u : verts0);
+    l->written = gc_gx_raster_stats.written - (st.resets ? 0u : written0);
+    return ok;
+}
+
+static void print_loop(const char *name, const Loop *l) {
+    const double frames = l->frames ? (double)l->frames : 1.0;
+    printf("%-8s %8u %10.3f %10.2f %10.2f %10.1f\n", name, l->frames, l->sec * 1e3 / frames,
+           (double)l->verts / l->sec / 1e6, (double)l->written / l->sec / 1e6, frames / l->sec);
+}
+
+int main(int argc, char **argv) {
+    const char *path = NULL, *demo = NULL;
+    uint32_t loops = 5, threads = 4, frames = 60, i;
+    const uint8_t *data;
+    size_t size = 0;
+    uint8_t *ram;
+    Loop first, l, sum;
+    int a, ok = 1, usage = 0;
+
+    for (a = 1; a < argc; a++) {
+        if (strncmp(argv[a], "--loops=", 8) == 0)
+            loops = (uint32_t)strtoul(argv[a] + 8, NULL, 0);
+        else if (strncmp(argv[a], "--threads=", 10) == 0)
+            threads = (uint32_t)strtoul(argv[a] + 10, NULL, 0);
+        else if (strncmp(argv[a], "--frames=", 9) == 0)
+            frames = (uint32_t)strtoul(argv[a] + 9, NULL, 0);
+        else if (strncmp(argv[a], "--demo=", 7) == 0)
+            demo = argv[a] + 7;
+        else if (argv[a][0] != '-' && !path)
+            path = argv[a];
+        else
+            usage = 1;
+    }
+    if (usage || (!path && !demo)) {
+        fprintf(stderr, "Usage: gxtrace_replay FILE [--loops=N] [--threads=N]\n"
+                        "       gxtrace_replay --demo=PATH [--frames=N]\n");
+        return 2;
+    }
+
+    ram = (uint8_t *)calloc(1, RAM_SIZE);
+    if (!ram) return 1;
+    gc_mem_set(RAM_BASE, RAM_SIZE, ram);
+    gc_gx_raster_threads = threads;
+    if (demo) {
+        a = record_demo(demo, frames);
+        free(ram);
+        return a;
+    }
+
+    data = gc_gx_trace_map(path, &size);
+    if (!data) {
+        fprintf(stderr, "gxtrace_replay: cannot map %s\n", path);
+        free(ram);
+        return 1;
+    }
+    printf("\n=== GX Trace Replay (%s, %.2f MB, %u loops, %u threads) ===\n", path,
+           (double)size / 1e6, loops, threads);
+    printf("%-8s %8s %10s %10s %10s %10s\n", "loop", "frames", "ms/frame", "Mverts/s", "Mpix/s", "fps");
+    ok &= replay_loop(data, size, &first);
+    print_loop("first", &first);
+    memset(&sum, 0, sizeof(sum));
+    for (i = 1; i < loops; i++) {
+        ok &= replay_loop(data, size, &l);
+        sum.sec += l.sec;
+        sum.frames += l.frames;
+        sum.draws += l.draws;
+        sum.verts += l.verts;
+        sum.written += l.written;
+    }
+    if (loops > 1u) print_loop("warm", &sum);
+    printf("\nper loop: %u draws, %llu verts, %llu pixels written\n", first.draws,
+           (unsigned long long)first.verts, (unsigned long long)first.written);
+    if (!ok) printf("warning: trace is truncated or not a version %u trace\n", GC_GX_TRACE_VERSION);
+    gc_gx_trace_unmap(data, size);
+    free(ram);
+    return ok ? 0 : 1;
+}
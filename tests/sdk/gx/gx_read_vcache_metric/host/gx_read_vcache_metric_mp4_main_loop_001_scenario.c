@@ -4,14 +4,16 @@
 #include "harness/gc_host_scenario.h"
 #include "harness/gc_host_test.h"
 
-extern uint32_t gc_gx_vcache_sel;
+extern uint32_t gc_gx_vcache_metrics[3];
 void GXReadVCacheMetric(uint32_t *check, uint32_t *miss, uint32_t *stall);
 
 const char *gc_scenario_label(void) { return "GXReadVCacheMetric/mp4_main_loop"; }
 const char *gc_scenario_out_path(void) { return "../actual/gx_read_vcache_metric_mp4_main_loop_001.bin"; }
 
 void gc_scenario_run(GcRam *ram) {
-    gc_gx_vcache_sel = 0x12345678u;
+    gc_gx_vcache_metrics[0] = 0x12345678u;
+    gc_gx_vcache_metrics[1] = 0;
+    gc_gx_vcache_metrics[2] = 0;
 
     uint32_t a = 0, b = 0, c = 0;
     GXReadVCacheMetric(&a, &b, &c);
@@ -1,2 +1,12 @@
 #include "src/sdk_port/gc_mem.c"
 #include "src/sdk_port/gx/GX.c"
+#include "src/sdk_port/gx/gx_gp.c"
+#include "src/sdk_port/gx/gx_dl.c"
+#include "src/sdk_port/gx/gx_vtx.c"
+#include "src/sdk_port/gx/gx_xf.c"
+#include "src/sdk_port/gx/gx_raster.c"
+#include "src/sdk_port/gx/gx_texdec.c"
+#include "src/sdk_port/gx/gx_texcopy.c"
+#include "src/sdk_port/gx/gx_xfb.c"
+#include "src/sdk_port/gx/gx_tmem.c"
+#include "src/sdk_port/gx/gx_fifo.c"
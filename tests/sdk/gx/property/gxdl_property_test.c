@@ -0,0 +1,455 @@
+/*
+ * gxdl_property_test.c — Property test for the GX display list replay cache
+ *
+ * Oracle: gc_gx_gp_run over the raw list bytes (cache disabled)
+ * Port:   gc_gx_dl_call pre-decode + replay (sdk_port/gx/gx_dl.c)
+ *
+ * Both paths must leave the GP model (gx_gp.c) in the same state.
+ *
+ * Levels:
+ *   L0 — SDK-recorded list: GXBeginDisplayList/GXEndDisplayList capture + parity
+ *   L1 — Random raw streams (CP/XF/BP/draw/NOP mix) parity, miss then hit
+ *   L2 — Invalidation: re-recording the list forces a re-decode
+ *   L3 — DCFlushRange over unchanged bytes revalidates without re-decoding
+ *   L4 — Nested CALL_DL + LRU eviction pressure
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "gc_mem.h"
+#include "gx_gp.h"
+#include "gx_dl.h"
+
+/* ── xorshift32 PRNG ────────────────────────────────────────────── */
+static uint32_t g_rng;
+static uint32_t xorshift32(void) {
+    uint32_t x = g_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rng = x;
+    return x;
+}
+
+/* ── Counters ───────────────────────────────────────────────────── */
+static uint64_t g_total_checks;
+static uint64_t g_total_pass;
+static int       g_verbose;
+static const char *g_opt_op;
+
+#define CHECK(cond, ...) do { \
+    g_total_checks++; \
+    if (!(cond)) { \
+        printf("FAIL @ %s:%d: ", __FILE__, __LINE__); \
+        printf(__VA_ARGS__); printf("\n"); \
+        return 0; \
+    } \
+    g_total_pass++; \
+} while(0)
+
+/* ── SDK surface (linked from GX.c / OSCache.c) ─────────────────── */
+typedef struct { uint8_t _dummy; } GXFifoObj;
+GXFifoObj *GXInit(void *base, uint32_t size);
+void GXBeginDisplayList(void *list, uint32_t size);
+uint32_t GXEndDisplayList(void);
+void GXCallDisplayList(const void *list, uint32_t nbytes);
+void GXClearVtxDesc(void);
+void GXSetVtxDesc(uint32_t attr, uint32_t type);
+void GXSetVtxAttrFmt(uint32_t vtxfmt, uint32_t attr, uint32_t cnt, uint32_t type, uint8_t frac);
+void GXBegin(uint8_t type, uint8_t vtxfmt, uint16_t nverts);
+void GXEnd(void);
+void GXPosition3f32(float x, float y, float z);
+void GXColor4u8(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+void GXTexCoord2f32(float s, float t);
+void GXLoadPosMtxImm(float mtx[3][4], uint32_t id);
+void GXSetTevColorIn(uint32_t stage, uint32_t a, uint32_t b, uint32_t c, uint32_t d);
+void GXSetCurrentMtx(uint32_t id);
+void GXFlush(void);
+void DCFlushRange(void *addr, uint32_t nbytes);
+
+/* ── Emulated RAM ───────────────────────────────────────────────── */
+#define RAM_BASE  0x80000000u
+#define RAM_SIZE  0x01800000u
+#define DL_AREA   0x80100000u   /* 32 lists x 4 KiB */
+#define DL_SLOT   0x1000u
+
+static uint8_t *g_ram;
+
+static void ram_init(void) {
+    if (!g_ram) g_ram = (uint8_t *)calloc(1, RAM_SIZE);
+    gc_mem_set(RAM_BASE, RAM_SIZE, g_ram);
+}
+
+static uint8_t *ram(uint32_t addr) { return gc_mem_ptr(addr, 1); }
+
+/* ── GP snapshot helpers ────────────────────────────────────────── */
+static GcGxGpState g_snap;
+
+static void run_oracle(uint32_t addr, uint32_t size) {
+    gc_gx_dl_cache_enable = 0;
+    gc_gx_dl_call(addr, size);
+    gc_gx_dl_cache_enable = 1;
+}
+
+static int gp_equal(const GcGxGpState *a, const GcGxGpState *b) {
+    return memcmp(a, b, sizeof(*a)) == 0;
+}
+
+/* ── Raw stream generator ───────────────────────────────────────── */
+static uint32_t g_gen_cp[256];
+
+static void put8(uint8_t *b, uint32_t *n, uint32_t v) { b[(*n)++] = (uint8_t)v; }
+static void put16(uint8_t *b, uint32_t *n, uint32_t v) { put8(b, n, v >> 8); put8(b, n, v); }
+static void put32(uint8_t *b, uint32_t *n, uint32_t v) { put16(b, n, v >> 16); put16(b, n, v); }
+
+/* Random but sane vertex state: at most a few attributes, small formats. */
+static uint32_t rand_cp_reg(uint32_t *val) {
+    switch (xorshift32() % 5) {
+    case 0: *val = (xorshift32() & 0x1FE00u) | (xorshift32() & 1u); return GC_GX_CP_VCD_LO;
+    case 1: *val = xorshift32() & 0xFu; return GC_GX_CP_VCD_HI;
+    case 2: *val = xorshift32() & 0x3FFFFFFFu; return GC_GX_CP_VAT_A + (xorshift32() & 7u);
+    case 3: *val = RAM_BASE | (xorshift32() & 0xFFFF0u); return GC_GX_CP_ARRAY_BASE + 12u + (xorshift32() & 3u);
+    default: *val = 4u + (xorshift32() & 0x3Cu); return GC_GX_CP_ARRAY_STRIDE + 12u + (xorshift32() & 3u);
+    }
+}
+
+static uint32_t gen_stream(uint8_t *b, uint32_t cap, int with_calls) {
+    uint32_t n = 0;
+    while (n + 256u < cap) {
+        uint32_t k = xorshift32() % (with_calls ? 8u : 7u);
+        uint32_t i, v;
+        if (k == 0) {
+            put8(b, &n, GC_GX_CMD_NOP);
+        } else if (k == 1) {
+            uint32_t reg = rand_cp_reg(&v);
+            put8(b, &n, GC_GX_CMD_LOAD_CP_REG);
+            put8(b, &n, reg);
+            put32(b, &n, v);
+            g_gen_cp[reg] = v;
+        } else if (k == 2) {
+            uint32_t cnt = 1u + (xorshift32() & 15u);
+            uint32_t addr = (xorshift32() & 1u) ? (xorshift32() % (GC_GX_XF_MEM_SIZE - cnt))
+                                                : (GC_GX_XF_REG_BASE + xorshift32() % (GC_GX_XF_REG_COUNT - cnt));
+            put8(b, &n, GC_GX_CMD_LOAD_XF_REG);
+            put32(b, &n, ((cnt - 1u) << 16) | addr);
+            for (i = 0; i < cnt; i++) put32(b, &n, xorshift32());
+        } else if (k == 3) {
+            /* Texture copies (BP 0x52, bit 14 clear) write RAM and could land on the lists. */
+            v = xorshift32();
+            if ((v >> 24) == 0x52u) v |= 1u << 14;
+            put8(b, &n, GC_GX_CMD_LOAD_BP_REG);
+            put32(b, &n, v);
+        } else if (k == 4) {
+            put8(b, &n, GC_GX_CMD_LOAD_INDX_A + ((xorshift32() & 3u) << 3));
+            put32(b, &n, ((xorshift32() & 0xFFu) << 16) | ((xorshift32() & 0xFu) << 12) | (xorshift32() & 0x3FFu));
+        } else if (k == 5) {
+            put8(b, &n, GC_GX_CMD_INVAL_VTX);
+        } else if (k == 6) {
+            uint32_t cmd = GC_GX_CMD_DRAW_FIRST | (xorshift32() & 0x3Fu);
+            uint32_t nv = xorshift32() & 3u;
+            uint32_t sz = gc_gx_gp_vertex_size_cp(g_gen_cp, cmd) * nv;
+            if (n + 3u + sz + 64u >= cap) break;
+            put8(b, &n, cmd);
+            put16(b, &n, nv);
+            for (i = 0; i < sz; i++) put8(b, &n, xorshift32());
+        } else {
+            /* Nested call into one of the other slots (bounded by GC_GX_DL_MAX_DEPTH). */
+            put8(b, &n, GC_GX_CMD_CALL_DL);
+            put32(b, &n, (DL_AREA + (xorshift32() & 31u) * DL_SLOT) & 0x3FFFFFFFu);
+            put32(b, &n, 32u + (xorshift32() & 0x1E0u));
+        }
+        if ((xorshift32() & 7u) == 0) break;
+    }
+    while (n & 31u) put8(b, &n, GC_GX_CMD_NOP);
+    return n;
+}
+
+static uint32_t write_random_list(uint32_t addr, int with_calls) {
+    uint8_t buf[DL_SLOT];
+    uint32_t n;
+    memcpy(g_gen_cp, gc_gx_gp.cp, sizeof(g_gen_cp));
+    n = gen_stream(buf, sizeof(buf), with_calls);
+    memcpy(ram(addr), buf, n);
+    DCFlushRange((void *)(uintptr_t)addr, n);
+    return n;
+}
+
+/* ── SDK-recorded list ──────────────────────────────────────────── */
+static uint32_t record_sdk_list(uint32_t addr, uint32_t nprims) {
+    float m[3][4];
+    uint32_t p, v, r, c;
+
+    GXBeginDisplayList((void *)(uintptr_t)addr, DL_SLOT);
+    for (p = 0; p < nprims; p++) {
+        for (r = 0; r < 3; r++)
+            for (c = 0; c < 4; c++)
+                m[r][c] = (float)(int32_t)(xorshift32() & 0xFFFu) / 64.0f;
+        GXLoadPosMtxImm(m, (xorshift32() % 10u) * 3u);
+        GXSetCurrentMtx((xorshift32() % 10u) * 3u);
+        GXSetTevColorIn(xorshift32() & 15u, xorshift32() & 15u, xorshift32() & 15u,
+                        xorshift32() & 15u, xorshift32() & 15u);
+        {
+            uint32_t nv = 1u + (xorshift32() & 7u);
+            GXBegin(0x90, 0, (uint16_t)nv);
+            for (v = 0; v < nv; v++) {
+                GXPosition3f32((float)(xorshift32() & 0xFF), (float)(xorshift32() & 0xFF), 0.0f);
+                GXColor4u8((uint8_t)xorshift32(), (uint8_t)xorshift32(), (uint8_t)xorshift32(), 0xFF);
+                GXTexCoord2f32((float)(xorshift32() & 1), (float)(xorshift32() & 1));
+            }
+            GXEnd();
+        }
+    }
+    return GXEndDisplayList();
+}
+
+/* GXEndDisplayList/GXCallDisplayList force register and vertex state to be
+ * resent; get that out of the way (empty primitive) so snapshots only differ
+ * by the list itself. */
+static void settle(void) {
+    GXBegin(0x90, 0, 0);
+    GXEnd();
+    GXFlush();
+}
+
+static void setup_vtx_fmt0(void) {
+    GXClearVtxDesc();
+    GXSetVtxDesc(9, 1);   /* POS direct */
+    GXSetVtxDesc(11, 1);  /* CLR0 direct */
+    GXSetVtxDesc(13, 1);  /* TEX0 direct */
+    GXSetVtxAttrFmt(0, 9, 1, 4, 0);   /* XYZ f32 */
+    GXSetVtxAttrFmt(0, 11, 1, 5, 0);  /* RGBA8 */
+    GXSetVtxAttrFmt(0, 13, 1, 4, 0);  /* ST f32 */
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Levels
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L0_sdk_list(void) {
+    const uint32_t addr = DL_AREA;
+    GcGxGpState ref;
+    uint32_t size, misses, hits;
+
+    GXInit(0, 0);
+    setup_vtx_fmt0();
+    size = record_sdk_list(addr, 1u + (xorshift32() & 7u));
+    CHECK(size != 0 && (size & 31u) == 0, "L0 list size=%u not 32B-padded", size);
+    CHECK(ram(addr)[0] != 0, "L0 list bytes not written");
+
+    settle();
+    g_snap = gc_gx_gp;
+    run_oracle(addr, size);
+    ref = gc_gx_gp;
+    CHECK(ref.draws > g_snap.draws, "L0 oracle saw no draws");
+
+    gc_gx_gp = g_snap;
+    misses = gc_gx_dl_cache_misses;
+    GXCallDisplayList((void *)(uintptr_t)addr, size);
+    CHECK(gc_gx_dl_cache_misses == misses + 1u, "L0 first call not a miss");
+    CHECK(gp_equal(&gc_gx_gp, &ref), "L0 cached decode != raw parse");
+
+    settle();
+    gc_gx_gp = g_snap;
+    hits = gc_gx_dl_cache_hits;
+    GXCallDisplayList((void *)(uintptr_t)addr, size);
+    CHECK(gc_gx_dl_cache_hits == hits + 1u, "L0 second call not a hit");
+    CHECK(gp_equal(&gc_gx_gp, &ref), "L0 replay != raw parse");
+    return 1;
+}
+
+static int test_L1_random_streams(void) {
+    uint32_t iter;
+    GXInit(0, 0);
+    for (iter = 0; iter < 16; iter++) {
+        const uint32_t addr = DL_AREA + (iter & 31u) * DL_SLOT;
+        uint32_t size = write_random_list(addr, 0);
+        GcGxGpState ref;
+
+        g_snap = gc_gx_gp;
+        run_oracle(addr, size);
+        ref = gc_gx_gp;
+
+        gc_gx_gp = g_snap;
+        gc_gx_dl_call(addr, size);
+        CHECK(gp_equal(&gc_gx_gp, &ref), "L1 iter %u: decode != raw (size=%u)", iter, size);
+
+        gc_gx_gp = g_snap;
+        gc_gx_dl_call(addr, size);
+        CHECK(gp_equal(&gc_gx_gp, &ref), "L1 iter %u: replay != raw (size=%u)", iter, size);
+    }
+    return 1;
+}
+
+static int test_L2_invalidate(void) {
+    const uint32_t addr = DL_AREA + 3u * DL_SLOT;
+    uint32_t size, size2, misses, inval;
+    GcGxGpState ref;
+
+    GXInit(0, 0);
+    setup_vtx_fmt0();
+    size = record_sdk_list(addr, 2);
+    settle();
+    GXCallDisplayList((void *)(uintptr_t)addr, size);
+
+    /* Re-record different content over the same buffer (same size is likely). */
+    inval = gc_gx_dl_cache_invalidations;
+    size2 = record_sdk_list(addr, 2);
+    CHECK(gc_gx_dl_cache_invalidations > inval, "L2 re-record did not invalidate");
+    settle();
+
+    g_snap = gc_gx_gp;
+    run_oracle(addr, size2);
+    ref = gc_gx_gp;
+
+    gc_gx_gp = g_snap;
+    misses = gc_gx_dl_cache_misses;
+    GXCallDisplayList((void *)(uintptr_t)addr, size2);
+    CHECK(size2 != size || gc_gx_dl_cache_misses == misses + 1u, "L2 stale entry reused");
+    CHECK(gp_equal(&gc_gx_gp, &ref), "L2 post-invalidate replay != raw parse");
+    return 1;
+}
+
+static int test_L3_revalidate(void) {
+    const uint32_t addr = DL_AREA + 5u * DL_SLOT;
+    uint32_t size, misses, reval;
+
+    GXInit(0, 0);
+    size = write_random_list(addr, 0);
+    g_snap = gc_gx_gp;
+    gc_gx_dl_call(addr, size);
+
+    /* Same entry vertex state as the first call, or the key differs. */
+    gc_gx_gp = g_snap;
+    misses = gc_gx_dl_cache_misses;
+    reval = gc_gx_dl_cache_revalidations;
+    DCFlushRange((void *)(uintptr_t)(addr + (xorshift32() % size)), 1);
+    gc_gx_dl_call(addr, size);
+    CHECK(gc_gx_dl_cache_revalidations == reval + 1u, "L3 unchanged bytes not revalidated");
+    CHECK(gc_gx_dl_cache_misses == misses, "L3 unchanged bytes re-decoded");
+
+    /* Unreported write: only verify mode notices. */
+    ram(addr)[size - 1u] ^= 0xFFu;
+    gc_gx_gp = g_snap;
+    gc_gx_dl_cache_verify = 1;
+    gc_gx_dl_call(addr, size);
+    gc_gx_dl_cache_verify = 0;
+    CHECK(gc_gx_dl_cache_misses == misses + 1u, "L3 verify mode missed a silent write");
+    return 1;
+}
+
+static int test_L4_nested_evict(void) {
+    uint32_t i, iter;
+    GXInit(0, 0);
+    for (i = 0; i < 32; i++) {
+        write_random_list(DL_AREA + i * DL_SLOT, 1);
+    }
+    for (iter = 0; iter < 8; iter++) {
+        const uint32_t addr = DL_AREA + (xorshift32() & 31u) * DL_SLOT;
+        const uint32_t size = 32u + (xorshift32() & 0x3E0u);
+        GcGxGpState ref;
+
+        g_snap = gc_gx_gp;
+        run_oracle(addr, size);
+        ref = gc_gx_gp;
+
+        gc_gx_gp = g_snap;
+        gc_gx_dl_call(addr, size);
+        CHECK(gp_equal(&gc_gx_gp, &ref), "L4 iter %u: nested replay != raw", iter);
+    }
+    CHECK(gc_gx_dl_cache_hits + gc_gx_dl_cache_misses > 0, "L4 cache unused");
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Per-seed runner
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int run_seed(uint32_t seed) {
+    g_rng = seed;
+    ram_init();
+    if (!g_opt_op || strstr("L0", g_opt_op) || strstr("SDK", g_opt_op)) {
+        if (!test_L0_sdk_list()) return 0;
+    }
+    if (!g_opt_op || strstr("L1", g_opt_op) || strstr("PARITY", g_opt_op)) {
+        if (!test_L1_random_streams()) return 0;
+    }
+    if (!g_opt_op || strstr("L2", g_opt_op) || strstr("INVALIDATE", g_opt_op)) {
+        if (!test_L2_invalidate()) return 0;
+    }
+    if (!g_opt_op || strstr("L3", g_opt_op) || strstr("REVALIDATE", g_opt_op)) {
+        if (!test_L3_revalidate()) return 0;
+    }
+    if (!g_opt_op || strstr("L4", g_opt_op) || strstr("NESTED", g_opt_op) || strstr("FULL", g_opt_op)) {
+        if (!test_L4_nested_evict()) return 0;
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * main
+ * ═══════════════════════════════════════════════════════════════════ */
+
+int main(int argc, char **argv) {
+    uint32_t start_seed = 1;
+    int num_runs = 100;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+            start_seed = (uint32_t)strtoul(argv[i] + 7, NULL, 0);
+        else if (strncmp(argv[i], "--num-runs=", 11) == 0)
+            num_runs = atoi(argv[i] + 11);
+        else if (strncmp(argv[i], "--op=", 5) == 0)
+            g_opt_op = argv[i] + 5;
+        else if (strcmp(argv[i], "-v") == 0)
+            g_verbose = 1;
+        else {
+            fprintf(stderr,
+                    "Usage: gxdl_property_test [--seed=N] [--num-runs=N] "
+                    "[--op=L0|L1|L2|L3|L4|SDK|PARITY|INVALIDATE|REVALIDATE|NESTED|FULL] [-v]\n");
+            return 2;
+        }
+    }
+
+    printf("\n=== GX Display List Cache Property Test ===\n");
+
+    for (i = 0; i < num_runs; i++) {
+        uint32_t seed = start_seed + (uint32_t)i;
+        uint64_t before = g_total_checks;
+
+        if (!run_seed(seed)) {
+            printf("  FAILED at seed %u\n", seed);
+            printf("\n--- Summary ---\n");
+            printf("Seeds:  %d (failed at %d)\n", i + 1, i + 1);
+            printf("Checks: %llu  (pass=%llu  fail=1)\n",
+                   (unsigned long long)g_total_checks,
+                   (unsigned long long)g_total_pass);
+            printf("\nRESULT: FAIL\n");
+            return 1;
+        }
+
+        if (g_verbose) {
+            printf("  seed %u: %llu checks OK (hits=%u misses=%u reval=%u inval=%u evict=%u)\n",
+                   seed, (unsigned long long)(g_total_checks - before),
+                   gc_gx_dl_cache_hits, gc_gx_dl_cache_misses, gc_gx_dl_cache_revalidations,
+                   gc_gx_dl_cache_invalidations, gc_gx_dl_cache_evictions);
+        }
+        if ((i + 1) % 100 == 0) {
+            printf("  progress: seed %d/%d\n", i + 1, num_runs);
+        }
+    }
+
+    printf("\n--- Summary ---\n");
+    printf("Seeds:  %d\n", num_runs);
+    printf("Checks: %llu  (pass=%llu  fail=0)\n",
+           (unsigned long long)g_total_checks,
+           (unsigned long long)g_total_pass);
+    printf("\nRESULT: %llu/%llu PASS\n",
+           (unsigned long long)g_total_pass,
+           (unsigned long long)g_total_checks);
+
+    return 0;
+}
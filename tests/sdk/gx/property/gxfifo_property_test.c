@@ -0,0 +1,618 @@
+/*
+ * gxfifo_property_test.c — Property test for the CPU/GP command FIFO
+ *
+ * Oracle: the same random scene run with the GP inline (no consumer
+ *         thread), and a closed-form model of PE token / draw done
+ *         interrupts latched until the next sync point
+ * Port:   gx_fifo.c (ring in the GXInit range, watermarks, consumer
+ *         thread, deferred RAM write notices), GX.c sync points
+ *
+ * Levels:
+ *   L0 — Ring: quads, register bursts and strips larger than the ring,
+ *        in emulated RAM, a host buffer or the default ring; the ring
+ *        holds the command stream at write offsets, the pointers meet
+ *        after a sync, the bytes in flight stay inside the ring, and the
+ *        threaded run leaves the same GP registers, counters, EFB and XFB
+ *   L1 — PE sync: GXSetDrawSync / GXSetDrawDone between draws; the sync
+ *        callback fires once per sync point with the last token, the
+ *        draw done callback once after a GXSetDrawDone, GXReadDrawSync
+ *        returns the token, in both modes
+ *   L2 — RAM write order: display lists rebuilt while the GP is busy
+ *        (GXEndDisplayList reports the write) and called again, with the
+ *        thread switched off and on mid-scene; same results as inline
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "gc_mem.h"
+#include "gx_gp.h"
+#include "gx_fifo.h"
+#include "gx_raster.h"
+#include "gx_trace.h"
+
+/* ── xorshift32 PRNG ────────────────────────────────────────────── */
+static uint32_t g_rng;
+static uint32_t xorshift32(void) {
+    uint32_t x = g_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rng = x;
+    return x;
+}
+
+/* ── Counters ───────────────────────────────────────────────────── */
+static uint64_t g_total_checks;
+static uint64_t g_total_pass;
+static int       g_verbose;
+static const char *g_opt_op;
+
+#define CHECK(cond, ...) do { \
+    g_total_checks++; \
+    if (!(cond)) { \
+        printf("FAIL @ %s:%d: ", __FILE__, __LINE__); \
+        printf(__VA_ARGS__); printf("\n"); \
+        return 0; \
+    } \
+    g_total_pass++; \
+} while(0)
+
+/* ── SDK surface (linked from GX.c) ─────────────────────────────── */
+typedef struct { uint8_t r, g, b, a; } GXColor;
+typedef struct {
+    void *base;
+    void *top;
+    uint32_t size;
+    uint32_t hiWatermark;
+    uint32_t loWatermark;
+    void *rdPtr;
+    void *wrPtr;
+    int32_t count;
+    uint8_t bind_cpu;
+    uint8_t bind_gp;
+} GXFifoObj;
+typedef void (*GXDrawSyncCallback)(uint16_t token);
+typedef void (*GXDrawDoneCallback)(void);
+
+GXFifoObj *GXInit(void *base, uint32_t size);
+void GXClearVtxDesc(void);
+void GXSetVtxDesc(uint32_t attr, uint32_t type);
+void GXSetVtxAttrFmt(uint32_t vtxfmt, uint32_t attr, uint32_t cnt, uint32_t type, uint8_t frac);
+void GXBegin(uint8_t type, uint8_t vtxfmt, uint16_t nverts);
+void GXEnd(void);
+void GXPosition3f32(float x, float y, float z);
+void GXColor4u8(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+void GXLoadPosMtxImm(float mtx[3][4], uint32_t id);
+void GXSetCurrentMtx(uint32_t id);
+void GXSetProjection(float mtx[4][4], uint32_t type);
+void GXSetViewport(float left, float top, float wd, float ht, float nearz, float farz);
+void GXSetCullMode(uint32_t mode);
+void GXSetNumChans(uint8_t n);
+void GXSetNumTexGens(uint8_t n);
+void GXSetChanCtrl(uint32_t chan, uint8_t enable, uint32_t amb_src, uint32_t mat_src,
+                   uint32_t light_mask, uint32_t diff_fn, uint32_t attn_fn);
+void GXSetNumTevStages(uint8_t n);
+void GXSetTevOrder(uint32_t stage, uint32_t coord, uint32_t map, uint32_t color);
+void GXSetTevOp(uint32_t stage, uint32_t mode);
+void GXSetTevColor(uint32_t id, GXColor color);
+void GXSetZMode(uint8_t enable, uint32_t func, uint8_t update);
+void GXSetBlendMode(uint32_t type, uint32_t src, uint32_t dst, uint32_t op);
+void GXSetColorUpdate(uint8_t enable);
+void GXSetAlphaCompare(uint32_t comp0, uint8_t ref0, uint32_t op, uint32_t comp1, uint8_t ref1);
+void GXSetPixelFmt(uint32_t pix_fmt, uint32_t z_fmt);
+void GXSetDispCopySrc(uint16_t left, uint16_t top, uint16_t wd, uint16_t ht);
+void GXSetDispCopyDst(uint16_t wd, uint16_t ht);
+void GXCopyDisp(void *dest, uint8_t clear);
+void GXBeginDisplayList(void *list, uint32_t size);
+uint32_t GXEndDisplayList(void);
+void GXCallDisplayList(const void *list, uint32_t nbytes);
+void GXFlush(void);
+
+GXDrawSyncCallback GXSetDrawSyncCallback(GXDrawSyncCallback cb);
+GXDrawDoneCallback GXSetDrawDoneCallback(GXDrawDoneCallback cb);
+void GXSetDrawSync(uint16_t token);
+uint16_t GXReadDrawSync(void);
+void GXSetDrawDone(void);
+void GXWaitDrawDone(void);
+void GXDrawDone(void);
+
+/* ── Emulated RAM ───────────────────────────────────────────────── */
+#define RAM_BASE   0x80000000u
+#define RAM_SIZE   0x01800000u
+#define FIFO_ADDR  0x80100000u
+#define DL_ADDR    0x80300000u
+#define XFB_ADDR   0x80600000u
+
+#define DL_SLOTS   8u
+#define DL_SIZE    0x800u
+#define XFB_W      64u
+#define XFB_H      64u
+#define XFB_BYTES  (XFB_W * 2u * XFB_H)
+
+static uint8_t *g_ram;
+static uint8_t g_host_fifo[0x20000];
+
+static void ram_init(void) {
+    if (!g_ram) g_ram = (uint8_t *)calloc(1, RAM_SIZE);
+    gc_mem_set(RAM_BASE, RAM_SIZE, g_ram);
+}
+
+static uint8_t *ram(uint32_t addr) { return g_ram + (addr - RAM_BASE); }
+
+static uint64_t fnv(const void *p, size_t n) {
+    const uint8_t *b = (const uint8_t *)p;
+    uint64_t h = 1469598103934665603ull;
+    size_t i;
+    for (i = 0; i < n; i++) h = (h ^ b[i]) * 1099511628211ull;
+    return h;
+}
+
+/* ── Scenes ─────────────────────────────────────────────────────── */
+enum {
+    OP_QUAD, OP_REGS, OP_STRIP, OP_TOKEN, OP_DONE, OP_SYNC, OP_DL, OP_MODE, OP_COUNT
+};
+
+#define MAX_OPS   48
+#define MAX_LOG   256u
+#define BIG_VERTS 6000u         /* 16 bytes each: longer than the 64K ring */
+
+typedef struct {
+    uint32_t op;
+    uint32_t a, b, c;
+} Op;
+
+typedef struct {
+    uint32_t ring;              /* 0: RAM, 1: host buffer, 2: GXInit(0, 0) */
+    uint32_t size;
+    uint32_t nops;
+    Op ops[MAX_OPS];
+} Scene;
+
+/* What a run leaves behind. */
+typedef struct {
+    uint32_t log[MAX_LOG];      /* callback / GXReadDrawSync events */
+    uint32_t nlog;
+    GcGxGpState gp;
+    uint64_t efb;
+    uint64_t xfb;
+    uint64_t written;
+    uint32_t wp0;               /* ring offset where the scene starts */
+    GcGxFifoInfo info;
+    GcGxFifoStats stats;
+    GXFifoObj obj;
+} Result;
+
+static Result *g_res;
+
+#define EV_TOKEN 0x10000u
+#define EV_DONE  0x20000u
+#define EV_READ  0x30000u
+
+static void log_event(uint32_t ev) {
+    if (g_res->nlog < MAX_LOG) g_res->log[g_res->nlog++] = ev;
+}
+
+static void cb_token(uint16_t token) { log_event(EV_TOKEN | token); }
+static void cb_done(void) { log_event(EV_DONE); }
+
+/* Command stream as the GP runs it (inline runs only). */
+static uint8_t *g_stream;
+static uint32_t g_stream_len;
+static uint32_t g_stream_cap;
+
+static void capture(uint32_t type, const void *data, uint32_t size) {
+    if (type != GC_GX_TRACE_CMD) return;
+    if (g_stream_len + size > g_stream_cap) {
+        g_stream_cap = (g_stream_len + size) * 2u;
+        g_stream = (uint8_t *)realloc(g_stream, g_stream_cap);
+    }
+    memcpy(g_stream + g_stream_len, data, size);
+    g_stream_len += size;
+}
+
+static void *scene_base(const Scene *s) {
+    if (s->ring == 0) return (void *)(uintptr_t)FIFO_ADDR;
+    if (s->ring == 1) return g_host_fifo;
+    return 0;
+}
+
+static void sdk_setup(const Scene *s) {
+    float pm[3][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 } };
+    float proj[4][4] = { { 2.0f / 640.0f, 0, 0, -1 }, { 0, -2.0f / 480.0f, 0, 1 },
+                         { 0, 0, -1, -1 }, { 0, 0, 0, 1 } };
+
+    g_res->obj = *GXInit(scene_base(s), s->ring == 2 ? 0u : s->size);
+    GXLoadPosMtxImm(pm, 0);
+    GXSetCurrentMtx(0);
+    GXSetProjection(proj, 1);
+    GXSetViewport(0.0f, 0.0f, 640.0f, 480.0f, 0.0f, 1.0f);
+    GXSetNumChans(1);
+    GXSetChanCtrl(4 /* GX_COLOR0A0 */, 0, 0, 1 /* mat vtx */, 0, 0, 2);
+    GXSetNumTexGens(0);
+    GXSetNumTevStages(1);
+    GXSetTevOrder(0, 0xFF, 0xFF, 4 /* GX_COLOR0A0 */);
+    GXSetTevOp(0, 4 /* GX_PASSCLR */);
+    GXSetZMode(1, 3 /* GX_LEQUAL */, 1);
+    GXSetBlendMode(0, 4, 5, 0);
+    GXSetColorUpdate(1);
+    GXSetAlphaCompare(7, 0, 0, 7, 0);
+    GXSetPixelFmt(0 /* GX_PF_RGB8_Z24 */, 0);
+    GXSetCullMode(0);
+    GXSetDispCopySrc(0, 0, XFB_W, XFB_H);
+    GXSetDispCopyDst(XFB_W, XFB_H);
+
+    GXClearVtxDesc();
+    GXSetVtxDesc(9, 1);
+    GXSetVtxDesc(11, 1);
+    GXSetVtxAttrFmt(0, 9, 1, 4, 0);
+    GXSetVtxAttrFmt(0, 11, 1, 5, 0);
+}
+
+static void sdk_quad(uint32_t seed) {
+    const float x = (float)(seed % 600u), y = (float)((seed >> 10) % 440u);
+    const float w = 1.0f + (float)((seed >> 20) % 40u), h = 1.0f + (float)((seed >> 26) % 40u);
+    const float z = -(float)(seed % 97u) / 100.0f;
+    const float xs[4] = { x, x + w, x + w, x };
+    const float ys[4] = { y, y, y + h, y + h };
+    uint32_t i;
+    GXBegin(0x80, 0, 4);
+    for (i = 0; i < 4u; i++) {
+        GXPosition3f32(xs[i], ys[i], z);
+        GXColor4u8((uint8_t)seed, (uint8_t)(seed >> 8), (uint8_t)(seed >> 16), 0xFF);
+    }
+    GXEnd();
+}
+
+/* A strip of tiny triangles inside a 4x4 box: lots of bytes, few pixels. */
+static void sdk_strip(uint32_t n, uint32_t seed) {
+    const float x = (float)(seed % 600u), y = (float)((seed >> 10) % 440u);
+    uint32_t i;
+    GXBegin(0x98, 0, (uint16_t)n);
+    for (i = 0; i < n; i++) {
+        GXPosition3f32(x + (float)(i & 3u), y + (float)((i >> 1) & 3u), -0.5f);
+        GXColor4u8((uint8_t)i, (uint8_t)seed, 0x80, 0xFF);
+    }
+    GXEnd();
+}
+
+static void sdk_regs(uint32_t n, uint32_t seed) {
+    uint32_t i;
+    for (i = 0; i < n; i++) {
+        const GXColor c = { (uint8_t)(seed + i), (uint8_t)(seed >> 8), (uint8_t)i, 0xFF };
+        GXSetTevColor(1u + (i % 3u), c);
+        GXSetBlendMode(0, 4, 5, 0);
+    }
+}
+
+static void sdk_dl(uint32_t slot, uint32_t nquads, uint32_t seed) {
+    void *dl = (void *)(uintptr_t)(DL_ADDR + slot * DL_SIZE);
+    uint32_t i, n;
+    GXBeginDisplayList(dl, DL_SIZE);
+    for (i = 0; i < nquads; i++) sdk_quad(seed * 2654435761u + i);
+    n = GXEndDisplayList();
+    GXCallDisplayList(dl, n);
+}
+
+/* Sync points: b picks GXDrawDone, GXWaitDrawDone, GXReadDrawSync or GXCopyDisp. */
+static void sdk_sync(uint32_t kind) {
+    switch (kind) {
+    case 0: GXDrawDone(); break;
+    case 1: GXWaitDrawDone(); break;
+    case 2: log_event(EV_READ | GXReadDrawSync()); break;
+    default: GXCopyDisp((void *)(uintptr_t)XFB_ADDR, 0); break;
+    }
+}
+
+static void run_scene(const Scene *s, uint32_t threaded, Result *r) {
+    uint32_t i;
+
+    memset(r, 0, sizeof(*r));
+    g_res = r;
+    memset(ram(DL_ADDR), 0, DL_SLOTS * DL_SIZE);
+    memset(ram(XFB_ADDR), 0, XFB_BYTES);
+    gc_gx_fifo_threaded = threaded;
+    sdk_setup(s);
+    gc_gx_fifo_drain();
+    gc_gx_fifo_info(&r->info);
+    r->wp0 = r->info.wp;
+    memset(&gc_gx_fifo_stats, 0, sizeof(gc_gx_fifo_stats));
+    if (!gc_gx_efb.color) gc_gx_raster_efb_init(&gc_gx_efb);
+    gc_gx_raster_clear(&gc_gx_efb, 0, 0xFFFFFFu);
+    GXSetDrawSyncCallback(cb_token);
+    GXSetDrawDoneCallback(cb_done);
+    if (!threaded) {
+        g_stream_len = 0;
+        gc_gx_trace_hook = capture;
+    }
+
+    for (i = 0; i < s->nops; i++) {
+        const Op *o = &s->ops[i];
+        switch (o->op) {
+        case OP_QUAD: sdk_quad(o->a); break;
+        case OP_REGS: sdk_regs(o->a, o->b); break;
+        case OP_STRIP: sdk_strip(o->a, o->b); break;
+        case OP_TOKEN: GXSetDrawSync((uint16_t)o->a); break;
+        case OP_DONE: GXSetDrawDone(); break;
+        case OP_SYNC: sdk_sync(o->a); break;
+        case OP_DL: sdk_dl(o->a, o->b, o->c); break;
+        case OP_MODE: if (threaded) gc_gx_fifo_threaded = o->a; break;
+        default: break;
+        }
+    }
+    GXFlush();
+    gc_gx_fifo_drain();
+    r->stats = gc_gx_fifo_stats;
+    gc_gx_trace_hook = 0;
+    gc_gx_fifo_info(&r->info);
+    r->gp = gc_gx_gp;
+    r->efb = fnv(gc_gx_efb.color, GC_GX_EFB_WIDTH * GC_GX_EFB_HEIGHT * 4u) ^
+             fnv(gc_gx_efb.depth, GC_GX_EFB_WIDTH * GC_GX_EFB_HEIGHT * 4u) * 3u;
+    r->xfb = fnv(ram(XFB_ADDR), XFB_BYTES);
+    r->written = gc_gx_fifo_stats.written;
+    GXSetDrawSyncCallback(0);
+    GXSetDrawDoneCallback(0);
+    gc_gx_fifo_threaded = 1;
+}
+
+/* Interrupts latch until a sync point hands them over. */
+static uint32_t oracle_log(const Scene *s, uint32_t *log) {
+    uint32_t i, n = 0, token = 0, tok_int = 0, done_int = 0;
+    for (i = 0; i < s->nops; i++) {
+        const Op *o = &s->ops[i];
+        if (o->op == OP_TOKEN) {
+            token = o->a & 0xFFFFu;
+            tok_int = 1;
+        } else if (o->op == OP_DONE) {
+            done_int = 1;
+        } else if (o->op == OP_SYNC) {
+            if (tok_int && n < MAX_LOG) log[n++] = EV_TOKEN | token;
+            if (done_int && n < MAX_LOG) log[n++] = EV_DONE;
+            if (o->a == 2u && n < MAX_LOG) log[n++] = EV_READ | token;
+            tok_int = done_int = 0;
+        }
+    }
+    return n;
+}
+
+static void gen_scene(Scene *s, uint32_t level) {
+    static const uint32_t k_sizes[] = { 0x10000u, 0x18000u, 0x20000u, 0x40000u };
+    uint32_t i, dl_busy = 0;
+
+    s->ring = xorshift32() % 3u;
+    s->size = s->ring == 1 ? sizeof(g_host_fifo) : k_sizes[xorshift32() % 4u];
+    s->nops = 8u + xorshift32() % (MAX_OPS - 8u);
+    for (i = 0; i < s->nops; i++) {
+        Op *o = &s->ops[i];
+        const uint32_t pick = xorshift32() % 16u;
+        o->a = xorshift32();
+        o->b = xorshift32();
+        o->c = xorshift32();
+        if (pick < 5u) {
+            o->op = OP_QUAD;
+        } else if (pick < 7u) {
+            o->op = OP_REGS;
+            o->a = 1u + o->a % 200u;
+        } else if (pick < 8u) {
+            o->op = OP_STRIP;
+            o->a = (o->a & 3u) ? 3u + o->a % 900u : BIG_VERTS;
+        } else if (level >= 1 && pick < 10u) {
+            o->op = OP_TOKEN;
+            o->a &= 0xFFFFu;
+        } else if (level >= 1 && pick < 11u) {
+            o->op = OP_DONE;
+        } else if (level >= 1 && pick < 13u) {
+            o->op = OP_SYNC;
+            o->a %= 4u;
+            dl_busy = 0;
+        } else if (level >= 2 && pick < 15u) {
+            // A slot is rebuilt only once the GP is done with its last call.
+            o->op = OP_DL;
+            o->a %= DL_SLOTS;
+            if (dl_busy & (1u << o->a)) o->a = (o->a + 1u) % DL_SLOTS;
+            if (dl_busy & (1u << o->a)) {
+                o->op = OP_QUAD;
+                continue;
+            }
+            dl_busy |= 1u << o->a;
+            o->b = 1u + o->b % 24u;
+        } else if (level >= 2) {
+            o->op = OP_MODE;
+            o->a &= 1u;
+        } else {
+            o->op = OP_QUAD;
+        }
+    }
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Checks shared by the levels
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static Result g_inline, g_thread;
+
+static int check_scene(const Scene *s, uint32_t level) {
+    const Result *a = &g_inline, *b = &g_thread;
+    const uint8_t *ring = s->ring == 0 ? ram(FIFO_ADDR) : s->ring == 1 ? g_host_fifo : 0;
+    const uint32_t size = s->ring == 2 ? GC_GX_FIFO_MIN_SIZE : s->size;
+    uint32_t want[MAX_LOG], nwant, i;
+
+    run_scene(s, 0, &g_inline);
+    run_scene(s, 1, &g_thread);
+
+    /* Ring placement and watermarks. */
+    CHECK(a->info.size == size, "L%u ring size %u != %u", level, a->info.size, size);
+    CHECK(a->info.base == (s->ring == 0 ? FIFO_ADDR : 0u), "L%u ring base %08X", level,
+          a->info.base);
+    CHECK(a->info.hi == size - 0x4000u && a->info.lo == size / 2u, "L%u watermarks %X/%X (size %X)",
+          level, a->info.hi, a->info.lo, size);
+    CHECK(a->obj.size == size && a->obj.hiWatermark == a->info.hi &&
+          a->obj.loWatermark == a->info.lo, "L%u GXFifoObj size/watermarks", level);
+    CHECK(s->ring == 2 || a->obj.base == scene_base(s), "L%u GXFifoObj base %p", level,
+          a->obj.base);
+
+    /* Everything written was run, and the pointers meet. */
+    for (i = 0; i < 2; i++) {
+        const Result *r = i ? b : a;
+        CHECK(r->stats.consumed == r->written, "L%u %s consumed %llu of %llu", level,
+              i ? "threaded" : "inline", (unsigned long long)r->stats.consumed,
+              (unsigned long long)r->written);
+        CHECK(r->info.count == 0 && r->info.wp == r->info.rp &&
+              r->info.wp == (uint32_t)((r->wp0 + r->written) % size), "L%u %s wp %X rp %X count %u", level,
+              i ? "threaded" : "inline", r->info.wp, r->info.rp, r->info.count);
+    }
+    CHECK(a->written == b->written, "L%u bytes written %llu != %llu", level,
+          (unsigned long long)a->written, (unsigned long long)b->written);
+
+    /* The ring holds the stream at its write offsets. */
+    CHECK(g_stream_len == a->written, "L%u stream %u bytes, %llu written", level, g_stream_len,
+          (unsigned long long)a->written);
+    if (ring) {
+        const uint32_t from = g_stream_len > size ? g_stream_len - size : 0u;
+        for (i = from; i < g_stream_len; i++) {
+            if (ring[(a->wp0 + i) % size] != g_stream[i]) break;
+        }
+        CHECK(i == g_stream_len, "L%u ring byte %X != stream byte %u", level,
+              (a->wp0 + i) % size, i);
+    }
+
+    /* The write pointer wraps, and never runs over bytes the GP has not read. */
+    for (i = 0; i < 2; i++) {
+        const Result *r = i ? b : a;
+        CHECK(r->stats.wraps == (uint32_t)((r->wp0 + r->written) / size), "L%u %s wraps %u",
+              level, i ? "threaded" : "inline", r->stats.wraps);
+        CHECK(r->stats.max_count < size, "L%u %s %u bytes in flight in a %X ring", level,
+              i ? "threaded" : "inline", r->stats.max_count, size);
+    }
+
+    /* Same GP results with and without the consumer thread. */
+    CHECK(memcmp(&a->gp, &b->gp, sizeof(a->gp)) == 0, "L%u GP state differs (draws %u/%u bp %u/%u)",
+          level, a->gp.draws, b->gp.draws, a->gp.bp_writes, b->gp.bp_writes);
+    CHECK(a->efb == b->efb, "L%u EFB differs", level);
+    CHECK(a->xfb == b->xfb, "L%u XFB differs", level);
+
+    /* PE interrupts reach the callbacks at the sync points. */
+    nwant = oracle_log(s, want);
+    CHECK(a->nlog == nwant && memcmp(a->log, want, nwant * 4u) == 0,
+          "L%u inline callbacks: %u events, want %u", level, a->nlog, nwant);
+    CHECK(b->nlog == nwant && memcmp(b->log, want, nwant * 4u) == 0,
+          "L%u threaded callbacks: %u events, want %u", level, b->nlog, nwant);
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L0 / L1 / L2
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_level(uint32_t level) {
+    Scene s;
+    gen_scene(&s, level);
+    return check_scene(&s, level);
+}
+
+/* GXEndDisplayList while the thread is busy: the notice waits for its place. */
+static int test_L2_rebuild(void) {
+    Scene s;
+    uint32_t i, n = 0;
+
+    memset(&s, 0, sizeof(s));
+    s.ring = 0;
+    s.size = 0x20000u;
+    for (i = 0; i < 4u; i++) {
+        const uint32_t seed = xorshift32();
+        s.ops[n++] = (Op){ OP_DL, 0, 1u + seed % 20u, seed };
+        s.ops[n++] = (Op){ OP_SYNC, 0, 0, 0 };
+        s.ops[n++] = (Op){ OP_STRIP, 2000u + seed % 2000u, seed, 0 };
+        s.ops[n++] = (Op){ OP_DL, 1, 1u + (seed >> 8) % 20u, seed >> 3 };
+        s.ops[n++] = (Op){ OP_SYNC, 3, 0, 0 };
+    }
+    s.nops = n;
+    return check_scene(&s, 2);
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Per-seed runner
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int run_seed(uint32_t seed) {
+    g_rng = seed;
+    ram_init();
+    if (!g_opt_op || strstr("L0", g_opt_op) || strstr("RING", g_opt_op)) {
+        if (!test_level(0)) return 0;
+    }
+    if (!g_opt_op || strstr("L1", g_opt_op) || strstr("SYNC", g_opt_op)) {
+        if (!test_level(1)) return 0;
+    }
+    if (!g_opt_op || strstr("L2", g_opt_op) || strstr("ORDER", g_opt_op) || strstr("FULL", g_opt_op)) {
+        if (!test_level(2)) return 0;
+        if (!test_L2_rebuild()) return 0;
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * main
+ * ═══════════════════════════════════════════════════════════════════ */
+
+int main(int argc, char **argv) {
+    uint32_t start_seed = 1;
+    int num_runs = 100;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+            start_seed = (uint32_t)strtoul(argv[i] + 7, NULL, 0);
+        else if (strncmp(argv[i], "--num-runs=", 11) == 0)
+            num_runs = atoi(argv[i] + 11);
+        else if (strncmp(argv[i], "--op=", 5) == 0)
+            g_opt_op = argv[i] + 5;
+        else if (strcmp(argv[i], "-v") == 0)
+            g_verbose = 1;
+        else {
+            fprintf(stderr,
+                    "Usage: gxfifo_property_test [--seed=N] [--num-runs=N] "
+                    "[--op=L0|L1|L2|RING|SYNC|ORDER|FULL] [-v]\n");
+            return 2;
+        }
+    }
+
+    printf("\n=== GX CPU/GP FIFO Property Test ===\n");
+
+    for (i = 0; i < num_runs; i++) {
+        uint32_t seed = start_seed + (uint32_t)i;
+        uint64_t before = g_total_checks;
+
+        if (!run_seed(seed)) {
+            printf("  FAILED at seed %u\n", seed);
+            printf("\n--- Summary ---\n");
+            printf("Seeds:  %d (failed at %d)\n", i + 1, i + 1);
+            printf("Checks: %llu  (pass=%llu  fail=1)\n",
+                   (unsigned long long)g_total_checks,
+                   (unsigned long long)g_total_pass);
+            printf("\nRESULT: FAIL\n");
+            return 1;
+        }
+
+        if (g_verbose) {
+            printf("  seed %u: %llu checks OK\n", seed,
+                   (unsigned long long)(g_total_checks - before));
+        }
+        if ((i + 1) % 100 == 0) {
+            printf("  progress: seed %d/%d\n", i + 1, num_runs);
+        }
+    }
+
+    gc_gx_fifo_shutdown();
+    printf("\n--- Summary ---\n");
+    printf("Seeds:  %d\n", num_runs);
+    printf("Checks: %llu  (pass=%llu  fail=0)\n",
+           (unsigned long long)g_total_checks,
+           (unsigned long long)g_total_pass);
+    printf("\nRESULT: %llu/%llu PASS\n",
+           (unsigned long long)g_total_pass,
+           (unsigned long long)g_total_checks);
+
+    return 0;
+}
@@ -0,0 +1,525 @@
+/*
+ * gxperf_property_test.c — Property test for the GX performance metrics
+ *
+ * Oracle: closed-form counts of what each draw and copy does
+ * Port:   GXSet/Clear/Read*Metric in GX.c, fed from gx_vtx (vertex cache),
+ *         gx_raster (pixel pipe), gx_texcopy / gx_xfb (copies)
+ *
+ * Levels:
+ *   L0 — Vertex cache: random index16 POS / index8 CLR0 draws over arrays
+ *        that fit the cache; a fetch misses iff it touches a line not
+ *        fetched before, a repeat draw hits, GXInvalidateVtxCache empties
+ *        the cache; GX_VC_ALL sums the attributes, others read 0
+ *   L1 — Pixel pipe: two overlapping z-tested quads with the z test before
+ *        or after TEV; top/bottom in/out and color counts, and the GP
+ *        metric selections (vertices, triangles, passed, culled, texels)
+ *   L2 — Semantics and copies: selections switched mid-stream, reads
+ *        without clears accumulate, clears zero; GXCopyTex / GXCopyDisp
+ *        copy clocks and PE requests
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "gc_mem.h"
+#include "gx_raster.h"
+#include "gx_texcopy.h"
+#include "gx_xfb.h"
+
+/* ── xorshift32 PRNG ────────────────────────────────────────────── */
+static uint32_t g_rng;
+static uint32_t xorshift32(void) {
+    uint32_t x = g_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rng = x;
+    return x;
+}
+
+/* ── Counters ───────────────────────────────────────────────────── */
+static uint64_t g_total_checks;
+static uint64_t g_total_pass;
+static int       g_verbose;
+static const char *g_opt_op;
+
+#define CHECK(cond, ...) do { \
+    g_total_checks++; \
+    if (!(cond)) { \
+        printf("FAIL @ %s:%d: ", __FILE__, __LINE__); \
+        printf(__VA_ARGS__); printf("\n"); \
+        return 0; \
+    } \
+    g_total_pass++; \
+} while(0)
+
+/* ── SDK surface (linked from GX.c) ─────────────────────────────── */
+typedef struct { uint8_t r, g, b, a; } GXColor;
+typedef struct { uint8_t _dummy; } GXFifoObj;
+GXFifoObj *GXInit(void *base, uint32_t size);
+void GXClearVtxDesc(void);
+void GXSetVtxDesc(uint32_t attr, uint32_t type);
+void GXSetVtxAttrFmt(uint32_t vtxfmt, uint32_t attr, uint32_t cnt, uint32_t type, uint8_t frac);
+void GXSetArray(uint32_t attr, const void *base_ptr, uint8_t stride);
+void GXInvalidateVtxCache(void);
+void GXBegin(uint8_t type, uint8_t vtxfmt, uint16_t nverts);
+void GXEnd(void);
+void GXPosition1x16(uint16_t idx);
+void GXColor1x8(uint8_t idx);
+void GXPosition3f32(float x, float y, float z);
+void GXColor4u8(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+void GXLoadPosMtxImm(float mtx[3][4], uint32_t id);
+void GXSetCurrentMtx(uint32_t id);
+void GXSetProjection(float mtx[4][4], uint32_t type);
+void GXSetViewport(float left, float top, float wd, float ht, float nearz, float farz);
+void GXSetCullMode(uint32_t mode);
+void GXSetNumChans(uint8_t n);
+void GXSetNumTexGens(uint8_t n);
+void GXSetChanCtrl(uint32_t chan, uint8_t enable, uint32_t amb_src, uint32_t mat_src,
+                   uint32_t light_mask, uint32_t diff_fn, uint32_t attn_fn);
+void GXSetNumTevStages(uint8_t n);
+void GXSetTevOrder(uint32_t stage, uint32_t coord, uint32_t map, uint32_t color);
+void GXSetTevOp(uint32_t stage, uint32_t mode);
+void GXSetZMode(uint8_t enable, uint32_t func, uint8_t update);
+void GXSetZCompLoc(uint8_t before_tex);
+void GXSetBlendMode(uint32_t type, uint32_t src, uint32_t dst, uint32_t op);
+void GXSetColorUpdate(uint8_t enable);
+void GXSetAlphaCompare(uint32_t comp0, uint8_t ref0, uint32_t op, uint32_t comp1, uint8_t ref1);
+void GXSetPixelFmt(uint32_t pix_fmt, uint32_t z_fmt);
+void GXSetDrawDone(void);
+void GXSetTexCopySrc(uint16_t left, uint16_t top, uint16_t wd, uint16_t ht);
+void GXSetTexCopyDst(uint16_t wd, uint16_t ht, uint32_t fmt, uint32_t mipmap);
+void GXCopyTex(void *dest, uint32_t clear);
+void GXSetDispCopySrc(uint16_t left, uint16_t top, uint16_t wd, uint16_t ht);
+void GXSetDispCopyDst(uint16_t wd, uint16_t ht);
+uint32_t GXSetDispCopyYScale(float vscale);
+void GXCopyDisp(void *dest, uint8_t clear);
+
+void GXSetGPMetric(uint32_t perf0, uint32_t perf1);
+void GXClearGPMetric(void);
+void GXReadGPMetric(uint32_t *met0, uint32_t *met1);
+void GXSetVCacheMetric(uint32_t attr);
+void GXClearVCacheMetric(void);
+void GXReadVCacheMetric(uint32_t *check, uint32_t *miss, uint32_t *stall);
+void GXClearPixMetric(void);
+void GXReadPixMetric(uint32_t *top_in, uint32_t *top_out, uint32_t *bot_in, uint32_t *bot_out,
+                     uint32_t *clr_in, uint32_t *copy_clks);
+void GXClearMemMetric(void);
+void GXReadMemMetric(uint32_t *cp_req, uint32_t *tc_req, uint32_t *cpu_rd_req, uint32_t *cpu_wr_req,
+                     uint32_t *dsp_req, uint32_t *io_req, uint32_t *vi_req, uint32_t *pe_req,
+                     uint32_t *rf_req, uint32_t *fi_req);
+
+/* GXPerf0 / GXPerf1 / GXVCachePerf values used here. */
+#define GX_PERF0_VERTICES            0u
+#define GX_PERF0_TRIANGLES           11u
+#define GX_PERF0_TRIANGLES_CULLED    12u
+#define GX_PERF0_TRIANGLES_PASSED    13u
+#define GX_PERF0_TRIANGLES_SCISSORED 14u
+#define GX_PERF0_CLOCKS              34u
+#define GX_PERF0_NONE                35u
+#define GX_PERF1_TEXELS              0u
+#define GX_PERF1_TC_MISS             8u
+#define GX_PERF1_VERTICES            16u
+#define GX_PERF1_VC_MISS_REQ         19u
+#define GX_PERF1_CLOCKS              21u
+#define GX_PERF1_NONE                22u
+#define GX_VC_POS                    0u
+#define GX_VC_NRM                    1u
+#define GX_VC_CLR0                   2u
+#define GX_VC_ALL                    15u
+
+/* ── Emulated RAM ───────────────────────────────────────────────── */
+#define RAM_BASE   0x80000000u
+#define RAM_SIZE   0x01800000u
+#define ARRAY_ADDR 0x80200000u
+#define COPY_ADDR  0x80400000u
+#define XFB_ADDR   0x80600000u
+
+static uint8_t *g_ram;
+
+static void ram_init(void) {
+    if (!g_ram) g_ram = (uint8_t *)calloc(1, RAM_SIZE);
+    gc_mem_set(RAM_BASE, RAM_SIZE, g_ram);
+}
+
+/* ── Helpers ────────────────────────────────────────────────────── */
+#define MAX_VTX 64u
+#define EFB_W   GC_GX_EFB_WIDTH
+#define EFB_H   GC_GX_EFB_HEIGHT
+
+static uint32_t min_u32(uint32_t a, uint32_t b) { return a < b ? a : b; }
+static uint32_t max_u32(uint32_t a, uint32_t b) { return a > b ? a : b; }
+
+/* Vertex cache oracle: lines fetched so far (no evictions: the arrays fit). */
+static uint8_t g_seen[256];
+
+static uint32_t oracle_fetch(uint32_t base, uint32_t idx, uint32_t stride, uint32_t len) {
+    const uint32_t first = (base + idx * stride) >> 5, last = (base + idx * stride + len - 1u) >> 5;
+    uint32_t line, miss = 0;
+    for (line = first; line <= last; line++) {
+        const uint32_t k = line - (ARRAY_ADDR >> 5);
+        if (!g_seen[k]) miss = 1;
+        g_seen[k] = 1;
+    }
+    return miss;
+}
+
+static void sdk_setup(void) {
+    float pm[3][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 } };
+    float proj[4][4] = { { 2.0f / 640.0f, 0, 0, -1 }, { 0, -2.0f / 480.0f, 0, 1 },
+                         { 0, 0, -1, -1 }, { 0, 0, 0, 1 } };
+
+    GXInit(0, 0);
+    GXLoadPosMtxImm(pm, 0);
+    GXSetCurrentMtx(0);
+    GXSetProjection(proj, 1);
+    GXSetViewport(0.0f, 0.0f, 640.0f, 480.0f, 0.0f, 1.0f);
+    GXSetNumChans(1);
+    GXSetChanCtrl(4 /* GX_COLOR0A0 */, 0, 0, 1 /* mat vtx */, 0, 0, 2);
+    GXSetNumTexGens(0);
+    GXSetNumTevStages(1);
+    GXSetTevOrder(0, 0xFF, 0xFF, 4 /* GX_COLOR0A0 */);
+    GXSetTevOp(0, 4 /* GX_PASSCLR */);
+    GXSetZMode(1, 3 /* GX_LEQUAL */, 1);
+    GXSetBlendMode(0, 4, 5, 0);
+    GXSetColorUpdate(1);
+    GXSetAlphaCompare(7, 0, 0, 7, 0);
+    GXSetPixelFmt(0 /* GX_PF_RGB8_Z24 */, 0);
+    GXSetCullMode(0);
+
+    GXClearVtxDesc();
+    GXSetVtxDesc(9, 1);
+    GXSetVtxDesc(11, 1);
+    GXSetVtxAttrFmt(0, 9, 1, 4, 0);
+    GXSetVtxAttrFmt(0, 11, 1, 5, 0);
+}
+
+static void sdk_quad(const uint32_t r[4], float z) {
+    const float xs[4] = { (float)r[0], (float)r[2], (float)r[2], (float)r[0] };
+    const float ys[4] = { (float)r[1], (float)r[1], (float)r[3], (float)r[3] };
+    uint32_t i;
+    GXBegin(0x80, 0, 4);
+    for (i = 0; i < 4u; i++) {
+        GXPosition3f32(xs[i], ys[i], z);
+        GXColor4u8(0x40, 0x80, 0xC0, 0xFF);
+    }
+    GXEnd();
+}
+
+static void rnd_rect(uint32_t r[4]) {
+    r[0] = xorshift32() % 500u;
+    r[1] = xorshift32() % 400u;
+    r[2] = r[0] + 1u + xorshift32() % 140u;
+    r[3] = r[1] + 1u + xorshift32() % 80u;
+}
+
+static uint32_t rect_area(const uint32_t r[4]) {
+    return (r[2] - r[0]) * (r[3] - r[1]);
+}
+
+static uint32_t overlap(const uint32_t a[4], const uint32_t b[4]) {
+    const uint32_t x0 = max_u32(a[0], b[0]), y0 = max_u32(a[1], b[1]);
+    const uint32_t x1 = min_u32(a[2], b[2]), y1 = min_u32(a[3], b[3]);
+    return x1 > x0 && y1 > y0 ? (x1 - x0) * (y1 - y0) : 0u;
+}
+
+static int efb_ready(void) {
+    if (!gc_gx_efb.color && !gc_gx_raster_efb_init(&gc_gx_efb)) return 0;
+    gc_gx_raster_clear(&gc_gx_efb, 0, 0xFFFFFFu);
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L0: vertex cache
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L0_vcache(void) {
+    static const uint32_t k_sels[] = { GX_VC_POS, GX_VC_NRM, GX_VC_CLR0, GX_VC_ALL, 7u };
+    const uint32_t n = 1u + xorshift32() % MAX_VTX;
+    const uint32_t pstride = 6u + xorshift32() % 27u;
+    const uint32_t cstride = 4u + xorshift32() % 29u;
+    const uint32_t use_clr = xorshift32() & 1u;
+    const uint32_t sel = k_sels[xorshift32() % 5u];
+    const uint32_t pbase = ARRAY_ADDR;
+    const uint32_t cbase = pbase + ((n * pstride + 31u) & ~31u);
+    uint16_t pidx[MAX_VTX];
+    uint8_t cidx[MAX_VTX];
+    uint32_t pmiss = 0, cmiss = 0, want_check, want_miss, check, miss, stall, pass, i;
+
+    for (i = 0; i < n; i++) {
+        pidx[i] = (uint16_t)(xorshift32() % n);
+        cidx[i] = (uint8_t)(xorshift32() % n);
+    }
+    memset(g_seen, 0, sizeof(g_seen));
+    for (i = 0; i < n; i++) {
+        pmiss += oracle_fetch(pbase, pidx[i], pstride, 6u);
+        if (use_clr) cmiss += oracle_fetch(cbase, cidx[i], cstride, 4u);
+    }
+    want_check = sel == GX_VC_POS ? n : sel == GX_VC_CLR0 ? n * use_clr
+               : sel == GX_VC_ALL ? n + n * use_clr : 0u;
+
+    GXInit(0, 0);
+    GXClearVtxDesc();
+    GXSetVtxDesc(9, 3 /* GX_INDEX16 */);
+    GXSetVtxAttrFmt(0, 9, 1, 3 /* GX_S16 */, 0);
+    GXSetArray(9, (void *)(uintptr_t)pbase, (uint8_t)pstride);
+    if (use_clr) {
+        GXSetVtxDesc(11, 2 /* GX_INDEX8 */);
+        GXSetVtxAttrFmt(0, 11, 1, 5 /* GX_RGBA8 */, 0);
+        GXSetArray(11, (void *)(uintptr_t)cbase, (uint8_t)cstride);
+    }
+    GXInvalidateVtxCache();
+    GXSetVCacheMetric(sel);
+    GXSetGPMetric(GX_PERF0_NONE, GX_PERF1_VC_MISS_REQ);
+
+    for (pass = 0; pass < 3u; pass++) {
+        /* Cold, warm (every line resident), cold again after the invalidate. */
+        if (pass == 2u) GXInvalidateVtxCache();
+        GXClearVCacheMetric();
+        GXClearGPMetric();
+        GXBegin(0xB8 /* GX_POINTS */, 0, (uint16_t)n);
+        for (i = 0; i < n; i++) {
+            GXPosition1x16(pidx[i]);
+            if (use_clr) GXColor1x8(cidx[i]);
+        }
+        GXEnd();
+        GXReadVCacheMetric(&check, &miss, &stall);
+        want_miss = pass == 1u ? 0u
+                  : sel == GX_VC_POS ? pmiss : sel == GX_VC_CLR0 ? cmiss
+                  : sel == GX_VC_ALL ? pmiss + cmiss : 0u;
+        CHECK(check == want_check, "L0 pass %u sel %u n %u: check %u != %u", pass, sel, n, check,
+              want_check);
+        CHECK(miss == want_miss, "L0 pass %u sel %u n %u strides %u/%u: miss %u != %u", pass, sel, n,
+              pstride, cstride, miss, want_miss);
+        CHECK(stall == 0u, "L0 stall %u", stall);
+        {
+            uint32_t m0 = 1, m1 = 0;
+            GXReadGPMetric(&m0, &m1);
+            CHECK(m0 == 0u, "L0 GX_PERF0_NONE counted %u", m0);
+            CHECK(m1 == (pass == 1u ? 0u : pmiss + cmiss), "L0 pass %u VC_MISS_REQ %u != %u", pass,
+                  m1, pmiss + cmiss);
+        }
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L1: pixel pipe
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L1_pixels(void) {
+    static const uint32_t k_perf0[] = {
+        GX_PERF0_VERTICES, GX_PERF0_TRIANGLES, GX_PERF0_TRIANGLES_CULLED,
+        GX_PERF0_TRIANGLES_PASSED, GX_PERF0_TRIANGLES_SCISSORED, GX_PERF0_CLOCKS,
+    };
+    static const uint32_t k_perf1[] = {
+        GX_PERF1_TEXELS, GX_PERF1_TC_MISS, GX_PERF1_VERTICES, GX_PERF1_VC_MISS_REQ, GX_PERF1_CLOCKS,
+    };
+    const uint32_t early = xorshift32() & 1u;
+    const uint32_t near_first = xorshift32() & 1u;
+    const uint32_t p0 = k_perf0[xorshift32() % 6u], p1 = k_perf1[xorshift32() % 5u];
+    uint32_t ra[4], rb[4], want_in, want_out, m[6], g0, g1, w0, w1;
+
+    rnd_rect(ra);
+    rnd_rect(rb);
+    want_in = rect_area(ra) + rect_area(rb);
+    /* A is nearer: B fails where it lands on A, A never fails. */
+    want_out = want_in - (near_first ? overlap(ra, rb) : 0u);
+
+    sdk_setup();
+    GXSetZCompLoc((uint8_t)early);
+    CHECK(efb_ready(), "L1 efb alloc failed");
+    GXSetGPMetric(p0, p1);
+    GXClearGPMetric();
+    GXClearPixMetric();
+    if (near_first) {
+        sdk_quad(ra, -0.25f);
+        sdk_quad(rb, -0.75f);
+    } else {
+        sdk_quad(rb, -0.75f);
+        sdk_quad(ra, -0.25f);
+    }
+    GXSetDrawDone();
+    GXReadPixMetric(&m[0], &m[1], &m[2], &m[3], &m[4], &m[5]);
+    CHECK(m[0] == (early ? want_in : 0u) && m[1] == (early ? want_out : 0u),
+          "L1 early %u: top %u/%u != %u/%u", early, m[0], m[1], want_in, want_out);
+    CHECK(m[2] == (early ? 0u : want_in) && m[3] == (early ? 0u : want_out),
+          "L1 early %u: bottom %u/%u != %u/%u", early, m[2], m[3], want_in, want_out);
+    CHECK(m[4] == want_out, "L1 clr_in %u != %u", m[4], want_out);
+    CHECK(m[5] == 0u, "L1 copy clocks %u without a copy", m[5]);
+
+    GXReadGPMetric(&g0, &g1);
+    w0 = p0 == GX_PERF0_VERTICES ? 8u : p0 == GX_PERF0_TRIANGLES ? 4u
+       : p0 == GX_PERF0_TRIANGLES_PASSED ? 4u : 0u;
+    w1 = p1 == GX_PERF1_VERTICES ? 8u : 0u;
+    CHECK(g0 == w0, "L1 perf0 %u: %u != %u", p0, g0, w0);
+    CHECK(g1 == w1, "L1 perf1 %u: %u != %u", p1, g1, w1);
+
+    /* Back faces: culled, never reach the pixel pipe. */
+    GXSetGPMetric(GX_PERF0_TRIANGLES_CULLED, GX_PERF1_VERTICES);
+    GXClearGPMetric();
+    GXClearPixMetric();
+    GXSetCullMode(1 /* GX_CULL_FRONT */);
+    sdk_quad(ra, -0.1f);
+    GXReadGPMetric(&g0, &g1);
+    GXReadPixMetric(&m[0], &m[1], &m[2], &m[3], &m[4], NULL);
+    CHECK(g0 == 2u && g1 == 4u, "L1 culled quad: culled %u vertices %u", g0, g1);
+    CHECK(!m[0] && !m[1] && !m[2] && !m[3] && !m[4], "L1 culled quad reached the pixel pipe");
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L2: counter semantics and copies
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L2_semantics(void) {
+    const uint32_t tw = 1u + xorshift32() % 256u, th = 1u + xorshift32() % 256u;
+    const uint32_t dw = 16u * (1u + xorshift32() % 40u), dh = 1u + xorshift32() % 480u;
+    const uint32_t tbytes = ((tw + 3u) / 4u) * ((th + 3u) / 4u) * 64u;   /* RGBA8 */
+    const uint32_t reads = 1u + xorshift32() % 3u;
+    uint32_t ra[4], rb[4], m[6], mem[10], g0, g1, i, copies;
+
+    rnd_rect(ra);
+    rnd_rect(rb);
+    sdk_setup();
+    CHECK(efb_ready(), "L2 efb alloc failed");
+
+    /* A selection change keeps the count and counts the new event from then on. */
+    GXSetGPMetric(GX_PERF0_VERTICES, GX_PERF1_NONE);
+    GXClearGPMetric();
+    GXClearPixMetric();
+    sdk_quad(ra, -0.5f);
+    for (i = 0; i < reads; i++) GXReadGPMetric(&g0, &g1);
+    CHECK(g0 == 4u && g1 == 0u, "L2 vertices %u/%u", g0, g1);
+    GXSetGPMetric(GX_PERF0_TRIANGLES, GX_PERF1_VERTICES);
+    sdk_quad(rb, -0.5f);
+    GXReadGPMetric(&g0, &g1);
+    CHECK(g0 == 6u && g1 == 4u, "L2 after switch %u/%u != 6/4", g0, g1);
+
+    /* Pixel counters accumulate across reads until cleared (equal z passes LEQUAL). */
+    GXReadPixMetric(&m[0], &m[1], &m[2], &m[3], &m[4], &m[5]);
+    CHECK(m[4] == rect_area(ra) + rect_area(rb), "L2 clr_in %u (areas %u %u)", m[4], rect_area(ra),
+          rect_area(rb));
+    GXClearGPMetric();
+    GXClearPixMetric();
+    GXReadGPMetric(&g0, &g1);
+    GXReadPixMetric(&m[0], &m[1], &m[2], &m[3], &m[4], &m[5]);
+    CHECK(!g0 && !g1 && !m[0] && !m[1] && !m[2] && !m[3] && !m[4] && !m[5], "L2 clear left counts");
+
+    /* Copies: one clock per source pixel, 32-byte PE writes. */
+    GXClearMemMetric();
+    copies = gc_gx_texcopy_copies + gc_gx_xfb_copies;
+    GXSetTexCopySrc(0, 0, (uint16_t)tw, (uint16_t)th);
+    GXSetTexCopyDst((uint16_t)tw, (uint16_t)th, 6 /* GX_TF_RGBA8 */, 0);
+    GXCopyTex((void *)(uintptr_t)COPY_ADDR, 0);
+    GXSetDispCopySrc(0, 0, (uint16_t)dw, (uint16_t)dh);
+    GXSetDispCopyDst((uint16_t)dw, (uint16_t)dh);
+    GXSetDispCopyYScale(1.0f);
+    GXCopyDisp((void *)(uintptr_t)XFB_ADDR, 0);
+    GXReadPixMetric(NULL, NULL, NULL, NULL, NULL, &m[5]);
+    CHECK(gc_gx_texcopy_copies + gc_gx_xfb_copies == copies + 2u, "L2 copies not executed");
+    CHECK(m[5] == tw * th + dw * dh, "L2 copy clocks %u != %u", m[5], tw * th + dw * dh);
+    GXReadMemMetric(&mem[0], &mem[1], &mem[2], &mem[3], &mem[4], &mem[5], &mem[6], &mem[7], &mem[8],
+                    &mem[9]);
+    CHECK(mem[7] == (tbytes + dw * 2u * dh) >> 5, "L2 pe_req %u != %u", mem[7],
+          (tbytes + dw * 2u * dh) >> 5);
+    CHECK(!mem[0] && !mem[1], "L2 cp/tc requests %u/%u without vertex or texture fetches", mem[0],
+          mem[1]);
+    for (i = 2; i < 10u; i++) {
+        if (i != 7u) CHECK(mem[i] == 0u, "L2 unmodeled mem metric %u = %u", i, mem[i]);
+    }
+    GXClearMemMetric();
+    GXReadMemMetric(NULL, NULL, NULL, NULL, NULL, NULL, NULL, &mem[7], NULL, NULL);
+    CHECK(mem[7] == 0u, "L2 pe_req %u after clear", mem[7]);
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Per-seed runner
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int run_seed(uint32_t seed) {
+    int i;
+    g_rng = seed;
+    ram_init();
+    if (!g_opt_op || strstr("L0", g_opt_op) || strstr("VCACHE", g_opt_op)) {
+        for (i = 0; i < 4; i++) {
+            if (!test_L0_vcache()) return 0;
+        }
+    }
+    if (!g_opt_op || strstr("L1", g_opt_op) || strstr("PIXEL", g_opt_op)) {
+        for (i = 0; i < 2; i++) {
+            if (!test_L1_pixels()) return 0;
+        }
+    }
+    if (!g_opt_op || strstr("L2", g_opt_op) || strstr("COPY", g_opt_op) || strstr("FULL", g_opt_op)) {
+        if (!test_L2_semantics()) return 0;
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * main
+ * ═══════════════════════════════════════════════════════════════════ */
+
+int main(int argc, char **argv) {
+    uint32_t start_seed = 1;
+    int num_runs = 100;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+            start_seed = (uint32_t)strtoul(argv[i] + 7, NULL, 0);
+        else if (strncmp(argv[i], "--num-runs=", 11) == 0)
+            num_runs = atoi(argv[i] + 11);
+        else if (strncmp(argv[i], "--op=", 5) == 0)
+            g_opt_op = argv[i] + 5;
+        else if (strcmp(argv[i], "-v") == 0)
+            g_verbose = 1;
+        else {
+            fprintf(stderr,
+                    "Usage: gxperf_property_test [--seed=N] [--num-runs=N] "
+                    "[--op=L0|L1|L2|VCACHE|PIXEL|COPY|FULL] [-v]\n");
+            return 2;
+        }
+    }
+
+    printf("\n=== GX Perf Metrics Property Test ===\n");
+
+    for (i = 0; i < num_runs; i++) {
+        uint32_t seed = start_seed + (uint32_t)i;
+        uint64_t before = g_total_checks;
+
+        if (!run_seed(seed)) {
+            printf("  FAILED at seed %u\n", seed);
+            printf("\n--- Summary ---\n");
+            printf("Seeds:  %d (failed at %d)\n", i + 1, i + 1);
+            printf("Checks: %llu  (pass=%llu  fail=1)\n",
+                   (unsigned long long)g_total_checks,
+                   (unsigned long long)g_total_pass);
+            printf("\nRESULT: FAIL\n");
+            return 1;
+        }
+
+        if (g_verbose) {
+            printf("  seed %u: %llu checks OK\n", seed,
+                   (unsigned long long)(g_total_checks - before));
+        }
+        if ((i + 1) % 100 == 0) {
+            printf("  progress: seed %d/%d\n", i + 1, num_runs);
+        }
+    }
+
+    printf("\n--- Summary ---\n");
+    printf("Seeds:  %d\n", num_runs);
+    printf("Checks: %llu  (pass=%llu  fail=0)\n",
+           (unsigned long long)g_total_checks,
+           (unsigned long long)g_total_pass);
+    printf("\nRESULT: %llu/%llu PASS\n",
+           (unsigned long long)g_total_pass,
+           (unsigned long long)g_total_checks);
+
+    return 0;
+}
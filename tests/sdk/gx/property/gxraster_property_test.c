@@ -0,0 +1,938 @@
+/*
+ * gxraster_property_test.c — Property test for the software rasterizer
+ *
+ * Oracle: gc_gx_raster_draw_ref (immediate shading, per-pixel TEV interpreter)
+ * Port:   gc_gx_raster_draw + gc_gx_raster_flush (tile bins, compiled TEV)
+ *
+ * Levels:
+ *   L0 — Random BP/TEV/PE state + random XF output: binned draws == ref,
+ *        bit-exact color and depth, same pixel/triangle counts
+ *   L1 — SDK path: flat quads drawn through GX calls (vertex color, TEV
+ *        register, konst color) cover exactly their rectangle, honor the
+ *        scissor, culling and the z test
+ *   L2 — Many triangles: threaded flush == serial flush; a repeated TEV
+ *        configuration hits the compiled-stage cache
+ *   L3 — Pipeline states: a dead stage is dropped and a konst-only stage
+ *        folded with the same pixels as the interpreter; distinct states
+ *        are counted once per frame; more states than the cache evicts
+ *   L4 — Bounding box and CPU EFB access: GXReadBoundingBox is the quad-
+ *        aligned union of the quads that pass the alpha test; peeks shade
+ *        one tile and see pending draws; pokes follow a model of the poke
+ *        z mode, alpha threshold, blend / logic op, update masks, dst alpha
+ *        and pixel format; peeks follow the alpha read mode
+ *        (L0 and L2 also check binned, threaded and ref bounding boxes agree)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "gc_mem.h"
+#include "gx_gp.h"
+#include "gx_xf.h"
+#include "gx_raster.h"
+
+/* ── xorshift32 PRNG ────────────────────────────────────────────── */
+static uint32_t g_rng;
+static uint32_t xorshift32(void) {
+    uint32_t x = g_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rng = x;
+    return x;
+}
+
+static float rnd_f(float lo, float hi) {
+    return lo + (hi - lo) * (float)(xorshift32() & 0xFFFFFFu) / 16777216.0f;
+}
+
+static uint32_t f2u(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+/* ── Counters ───────────────────────────────────────────────────── */
+static uint64_t g_total_checks;
+static uint64_t g_total_pass;
+static int       g_verbose;
+static const char *g_opt_op;
+
+#define CHECK(cond, ...) do { \
+    g_total_checks++; \
+    if (!(cond)) { \
+        printf("FAIL @ %s:%d: ", __FILE__, __LINE__); \
+        printf(__VA_ARGS__); printf("\n"); \
+        return 0; \
+    } \
+    g_total_pass++; \
+} while(0)
+
+/* ── SDK surface (linked from GX.c) ─────────────────────────────── */
+typedef struct { uint8_t r, g, b, a; } GXColor;
+typedef struct { uint8_t _dummy; } GXFifoObj;
+GXFifoObj *GXInit(void *base, uint32_t size);
+void GXClearVtxDesc(void);
+void GXSetVtxDesc(uint32_t attr, uint32_t type);
+void GXSetVtxAttrFmt(uint32_t vtxfmt, uint32_t attr, uint32_t cnt, uint32_t type, uint8_t frac);
+void GXBegin(uint8_t type, uint8_t vtxfmt, uint16_t nverts);
+void GXEnd(void);
+void GXPosition3f32(float x, float y, float z);
+void GXColor4u8(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+void GXLoadPosMtxImm(float mtx[3][4], uint32_t id);
+void GXSetCurrentMtx(uint32_t id);
+void GXSetProjection(float mtx[4][4], uint32_t type);
+void GXSetViewport(float left, float top, float wd, float ht, float nearz, float farz);
+void GXSetScissor(uint32_t left, uint32_t top, uint32_t wd, uint32_t ht);
+void GXSetCullMode(uint32_t mode);
+void GXSetNumChans(uint8_t n);
+void GXSetNumTexGens(uint8_t n);
+void GXSetChanCtrl(uint32_t chan, uint8_t enable, uint32_t amb_src, uint32_t mat_src,
+                   uint32_t light_mask, uint32_t diff_fn, uint32_t attn_fn);
+void GXSetNumTevStages(uint8_t n);
+void GXSetTevOrder(uint32_t stage, uint32_t coord, uint32_t map, uint32_t color);
+void GXSetTevOp(uint32_t stage, uint32_t mode);
+void GXSetTevColorIn(uint32_t stage, uint32_t a, uint32_t b, uint32_t c, uint32_t d);
+void GXSetTevAlphaIn(uint32_t stage, uint32_t a, uint32_t b, uint32_t c, uint32_t d);
+void GXSetTevColorOp(uint32_t stage, uint32_t op, uint32_t bias, uint32_t scale, uint32_t clamp, uint32_t out);
+void GXSetTevAlphaOp(uint32_t stage, uint32_t op, uint32_t bias, uint32_t scale, uint32_t clamp, uint32_t out);
+void GXSetTevColor(uint32_t id, GXColor c);
+void GXSetTevKColor(uint32_t id, GXColor c);
+void GXSetTevKColorSel(uint32_t stage, uint32_t sel);
+void GXSetTevKAlphaSel(uint32_t stage, uint32_t sel);
+void GXSetTevSwapMode(uint32_t stage, uint32_t ras_sel, uint32_t tex_sel);
+void GXSetTevSwapModeTable(uint32_t table, uint32_t r, uint32_t g, uint32_t b, uint32_t a);
+void GXSetZMode(uint8_t enable, uint32_t func, uint8_t update);
+void GXSetBlendMode(uint32_t type, uint32_t src, uint32_t dst, uint32_t op);
+void GXSetColorUpdate(uint8_t enable);
+void GXSetAlphaUpdate(uint8_t enable);
+void GXSetAlphaCompare(uint32_t comp0, uint8_t ref0, uint32_t op, uint32_t comp1, uint8_t ref1);
+void GXSetPixelFmt(uint32_t pix_fmt, uint32_t z_fmt);
+void GXSetDrawDone(void);
+void GXClearBoundingBox(void);
+void GXReadBoundingBox(uint16_t *left, uint16_t *top, uint16_t *right, uint16_t *bottom);
+void GXPokeARGB(uint16_t x, uint16_t y, uint32_t color);
+void GXPeekARGB(uint16_t x, uint16_t y, uint32_t *color);
+void GXPokeZ(uint16_t x, uint16_t y, uint32_t z);
+void GXPeekZ(uint16_t x, uint16_t y, uint32_t *z);
+void GXPokeColorUpdate(uint8_t enable);
+void GXPokeAlphaUpdate(uint8_t enable);
+void GXPokeBlendMode(uint32_t type, uint32_t src, uint32_t dst, uint32_t op);
+void GXPokeAlphaMode(uint32_t func, uint8_t threshold);
+void GXPokeAlphaRead(uint32_t mode);
+void GXPokeDstAlpha(uint8_t enable, uint8_t alpha);
+void GXPokeZMode(uint8_t enable, uint32_t func, uint8_t update);
+
+/* ── Emulated RAM ───────────────────────────────────────────────── */
+#define RAM_BASE  0x80000000u
+#define RAM_SIZE  0x01800000u
+
+static uint8_t *g_ram;
+
+static void ram_init(void) {
+    if (!g_ram) g_ram = (uint8_t *)calloc(1, RAM_SIZE);
+    gc_mem_set(RAM_BASE, RAM_SIZE, g_ram);
+}
+
+/* ── Helpers ────────────────────────────────────────────────────── */
+#define VTX_CAP  4096u
+#define EFB_PIX  (GC_GX_EFB_WIDTH * GC_GX_EFB_HEIGHT)
+
+static GcGxXfBuf g_xf;
+static GcGxGpState g_gp;
+static GcGxEfb g_efb_a, g_efb_b;
+
+static const uint32_t k_prims[] = { 0x80u, 0x90u, 0x98u, 0xA0u, 0xA8u, 0xB0u };
+
+static int xf_alloc(void) {
+    uint32_t i;
+    if (g_xf.cap) return 1;
+    g_xf.cap = VTX_CAP;
+    for (i = 0; i < GC_GX_XF_PLANES; i++) {
+        g_xf.f[i] = (float *)calloc(VTX_CAP, sizeof(float));
+        if (!g_xf.f[i]) return 0;
+    }
+    return gc_gx_raster_efb_init(&g_efb_a) && gc_gx_raster_efb_init(&g_efb_b);
+}
+
+/* Fog A/C: sign(19) | exponent(11..18) | 11-bit mantissa. */
+static uint32_t rnd_fog_float(void) {
+    return (xorshift32() & 1u) << 19 | (120u + xorshift32() % 16u) << 11 | (xorshift32() & 0x7FFu);
+}
+
+static void random_state(GcGxGpState *gp) {
+    const uint32_t nst = 1u + xorshift32() % 4u;
+    uint32_t i;
+
+    memset(gp->bp, 0, sizeof(gp->bp));
+    gp->bp[0x00] = (nst - 1u) << 10 | ((xorshift32() & 3u) == 0 ? (xorshift32() & 3u) << 14 : 0u);
+    for (i = 0; i < 16u; i++) {
+        gp->bp[0xC0u + i * 2u] = xorshift32() & 0xFFFFFFu;
+        gp->bp[0xC1u + i * 2u] = xorshift32() & 0xFFFFFFu;
+    }
+    for (i = 0; i < 8u; i++) {
+        gp->bp[0x28u + i] = xorshift32() & 0xFFFFFFu;
+        gp->bp[0xF6u + i] = xorshift32() & 0xFFFFFFu;
+        gp->tev_reg[i] = xorshift32() & 0x7FF7FFu;
+        gp->tev_konst[i] = (xorshift32() & 0x0FF0FFu) | 0x800000u;
+    }
+    gp->bp[0x40] = xorshift32() & 0x1Fu;
+    gp->bp[0x41] = (xorshift32() & 0xFFF7u) | ((xorshift32() & 7u) ? 8u : 0u);
+    gp->bp[0x42] = xorshift32() & 0x1FFu;
+    gp->bp[0x43] = xorshift32() % 3u | (xorshift32() & 0x40u);
+    gp->bp[0xF3] = (xorshift32() & 1u) ? 0x3F0000u : xorshift32() & 0xFFFFFFu;
+    if (xorshift32() & 1u) {
+        static const uint32_t k_fog[] = { 2u, 3u, 4u, 5u, 6u, 7u };
+        gp->bp[0xEE] = rnd_fog_float();
+        gp->bp[0xEF] = xorshift32() & 0xFFFFFFu;
+        gp->bp[0xF0] = xorshift32() % 24u;
+        gp->bp[0xF1] = rnd_fog_float() | (xorshift32() & 1u) << 20 | k_fog[xorshift32() % 6u] << 21;
+        gp->bp[0xF2] = xorshift32() & 0xFFFFFFu;
+    }
+    if (xorshift32() & 1u) {
+        const uint32_t x0 = 342u + xorshift32() % 600u, y0 = 342u + xorshift32() % 500u;
+        gp->bp[0x20] = (x0 << 12 | y0) - (xorshift32() & 1u ? 0u : 40u << 12 | 40u);
+        gp->bp[0x21] = (x0 + xorshift32() % 200u) << 12 | (y0 + xorshift32() % 200u);
+    }
+    if (xorshift32() & 1u) {
+        gp->bp[0x59] = (151u + xorshift32() % 40u) | (151u + xorshift32() % 40u) << 10;
+    }
+    gp->xf_regs[0x1A] = f2u(rnd_f(200.0f, 400.0f));
+    gp->xf_regs[0x1B] = f2u(-rnd_f(150.0f, 300.0f));
+    gp->xf_regs[0x1C] = f2u(16777215.0f);
+    gp->xf_regs[0x1D] = f2u(rnd_f(600.0f, 700.0f));
+    gp->xf_regs[0x1E] = f2u(rnd_f(550.0f, 650.0f));
+    gp->xf_regs[0x1F] = f2u(16777215.0f);
+}
+
+/* Clip coordinates first; window coordinates follow through the viewport. */
+static void random_xf(const GcGxGpState *gp, uint32_t n, float spread) {
+    const int persp = (int)(xorshift32() & 1u);
+    const int deep = (xorshift32() & 3u) == 0;
+    const float cx = rnd_f(-1.0f, 1.0f), cy = rnd_f(-1.0f, 1.0f);
+    float vp[6];
+    uint32_t i, v;
+
+    for (i = 0; i < 6u; i++) memcpy(&vp[i], &gp->xf_regs[0x1A + i], sizeof(float));
+    g_xf.count = n;
+    g_xf.nchans = 2;
+    g_xf.ntexgens = 8;
+    g_xf.mask = (uint64_t)0xFu << GC_GX_XF_CLIP | (uint64_t)0x7u << GC_GX_XF_WIN;
+    if (xorshift32() & 3u) g_xf.mask |= (uint64_t)0xFu << GC_GX_XF_CLR0;
+    if (xorshift32() & 1u) g_xf.mask |= (uint64_t)0xFu << GC_GX_XF_CLR1;
+    for (i = 0; i < 8u; i++) {
+        if (xorshift32() & 1u) g_xf.mask |= (uint64_t)0x7u << (GC_GX_XF_TEX0 + i * 3u);
+    }
+    for (v = 0; v < n; v++) {
+        const float w = persp ? rnd_f(0.3f, 3.0f) : 1.0f;
+        const float x = cx + rnd_f(-spread, spread), y = cy + rnd_f(-spread, spread);
+        const float z = deep ? rnd_f(-1.3f, 0.0f) : rnd_f(-1.0f, 0.0f);
+        g_xf.f[GC_GX_XF_CLIP + 0][v] = x * w;
+        g_xf.f[GC_GX_XF_CLIP + 1][v] = y * w;
+        g_xf.f[GC_GX_XF_CLIP + 2][v] = z * w;
+        g_xf.f[GC_GX_XF_CLIP + 3][v] = w;
+        g_xf.f[GC_GX_XF_WIN + 0][v] = x * vp[0] + vp[3];
+        g_xf.f[GC_GX_XF_WIN + 1][v] = y * vp[1] + vp[4];
+        g_xf.f[GC_GX_XF_WIN + 2][v] = z * vp[2] + vp[5];
+        for (i = 0; i < 8u; i++) g_xf.f[GC_GX_XF_CLR0 + i][v] = rnd_f(0.0f, 1.0f);
+        for (i = 0; i < 24u; i++) g_xf.f[GC_GX_XF_TEX0 + i][v] = rnd_f(-4.0f, 4.0f);
+    }
+}
+
+static uint32_t random_count(uint32_t prim) {
+    const uint32_t n = (xorshift32() & 7u) == 0 ? 3u + xorshift32() % 400u : 3u + xorshift32() % 24u;
+    if (prim == 0x80u) return n & ~3u ? n & ~3u : 4u;
+    if (prim == 0x90u) return n - n % 3u;
+    return n;
+}
+
+static int efb_match(const char *tag) {
+    uint32_t i;
+    for (i = 0; i < EFB_PIX; i++) {
+        if (g_efb_a.color[i] != g_efb_b.color[i] || g_efb_a.depth[i] != g_efb_b.depth[i]) break;
+    }
+    CHECK(i == EFB_PIX, "%s pixel (%u,%u): color %08x/%08x depth %06x/%06x", tag,
+          i % GC_GX_EFB_WIDTH, i / GC_GX_EFB_WIDTH, g_efb_a.color[i], g_efb_b.color[i],
+          g_efb_a.depth[i], g_efb_b.depth[i]);
+    return 1;
+}
+
+static void bbox_clear(void) {
+    gc_gx_raster_bbox_write(0x55u, 0x3FFu);
+    gc_gx_raster_bbox_write(0x56u, 0x3FFu);
+}
+
+static int bbox_match(const char *tag, const GcGxRasterBBox *a, const GcGxRasterBBox *b) {
+    CHECK(a->left == b->left && a->top == b->top && a->right == b->right && a->bottom == b->bottom,
+          "%s bbox (%u,%u)-(%u,%u) != (%u,%u)-(%u,%u)", tag, a->left, a->top, a->right, a->bottom,
+          b->left, b->top, b->right, b->bottom);
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Levels
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L0_random(void) {
+    const uint32_t ndraws = 1u + xorshift32() % 6u;
+    const uint32_t clear = xorshift32(), zclear = xorshift32() & 0xFFFFFFu;
+    GcGxRasterStats s0, s1, s2;
+    GcGxRasterBBox bb;
+    uint32_t rng, i;
+
+    CHECK(xf_alloc(), "L0 alloc failed");
+    gc_gx_raster_clear(&g_efb_a, clear, zclear);
+    gc_gx_raster_clear(&g_efb_b, clear, zclear);
+
+    rng = g_rng;
+    bbox_clear();
+    s0 = gc_gx_raster_stats;
+    for (i = 0; i < ndraws; i++) {
+        const uint32_t prim = k_prims[xorshift32() % 6u];
+        const uint32_t n = random_count(prim);
+        const float spread = (xorshift32() & 1u) ? 0.2f : 1.2f;
+        random_state(&g_gp);
+        random_xf(&g_gp, n, spread);
+        CHECK(gc_gx_raster_draw(&g_efb_a, &g_xf, prim, &g_gp), "L0 draw failed");
+    }
+    gc_gx_raster_flush();
+    s1 = gc_gx_raster_stats;
+    bb = gc_gx_raster_bbox;
+
+    g_rng = rng;
+    bbox_clear();
+    for (i = 0; i < ndraws; i++) {
+        const uint32_t prim = k_prims[xorshift32() % 6u];
+        const uint32_t n = random_count(prim);
+        const float spread = (xorshift32() & 1u) ? 0.2f : 1.2f;
+        random_state(&g_gp);
+        random_xf(&g_gp, n, spread);
+        CHECK(gc_gx_raster_draw_ref(&g_efb_b, &g_xf, prim, &g_gp), "L0 ref failed");
+    }
+    s2 = gc_gx_raster_stats;
+
+    if (!efb_match("L0") || !bbox_match("L0", &bb, &gc_gx_raster_bbox)) return 0;
+    CHECK(s1.tris - s0.tris == s2.tris - s1.tris, "L0 tris %u != %u", s1.tris - s0.tris, s2.tris - s1.tris);
+    CHECK(s1.culled - s0.culled == s2.culled - s1.culled, "L0 culled");
+    CHECK(s1.clipped - s0.clipped == s2.clipped - s1.clipped, "L0 clipped");
+    CHECK(s1.skipped - s0.skipped == s2.skipped - s1.skipped, "L0 skipped");
+    CHECK(s1.pixels - s0.pixels == s2.pixels - s1.pixels, "L0 pixels %llu != %llu",
+          (unsigned long long)(s1.pixels - s0.pixels), (unsigned long long)(s2.pixels - s1.pixels));
+    CHECK(s1.written - s0.written == s2.written - s1.written, "L0 written");
+    return 1;
+}
+
+/* Pixel-exact ortho: window = object + 342, so EFB pixel = object coord. */
+static void sdk_setup(uint32_t mode, GXColor c) {
+    float pm[3][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 } };
+    float proj[4][4] = { { 2.0f / 640.0f, 0, 0, -1 }, { 0, -2.0f / 480.0f, 0, 1 },
+                         { 0, 0, -1, -1 }, { 0, 0, 0, 1 } };
+
+    GXInit(0, 0);
+    GXLoadPosMtxImm(pm, 0);
+    GXSetCurrentMtx(0);
+    GXSetProjection(proj, 1);
+    GXSetViewport(0.0f, 0.0f, 640.0f, 480.0f, 0.0f, 1.0f);
+    GXSetNumChans(1);
+    GXSetChanCtrl(4 /* GX_COLOR0A0 */, 0, 0, 1 /* mat vtx */, 0, 0, 2);
+    GXSetNumTexGens(0);
+    GXSetNumTevStages(1);
+    GXSetTevOrder(0, 0xFF, 0xFF, 4 /* GX_COLOR0A0 */);
+    GXSetTevSwapModeTable(0, 0, 1, 2, 3);
+    GXSetTevSwapMode(0, 0, 0);
+    if (mode == 0) {
+        GXSetTevOp(0, 4 /* GX_PASSCLR */);
+    } else {
+        /* d = C0/A0 (TEV register 0) or KONST (kcolor 0). */
+        GXSetTevColorIn(0, 15, 15, 15, mode == 1 ? 2u : 14u);
+        GXSetTevAlphaIn(0, 7, 7, 7, mode == 1 ? 1u : 6u);
+        GXSetTevColorOp(0, 0, 0, 0, 1, 0);
+        GXSetTevAlphaOp(0, 0, 0, 0, 1, 0);
+        if (mode == 1) {
+            GXSetTevColor(1 /* GX_TEVREG0 */, c);
+        } else {
+            GXSetTevKColor(0, c);
+            GXSetTevKColorSel(0, 0x0C /* K0 */);
+            GXSetTevKAlphaSel(0, 0x1C /* K0_A */);
+        }
+    }
+    GXSetZMode(1, 3 /* GX_LEQUAL */, 1);
+    GXSetBlendMode(0, 4, 5, 0);
+    GXSetColorUpdate(1);
+    GXSetAlphaUpdate(1);
+    GXSetAlphaCompare(7, 0, 0, 7, 0);
+    GXSetPixelFmt(0 /* GX_PF_RGB8_Z24 */, 0);
+    GXSetCullMode(0);
+
+    GXClearVtxDesc();
+    GXSetVtxDesc(9, 1);
+    GXSetVtxDesc(11, 1);
+    GXSetVtxAttrFmt(0, 9, 1, 4, 0);
+    GXSetVtxAttrFmt(0, 11, 1, 5, 0);
+}
+
+/* Clockwise on screen (y down) unless ccw. */
+static void sdk_quad(int32_t x0, int32_t y0, int32_t x1, int32_t y1, float z, GXColor c, int ccw) {
+    const float xs[4] = { (float)x0, (float)x1, (float)x1, (float)x0 };
+    const float ys[4] = { (float)y0, (float)y0, (float)y1, (float)y1 };
+    uint32_t i;
+    GXBegin(0x80, 0, 4);
+    for (i = 0; i < 4u; i++) {
+        const uint32_t k = ccw ? 3u - i : i;
+        GXPosition3f32(xs[k], ys[k], z);
+        GXColor4u8(c.r, c.g, c.b, c.a);
+    }
+    GXEnd();
+}
+
+/* RGB8_Z24 has no alpha plane: written pixels read back alpha 0xFF. */
+static uint32_t rgb8(GXColor c) {
+    return (uint32_t)c.r << 24 | (uint32_t)c.g << 16 | (uint32_t)c.b << 8 | 0xFFu;
+}
+
+static GXColor rnd_color(void) {
+    const uint32_t v = xorshift32();
+    const GXColor c = { (uint8_t)(v >> 24), (uint8_t)(v >> 16), (uint8_t)(v >> 8), (uint8_t)v };
+    return c;
+}
+
+static int in_rect(int32_t x, int32_t y, const int32_t r[4]) {
+    return x >= r[0] && x < r[2] && y >= r[1] && y < r[3];
+}
+
+static int test_L1_sdk(void) {
+    const uint32_t mode = xorshift32() % 3u;
+    const uint32_t clear = xorshift32() | 1u;
+    GXColor ca = rnd_color(), cb = rnd_color(), cc = rnd_color();
+    int32_t ra[4], rb[4], sc[4];
+    uint32_t written, culled, flushes, x, y, na = 0, nb = 0;
+    const int scissor = (int)(xorshift32() & 1u);
+    uint32_t bad = 0, want = 0;
+
+    ra[0] = (int32_t)(xorshift32() % 500u);
+    ra[1] = (int32_t)(xorshift32() % 400u);
+    ra[2] = ra[0] + 1 + (int32_t)(xorshift32() % 140u);
+    ra[3] = ra[1] + 1 + (int32_t)(xorshift32() % 80u);
+    rb[0] = ra[0] + (int32_t)(xorshift32() % 40u) - 20;
+    rb[1] = ra[1] + (int32_t)(xorshift32() % 40u) - 20;
+    rb[2] = rb[0] + 1 + (int32_t)(xorshift32() % 140u);
+    rb[3] = rb[1] + 1 + (int32_t)(xorshift32() % 80u);
+    if (rb[0] < 0) rb[0] = 0;
+    if (rb[1] < 0) rb[1] = 0;
+    sc[0] = (int32_t)(xorshift32() % 320u);
+    sc[1] = (int32_t)(xorshift32() % 240u);
+    sc[2] = sc[0] + 1 + (int32_t)(xorshift32() % 320u);
+    sc[3] = sc[1] + 1 + (int32_t)(xorshift32() % 240u);
+    if (!scissor) {
+        sc[0] = 0;
+        sc[1] = 0;
+        sc[2] = 640;
+        sc[3] = 480;
+    }
+    /* The TEV register/konst paths draw one color for every quad. */
+    if (mode != 0) cb = cc = ca;
+
+    sdk_setup(mode, ca);
+    if (!gc_gx_efb.color) CHECK(gc_gx_raster_efb_init(&gc_gx_efb), "L1 efb alloc failed");
+    gc_gx_raster_clear(&gc_gx_efb, clear, 0xFFFFFFu);
+    GXSetScissor((uint32_t)sc[0], (uint32_t)sc[1], (uint32_t)(sc[2] - sc[0]), (uint32_t)(sc[3] - sc[1]));
+
+    /* A near, B farther (hidden under A), C culled as a back face. */
+    written = (uint32_t)gc_gx_raster_stats.written;
+    sdk_quad(ra[0], ra[1], ra[2], ra[3], -0.25f, ca, 0);
+    sdk_quad(rb[0], rb[1], rb[2], rb[3], -0.75f, cb, 0);
+    GXSetCullMode(2 /* GX_CULL_BACK */);
+    culled = gc_gx_raster_stats.culled;
+    sdk_quad(0, 0, 640, 480, -0.1f, cc, 1);
+    CHECK(gc_gx_raster_stats.culled == culled + 2u, "L1 back face not culled");
+    GXSetDrawDone();
+    flushes = gc_gx_raster_stats.flushes;
+    gc_gx_raster_flush();
+    CHECK(gc_gx_raster_stats.flushes == flushes, "L1 triangles still binned after draw done");
+
+    for (y = 0; y < GC_GX_EFB_HEIGHT && !bad; y++) {
+        for (x = 0; x < GC_GX_EFB_WIDTH; x++) {
+            const int vis = in_rect((int32_t)x, (int32_t)y, sc);
+            want = clear;
+            if (vis && in_rect((int32_t)x, (int32_t)y, ra)) {
+                want = rgb8(ca);
+                na++;
+            } else if (vis && in_rect((int32_t)x, (int32_t)y, rb)) {
+                want = rgb8(cb);
+                nb++;
+            }
+            if (gc_gx_efb.color[y * GC_GX_EFB_WIDTH + x] != want) {
+                bad = 1;
+                break;
+            }
+        }
+    }
+    CHECK(!bad, "L1 mode %u pixel (%u,%u) %08x != %08x", mode, x, y - 1u,
+          gc_gx_efb.color[(y - 1u) * GC_GX_EFB_WIDTH + x], want);
+    CHECK(gc_gx_raster_stats.written - written == na + nb, "L1 written %u != %u",
+          (uint32_t)(gc_gx_raster_stats.written - written), na + nb);
+    return 1;
+}
+
+static int test_L2_parallel(void) {
+    const uint32_t saved = gc_gx_raster_threads;
+    const uint32_t clear = xorshift32(), zclear = xorshift32() & 0xFFFFFFu;
+    const uint32_t batches = 2u + xorshift32() % 3u;
+    const uint32_t nthreads = 2u + xorshift32() % (GC_GX_RASTER_MAX_THREADS - 1u);
+    uint32_t i, par, hits, misses;
+    GcGxRasterBBox bb;
+
+    CHECK(xf_alloc(), "L2 alloc failed");
+    random_state(&g_gp);
+    g_gp.bp[0x00] &= ~(3u << 14);
+    g_gp.bp[0x20] = 0;
+    g_gp.bp[0x21] = 0;
+
+    /* Serial reference into B. */
+    gc_gx_raster_threads = 1;
+    gc_gx_raster_clear(&g_efb_b, clear, zclear);
+    bbox_clear();
+    {
+        const uint32_t rng = g_rng;
+        for (i = 0; i < batches; i++) {
+            random_xf(&g_gp, 900u + xorshift32() % 900u, 0.05f);
+            g_xf.count -= g_xf.count % 3u;
+            CHECK(gc_gx_raster_draw(&g_efb_b, &g_xf, 0x90u, &g_gp), "L2 serial draw failed");
+        }
+        gc_gx_raster_flush();
+        g_rng = rng;
+    }
+    bb = gc_gx_raster_bbox;
+    bbox_clear();
+
+    gc_gx_raster_threads = nthreads;
+    gc_gx_raster_clear(&g_efb_a, clear, zclear);
+    par = gc_gx_raster_stats.parallel_flushes;
+    hits = gc_gx_raster_stats.tev_hits;
+    misses = gc_gx_raster_stats.tev_misses;
+    for (i = 0; i < batches; i++) {
+        random_xf(&g_gp, 900u + xorshift32() % 900u, 0.05f);
+        g_xf.count -= g_xf.count % 3u;
+        CHECK(gc_gx_raster_draw(&g_efb_a, &g_xf, 0x90u, &g_gp), "L2 parallel draw failed");
+    }
+    gc_gx_raster_flush();
+    gc_gx_raster_threads = saved;
+
+    /* Same configuration as the serial pass: every lookup is a hit. */
+    CHECK(gc_gx_raster_stats.tev_hits == hits + batches, "L2 tev hits %u (+%u expected)",
+          gc_gx_raster_stats.tev_hits - hits, batches);
+    CHECK(gc_gx_raster_stats.tev_misses == misses, "L2 tev miss on a cached configuration");
+#ifdef GC_GX_RASTER_THREADS
+    CHECK(gc_gx_raster_stats.parallel_flushes == par + 1u, "L2 flush not parallel");
+#else
+    CHECK(gc_gx_raster_stats.parallel_flushes == par, "L2 parallel flush without thread support");
+#endif
+    return efb_match("L2") && bbox_match("L2", &bb, &gc_gx_raster_bbox);
+}
+
+/* Stage 0: REG1 = KONST (folds). Stage 1: REG2 = RAS (never read, dropped).
+ * Stage 2: PREV = RAS * REG1.
+ * war: stage 0: PREV = RAS * REG0. Stage 1: REG0 = KONST (read by stage 0
+ * before, so it stays per pixel). Stage 2: PREV = lerp(REG0, PREV). */
+static void plan_state(GcGxGpState *gp, int war) {
+    gp->bp[0x00] = 2u << 10;
+    if (war) {
+        gp->bp[0xC0] = 0u << 22 | 0xFu << 12 | 0xAu << 8 | 0x2u << 4 | 0xFu;
+        gp->bp[0xC1] = 0u << 22 | 7u << 13 | 5u << 10 | 1u << 7 | 7u << 4;
+        gp->bp[0xC2] = 1u << 22 | 0xFFFEu;
+        gp->bp[0xC3] = 1u << 22 | 7u << 13 | 7u << 10 | 7u << 7 | 6u << 4;
+        gp->bp[0xC4] = 0u << 22 | 0x2u << 12 | 0x0u << 8 | 0xDu << 4 | 0xFu;
+        gp->bp[0xC5] = 0u << 22 | 1u << 13 | 0u << 10 | 6u << 7 | 7u << 4;
+    } else {
+        gp->bp[0xC0] = 2u << 22 | 0xFFFEu;
+        gp->bp[0xC1] = 2u << 22 | 7u << 13 | 7u << 10 | 7u << 7 | 6u << 4;
+        gp->bp[0xC2] = 3u << 22 | 0xFFFAu;
+        gp->bp[0xC3] = 3u << 22 | 7u << 13 | 7u << 10 | 7u << 7 | 5u << 4;
+        gp->bp[0xC4] = 0u << 22 | 0xFu << 12 | 0xAu << 8 | 0x4u << 4 | 0xFu;
+        gp->bp[0xC5] = 0u << 22 | 7u << 13 | 5u << 10 | 2u << 7 | 7u << 4;
+    }
+    gp->bp[0x28] = 0;
+    gp->bp[0x29] = 0;
+    gp->bp[0xF6] = (gp->bp[0xF6] & ~(0x3FFu << 4)) | 0x0Cu << 4 | 0x1Cu << 9;
+}
+
+static int draw_states(GcGxGpState *states, uint32_t n, uint32_t first) {
+    uint32_t i;
+    for (i = 0; i < n; i++) {
+        random_xf(&states[(first + i) % n], 3u, 0.2f);
+        CHECK(gc_gx_raster_draw(&g_efb_a, &g_xf, 0x90u, &states[(first + i) % n]),
+              "L3 draw failed");
+    }
+    return 1;
+}
+
+static int test_L3_states(void) {
+    static GcGxGpState states[GC_GX_RASTER_TEV_CACHE + 32u];
+    const uint32_t k = 2u + xorshift32() % 3u;
+    const uint32_t rounds = 2u + xorshift32() % 3u;
+    const uint32_t many = GC_GX_RASTER_TEV_CACHE + 1u + xorshift32() % 31u;
+    const uint32_t clear = xorshift32(), zclear = xorshift32() & 0xFFFFFFu;
+    const int war = (int)(xorshift32() & 1u);
+    GcGxRasterStats st;
+    uint32_t i;
+
+    CHECK(xf_alloc(), "L3 alloc failed");
+
+    /* Plan: same pixels as the interpreter, one stage folded and one
+     * dropped, or none when the constant stage overwrites a register an
+     * earlier per-pixel stage reads. */
+    gc_gx_raster_reset();
+    gc_gx_raster_clear(&g_efb_a, clear, zclear);
+    gc_gx_raster_clear(&g_efb_b, clear, zclear);
+    random_state(&g_gp);
+    plan_state(&g_gp, war);
+    {
+        const uint32_t rng = g_rng;
+        random_xf(&g_gp, 3u + xorshift32() % 60u, 1.2f);
+        g_xf.count -= g_xf.count % 3u;
+        CHECK(gc_gx_raster_draw(&g_efb_a, &g_xf, 0x90u, &g_gp), "L3 plan draw failed");
+        gc_gx_raster_flush();
+        g_rng = rng;
+        random_xf(&g_gp, 3u + xorshift32() % 60u, 1.2f);
+        g_xf.count -= g_xf.count % 3u;
+        CHECK(gc_gx_raster_draw_ref(&g_efb_b, &g_xf, 0x90u, &g_gp), "L3 plan ref failed");
+    }
+    if (!efb_match("L3 plan")) return 0;
+    CHECK(gc_gx_raster_stats.tev_folded == (war ? 0u : 1u) &&
+          gc_gx_raster_stats.tev_dropped == (war ? 0u : 1u), "L3 plan%s folded %u dropped %u",
+          war ? " (war)" : "", gc_gx_raster_stats.tev_folded, gc_gx_raster_stats.tev_dropped);
+
+    /* A few states, drawn over several rounds in one frame. */
+    gc_gx_raster_reset();
+    for (i = 0; i < k; i++) random_state(&states[i]);
+    for (i = 0; i < rounds; i++) {
+        if (!draw_states(states, k, i)) return 0;
+    }
+    CHECK(gc_gx_raster_stats.tev_states == k, "L3 %u states this frame (want %u)",
+          gc_gx_raster_stats.tev_states, k);
+    CHECK(gc_gx_raster_stats.tev_misses == k && gc_gx_raster_stats.tev_hits == k * (rounds - 1u),
+          "L3 hits %u misses %u", gc_gx_raster_stats.tev_hits, gc_gx_raster_stats.tev_misses);
+    gc_gx_raster_end_frame();
+    CHECK(gc_gx_raster_stats.tev_states == 0 && gc_gx_raster_stats.tev_states_last == k &&
+          gc_gx_raster_stats.tev_states_max == k, "L3 frame end: states %u last %u max %u",
+          gc_gx_raster_stats.tev_states, gc_gx_raster_stats.tev_states_last,
+          gc_gx_raster_stats.tev_states_max);
+    if (!draw_states(states, 1u, 0)) return 0;
+    gc_gx_raster_end_frame();
+    CHECK(gc_gx_raster_stats.tev_states_last == 1u && gc_gx_raster_stats.tev_states_max == k,
+          "L3 second frame: last %u max %u", gc_gx_raster_stats.tev_states_last,
+          gc_gx_raster_stats.tev_states_max);
+    CHECK(gc_gx_raster_stats.tev_misses == k, "L3 cached state missed in the next frame");
+
+    /* More states than the cache holds: every one misses, the sets evict. */
+    gc_gx_raster_reset();
+    for (i = 0; i < many; i++) random_state(&states[i]);
+    if (!draw_states(states, many, 0)) return 0;
+    gc_gx_raster_flush();
+    st = gc_gx_raster_stats;
+    CHECK(st.tev_misses == many && st.tev_states == many, "L3 %u states: misses %u states %u",
+          many, st.tev_misses, st.tev_states);
+    CHECK(st.tev_evictions >= many - GC_GX_RASTER_TEV_CACHE && st.tev_evictions < many,
+          "L3 %u states in %u entries: %u evictions", many, GC_GX_RASTER_TEV_CACHE,
+          st.tev_evictions);
+    return 1;
+}
+
+/* Poke model: the PE write of one CPU color poke (ARGB in, EFB RGBA out). */
+typedef struct {
+    uint32_t color_update, alpha_update, type, src, dst, op;
+    uint32_t afunc, thresh, dst_alpha_en, dst_alpha, fmt;
+} PokeModel;
+
+static int cmp_func(uint32_t func, uint32_t a, uint32_t b) {
+    switch (func & 7u) {
+    case 0: return 0;
+    case 1: return a < b;
+    case 2: return a == b;
+    case 3: return a <= b;
+    case 4: return a > b;
+    case 5: return a != b;
+    case 6: return a >= b;
+    default: return 1;
+    }
+}
+
+static int32_t model_factor(uint32_t f, const int32_t *s, const int32_t *d, int ch, int dst_side) {
+    switch (f) {
+    case 0: return 0;
+    case 1: return 255;
+    case 2: return dst_side ? s[ch] : d[ch];
+    case 3: return 255 - (dst_side ? s[ch] : d[ch]);
+    case 4: return s[3];
+    case 5: return 255 - s[3];
+    case 6: return d[3];
+    default: return 255 - d[3];
+    }
+}
+
+static int32_t model_logic(uint32_t op, int32_t s, int32_t d) {
+    switch (op) {   /* GX_LO_CLEAR .. GX_LO_SET */
+    case 0: return 0;
+    case 1: return s & d;
+    case 2: return s & ~d & 255;
+    case 3: return s;
+    case 4: return ~s & d & 255;
+    case 5: return d;
+    case 6: return s ^ d;
+    case 7: return s | d;
+    case 8: return ~(s | d) & 255;
+    case 9: return ~(s ^ d) & 255;
+    case 10: return ~d & 255;
+    case 11: return (s | ~d) & 255;
+    case 12: return ~s & 255;
+    case 13: return (~s | d) & 255;
+    case 14: return ~(s & d) & 255;
+    default: return 255;
+    }
+}
+
+static uint32_t model_poke(const PokeModel *m, uint32_t old, uint32_t argb) {
+    const int32_t s[4] = { (int32_t)((argb >> 16) & 0xFFu), (int32_t)((argb >> 8) & 0xFFu),
+                           (int32_t)(argb & 0xFFu), (int32_t)(argb >> 24) };
+    const int32_t d[4] = { (int32_t)(old >> 24), (int32_t)((old >> 16) & 0xFFu),
+                           (int32_t)((old >> 8) & 0xFFu), (int32_t)(old & 0xFFu) };
+    int32_t o[4];
+    int ch;
+
+    if (!cmp_func(m->afunc, (uint32_t)s[3], m->thresh)) return old;
+    for (ch = 0; ch < 4; ch++) {
+        if (m->type == 3u) {
+            o[ch] = d[ch] - s[ch] < 0 ? 0 : d[ch] - s[ch];
+        } else if (m->type == 1u) {
+            const int32_t fs = model_factor(m->src, s, d, ch, 0);
+            const int32_t fd = model_factor(m->dst, s, d, ch, 1);
+            o[ch] = (s[ch] * (fs + (fs >> 7)) + d[ch] * (fd + (fd >> 7))) >> 8;
+            if (o[ch] > 255) o[ch] = 255;
+        } else if (m->type == 2u) {
+            o[ch] = model_logic(m->op, s[ch], d[ch]);
+        } else {
+            o[ch] = s[ch];
+        }
+    }
+    if (m->dst_alpha_en) o[3] = (int32_t)m->dst_alpha;
+    if (m->fmt == 1u) {
+        for (ch = 0; ch < 4; ch++) o[ch] = (o[ch] & 0xFC) | (o[ch] >> 6);
+    }
+    if (!m->color_update) {
+        o[0] = d[0];
+        o[1] = d[1];
+        o[2] = d[2];
+    }
+    if (m->fmt != 1u) o[3] = 255;
+    else if (!m->alpha_update) o[3] = d[3];
+    return (uint32_t)o[0] << 24 | (uint32_t)o[1] << 16 | (uint32_t)o[2] << 8 | (uint32_t)o[3];
+}
+
+static void rnd_rect(int32_t r[4]) {
+    r[0] = (int32_t)(xorshift32() % 600u);
+    r[1] = (int32_t)(xorshift32() % 440u);
+    r[2] = r[0] + 1 + (int32_t)(xorshift32() % 40u);
+    r[3] = r[1] + 1 + (int32_t)(xorshift32() % 40u);
+}
+
+static void bbox_add(GcGxRasterBBox *bb, const int32_t r[4]) {
+    if ((uint32_t)r[0] < bb->left) bb->left = (uint32_t)r[0] & ~1u;
+    if ((uint32_t)r[1] < bb->top) bb->top = (uint32_t)r[1] & ~1u;
+    if ((uint32_t)(r[2] - 1) > bb->right) bb->right = (uint32_t)(r[2] - 1) | 1u;
+    if ((uint32_t)(r[3] - 1) > bb->bottom) bb->bottom = (uint32_t)(r[3] - 1) | 1u;
+}
+
+static int test_L4_efb(void) {
+    const uint32_t nquads = 1u + xorshift32() % 6u;
+    const uint32_t clear = xorshift32() | 0xFFu;
+    GcGxRasterBBox want = { 0x3FFu, 0x3FFu, 0u, 0u }, got;
+    GXColor c = rnd_color();
+    PokeModel m;
+    int32_t r[4];
+    uint32_t i, flushes, tiles, v, z;
+    uint16_t l, t, rt, b;
+
+    /* Quads with alpha > 0x80 pass the alpha test and widen the box. */
+    sdk_setup(0, c);
+    if (!gc_gx_efb.color) CHECK(gc_gx_raster_efb_init(&gc_gx_efb), "L4 efb alloc failed");
+    gc_gx_raster_clear(&gc_gx_efb, clear, 0xFFFFFFu);
+    GXSetScissor(0, 0, 640, 480);
+    GXSetAlphaCompare(4 /* GX_GREATER */, 0x80, 0 /* AND */, 7, 0);
+    GXClearBoundingBox();
+    for (i = 0; i < nquads; i++) {
+        c = rnd_color();
+        rnd_rect(r);
+        if (c.a > 0x80u) bbox_add(&want, r);
+        sdk_quad(r[0], r[1], r[2], r[3], -0.5f, c, 0);
+    }
+
+    /* A peek inside the last quad sees it without a full flush. */
+    flushes = gc_gx_raster_stats.flushes;
+    tiles = gc_gx_raster_stats.tile_flushes;
+    GXPokeAlphaRead(1 /* GX_READ_FF */);
+    GXPeekARGB((uint16_t)r[0], (uint16_t)r[1], &v);
+    CHECK(gc_gx_raster_stats.flushes == flushes && gc_gx_raster_stats.tile_flushes == tiles + 1u,
+          "L4 peek flushes %u tiles %u", gc_gx_raster_stats.flushes - flushes,
+          gc_gx_raster_stats.tile_flushes - tiles);
+    if (c.a > 0x80u) {
+        CHECK(v == (0xFF000000u | rgb8(c) >> 8), "L4 peek (%d,%d) %08x after quad %02x%02x%02x",
+              r[0], r[1], v, c.r, c.g, c.b);
+    }
+
+    GXReadBoundingBox(&l, &t, &rt, &b);
+    got.left = l;
+    got.top = t;
+    got.right = rt;
+    got.bottom = b;
+    if (!bbox_match("L4", &got, &want)) return 0;
+    GXClearBoundingBox();
+    GXReadBoundingBox(&l, &t, &rt, &b);
+    CHECK(l == 0x3FFu && t == 0x3FFu && rt == 0u && b == 0u, "L4 cleared bbox (%u,%u)-(%u,%u)",
+          l, t, rt, b);
+
+    /* Pokes under random poke modes and pixel formats. */
+    m.fmt = xorshift32() & 1u;
+    GXSetPixelFmt(m.fmt, 0);
+    for (i = 0; i < 64u; i++) {
+        const uint32_t x = xorshift32() % GC_GX_EFB_WIDTH, y = xorshift32() % GC_GX_EFB_HEIGHT;
+        const uint32_t argb = xorshift32(), zmode = xorshift32(), zv = xorshift32() & 0xFFFFFFu;
+        const uint32_t aread = xorshift32() % 3u;
+        const uint32_t old = gc_gx_efb.color[y * GC_GX_EFB_WIDTH + x];
+        const uint32_t zold = gc_gx_efb.depth[y * GC_GX_EFB_WIDTH + x];
+        uint32_t exp, zexp;
+
+        m.color_update = (xorshift32() & 3u) != 0u;
+        m.alpha_update = xorshift32() & 1u;
+        m.type = xorshift32() & 3u;
+        m.src = xorshift32() & 7u;
+        m.dst = xorshift32() & 7u;
+        m.op = xorshift32() & 15u;
+        m.afunc = (xorshift32() & 1u) ? 7u : xorshift32() & 7u;
+        m.thresh = xorshift32() & 0xFFu;
+        m.dst_alpha_en = (xorshift32() & 3u) == 0u;
+        m.dst_alpha = xorshift32() & 0xFFu;
+        GXPokeColorUpdate((uint8_t)m.color_update);
+        GXPokeAlphaUpdate((uint8_t)m.alpha_update);
+        GXPokeBlendMode(m.type, m.src, m.dst, m.op);
+        GXPokeAlphaMode(m.afunc, (uint8_t)m.thresh);
+        GXPokeDstAlpha((uint8_t)m.dst_alpha_en, (uint8_t)m.dst_alpha);
+        GXPokeZMode((uint8_t)(zmode & 1u), (zmode >> 1) & 7u, (uint8_t)((zmode >> 4) & 1u));
+        GXPokeAlphaRead(aread);
+
+        exp = model_poke(&m, old, argb);
+        GXPokeARGB((uint16_t)x, (uint16_t)y, argb);
+        GXPeekARGB((uint16_t)x, (uint16_t)y, &v);
+        CHECK(gc_gx_efb.color[y * GC_GX_EFB_WIDTH + x] == exp,
+              "L4 poke (%u,%u) %08x over %08x: %08x != %08x (fmt %u type %u src %u dst %u op %u)",
+              x, y, argb, old, gc_gx_efb.color[y * GC_GX_EFB_WIDTH + x], exp, m.fmt, m.type,
+              m.src, m.dst, m.op);
+        CHECK(v == ((aread == 0u ? 0u : aread == 1u ? 0xFFu : exp & 0xFFu) << 24 | exp >> 8),
+              "L4 peek (%u,%u) read mode %u: %08x (EFB %08x)", x, y, aread, v, exp);
+
+        zexp = (zmode & 1u) && cmp_func((zmode >> 1) & 7u, zv, zold) && ((zmode >> 4) & 1u)
+                   ? zv : zold;
+        GXPokeZ((uint16_t)x, (uint16_t)y, zv);
+        GXPeekZ((uint16_t)x, (uint16_t)y, &z);
+        CHECK(z == zexp, "L4 poke z (%u,%u) %06x over %06x mode %02x: %06x", x, y, zv, zold,
+              zmode & 0x1Fu, z);
+    }
+
+    /* Outside the EFB: peeks read 0, pokes are dropped. */
+    GXPeekARGB(10, GC_GX_EFB_HEIGHT + 4u, &v);
+    GXPeekZ(GC_GX_EFB_WIDTH + 4u, 10, &z);
+    CHECK(v == 0u && z == 0u, "L4 peek outside the EFB: %08x %06x", v, z);
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Per-seed runner
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int run_seed(uint32_t seed) {
+    g_rng = seed;
+    ram_init();
+    if (!g_opt_op || strstr("L0", g_opt_op) || strstr("RANDOM", g_opt_op)) {
+        if (!test_L0_random()) return 0;
+    }
+    if (!g_opt_op || strstr("L1", g_opt_op) || strstr("SDK", g_opt_op)) {
+        if (!test_L1_sdk()) return 0;
+    }
+    if (!g_opt_op || strstr("L2", g_opt_op) || strstr("PARALLEL", g_opt_op) || strstr("FULL", g_opt_op)) {
+        if (!test_L2_parallel()) return 0;
+    }
+    if (!g_opt_op || strstr("L3", g_opt_op) || strstr("STATES", g_opt_op) || strstr("FULL", g_opt_op)) {
+        if (!test_L3_states()) return 0;
+    }
+    if (!g_opt_op || strstr("L4", g_opt_op) || strstr("EFB", g_opt_op) || strstr("FULL", g_opt_op)) {
+        if (!test_L4_efb()) return 0;
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * main
+ * ═══════════════════════════════════════════════════════════════════ */
+
+int main(int argc, char **argv) {
+    uint32_t start_seed = 1;
+    int num_runs = 100;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+            start_seed = (uint32_t)strtoul(argv[i] + 7, NULL, 0);
+        else if (strncmp(argv[i], "--num-runs=", 11) == 0)
+            num_runs = atoi(argv[i] + 11);
+        else if (strncmp(argv[i], "--op=", 5) == 0)
+            g_opt_op = argv[i] + 5;
+        else if (strcmp(argv[i], "-v") == 0)
+            g_verbose = 1;
+        else {
+            fprintf(stderr,
+                    "Usage: gxraster_property_test [--seed=N] [--num-runs=N] "
+                    "[--op=L0|L1|L2|L3|L4|RANDOM|SDK|PARALLEL|STATES|EFB|FULL] [-v]\n");
+            return 2;
+        }
+    }
+
+    printf("\n=== GX Rasterizer Property Test ===\n");
+
+    for (i = 0; i < num_runs; i++) {
+        uint32_t seed = start_seed + (uint32_t)i;
+        uint64_t before = g_total_checks;
+
+        if (!run_seed(seed)) {
+            printf("  FAILED at seed %u\n", seed);
+            printf("\n--- Summary ---\n");
+            printf("Seeds:  %d (failed at %d)\n", i + 1, i + 1);
+            printf("Checks: %llu  (pass=%llu  fail=1)\n",
+                   (unsigned long long)g_total_checks,
+                   (unsigned long long)g_total_pass);
+            printf("\nRESULT: FAIL\n");
+            return 1;
+        }
+
+        if (g_verbose) {
+            printf("  seed %u: %llu checks OK (tris=%u pixels=%llu tev hits=%u misses=%u)\n",
+                   seed, (unsigned long long)(g_total_checks - before), gc_gx_raster_stats.tris,
+                   (unsigned long long)gc_gx_raster_stats.pixels, gc_gx_raster_stats.tev_hits,
+                   gc_gx_raster_stats.tev_misses);
+        }
+        if ((i + 1) % 100 == 0) {
+            printf("  progress: seed %d/%d\n", i + 1, num_runs);
+        }
+    }
+
+    printf("\n--- Summary ---\n");
+    printf("Seeds:  %d\n", num_runs);
+    printf("Checks: %llu  (pass=%llu  fail=0)\n",
+           (unsigned long long)g_total_checks,
+           (unsigned long long)g_total_pass);
+    printf("\nRESULT: %llu/%llu PASS\n",
+           (unsigned long long)g_total_pass,
+           (unsigned long long)g_total_checks);
+
+    return 0;
+}
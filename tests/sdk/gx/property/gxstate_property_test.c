@@ -0,0 +1,364 @@
+/*
+ * gxstate_property_test.c — Property test for GX dirty-state coalescing
+ *
+ * Oracle: write-through stream (gc_gx_state_coalesce = 0)
+ * Port:   staged BP/XF state flushed at draw time (GX.c dirty-state layer)
+ *
+ * At every draw the GP model (gx_gp.c) must hold the same registers in both
+ * modes; the coalesced stream may only be shorter.
+ *
+ * Levels:
+ *   L0 — Random setter/draw sequences: register files equal at every draw
+ *   L1 — Redundant writes are dropped and counted per register
+ *   L2 — Display lists start with nothing known (state is re-recorded)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "gc_mem.h"
+#include "gx_gp.h"
+#include "gx_state.h"
+
+/* ── xorshift32 PRNG ────────────────────────────────────────────── */
+static uint32_t g_rng;
+static uint32_t xorshift32(void) {
+    uint32_t x = g_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rng = x;
+    return x;
+}
+
+/* ── Counters ───────────────────────────────────────────────────── */
+static uint64_t g_total_checks;
+static uint64_t g_total_pass;
+static int       g_verbose;
+static const char *g_opt_op;
+
+#define CHECK(cond, ...) do { \
+    g_total_checks++; \
+    if (!(cond)) { \
+        printf("FAIL @ %s:%d: ", __FILE__, __LINE__); \
+        printf(__VA_ARGS__); printf("\n"); \
+        return 0; \
+    } \
+    g_total_pass++; \
+} while(0)
+
+/* ── SDK surface (linked from GX.c) ─────────────────────────────── */
+typedef struct { uint8_t _dummy; } GXFifoObj;
+typedef struct { uint8_t r, g, b, a; } GXColor;
+GXFifoObj *GXInit(void *base, uint32_t size);
+void GXBeginDisplayList(void *list, uint32_t size);
+uint32_t GXEndDisplayList(void);
+void GXCallDisplayList(const void *list, uint32_t nbytes);
+void GXClearVtxDesc(void);
+void GXSetVtxDesc(uint32_t attr, uint32_t type);
+void GXSetVtxAttrFmt(uint32_t vtxfmt, uint32_t attr, uint32_t cnt, uint32_t type, uint8_t frac);
+void GXBegin(uint8_t type, uint8_t vtxfmt, uint16_t nverts);
+void GXEnd(void);
+void GXPosition3f32(float x, float y, float z);
+void GXFlush(void);
+void GXSetTevColorIn(uint32_t stage, uint32_t a, uint32_t b, uint32_t c, uint32_t d);
+void GXSetTevOrder(uint32_t stage, uint32_t coord, uint32_t map, uint32_t color);
+void GXSetTevColor(uint32_t id, GXColor color);
+void GXSetChanCtrl(uint32_t chan, uint8_t enable, uint32_t amb_src, uint32_t mat_src,
+                   uint32_t light_mask, uint32_t diff_fn, uint32_t attn_fn);
+void GXSetBlendMode(uint32_t type, uint32_t src_factor, uint32_t dst_factor, uint32_t op);
+void GXSetZMode(uint8_t enable, uint32_t func, uint8_t update_enable);
+void GXSetAlphaCompare(uint32_t comp0, uint8_t ref0, uint32_t op, uint32_t comp1, uint8_t ref1);
+void GXSetNumTevStages(uint8_t nStages);
+void GXSetCullMode(uint32_t mode);
+void GXSetDither(uint8_t dither);
+
+extern uint32_t gc_gx_cmode0;
+
+/* ── Emulated RAM ───────────────────────────────────────────────── */
+#define RAM_BASE  0x80000000u
+#define RAM_SIZE  0x01800000u
+#define DL_ADDR   0x80100000u
+#define DL_SIZE   0x1000u
+
+static uint8_t *g_ram;
+
+static void ram_init(void) {
+    if (!g_ram) g_ram = (uint8_t *)calloc(1, RAM_SIZE);
+    gc_mem_set(RAM_BASE, RAM_SIZE, g_ram);
+}
+
+/* ── GP register snapshot (stream counters excluded) ────────────── */
+typedef struct {
+    uint32_t bp[256];
+    uint32_t cp[256];
+    uint32_t xf_regs[GC_GX_XF_REG_COUNT];
+    uint32_t draws;
+    uint32_t verts;
+} RegSnap;
+
+#define MAX_DRAWS 64
+static RegSnap g_snaps[MAX_DRAWS];
+
+static void snap(RegSnap *s) {
+    memcpy(s->bp, gc_gx_gp.bp, sizeof(s->bp));
+    memcpy(s->cp, gc_gx_gp.cp, sizeof(s->cp));
+    memcpy(s->xf_regs, gc_gx_gp.xf_regs, sizeof(s->xf_regs));
+    s->draws = gc_gx_gp.draws;
+    s->verts = gc_gx_gp.verts;
+}
+
+static void setup_vtx_fmt0(void) {
+    GXClearVtxDesc();
+    GXSetVtxDesc(9, 1);               /* POS direct */
+    GXSetVtxAttrFmt(0, 9, 1, 4, 0);   /* XYZ f32 */
+}
+
+static void draw(uint32_t nverts) {
+    uint32_t i;
+    GXBegin(0x90, 0, (uint16_t)nverts);
+    for (i = 0; i < nverts; i++) {
+        GXPosition3f32((float)i, 1.0f, 2.0f);
+    }
+    GXEnd();
+}
+
+/* One random setter call. Arguments come from small sets so that repeats
+ * (the case being optimized) are common. */
+static void random_setter(void) {
+    const uint32_t r = xorshift32();
+    const uint32_t a = (r >> 8) & 3u;
+    const uint32_t b = (r >> 12) & 1u;
+    switch ((r & 0xFFu) % 11u) {
+    case 0: GXSetTevColorIn(a, 0xF, b ? 8u : 10u, 0xF, 0xF); break;
+    case 1: GXSetTevOrder(a, b, b ? 0u : 0xFFu, 4u); break;
+    case 2: { GXColor c = { (uint8_t)(a * 40u), 0x20, 0x30, 0xFF }; GXSetTevColor(1u + (b ? 1u : 0u), c); break; }
+    case 3: GXSetChanCtrl(4u + (a & 1u), (uint8_t)b, 0, 1, b ? 1u : 0u, 2, b ? 2u : 1u); break;
+    case 4: GXSetBlendMode(b, 4, 5, 0); break;
+    case 5: GXSetZMode(1, a + 1u, (uint8_t)b); break;
+    case 6: GXSetAlphaCompare(7, (uint8_t)(a * 8u), 0, 7, 0); break;
+    case 7: GXSetNumTevStages((uint8_t)(a + 1u)); break;
+    case 8: GXSetCullMode(a); break;
+    case 9: GXSetDither((uint8_t)b); break;
+    default: GXFlush(); break;
+    }
+}
+
+/* Runs one op sequence from seed; returns the number of draws snapshotted. */
+static uint32_t run_sequence(uint32_t seed, uint32_t coalesce, uint32_t *bp_writes, uint32_t *xf_writes) {
+    uint32_t ndraws = 0, i;
+
+    gc_gx_state_coalesce = coalesce;
+    g_rng = seed;
+    GXInit(0, 0);
+    setup_vtx_fmt0();
+    GXSetZMode(1, 3, 1);  /* GXInit leaves the zmode mirror alone */
+    for (i = 0; i < 256u && ndraws < MAX_DRAWS; i++) {
+        if ((xorshift32() & 7u) == 0) {
+            draw(1u + (xorshift32() & 3u));
+            snap(&g_snaps[ndraws++]);
+        } else {
+            random_setter();
+        }
+    }
+    GXFlush();
+    *bp_writes = gc_gx_gp.bp_writes;
+    *xf_writes = gc_gx_gp.xf_writes;
+    gc_gx_state_coalesce = 1;
+    return ndraws;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Levels
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L0_parity(uint32_t seed) {
+    static RegSnap ref[MAX_DRAWS];
+    uint32_t n_ref, n, i, wt_bp, wt_xf, co_bp, co_xf, wt_state, bp_elim = 0, xf_elim = 0;
+
+    n_ref = run_sequence(seed, 0, &wt_bp, &wt_xf);
+    memcpy(ref, g_snaps, sizeof(ref));
+    wt_state = gc_gx_state_writes;
+    CHECK(gc_gx_state_elim == 0, "L0 write-through mode dropped %u writes", gc_gx_state_elim);
+
+    n = run_sequence(seed, 1, &co_bp, &co_xf);
+    CHECK(n == n_ref, "L0 draw count %u != %u", n, n_ref);
+    for (i = 0; i < n; i++) {
+        CHECK(memcmp(&g_snaps[i], &ref[i], sizeof(RegSnap)) == 0,
+              "L0 GP registers differ at draw %u", i);
+    }
+    CHECK(gc_gx_state_writes == wt_state, "L0 state write count %u != %u",
+          gc_gx_state_writes, wt_state);
+
+    /* Every state write either reached the stream or was counted as dropped. */
+    for (i = 0; i < 256u; i++) bp_elim += gc_gx_bp_elim[i];
+    for (i = 0; i < GC_GX_XF_REG_COUNT; i++) xf_elim += gc_gx_xf_elim[i];
+    CHECK(bp_elim + xf_elim == gc_gx_state_elim, "L0 per-register counts != total");
+    CHECK(co_bp + bp_elim == wt_bp, "L0 BP writes %u + dropped %u != write-through %u",
+          co_bp, bp_elim, wt_bp);
+    CHECK(co_xf + xf_elim == wt_xf, "L0 XF writes %u + dropped %u != write-through %u",
+          co_xf, xf_elim, wt_xf);
+    return 1;
+}
+
+static int test_L1_redundant(void) {
+    const uint32_t reps = 1u + (xorshift32() & 15u);
+    const uint32_t src = xorshift32() & 7u;
+    uint32_t writes, elim, i;
+
+    GXInit(0, 0);
+    setup_vtx_fmt0();
+    GXSetBlendMode(1, src, 5, 0);
+    draw(1);
+    CHECK(gc_gx_gp.bp[0x41] == (gc_gx_cmode0 & 0xFFFFFFu), "L1 cmode0 not flushed at draw");
+
+    /* Same value again: nothing reaches the stream. */
+    writes = gc_gx_gp.bp_writes;
+    elim = gc_gx_bp_elim[0x41];
+    for (i = 0; i < reps; i++) {
+        GXSetBlendMode(1, src, 5, 0);
+    }
+    GXFlush();
+    CHECK(gc_gx_gp.bp_writes == writes, "L1 redundant cmode0 reached the GP");
+    CHECK(gc_gx_bp_elim[0x41] == elim + reps, "L1 elim %u != %u", gc_gx_bp_elim[0x41], elim + reps);
+
+    /* Changed and changed back before the flush: both writes dropped. */
+    GXSetBlendMode(1, (src + 1u) & 7u, 5, 0);
+    GXSetBlendMode(1, src, 5, 0);
+    GXFlush();
+    CHECK(gc_gx_gp.bp_writes == writes, "L1 toggled cmode0 reached the GP");
+    CHECK(gc_gx_bp_elim[0x41] == elim + reps + 2u, "L1 toggle not counted");
+
+    /* Changed: exactly one write, holding the last value. */
+    GXSetBlendMode(1, (src + 2u) & 7u, 5, 0);
+    GXSetBlendMode(1, (src + 3u) & 7u, 5, 0);
+    GXFlush();
+    CHECK(gc_gx_gp.bp_writes == writes + 1u, "L1 coalesced write count %u", gc_gx_gp.bp_writes - writes);
+    CHECK(gc_gx_gp.bp[0x41] == (gc_gx_cmode0 & 0xFFFFFFu), "L1 last value lost");
+
+    /* XF: channel control for COLOR0 (XF 0x100E). */
+    GXSetChanCtrl(0, 1, 0, 1, 1, 2, 1);
+    GXFlush();
+    elim = gc_gx_xf_elim[14];
+    writes = gc_gx_gp.xf_writes;
+    GXSetChanCtrl(0, 1, 0, 1, 1, 2, 1);
+    GXFlush();
+    CHECK(gc_gx_gp.xf_writes == writes, "L1 redundant chan ctrl reached the GP");
+    CHECK(gc_gx_xf_elim[14] == elim + 1u, "L1 XF elim not counted");
+    return 1;
+}
+
+static int test_L2_display_list(void) {
+    const uint32_t src = xorshift32() & 7u;
+    uint32_t size, want;
+
+    GXInit(0, 0);
+    setup_vtx_fmt0();
+    GXSetBlendMode(1, src, 5, 0);
+    draw(1);
+    want = gc_gx_gp.bp[0x41];
+
+    /* Same value as the immediate stream carries, but the list must still
+     * record it: it may be called with any GP state. */
+    GXBeginDisplayList((void *)(uintptr_t)DL_ADDR, DL_SIZE);
+    GXSetBlendMode(1, src, 5, 0);
+    size = GXEndDisplayList();
+    CHECK(size != 0, "L2 list empty");
+
+    gc_gx_gp.bp[0x41] = 0;
+    GXCallDisplayList((void *)(uintptr_t)DL_ADDR, size);
+    CHECK(gc_gx_gp.bp[0x41] == want, "L2 list did not carry cmode0");
+
+    /* After the call nothing is assumed; the next draw resends. */
+    gc_gx_gp.bp[0x41] = 0;
+    GXSetBlendMode(1, src, 5, 0);
+    draw(1);
+    CHECK(gc_gx_gp.bp[0x41] == want, "L2 state assumed across a list call");
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Per-seed runner
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int run_seed(uint32_t seed) {
+    ram_init();
+    if (!g_opt_op || strstr("L0", g_opt_op) || strstr("PARITY", g_opt_op)) {
+        if (!test_L0_parity(seed)) return 0;
+    }
+    g_rng = seed;
+    if (!g_opt_op || strstr("L1", g_opt_op) || strstr("REDUNDANT", g_opt_op)) {
+        if (!test_L1_redundant()) return 0;
+    }
+    if (!g_opt_op || strstr("L2", g_opt_op) || strstr("DL", g_opt_op) || strstr("FULL", g_opt_op)) {
+        if (!test_L2_display_list()) return 0;
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * main
+ * ═══════════════════════════════════════════════════════════════════ */
+
+int main(int argc, char **argv) {
+    uint32_t start_seed = 1;
+    int num_runs = 100;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+            start_seed = (uint32_t)strtoul(argv[i] + 7, NULL, 0);
+        else if (strncmp(argv[i], "--num-runs=", 11) == 0)
+            num_runs = atoi(argv[i] + 11);
+        else if (strncmp(argv[i], "--op=", 5) == 0)
+            g_opt_op = argv[i] + 5;
+        else if (strcmp(argv[i], "-v") == 0)
+            g_verbose = 1;
+        else {
+            fprintf(stderr,
+                    "Usage: gxstate_property_test [--seed=N] [--num-runs=N] "
+                    "[--op=L0|L1|L2|PARITY|REDUNDANT|DL|FULL] [-v]\n");
+            return 2;
+        }
+    }
+
+    printf("\n=== GX Dirty State Property Test ===\n");
+
+    for (i = 0; i < num_runs; i++) {
+        uint32_t seed = start_seed + (uint32_t)i;
+        uint64_t before = g_total_checks;
+
+        if (!run_seed(seed)) {
+            printf("  FAILED at seed %u\n", seed);
+            printf("\n--- Summary ---\n");
+            printf("Seeds:  %d (failed at %d)\n", i + 1, i + 1);
+            printf("Checks: %llu  (pass=%llu  fail=1)\n",
+                   (unsigned long long)g_total_checks,
+                   (unsigned long long)g_total_pass);
+            printf("\nRESULT: FAIL\n");
+            return 1;
+        }
+
+        if (g_verbose) {
+            printf("  seed %u: %llu checks OK (state writes=%u dropped=%u)\n",
+                   seed, (unsigned long long)(g_total_checks - before),
+                   gc_gx_state_writes, gc_gx_state_elim);
+        }
+        if ((i + 1) % 100 == 0) {
+            printf("  progress: seed %d/%d\n", i + 1, num_runs);
+        }
+    }
+
+    printf("\n--- Summary ---\n");
+    printf("Seeds:  %d\n", num_runs);
+    printf("Checks: %llu  (pass=%llu  fail=0)\n",
+           (unsigned long long)g_total_checks,
+           (unsigned long long)g_total_pass);
+    printf("\nRESULT: %llu/%llu PASS\n",
+           (unsigned long long)g_total_pass,
+           (unsigned long long)g_total_checks);
+
+    return 0;
+}
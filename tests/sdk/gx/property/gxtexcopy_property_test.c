@@ -0,0 +1,438 @@
+/*
+ * gxtexcopy_property_test.c — Property test for the EFB to texture copy encoder
+ *
+ * Oracle: gc_gx_texcopy_encode_ref (one texel at a time to its tiled address)
+ * Port:   gc_gx_texcopy_encode (four texels per vector op, whole block rows)
+ *
+ * Levels:
+ *   L0 — Random EFB color/depth, random rectangles (EFB edges included),
+ *        every copy format with and without box filter, intensity and
+ *        depth: vector encode == reference, size == block math
+ *   L1 — Closed form: copies decoded back through gx_texdec give the
+ *        source pixels in the format's channels (RGBA8, R8, RA8, RG8, A8,
+ *        RGB565, I8, 2x2 box average, Z4, Z16L, Z24X8)
+ *   L2 — SDK: GXSetTexCopySrc / GXSetTexCopyDst / GXCopyTex with SDK
+ *        format values copy the pre-clear EFB into RAM, clear the rectangle
+ *        afterwards, restore the PE pixel format after Z copies and
+ *        invalidate decoded textures at the destination
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "gc_mem.h"
+#include "gx_gp.h"
+#include "gx_raster.h"
+#include "gx_texdec.h"
+#include "gx_texcopy.h"
+
+/* ── xorshift32 PRNG ────────────────────────────────────────────── */
+static uint32_t g_rng;
+static uint32_t xorshift32(void) {
+    uint32_t x = g_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rng = x;
+    return x;
+}
+
+/* ── Counters ───────────────────────────────────────────────────── */
+static uint64_t g_total_checks;
+static uint64_t g_total_pass;
+static int       g_verbose;
+static const char *g_opt_op;
+
+#define CHECK(cond, ...) do { \
+    g_total_checks++; \
+    if (!(cond)) { \
+        printf("FAIL @ %s:%d: ", __FILE__, __LINE__); \
+        printf(__VA_ARGS__); printf("\n"); \
+        return 0; \
+    } \
+    g_total_pass++; \
+} while(0)
+
+/* ── SDK surface (linked from GX.c) ─────────────────────────────── */
+typedef struct { uint8_t _dummy; } GXFifoObj;
+typedef struct { uint8_t r, g, b, a; } GXColor;
+GXFifoObj *GXInit(void *base, uint32_t size);
+void GXSetPixelFmt(uint32_t pix_fmt, uint32_t z_fmt);
+void GXSetCopyClear(GXColor clear_clr, uint32_t clear_z);
+void GXSetTexCopySrc(uint16_t left, uint16_t top, uint16_t wd, uint16_t ht);
+void GXSetTexCopyDst(uint16_t wd, uint16_t ht, uint32_t fmt, uint32_t mipmap);
+void GXCopyTex(void *dest, uint32_t clear);
+void GXSetDrawDone(void);
+
+/* ── Emulated RAM ───────────────────────────────────────────────── */
+#define RAM_BASE  0x80000000u
+#define RAM_SIZE  0x01800000u
+#define DST_ADDR  0x80200000u
+
+static uint8_t *g_ram;
+
+static void ram_init(void) {
+    if (!g_ram) g_ram = (uint8_t *)calloc(1, RAM_SIZE);
+    gc_mem_set(RAM_BASE, RAM_SIZE, g_ram);
+}
+
+static uint8_t *ram(uint32_t addr) {
+    return g_ram + (addr - RAM_BASE);
+}
+
+/* ── Helpers ────────────────────────────────────────────────────── */
+#define EFB_W GC_GX_EFB_WIDTH
+#define EFB_H GC_GX_EFB_HEIGHT
+#define MAX_BYTES (160u * 132u * 64u)
+
+static uint8_t g_enc_a[MAX_BYTES];
+static uint8_t g_enc_b[MAX_BYTES];
+static uint32_t g_texels[EFB_W * EFB_H];
+static uint32_t g_efb_before[EFB_W * EFB_H];
+static uint32_t g_depth_before[EFB_W * EFB_H];
+
+static int efb_fill(void) {
+    uint32_t i;
+    if (!gc_gx_efb.color && !gc_gx_raster_efb_init(&gc_gx_efb)) return 0;
+    for (i = 0; i < EFB_W * EFB_H; i++) {
+        gc_gx_efb.color[i] = xorshift32();
+        gc_gx_efb.depth[i] = xorshift32() & 0xFFFFFFu;
+    }
+    return 1;
+}
+
+static uint32_t rnd_dim(uint32_t max) {
+    static const uint32_t k_dims[] = { 1, 2, 3, 4, 5, 7, 8, 9, 16, 31, 64 };
+    const uint32_t d = (xorshift32() & 1u) ? k_dims[xorshift32() % 11u] : 1u + xorshift32() % 160u;
+    return d < max ? d : max;
+}
+
+/* Block width/height/bytes for a copy format, from the GX texture table. */
+static void blk_dims(uint32_t fmt, uint32_t *bw, uint32_t *bh, uint32_t *bytes) {
+    *bytes = fmt == GC_GX_CPF_RGBA8 ? 64u : 32u;
+    *bw = (fmt == GC_GX_CPF_RA8 || fmt == GC_GX_CPF_RGB565 || fmt == GC_GX_CPF_RGB5A3 ||
+           fmt == GC_GX_CPF_RGBA8 || fmt == GC_GX_CPF_RG8 || fmt == GC_GX_CPF_GB8) ? 4u : 8u;
+    *bh = fmt == GC_GX_CPF_R4 ? 8u : 4u;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L0: vector encode == reference
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L0_random(void) {
+    GcGxTexCopy c;
+    uint32_t bw, bh, bytes, w, h, size, i;
+
+    /* Rectangles start anywhere and may run past the EFB edges. */
+    c.x = (xorshift32() & 3u) ? xorshift32() % EFB_W : EFB_W - 1u - xorshift32() % 8u;
+    c.y = (xorshift32() & 3u) ? xorshift32() % EFB_H : EFB_H - 1u - xorshift32() % 8u;
+    c.w = rnd_dim(1024u);
+    c.h = rnd_dim(1024u);
+    c.fmt = xorshift32() % 13u;
+    c.half = xorshift32() & 1u;
+    c.depth = (xorshift32() & 3u) == 0u;
+    c.intensity = !c.depth && c.fmt <= GC_GX_CPF_RA8 && (xorshift32() & 1u);
+
+    blk_dims(c.fmt, &bw, &bh, &bytes);
+    gc_gx_texcopy_dims(&c, &w, &h);
+    size = gc_gx_texcopy_size(&c);
+    CHECK(size == ((w + bw - 1u) / bw) * ((h + bh - 1u) / bh) * bytes,
+          "L0 fmt %u %ux%u half %u size %u", c.fmt, c.w, c.h, c.half, size);
+    CHECK(size <= MAX_BYTES, "L0 size %u too large", size);
+
+    memset(g_enc_a, 0xA5, size);
+    memset(g_enc_b, 0x5A, size);
+    CHECK(gc_gx_texcopy_encode(g_enc_a, &gc_gx_efb, &c), "L0 encode failed");
+    CHECK(gc_gx_texcopy_encode_ref(g_enc_b, &gc_gx_efb, &c), "L0 ref failed");
+    for (i = 0; i < size && g_enc_a[i] == g_enc_b[i]; i++) {
+    }
+    CHECK(i == size, "L0 fmt %u rect (%u,%u %ux%u) half %u depth %u int %u byte %u %02x != %02x",
+          c.fmt, c.x, c.y, c.w, c.h, c.half, c.depth, c.intensity, i, g_enc_a[i], g_enc_b[i]);
+
+    c.fmt = 0xDu;
+    CHECK(!gc_gx_texcopy_size(&c) && !gc_gx_texcopy_encode(g_enc_a, &gc_gx_efb, &c),
+          "L0 bad format accepted");
+    c.fmt = GC_GX_CPF_R8;
+    c.x = EFB_W;
+    CHECK(!gc_gx_texcopy_encode(g_enc_a, &gc_gx_efb, &c), "L0 rectangle outside the EFB accepted");
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L1: closed form through the texture decoder
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static uint32_t x5(uint32_t v) { return (v << 3) | (v >> 2); }
+static uint32_t x6(uint32_t v) { return (v << 2) | (v >> 4); }
+
+typedef struct {
+    const char *name;
+    uint32_t fmt, depth, intensity, half;
+    uint32_t tex_fmt;                   /* GX_TF_* the copy is decoded as */
+} CopyCase;
+
+static const CopyCase k_cases[] = {
+    { "RGBA8",  GC_GX_CPF_RGBA8,  0, 0, 0, GC_GX_TF_RGBA8 },
+    { "R8",     GC_GX_CPF_R8,     0, 0, 0, GC_GX_TF_I8 },
+    { "RA8",    GC_GX_CPF_RA8,    0, 0, 0, GC_GX_TF_IA8 },
+    { "RG8",    GC_GX_CPF_RG8,    0, 0, 0, GC_GX_TF_IA8 },
+    { "A8",     GC_GX_CPF_A8,     0, 0, 0, GC_GX_TF_I8 },
+    { "RGB565", GC_GX_CPF_RGB565, 0, 0, 0, GC_GX_TF_RGB565 },
+    { "I8",     GC_GX_CPF_R8_1,   0, 1, 0, GC_GX_TF_I8 },
+    { "R8 box", GC_GX_CPF_R8,     0, 0, 1, GC_GX_TF_I8 },
+    { "Z4",     GC_GX_CPF_R4,     1, 0, 0, GC_GX_TF_I4 },
+    { "Z16L",   GC_GX_CPF_GB8,    1, 0, 0, GC_GX_TF_IA8 },
+    { "Z24X8",  GC_GX_CPF_RGBA8,  1, 0, 0, GC_GX_TF_RGBA8 },
+};
+#define NCASES (sizeof(k_cases) / sizeof(k_cases[0]))
+
+/* Decoded RGBA8 texel for source pixel p (a color, or a 24-bit depth). */
+static uint32_t expect(const CopyCase *k, uint32_t p) {
+    const uint32_t r = p >> 24, g = (p >> 16) & 0xFFu, b = (p >> 8) & 0xFFu, a = p & 0xFFu;
+    if (k->depth) {
+        switch (k->fmt) {
+        case GC_GX_CPF_R4: return ((p >> 20) & 15u) * 0x11111111u;
+        case GC_GX_CPF_GB8: return (p & 0xFFu) * 0x01010100u | ((p >> 8) & 0xFFu);
+        default: return (p << 8) | 0xFFu;
+        }
+    }
+    switch (k->fmt) {
+    case GC_GX_CPF_RGBA8: return p;
+    case GC_GX_CPF_R8: return r * 0x01010101u;
+    case GC_GX_CPF_RA8: return r * 0x01010100u | a;
+    case GC_GX_CPF_RG8: return g * 0x01010100u | r;
+    case GC_GX_CPF_A8: return a * 0x01010101u;
+    case GC_GX_CPF_RGB565: return x5(r >> 3) << 24 | x6(g >> 2) << 16 | x5(b >> 3) << 8 | 0xFFu;
+    default: /* I8: BT.601 luma */
+        return (((66u * r + 129u * g + 25u * b + 128u) >> 8) + 16u) * 0x01010101u;
+    }
+}
+
+/* Source pixel for output texel (x, y), box filter included. */
+static uint32_t source(const CopyCase *k, const GcGxTexCopy *c, uint32_t x, uint32_t y) {
+    const uint32_t *buf = k->depth ? gc_gx_efb.depth : gc_gx_efb.color;
+    uint32_t xa, xb, ya, yb, sh, p = 0;
+    if (!k->half) return buf[(c->y + y) * EFB_W + c->x + x];
+    xa = c->x + 2u * x;
+    ya = c->y + 2u * y;
+    xb = xa + 1u < c->x + c->w ? xa + 1u : xa;
+    yb = ya + 1u < c->y + c->h ? ya + 1u : ya;
+    for (sh = 0; sh < 32u; sh += 8u) {
+        const uint32_t sum = ((buf[ya * EFB_W + xa] >> sh) & 0xFFu) + ((buf[ya * EFB_W + xb] >> sh) & 0xFFu) +
+                             ((buf[yb * EFB_W + xa] >> sh) & 0xFFu) + ((buf[yb * EFB_W + xb] >> sh) & 0xFFu);
+        p |= ((sum + 2u) >> 2) << sh;
+    }
+    return p;
+}
+
+static int test_L1_closed_form(void) {
+    const CopyCase *k = &k_cases[xorshift32() % NCASES];
+    GcGxTexCopy c;
+    uint32_t w, h, x, y, bad = 0, want = 0, got = 0;
+
+    c.w = rnd_dim(EFB_W);
+    c.h = rnd_dim(EFB_H);
+    c.x = xorshift32() % (EFB_W - c.w + 1u);
+    c.y = xorshift32() % (EFB_H - c.h + 1u);
+    c.fmt = k->fmt;
+    c.depth = k->depth;
+    c.intensity = k->intensity;
+    c.half = k->half;
+    gc_gx_texcopy_dims(&c, &w, &h);
+
+    CHECK(gc_gx_texcopy_encode(ram(DST_ADDR), &gc_gx_efb, &c), "L1 %s encode failed", k->name);
+    CHECK(gc_gx_texcopy_size(&c) == gc_gx_texdec_size(w, h, k->tex_fmt),
+          "L1 %s %ux%u size differs from the texture size", k->name, w, h);
+    CHECK(gc_gx_texdec_decode(g_texels, ram(DST_ADDR), w, h, k->tex_fmt, NULL, 0),
+          "L1 %s decode failed", k->name);
+    for (y = 0; y < h && !bad; y++) {
+        for (x = 0; x < w; x++) {
+            want = expect(k, source(k, &c, x, y));
+            got = g_texels[y * w + x];
+            if (got != want) {
+                bad = 1;
+                break;
+            }
+        }
+    }
+    CHECK(!bad, "L1 %s rect (%u,%u %ux%u) texel (%u,%u) %08x != %08x", k->name, c.x, c.y, c.w,
+          c.h, x, y - 1u, got, want);
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L2: SDK copies through GX and the GP
+ * ═══════════════════════════════════════════════════════════════════ */
+
+typedef struct {
+    const char *name;
+    uint32_t sdk_fmt;                   /* SDK GX_TF_* / GX_CTF_* value */
+    uint32_t case_idx;                  /* k_cases entry with the same encoding */
+} SdkCase;
+
+static const SdkCase k_sdk[] = {
+    { "GX_TF_RGBA8",  0x06u, 0 },
+    { "GX_CTF_R8",    0x28u, 1 },
+    { "GX_CTF_RG8",   0x2Bu, 3 },
+    { "GX_TF_RGB565", 0x04u, 5 },
+    { "GX_CTF_Z4",    0x30u, 8 },
+    { "GX_CTF_Z16L",  0x3Cu, 9 },
+    { "GX_TF_Z24X8",  0x16u, 10 },
+};
+#define NSDK (sizeof(k_sdk) / sizeof(k_sdk[0]))
+
+static int test_L2_sdk(void) {
+    const SdkCase *s = &k_sdk[xorshift32() % NSDK];
+    const CopyCase *k = &k_cases[s->case_idx];
+    const uint32_t clear = xorshift32() & 1u;
+    const GXColor cc = { (uint8_t)xorshift32(), (uint8_t)xorshift32(), (uint8_t)xorshift32(),
+                         (uint8_t)xorshift32() };
+    const uint32_t rgba = (uint32_t)cc.r << 24 | (uint32_t)cc.g << 16 | (uint32_t)cc.b << 8 | cc.a;
+    const uint32_t cz = xorshift32() & 0xFFFFFFu;
+    const uint32_t *tex;
+    GcGxTexCopy c;
+    uint32_t x, y, copies, bad = 0, want = 0, got = 0;
+
+    c.w = rnd_dim(EFB_W);
+    c.h = rnd_dim(EFB_H);
+    c.x = xorshift32() % (EFB_W - c.w + 1u);
+    c.y = xorshift32() % (EFB_H - c.h + 1u);
+    c.half = 0;
+
+    GXInit(0, 0);
+    GXSetPixelFmt(0 /* GX_PF_RGB8_Z24 */, 0);
+    GXSetCopyClear(cc, cz);
+    GXSetDrawDone();
+    memcpy(g_efb_before, gc_gx_efb.color, sizeof(g_efb_before));
+    memcpy(g_depth_before, gc_gx_efb.depth, sizeof(g_depth_before));
+
+    /* A decoded texture at the destination must not survive the copy. */
+    gc_gx_texdec_cache_reset();
+    memset(ram(DST_ADDR), 0, gc_gx_texdec_size(c.w, c.h, k->tex_fmt));
+    CHECK(gc_gx_texdec_get(DST_ADDR, c.w, c.h, k->tex_fmt, 0) != NULL, "L2 pre-copy decode failed");
+
+    copies = gc_gx_texcopy_copies;
+    GXSetTexCopySrc((uint16_t)c.x, (uint16_t)c.y, (uint16_t)c.w, (uint16_t)c.h);
+    GXSetTexCopyDst((uint16_t)c.w, (uint16_t)c.h, s->sdk_fmt, 0);
+    GXCopyTex((void *)(uintptr_t)DST_ADDR, clear);
+    GXSetDrawDone();
+    CHECK(gc_gx_texcopy_copies == copies + 1u, "L2 %s copy not executed", s->name);
+    CHECK((gc_gx_gp.bp[0x43] & 7u) == 0u, "L2 %s pixel format not restored (%u)", s->name,
+          gc_gx_gp.bp[0x43] & 7u);
+
+    tex = gc_gx_texdec_get(DST_ADDR, c.w, c.h, k->tex_fmt, 0);
+    CHECK(tex != NULL, "L2 %s decode failed", s->name);
+    for (y = 0; y < c.h && !bad; y++) {
+        for (x = 0; x < c.w; x++) {
+            const uint32_t i = (c.y + y) * EFB_W + c.x + x;
+            want = expect(k, k->depth ? g_depth_before[i] : g_efb_before[i]);
+            got = tex[y * c.w + x];
+            if (got != want) {
+                bad = 1;
+                break;
+            }
+            if (clear && (gc_gx_efb.color[i] != rgba || gc_gx_efb.depth[i] != cz)) {
+                bad = 2;
+                break;
+            }
+        }
+    }
+    CHECK(bad != 1, "L2 %s rect (%u,%u %ux%u) texel (%u,%u) %08x != %08x", s->name, c.x, c.y,
+          c.w, c.h, x, y - 1u, got, want);
+    CHECK(bad != 2, "L2 %s pixel (%u,%u) not cleared after the copy", s->name, c.x + x, c.y + y - 1u);
+    if (!clear) {
+        CHECK(memcmp(g_efb_before, gc_gx_efb.color, sizeof(g_efb_before)) == 0,
+              "L2 %s copy without clear changed the EFB", s->name);
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Per-seed runner
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int run_seed(uint32_t seed) {
+    g_rng = seed;
+    ram_init();
+    if (!efb_fill()) {
+        printf("EFB allocation failed\n");
+        return 0;
+    }
+    if (!g_opt_op || strstr("L0", g_opt_op) || strstr("RANDOM", g_opt_op)) {
+        if (!test_L0_random()) return 0;
+    }
+    if (!g_opt_op || strstr("L1", g_opt_op) || strstr("CLOSED", g_opt_op)) {
+        if (!test_L1_closed_form()) return 0;
+    }
+    if (!g_opt_op || strstr("L2", g_opt_op) || strstr("SDK", g_opt_op) || strstr("FULL", g_opt_op)) {
+        if (!test_L2_sdk()) return 0;
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * main
+ * ═══════════════════════════════════════════════════════════════════ */
+
+int main(int argc, char **argv) {
+    uint32_t start_seed = 1;
+    int num_runs = 100;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+            start_seed = (uint32_t)strtoul(argv[i] + 7, NULL, 0);
+        else if (strncmp(argv[i], "--num-runs=", 11) == 0)
+            num_runs = atoi(argv[i] + 11);
+        else if (strncmp(argv[i], "--op=", 5) == 0)
+            g_opt_op = argv[i] + 5;
+        else if (strcmp(argv[i], "-v") == 0)
+            g_verbose = 1;
+        else {
+            fprintf(stderr,
+                    "Usage: gxtexcopy_property_test [--seed=N] [--num-runs=N] "
+                    "[--op=L0|L1|L2|RANDOM|CLOSED|SDK|FULL] [-v]\n");
+            return 2;
+        }
+    }
+
+    printf("\n=== GX Texture Copy Property Test ===\n");
+
+    for (i = 0; i < num_runs; i++) {
+        uint32_t seed = start_seed + (uint32_t)i;
+        uint64_t before = g_total_checks;
+
+        if (!run_seed(seed)) {
+            printf("  FAILED at seed %u\n", seed);
+            printf("\n--- Summary ---\n");
+            printf("Seeds:  %d (failed at %d)\n", i + 1, i + 1);
+            printf("Checks: %llu  (pass=%llu  fail=1)\n",
+                   (unsigned long long)g_total_checks,
+                   (unsigned long long)g_total_pass);
+            printf("\nRESULT: FAIL\n");
+            return 1;
+        }
+
+        if (g_verbose) {
+            printf("  seed %u: %llu checks OK (copies=%u bytes=%u)\n", seed,
+                   (unsigned long long)(g_total_checks - before), gc_gx_texcopy_copies,
+                   gc_gx_texcopy_bytes);
+        }
+        if ((i + 1) % 100 == 0) {
+            printf("  progress: seed %d/%d\n", i + 1, num_runs);
+        }
+    }
+
+    printf("\n--- Summary ---\n");
+    printf("Seeds:  %d\n", num_runs);
+    printf("Checks: %llu  (pass=%llu  fail=0)\n",
+           (unsigned long long)g_total_checks,
+           (unsigned long long)g_total_pass);
+    printf("\nRESULT: %llu/%llu PASS\n",
+           (unsigned long long)g_total_pass,
+           (unsigned long long)g_total_checks);
+
+    return 0;
+}
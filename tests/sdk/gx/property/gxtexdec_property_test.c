@@ -0,0 +1,568 @@
+/*
+ * gxtexdec_property_test.c — Property test for the texture decoder and cache
+ *
+ * Oracle: gc_gx_texdec_decode_ref (one texel at a time from its tiled address)
+ * Port:   gc_gx_texdec_decode (vector block decoders) + gc_gx_texdec_get
+ *
+ * Levels:
+ *   L0 — Random bytes in every format, random sizes (edge blocks included)
+ *        and random TLUTs: vector decode == reference, size == block math
+ *   L1 — Closed form: images built texel by texel with a test-side tiler
+ *        decode to the colors they were built from; an SDK quad textured
+ *        through GXInitTexObj / GXInitTlutObj / GXLoadTlut with GX_REPLACE
+ *        shows the image 1:1 in the EFB
+ *   L2 — Cache: repeat lookups hit, reported writes revalidate unchanged
+ *        bytes and re-decode changed ones, a TLUT reload with new entries
+ *        re-decodes CI images, verify mode catches unreported writes
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "gc_mem.h"
+#include "gx_gp.h"
+#include "gx_raster.h"
+#include "gx_texdec.h"
+
+/* ── xorshift32 PRNG ────────────────────────────────────────────── */
+static uint32_t g_rng;
+static uint32_t xorshift32(void) {
+    uint32_t x = g_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rng = x;
+    return x;
+}
+
+/* ── Counters ───────────────────────────────────────────────────── */
+static uint64_t g_total_checks;
+static uint64_t g_total_pass;
+static int       g_verbose;
+static const char *g_opt_op;
+
+#define CHECK(cond, ...) do { \
+    g_total_checks++; \
+    if (!(cond)) { \
+        printf("FAIL @ %s:%d: ", __FILE__, __LINE__); \
+        printf(__VA_ARGS__); printf("\n"); \
+        return 0; \
+    } \
+    g_total_pass++; \
+} while(0)
+
+/* ── SDK surface (linked from GX.c) ─────────────────────────────── */
+typedef struct { uint8_t _dummy; } GXFifoObj;
+typedef struct { uint32_t _w[8]; } GXTexObj;
+typedef struct { uint32_t _w[4]; } GXTlutObj;
+GXFifoObj *GXInit(void *base, uint32_t size);
+void GXClearVtxDesc(void);
+void GXSetVtxDesc(uint32_t attr, uint32_t type);
+void GXSetVtxAttrFmt(uint32_t vtxfmt, uint32_t attr, uint32_t cnt, uint32_t type, uint8_t frac);
+void GXBegin(uint8_t type, uint8_t vtxfmt, uint16_t nverts);
+void GXEnd(void);
+void GXPosition3f32(float x, float y, float z);
+void GXTexCoord2f32(float s, float t);
+void GXLoadPosMtxImm(float mtx[3][4], uint32_t id);
+void GXLoadTexMtxImm(float mtx[][4], uint32_t id, uint32_t type);
+void GXSetCurrentMtx(uint32_t id);
+void GXSetProjection(float mtx[4][4], uint32_t type);
+void GXSetViewport(float left, float top, float wd, float ht, float nearz, float farz);
+void GXSetScissor(uint32_t left, uint32_t top, uint32_t wd, uint32_t ht);
+void GXSetCullMode(uint32_t mode);
+void GXSetNumChans(uint8_t n);
+void GXSetNumTexGens(uint8_t n);
+void GXSetTexCoordGen2(uint8_t dst_coord, uint32_t func, uint32_t src_param, uint32_t mtx,
+                       uint32_t normalize, uint32_t postmtx);
+void GXSetNumTevStages(uint8_t n);
+void GXSetTevOrder(uint32_t stage, uint32_t coord, uint32_t map, uint32_t color);
+void GXSetTevOp(uint32_t stage, uint32_t mode);
+void GXSetTevColorOp(uint32_t stage, uint32_t op, uint32_t bias, uint32_t scale, uint32_t clamp, uint32_t out);
+void GXSetTevAlphaOp(uint32_t stage, uint32_t op, uint32_t bias, uint32_t scale, uint32_t clamp, uint32_t out);
+void GXSetTevSwapMode(uint32_t stage, uint32_t ras_sel, uint32_t tex_sel);
+void GXSetTevSwapModeTable(uint32_t table, uint32_t r, uint32_t g, uint32_t b, uint32_t a);
+void GXSetZMode(uint8_t enable, uint32_t func, uint8_t update);
+void GXSetBlendMode(uint32_t type, uint32_t src, uint32_t dst, uint32_t op);
+void GXSetColorUpdate(uint8_t enable);
+void GXSetAlphaUpdate(uint8_t enable);
+void GXSetAlphaCompare(uint32_t comp0, uint8_t ref0, uint32_t op, uint32_t comp1, uint8_t ref1);
+void GXSetPixelFmt(uint32_t pix_fmt, uint32_t z_fmt);
+void GXSetDrawDone(void);
+void GXInitTexObj(GXTexObj *obj, void *image_ptr, uint16_t width, uint16_t height, uint32_t format,
+                  uint32_t wrap_s, uint32_t wrap_t, uint8_t mipmap);
+void GXInitTexObjCI(GXTexObj *obj, void *image_ptr, uint16_t width, uint16_t height, uint32_t format,
+                    uint32_t wrap_s, uint32_t wrap_t, uint8_t mipmap, uint32_t tlut_name);
+void GXInitTexObjLOD(GXTexObj *obj, uint32_t min_filt, uint32_t mag_filt, float min_lod,
+                     float max_lod, float lod_bias, uint8_t bias_clamp, uint8_t do_edge_lod,
+                     uint32_t max_aniso);
+void GXLoadTexObj(GXTexObj *obj, uint32_t id);
+void GXInitTlutObj(GXTlutObj *tlut_obj, void *lut, uint32_t fmt, uint16_t n_entries);
+void GXLoadTlut(GXTlutObj *tlut_obj, uint32_t tlut_name);
+void DCFlushRange(void *addr, uint32_t nbytes);
+
+/* ── Emulated RAM ───────────────────────────────────────────────── */
+#define RAM_BASE  0x80000000u
+#define RAM_SIZE  0x01800000u
+#define IMG_ADDR  0x80100000u
+#define TLUT_ADDR 0x80400000u
+
+static uint8_t *g_ram;
+
+static void ram_init(void) {
+    if (!g_ram) g_ram = (uint8_t *)calloc(1, RAM_SIZE);
+    gc_mem_set(RAM_BASE, RAM_SIZE, g_ram);
+}
+
+static uint8_t *ram(uint32_t addr) {
+    return g_ram + (addr - RAM_BASE);
+}
+
+/* ── Helpers ────────────────────────────────────────────────────── */
+#define MAX_TEXELS (256u * 256u)
+
+static const uint32_t k_fmts[] = {
+    GC_GX_TF_I4, GC_GX_TF_I8, GC_GX_TF_IA4, GC_GX_TF_IA8, GC_GX_TF_RGB565, GC_GX_TF_RGB5A3,
+    GC_GX_TF_RGBA8, GC_GX_TF_C4, GC_GX_TF_C8, GC_GX_TF_C14X2, GC_GX_TF_CMPR,
+};
+#define NFMTS (sizeof(k_fmts) / sizeof(k_fmts[0]))
+
+static uint32_t g_out_a[MAX_TEXELS];
+static uint32_t g_out_b[MAX_TEXELS];
+static uint8_t g_tlut[0x8000];
+
+/* Block width/height/bytes straight from the GX format table. */
+static void blk_dims(uint32_t fmt, uint32_t *bw, uint32_t *bh, uint32_t *bytes) {
+    *bytes = fmt == GC_GX_TF_RGBA8 ? 64u : 32u;
+    *bw = (fmt == GC_GX_TF_IA8 || fmt == GC_GX_TF_RGB565 || fmt == GC_GX_TF_RGB5A3 ||
+           fmt == GC_GX_TF_RGBA8 || fmt == GC_GX_TF_C14X2) ? 4u : 8u;
+    *bh = (fmt == GC_GX_TF_I4 || fmt == GC_GX_TF_C4 || fmt == GC_GX_TF_CMPR) ? 8u : 4u;
+}
+
+/* Byte offset of texel (x, y) in a tiled image, for 8/16-bit formats. */
+static uint32_t tile_off(uint32_t fmt, uint32_t w, uint32_t x, uint32_t y) {
+    uint32_t bw, bh, bytes, bpp;
+    blk_dims(fmt, &bw, &bh, &bytes);
+    bpp = bw == 8u ? 1u : 2u;
+    return ((y / bh) * ((w + bw - 1u) / bw) + x / bw) * bytes + ((y % bh) * bw + x % bw) * bpp;
+}
+
+static void put16(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static uint32_t rnd_dim(void) {
+    static const uint32_t k_dims[] = { 1, 3, 4, 7, 8, 12, 16, 20, 31, 32, 64 };
+    return (xorshift32() & 1u) ? k_dims[xorshift32() % 11u] : 1u + xorshift32() % 96u;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L0: vector decode == reference
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L0_random(void) {
+    const uint32_t fmt = k_fmts[xorshift32() % NFMTS];
+    const uint32_t w = rnd_dim(), h = rnd_dim(), tlut_fmt = xorshift32() % 3u;
+    uint32_t bw, bh, bytes, size, i;
+    uint8_t *src = ram(IMG_ADDR);
+
+    blk_dims(fmt, &bw, &bh, &bytes);
+    size = gc_gx_texdec_size(w, h, fmt);
+    CHECK(size == ((w + bw - 1u) / bw) * ((h + bh - 1u) / bh) * bytes,
+          "L0 fmt %u %ux%u size %u", fmt, w, h, size);
+    for (i = 0; i < size; i++) src[i] = (uint8_t)xorshift32();
+    for (i = 0; i < sizeof(g_tlut); i++) g_tlut[i] = (uint8_t)xorshift32();
+
+    memset(g_out_a, 0xA5, w * h * 4u);
+    memset(g_out_b, 0x5A, w * h * 4u);
+    CHECK(gc_gx_texdec_decode(g_out_a, src, w, h, fmt, g_tlut, tlut_fmt), "L0 decode failed");
+    CHECK(gc_gx_texdec_decode_ref(g_out_b, src, w, h, fmt, g_tlut, tlut_fmt), "L0 ref failed");
+    for (i = 0; i < w * h && g_out_a[i] == g_out_b[i]; i++) {
+    }
+    CHECK(i == w * h, "L0 fmt %u %ux%u tlut %u texel (%u,%u) %08x != %08x", fmt, w, h,
+          tlut_fmt, i % w, i / w, g_out_a[i], g_out_b[i]);
+
+    CHECK(!gc_gx_texdec_size(w, h, 7u) && !gc_gx_texdec_size(0, h, fmt) &&
+          !gc_gx_texdec_size(w, GC_GX_TEXDEC_MAX_DIM + 1u, fmt), "L0 bad size accepted");
+    CHECK(!gc_gx_texdec_decode(g_out_a, src, w, h, 0xFu, g_tlut, 0), "L0 bad format decoded");
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L1: closed-form images and an SDK textured quad
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static uint32_t x5(uint32_t v) { return (v << 3) | (v >> 2); }
+static uint32_t x6(uint32_t v) { return (v << 2) | (v >> 4); }
+
+/* Builds a w x h image of fmt texel by texel; want[] gets the RGBA8 result. */
+static void build_image(uint8_t *dst, uint32_t *want, uint32_t w, uint32_t h, uint32_t fmt,
+                        const uint8_t *tlut, uint32_t tlut_fmt) {
+    uint32_t x, y;
+    memset(dst, 0, gc_gx_texdec_size(w, h, fmt));
+    for (y = 0; y < h; y++) {
+        for (x = 0; x < w; x++) {
+            const uint32_t v = xorshift32();
+            uint32_t *o = &want[y * w + x];
+            switch (fmt) {
+            case GC_GX_TF_I8:
+                dst[tile_off(fmt, w, x, y)] = (uint8_t)v;
+                *o = (v & 0xFFu) * 0x01010101u;
+                break;
+            case GC_GX_TF_IA4:
+                dst[tile_off(fmt, w, x, y)] = (uint8_t)v;
+                *o = (v & 15u) * 0x11111100u | ((v >> 4) & 15u) * 0x11u;
+                break;
+            case GC_GX_TF_IA8:
+                put16(dst + tile_off(fmt, w, x, y), v & 0xFFFFu);
+                *o = (v & 0xFFu) * 0x01010100u | ((v >> 8) & 0xFFu);
+                break;
+            case GC_GX_TF_RGB565:
+                put16(dst + tile_off(fmt, w, x, y), v & 0xFFFFu);
+                *o = x5((v >> 11) & 31u) << 24 | x6((v >> 5) & 63u) << 16 | x5(v & 31u) << 8 | 0xFFu;
+                break;
+            case GC_GX_TF_RGBA8: {
+                /* 4x4 blocks: AR pairs in the first 32 bytes, GB in the second. */
+                uint8_t *b = dst + ((y / 4u) * ((w + 3u) / 4u) + x / 4u) * 64u + ((y % 4u) * 4u + x % 4u) * 2u;
+                b[0] = (uint8_t)v;
+                b[1] = (uint8_t)(v >> 24);
+                b[32] = (uint8_t)(v >> 16);
+                b[33] = (uint8_t)(v >> 8);
+                *o = v;
+                break;
+            }
+            case GC_GX_TF_C8: {
+                const uint32_t e = ((uint32_t)tlut[(v & 0xFFu) * 2u] << 8) | tlut[(v & 0xFFu) * 2u + 1u];
+                dst[tile_off(fmt, w, x, y)] = (uint8_t)v;
+                if (tlut_fmt == GC_GX_TL_RGB565) {
+                    *o = x5(e >> 11) << 24 | x6((e >> 5) & 63u) << 16 | x5(e & 31u) << 8 | 0xFFu;
+                } else {
+                    *o = (e & 0xFFu) * 0x01010100u | (e >> 8);
+                }
+                break;
+            }
+            default:
+                break;
+            }
+        }
+    }
+}
+
+static int test_L1_closed_form(void) {
+    static const uint32_t k_l1_fmts[] = {
+        GC_GX_TF_I8, GC_GX_TF_IA4, GC_GX_TF_IA8, GC_GX_TF_RGB565, GC_GX_TF_RGBA8, GC_GX_TF_C8,
+    };
+    const uint32_t fmt = k_l1_fmts[xorshift32() % 6u];
+    const uint32_t w = rnd_dim(), h = rnd_dim();
+    const uint32_t tlut_fmt = (xorshift32() & 1u) ? GC_GX_TL_RGB565 : GC_GX_TL_IA8;
+    uint8_t *src = ram(IMG_ADDR);
+    uint32_t i;
+
+    for (i = 0; i < 512u; i++) g_tlut[i] = (uint8_t)xorshift32();
+    build_image(src, g_out_b, w, h, fmt, g_tlut, tlut_fmt);
+    CHECK(gc_gx_texdec_decode(g_out_a, src, w, h, fmt, g_tlut, tlut_fmt), "L1 decode failed");
+    for (i = 0; i < w * h && g_out_a[i] == g_out_b[i]; i++) {
+    }
+    CHECK(i == w * h, "L1 fmt %u %ux%u texel (%u,%u) %08x != %08x", fmt, w, h, i % w, i / w,
+          g_out_a[i], g_out_b[i]);
+
+    /* Fixed CMPR block: c0 > c1 gives 5/8 and 3/8 blends, c0 <= c1 a
+     * transparent fourth color. */
+    {
+        static const uint8_t blk[32] = {
+            0xF8, 0x00, 0x00, 0x1F, 0x1B, 0x1B, 0x1B, 0x1B,   /* red > blue */
+            0x00, 0x1F, 0xF8, 0x00, 0xE4, 0xE4, 0xE4, 0xE4,   /* blue <= red */
+        };
+        CHECK(gc_gx_texdec_decode(g_out_a, blk, 8, 8, GC_GX_TF_CMPR, NULL, 0), "L1 cmpr failed");
+        /* Row 0 of sub-block 0: indices 0,1,2,3. */
+        CHECK(g_out_a[0] == 0xFF0000FFu && g_out_a[1] == 0x0000FFFFu, "L1 cmpr endpoints %08x %08x",
+              g_out_a[0], g_out_a[1]);
+        CHECK(g_out_a[2] == 0x9F005FFFu && g_out_a[3] == 0x5F009FFFu, "L1 cmpr blends %08x %08x",
+              g_out_a[2], g_out_a[3]);
+        /* Sub-block 1 row 0: indices 3,2,1,0. */
+        CHECK(g_out_a[4] == 0x7F007F00u && g_out_a[5] == 0x7F007FFFu && g_out_a[6] == 0xFF0000FFu &&
+              g_out_a[7] == 0x0000FFFFu, "L1 cmpr 3-color %08x %08x %08x %08x",
+              g_out_a[4], g_out_a[5], g_out_a[6], g_out_a[7]);
+    }
+    return 1;
+}
+
+/* Pixel-exact ortho with one textured stage: REPLACE, nearest filtering. */
+static void sdk_setup(void) {
+    float pm[3][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 } };
+    float tm[2][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 } };
+    float proj[4][4] = { { 2.0f / 640.0f, 0, 0, -1 }, { 0, -2.0f / 480.0f, 0, 1 },
+                         { 0, 0, -1, -1 }, { 0, 0, 0, 1 } };
+
+    GXInit(0, 0);
+    GXLoadPosMtxImm(pm, 0);
+    GXLoadTexMtxImm(tm, 60 /* GX_IDENTITY */, 1 /* GX_MTX2x4 */);
+    GXSetCurrentMtx(0);
+    GXSetProjection(proj, 1);
+    GXSetViewport(0.0f, 0.0f, 640.0f, 480.0f, 0.0f, 1.0f);
+    GXSetScissor(0, 0, 640, 480);
+    GXSetNumChans(0);
+    GXSetNumTexGens(1);
+    GXSetTexCoordGen2(0, 1 /* GX_TG_MTX2x4 */, 4 /* GX_TG_TEX0 */, 60, 0, 125);
+    GXSetNumTevStages(1);
+    GXSetTevOrder(0, 0 /* GX_TEXCOORD0 */, 0 /* GX_TEXMAP0 */, 0xFF);
+    GXSetTevSwapModeTable(0, 0, 1, 2, 3);
+    GXSetTevSwapMode(0, 0, 0);
+    GXSetTevOp(0, 3 /* GX_REPLACE */);
+    GXSetTevColorOp(0, 0, 0, 0, 1, 0);
+    GXSetTevAlphaOp(0, 0, 0, 0, 1, 0);
+    GXSetZMode(0, 7, 0);
+    GXSetBlendMode(0, 4, 5, 0);
+    GXSetColorUpdate(1);
+    GXSetAlphaUpdate(1);
+    GXSetAlphaCompare(7, 0, 0, 7, 0);
+    GXSetPixelFmt(0 /* GX_PF_RGB8_Z24 */, 0);
+    GXSetCullMode(0);
+
+    GXClearVtxDesc();
+    GXSetVtxDesc(9, 1);
+    GXSetVtxDesc(13, 1);
+    GXSetVtxAttrFmt(0, 9, 1, 4, 0);
+    GXSetVtxAttrFmt(0, 13, 1, 4, 0);
+}
+
+static int test_L1_sdk(void) {
+    const int ci = (int)(xorshift32() & 1u);
+    const uint32_t fmt = ci ? GC_GX_TF_C8 : GC_GX_TF_RGBA8;
+    const uint32_t tlut_fmt = (xorshift32() & 1u) ? GC_GX_TL_RGB565 : GC_GX_TL_IA8;
+    const uint32_t w = 1u + xorshift32() % 64u, h = 1u + xorshift32() % 64u;
+    const int32_t x0 = (int32_t)(xorshift32() % (640u - w)), y0 = (int32_t)(xorshift32() % (480u - h));
+    const uint32_t clear = xorshift32() | 0xFFu;
+    const float xs[4] = { (float)x0, (float)x0 + (float)w, (float)x0 + (float)w, (float)x0 };
+    const float ys[4] = { (float)y0, (float)y0, (float)y0 + (float)h, (float)y0 + (float)h };
+    const float ss[4] = { 0, 1, 1, 0 }, ts[4] = { 0, 0, 1, 1 };
+    GXTexObj tex;
+    GXTlutObj tlut;
+    uint32_t x, y, i, bad = 0, want = 0, got = 0;
+
+    for (i = 0; i < 512u; i++) ram(TLUT_ADDR)[i] = (uint8_t)xorshift32();
+    build_image(ram(IMG_ADDR), g_out_b, w, h, fmt, ram(TLUT_ADDR), tlut_fmt);
+    DCFlushRange((void *)(uintptr_t)IMG_ADDR, gc_gx_texdec_size(w, h, fmt));
+    DCFlushRange((void *)(uintptr_t)TLUT_ADDR, 512u);
+
+    sdk_setup();
+    if (!gc_gx_efb.color) CHECK(gc_gx_raster_efb_init(&gc_gx_efb), "L1 efb alloc failed");
+    gc_gx_raster_clear(&gc_gx_efb, clear, 0xFFFFFFu);
+    if (ci) {
+        GXInitTlutObj(&tlut, (void *)(uintptr_t)TLUT_ADDR, tlut_fmt, 256);
+        GXLoadTlut(&tlut, 3);
+        GXInitTexObjCI(&tex, (void *)(uintptr_t)IMG_ADDR, (uint16_t)w, (uint16_t)h, fmt, 0, 0, 0, 3);
+    } else {
+        GXInitTexObj(&tex, (void *)(uintptr_t)IMG_ADDR, (uint16_t)w, (uint16_t)h, fmt, 0, 0, 0);
+    }
+    GXInitTexObjLOD(&tex, 0 /* GX_NEAR */, 0 /* GX_NEAR */, 0, 0, 0, 0, 0, 0);
+    GXLoadTexObj(&tex, 0);
+
+    GXBegin(0x80, 0, 4);
+    for (i = 0; i < 4u; i++) {
+        GXPosition3f32(xs[i], ys[i], -0.5f);
+        GXTexCoord2f32(ss[i], ts[i]);
+    }
+    GXEnd();
+    GXSetDrawDone();
+
+    for (y = 0; y < 480u && !bad; y++) {
+        for (x = 0; x < 640u; x++) {
+            const int in = (int32_t)x >= x0 && (int32_t)x < x0 + (int32_t)w &&
+                           (int32_t)y >= y0 && (int32_t)y < y0 + (int32_t)h;
+            /* RGB8_Z24 has no alpha plane: written pixels read back alpha 0xFF. */
+            want = in ? (g_out_b[(y - (uint32_t)y0) * w + (x - (uint32_t)x0)] | 0xFFu) : clear;
+            got = gc_gx_efb.color[y * GC_GX_EFB_WIDTH + x];
+            if (got != want) {
+                bad = 1;
+                break;
+            }
+        }
+    }
+    CHECK(!bad, "L1 sdk %s %ux%u tlut %u pixel (%u,%u) %08x != %08x", ci ? "C8" : "RGBA8", w, h,
+          tlut_fmt, x, y - 1u, got, want);
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L2: decoded-texture cache
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L2_cache(void) {
+    const uint32_t fmt = k_fmts[xorshift32() % NFMTS];
+    const uint32_t w = rnd_dim(), h = rnd_dim();
+    const uint32_t size = gc_gx_texdec_size(w, h, fmt);
+    const uint32_t off = (xorshift32() % 64u) * 16u;       /* TLUT offset, 512B units */
+    const uint32_t tlut_reg = ((xorshift32() % 3u) << 10) | off;
+    const int ci = fmt == GC_GX_TF_C4 || fmt == GC_GX_TF_C8 || fmt == GC_GX_TF_C14X2;
+    uint8_t *src = ram(IMG_ADDR);
+    const uint32_t *a, *b;
+    uint32_t i, hits, misses, reval, inval;
+
+    gc_gx_texdec_cache_reset();
+    for (i = 0; i < size; i++) src[i] = (uint8_t)xorshift32();
+    for (i = 0; i < 0x8000u; i++) ram(TLUT_ADDR)[i] = (uint8_t)xorshift32();
+    gc_gx_texdec_load_tlut(TLUT_ADDR & 0x01FFFFFFu, off, 0x400u);
+
+    a = gc_gx_texdec_get(IMG_ADDR, w, h, fmt, tlut_reg);
+    CHECK(a != NULL, "L2 get failed");
+    CHECK(gc_gx_texdec_decode_ref(g_out_b, src, w, h, fmt, gc_gx_texdec_tlut(off), tlut_reg >> 10),
+          "L2 ref failed");
+    CHECK(memcmp(a, g_out_b, w * h * 4u) == 0, "L2 cached image != reference");
+    CHECK(gc_gx_texdec_misses == 1u && gc_gx_texdec_hits == 0u, "L2 first lookup counters");
+
+    /* Repeat lookups hit; a different size or format is a different entry. */
+    b = gc_gx_texdec_get(IMG_ADDR, w, h, fmt, tlut_reg);
+    CHECK(b == a && gc_gx_texdec_hits == 1u, "L2 repeat lookup missed");
+    CHECK(gc_gx_texdec_get(IMG_ADDR, w + 1u, h, fmt, tlut_reg) != a &&
+          gc_gx_texdec_misses == 2u, "L2 different width shared an entry");
+
+    /* Reported write with the same bytes: revalidated, no re-decode. */
+    misses = gc_gx_texdec_misses;
+    inval = gc_gx_texdec_invalidations;
+    gc_mem_notify_write(IMG_ADDR + size / 2u, 1);
+    CHECK(gc_gx_texdec_invalidations == inval + 2u, "L2 write did not mark entries stale");
+    reval = gc_gx_texdec_revalidations;
+    CHECK(gc_gx_texdec_get(IMG_ADDR, w, h, fmt, tlut_reg) == a &&
+          gc_gx_texdec_revalidations == reval + 1u && gc_gx_texdec_misses == misses,
+          "L2 unchanged bytes not revalidated");
+
+    /* Reported write that changes a texel: re-decoded to the new contents. */
+    src[size - 1u] ^= 0x5Au;
+    gc_mem_notify_write(IMG_ADDR + size - 1u, 1);
+    a = gc_gx_texdec_get(IMG_ADDR, w, h, fmt, tlut_reg);
+    CHECK(a != NULL && gc_gx_texdec_misses == misses + 1u, "L2 changed bytes not re-decoded");
+    gc_gx_texdec_decode_ref(g_out_b, src, w, h, fmt, gc_gx_texdec_tlut(off), tlut_reg >> 10);
+    CHECK(memcmp(a, g_out_b, w * h * 4u) == 0, "L2 re-decoded image != reference");
+
+    /* Unreported write: only verify mode sees it. */
+    src[0] ^= 0xFFu;
+    hits = gc_gx_texdec_hits;
+    CHECK(gc_gx_texdec_get(IMG_ADDR, w, h, fmt, tlut_reg) == a && gc_gx_texdec_hits == hits + 1u,
+          "L2 unreported write should still hit");
+    gc_gx_texdec_cache_verify = 1;
+    misses = gc_gx_texdec_misses;
+    a = gc_gx_texdec_get(IMG_ADDR, w, h, fmt, tlut_reg);
+    gc_gx_texdec_cache_verify = 0;
+    CHECK(gc_gx_texdec_misses == misses + 1u, "L2 verify mode missed an unreported write");
+    gc_gx_texdec_decode_ref(g_out_b, src, w, h, fmt, gc_gx_texdec_tlut(off), tlut_reg >> 10);
+    CHECK(memcmp(a, g_out_b, w * h * 4u) == 0, "L2 verified image != reference");
+
+    /* A TLUT load elsewhere keeps CI entries; new entries in ours re-decode. */
+    misses = gc_gx_texdec_misses;
+    gc_gx_texdec_load_tlut(TLUT_ADDR & 0x01FFFFFFu, off + 0x100u, 1u);
+    CHECK(gc_gx_texdec_get(IMG_ADDR, w, h, fmt, tlut_reg) == a && gc_gx_texdec_misses == misses,
+          "L2 unrelated TLUT load re-decoded");
+    ram(TLUT_ADDR)[1] ^= 0x81u;
+    gc_gx_texdec_load_tlut(TLUT_ADDR & 0x01FFFFFFu, off, 1u);
+    a = gc_gx_texdec_get(IMG_ADDR, w, h, fmt, tlut_reg);
+    CHECK(gc_gx_texdec_misses == misses + (ci ? 1u : 0u), "L2 TLUT change: %u misses (ci %d)",
+          gc_gx_texdec_misses - misses, ci);
+    gc_gx_texdec_decode_ref(g_out_b, src, w, h, fmt, gc_gx_texdec_tlut(off), tlut_reg >> 10);
+    CHECK(memcmp(a, g_out_b, w * h * 4u) == 0, "L2 TLUT re-decode != reference");
+
+    /* More images than slots: LRU eviction, the newest stays resident. */
+    for (i = 0; i < GC_GX_TEXDEC_CACHE_ENTRIES + 4u; i++) {
+        CHECK(gc_gx_texdec_get(IMG_ADDR + i * 32u, 8, 8, GC_GX_TF_I8, 0) != NULL, "L2 fill failed");
+    }
+    CHECK(gc_gx_texdec_evictions >= 4u, "L2 no evictions (%u)", gc_gx_texdec_evictions);
+    hits = gc_gx_texdec_hits;
+    gc_gx_texdec_get(IMG_ADDR + (GC_GX_TEXDEC_CACHE_ENTRIES + 3u) * 32u, 8, 8, GC_GX_TF_I8, 0);
+    CHECK(gc_gx_texdec_hits == hits + 1u, "L2 newest entry evicted");
+
+    /* Cache off: every lookup decodes. */
+    gc_gx_texdec_cache_enable = 0;
+    misses = gc_gx_texdec_misses;
+    gc_gx_texdec_get(IMG_ADDR, w, h, fmt, tlut_reg);
+    gc_gx_texdec_get(IMG_ADDR, w, h, fmt, tlut_reg);
+    gc_gx_texdec_cache_enable = 1;
+    CHECK(gc_gx_texdec_misses == misses + 2u, "L2 disabled cache served a hit");
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Per-seed runner
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int run_seed(uint32_t seed) {
+    g_rng = seed;
+    ram_init();
+    if (!g_opt_op || strstr("L0", g_opt_op) || strstr("RANDOM", g_opt_op)) {
+        if (!test_L0_random()) return 0;
+    }
+    if (!g_opt_op || strstr("L1", g_opt_op) || strstr("SDK", g_opt_op)) {
+        if (!test_L1_closed_form()) return 0;
+        if (!test_L1_sdk()) return 0;
+    }
+    if (!g_opt_op || strstr("L2", g_opt_op) || strstr("CACHE", g_opt_op) || strstr("FULL", g_opt_op)) {
+        if (!test_L2_cache()) return 0;
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * main
+ * ═══════════════════════════════════════════════════════════════════ */
+
+int main(int argc, char **argv) {
+    uint32_t start_seed = 1;
+    int num_runs = 100;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+            start_seed = (uint32_t)strtoul(argv[i] + 7, NULL, 0);
+        else if (strncmp(argv[i], "--num-runs=", 11) == 0)
+            num_runs = atoi(argv[i] + 11);
+        else if (strncmp(argv[i], "--op=", 5) == 0)
+            g_opt_op = argv[i] + 5;
+        else if (strcmp(argv[i], "-v") == 0)
+            g_verbose = 1;
+        else {
+            fprintf(stderr,
+                    "Usage: gxtexdec_property_test [--seed=N] [--num-runs=N] "
+                    "[--op=L0|L1|L2|RANDOM|SDK|CACHE|FULL] [-v]\n");
+            return 2;
+        }
+    }
+
+    printf("\n=== GX Texture Decoder Property Test ===\n");
+
+    for (i = 0; i < num_runs; i++) {
+        uint32_t seed = start_seed + (uint32_t)i;
+        uint64_t before = g_total_checks;
+
+        if (!run_seed(seed)) {
+            printf("  FAILED at seed %u\n", seed);
+            printf("\n--- Summary ---\n");
+            printf("Seeds:  %d (failed at %d)\n", i + 1, i + 1);
+            printf("Checks: %llu  (pass=%llu  fail=1)\n",
+                   (unsigned long long)g_total_checks,
+                   (unsigned long long)g_total_pass);
+            printf("\nRESULT: FAIL\n");
+            return 1;
+        }
+
+        if (g_verbose) {
+            printf("  seed %u: %llu checks OK (hits=%u misses=%u revalidations=%u evictions=%u)\n",
+                   seed, (unsigned long long)(g_total_checks - before), gc_gx_texdec_hits,
+                   gc_gx_texdec_misses, gc_gx_texdec_revalidations, gc_gx_texdec_evictions);
+        }
+        if ((i + 1) % 100 == 0) {
+            printf("  progress: seed %d/%d\n", i + 1, num_runs);
+        }
+    }
+
+    printf("\n--- Summary ---\n");
+    printf("Seeds:  %d\n", num_runs);
+    printf("Checks: %llu  (pass=%llu  fail=0)\n",
+           (unsigned long long)g_total_checks,
+           (unsigned long long)g_total_pass);
+    printf("\nRESULT: %llu/%llu PASS\n",
+           (unsigned long long)g_total_pass,
+           (unsigned long long)g_total_checks);
+
+    return 0;
+}
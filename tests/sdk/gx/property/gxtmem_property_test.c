@@ -0,0 +1,475 @@
+/*
+ * gxtmem_property_test.c — Property test for the TMEM / texture cache simulator
+ *
+ * Oracle: closed-form line counts of a direct-mapped cache
+ * Port:   gx_tmem.c (fed from GXLoadTexObj, GXLoadTlut, GXPreLoadEntireTexture,
+ *         GXInvalidateTexAll and GXCopyDisp)
+ *
+ * Levels:
+ *   L0 — Random images and regions: a first load of S lines into a bank of
+ *        R lines misses S times and evicts max(0, S - R); a reload hits
+ *        the lines whose cache slot holds no other line; RGBA8 and mipmaps
+ *        split between the banks; preloaded regions cause no traffic;
+ *        TLUT and preload lines survive an invalidate and count clobbers
+ *   L1 — SDK: GXLoadTexObj round-robins the default regions (hits on the
+ *        second pass), GXSetTexRegionCallback routes loads over the TLUT
+ *        area, GXInitTexPreLoadRegion / GXPreLoadEntireTexture preload
+ *   L2 — Frames: random load sequences split by GXCopyDisp; the hook sees
+ *        every frame, the total is the sum of the frames, disabling the
+ *        simulator leaves every counter at zero
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "gx_texdec.h"
+#include "gx_tmem.h"
+
+/* ── xorshift32 PRNG ────────────────────────────────────────────── */
+static uint32_t g_rng;
+static uint32_t xorshift32(void) {
+    uint32_t x = g_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rng = x;
+    return x;
+}
+
+/* ── Counters ───────────────────────────────────────────────────── */
+static uint64_t g_total_checks;
+static uint64_t g_total_pass;
+static int       g_verbose;
+static const char *g_opt_op;
+
+#define CHECK(cond, ...) do { \
+    g_total_checks++; \
+    if (!(cond)) { \
+        printf("FAIL @ %s:%d: ", __FILE__, __LINE__); \
+        printf(__VA_ARGS__); printf("\n"); \
+        return 0; \
+    } \
+    g_total_pass++; \
+} while(0)
+
+/* ── SDK surface (linked from GX.c) ─────────────────────────────── */
+typedef struct { uint8_t _dummy; } GXFifoObj;
+typedef struct { uint32_t _w[8]; } GXTexObj;
+typedef struct { uint32_t _w[4]; } GXTexRegion;
+typedef struct { uint32_t _w[3]; } GXTlutObj;
+typedef GXTexRegion *(*GXTexRegionCallback)(GXTexObj *t_obj, uint32_t unused);
+GXFifoObj *GXInit(void *base, uint32_t size);
+void GXInitTexObj(GXTexObj *obj, void *image_ptr, uint16_t width, uint16_t height, uint32_t format,
+                  uint32_t wrap_s, uint32_t wrap_t, uint8_t mipmap);
+void GXInitTexCacheRegion(GXTexRegion *region, uint8_t is_32b_mipmap, uint32_t tmem_even,
+                          uint32_t size_even, uint32_t tmem_odd, uint32_t size_odd);
+void GXInitTexPreLoadRegion(GXTexRegion *region, uint32_t tmem_even, uint32_t size_even,
+                            uint32_t tmem_odd, uint32_t size_odd);
+void GXPreLoadEntireTexture(GXTexObj *obj, GXTexRegion *region);
+void GXLoadTexObj(GXTexObj *obj, uint32_t id);
+void GXLoadTexObjPreLoaded(GXTexObj *obj, GXTexRegion *region, uint32_t id);
+GXTexRegionCallback GXSetTexRegionCallback(GXTexRegionCallback f);
+void GXInitTlutObj(GXTlutObj *tlut_obj, void *lut, uint32_t fmt, uint16_t n_entries);
+void GXLoadTlut(GXTlutObj *tlut_obj, uint32_t tlut_name);
+void GXInvalidateTexAll(void);
+void GXCopyDisp(void *dest, uint8_t clear);
+
+#define GX_TEXCACHE_512K 2u
+#define GX_TEXCACHE_NONE 3u
+
+/* ── Helpers ────────────────────────────────────────────────────── */
+static const uint32_t k_fmts[] = {
+    GC_GX_TF_I4, GC_GX_TF_I8, GC_GX_TF_IA4, GC_GX_TF_IA8, GC_GX_TF_RGB565,
+    GC_GX_TF_RGB5A3, GC_GX_TF_C4, GC_GX_TF_C8, GC_GX_TF_C14X2, GC_GX_TF_CMPR,
+};
+
+static uint32_t image0(uint32_t w, uint32_t h, uint32_t fmt) {
+    return (w - 1u) | ((h - 1u) << 10) | (fmt << 20);
+}
+
+/* Cache bank register: line base, size exponent 3..5 (0 = none). */
+static uint32_t bank_reg(uint32_t base, uint32_t exp) {
+    return base | (exp << 15) | (exp << 18);
+}
+
+static uint32_t bank_lines(uint32_t exp) {
+    return exp ? (1u << (2u * exp + 9u)) >> 5 : 0u;
+}
+
+static uint32_t lines_of(uint32_t w, uint32_t h, uint32_t fmt) {
+    return gc_gx_texdec_size(w, h, fmt) >> 5;
+}
+
+/* Misses landing in TMEM lines [first, first + n). */
+static uint32_t slot_sum(const uint32_t *slots, uint32_t first, uint32_t n) {
+    uint32_t s = 0, i;
+    for (i = first >> 10; i < (first + n) >> 10; i++) s += slots[i];
+    return s;
+}
+
+/* Reload hits for S consecutive keys in a direct-mapped bank of R lines:
+ * slots holding exactly one of them. */
+static uint32_t reload_hits(uint32_t s, uint32_t r) {
+    if (s <= r) return s;
+    return s < 2u * r ? 2u * r - s : 0u;
+}
+
+static uint32_t rnd_dim(void) {
+    static const uint32_t k_dims[] = { 1, 4, 8, 16, 32, 64, 128, 256, 512, 1024 };
+    return (xorshift32() & 1u) ? k_dims[xorshift32() % 10u] : 1u + xorshift32() % 300u;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L0 — Direct-mapped closed form
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L0_single(void) {
+    const uint32_t fmt = k_fmts[xorshift32() % 10u];
+    const uint32_t w = rnd_dim(), h = rnd_dim();
+    const uint32_t exp = 3u + xorshift32() % 3u;
+    const uint32_t r = bank_lines(exp);
+    const uint32_t base = (xorshift32() % ((GC_GX_TMEM_LINES - r) / 1024u + 1u)) * 1024u;
+    const uint32_t line = xorshift32() & 0x1FFFFu;
+    const uint32_t s = lines_of(w, h, fmt);
+    const uint32_t i1 = bank_reg(base, exp), i2 = bank_reg(0, 0);
+    const GcGxTmemStats *f = &gc_gx_tmem_frame;
+
+    gc_gx_tmem_reset();
+    gc_gx_tmem_load_tex(image0(w, h, fmt), line, 0, 0, i1, i2);
+    CHECK(f->loads == 1u && f->hits == 0u && f->misses == s,
+          "L0 fmt %u %ux%u: misses %u hits %u, want %u", fmt, w, h, f->misses, f->hits, s);
+    CHECK(f->evictions == (s > r ? s - r : 0u), "L0 fmt %u %ux%u R %u: evictions %u",
+          fmt, w, h, r, f->evictions);
+    CHECK(slot_sum(f->slot_misses, base, r) == s, "L0 misses outside the bank at %u", base);
+
+    gc_gx_tmem_end_frame();
+    gc_gx_tmem_load_tex(image0(w, h, fmt), line, 0, 0, i1, i2);
+    CHECK(f->hits == reload_hits(s, r) && f->hits + f->misses == s,
+          "L0 reload S %u R %u: hits %u misses %u", s, r, f->hits, f->misses);
+
+    gc_gx_tmem_end_frame();
+    gc_gx_tmem_invalidate();
+    gc_gx_tmem_load_tex(image0(w, h, fmt), line, 0, 0, i1, i2);
+    CHECK(f->misses == s && f->evictions == (s > r ? s - r : 0u) && f->invalidates == 1u,
+          "L0 after invalidate: misses %u evictions %u", f->misses, f->evictions);
+
+    /* Preloaded region: counted, no line traffic. */
+    gc_gx_tmem_load_tex(image0(w, h, fmt), line, 0, 0, i1 | (1u << 21), i2);
+    CHECK(f->loads == 2u && f->preloaded == 1u && f->misses == s && f->hits == 0u,
+          "L0 preloaded load touched the cache");
+    return 1;
+}
+
+static int test_L0_rgba8(void) {
+    const uint32_t w = rnd_dim(), h = rnd_dim();
+    const uint32_t s = lines_of(w, h, GC_GX_TF_RGBA8);
+    const uint32_t line = (xorshift32() & 0xFFFFu) * 2u;
+    const GcGxTmemStats *f = &gc_gx_tmem_frame;
+
+    /* 512K banks hold up to 1 MiB of RGBA8: AR tiles even, GB tiles odd. */
+    if (s > 0x8000u) return 1;
+    gc_gx_tmem_reset();
+    gc_gx_tmem_load_tex(image0(w, h, GC_GX_TF_RGBA8), line, 0, 0, bank_reg(0, 5), bank_reg(0x4000, 5));
+    CHECK(f->misses == s && f->evictions == 0u, "L0 RGBA8 %ux%u: misses %u", w, h, f->misses);
+    CHECK(slot_sum(f->slot_misses, 0, 0x4000) == (s + 1u) / 2u &&
+          slot_sum(f->slot_misses, 0x4000, 0x4000) == s / 2u,
+          "L0 RGBA8 %ux%u: even %u odd %u of %u", w, h, slot_sum(f->slot_misses, 0, 0x4000),
+          slot_sum(f->slot_misses, 0x4000, 0x4000), s);
+
+    /* No odd bank: both halves share the even bank. */
+    gc_gx_tmem_reset();
+    gc_gx_tmem_load_tex(image0(w, h, GC_GX_TF_RGBA8), line, 0, 0, bank_reg(0, 5), bank_reg(0, 0));
+    CHECK(f->hits + f->misses == s && slot_sum(f->slot_misses, 0, 0x4000) == f->misses,
+          "L0 RGBA8 without odd bank: %u + %u != %u", f->hits, f->misses, s);
+    return 1;
+}
+
+static int test_L0_mipmap_split(void) {
+    const uint32_t fmt = k_fmts[xorshift32() % 10u];
+    const uint32_t lod = xorshift32() % 11u;
+    const uint32_t line = xorshift32() & 0x1FFFFu;
+    const uint32_t w0 = rnd_dim(), h0 = rnd_dim();
+    uint32_t w = w0, h = h0, even = 0, odd = 0, level;
+    const GcGxTmemStats *f = &gc_gx_tmem_frame;
+
+    for (level = 0; level <= lod; level++) {
+        const uint32_t n = lines_of(w, h, fmt);
+        if (level & 1u) odd += n;
+        else even += n;
+        if (w == 1u && h == 1u) break;
+        w = w > 1u ? w >> 1 : 1u;
+        h = h > 1u ? h >> 1 : 1u;
+    }
+    /* Keys span every level; beyond one bank they would collide. */
+    if (even + odd > 0x4000u) return 1;
+    gc_gx_tmem_reset();
+    gc_gx_tmem_load_tex(image0(w0, h0, fmt), line, (lod * 16u) << 8, 1u, bank_reg(0, 5),
+                        bank_reg(0x4000, 5));
+    CHECK(f->misses == even + odd && f->evictions == 0u,
+          "L0 mip fmt %u %ux%u lod %u: misses %u want %u", fmt, w0, h0, lod, f->misses, even + odd);
+    CHECK(slot_sum(f->slot_misses, 0, 0x4000) == even && slot_sum(f->slot_misses, 0x4000, 0x4000) == odd,
+          "L0 mip fmt %u %ux%u lod %u: even %u/%u odd %u/%u", fmt, w0, h0, lod,
+          slot_sum(f->slot_misses, 0, 0x4000), even, slot_sum(f->slot_misses, 0x4000, 0x4000), odd);
+
+    /* Without mipmapping only level 0 loads. */
+    gc_gx_tmem_reset();
+    gc_gx_tmem_load_tex(image0(w0, h0, fmt), line, (lod * 16u) << 8, 0u, bank_reg(0, 5),
+                        bank_reg(0x4000, 5));
+    CHECK(f->misses == lines_of(w0, h0, fmt), "L0 mip flag clear: misses %u", f->misses);
+    return 1;
+}
+
+static int test_L0_tlut(void) {
+    /* n 32-byte TLUT units at 512-byte offset off; a 512K bank over them. */
+    const uint32_t off = xorshift32() % 1024u;
+    const uint32_t n = 1u + xorshift32() % 64u;
+    const uint32_t first = 0x4000u + off * 16u;
+    const uint32_t last = first + n < GC_GX_TMEM_LINES ? first + n : GC_GX_TMEM_LINES;
+    const GcGxTmemStats *f = &gc_gx_tmem_frame;
+
+    gc_gx_tmem_reset();
+    gc_gx_tmem_load_tlut(off | (n << 10));
+    gc_gx_tmem_invalidate();
+    /* A 1024x512 I8 image fills the 512K bank exactly once. */
+    gc_gx_tmem_load_tex(image0(1024, 512, GC_GX_TF_I8), 0, 0, 0, bank_reg(0x4000, 5), 0);
+    CHECK(f->tlut_loads == 1u && f->tlut_clobbers == last - first && f->evictions == 0u,
+          "L0 TLUT off %u n %u: clobbers %u want %u", off, n, f->tlut_clobbers, last - first);
+
+    /* Preload, invalidate, then a cache fill over the preloaded lines. */
+    gc_gx_tmem_reset();
+    gc_gx_tmem_preload(image0(64, 64, GC_GX_TF_I8), 0, 0, 0, 0x1000u | (1u << 21), 0);
+    gc_gx_tmem_invalidate();
+    gc_gx_tmem_load_tex(image0(1024, 32, GC_GX_TF_I8), 0, 0, 0, bank_reg(0x1000, 3), 0);
+    CHECK(f->preloads == 1u && f->preload_clobbers == 128u && f->misses == 1024u,
+          "L0 preload clobbers %u misses %u", f->preload_clobbers, f->misses);
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L1 — SDK region callbacks and preloading
+ * ═══════════════════════════════════════════════════════════════════ */
+
+#define TEX_ADDR 0x80100000u
+
+static GXTexRegion g_big_region;
+
+static GXTexRegion *big_region_cb(GXTexObj *t_obj, uint32_t unused) {
+    (void)t_obj;
+    (void)unused;
+    return &g_big_region;
+}
+
+static int test_L1_sdk(void) {
+    static GXTexObj tex[9];
+    GXTlutObj tlut;
+    GXTexRegion pre;
+    GXTexRegionCallback old;
+    const uint32_t dim = 8u << (xorshift32() % 4u);  /* 8..64: fits a 32K bank */
+    const uint32_t s = lines_of(dim, dim, GC_GX_TF_I8);
+    const GcGxTmemStats *f = &gc_gx_tmem_frame;
+    uint32_t i;
+
+    GXInit(0, 0);
+    CHECK(f->loads == 0u && gc_gx_tmem_frames == 0u, "L1 GXInit left counters");
+    for (i = 0; i < 8u; i++) {
+        GXInitTexObj(&tex[i], (void *)(uintptr_t)(TEX_ADDR + i * 0x40000u), (uint16_t)dim,
+                     (uint16_t)dim, GC_GX_TF_I8, 0, 0, 0);
+        GXLoadTexObj(&tex[i], i);
+    }
+    CHECK(f->loads == 8u && f->misses == 8u * s && f->hits == 0u && f->evictions == 0u,
+          "L1 first pass %ux%u: misses %u", dim, dim, f->misses);
+    for (i = 0; i < 8u; i++) {
+        CHECK(f->slot_misses[i] == s, "L1 region %u misses %u want %u", i, f->slot_misses[i], s);
+    }
+    /* Round robin lands every texture in its own region again. */
+    for (i = 0; i < 8u; i++) GXLoadTexObj(&tex[i], i);
+    CHECK(f->hits == 8u * s && f->misses == 8u * s, "L1 second pass hits %u", f->hits);
+
+    GXInvalidateTexAll();
+    GXLoadTexObj(&tex[0], 0);
+    CHECK(f->misses == 9u * s && f->invalidates == 1u, "L1 invalidate kept lines");
+
+    /* One 512K region over the default TLUT area: the first fill of a
+     * 1024x1024 I8 image clobbers TLUT 0, the second pass evicts. */
+    GXInitTlutObj(&tlut, (void *)(uintptr_t)TEX_ADDR, 1, 256);
+    GXLoadTlut(&tlut, 0);
+    GXInitTexCacheRegion(&g_big_region, 0, 0x80000u, GX_TEXCACHE_512K, 0, GX_TEXCACHE_NONE);
+    old = GXSetTexRegionCallback(big_region_cb);
+    CHECK(old != NULL, "L1 GXSetTexRegionCallback returned NULL");
+    gc_gx_tmem_end_frame();
+    GXInitTexObj(&tex[8], (void *)(uintptr_t)0x80400000u, 1024, 1024, GC_GX_TF_I8, 0, 0, 0);
+    GXLoadTexObj(&tex[8], 0);
+    CHECK(f->misses == 32768u && f->tlut_clobbers == 16u && f->evictions == 32768u - 16384u,
+          "L1 big region: misses %u clobbers %u evictions %u", f->misses, f->tlut_clobbers,
+          f->evictions);
+    CHECK(slot_sum(f->slot_misses, 0x4000, 0x4000) == 32768u, "L1 big region misses elsewhere");
+    CHECK(GXSetTexRegionCallback(old) == big_region_cb, "L1 callback not returned");
+
+    /* Preload into default region 4's even bank, then a fill through it. */
+    gc_gx_tmem_end_frame();
+    GXInitTexPreLoadRegion(&pre, 0x20000u, 0x1000u, 0xA0000u, 0);
+    GXPreLoadEntireTexture(&tex[0], &pre);
+    GXLoadTexObjPreLoaded(&tex[0], &pre, 1);
+    CHECK(f->preloads == 1u && f->preloaded == 1u && f->misses == 0u,
+          "L1 preloaded load missed %u", f->misses);
+    GXInitTexObj(&tex[8], (void *)(uintptr_t)0x80400000u, 256, 128, GC_GX_TF_I8, 0, 0, 0);
+    for (i = 0; i < 5u; i++) GXLoadTexObj(&tex[8], 0);
+    CHECK(f->preload_clobbers == s, "L1 preload clobbers %u want %u", f->preload_clobbers, s);
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L2 — Frame accounting through GXCopyDisp
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static GcGxTmemStats g_hook_sum;
+static uint32_t g_hook_calls;
+static int g_hook_bad;
+
+static void frame_hook(const GcGxTmemStats *frame) {
+    const uint32_t *src = (const uint32_t *)(const void *)frame;
+    uint32_t *dst = (uint32_t *)(void *)&g_hook_sum;
+    uint32_t i;
+    if (frame != &gc_gx_tmem_last) g_hook_bad = 1;
+    for (i = 0; i < sizeof(GcGxTmemStats) / sizeof(uint32_t); i++) dst[i] += src[i];
+    g_hook_calls++;
+}
+
+static int test_L2_frames(void) {
+    static GXTexObj tex[6];
+    const uint32_t frames = 1u + xorshift32() % 6u;
+    uint32_t fr, i, loads = 0, lines = 0;
+
+    GXInit(0, 0);
+    memset(&g_hook_sum, 0, sizeof(g_hook_sum));
+    g_hook_calls = 0;
+    g_hook_bad = 0;
+    gc_gx_tmem_frame_hook = frame_hook;
+    for (i = 0; i < 6u; i++) {
+        GXInitTexObj(&tex[i], (void *)(uintptr_t)(TEX_ADDR + (xorshift32() & 0xFFFFu) * 32u),
+                     (uint16_t)rnd_dim(), (uint16_t)rnd_dim(), k_fmts[xorshift32() % 10u], 0, 0, 0);
+    }
+    for (fr = 0; fr < frames; fr++) {
+        const uint32_t n = xorshift32() % 12u;
+        for (i = 0; i < n; i++) {
+            const uint32_t t = xorshift32() % 6u;
+            const uint32_t *w = tex[t]._w;
+            /* image0 is word 2 of the SDK object */
+            lines += lines_of((w[2] & 0x3FFu) + 1u, ((w[2] >> 10) & 0x3FFu) + 1u, (w[2] >> 20) & 0xFu);
+            GXLoadTexObj(&tex[t], t);
+            loads++;
+        }
+        if (xorshift32() & 1u) GXInvalidateTexAll();
+        GXCopyDisp((void *)(uintptr_t)0x80300000u, 0);
+        CHECK(gc_gx_tmem_frame.loads == 0u, "L2 frame counters not cleared");
+        CHECK(gc_gx_tmem_last.loads == n, "L2 frame %u: loads %u want %u", fr, gc_gx_tmem_last.loads, n);
+    }
+    gc_gx_tmem_frame_hook = NULL;
+    CHECK(gc_gx_tmem_frames == frames && g_hook_calls == frames && !g_hook_bad,
+          "L2 frames %u hook calls %u want %u", gc_gx_tmem_frames, g_hook_calls, frames);
+    CHECK(memcmp(&g_hook_sum, &gc_gx_tmem_total, sizeof(g_hook_sum)) == 0, "L2 total != sum of frames");
+    CHECK(gc_gx_tmem_total.loads == loads && gc_gx_tmem_total.hits + gc_gx_tmem_total.misses == lines,
+          "L2 total loads %u lines %u want %u %u", gc_gx_tmem_total.loads,
+          gc_gx_tmem_total.hits + gc_gx_tmem_total.misses, loads, lines);
+
+    /* Disabled: nothing is counted and frames do not advance. */
+    GXInit(0, 0);
+    gc_gx_tmem_enable = 0;
+    GXLoadTexObj(&tex[0], 0);
+    GXInvalidateTexAll();
+    GXCopyDisp((void *)(uintptr_t)0x80300000u, 0);
+    gc_gx_tmem_enable = 1;
+    CHECK(gc_gx_tmem_frames == 0u && gc_gx_tmem_frame.loads == 0u && gc_gx_tmem_total.loads == 0u &&
+          gc_gx_tmem_frame.invalidates == 0u, "L2 disabled simulator counted");
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Per-seed runner
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int run_seed(uint32_t seed) {
+    int i;
+    g_rng = seed;
+    if (!g_opt_op || strstr("L0", g_opt_op) || strstr("RANDOM", g_opt_op)) {
+        for (i = 0; i < 8; i++) {
+            if (!test_L0_single()) return 0;
+            if (!test_L0_rgba8()) return 0;
+            if (!test_L0_mipmap_split()) return 0;
+        }
+        if (!test_L0_tlut()) return 0;
+    }
+    if (!g_opt_op || strstr("L1", g_opt_op) || strstr("SDK", g_opt_op)) {
+        if (!test_L1_sdk()) return 0;
+    }
+    if (!g_opt_op || strstr("L2", g_opt_op) || strstr("FRAME", g_opt_op) || strstr("FULL", g_opt_op)) {
+        if (!test_L2_frames()) return 0;
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * main
+ * ═══════════════════════════════════════════════════════════════════ */
+
+int main(int argc, char **argv) {
+    uint32_t start_seed = 1;
+    int num_runs = 100;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+            start_seed = (uint32_t)strtoul(argv[i] + 7, NULL, 0);
+        else if (strncmp(argv[i], "--num-runs=", 11) == 0)
+            num_runs = atoi(argv[i] + 11);
+        else if (strncmp(argv[i], "--op=", 5) == 0)
+            g_opt_op = argv[i] + 5;
+        else if (strcmp(argv[i], "-v") == 0)
+            g_verbose = 1;
+        else {
+            fprintf(stderr,
+                    "Usage: gxtmem_property_test [--seed=N] [--num-runs=N] "
+                    "[--op=L0|L1|L2|RANDOM|SDK|FRAME|FULL] [-v]\n");
+            return 2;
+        }
+    }
+
+    printf("\n=== GX TMEM Property Test ===\n");
+
+    for (i = 0; i < num_runs; i++) {
+        uint32_t seed = start_seed + (uint32_t)i;
+        uint64_t before = g_total_checks;
+
+        if (!run_seed(seed)) {
+            printf("  FAILED at seed %u\n", seed);
+            printf("\n--- Summary ---\n");
+            printf("Seeds:  %d (failed at %d)\n", i + 1, i + 1);
+            printf("Checks: %llu  (pass=%llu  fail=1)\n",
+                   (unsigned long long)g_total_checks,
+                   (unsigned long long)g_total_pass);
+            printf("\nRESULT: FAIL\n");
+            return 1;
+        }
+
+        if (g_verbose) {
+            printf("  seed %u: %llu checks OK\n", seed,
+                   (unsigned long long)(g_total_checks - before));
+        }
+        if ((i + 1) % 100 == 0) {
+            printf("  progress: seed %d/%d\n", i + 1, num_runs);
+        }
+    }
+
+    printf("\n--- Summary ---\n");
+    printf("Seeds:  %d\n", num_runs);
+    printf("Checks: %llu  (pass=%llu  fail=0)\n",
+           (unsigned long long)g_total_checks,
+           (unsigned long long)g_total_pass);
+    printf("\nRESULT: %llu/%llu PASS\n",
+           (unsigned long long)g_total_pass,
+           (unsigned long long)g_total_checks);
+
+    return 0;
+}
@@ -0,0 +1,674 @@
+/*
+ * gxtrace_property_test.c — Property test for .gxtrace capture and replay
+ *
+ * Oracle: the live session — EFB, XFB, EFB-to-texture copy and GP / raster /
+ *         TMEM counters as the SDK calls left them
+ * Port:   gx_trace.c recording the session, then replaying it into fresh
+ *         RAM and GP state without any GX calls
+ *
+ * Levels:
+ *   L0 — One frame of direct quads: replay reproduces EFB, XFB and every
+ *        counter; the record, frame and CMD byte counts agree
+ *   L1 — Multi-frame sessions with indexed vertex arrays, a display list,
+ *        a RAM texture, a texture drawn from the previous frame's EFB copy
+ *        and TMEM loads: replay matches; frames that change no RAM add no
+ *        MEM bytes, one changed vertex adds exactly one 32-byte line
+ *   L2 — Recording started mid-session (GP registers from the GP_STATE
+ *        record); truncated traces and bad headers fail; a trace mapped
+ *        from a file equals the bytes written
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "gc_mem.h"
+#include "gx_gp.h"
+#include "gx_dl.h"
+#include "gx_vtx.h"
+#include "gx_raster.h"
+#include "gx_texcopy.h"
+#include "gx_xfb.h"
+#include "gx_texdec.h"
+#include "gx_tmem.h"
+#include "gx_trace.h"
+
+/* ── xorshift32 PRNG ────────────────────────────────────────────── */
+static uint32_t g_rng;
+static uint32_t xorshift32(void) {
+    uint32_t x = g_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rng = x;
+    return x;
+}
+
+/* ── Counters ───────────────────────────────────────────────────── */
+static uint64_t g_total_checks;
+static uint64_t g_total_pass;
+static int       g_verbose;
+static const char *g_opt_op;
+
+#define CHECK(cond, ...) do { \
+    g_total_checks++; \
+    if (!(cond)) { \
+        printf("FAIL @ %s:%d: ", __FILE__, __LINE__); \
+        printf(__VA_ARGS__); printf("\n"); \
+        return 0; \
+    } \
+    g_total_pass++; \
+} while(0)
+
+/* ── SDK surface (linked from GX.c) ─────────────────────────────── */
+typedef struct { uint8_t r, g, b, a; } GXColor;
+typedef struct { uint8_t _dummy; } GXFifoObj;
+typedef struct { uint32_t _w[8]; } GXTexObj;
+GXFifoObj *GXInit(void *base, uint32_t size);
+void GXClearVtxDesc(void);
+void GXSetVtxDesc(uint32_t attr, uint32_t type);
+void GXSetVtxAttrFmt(uint32_t vtxfmt, uint32_t attr, uint32_t cnt, uint32_t type, uint8_t frac);
+void GXSetArray(uint32_t attr, const void *base_ptr, uint8_t stride);
+void GXBegin(uint8_t type, uint8_t vtxfmt, uint16_t nverts);
+void GXEnd(void);
+void GXPosition1x16(uint16_t idx);
+void GXPosition3f32(float x, float y, float z);
+void GXColor4u8(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+void GXTexCoord2f32(float s, float t);
+void GXLoadPosMtxImm(float mtx[3][4], uint32_t id);
+void GXLoadTexMtxImm(float mtx[][4], uint32_t id, uint32_t type);
+void GXSetCurrentMtx(uint32_t id);
+void GXSetProjection(float mtx[4][4], uint32_t type);
+void GXSetViewport(float left, float top, float wd, float ht, float nearz, float farz);
+void GXSetScissor(uint32_t left, uint32_t top, uint32_t wd, uint32_t ht);
+void GXSetCullMode(uint32_t mode);
+void GXSetNumChans(uint8_t n);
+void GXSetNumTexGens(uint8_t n);
+void GXSetTexCoordGen2(uint8_t dst_coord, uint32_t func, uint32_t src_param, uint32_t mtx,
+                       uint8_t normalize, uint32_t postmtx);
+void GXSetChanCtrl(uint32_t chan, uint8_t enable, uint32_t amb_src, uint32_t mat_src,
+                   uint32_t light_mask, uint32_t diff_fn, uint32_t attn_fn);
+void GXSetNumTevStages(uint8_t n);
+void GXSetTevOrder(uint32_t stage, uint32_t coord, uint32_t map, uint32_t color);
+void GXSetTevOp(uint32_t stage, uint32_t mode);
+void GXSetTevSwapModeTable(uint32_t table, uint32_t r, uint32_t g, uint32_t b, uint32_t a);
+void GXSetTevSwapMode(uint32_t stage, uint32_t ras_sel, uint32_t tex_sel);
+void GXSetZMode(uint8_t enable, uint32_t func, uint8_t update);
+void GXSetBlendMode(uint32_t type, uint32_t src, uint32_t dst, uint32_t op);
+void GXSetColorUpdate(uint8_t enable);
+void GXSetAlphaUpdate(uint8_t enable);
+void GXSetAlphaCompare(uint32_t comp0, uint8_t ref0, uint32_t op, uint32_t comp1, uint8_t ref1);
+void GXSetPixelFmt(uint32_t pix_fmt, uint32_t z_fmt);
+void GXSetDrawDone(void);
+void GXBeginDisplayList(void *list, uint32_t size);
+uint32_t GXEndDisplayList(void);
+void GXCallDisplayList(const void *list, uint32_t nbytes);
+void GXInitTexObj(GXTexObj *obj, void *image_ptr, uint16_t width, uint16_t height, uint32_t format,
+                  uint32_t wrap_s, uint32_t wrap_t, uint8_t mipmap);
+void GXInitTexObjLOD(GXTexObj *obj, uint32_t min_filt, uint32_t mag_filt, float min_lod,
+                     float max_lod, float lod_bias, uint8_t bias_clamp, uint8_t do_edge_lod,
+                     uint32_t max_aniso);
+void GXLoadTexObj(GXTexObj *obj, uint32_t id);
+void GXInvalidateTexAll(void);
+void GXSetTexCopySrc(uint16_t left, uint16_t top, uint16_t wd, uint16_t ht);
+void GXSetTexCopyDst(uint16_t wd, uint16_t ht, uint32_t fmt, uint32_t mipmap);
+void GXCopyTex(void *dest, uint32_t clear);
+void GXSetDispCopySrc(uint16_t left, uint16_t top, uint16_t wd, uint16_t ht);
+void GXSetDispCopyDst(uint16_t wd, uint16_t ht);
+uint32_t GXSetDispCopyYScale(float vscale);
+void GXSetCopyClear(GXColor clear_clr, uint32_t clear_z);
+void GXCopyDisp(void *dest, uint8_t clear);
+void DCFlushRange(void *addr, uint32_t nbytes);
+
+/* ── Emulated RAM ───────────────────────────────────────────────── */
+#define RAM_BASE   0x80000000u
+#define RAM_SIZE   0x01800000u
+#define ARRAY_ADDR 0x80200000u
+#define DL_ADDR    0x80210000u
+#define TEX_ADDR   0x80300000u
+#define COPY_ADDR  0x80400000u
+#define XFB_ADDR   0x80600000u
+
+#define DL_SIZE    0x400u
+#define XFB_BYTES  (640u * 2u * 480u)
+#define POS_STRIDE 8u
+#define MAX_POS    96u
+
+static uint8_t *g_ram;
+
+static void ram_init(void) {
+    if (!g_ram) g_ram = (uint8_t *)calloc(1, RAM_SIZE);
+    gc_mem_set(RAM_BASE, RAM_SIZE, g_ram);
+}
+
+static uint8_t *ram(uint32_t addr) { return g_ram + (addr - RAM_BASE); }
+
+/* Fresh RAM, as a replay process would start. */
+static void ram_wipe(void) {
+    memset(g_ram, 0, RAM_SIZE);
+    gc_mem_notify_write(RAM_BASE, RAM_SIZE);
+}
+
+/* ── Session state ──────────────────────────────────────────────── */
+typedef struct {
+    uint32_t efb_clear;
+    uint32_t npos;                 /* indexed positions (multiple of 3) */
+    uint32_t tw, th;               /* RAM texture and EFB copy size */
+    uint32_t dl_size;
+    uint32_t textured, indexed, use_dl;
+} Session;
+
+/* What a session leaves behind: the oracle for the replay. */
+typedef struct {
+    uint32_t draws, verts, bp_writes, cp_writes, xf_writes;
+    uint32_t tris, texcopies, xfb_copies, tmem_frames;
+    uint64_t written, pixels, texels;
+    GcGxTmemStats tmem;
+} Result;
+
+static uint32_t g_efb_color[GC_GX_EFB_WIDTH * GC_GX_EFB_HEIGHT];
+static uint32_t g_efb_depth[GC_GX_EFB_WIDTH * GC_GX_EFB_HEIGHT];
+static uint8_t g_xfb[XFB_BYTES];
+static uint8_t g_copy[256u * 256u * 4u];
+
+static int efb_ready(uint32_t clear) {
+    if (!gc_gx_efb.color && !gc_gx_raster_efb_init(&gc_gx_efb)) return 0;
+    gc_gx_raster_clear(&gc_gx_efb, clear, 0xFFFFFFu);
+    return 1;
+}
+
+static uint32_t copy_bytes(const Session *s) { return ((s->tw + 3u) / 4u) * ((s->th + 3u) / 4u) * 64u; }
+
+static void result_take(Result *r, const uint32_t texcopies0, const uint32_t xfb_copies0) {
+    r->draws = gc_gx_gp.draws;
+    r->verts = gc_gx_gp.verts;
+    r->bp_writes = gc_gx_gp.bp_writes;
+    r->cp_writes = gc_gx_gp.cp_writes;
+    r->xf_writes = gc_gx_gp.xf_writes;
+    r->tris = gc_gx_raster_stats.tris;
+    r->written = gc_gx_raster_stats.written;
+    r->pixels = gc_gx_raster_stats.pixels;
+    r->texels = gc_gx_raster_stats.texels;
+    r->texcopies = gc_gx_texcopy_copies - texcopies0;
+    r->xfb_copies = gc_gx_xfb_copies - xfb_copies0;
+    r->tmem = gc_gx_tmem_total;
+    r->tmem_frames = gc_gx_tmem_frames;
+}
+
+static void snapshot(const Session *s) {
+    memcpy(g_efb_color, gc_gx_efb.color, sizeof(g_efb_color));
+    memcpy(g_efb_depth, gc_gx_efb.depth, sizeof(g_efb_depth));
+    memcpy(g_xfb, ram(XFB_ADDR), XFB_BYTES);
+    memcpy(g_copy, ram(COPY_ADDR), copy_bytes(s));
+}
+
+static void sdk_setup(void) {
+    float pm[3][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 } };
+    float tm[2][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 } };
+    float proj[4][4] = { { 2.0f / 640.0f, 0, 0, -1 }, { 0, -2.0f / 480.0f, 0, 1 },
+                         { 0, 0, -1, -1 }, { 0, 0, 0, 1 } };
+
+    GXLoadPosMtxImm(pm, 0);
+    GXLoadTexMtxImm(tm, 60 /* GX_IDENTITY */, 1 /* GX_MTX2x4 */);
+    GXSetCurrentMtx(0);
+    GXSetProjection(proj, 1);
+    GXSetViewport(0.0f, 0.0f, 640.0f, 480.0f, 0.0f, 1.0f);
+    GXSetScissor(0, 0, 640, 480);
+    GXSetChanCtrl(4 /* GX_COLOR0A0 */, 0, 0, 1 /* mat vtx */, 0, 0, 2);
+    GXSetTexCoordGen2(0, 1 /* GX_TG_MTX2x4 */, 4 /* GX_TG_TEX0 */, 60, 0, 125);
+    GXSetNumTevStages(1);
+    GXSetTevSwapModeTable(0, 0, 1, 2, 3);
+    GXSetTevSwapMode(0, 0, 0);
+    GXSetZMode(1, 3 /* GX_LEQUAL */, 1);
+    GXSetBlendMode(0, 4, 5, 0);
+    GXSetColorUpdate(1);
+    GXSetAlphaUpdate(1);
+    GXSetAlphaCompare(7, 0, 0, 7, 0);
+    GXSetPixelFmt(0 /* GX_PF_RGB8_Z24 */, 0);
+    GXSetCullMode(0);
+    GXSetVtxAttrFmt(0, 9, 1, 4 /* GX_F32 */, 0);
+    GXSetVtxAttrFmt(0, 11, 1, 5 /* GX_RGBA8 */, 0);
+    GXSetVtxAttrFmt(0, 13, 1, 4 /* GX_F32 */, 0);
+    GXSetVtxAttrFmt(1, 9, 1, 3 /* GX_S16 */, 0);
+    GXSetVtxAttrFmt(1, 11, 1, 5 /* GX_RGBA8 */, 0);
+}
+
+/* POS + CLR0 direct, vertex colors straight through. */
+static void mode_color(void) {
+    GXSetNumChans(1);
+    GXSetNumTexGens(0);
+    GXSetTevOrder(0, 0xFF, 0xFF, 4 /* GX_COLOR0A0 */);
+    GXSetTevOp(0, 4 /* GX_PASSCLR */);
+    GXClearVtxDesc();
+    GXSetVtxDesc(9, 1);
+    GXSetVtxDesc(11, 1);
+}
+
+static void color_quad(float x, float y, float w, float h, float z, uint32_t c) {
+    const float xs[4] = { x, x + w, x + w, x }, ys[4] = { y, y, y + h, y + h };
+    uint32_t i;
+    GXBegin(0x80, 0, 4);
+    for (i = 0; i < 4u; i++) {
+        GXPosition3f32(xs[i], ys[i], z);
+        GXColor4u8((uint8_t)(c >> 24), (uint8_t)(c >> 16), (uint8_t)(c >> 8), 0xFF);
+    }
+    GXEnd();
+}
+
+static void tex_quad(uint32_t image, const Session *s, float x, float y, float z) {
+    const float w = (float)s->tw, h = (float)s->th;
+    const float xs[4] = { x, x + w, x + w, x }, ys[4] = { y, y, y + h, y + h };
+    const float ss[4] = { 0, 1, 1, 0 }, ts[4] = { 0, 0, 1, 1 };
+    GXTexObj tex;
+    uint32_t i;
+
+    GXSetNumChans(0);
+    GXSetNumTexGens(1);
+    GXSetTevOrder(0, 0 /* GX_TEXCOORD0 */, 0 /* GX_TEXMAP0 */, 0xFF);
+    GXSetTevOp(0, 3 /* GX_REPLACE */);
+    GXClearVtxDesc();
+    GXSetVtxDesc(9, 1);
+    GXSetVtxDesc(13, 1);
+    GXInitTexObj(&tex, (void *)(uintptr_t)image, (uint16_t)s->tw, (uint16_t)s->th, GC_GX_TF_RGBA8,
+                 0, 0, 0);
+    GXInitTexObjLOD(&tex, 0 /* GX_NEAR */, 0 /* GX_NEAR */, 0, 0, 0, 0, 0, 0);
+    GXLoadTexObj(&tex, 0);
+    GXBegin(0x80, 0, 4);
+    for (i = 0; i < 4u; i++) {
+        GXPosition3f32(xs[i], ys[i], z);
+        GXTexCoord2f32(ss[i], ts[i]);
+    }
+    GXEnd();
+}
+
+static void session_init(Session *s) {
+    uint32_t i;
+    s->efb_clear = xorshift32() | 0xFFu;
+    s->npos = 3u * (1u + xorshift32() % (MAX_POS / 3u));
+    s->tw = 4u + xorshift32() % 120u;
+    s->th = 4u + xorshift32() % 120u;
+    s->textured = xorshift32() & 1u;
+    s->indexed = xorshift32() & 1u;
+    s->use_dl = xorshift32() & 1u;
+    s->dl_size = 0;
+    for (i = 0; i < s->npos; i++) {
+        uint8_t *p = ram(ARRAY_ADDR + i * POS_STRIDE);
+        const uint32_t x = xorshift32() % 640u, y = xorshift32() % 480u;
+        p[0] = (uint8_t)(x >> 8); p[1] = (uint8_t)x;
+        p[2] = (uint8_t)(y >> 8); p[3] = (uint8_t)y;
+        p[4] = 0xFF; p[5] = 0xF0;            /* z = -16 */
+    }
+    for (i = 0; i < copy_bytes(s); i++) ram(TEX_ADDR)[i] = (uint8_t)xorshift32();
+    DCFlushRange((void *)(uintptr_t)ARRAY_ADDR, s->npos * POS_STRIDE);
+    DCFlushRange((void *)(uintptr_t)TEX_ADDR, copy_bytes(s));
+}
+
+/* GXInit and the per-session setup; the display list is built here. */
+static void session_begin(Session *s) {
+    GXInit(0, 0);
+    sdk_setup();
+    if (s->use_dl) {
+        mode_color();
+        GXBeginDisplayList((void *)(uintptr_t)DL_ADDR, DL_SIZE);
+        color_quad(300.0f, 200.0f, 120.0f, 90.0f, -0.3f, 0x20C040FFu);
+        s->dl_size = GXEndDisplayList();
+    }
+}
+
+/* One frame; frame > 0 may draw the previous frame's EFB copy. */
+static void session_frame(const Session *s, uint32_t frame) {
+    const uint32_t nq = 1u + xorshift32() % 6u;
+    const GXColor clear = { (uint8_t)(s->efb_clear >> 24), (uint8_t)(s->efb_clear >> 16),
+                            (uint8_t)(s->efb_clear >> 8), 0xFF };
+    uint32_t i;
+
+    mode_color();
+    for (i = 0; i < nq; i++) {
+        color_quad((float)(xorshift32() % 560u), (float)(xorshift32() % 420u),
+                   (float)(1u + xorshift32() % 80u), (float)(1u + xorshift32() % 60u),
+                   -(float)(xorshift32() % 1000u) / 1000.0f, xorshift32());
+    }
+    if (s->indexed) {
+        GXClearVtxDesc();
+        GXSetVtxDesc(9, 3 /* GX_INDEX16 */);
+        GXSetVtxDesc(11, 1);
+        GXSetArray(9, (void *)(uintptr_t)ARRAY_ADDR, (uint8_t)POS_STRIDE);
+        GXBegin(0x90 /* GX_TRIANGLES */, 1, (uint16_t)s->npos);
+        for (i = 0; i < s->npos; i++) {
+            GXPosition1x16((uint16_t)i);
+            GXColor4u8((uint8_t)(i * 37u), (uint8_t)(i * 11u), 0x80, 0xFF);
+        }
+        GXEnd();
+    }
+    if (s->use_dl) {
+        mode_color();
+        GXCallDisplayList((void *)(uintptr_t)DL_ADDR, s->dl_size);
+    }
+    if (s->textured) {
+        if (xorshift32() & 1u) GXInvalidateTexAll();
+        tex_quad(TEX_ADDR, s, (float)(xorshift32() % 500u), (float)(xorshift32() % 340u), -0.2f);
+        if (frame) tex_quad(COPY_ADDR, s, 10.0f, 10.0f, -0.1f);
+        GXSetTexCopySrc(0, 0, (uint16_t)s->tw, (uint16_t)s->th);
+        GXSetTexCopyDst((uint16_t)s->tw, (uint16_t)s->th, GC_GX_TF_RGBA8, 0);
+        GXCopyTex((void *)(uintptr_t)COPY_ADDR, 0);
+    }
+    GXSetDrawDone();
+    GXSetDispCopySrc(0, 0, 640, 480);
+    GXSetDispCopyDst(640, 480);
+    GXSetDispCopyYScale(1.0f);
+    GXSetCopyClear(clear, 0xFFFFFFu);
+    GXCopyDisp((void *)(uintptr_t)XFB_ADDR, 1);
+}
+
+/* ── Trace buffer ───────────────────────────────────────────────── */
+static uint8_t *g_trace;
+static size_t g_trace_size;
+
+static int trace_begin(FILE **f) {
+    *f = tmpfile();
+    return *f && gc_gx_trace_record_start(*f) == 0;
+}
+
+static int trace_end(FILE *f) {
+    long n;
+    gc_gx_trace_record_stop();
+    free(g_trace);
+    g_trace = NULL;
+    g_trace_size = 0;
+    if (fseek(f, 0, SEEK_END) != 0 || (n = ftell(f)) <= 0 || fseek(f, 0, SEEK_SET) != 0) {
+        fclose(f);
+        return 0;
+    }
+    g_trace = (uint8_t *)malloc((size_t)n);
+    if (g_trace && fread(g_trace, 1, (size_t)n, f) == (size_t)n) g_trace_size = (size_t)n;
+    fclose(f);
+    return g_trace_size != 0;
+}
+
+/* Fresh process: wiped RAM, reset GP modules, the same EFB start. */
+static int replay(const Session *s, GcGxTraceStats *st, Result *r) {
+    const uint32_t tc0 = gc_gx_texcopy_copies, xc0 = gc_gx_xfb_copies;
+    int ok;
+    ram_wipe();
+    gc_gx_gp_reset();
+    gc_gx_dl_cache_reset();
+    gc_gx_vtx_reset();
+    gc_gx_raster_reset();
+    gc_gx_tmem_reset();
+    if (!efb_ready(s->efb_clear)) return 0;
+    ok = gc_gx_trace_replay(g_trace, g_trace_size, st);
+    gc_gx_raster_flush();
+    result_take(r, tc0, xc0);
+    return ok;
+}
+
+static int check_match(const char *lvl, const Session *s, const Result *live, const Result *rep) {
+    uint32_t i, bad = ~0u;
+    for (i = 0; i < GC_GX_EFB_WIDTH * GC_GX_EFB_HEIGHT; i++) {
+        if (gc_gx_efb.color[i] != g_efb_color[i] || gc_gx_efb.depth[i] != g_efb_depth[i]) {
+            bad = i;
+            break;
+        }
+    }
+    CHECK(bad == ~0u, "%s EFB differs at (%u,%u): %08X/%06X != %08X/%06X", lvl,
+          bad % GC_GX_EFB_WIDTH, bad / GC_GX_EFB_WIDTH, gc_gx_efb.color[bad], gc_gx_efb.depth[bad],
+          g_efb_color[bad], g_efb_depth[bad]);
+    CHECK(memcmp(ram(XFB_ADDR), g_xfb, XFB_BYTES) == 0, "%s XFB differs", lvl);
+    CHECK(!s->textured || memcmp(ram(COPY_ADDR), g_copy, copy_bytes(s)) == 0,
+          "%s EFB copy differs (%ux%u)", lvl, s->tw, s->th);
+    CHECK(rep->draws == live->draws && rep->verts == live->verts, "%s draws/verts %u/%u != %u/%u", lvl,
+          rep->draws, rep->verts, live->draws, live->verts);
+    CHECK(rep->bp_writes == live->bp_writes && rep->cp_writes == live->cp_writes &&
+          rep->xf_writes == live->xf_writes,
+          "%s bp/cp/xf writes %u/%u/%u != %u/%u/%u", lvl, rep->bp_writes, rep->cp_writes,
+          rep->xf_writes, live->bp_writes, live->cp_writes, live->xf_writes);
+    CHECK(rep->tris == live->tris && rep->written == live->written && rep->pixels == live->pixels &&
+          rep->texels == live->texels,
+          "%s raster tris %u written %llu != %u %llu", lvl, rep->tris,
+          (unsigned long long)rep->written, live->tris, (unsigned long long)live->written);
+    CHECK(rep->texcopies == live->texcopies && rep->xfb_copies == live->xfb_copies,
+          "%s copies %u/%u != %u/%u", lvl, rep->texcopies, rep->xfb_copies, live->texcopies,
+          live->xfb_copies);
+    CHECK(rep->tmem_frames == live->tmem_frames && memcmp(&rep->tmem, &live->tmem, sizeof(rep->tmem)) == 0,
+          "%s TMEM stats differ (%u/%u loads, %u/%u misses)", lvl, rep->tmem.loads, live->tmem.loads,
+          rep->tmem.misses, live->tmem.misses);
+    return 1;
+}
+
+static int check_stats(const char *lvl, const GcGxTraceStats *st, uint32_t frames) {
+    const GcGxTraceStats *rec = &gc_gx_trace_recorded;
+    CHECK(st->records == rec->records, "%s records %u != recorded %u", lvl, st->records, rec->records);
+    CHECK(st->frames == frames && rec->frames == frames, "%s frames %u/%u != %u", lvl, st->frames,
+          rec->frames, frames);
+    CHECK(st->cmd_bytes == rec->cmd_bytes && st->mem_bytes == rec->mem_bytes,
+          "%s cmd/mem bytes %llu/%llu != %llu/%llu", lvl, (unsigned long long)st->cmd_bytes,
+          (unsigned long long)st->mem_bytes, (unsigned long long)rec->cmd_bytes,
+          (unsigned long long)rec->mem_bytes);
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L0: one frame of direct quads
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L0_frame(void) {
+    Session s;
+    Result live, rep;
+    GcGxTraceStats st;
+    FILE *f;
+    uint32_t tc0, xc0;
+
+    session_init(&s);
+    s.textured = s.indexed = s.use_dl = 0;
+    CHECK(efb_ready(s.efb_clear), "L0 efb alloc failed");
+    tc0 = gc_gx_texcopy_copies;
+    xc0 = gc_gx_xfb_copies;
+    CHECK(trace_begin(&f), "L0 cannot start recording");
+    session_begin(&s);
+    session_frame(&s, 0);
+    CHECK(trace_end(f), "L0 empty trace");
+    result_take(&live, tc0, xc0);
+    snapshot(&s);
+
+    CHECK(gc_gx_trace_recorded.resets == 1u, "L0 resets %u", gc_gx_trace_recorded.resets);
+    CHECK(gc_gx_trace_recorded.mem_bytes == 0u, "L0 %llu MEM bytes without RAM reads",
+          (unsigned long long)gc_gx_trace_recorded.mem_bytes);
+    CHECK(replay(&s, &st, &rep), "L0 replay failed");
+    CHECK(st.resets == 1u, "L0 replayed resets %u", st.resets);
+    if (!check_stats("L0", &st, 1u)) return 0;
+    return check_match("L0", &s, &live, &rep);
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L1: multi-frame sessions, RAM reads and line dedup
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L1_session(void) {
+    const uint32_t frames = 2u + xorshift32() % 3u;
+    Session s;
+    Result live, rep;
+    GcGxTraceStats st;
+    FILE *f;
+    uint32_t tc0, xc0, fr;
+
+    session_init(&s);
+    if (!s.indexed && !s.use_dl && !s.textured) s.indexed = 1;
+    CHECK(efb_ready(s.efb_clear), "L1 efb alloc failed");
+    tc0 = gc_gx_texcopy_copies;
+    xc0 = gc_gx_xfb_copies;
+    CHECK(trace_begin(&f), "L1 cannot start recording");
+    session_begin(&s);
+    for (fr = 0; fr < frames; fr++) {
+        const uint64_t mem0 = gc_gx_trace_recorded.mem_bytes;
+        uint32_t want = 0;
+        if (fr && s.indexed && (xorshift32() & 1u)) {
+            /* Move one position: one array line differs from the trace. */
+            uint8_t *p = ram(ARRAY_ADDR + (xorshift32() % s.npos) * POS_STRIDE);
+            p[1] ^= 1u;
+            DCFlushRange(p, 2);
+            want = 32u;
+        }
+        session_frame(&s, fr);
+        if (fr) {
+            CHECK(gc_gx_trace_recorded.mem_bytes - mem0 == want,
+                  "L1 frame %u: %llu MEM bytes != %u (indexed %u dl %u tex %u)", fr,
+                  (unsigned long long)(gc_gx_trace_recorded.mem_bytes - mem0), want, s.indexed,
+                  s.use_dl, s.textured);
+        } else {
+            CHECK(gc_gx_trace_recorded.mem_bytes > 0u, "L1 first frame stored no RAM");
+        }
+    }
+    CHECK(trace_end(f), "L1 empty trace");
+    result_take(&live, tc0, xc0);
+    snapshot(&s);
+
+    CHECK(replay(&s, &st, &rep), "L1 replay failed");
+    if (!check_stats("L1", &st, frames)) return 0;
+    return check_match("L1", &s, &live, &rep);
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L2: mid-session start, malformed traces, mapping
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L2_edges(void) {
+    Session s;
+    Result live, rep;
+    GcGxTraceStats st;
+    FILE *f;
+    uint32_t tc0, xc0, draws0, cut;
+    char path[] = "/tmp/gxtrace_XXXXXX";
+    const uint8_t *map;
+    size_t map_size = 0;
+    int fd;
+
+    session_init(&s);
+    CHECK(efb_ready(s.efb_clear), "L2 efb alloc failed");
+    session_begin(&s);
+    GXSetDrawDone();
+    tc0 = gc_gx_texcopy_copies;
+    xc0 = gc_gx_xfb_copies;
+    draws0 = gc_gx_gp.draws;
+    CHECK(trace_begin(&f), "L2 cannot start recording");
+    session_frame(&s, 0);
+    CHECK(trace_end(f), "L2 empty trace");
+    result_take(&live, tc0, xc0);
+    live.draws -= draws0;
+    snapshot(&s);
+    CHECK(gc_gx_trace_recorded.resets == 0u, "L2 reset recorded without GXInit");
+
+    CHECK(replay(&s, &st, &rep), "L2 replay failed");
+    CHECK(rep.draws == live.draws, "L2 draws %u != %u", rep.draws, live.draws);
+    {
+        uint32_t i, bad = 0;
+        for (i = 0; i < GC_GX_EFB_WIDTH * GC_GX_EFB_HEIGHT && !bad; i++)
+            bad = gc_gx_efb.color[i] != g_efb_color[i] || gc_gx_efb.depth[i] != g_efb_depth[i];
+        CHECK(!bad, "L2 mid-session EFB differs at %u", i - 1u);
+    }
+    CHECK(memcmp(ram(XFB_ADDR), g_xfb, XFB_BYTES) == 0, "L2 mid-session XFB differs");
+
+    /* A cut anywhere past the header leaves a truncated record or padding. */
+    cut = 1u + xorshift32() % 3u;
+    CHECK(gc_gx_trace_replay(g_trace, g_trace_size - cut, &st) == 0, "L2 truncated trace accepted");
+    CHECK(st.frames == 0u, "L2 truncated trace ran its COPY_DISP");
+    g_trace[xorshift32() % 4u] ^= 0x20u;
+    CHECK(gc_gx_trace_replay(g_trace, g_trace_size, &st) == 0 && st.records == 0u,
+          "L2 bad magic accepted");
+    CHECK(gc_gx_trace_replay(g_trace, 15u, &st) == 0, "L2 short header accepted");
+
+    fd = mkstemp(path);
+    CHECK(fd >= 0, "L2 mkstemp failed");
+    CHECK(write(fd, g_trace, g_trace_size) == (ssize_t)g_trace_size, "L2 write failed");
+    close(fd);
+    map = gc_gx_trace_map(path, &map_size);
+    unlink(path);
+    CHECK(map && map_size == g_trace_size && memcmp(map, g_trace, g_trace_size) == 0,
+          "L2 mapped trace differs (%zu != %zu bytes)", map_size, g_trace_size);
+    gc_gx_trace_unmap(map, map_size);
+    CHECK(gc_gx_trace_map("/nonexistent/trace.gxtrace", &map_size) == NULL, "L2 mapped a missing file");
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Per-seed runner
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int run_seed(uint32_t seed) {
+    g_rng = seed;
+    ram_init();
+    if (!g_opt_op || strstr("L0", g_opt_op) || strstr("FRAME", g_opt_op)) {
+        if (!test_L0_frame()) return 0;
+    }
+    if (!g_opt_op || strstr("L1", g_opt_op) || strstr("SESSION", g_opt_op)) {
+        if (!test_L1_session()) return 0;
+    }
+    if (!g_opt_op || strstr("L2", g_opt_op) || strstr("EDGES", g_opt_op) || strstr("FULL", g_opt_op)) {
+        if (!test_L2_edges()) return 0;
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * main
+ * ═══════════════════════════════════════════════════════════════════ */
+
+int main(int argc, char **argv) {
+    uint32_t start_seed = 1;
+    int num_runs = 100;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+            start_seed = (uint32_t)strtoul(argv[i] + 7, NULL, 0);
+        else if (strncmp(argv[i], "--num-runs=", 11) == 0)
+            num_runs = atoi(argv[i] + 11);
+        else if (strncmp(argv[i], "--op=", 5) == 0)
+            g_opt_op = argv[i] + 5;
+        else if (strcmp(argv[i], "-v") == 0)
+            g_verbose = 1;
+        else {
+            fprintf(stderr,
+                    "Usage: gxtrace_property_test [--seed=N] [--num-runs=N] "
+                    "[--op=L0|L1|L2|FRAME|SESSION|EDGES|FULL] [-v]\n");
+            return 2;
+        }
+    }
+
+    printf("\n=== GX Trace Property Test ===\n");
+
+    for (i = 0; i < num_runs; i++) {
+        uint32_t seed = start_seed + (uint32_t)i;
+        uint64_t before = g_total_checks;
+
+        if (!run_seed(seed)) {
+            printf("  FAILED at seed %u\n", seed);
+            printf("\n--- Summary ---\n");
+            printf("Seeds:  %d (failed at %d)\n", i + 1, i + 1);
+            printf("Checks: %llu  (pass=%llu  fail=1)\n",
+                   (unsigned long long)g_total_checks,
+                   (unsigned long long)g_total_pass);
+            printf("\nRESULT: FAIL\n");
+            return 1;
+        }
+
+        if (g_verbose) {
+            printf("  seed %u: %llu checks OK\n", seed,
+                   (unsigned long long)(g_total_checks - before));
+        }
+        if ((i + 1) % 100 == 0) {
+            printf("  progress: seed %d/%d\n", i + 1, num_runs);
+        }
+    }
+
+    printf("\n--- Summary ---\n");
+    printf("Seeds:  %d\n", num_runs);
+    printf("Checks: %llu  (pass=%llu  fail=0)\n",
+           (unsigned long long)g_total_checks,
+           (unsigned long long)g_total_pass);
+    printf("\nRESULT: %llu/%llu PASS\n",
+           (unsigned long long)g_total_pass,
+           (unsigned long long)g_total_checks);
+    return 0;
+}
@@ -0,0 +1,358 @@
+/*
+ * gxvtx_property_test.c — Property test for the software vertex loader
+ *
+ * Oracle: gc_gx_vtx_decode_ref (per-vertex scalar decode)
+ * Port:   gc_gx_vtx_decode (cached per-config loader, vectorized dequant)
+ *
+ * Levels:
+ *   L0 — Random VCD/VAT/array configs + random vertex bytes: bit-exact planes
+ *   L1 — SDK path: GXSetVtxDesc/GXSetVtxAttrFmt/GXSetArray + GXBegin..GXEnd
+ *        lands the expected dequantized values in gc_gx_vtx
+ *   L2 — Loader cache: repeat configs hit, eviction keeps results exact
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "gc_mem.h"
+#include "gx_gp.h"
+#include "gx_vtx.h"
+
+/* ── xorshift32 PRNG ────────────────────────────────────────────── */
+static uint32_t g_rng;
+static uint32_t xorshift32(void) {
+    uint32_t x = g_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rng = x;
+    return x;
+}
+
+/* ── Counters ───────────────────────────────────────────────────── */
+static uint64_t g_total_checks;
+static uint64_t g_total_pass;
+static int       g_verbose;
+static const char *g_opt_op;
+
+#define CHECK(cond, ...) do { \
+    g_total_checks++; \
+    if (!(cond)) { \
+        printf("FAIL @ %s:%d: ", __FILE__, __LINE__); \
+        printf(__VA_ARGS__); printf("\n"); \
+        return 0; \
+    } \
+    g_total_pass++; \
+} while(0)
+
+/* ── SDK surface (linked from GX.c) ─────────────────────────────── */
+typedef struct { uint8_t _dummy; } GXFifoObj;
+GXFifoObj *GXInit(void *base, uint32_t size);
+void GXClearVtxDesc(void);
+void GXSetVtxDesc(uint32_t attr, uint32_t type);
+void GXSetVtxAttrFmt(uint32_t vtxfmt, uint32_t attr, uint32_t cnt, uint32_t type, uint8_t frac);
+void GXSetArray(uint32_t attr, const void *base_ptr, uint8_t stride);
+void GXBegin(uint8_t type, uint8_t vtxfmt, uint16_t nverts);
+void GXEnd(void);
+void GXPosition3s16(int16_t x, int16_t y, int16_t z);
+void GXPosition1x16(uint16_t idx);
+void GXNormal3s16(int16_t x, int16_t y, int16_t z);
+void GXColor4u8(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+void GXTexCoord2s16(int16_t s, int16_t t);
+
+/* ── Emulated RAM ───────────────────────────────────────────────── */
+#define RAM_BASE   0x80000000u
+#define RAM_SIZE   0x01800000u
+#define ARRAY_AREA 0x00200000u  /* physical; 16 arrays x 64 KiB */
+#define ARRAY_SLOT 0x10000u
+
+static uint8_t *g_ram;
+
+static void ram_init(void) {
+    if (!g_ram) g_ram = (uint8_t *)calloc(1, RAM_SIZE);
+    gc_mem_set(RAM_BASE, RAM_SIZE, g_ram);
+}
+
+static uint8_t *ram(uint32_t addr) { return gc_mem_ptr(addr, 1); }
+
+static void put16be(uint8_t *p, uint32_t v) { p[0] = (uint8_t)(v >> 8); p[1] = (uint8_t)v; }
+
+/* ── Helpers ────────────────────────────────────────────────────── */
+static GcGxVtxBuf g_ref;
+static uint8_t g_data[64 * 128];
+
+static void random_config(uint32_t *cp, uint32_t fmt) {
+    uint32_t i, vcd_lo = 0, vcd_hi = 0;
+    for (i = 0; i < 9; i++) {
+        if ((xorshift32() & 7u) == 0) vcd_lo |= 1u << i;
+    }
+    vcd_lo |= (1u + xorshift32() % 3u) << 9;                 /* POS always present */
+    for (i = 11; i < 17; i += 2) vcd_lo |= (xorshift32() & 3u) << i;
+    for (i = 0; i < 8; i++) {
+        if (xorshift32() & 1u) vcd_hi |= (xorshift32() & 3u) << (i * 2u);
+    }
+    cp[GC_GX_CP_VCD_LO] = vcd_lo;
+    cp[GC_GX_CP_VCD_HI] = vcd_hi;
+    cp[GC_GX_CP_VAT_A + fmt] = xorshift32();
+    cp[GC_GX_CP_VAT_B + fmt] = xorshift32();
+    cp[GC_GX_CP_VAT_C + fmt] = xorshift32();
+    for (i = 0; i < 12; i++) {
+        cp[GC_GX_CP_ARRAY_BASE + i] = ARRAY_AREA + i * ARRAY_SLOT;
+        cp[GC_GX_CP_ARRAY_STRIDE + i] = 1u + (xorshift32() % 48u);
+    }
+}
+
+static void fill_arrays(void) {
+    uint8_t *p = ram(RAM_BASE | ARRAY_AREA);
+    uint32_t i;
+    for (i = 0; i < 12u * ARRAY_SLOT; i += 4) {
+        const uint32_t r = xorshift32();
+        memcpy(p + i, &r, 4);
+    }
+}
+
+static int planes_equal(const GcGxVtxBuf *a, const GcGxVtxBuf *b, const char *tag) {
+    uint32_t i;
+    CHECK(a->count == b->count, "%s count %u != %u", tag, a->count, b->count);
+    CHECK(a->mask == b->mask, "%s mask %llx != %llx", tag,
+          (unsigned long long)a->mask, (unsigned long long)b->mask);
+    CHECK(a->mtx_mask == b->mtx_mask, "%s mtx mask %x != %x", tag, a->mtx_mask, b->mtx_mask);
+    for (i = 0; i < GC_GX_VTX_PLANES; i++) {
+        if (!((a->mask >> i) & 1u)) continue;
+        CHECK(memcmp(a->f[i], b->f[i], a->count * sizeof(float)) == 0,
+              "%s plane %u differs", tag, i);
+    }
+    for (i = 0; i < GC_GX_VTX_MTX_PLANES; i++) {
+        if (!((a->mtx_mask >> i) & 1u)) continue;
+        CHECK(memcmp(a->mtx[i], b->mtx[i], a->count) == 0, "%s mtx plane %u differs", tag, i);
+    }
+    return 1;
+}
+
+static int decode_both(const uint32_t *cp, uint32_t fmt, const char *tag) {
+    const uint32_t vsize = gc_gx_gp_vertex_size_cp(cp, fmt);
+    const uint32_t n = vsize ? 1u + (xorshift32() % 64u) : 0u;
+    uint32_t i;
+    if (vsize > 128u) return 1;
+    for (i = 0; i < n * vsize; i++) g_data[i] = (uint8_t)xorshift32();
+    CHECK(gc_gx_vtx_decode(&gc_gx_vtx, cp, fmt, n, g_data), "%s decode failed", tag);
+    CHECK(gc_gx_vtx_decode_ref(&g_ref, cp, fmt, n, g_data), "%s ref decode failed", tag);
+    return planes_equal(&gc_gx_vtx, &g_ref, tag);
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Levels
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L0_random(void) {
+    uint32_t cp[256], iter;
+    memset(cp, 0, sizeof(cp));
+    fill_arrays();
+    for (iter = 0; iter < 32; iter++) {
+        const uint32_t fmt = xorshift32() & 7u;
+        random_config(cp, fmt);
+        if (!decode_both(cp, fmt, "L0")) return 0;
+    }
+    return 1;
+}
+
+static int test_L1_sdk(void) {
+    const uint32_t n = 1u + (xorshift32() % 24u);
+    const uint32_t pfrac = xorshift32() % 12u;
+    const uint32_t tfrac = xorshift32() % 12u;
+    const uint32_t arr = RAM_BASE | ARRAY_AREA;
+    int16_t pos[24][3], nrm[24][3], tex[24][2];
+    uint8_t clr[24][4];
+    uint16_t idx[24];
+    uint32_t i, c;
+
+    GXInit(0, 0);
+
+    /* Direct: POS s16 xyz, NRM s16, CLR0 RGBA8, TEX0 s16 st. */
+    GXClearVtxDesc();
+    GXSetVtxDesc(9, 1);
+    GXSetVtxDesc(10, 1);
+    GXSetVtxDesc(11, 1);
+    GXSetVtxDesc(13, 1);
+    GXSetVtxAttrFmt(1, 9, 1, 3, (uint8_t)pfrac);
+    GXSetVtxAttrFmt(1, 10, 0, 3, 0);
+    GXSetVtxAttrFmt(1, 11, 1, 5, 0);
+    GXSetVtxAttrFmt(1, 13, 1, 3, (uint8_t)tfrac);
+    GXBegin(0x90, 1, (uint16_t)n);
+    for (i = 0; i < n; i++) {
+        for (c = 0; c < 3; c++) {
+            pos[i][c] = (int16_t)xorshift32();
+            nrm[i][c] = (int16_t)xorshift32();
+        }
+        for (c = 0; c < 4; c++) clr[i][c] = (uint8_t)xorshift32();
+        tex[i][0] = (int16_t)xorshift32();
+        tex[i][1] = (int16_t)xorshift32();
+        GXPosition3s16(pos[i][0], pos[i][1], pos[i][2]);
+        GXNormal3s16(nrm[i][0], nrm[i][1], nrm[i][2]);
+        GXColor4u8(clr[i][0], clr[i][1], clr[i][2], clr[i][3]);
+        GXTexCoord2s16(tex[i][0], tex[i][1]);
+    }
+    GXEnd();
+
+    CHECK(gc_gx_vtx.count == n, "L1 direct count %u != %u", gc_gx_vtx.count, n);
+    CHECK(gc_gx_vtx.vtxfmt == 1u, "L1 vtxfmt %u", gc_gx_vtx.vtxfmt);
+    for (i = 0; i < n; i++) {
+        for (c = 0; c < 3; c++) {
+            CHECK(gc_gx_vtx.f[GC_GX_VTX_POS + c][i] == (float)pos[i][c] / (float)(1u << pfrac),
+                  "L1 pos[%u][%u]", i, c);
+            CHECK(gc_gx_vtx.f[GC_GX_VTX_NRM + c][i] == (float)nrm[i][c] / 16384.0f,
+                  "L1 nrm[%u][%u]", i, c);
+        }
+        for (c = 0; c < 4; c++) {
+            CHECK(gc_gx_vtx.f[GC_GX_VTX_CLR0 + c][i] == (float)clr[i][c] / 255.0f,
+                  "L1 clr[%u][%u]", i, c);
+        }
+        for (c = 0; c < 2; c++) {
+            CHECK(gc_gx_vtx.f[GC_GX_VTX_TEX0 + c][i] == (float)tex[i][c] / (float)(1u << tfrac),
+                  "L1 tex[%u][%u]", i, c);
+        }
+    }
+
+    /* Indexed: POS index16 into an s16 xyz array with stride 6. */
+    for (i = 0; i < 24; i++) {
+        for (c = 0; c < 3; c++) {
+            pos[i][c] = (int16_t)xorshift32();
+            put16be(ram(arr + i * 6u + c * 2u), (uint16_t)pos[i][c]);
+        }
+    }
+    GXClearVtxDesc();
+    GXSetVtxDesc(9, 3);
+    GXSetArray(9, (void *)(uintptr_t)arr, 6);
+    GXBegin(0x90, 1, (uint16_t)n);
+    for (i = 0; i < n; i++) {
+        idx[i] = (uint16_t)(xorshift32() % 24u);
+        GXPosition1x16(idx[i]);
+    }
+    GXEnd();
+
+    CHECK(gc_gx_vtx.count == n, "L1 indexed count %u != %u", gc_gx_vtx.count, n);
+    CHECK(gc_gx_vtx.mask == (uint64_t)7u << GC_GX_VTX_POS, "L1 indexed mask");
+    for (i = 0; i < n; i++) {
+        for (c = 0; c < 3; c++) {
+            CHECK(gc_gx_vtx.f[GC_GX_VTX_POS + c][i] == (float)pos[idx[i]][c] / (float)(1u << pfrac),
+                  "L1 indexed pos[%u][%u]", i, c);
+        }
+    }
+    return 1;
+}
+
+static int test_L2_cache(void) {
+    uint32_t cp[256], saved[8][256], iter, hits;
+    memset(cp, 0, sizeof(cp));
+    fill_arrays();
+    gc_gx_vtx_reset();
+
+    /* Same config twice: second decode is a hit. */
+    random_config(cp, 0);
+    if (!decode_both(cp, 0, "L2 first")) return 0;
+    hits = gc_gx_vtx_loader_hits;
+    if (!decode_both(cp, 0, "L2 repeat")) return 0;
+    CHECK(gc_gx_vtx_loader_hits == hits + 1u, "L2 repeat config was not a hit");
+    CHECK(gc_gx_vtx_loader_misses == 1u, "L2 misses %u", gc_gx_vtx_loader_misses);
+
+    /* More configs than slots, revisiting a few old ones. */
+    for (iter = 0; iter < GC_GX_VTX_LOADER_CACHE * 2u; iter++) {
+        uint32_t fmt = iter & 7u;
+        if (iter >= 8u && (xorshift32() & 3u) == 0) {
+            fmt = xorshift32() & 7u;             /* saved[k] was built for vtxfmt k */
+            memcpy(cp, saved[fmt], sizeof(cp));
+        } else {
+            random_config(cp, fmt);
+            if (iter < 8u) memcpy(saved[iter], cp, sizeof(cp));
+        }
+        if (!decode_both(cp, fmt, "L2 churn")) return 0;
+    }
+    CHECK(gc_gx_vtx_loader_evictions > 0, "L2 no evictions");
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Per-seed runner
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int run_seed(uint32_t seed) {
+    g_rng = seed;
+    ram_init();
+    if (!g_opt_op || strstr("L0", g_opt_op) || strstr("RANDOM", g_opt_op)) {
+        if (!test_L0_random()) return 0;
+    }
+    if (!g_opt_op || strstr("L1", g_opt_op) || strstr("SDK", g_opt_op)) {
+        if (!test_L1_sdk()) return 0;
+    }
+    if (!g_opt_op || strstr("L2", g_opt_op) || strstr("CACHE", g_opt_op) || strstr("FULL", g_opt_op)) {
+        if (!test_L2_cache()) return 0;
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * main
+ * ═══════════════════════════════════════════════════════════════════ */
+
+int main(int argc, char **argv) {
+    uint32_t start_seed = 1;
+    int num_runs = 100;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+            start_seed = (uint32_t)strtoul(argv[i] + 7, NULL, 0);
+        else if (strncmp(argv[i], "--num-runs=", 11) == 0)
+            num_runs = atoi(argv[i] + 11);
+        else if (strncmp(argv[i], "--op=", 5) == 0)
+            g_opt_op = argv[i] + 5;
+        else if (strcmp(argv[i], "-v") == 0)
+            g_verbose = 1;
+        else {
+            fprintf(stderr,
+                    "Usage: gxvtx_property_test [--seed=N] [--num-runs=N] "
+                    "[--op=L0|L1|L2|RANDOM|SDK|CACHE|FULL] [-v]\n");
+            return 2;
+        }
+    }
+
+    printf("\n=== GX Vertex Loader Property Test ===\n");
+
+    for (i = 0; i < num_runs; i++) {
+        uint32_t seed = start_seed + (uint32_t)i;
+        uint64_t before = g_total_checks;
+
+        if (!run_seed(seed)) {
+            printf("  FAILED at seed %u\n", seed);
+            printf("\n--- Summary ---\n");
+            printf("Seeds:  %d (failed at %d)\n", i + 1, i + 1);
+            printf("Checks: %llu  (pass=%llu  fail=1)\n",
+                   (unsigned long long)g_total_checks,
+                   (unsigned long long)g_total_pass);
+            printf("\nRESULT: FAIL\n");
+            return 1;
+        }
+
+        if (g_verbose) {
+            printf("  seed %u: %llu checks OK (loader hits=%u misses=%u evict=%u)\n",
+                   seed, (unsigned long long)(g_total_checks - before),
+                   gc_gx_vtx_loader_hits, gc_gx_vtx_loader_misses, gc_gx_vtx_loader_evictions);
+        }
+        if ((i + 1) % 100 == 0) {
+            printf("  progress: seed %d/%d\n", i + 1, num_runs);
+        }
+    }
+
+    printf("\n--- Summary ---\n");
+    printf("Seeds:  %d\n", num_runs);
+    printf("Checks: %llu  (pass=%llu  fail=0)\n",
+           (unsigned long long)g_total_checks,
+           (unsigned long long)g_total_pass);
+    printf("\nRESULT: %llu/%llu PASS\n",
+           (unsigned long long)g_total_pass,
+           (unsigned long long)g_total_checks);
+
+    return 0;
+}
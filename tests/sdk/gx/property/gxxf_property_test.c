@@ -0,0 +1,444 @@
+/*
+ * gxxf_property_test.c — Property test for the software XF stage
+ *
+ * Oracle: gc_gx_xf_run_ref (per-vertex scalar transform/lighting/texgen)
+ * Port:   gc_gx_xf_run (4-lane batches, chunked across threads when large)
+ *
+ * Levels:
+ *   L0 — Random XF memory/registers + random vertex planes: batched == ref
+ *   L1 — SDK path: matrices, projection, viewport, one light and a texgen
+ *        set through GX calls; GXBegin..GXEnd output matches closed form
+ *   L2 — Large batches: threaded chunks == single-thread run, bit-exact
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "gc_mem.h"
+#include "gx_gp.h"
+#include "gx_vtx.h"
+#include "gx_xf.h"
+
+/* ── xorshift32 PRNG ────────────────────────────────────────────── */
+static uint32_t g_rng;
+static uint32_t xorshift32(void) {
+    uint32_t x = g_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rng = x;
+    return x;
+}
+
+static float rnd_f(float lo, float hi) {
+    return lo + (hi - lo) * (float)(xorshift32() & 0xFFFFFFu) / 16777216.0f;
+}
+
+static uint32_t f2u(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+/* ── Counters ───────────────────────────────────────────────────── */
+static uint64_t g_total_checks;
+static uint64_t g_total_pass;
+static int       g_verbose;
+static const char *g_opt_op;
+
+#define CHECK(cond, ...) do { \
+    g_total_checks++; \
+    if (!(cond)) { \
+        printf("FAIL @ %s:%d: ", __FILE__, __LINE__); \
+        printf(__VA_ARGS__); printf("\n"); \
+        return 0; \
+    } \
+    g_total_pass++; \
+} while(0)
+
+/* ── SDK surface (linked from GX.c) ─────────────────────────────── */
+typedef struct { uint8_t r, g, b, a; } GXColor;
+typedef struct {
+    uint32_t reserved[3];
+    uint32_t Color;
+    float a[3];
+    float k[3];
+    float lpos[3];
+    float ldir[3];
+} GXLightObj;
+typedef struct { uint8_t _dummy; } GXFifoObj;
+GXFifoObj *GXInit(void *base, uint32_t size);
+void GXClearVtxDesc(void);
+void GXSetVtxDesc(uint32_t attr, uint32_t type);
+void GXSetVtxAttrFmt(uint32_t vtxfmt, uint32_t attr, uint32_t cnt, uint32_t type, uint8_t frac);
+void GXBegin(uint8_t type, uint8_t vtxfmt, uint16_t nverts);
+void GXEnd(void);
+void GXPosition3f32(float x, float y, float z);
+void GXNormal3s16(int16_t x, int16_t y, int16_t z);
+void GXColor4u8(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+void GXTexCoord2f32(float s, float t);
+void GXLoadPosMtxImm(float mtx[3][4], uint32_t id);
+void GXLoadNrmMtxImm(float mtx[3][4], uint32_t id);
+void GXLoadTexMtxImm(float mtx[][4], uint32_t id, uint32_t type);
+void GXSetCurrentMtx(uint32_t id);
+void GXSetProjection(float mtx[4][4], uint32_t type);
+void GXSetViewport(float left, float top, float wd, float ht, float nearz, float farz);
+void GXSetNumChans(uint8_t n);
+void GXSetNumTexGens(uint8_t n);
+void GXSetChanCtrl(uint32_t chan, uint8_t enable, uint32_t amb_src, uint32_t mat_src,
+                   uint32_t light_mask, uint32_t diff_fn, uint32_t attn_fn);
+void GXSetChanAmbColor(uint32_t chan, GXColor c);
+void GXSetTexCoordGen(uint8_t dst, uint32_t func, uint32_t src, uint32_t mtx);
+void GXInitLightPos(GXLightObj *lt, float x, float y, float z);
+void GXInitLightColor(GXLightObj *lt, GXColor c);
+void GXInitLightAttn(GXLightObj *lt, float a0, float a1, float a2, float k0, float k1, float k2);
+void GXLoadLightObjImm(GXLightObj *lt, uint32_t light);
+
+/* ── Emulated RAM ───────────────────────────────────────────────── */
+#define RAM_BASE  0x80000000u
+#define RAM_SIZE  0x01800000u
+
+static uint8_t *g_ram;
+
+static void ram_init(void) {
+    if (!g_ram) g_ram = (uint8_t *)calloc(1, RAM_SIZE);
+    gc_mem_set(RAM_BASE, RAM_SIZE, g_ram);
+}
+
+/* ── Helpers ────────────────────────────────────────────────────── */
+#define BIG_CAP 16384u
+
+static GcGxVtxBuf g_in;
+static GcGxXfBuf g_a, g_b;
+static uint32_t g_mem[GC_GX_XF_MEM_SIZE];
+static uint32_t g_regs[GC_GX_XF_REG_COUNT];
+
+static void in_alloc(void) {
+    uint32_t i;
+    if (g_in.cap) return;
+    g_in.cap = BIG_CAP;
+    for (i = 0; i < GC_GX_VTX_PLANES; i++) g_in.f[i] = (float *)calloc(BIG_CAP, sizeof(float));
+    for (i = 0; i < GC_GX_VTX_MTX_PLANES; i++) g_in.mtx[i] = (uint8_t *)calloc(BIG_CAP, 1);
+}
+
+static void random_input(uint32_t n) {
+    uint32_t i, v;
+    g_in.count = n;
+    g_in.mask = (uint64_t)0x7u << GC_GX_VTX_POS;
+    if (xorshift32() & 1u) g_in.mask |= (uint64_t)((xorshift32() & 1u) ? 0x1FFu : 0x7u) << GC_GX_VTX_NRM;
+    if (xorshift32() & 1u) g_in.mask |= (uint64_t)0xFu << GC_GX_VTX_CLR0;
+    if (xorshift32() & 1u) g_in.mask |= (uint64_t)0xFu << GC_GX_VTX_CLR1;
+    for (i = 0; i < 8; i++) {
+        if (xorshift32() & 1u) g_in.mask |= (uint64_t)((xorshift32() & 1u) ? 3u : 1u) << (GC_GX_VTX_TEX0 + i * 2u);
+    }
+    g_in.mtx_mask = (xorshift32() & 3u) == 0 ? (xorshift32() & 0x1FFu) : 0u;
+    for (i = 0; i < GC_GX_VTX_PLANES; i++) {
+        const int clr = i >= GC_GX_VTX_CLR0 && i < GC_GX_VTX_TEX0;
+        for (v = 0; v < n; v++) g_in.f[i][v] = clr ? rnd_f(0.0f, 1.0f) : rnd_f(-4.0f, 4.0f);
+    }
+    for (i = 0; i < GC_GX_VTX_MTX_PLANES; i++) {
+        for (v = 0; v < n; v++) g_in.mtx[i][v] = (uint8_t)xorshift32();
+    }
+}
+
+static void random_xf(void) {
+    uint32_t i, l;
+    for (i = 0; i < GC_GX_XF_MEM_SIZE; i++) g_mem[i] = f2u(rnd_f(-2.0f, 2.0f));
+    for (l = 0; l < 8; l++) {
+        const uint32_t b = 0x600u + l * 16u;
+        g_mem[b + 3u] = xorshift32();
+        for (i = 0; i < 3; i++) {
+            g_mem[b + 4u + i] = f2u(rnd_f(-1.0f, 1.0f));
+            g_mem[b + 7u + i] = (xorshift32() & 7u) == 0 ? 0 : f2u(rnd_f(0.0f, 1.0f));
+            g_mem[b + 10u + i] = f2u(rnd_f(-50.0f, 50.0f));
+        }
+    }
+    memset(g_regs, 0, sizeof(g_regs));
+    g_regs[0x09] = xorshift32() & 3u;
+    for (i = 0x0A; i <= 0x0D; i++) g_regs[i] = xorshift32();
+    for (i = 0x0E; i <= 0x11; i++) g_regs[i] = xorshift32() & 0x7FFFu;
+    g_regs[0x12] = xorshift32() & 1u;
+    g_regs[0x18] = xorshift32();
+    g_regs[0x19] = xorshift32();
+    for (i = 0x1A; i <= 0x1F; i++) g_regs[i] = f2u(rnd_f(-400.0f, 400.0f));
+    for (i = 0x20; i <= 0x25; i++) g_regs[i] = f2u(rnd_f(-2.0f, 2.0f));
+    g_regs[0x26] = xorshift32() & 1u;
+    g_regs[0x3F] = xorshift32() % 10u;
+    for (i = 0; i < 8; i++) {
+        uint32_t reg = 0;
+        reg |= (xorshift32() & 1u) << 1;           /* projection */
+        reg |= (xorshift32() & 1u) << 2;           /* input form */
+        reg |= (xorshift32() % 5u) << 4;           /* type (4 is invalid) */
+        reg |= (xorshift32() % 15u) << 7;          /* source row */
+        reg |= (xorshift32() & 7u) << 12;          /* emboss source */
+        reg |= (xorshift32() & 7u) << 15;          /* emboss light */
+        g_regs[0x40 + i] = reg;
+        g_regs[0x50 + i] = xorshift32() & 0x13Fu;
+    }
+}
+
+static int feq(float a, float b) {
+    float d, m;
+    if (a == b) return 1;
+    if (a != a && b != b) return 1;
+    d = fabsf(a - b);
+    m = fabsf(a) > fabsf(b) ? fabsf(a) : fabsf(b);
+    return d <= 1e-5f * (m > 1.0f ? m : 1.0f);
+}
+
+static int planes_match(const GcGxXfBuf *a, const GcGxXfBuf *b, const char *tag) {
+    uint32_t i, v;
+    CHECK(a->count == b->count, "%s count %u != %u", tag, a->count, b->count);
+    CHECK(a->mask == b->mask, "%s mask %llx != %llx", tag,
+          (unsigned long long)a->mask, (unsigned long long)b->mask);
+    CHECK(a->nchans == b->nchans && a->ntexgens == b->ntexgens, "%s chans/texgens", tag);
+    for (i = 0; i < GC_GX_XF_PLANES; i++) {
+        if (!((a->mask >> i) & 1u)) continue;
+        for (v = 0; v < a->count; v++) {
+            CHECK(feq(a->f[i][v], b->f[i][v]), "%s plane %u vtx %u: %.9g != %.9g",
+                  tag, i, v, a->f[i][v], b->f[i][v]);
+        }
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Levels
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L0_random(void) {
+    uint32_t iter;
+    in_alloc();
+    for (iter = 0; iter < 8; iter++) {
+        const uint32_t n = (xorshift32() & 3u) == 0 ? 1u + xorshift32() % 300u : 1u + xorshift32() % 16u;
+        random_xf();
+        random_input(n);
+        CHECK(gc_gx_xf_run(&g_a, &g_in, g_mem, g_regs), "L0 run failed");
+        CHECK(gc_gx_xf_run_ref(&g_b, &g_in, g_mem, g_regs), "L0 ref failed");
+        if (!planes_match(&g_a, &g_b, "L0")) return 0;
+    }
+    return 1;
+}
+
+static int near(float a, float b, float tol) {
+    return fabsf(a - b) <= tol * (fabsf(b) > 1.0f ? fabsf(b) : 1.0f);
+}
+
+static int test_L1_sdk(void) {
+    const uint32_t n = 1u + (xorshift32() % 12u);
+    const float tx = rnd_f(-5.0f, 5.0f), ty = rnd_f(-5.0f, 5.0f), sc = rnd_f(0.5f, 2.0f);
+    const float ts = rnd_f(0.25f, 4.0f), to = rnd_f(-1.0f, 1.0f);
+    const float lx = rnd_f(-20.0f, 20.0f), ly = rnd_f(-20.0f, 20.0f), lz = rnd_f(5.0f, 20.0f);
+    const GXColor amb = { (uint8_t)xorshift32(), (uint8_t)xorshift32(), (uint8_t)xorshift32(), (uint8_t)xorshift32() };
+    const GXColor lc = { (uint8_t)xorshift32(), (uint8_t)xorshift32(), (uint8_t)xorshift32(), (uint8_t)xorshift32() };
+    float pm[3][4] = { { sc, 0, 0, tx }, { 0, sc, 0, ty }, { 0, 0, sc, -10.0f } };
+    float nm[3][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 } };
+    float tm[2][4] = { { ts, 0, 0, to }, { 0, ts, 0, -to } };
+    float proj[4][4] = { { 0.01f, 0, 0, -0.5f }, { 0, 0.02f, 0, 0.25f }, { 0, 0, -0.01f, -1.0f }, { 0, 0, 0, 1 } };
+    float pos[12][3], st[12][2], nrm[12][3];
+    uint8_t clr[12][4];
+    GXLightObj light;
+    uint32_t i, c;
+
+    GXInit(0, 0);
+    GXLoadPosMtxImm(pm, 0);
+    GXLoadNrmMtxImm(nm, 0);
+    GXSetCurrentMtx(0);
+    GXLoadTexMtxImm(tm, 30, 1);
+    GXSetProjection(proj, 1);
+    GXSetViewport(0.0f, 0.0f, 640.0f, 480.0f, 0.0f, 1.0f);
+
+    memset(&light, 0, sizeof(light));
+    GXInitLightPos(&light, lx, ly, lz);
+    GXInitLightColor(&light, lc);
+    GXInitLightAttn(&light, 1, 0, 0, 1, 0, 0);
+    GXLoadLightObjImm(&light, 1u /* GX_LIGHT0 */);
+
+    GXSetNumChans(1);
+    GXSetChanCtrl(4 /* GX_COLOR0A0 */, 1, 0 /* amb reg */, 1 /* mat vtx */,
+                  1u /* GX_LIGHT0 */, 2 /* GX_DF_CLAMP */, 2 /* GX_AF_NONE */);
+    GXSetChanAmbColor(4, amb);
+    GXSetNumTexGens(1);
+    GXSetTexCoordGen(0, 1 /* GX_TG_MTX2x4 */, 4 /* GX_TG_TEX0 */, 30);
+
+    GXClearVtxDesc();
+    GXSetVtxDesc(9, 1);
+    GXSetVtxDesc(10, 1);
+    GXSetVtxDesc(11, 1);
+    GXSetVtxDesc(13, 1);
+    GXSetVtxAttrFmt(0, 9, 1, 4, 0);
+    GXSetVtxAttrFmt(0, 10, 0, 3, 0);
+    GXSetVtxAttrFmt(0, 11, 1, 5, 0);
+    GXSetVtxAttrFmt(0, 13, 1, 4, 0);
+
+    GXBegin(0x90, 0, (uint16_t)n);
+    for (i = 0; i < n; i++) {
+        int16_t q[3];
+        for (c = 0; c < 3; c++) pos[i][c] = rnd_f(-10.0f, 10.0f);
+        for (c = 0; c < 3; c++) q[c] = (int16_t)(rnd_f(-1.0f, 1.0f) * 16384.0f);
+        for (c = 0; c < 3; c++) nrm[i][c] = (float)q[c] / 16384.0f;
+        for (c = 0; c < 4; c++) clr[i][c] = (uint8_t)xorshift32();
+        st[i][0] = rnd_f(-2.0f, 2.0f);
+        st[i][1] = rnd_f(-2.0f, 2.0f);
+        GXPosition3f32(pos[i][0], pos[i][1], pos[i][2]);
+        GXNormal3s16(q[0], q[1], q[2]);
+        GXColor4u8(clr[i][0], clr[i][1], clr[i][2], clr[i][3]);
+        GXTexCoord2f32(st[i][0], st[i][1]);
+    }
+    GXEnd();
+
+    CHECK(gc_gx_xf.count == n, "L1 count %u != %u", gc_gx_xf.count, n);
+    CHECK(gc_gx_xf.nchans == 1u && gc_gx_xf.ntexgens == 1u, "L1 chans %u texgens %u",
+          gc_gx_xf.nchans, gc_gx_xf.ntexgens);
+    for (i = 0; i < n; i++) {
+        float eye[3], nn[3], ld[3], len, d, lit;
+        eye[0] = sc * pos[i][0] + tx;
+        eye[1] = sc * pos[i][1] + ty;
+        eye[2] = sc * pos[i][2] - 10.0f;
+        for (c = 0; c < 3; c++) {
+            CHECK(near(gc_gx_xf.f[GC_GX_XF_EYE + c][i], eye[c], 1e-5f), "L1 eye[%u][%u]", i, c);
+        }
+        /* Ortho: x' = 0.01x - 0.5, viewport scale 320 / offset 320 + 342. */
+        CHECK(near(gc_gx_xf.f[GC_GX_XF_WIN + 0][i], (0.01f * eye[0] - 0.5f) * 320.0f + 662.0f, 1e-5f),
+              "L1 win x[%u]", i);
+        CHECK(near(gc_gx_xf.f[GC_GX_XF_WIN + 1][i], (0.02f * eye[1] + 0.25f) * -240.0f + 582.0f, 1e-5f),
+              "L1 win y[%u]", i);
+        CHECK(gc_gx_xf.f[GC_GX_XF_CLIP + 3][i] == 1.0f, "L1 ortho w[%u]", i);
+
+        len = sqrtf(nrm[i][0] * nrm[i][0] + nrm[i][1] * nrm[i][1] + nrm[i][2] * nrm[i][2]);
+        for (c = 0; c < 3; c++) nn[c] = len > 0.0f ? nrm[i][c] / len : 0.0f;
+        ld[0] = lx - eye[0];
+        ld[1] = ly - eye[1];
+        ld[2] = lz - eye[2];
+        len = sqrtf(ld[0] * ld[0] + ld[1] * ld[1] + ld[2] * ld[2]);
+        d = (ld[0] * nn[0] + ld[1] * nn[1] + ld[2] * nn[2]) / len;
+        if (d < 0.0f) d = 0.0f;
+        for (c = 0; c < 4; c++) {
+            const uint8_t a8 = c == 0 ? amb.r : c == 1 ? amb.g : c == 2 ? amb.b : amb.a;
+            const uint8_t l8 = c == 0 ? lc.r : c == 1 ? lc.g : c == 2 ? lc.b : lc.a;
+            lit = (float)a8 / 255.0f + d * (float)l8 / 255.0f;
+            if (lit > 1.0f) lit = 1.0f;
+            CHECK(fabsf(gc_gx_xf.f[GC_GX_XF_CLR0 + c][i] - (float)clr[i][c] / 255.0f * lit) < 1e-4f,
+                  "L1 clr[%u][%u] %f", i, c, gc_gx_xf.f[GC_GX_XF_CLR0 + c][i]);
+        }
+
+        CHECK(near(gc_gx_xf.f[GC_GX_XF_TEX0 + 0][i], ts * st[i][0] + to, 1e-5f), "L1 s[%u]", i);
+        CHECK(near(gc_gx_xf.f[GC_GX_XF_TEX0 + 1][i], ts * st[i][1] - to, 1e-5f), "L1 t[%u]", i);
+        CHECK(gc_gx_xf.f[GC_GX_XF_TEX0 + 2][i] == 1.0f, "L1 q[%u]", i);
+    }
+    return 1;
+}
+
+static int test_L2_parallel(void) {
+    const uint32_t n = GC_GX_XF_PAR_MIN + xorshift32() % (BIG_CAP - GC_GX_XF_PAR_MIN);
+    const uint32_t saved = gc_gx_xf_threads;
+    uint32_t i, before;
+
+    in_alloc();
+    random_xf();
+    random_input(n);
+
+    gc_gx_xf_threads = 1;
+    CHECK(gc_gx_xf_run(&g_b, &g_in, g_mem, g_regs), "L2 serial run failed");
+    gc_gx_xf_threads = 2u + xorshift32() % 7u;
+    before = gc_gx_xf_parallel_batches;
+    CHECK(gc_gx_xf_run(&g_a, &g_in, g_mem, g_regs), "L2 parallel run failed");
+    gc_gx_xf_threads = saved;
+#ifdef GC_GX_XF_THREADS
+    CHECK(gc_gx_xf_parallel_batches == before + 1u, "L2 batch of %u not split", n);
+#else
+    CHECK(gc_gx_xf_parallel_batches == before, "L2 split without thread support");
+#endif
+    CHECK(g_a.mask == g_b.mask && g_a.count == g_b.count, "L2 mask/count");
+    for (i = 0; i < GC_GX_XF_PLANES; i++) {
+        if (!((g_a.mask >> i) & 1u)) continue;
+        CHECK(memcmp(g_a.f[i], g_b.f[i], n * sizeof(float)) == 0, "L2 plane %u differs", i);
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Per-seed runner
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int run_seed(uint32_t seed) {
+    g_rng = seed;
+    ram_init();
+    if (!g_opt_op || strstr("L0", g_opt_op) || strstr("RANDOM", g_opt_op)) {
+        if (!test_L0_random()) return 0;
+    }
+    if (!g_opt_op || strstr("L1", g_opt_op) || strstr("SDK", g_opt_op)) {
+        if (!test_L1_sdk()) return 0;
+    }
+    if (!g_opt_op || strstr("L2", g_opt_op) || strstr("PARALLEL", g_opt_op) || strstr("FULL", g_opt_op)) {
+        if (!test_L2_parallel()) return 0;
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * main
+ * ═══════════════════════════════════════════════════════════════════ */
+
+int main(int argc, char **argv) {
+    uint32_t start_seed = 1;
+    int num_runs = 100;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+            start_seed = (uint32_t)strtoul(argv[i] + 7, NULL, 0);
+        else if (strncmp(argv[i], "--num-runs=", 11) == 0)
+            num_runs = atoi(argv[i] + 11);
+        else if (strncmp(argv[i], "--op=", 5) == 0)
+            g_opt_op = argv[i] + 5;
+        else if (strcmp(argv[i], "-v") == 0)
+            g_verbose = 1;
+        else {
+            fprintf(stderr,
+                    "Usage: gxxf_property_test [--seed=N] [--num-runs=N] "
+                    "[--op=L0|L1|L2|RANDOM|SDK|PARALLEL|FULL] [-v]\n");
+            return 2;
+        }
+    }
+
+    printf("\n=== GX XF Stage Property Test ===\n");
+
+    for (i = 0; i < num_runs; i++) {
+        uint32_t seed = start_seed + (uint32_t)i;
+        uint64_t before = g_total_checks;
+
+        if (!run_seed(seed)) {
+            printf("  FAILED at seed %u\n", seed);
+            printf("\n--- Summary ---\n");
+            printf("Seeds:  %d (failed at %d)\n", i + 1, i + 1);
+            printf("Checks: %llu  (pass=%llu  fail=1)\n",
+                   (unsigned long long)g_total_checks,
+                   (unsigned long long)g_total_pass);
+            printf("\nRESULT: FAIL\n");
+            return 1;
+        }
+
+        if (g_verbose) {
+            printf("  seed %u: %llu checks OK (parallel batches=%u)\n",
+                   seed, (unsigned long long)(g_total_checks - before), gc_gx_xf_parallel_batches);
+        }
+        if ((i + 1) % 100 == 0) {
+            printf("  progress: seed %d/%d\n", i + 1, num_runs);
+        }
+    }
+
+    printf("\n--- Summary ---\n");
+    printf("Seeds:  %d\n", num_runs);
+    printf("Checks: %llu  (pass=%llu  fail=0)\n",
+           (unsigned long long)g_total_checks,
+           (unsigned long long)g_total_pass);
+    printf("\nRESULT: %llu/%llu PASS\n",
+           (unsigned long long)g_total_pass,
+           (unsigned long long)g_total_checks);
+
+    return 0;
+}
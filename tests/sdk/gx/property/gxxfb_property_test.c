@@ -0,0 +1,464 @@
+/*
+ * gxxfb_property_test.c — Property test for the EFB to XFB display copy
+ *
+ * Oracle: gc_gx_xfb_copy_ref (one pixel at a time)
+ * Port:   gc_gx_xfb_copy (four pixels per vector op, lines split across
+ *         gc_gx_xfb_threads workers)
+ *
+ * Levels:
+ *   L0 — Random EFB, rectangles (EFB edges included), strides, Y scales,
+ *        filter coefficients, gamma and clamp modes: vector == reference,
+ *        threaded == serial, size == stride math
+ *   L1 — Closed form: unity filter gives BT.601 YUYV of each pixel; a
+ *        flat rectangle survives any unity filter and Y scale; a vertical
+ *        ramp gives the 3-line weighted sum with top/bottom clamping;
+ *        gamma 1.7/2.2 match pow(); Y scale picks line y + (i * scale >> 8)
+ *   L2 — SDK: GXSetDispCopySrc / Dst / YScale, GXSetCopyFilter,
+ *        GXSetDispCopyGamma, GXSetCopyClamp and GXCopyDisp write the
+ *        reference image to RAM and clear the rectangle afterwards
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "gc_mem.h"
+#include "gx_raster.h"
+#include "gx_xfb.h"
+
+/* ── xorshift32 PRNG ────────────────────────────────────────────── */
+static uint32_t g_rng;
+static uint32_t xorshift32(void) {
+    uint32_t x = g_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rng = x;
+    return x;
+}
+
+/* ── Counters ───────────────────────────────────────────────────── */
+static uint64_t g_total_checks;
+static uint64_t g_total_pass;
+static int       g_verbose;
+static const char *g_opt_op;
+
+#define CHECK(cond, ...) do { \
+    g_total_checks++; \
+    if (!(cond)) { \
+        printf("FAIL @ %s:%d: ", __FILE__, __LINE__); \
+        printf(__VA_ARGS__); printf("\n"); \
+        return 0; \
+    } \
+    g_total_pass++; \
+} while(0)
+
+/* ── SDK surface (linked from GX.c) ─────────────────────────────── */
+typedef struct { uint8_t _dummy; } GXFifoObj;
+typedef struct { uint8_t r, g, b, a; } GXColor;
+GXFifoObj *GXInit(void *base, uint32_t size);
+void GXSetDispCopySrc(uint16_t left, uint16_t top, uint16_t wd, uint16_t ht);
+void GXSetDispCopyDst(uint16_t wd, uint16_t ht);
+uint32_t GXSetDispCopyYScale(float vscale);
+void GXSetCopyFilter(uint8_t aa, const uint8_t sample_pattern[12][2], uint8_t vf, const uint8_t vfilter[7]);
+void GXSetDispCopyGamma(uint32_t gamma);
+void GXSetCopyClamp(uint32_t clamp);
+void GXSetCopyClear(GXColor clear_clr, uint32_t clear_z);
+void GXCopyDisp(void *dest, uint8_t clear);
+
+/* ── Emulated RAM ───────────────────────────────────────────────── */
+#define RAM_BASE  0x80000000u
+#define RAM_SIZE  0x01800000u
+#define XFB_ADDR  0x80300000u
+
+static uint8_t *g_ram;
+
+static void ram_init(void) {
+    if (!g_ram) g_ram = (uint8_t *)calloc(1, RAM_SIZE);
+    gc_mem_set(RAM_BASE, RAM_SIZE, g_ram);
+}
+
+static uint8_t *ram(uint32_t addr) {
+    return g_ram + (addr - RAM_BASE);
+}
+
+/* ── Helpers ────────────────────────────────────────────────────── */
+#define EFB_W GC_GX_EFB_WIDTH
+#define EFB_H GC_GX_EFB_HEIGHT
+#define MAX_BYTES (1408u * 1024u)
+
+static uint8_t g_out_a[MAX_BYTES];
+static uint8_t g_out_b[MAX_BYTES];
+static uint32_t g_efb_before[EFB_W * EFB_H];
+
+static int efb_fill(void) {
+    uint32_t i;
+    if (!gc_gx_efb.color && !gc_gx_raster_efb_init(&gc_gx_efb)) return 0;
+    for (i = 0; i < EFB_W * EFB_H; i++) gc_gx_efb.color[i] = xorshift32();
+    return 1;
+}
+
+static uint32_t rnd_dim(uint32_t max) {
+    static const uint32_t k_dims[] = { 1, 2, 3, 4, 5, 7, 8, 16, 31, 64, 640 };
+    const uint32_t d = (xorshift32() & 1u) ? k_dims[xorshift32() % 11u] : 1u + xorshift32() % 200u;
+    return d < max ? d : max;
+}
+
+static uint32_t line_bytes(uint32_t w) { return ((w + 1u) >> 1) * 4u; }
+
+static uint32_t luma(uint32_t r, uint32_t g, uint32_t b) {
+    return ((66u * r + 129u * g + 25u * b + 128u) >> 8) + 16u;
+}
+
+/* Signed BT.601 chroma, floor division like an arithmetic shift. */
+static uint32_t chroma(int32_t kr, int32_t kg, int32_t kb, uint32_t r, uint32_t g, uint32_t b) {
+    const int32_t s = kr * (int32_t)r + kg * (int32_t)g + kb * (int32_t)b + 128;
+    return (uint32_t)((s >= 0 ? s / 256 : -((-s + 255) / 256)) + 128);
+}
+
+/* YUYV bytes for a pixel pair of gamma-free, filter-free colors. */
+static void yuyv(uint32_t p0, uint32_t p1, uint8_t o[4]) {
+    const uint32_t r0 = p0 >> 24, g0 = (p0 >> 16) & 0xFFu, b0 = (p0 >> 8) & 0xFFu;
+    const uint32_t r1 = p1 >> 24, g1 = (p1 >> 16) & 0xFFu, b1 = (p1 >> 8) & 0xFFu;
+    const uint32_t r = (r0 + r1 + 1u) >> 1, g = (g0 + g1 + 1u) >> 1, b = (b0 + b1 + 1u) >> 1;
+    o[0] = (uint8_t)luma(r0, g0, b0);
+    o[1] = (uint8_t)chroma(-38, -74, 112, r, g, b);
+    o[2] = (uint8_t)luma(r1, g1, b1);
+    o[3] = (uint8_t)chroma(112, -94, -18, r, g, b);
+}
+
+static void rnd_copy(GcGxXfbCopy *c, int edges) {
+    uint32_t i;
+    c->w = rnd_dim(edges ? 1024u : EFB_W);
+    c->h = rnd_dim(edges ? 1024u : EFB_H);
+    if (edges) {
+        c->x = (xorshift32() & 3u) ? xorshift32() % EFB_W : EFB_W - 1u - xorshift32() % 8u;
+        c->y = (xorshift32() & 3u) ? xorshift32() % EFB_H : EFB_H - 1u - xorshift32() % 8u;
+    } else {
+        c->x = xorshift32() % (EFB_W - c->w + 1u);
+        c->y = xorshift32() % (EFB_H - c->h + 1u);
+    }
+    c->stride = ((line_bytes(c->w) + 31u) & ~31u) + (xorshift32() & 1u) * 32u;
+    c->yscale = 0x100u;
+    c->lines = c->h;
+    for (i = 0; i < 7u; i++) c->vfilter[i] = 0;
+    c->vfilter[2] = 32;     /* coefficients are 6-bit: unity takes two taps */
+    c->vfilter[3] = 32;
+    c->gamma = 0;
+    c->clamp = 0;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L0: vector == reference, threaded == serial
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L0_random(void) {
+    GcGxXfbCopy c;
+    uint32_t size, i, serial_ok;
+
+    rnd_copy(&c, 1);
+    c.yscale = 1u + xorshift32() % 0x1FFu;
+    c.lines = 1u + xorshift32() % 600u;
+    for (i = 0; i < 7u; i++) c.vfilter[i] = (uint8_t)xorshift32();   /* top bits must be ignored */
+    c.gamma = xorshift32() & 3u;
+    c.clamp = xorshift32() & 3u;
+
+    size = gc_gx_xfb_size(&c);
+    CHECK(size == c.stride * (c.lines - 1u) + line_bytes(c.w), "L0 %ux%u stride %u lines %u size %u",
+          c.w, c.h, c.stride, c.lines, size);
+    CHECK(size <= MAX_BYTES, "L0 size %u too large", size);
+
+    memset(g_out_a, 0xA5, size);
+    memset(g_out_b, 0xA5, size);
+    gc_gx_xfb_threads = 1;
+    serial_ok = (uint32_t)gc_gx_xfb_copy(g_out_a, &gc_gx_efb, &c);
+    CHECK(serial_ok, "L0 copy failed");
+    CHECK(gc_gx_xfb_copy_ref(g_out_b, &gc_gx_efb, &c), "L0 ref failed");
+    for (i = 0; i < size && g_out_a[i] == g_out_b[i]; i++) {
+    }
+    CHECK(i == size, "L0 rect (%u,%u %ux%u) scale %x filter %u gamma %u clamp %u line %u byte %u: "
+          "%02x != %02x", c.x, c.y, c.w, c.h, c.yscale, c.vfilter[3] & 63u, c.gamma, c.clamp,
+          i / c.stride, i % c.stride, g_out_a[i], g_out_b[i]);
+
+    gc_gx_xfb_threads = 2u + xorshift32() % 7u;
+    memset(g_out_a, 0xA5, size);
+    CHECK(gc_gx_xfb_copy(g_out_a, &gc_gx_efb, &c), "L0 threaded copy failed");
+    gc_gx_xfb_threads = 4u;
+    CHECK(memcmp(g_out_a, g_out_b, size) == 0, "L0 threaded copy != reference (%u lines)", c.lines);
+
+    c.stride = line_bytes(c.w) - 2u;
+    CHECK(!gc_gx_xfb_size(&c) && !gc_gx_xfb_copy(g_out_a, &gc_gx_efb, &c), "L0 short stride accepted");
+    c.stride += 2u;
+    c.x = EFB_W;
+    CHECK(!gc_gx_xfb_copy(g_out_a, &gc_gx_efb, &c), "L0 rectangle outside the EFB accepted");
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L1: closed form
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L1_identity(void) {
+    GcGxXfbCopy c;
+    uint32_t x, y;
+    uint8_t want[4];
+
+    rnd_copy(&c, 0);
+    CHECK(gc_gx_xfb_copy(g_out_a, &gc_gx_efb, &c), "L1 identity copy failed");
+    for (y = 0; y < c.h; y++) {
+        const uint32_t *row = gc_gx_efb.color + (c.y + y) * EFB_W + c.x;
+        for (x = 0; x < c.w; x += 2u) {
+            const uint8_t *o = g_out_a + y * c.stride + x * 2u;
+            yuyv(row[x], row[x + 1u < c.w ? x + 1u : x], want);
+            CHECK(memcmp(o, want, 4) == 0, "L1 identity (%u,%u) %02x%02x%02x%02x != %02x%02x%02x%02x",
+                  x, y, o[0], o[1], o[2], o[3], want[0], want[1], want[2], want[3]);
+        }
+    }
+    return 1;
+}
+
+static int test_L1_flat(void) {
+    static const float k_scales[] = { 1.0f, 1.1f, 1.25f, 1.5f, 2.0f };
+    const uint32_t color = xorshift32();
+    GcGxXfbCopy c;
+    uint32_t x, y, i, a, b;
+    uint8_t want[4];
+
+    rnd_copy(&c, 0);
+    c.yscale = ((uint32_t)(256.0f / k_scales[xorshift32() % 5u])) & 0x1FFu;
+    c.lines = 1u + ((c.h - 1u) * 0x100u) / c.yscale;
+    /* Any split of 64 over the taps is unity on a flat image. */
+    for (i = 0; i < 7u; i++) c.vfilter[i] = 0;
+    a = xorshift32() % 64u;
+    b = xorshift32() % (64u - a);
+    c.vfilter[xorshift32() % 2u] = (uint8_t)a;
+    c.vfilter[2] = (uint8_t)((64u - a - b) / 2u);
+    c.vfilter[4] = (uint8_t)(64u - a - b - c.vfilter[2]);
+    c.vfilter[5u + xorshift32() % 2u] = (uint8_t)b;
+    c.clamp = 3u;
+    for (y = c.y; y < c.y + c.h; y++) {
+        for (x = c.x; x < c.x + c.w; x++) gc_gx_efb.color[y * EFB_W + x] = color;
+    }
+    CHECK(gc_gx_xfb_copy(g_out_a, &gc_gx_efb, &c), "L1 flat copy failed");
+    yuyv(color, color, want);
+    for (y = 0; y < c.lines; y++) {
+        for (x = 0; x < c.w; x += 2u) {
+            const uint8_t *o = g_out_a + y * c.stride + x * 2u;
+            CHECK(memcmp(o, want, 4) == 0, "L1 flat scale %x line %u x %u", c.yscale, y, x);
+        }
+    }
+    return 1;
+}
+
+/* Grey ramp, one value per line: every Y byte is the 3-line weighted sum. */
+static int test_L1_ramp(void) {
+    static const double k_gamma[] = { 1.0, 1.7, 2.2 };
+    GcGxXfbCopy c;
+    uint32_t i, x, y, top, bottom;
+
+    rnd_copy(&c, 0);
+    for (i = 0; i < 7u; i++) c.vfilter[i] = (uint8_t)(xorshift32() & 63u);
+    c.gamma = xorshift32() % 3u;
+    c.clamp = xorshift32() & 3u;
+    for (y = 0; y < EFB_H; y++) {
+        const uint32_t g = xorshift32() & 0xFFu;
+        for (x = c.x; x < c.x + c.w; x++) gc_gx_efb.color[y * EFB_W + x] = g * 0x01010100u | 0xFFu;
+    }
+    CHECK(gc_gx_xfb_copy(g_out_a, &gc_gx_efb, &c), "L1 ramp copy failed");
+
+    top = (c.clamp & 1u) ? c.y : 0u;
+    bottom = (c.clamp & 2u) ? c.y + c.h - 1u : EFB_H - 1u;
+    for (y = 0; y < c.h; y++) {
+        const uint32_t ym = c.y + y, ya = ym > top ? ym - 1u : top, yb = ym < bottom ? ym + 1u : bottom;
+        const uint32_t ga = gc_gx_efb.color[ya * EFB_W + c.x] >> 24;
+        const uint32_t gm = gc_gx_efb.color[ym * EFB_W + c.x] >> 24;
+        const uint32_t gb = gc_gx_efb.color[yb * EFB_W + c.x] >> 24;
+        uint32_t v = ((c.vfilter[0] + c.vfilter[1]) * ga + (c.vfilter[2] + c.vfilter[3] + c.vfilter[4]) * gm +
+                      (c.vfilter[5] + c.vfilter[6]) * gb) >> 6;
+        uint32_t want;
+        if (v > 255u) v = 255u;
+        v = (uint32_t)(255.0 * pow(v / 255.0, 1.0 / k_gamma[c.gamma]) + 0.5);
+        want = luma(v, v, v);
+        CHECK(g_out_a[y * c.stride] == want && g_out_a[y * c.stride + 1u] == 128u,
+              "L1 ramp line %u (rows %u/%u/%u) gamma %u: Y %u U %u, want Y %u", y, ya, ym, yb,
+              c.gamma, g_out_a[y * c.stride], g_out_a[y * c.stride + 1u], want);
+    }
+    return 1;
+}
+
+static int test_L1_yscale(void) {
+    GcGxXfbCopy c;
+    uint32_t i;
+
+    rnd_copy(&c, 0);
+    c.yscale = 0x40u + xorshift32() % 0x1C0u;
+    c.lines = 1u + ((c.h - 1u) * 0x100u) / c.yscale;
+    CHECK(gc_gx_xfb_copy(g_out_a, &gc_gx_efb, &c), "L1 yscale copy failed");
+    for (i = 0; i < c.lines; i++) {
+        const uint32_t p = gc_gx_efb.color[(c.y + ((i * c.yscale) >> 8)) * EFB_W + c.x];
+        const uint32_t want = luma(p >> 24, (p >> 16) & 0xFFu, (p >> 8) & 0xFFu);
+        CHECK(g_out_a[i * c.stride] == want, "L1 yscale %x line %u: Y %u != %u", c.yscale, i,
+              g_out_a[i * c.stride], want);
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L2: SDK display copy
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L2_sdk(void) {
+    static const float k_scales[] = { 1.0f, 1.1f, 1.25f, 1.5f, 2.0f };
+    static const uint8_t k_pattern[12][2] = {
+        { 6, 6 }, { 6, 6 }, { 6, 6 }, { 6, 6 }, { 6, 6 }, { 6, 6 },
+        { 6, 6 }, { 6, 6 }, { 6, 6 }, { 6, 6 }, { 6, 6 }, { 6, 6 },
+    };
+    const float vscale = k_scales[xorshift32() % 5u];
+    const uint32_t clear = xorshift32() & 1u, vf = xorshift32() & 1u;
+    const GXColor cc = { (uint8_t)xorshift32(), (uint8_t)xorshift32(), (uint8_t)xorshift32(),
+                         (uint8_t)xorshift32() };
+    const uint32_t rgba = (uint32_t)cc.r << 24 | (uint32_t)cc.g << 16 | (uint32_t)cc.b << 8 | cc.a;
+    GcGxEfb before = { g_efb_before, gc_gx_efb.depth };
+    GcGxXfbCopy c;
+    uint32_t i, x, y, size, copies, bad = 0;
+
+    rnd_copy(&c, 0);
+    c.w = 16u * (1u + xorshift32() % 40u);
+    c.x = xorshift32() % (EFB_W - c.w + 1u);
+    c.stride = c.w * 2u;
+    c.yscale = ((uint32_t)(256.0f / vscale)) & 0x1FFu;
+    for (i = 0; i < 7u; i++) c.vfilter[i] = (uint8_t)(xorshift32() & 63u);
+    c.gamma = xorshift32() % 3u;
+    c.clamp = xorshift32() & 3u;
+
+    GXInit(0, 0);
+    GXSetDispCopySrc((uint16_t)c.x, (uint16_t)c.y, (uint16_t)c.w, (uint16_t)c.h);
+    GXSetDispCopyDst((uint16_t)c.w, (uint16_t)c.h);
+    c.lines = GXSetDispCopyYScale(vscale);
+    GXSetCopyFilter(0, k_pattern, (uint8_t)vf, c.vfilter);
+    if (!vf) {
+        static const uint8_t k_default[7] = { 0, 0, 21, 22, 21, 0, 0 };
+        memcpy(c.vfilter, k_default, 7u);
+    }
+    GXSetDispCopyGamma(c.gamma);
+    GXSetCopyClamp(c.clamp);
+    GXSetCopyClear(cc, 0xFFFFFFu);
+
+    memcpy(g_efb_before, gc_gx_efb.color, sizeof(g_efb_before));
+    size = gc_gx_xfb_size(&c);
+    CHECK(size && size <= MAX_BYTES, "L2 size %u", size);
+    CHECK(gc_gx_xfb_copy_ref(g_out_b, &before, &c), "L2 ref failed");
+    copies = gc_gx_xfb_copies;
+    GXCopyDisp((void *)(uintptr_t)XFB_ADDR, (uint8_t)clear);
+    CHECK(gc_gx_xfb_copies == copies + 1u, "L2 display copy not executed");
+    for (i = 0; i < size && ram(XFB_ADDR)[i] == g_out_b[i]; i++) {
+    }
+    CHECK(i == size, "L2 rect (%u,%u %ux%u) vscale %.2f lines %u: line %u byte %u %02x != %02x",
+          c.x, c.y, c.w, c.h, vscale, c.lines, i / c.stride, i % c.stride, ram(XFB_ADDR)[i], g_out_b[i]);
+
+    for (y = 0; y < EFB_H && !bad; y++) {
+        for (x = 0; x < EFB_W; x++) {
+            const int in = x >= c.x && x < c.x + c.w && y >= c.y && y < c.y + c.h;
+            const uint32_t want = clear && in ? rgba : g_efb_before[y * EFB_W + x];
+            if (gc_gx_efb.color[y * EFB_W + x] != want) {
+                bad = 1;
+                break;
+            }
+        }
+    }
+    CHECK(!bad, "L2 clear %u: EFB pixel (%u,%u) wrong after the copy", clear, x, y - 1u);
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Per-seed runner
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int run_seed(uint32_t seed) {
+    g_rng = seed;
+    ram_init();
+    if (!efb_fill()) {
+        printf("EFB allocation failed\n");
+        return 0;
+    }
+    if (!g_opt_op || strstr("L0", g_opt_op) || strstr("RANDOM", g_opt_op)) {
+        if (!test_L0_random()) return 0;
+    }
+    if (!g_opt_op || strstr("L1", g_opt_op) || strstr("CLOSED", g_opt_op)) {
+        if (!test_L1_identity()) return 0;
+        if (!test_L1_yscale()) return 0;
+        if (!test_L1_flat()) return 0;
+        if (!test_L1_ramp()) return 0;
+    }
+    if (!g_opt_op || strstr("L2", g_opt_op) || strstr("SDK", g_opt_op) || strstr("FULL", g_opt_op)) {
+        if (!test_L2_sdk()) return 0;
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * main
+ * ═══════════════════════════════════════════════════════════════════ */
+
+int main(int argc, char **argv) {
+    uint32_t start_seed = 1;
+    int num_runs = 100;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+            start_seed = (uint32_t)strtoul(argv[i] + 7, NULL, 0);
+        else if (strncmp(argv[i], "--num-runs=", 11) == 0)
+            num_runs = atoi(argv[i] + 11);
+        else if (strncmp(argv[i], "--op=", 5) == 0)
+            g_opt_op = argv[i] + 5;
+        else if (strcmp(argv[i], "-v") == 0)
+            g_verbose = 1;
+        else {
+            fprintf(stderr,
+                    "Usage: gxxfb_property_test [--seed=N] [--num-runs=N] "
+                    "[--op=L0|L1|L2|RANDOM|CLOSED|SDK|FULL] [-v]\n");
+            return 2;
+        }
+    }
+
+    printf("\n=== GX Display Copy Property Test ===\n");
+
+    for (i = 0; i < num_runs; i++) {
+        uint32_t seed = start_seed + (uint32_t)i;
+        uint64_t before = g_total_checks;
+
+        if (!run_seed(seed)) {
+            printf("  FAILED at seed %u\n", seed);
+            printf("\n--- Summary ---\n");
+            printf("Seeds:  %d (failed at %d)\n", i + 1, i + 1);
+            printf("Checks: %llu  (pass=%llu  fail=1)\n",
+                   (unsigned long long)g_total_checks,
+                   (unsigned long long)g_total_pass);
+            printf("\nRESULT: FAIL\n");
+            return 1;
+        }
+
+        if (g_verbose) {
+            printf("  seed %u: %llu checks OK (copies=%u parallel=%u)\n", seed,
+                   (unsigned long long)(g_total_checks - before), gc_gx_xfb_copies,
+                   gc_gx_xfb_parallel_copies);
+        }
+        if ((i + 1) % 100 == 0) {
+            printf("  progress: seed %d/%d\n", i + 1, num_runs);
+        }
+    }
+
+    printf("\n--- Summary ---\n");
+    printf("Seeds:  %d\n", num_runs);
+    printf("Checks: %llu  (pass=%llu  fail=0)\n",
+           (unsigned long long)g_total_checks,
+           (unsigned long long)g_total_pass);
+    printf("\nRESULT: %llu/%llu PASS\n",
+           (unsigned long long)g_total_pass,
+           (unsigned long long)g_total_checks);
+
+    return 0;
+}
@@ -2,7 +2,8 @@
  * gxz16_property_test.c — Property-based parity test for GXCompressZ16/GXDecompressZ16
  *
  * Oracle: exact copy of decomp GXCompressZ16 + GXDecompressZ16 (GXMisc.c:362-485)
- * Port:   identical logic (pure integer function, no gc_mem)
+ * Port:   identical logic (pure integer function, no gc_mem), and the
+ *         batch kernels gc_gx_z16_compress/decompress (gx_z16.c)
  *
  * Levels:
  *   L0 — Oracle vs port parity (compress + decompress)
@@ -11,6 +12,10 @@
  *   L3 — Bit range: z16 < 0x10000, z24 <= 0xFFFFFF
  *   L4 — Exhaustive LINEAR (all 65536 z16 values)
  *   L5 — Random integration mix across all formats
+ *   L6 — Batch parity: random arrays (any length, any alignment) and values
+ *        around every exponent boundary, batch == scalar port
+ *   L7 — Exhaustive batch: every z16 and every z24 in every format
+ *        (first seed only)
  */
 
 #include <stdio.h>
@@ -196,6 +201,8 @@ typedef uint32_t u32;
 u32 GXCompressZ16(u32 z24, u32 zfmt);
 u32 GXDecompressZ16(u32 z16, u32 zfmt);
 
+#include "gx_z16.h"
+
 /* ═══════════════════════════════════════════════════════════════════
  * Random z24 value (24 bits)
  * ═══════════════════════════════════════════════════════════════════ */
@@ -364,11 +371,96 @@ static int test_L5_random_integration(void) {
     return 1;
 }
 
+/* ═══════════════════════════════════════════════════════════════════
+ * L6 — Batch parity: random arrays and exponent boundaries
+ * ═══════════════════════════════════════════════════════════════════ */
+
+#define BATCH_MAX 4096u
+
+static uint32_t g_z24[BATCH_MAX + 4];
+static uint16_t g_z16[BATCH_MAX + 4];
+static uint16_t g_c16[BATCH_MAX + 4];
+static uint32_t g_d24[BATCH_MAX + 4];
+
+static int test_L6_batch(void) {
+    uint32_t i, k, fmt;
+    for (k = 0; k < 8; k++) {
+        const uint32_t n = (k & 1) ? xorshift32() % 9u : xorshift32() % 700u;
+        const uint32_t off = xorshift32() & 3u;
+        fmt = xorshift32() % 5u;   /* 4 = invalid format */
+        for (i = 0; i < n; i++) {
+            g_z24[off + i] = xorshift32();   /* top byte must be ignored */
+            g_z16[off + i] = (uint16_t)xorshift32();
+        }
+        g_c16[off + n] = 0xBEEF;
+        g_d24[off + n] = 0xDEADBEEF;
+        gc_gx_z16_compress(g_c16 + off, g_z24 + off, n, fmt);
+        gc_gx_z16_decompress(g_d24 + off, g_z16 + off, n, fmt);
+        for (i = 0; i < n; i++) {
+            CHECK(g_c16[off + i] == GXCompressZ16(g_z24[off + i], fmt),
+                  "L6 batch compress: z24=0x%08X fmt=%u batch=0x%04X port=0x%04X",
+                  g_z24[off + i], fmt, g_c16[off + i], GXCompressZ16(g_z24[off + i], fmt));
+            CHECK(g_d24[off + i] == GXDecompressZ16(g_z16[off + i], fmt),
+                  "L6 batch decompress: z16=0x%04X fmt=%u batch=0x%06X port=0x%06X",
+                  g_z16[off + i], fmt, g_d24[off + i], GXDecompressZ16(g_z16[off + i], fmt));
+        }
+        CHECK(g_c16[off + n] == 0xBEEF && g_d24[off + n] == 0xDEADBEEF,
+              "L6 batch wrote past n=%u", n);
+    }
+
+    /* Leading-one boundaries: the top k bits set, then the next bit clear or set. */
+    for (k = 0; k <= 24; k++) {
+        const uint32_t ones = k ? (0xFFFFFFu << (24 - k)) & 0xFFFFFFu : 0;
+        g_z24[4 * k + 0] = ones;
+        g_z24[4 * k + 1] = ones | (0xFFFFFFu >> (k + 1 < 24 ? k + 1 : 24));
+        g_z24[4 * k + 2] = ones | (xorshift32() & (0xFFFFFFu >> (k < 24 ? k : 24)));
+        g_z24[4 * k + 3] = ones ? ones - 1u : 0;
+    }
+    for (fmt = 0; fmt < 4; fmt++) {
+        gc_gx_z16_compress(g_c16, g_z24, 100, fmt);
+        for (i = 0; i < 100; i++) {
+            CHECK(g_c16[i] == GXCompressZ16(g_z24[i], fmt),
+                  "L6 boundary compress: z24=0x%06X fmt=%u batch=0x%04X port=0x%04X",
+                  g_z24[i], fmt, g_c16[i], GXCompressZ16(g_z24[i], fmt));
+        }
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L7 — Exhaustive batch parity
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_L7_exhaustive_batch(void) {
+    uint32_t base, i, fmt;
+    for (fmt = 0; fmt < 4; fmt++) {
+        for (base = 0; base < 0x10000u; base += BATCH_MAX) {
+            for (i = 0; i < BATCH_MAX; i++) g_z16[i] = (uint16_t)(base + i);
+            gc_gx_z16_decompress(g_d24, g_z16, BATCH_MAX, fmt);
+            for (i = 0; i < BATCH_MAX; i++) {
+                CHECK(g_d24[i] == GXDecompressZ16(base + i, fmt),
+                      "L7 exhaustive decompress: z16=0x%04X fmt=%u batch=0x%06X port=0x%06X",
+                      base + i, fmt, g_d24[i], GXDecompressZ16(base + i, fmt));
+            }
+        }
+        for (base = 0; base < 0x1000000u; base += BATCH_MAX) {
+            for (i = 0; i < BATCH_MAX; i++) g_z24[i] = base + i;
+            gc_gx_z16_compress(g_c16, g_z24, BATCH_MAX, fmt);
+            for (i = 0; i < BATCH_MAX; i++) {
+                CHECK(g_c16[i] == GXCompressZ16(base + i, fmt),
+                      "L7 exhaustive compress: z24=0x%06X fmt=%u batch=0x%04X port=0x%04X",
+                      base + i, fmt, g_c16[i], GXCompressZ16(base + i, fmt));
+            }
+        }
+    }
+    return 1;
+}
+
 /* ═══════════════════════════════════════════════════════════════════
  * Per-seed runner
  * ═══════════════════════════════════════════════════════════════════ */
 
-static int run_seed(uint32_t seed) {
+static int run_seed(uint32_t seed, int first) {
     g_rng = seed;
     if (!g_opt_op || strstr("L0", g_opt_op) || strstr("PARITY", g_opt_op)) {
         if (!test_L0_parity()) return 0;
@@ -388,6 +480,12 @@ static int run_seed(uint32_t seed) {
     if (!g_opt_op || strstr("L5", g_opt_op) || strstr("FULL", g_opt_op) || strstr("MIX", g_opt_op) || strstr("RANDOM", g_opt_op)) {
         if (!test_L5_random_integration()) return 0;
     }
+    if (!g_opt_op || strstr("L6", g_opt_op) || strstr("BATCH", g_opt_op)) {
+        if (!test_L6_batch()) return 0;
+    }
+    if (!g_opt_op || strstr("L7", g_opt_op) || strstr("EXHAUSTIVE", g_opt_op)) {
+        if (first && !test_L7_exhaustive_batch()) return 0;
+    }
     return 1;
 }
 
@@ -412,7 +510,7 @@ int main(int argc, char **argv) {
         else {
             fprintf(stderr,
                     "Usage: gxz16_property_test [--seed=N] [--num-runs=N] "
-                    "[--op=L0|L1|L2|L3|L4|L5|PARITY|ROUNDTRIP|IDEMPOTENCE|RANGE|EXHAUSTIVE|FULL|MIX] [-v]\n");
+                    "[--op=L0|L1|L2|L3|L4|L5|L6|L7|PARITY|ROUNDTRIP|IDEMPOTENCE|RANGE|EXHAUSTIVE|FULL|MIX|BATCH] [-v]\n");
             return 2;
         }
     }
@@ -423,7 +521,7 @@ int main(int argc, char **argv) {
         uint32_t seed = start_seed + (uint32_t)i;
         uint64_t before = g_total_checks;
 
-        if (!run_seed(seed)) {
+        if (!run_seed(seed, i == 0)) {
             printf("  FAILED at seed %u\n", seed);
             printf("\n--- Summary ---\n");
             printf("Seeds:  %d (failed at %d)\n", i + 1, i + 1);
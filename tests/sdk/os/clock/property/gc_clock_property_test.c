@@ -0,0 +1,579 @@
+/*
+ * gc_clock_property_test.c --- Property-based test for the virtual clock.
+ *
+ * Oracle: a naive scheduler (flat array, linear scan for the earliest
+ *         (when, seq)) with the same tie rules as gc_clock.h.
+ * Port:   linked from src/sdk_port/gc_clock.c, plus OSAlarm.c as a source.
+ *
+ * Levels:
+ *   L0 — Order: random one-shot and periodic events, some of which schedule
+ *        follow-ups when they fire; the firing sequence (id, time) matches
+ *        the oracle step for step
+ *   L1 — run_until: everything due up to the limit fires, nothing after it,
+ *        and the clock is left at the limit
+ *   L2 — Cancel: cancel/pending agree with the oracle, a stale id never
+ *        cancels the event that reused its slot
+ *   L3 — Enable/disable: queued events are dropped, the epoch moves, and
+ *        nothing schedules while the clock is off
+ *   L4 — OSAlarm source: alarms and events due at the same ticks fire in
+ *        one merged order (events first), periodic alarms re-arm
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "gc_clock.h"
+#include "gc_mem.h"
+#include "OSAlarm.h"
+
+/* ── xorshift32 PRNG ────────────────────────────────────────────── */
+static uint32_t g_rng;
+static uint32_t xorshift32(void) {
+    uint32_t x = g_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rng = x;
+    return x;
+}
+
+/* ── Counters ───────────────────────────────────────────────────── */
+static uint64_t g_total_checks;
+static uint64_t g_total_pass;
+static int       g_verbose;
+static const char *g_opt_op;
+
+#define CHECK(cond, ...) do { \
+    g_total_checks++; \
+    if (!(cond)) { \
+        printf("FAIL @ %s:%d: ", __FILE__, __LINE__); \
+        printf(__VA_ARGS__); printf("\n"); \
+        return 0; \
+    } \
+    g_total_pass++; \
+} while(0)
+
+/* ═══════════════════════════════════════════════════════════════════
+ * ORACLE — flat array, linear scan
+ * ═══════════════════════════════════════════════════════════════════ */
+
+#define MAX_EVENTS 1024
+#define MAX_LOG    8192
+
+typedef struct {
+    int live;
+    uint64_t when;
+    uint64_t seq;
+    uint64_t period;
+    uint32_t arg;
+} OracleEvent;
+
+static OracleEvent o_ev[MAX_EVENTS];
+static uint32_t p_id[MAX_EVENTS]; /* port event id per oracle slot */
+static uint64_t o_now;
+static uint64_t o_seq;
+
+/* Oracle alarm: fire time and insertion order (equal fire times are FIFO,
+ * like InsertAlarm's `next->fire <= fire` walk). */
+typedef struct {
+    int live;
+    int64_t fire;
+    uint64_t order;
+    int64_t period;
+    int64_t start;
+} OracleAlarm;
+
+#define MAX_ALARMS 64
+static OracleAlarm o_al[MAX_ALARMS];
+static uint64_t o_al_order;
+
+/* Fired log: arg | (kind << 24), and the time it fired. */
+typedef struct {
+    uint32_t what;
+    uint64_t when;
+} LogEntry;
+
+static LogEntry o_log[MAX_LOG], p_log[MAX_LOG];
+static int o_log_n, p_log_n;
+
+#define LOG_ALARM 0x01000000u
+
+static void log_push(LogEntry *log, int *n, uint32_t what, uint64_t when) {
+    if (*n < MAX_LOG) {
+        log[*n].what = what;
+        log[*n].when = when;
+    }
+    (*n)++;
+}
+
+/* Events whose arg has bit 15 set schedule a follow-up (arg + 1, bit 15
+ * cleared) this many ticks later when they fire. */
+#define FOLLOW_BIT 0x8000u
+static uint64_t follow_delay(uint32_t arg) { return (arg * 7u) % 5u; }
+
+static int o_schedule(uint64_t when, uint64_t period, uint32_t arg) {
+    int i;
+    for (i = 0; i < MAX_EVENTS; i++) {
+        if (!o_ev[i].live) {
+            o_ev[i].live = 1;
+            o_ev[i].when = when < o_now ? o_now : when;
+            o_ev[i].seq = o_seq++;
+            o_ev[i].period = period;
+            o_ev[i].arg = arg;
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int o_earliest_event(void) {
+    int i, best = -1;
+    for (i = 0; i < MAX_EVENTS; i++) {
+        if (!o_ev[i].live) continue;
+        if (best < 0 || o_ev[i].when < o_ev[best].when ||
+            (o_ev[i].when == o_ev[best].when && o_ev[i].seq < o_ev[best].seq)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+static int o_earliest_alarm(void) {
+    int i, best = -1;
+    for (i = 0; i < MAX_ALARMS; i++) {
+        if (!o_al[i].live) continue;
+        if (best < 0 || o_al[i].fire < o_al[best].fire ||
+            (o_al[i].fire == o_al[best].fire && o_al[i].order < o_al[best].order)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+static void o_alarm_insert(int i, int64_t fire, int64_t sys) {
+    if (o_al[i].period > 0) {
+        fire = o_al[i].start;
+        if (o_al[i].start < sys) {
+            fire += o_al[i].period * ((sys - o_al[i].start) / o_al[i].period + 1);
+        }
+    }
+    o_al[i].live = 1;
+    o_al[i].fire = fire;
+    o_al[i].order = o_al_order++;
+}
+
+/* One oracle step up to `limit`; mirrors fire_one + alarm_clock_fire. */
+static int o_step(uint64_t limit) {
+    const int e = o_earliest_event();
+    const int a = o_earliest_alarm();
+    uint64_t et = e >= 0 ? o_ev[e].when : GC_CLOCK_NEVER;
+    uint64_t at = GC_CLOCK_NEVER;
+
+    if (a >= 0) at = o_al[a].fire < (int64_t)o_now ? o_now : (uint64_t)o_al[a].fire;
+    if (e >= 0 && et <= at && et <= limit) {
+        const uint32_t arg = o_ev[e].arg;
+        o_now = et;
+        if (o_ev[e].period) {
+            o_ev[e].when += o_ev[e].period;
+            o_ev[e].seq = o_seq++;
+        } else {
+            o_ev[e].live = 0;
+        }
+        log_push(o_log, &o_log_n, arg, o_now);
+        if (arg & FOLLOW_BIT) {
+            const int f = o_schedule(o_now + follow_delay(arg), 0, (arg & ~FOLLOW_BIT) + 1u);
+            if (f >= 0) p_id[f] = 0; /* the port's id is not known here */
+        }
+        return 1;
+    }
+    if (a >= 0 && at <= limit) {
+        int i;
+        o_now = at;
+        while ((i = o_earliest_alarm()) >= 0 && o_al[i].fire <= (int64_t)o_now) {
+            o_al[i].live = 0;
+            if (o_al[i].period > 0) o_alarm_insert(i, 0, (int64_t)o_now + 1);
+            log_push(o_log, &o_log_n, LOG_ALARM | (uint32_t)i, o_now);
+        }
+        return 1;
+    }
+    return 0;
+}
+
+static uint32_t o_run_until(uint64_t when) {
+    uint32_t n = 0;
+    while (o_step(when)) n++;
+    if (when > o_now) o_now = when;
+    return n;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * PORT — gc_clock.c (+ OSAlarm.c as a source)
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static void p_event(void *ctx, uint32_t arg) {
+    (void)ctx;
+    log_push(p_log, &p_log_n, arg, gc_clock_now());
+    if (arg & FOLLOW_BIT) {
+        gc_clock_schedule(GC_CLOCK_USER, gc_clock_now() + follow_delay(arg), 0,
+                          p_event, NULL, (arg & ~FOLLOW_BIT) + 1u);
+    }
+}
+
+#define GC_ALARM_BASE 0x80001000u
+#define ALARM_ADDR(i) (GC_ALARM_BASE + (uint32_t)(i) * PORT_ALARM_SIZE)
+static uint8_t gc_alarm_backing[MAX_ALARMS * PORT_ALARM_SIZE];
+static port_OSAlarmState p_alarms;
+
+static void p_alarm_fired(port_OSAlarmState *st, uint32_t alarm) {
+    (void)st;
+    log_push(p_log, &p_log_n,
+             LOG_ALARM | ((alarm - GC_ALARM_BASE) / PORT_ALARM_SIZE), gc_clock_now());
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Test infrastructure
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static void init_both(uint64_t start) {
+    memset(o_ev, 0, sizeof(o_ev));
+    memset(o_al, 0, sizeof(o_al));
+    memset(p_id, 0, sizeof(p_id));
+    o_now = start;
+    o_seq = 0;
+    o_al_order = 0;
+    o_log_n = p_log_n = 0;
+    gc_clock_enable(start);
+}
+
+static int compare_logs(const char *label) {
+    int i;
+    CHECK(o_log_n == p_log_n, "%s: fired %d (oracle) vs %d (port)", label, o_log_n, p_log_n);
+    for (i = 0; i < o_log_n && i < MAX_LOG; i++) {
+        CHECK(o_log[i].what == p_log[i].what && o_log[i].when == p_log[i].when,
+              "%s: firing %d: oracle %#x@%llu port %#x@%llu", label, i,
+              o_log[i].what, (unsigned long long)o_log[i].when,
+              p_log[i].what, (unsigned long long)p_log[i].when);
+    }
+    CHECK(o_now == gc_clock_now(), "%s: now oracle=%llu port=%llu", label,
+          (unsigned long long)o_now, (unsigned long long)gc_clock_now());
+    return 1;
+}
+
+/* Random event: small time range so ties are common. */
+static void schedule_both(uint32_t arg) {
+    const uint64_t when = o_now + (xorshift32() % 64u);
+    const uint64_t period = (xorshift32() % 8u) == 0 ? 1u + xorshift32() % 16u : 0u;
+    int o;
+
+    if (xorshift32() % 4u == 0) arg |= FOLLOW_BIT;
+    o = o_schedule(when, period, arg);
+    if (o >= 0) {
+        p_id[o] = gc_clock_schedule(GC_CLOCK_USER, when, period, p_event, NULL, arg);
+    }
+}
+
+static void cancel_periodic_both(void) {
+    int i;
+    for (i = 0; i < MAX_EVENTS; i++) {
+        if (o_ev[i].live && o_ev[i].period) {
+            o_ev[i].live = 0;
+            gc_clock_cancel(p_id[i]);
+        }
+    }
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L0 — Order
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_order(uint32_t seed) {
+    int round, i;
+    g_rng = seed;
+    init_both(1000u + (xorshift32() % 1000u));
+
+    for (round = 0; round < 8; round++) {
+        const int n = 1 + (int)(xorshift32() % 48u);
+        for (i = 0; i < n; i++) schedule_both((uint32_t)(round * 64 + i));
+        for (i = 0; i < 64; i++) {
+            const int o = o_step(GC_CLOCK_NEVER);
+            const int p = gc_clock_step();
+            CHECK(o == p, "L0: step %d oracle=%d port=%d", i, o, p);
+            if (!o) break;
+        }
+        if (!compare_logs("L0")) return 0;
+    }
+    cancel_periodic_both();
+    while (o_step(GC_CLOCK_NEVER)) {}
+    while (gc_clock_step()) {}
+    if (!compare_logs("L0 drain")) return 0;
+    CHECK(gc_clock_next() == GC_CLOCK_NEVER, "L0: queue not empty after drain");
+    CHECK(gc_clock_step() == 0, "L0: step on empty queue fired");
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L1 — run_until
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_run_until(uint32_t seed) {
+    int round, i;
+    g_rng = seed;
+    init_both(xorshift32() % 100u);
+
+    for (round = 0; round < 16; round++) {
+        const int n = (int)(xorshift32() % 24u);
+        uint64_t limit;
+        uint32_t on, pn;
+
+        for (i = 0; i < n; i++) schedule_both((uint32_t)(round * 32 + i));
+        limit = o_now + (xorshift32() % 80u);
+        if (xorshift32() % 2u) {
+            on = o_run_until(limit);
+            pn = gc_clock_run_until(limit);
+        } else {
+            const uint64_t d = limit - o_now;
+            on = o_run_until(limit);
+            pn = gc_clock_advance(d);
+        }
+        CHECK(on == pn, "L1: round %d fired oracle=%u port=%u", round, on, pn);
+        CHECK(gc_clock_now() == limit, "L1: now %llu != limit %llu",
+              (unsigned long long)gc_clock_now(), (unsigned long long)limit);
+        CHECK(gc_clock_next() > limit, "L1: event due at %llu left behind",
+              (unsigned long long)gc_clock_next());
+        if (!compare_logs("L1")) return 0;
+    }
+    /* run_until into the past leaves time alone */
+    {
+        const uint64_t now = gc_clock_now();
+        gc_clock_run_until(now / 2u);
+        CHECK(gc_clock_now() == now, "L1: run_until(past) moved time");
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L2 — Cancel
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_cancel(uint32_t seed) {
+    int i, round;
+    g_rng = seed;
+    init_both(0);
+
+    for (round = 0; round < 6; round++) {
+        const int n = 8 + (int)(xorshift32() % 64u);
+        for (i = 0; i < n; i++) schedule_both((uint32_t)(round * 128 + i) & 0x7FFFu);
+        for (i = 0; i < MAX_EVENTS; i++) {
+            if (!p_id[i] || xorshift32() % 3u) continue;
+            CHECK(gc_clock_pending(p_id[i]) == o_ev[i].live,
+                  "L2: pending(slot %d) port=%d oracle=%d", i,
+                  gc_clock_pending(p_id[i]), o_ev[i].live);
+            CHECK(gc_clock_cancel(p_id[i]) == o_ev[i].live, "L2: cancel(slot %d)", i);
+            CHECK(gc_clock_cancel(p_id[i]) == 0, "L2: second cancel(slot %d) succeeded", i);
+            o_ev[i].live = 0;
+        }
+        /* Stale ids: every released slot is reused by the next schedules;
+         * the old ids must not touch the new events. */
+        {
+            uint32_t stale[MAX_EVENTS];
+            int ns = 0;
+            for (i = 0; i < MAX_EVENTS; i++) {
+                if (p_id[i] && !o_ev[i].live) stale[ns++] = p_id[i];
+            }
+            for (i = 0; i < 16; i++) schedule_both(0x7000u + (uint32_t)i);
+            for (i = 0; i < ns; i++) {
+                CHECK(gc_clock_cancel(stale[i]) == 0, "L2: stale id %#x cancelled", stale[i]);
+            }
+        }
+        for (i = 0; i < 8; i++) {
+            o_step(GC_CLOCK_NEVER);
+            gc_clock_step();
+        }
+        if (!compare_logs("L2")) return 0;
+    }
+    CHECK(gc_clock_cancel(0) == 0, "L2: cancel(0)");
+    CHECK(gc_clock_pending(0xFFFFFFFFu) == 0, "L2: pending(bogus)");
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L3 — Enable/disable
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_enable(uint32_t seed) {
+    uint32_t epoch, id;
+    gc_clock_stats stats;
+    int i;
+    g_rng = seed;
+    init_both(500);
+
+    for (i = 0; i < 20; i++) schedule_both((uint32_t)i);
+    epoch = gc_clock_epoch();
+    gc_clock_disable();
+    CHECK(gc_clock_epoch() != epoch, "L3: disable kept the epoch");
+    CHECK(!gc_clock_enabled(), "L3: still enabled");
+    CHECK(gc_clock_step() == 0, "L3: step while disabled fired");
+    CHECK(gc_clock_advance(1000) == 0, "L3: advance while disabled fired");
+    CHECK(gc_clock_schedule(GC_CLOCK_USER, 0, 0, p_event, NULL, 1) == 0,
+          "L3: schedule while disabled");
+    CHECK(p_log_n == 0, "L3: something fired while disabled");
+
+    epoch = gc_clock_epoch();
+    gc_clock_enable(42);
+    CHECK(gc_clock_epoch() != epoch, "L3: enable kept the epoch");
+    CHECK(gc_clock_now() == 42, "L3: enable(42) now=%llu", (unsigned long long)gc_clock_now());
+    CHECK(gc_clock_next() == GC_CLOCK_NEVER, "L3: events survived re-enable");
+    gc_clock_get_stats(&stats);
+    CHECK(stats.queued == 0 && stats.steps == 0, "L3: stats not reset");
+
+    id = gc_clock_schedule(GC_CLOCK_DVD, 10, 0, p_event, NULL, 7);
+    CHECK(id != 0, "L3: schedule after enable");
+    CHECK(gc_clock_step() == 1 && p_log_n == 1 && p_log[0].when == 42,
+          "L3: event in the past not clamped to now");
+    gc_clock_get_stats(&stats);
+    CHECK(stats.fired[GC_CLOCK_DVD] == 1 && stats.peak == 1, "L3: per-kind stats");
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * L4 — OSAlarm source
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int test_alarm_source(uint32_t seed) {
+    int i, round;
+    g_rng = seed;
+    init_both(100);
+
+    memset(gc_alarm_backing, 0, sizeof(gc_alarm_backing));
+    port_OSAlarmInit(&p_alarms);
+    for (i = 0; i < MAX_ALARMS; i++) port_OSCreateAlarm(ALARM_ADDR(i));
+    CHECK(port_OSAlarmAttachClock(&p_alarms, p_alarm_fired) == 0, "L4: attach");
+
+    for (round = 0; round < 10; round++) {
+        const int n = (int)(xorshift32() % 12u);
+        for (i = 0; i < n; i++) {
+            const int a = (int)(xorshift32() % MAX_ALARMS);
+            if (o_al[a].live) {
+                o_al[a].live = 0;
+                port_OSCancelAlarm(&p_alarms, ALARM_ADDR(a));
+            }
+            if (xorshift32() % 6u == 0) {
+                const int64_t start = (int64_t)o_now + (int64_t)(xorshift32() % 32u) - 8;
+                const int64_t period = 1 + (int64_t)(xorshift32() % 24u);
+                o_al[a].period = period;
+                o_al[a].start = start;
+                o_alarm_insert(a, 0, (int64_t)o_now);
+                port_OSSetPeriodicAlarm(&p_alarms, ALARM_ADDR(a), start, period);
+            } else {
+                const int64_t tick = (int64_t)(xorshift32() % 48u);
+                o_al[a].period = 0;
+                o_alarm_insert(a, (int64_t)o_now + tick, (int64_t)o_now);
+                port_OSSetAlarm(&p_alarms, ALARM_ADDR(a), tick);
+            }
+        }
+        for (i = 0; i < (int)(xorshift32() % 16u); i++) schedule_both((uint32_t)(round * 16 + i));
+
+        if (xorshift32() % 2u) {
+            const uint64_t limit = o_now + (xorshift32() % 64u);
+            o_run_until(limit);
+            gc_clock_run_until(limit);
+        } else {
+            for (i = 0; i < 24; i++) {
+                const int o = o_step(GC_CLOCK_NEVER);
+                const int p = gc_clock_step();
+                CHECK(o == p, "L4: step %d oracle=%d port=%d", i, o, p);
+                if (!o) break;
+            }
+        }
+        if (!compare_logs("L4")) return 0;
+    }
+
+    /* Detached, the queue keeps its alarms but the clock no longer sees them. */
+    port_OSAlarmDetachClock(&p_alarms);
+    cancel_periodic_both();
+    round = p_log_n;
+    gc_clock_run_until(gc_clock_now() + 1000u);
+    for (i = round; i < p_log_n && i < MAX_LOG; i++) {
+        CHECK(!(p_log[i].what & LOG_ALARM), "L4: alarm fired after detach");
+    }
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Runner
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int op_enabled(const char *a, const char *b) {
+    return !g_opt_op || strcmp(g_opt_op, a) == 0 || strcmp(g_opt_op, b) == 0;
+}
+
+static int run_seed(uint32_t seed) {
+    if (op_enabled("L0", "ORDER") && !test_order(seed)) return 0;
+    if (op_enabled("L1", "RUN_UNTIL") && !test_run_until(seed)) return 0;
+    if (op_enabled("L2", "CANCEL") && !test_cancel(seed)) return 0;
+    if (op_enabled("L3", "ENABLE") && !test_enable(seed)) return 0;
+    if (op_enabled("L4", "ALARM") && !test_alarm_source(seed)) return 0;
+    gc_clock_disable();
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    uint32_t start_seed = 1;
+    int num_runs = 200;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+            start_seed = (uint32_t)strtoul(argv[i] + 7, NULL, 0);
+        else if (strncmp(argv[i], "--num-runs=", 11) == 0)
+            num_runs = atoi(argv[i] + 11);
+        else if (strncmp(argv[i], "--op=", 5) == 0)
+            g_opt_op = argv[i] + 5;
+        else if (strcmp(argv[i], "-v") == 0)
+            g_verbose = 1;
+        else {
+            fprintf(stderr,
+                    "Usage: gc_clock_property_test [--seed=N] [--num-runs=N] "
+                    "[--op=L0|L1|L2|L3|L4|ORDER|RUN_UNTIL|CANCEL|ENABLE|ALARM] [-v]\n");
+            return 2;
+        }
+    }
+
+    gc_mem_set(GC_ALARM_BASE, sizeof(gc_alarm_backing), gc_alarm_backing);
+
+    printf("\n=== gc_clock Property Test ===\n");
+
+    for (i = 0; i < num_runs; i++) {
+        uint32_t seed = start_seed + (uint32_t)i;
+        uint64_t before = g_total_checks;
+
+        if (seed == 0) seed = 1; /* xorshift32 sticks at 0 */
+        if (!run_seed(seed)) {
+            printf("  FAILED at seed %u\n", seed);
+            printf("\n--- Summary ---\n");
+            printf("Seeds:  %d (failed at %d)\n", i + 1, i + 1);
+            printf("Checks: %llu  (pass=%llu  fail=1)\n",
+                   g_total_checks, g_total_pass);
+            printf("\nRESULT: FAIL\n");
+            return 1;
+        }
+
+        if (g_verbose) {
+            printf("  seed %u: %llu checks OK\n",
+                   seed, g_total_checks - before);
+        }
+        if ((i + 1) % 100 == 0) {
+            printf("  progress: seed %d/%d\n", i + 1, num_runs);
+        }
+    }
+
+    printf("\n--- Summary ---\n");
+    printf("Seeds:  %d\n", num_runs);
+    printf("Checks: %llu  (pass=%llu  fail=0)\n",
+           g_total_checks, g_total_pass);
+    printf("\nRESULT: %llu/%llu PASS\n", g_total_pass, g_total_checks);
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""Fixture checks for tools/osalloc_prof_summary.py.
+
+Builds small profiler logs by hand (layout in src/sdk_port/os/OSAlloc.h)
+and checks the summary lines they produce.
+"""
+import struct
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+REPO = Path(__file__).resolve().parents[5]
+TOOL = REPO / "tools" / "osalloc_prof_summary.py"
+
+RECORD = struct.Struct("<BBHIII")
+ALLOC, FIXED, FREE, ADD, CREATE, DESTROY, HEAP, FRAME, NAME = range(1, 10)
+
+failures = 0
+
+
+def expect(label, ok):
+    global failures
+    if not ok:
+        print(f"FAIL {label}", file=sys.stderr)
+        failures += 1
+
+
+def summary(records):
+    log = b"OSAP" + struct.pack("<III", 1, RECORD.size, 0)
+    for r in records:
+        log += RECORD.pack(*r)
+    with tempfile.TemporaryDirectory() as tmp:
+        path = Path(tmp) / "prof.bin"
+        path.write_bytes(log)
+        out = subprocess.run([sys.executable, str(TOOL), str(path)],
+                             check=True, capture_output=True, text=True).stdout
+    return [line.strip() for line in out.splitlines()]
+
+
+def line(lines, prefix):
+    return next((l for l in lines if l.startswith(prefix)), "")
+
+
+# Profiling started mid-session: the first free is of a block the log never
+# saw allocated. It counts as a free but must not touch live bytes.
+lines = summary([
+    (CREATE, 0, 0, 0x80001000, 0x1000, 0),
+    (FREE, 0, 0, 0x80001020, 0x80, 0),
+    (ALLOC, 0, 0, 0x80001100, 0x40, 0x80),
+])
+expect("pre-start free counted", line(lines, "allocs") == "allocs 1 (fixed 0)  failed 0  frees 1")
+expect("pre-start free leaves live bytes",
+       line(lines, "peak live") == "peak live 0x80 bytes / 1 blocks (frame 0)  end live 0x80 bytes / 1 blocks")
+expect("pre-start free leaves tag live", line(lines, "0 ").split() == ["0", "1", "0x80", "0x80", "0x80"])
+
+# A free of a logged block still returns its cell to the heap and its tag.
+lines = summary([
+    (CREATE, 0, 0, 0x80001000, 0x1000, 0),
+    (ALLOC, 0, 3, 0x80001020, 0x40, 0x80),
+    (ALLOC, 0, 3, 0x800010A0, 0x20, 0x40),
+    (FREE, 0, 0, 0x80001020, 0x80, 0),
+])
+expect("logged free",
+       line(lines, "peak live") == "peak live 0xc0 bytes / 2 blocks (frame 0)  end live 0x40 bytes / 1 blocks")
+expect("logged free tag", line(lines, "3 ").split() == ["3", "2", "0xc0", "0xc0", "0x40"])
+
+if failures:
+    print(f"osalloc_prof_summary_test: {failures} failure(s)", file=sys.stderr)
+    sys.exit(1)
+print("osalloc_prof_summary_test: PASS")
@@ -23,6 +23,7 @@
 #include "harness/gc_host_ram.h"
 #include "gc_mem.h"
 #include "sdk_state.h"
+#include "os/OSAlloc.h"
 
 /* Port API (sdk_port) */
 extern void *OSInitAlloc(void *arenaStart, void *arenaEnd, int maxHeaps);
@@ -41,6 +42,9 @@ extern uint32_t port_DLExtract(uint32_t list, uint32_t cell);
 extern uint32_t port_DLInsert(uint32_t list, uint32_t cell);
 extern uint32_t port_DLLookup(uint32_t list, uint32_t cell);
 
+extern void *OSAllocFixed(uint32_t size);
+extern uint32_t __gc_osalloc_heap_array;
+
 /* ── Config ── */
 
 #define GC_BASE       0x80000000u
@@ -466,6 +470,14 @@ static int run_alloc_free_mix(uint32_t seed, int run_idx, int steps, int alloc_o
             fail_case(seed, run_idx, step, alloc_only ? "OSAllocFromHeap" : "full", "OSCheckHeap free-bytes mismatch");
             return 1;
         }
+        if (port_OSCheckHeapIncremental(p_heap) != p_free) {
+            fail_case(seed, run_idx, step, alloc_only ? "OSAllocFromHeap" : "full", "incremental OSCheckHeap mismatch");
+            return 1;
+        }
+        if (port_OSAllocIndexCheck(p_heap) != 0) {
+            fail_case(seed, run_idx, step, alloc_only ? "OSAllocFromHeap" : "full", "free-cell index out of sync");
+            return 1;
+        }
     }
     return 0;
 }
@@ -541,6 +553,14 @@ static int run_free_heavy_mix(uint32_t seed, int run_idx, int steps) {
             fail_case(seed, run_idx, step, "OSFreeToHeap", "OSCheckHeap free-bytes mismatch");
             return 1;
         }
+        if (port_OSCheckHeapIncremental(p_heap) != p_free) {
+            fail_case(seed, run_idx, step, "OSFreeToHeap", "incremental OSCheckHeap mismatch");
+            return 1;
+        }
+        if (port_OSAllocIndexCheck(p_heap) != 0) {
+            fail_case(seed, run_idx, step, "OSFreeToHeap", "free-cell index out of sync");
+            return 1;
+        }
     }
     return 0;
 }
@@ -609,6 +629,7 @@ static int test_OSAddToHeap(uint32_t seed) {
     long p_after = OSCheckHeap(p_heap);
     if ((long)o_after != p_after) return 1;
     if (o_after <= o_before) return 1;
+    if (port_OSAllocIndexCheck(p_heap) != 0) return 1;
 
     /* Allocation should still be consistent */
     o32 o_ptr = oracle_OSAllocFromHeap(o_heap, 0x800);
@@ -617,6 +638,428 @@ static int test_OSAddToHeap(uint32_t seed) {
     return 0;
 }
 
+/*
+ * FreeIndex: the port keeps a host-side index of each heap's free list. Edit
+ * the list behind its back (new head cell, moved backing buffer, unsorted
+ * list) and check the allocator still matches the oracle, resyncing where it
+ * can and walking the list where it can't.
+ */
+static int test_FreeIndex(uint32_t seed) {
+    uint32_t rng = seed ? seed : 1;
+
+    const o32 o_heap_base = 0x8000;
+    const uint32_t p_heap_base = PORT_ARENA_LO + 0x8000;
+
+    int32_t o_heap;
+    int p_heap;
+    if (setup_one_heap(o_heap_base, o_heap_base + 0x80000, p_heap_base, p_heap_base + 0x80000,
+                       &o_heap, &p_heap) != 0) {
+        fail_case(seed, 0, 0, "FreeIndex", "heap setup failed");
+        return 1;
+    }
+    struct oracle_HeapDesc *ohd = OHD(oracle_HeapArray + (o32)(o_heap * 12));
+    const uint32_t phd = __gc_osalloc_heap_array + (uint32_t)p_heap * 12u;
+    if (!ohd) return 1;
+
+    for (int phase = 0; phase < 3; phase++) {
+        /* Fragment the heap. */
+        for (int i = 0; i < 48 && g_alloc_count < MAX_ALLOCS; i++) {
+            uint32_t size = 1 + (xorshift32(&rng) % 0x800u);
+            o32 o_ptr = oracle_OSAllocFromHeap(o_heap, size);
+            void *p_ptr = OSAllocFromHeap(p_heap, size);
+            if (compare_alloc_result(o_ptr, p_ptr, o_heap_base, p_heap_base) != 0) {
+                fail_case(seed, phase, i, "FreeIndex", "prefill alloc return mismatch");
+                return 1;
+            }
+            if (o_ptr != 0) alloc_push(o_heap, o_ptr, p_ptr);
+        }
+        for (int i = 0; i < 16 && g_alloc_count > 0; i++) {
+            int idx = alloc_pick_index(&rng);
+            oracle_OSFreeToHeap(o_heap, g_allocs[idx].oracle_ptr);
+            OSFreeToHeap(p_heap, g_allocs[idx].port_ptr);
+            alloc_remove_index(idx);
+        }
+        if (port_OSAllocIndexCheck(p_heap) != 0) {
+            fail_case(seed, phase, 0, "FreeIndex", "index out of sync before edit");
+            return 1;
+        }
+
+        if (phase == 0) {
+            /* Out-of-band DLInsert of a region below the heap: new list head. */
+            const uint32_t rel = 0x4000u + (xorshift32(&rng) % 4u) * 0x400u;
+            struct oracle_Cell *oc = OCELL(rel);
+            if (!oc) return 1;
+            oc->size = 0x400;
+            oc->hd = 0;
+            ohd->free = oracle_DLInsert(ohd->free, rel);
+            ohd->size += 0x400;
+            port_cell_write(PORT_ARENA_LO + rel, 0, 0, 0x400, 0);
+            store_u32be(phd + 4, port_DLInsert(load_u32be(phd + 4), PORT_ARENA_LO + rel));
+            store_u32be(phd + 0, load_u32be(phd + 0) + 0x400u);
+        } else if (phase == 1) {
+            /* Same contents, new backing buffer. */
+            uint8_t *copy = (uint8_t *)malloc(g_ram.size);
+            if (!copy) die("malloc failed");
+            memcpy(copy, g_ram.buf, g_ram.size);
+            free(g_ram.buf);
+            g_ram.buf = copy;
+            gc_mem_set(g_ram.base, g_ram.size, g_ram.buf);
+        } else {
+            /* Move the last free cell to the front: the list is no longer sorted. */
+            o32 o_last = ohd->free;
+            uint32_t p_last = load_u32be(phd + 4);
+            while (o_last != 0 && OCELL(o_last)->next != 0) o_last = OCELL(o_last)->next;
+            while (p_last != 0 && port_cell_next(p_last) != 0) p_last = port_cell_next(p_last);
+            if (o_last == 0 || p_last == 0) return 1;
+            ohd->free = oracle_DLAddFront(oracle_DLExtract(ohd->free, o_last), o_last);
+            store_u32be(phd + 4, port_DLAddFront(port_DLExtract(load_u32be(phd + 4), p_last), p_last));
+        }
+        if (port_OSAllocIndexCheck(p_heap) != 1) {
+            fail_case(seed, phase, 0, "FreeIndex", "edit went unnoticed");
+            return 1;
+        }
+
+        for (int step = 0; step < 64; step++) {
+            if (g_alloc_count > 0 && (xorshift32(&rng) % 3u) == 0u) {
+                int idx = alloc_pick_index(&rng);
+                oracle_OSFreeToHeap(o_heap, g_allocs[idx].oracle_ptr);
+                OSFreeToHeap(p_heap, g_allocs[idx].port_ptr);
+                alloc_remove_index(idx);
+            } else if (g_alloc_count < MAX_ALLOCS) {
+                uint32_t size = 1 + (xorshift32(&rng) % 0x1000u);
+                o32 o_ptr = oracle_OSAllocFromHeap(o_heap, size);
+                void *p_ptr = OSAllocFromHeap(p_heap, size);
+                if (compare_alloc_result(o_ptr, p_ptr, o_heap_base, p_heap_base) != 0) {
+                    fail_case(seed, phase, step, "FreeIndex", "alloc return mismatch");
+                    return 1;
+                }
+                if (o_ptr != 0) alloc_push(o_heap, o_ptr, p_ptr);
+            }
+            /* The port's OSCheckHeap rejects an unsorted free list; the oracle's doesn't. */
+            if (phase < 2 && (long)oracle_OSCheckHeap(o_heap) != OSCheckHeap(p_heap)) {
+                fail_case(seed, phase, step, "FreeIndex", "OSCheckHeap free-bytes mismatch");
+                return 1;
+            }
+            if (compare_lists("FreeIndex", seed, phase, step, ohd->free, load_u32be(phd + 4),
+                              0, PORT_ARENA_LO) != 0) {
+                return 1;
+            }
+            /* A sorted list must be indexed again; an unsorted one walked. */
+            int rc = port_OSAllocIndexCheck(p_heap);
+            if (rc < 0 || (phase < 2 && rc != 0)) {
+                fail_case(seed, phase, step, "FreeIndex", "index not resynced");
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+ * Profiler: drive a random alloc/free mix (with OSAllocFixed and OSAddToHeap)
+ * under the allocation profiler, then check the log record by record and the
+ * counters against what the oracle saw. Frame snapshots and port_OSHeapFree
+ * must match the oracle's free list.
+ */
+typedef struct {
+    uint8_t kind;
+    uint8_t heap;
+    uint16_t tag;
+    uint32_t a, b, c;
+} ProfRec;
+
+static void oracle_free_stats(o32 list, port_OSHeapFreeStats *out) {
+    memset(out, 0, sizeof(*out));
+    for (o32 it = list; it != 0; it = OCELL(it)->next) {
+        uint32_t size = (uint32_t)OCELL(it)->size;
+        out->free_bytes += size;
+        if (size > out->largest) out->largest = size;
+        out->cells++;
+    }
+}
+
+static int test_Profiler(uint32_t seed) {
+    uint32_t rng = seed ? seed : 1;
+
+    const o32 o_heap_base = 0x4000;
+    const uint32_t p_heap_base = PORT_ARENA_LO + 0x4000;
+
+    int32_t o_heap;
+    int p_heap;
+    if (setup_one_heap(o_heap_base, o_heap_base + 0x40000, p_heap_base, p_heap_base + 0x40000,
+                       &o_heap, &p_heap) != 0) {
+        fail_case(seed, 0, 0, "Profiler", "heap setup failed");
+        return 1;
+    }
+    struct oracle_HeapDesc *ohd = OHD(oracle_HeapArray + (o32)(o_heap * 12));
+    if (!ohd) return 1;
+
+    enum { STEPS = 160, MAX_RECS = STEPS * 2 + 64 };
+    static ProfRec want[MAX_RECS];
+    int n_want = 0;
+    port_OSAllocProfHeap model;
+    memset(&model, 0, sizeof(model));
+
+    FILE *log = tmpfile();
+    if (!log) die("tmpfile failed");
+    if (!port_OSAllocProfStart(log)) die("profiler start failed");
+
+    static const char name[] = "osalloc-property-tag";
+    port_OSAllocProfName(3, name);
+    want[n_want++] = (ProfRec){PORT_OSALLOC_PROF_NAME, 0xFF, 3, (uint32_t)strlen(name), 0, 0};
+
+    uint16_t tag = 0;
+    uint32_t frame = 0;
+    for (int step = 0; step < STEPS; step++) {
+        if ((xorshift32(&rng) & 7u) == 0u) {
+            tag = (uint16_t)(xorshift32(&rng) % 4u);
+            port_OSAllocProfTag(tag);
+        }
+
+        if (step == STEPS / 2) {
+            /* Grow the heap by a disjoint region. */
+            oracle_OSAddToHeap(o_heap, o_heap_base + 0x48000, o_heap_base + 0x50000);
+            OSAddToHeap(p_heap, (void *)(uintptr_t)(p_heap_base + 0x48000),
+                        (void *)(uintptr_t)(p_heap_base + 0x50000));
+            want[n_want++] = (ProfRec){PORT_OSALLOC_PROF_ADD, (uint8_t)p_heap, tag,
+                                       p_heap_base + 0x48000, 0x8000, 0};
+        } else if (g_alloc_count > 0 && (xorshift32(&rng) % 3u) == 0u) {
+            int idx = alloc_pick_index(&rng);
+            Alloc a = g_allocs[idx];
+            uint32_t cell_size = (uint32_t)OCELL(a.oracle_ptr - 0x20)->size;
+            oracle_OSFreeToHeap(o_heap, a.oracle_ptr);
+            OSFreeToHeap(p_heap, a.port_ptr);
+            alloc_remove_index(idx);
+            want[n_want++] = (ProfRec){PORT_OSALLOC_PROF_FREE, (uint8_t)p_heap, tag,
+                                       (uint32_t)(uintptr_t)a.port_ptr, cell_size, 0};
+            model.frees++;
+            model.live_bytes -= cell_size;
+            model.live_blocks--;
+        } else if (g_alloc_count < MAX_ALLOCS) {
+            uint32_t size = 1 + (xorshift32(&rng) % 0x3000u);
+            int fixed = (xorshift32(&rng) & 7u) == 0u;
+            o32 o_ptr = oracle_OSAllocFromHeap(o_heap, size);
+            void *p_ptr = fixed ? OSAllocFixed(size) : OSAllocFromHeap(p_heap, size);
+            if (compare_alloc_result(o_ptr, p_ptr, o_heap_base, p_heap_base) != 0) {
+                fail_case(seed, 0, step, "Profiler", "alloc return mismatch");
+                return 1;
+            }
+            uint32_t cell = o_ptr ? (uint32_t)OCELL(o_ptr - 0x20)->size : 0;
+            want[n_want++] = (ProfRec){fixed ? PORT_OSALLOC_PROF_FIXED : PORT_OSALLOC_PROF_ALLOC,
+                                       (uint8_t)p_heap, tag, (uint32_t)(uintptr_t)p_ptr, size, cell};
+            if (o_ptr != 0) {
+                alloc_push(o_heap, o_ptr, p_ptr);
+                uint32_t req = (size + 0x20u + 31u) & ~31u;
+                uint32_t c = 0;
+                for (uint32_t s = req >> 6; s > 1u && c < PORT_OSALLOC_CLASSES - 1; s >>= 1) c++;
+                model.allocs++;
+                model.alloc_classes[c]++;
+                model.live_bytes += cell;
+                model.live_blocks++;
+                if (model.live_bytes > model.peak_bytes) model.peak_bytes = model.live_bytes;
+                if (model.live_blocks > model.peak_blocks) model.peak_blocks = model.live_blocks;
+            } else {
+                model.failed++;
+            }
+        }
+
+        port_OSHeapFreeStats o_fs, p_fs;
+        oracle_free_stats(ohd->free, &o_fs);
+        if (port_OSHeapFree(p_heap, &p_fs) != 0 || o_fs.free_bytes != p_fs.free_bytes ||
+            o_fs.largest != p_fs.largest || o_fs.cells != p_fs.cells) {
+            fail_case(seed, 0, step, "Profiler", "port_OSHeapFree mismatch");
+            return 1;
+        }
+        uint32_t classed = 0;
+        for (int c = 0; c < PORT_OSALLOC_CLASSES; c++) classed += p_fs.classes[c];
+        if (classed != p_fs.cells) {
+            fail_case(seed, 0, step, "Profiler", "free size classes don't add up");
+            return 1;
+        }
+
+        if ((step & 15) == 15) {
+            port_OSAllocProfFrame();
+            want[n_want++] = (ProfRec){PORT_OSALLOC_PROF_HEAP, (uint8_t)p_heap, 0,
+                                       o_fs.free_bytes, o_fs.largest, o_fs.cells};
+            want[n_want++] = (ProfRec){PORT_OSALLOC_PROF_FRAME, 0xFF, 0, frame++, 0, 0};
+        }
+    }
+    port_OSAllocProfStop();
+
+    port_OSAllocProfHeap got;
+    if (port_OSAllocProfHeapStats(p_heap, &got) != 0 || memcmp(&got, &model, sizeof(got)) != 0) {
+        fail_case(seed, 0, STEPS, "Profiler", "heap counters mismatch");
+        fclose(log);
+        return 1;
+    }
+
+    /* Replay the log. */
+    uint8_t rec[PORT_OSALLOC_PROF_RECORD];
+    rewind(log);
+    int rc = 0;
+    if (fread(rec, sizeof(rec), 1, log) != 1 || memcmp(rec, "OSAP", 4) != 0 || rec[4] != 1 || rec[8] != 16) {
+        fail_case(seed, 0, 0, "Profiler", "bad log header");
+        rc = 1;
+    }
+    for (int i = 0; rc == 0 && i < n_want; i++) {
+        if (fread(rec, sizeof(rec), 1, log) != 1) {
+            fail_case(seed, 0, i, "Profiler", "log too short");
+            rc = 1;
+            break;
+        }
+        uint32_t w[3];
+        for (int k = 0; k < 3; k++) {
+            w[k] = (uint32_t)rec[4 + k * 4] | ((uint32_t)rec[5 + k * 4] << 8) |
+                   ((uint32_t)rec[6 + k * 4] << 16) | ((uint32_t)rec[7 + k * 4] << 24);
+        }
+        const ProfRec *e = &want[i];
+        if (rec[0] != e->kind || rec[1] != e->heap || (rec[2] | (rec[3] << 8)) != e->tag ||
+            w[0] != e->a || w[1] != e->b || w[2] != e->c) {
+            fail_case(seed, 0, i, "Profiler", "log record mismatch");
+            rc = 1;
+            break;
+        }
+        if (e->kind == PORT_OSALLOC_PROF_NAME) {
+            if (fread(rec, sizeof(rec), 1, log) != 1 || memcmp(rec, name, 16) != 0 ||
+                fread(rec, sizeof(rec), 1, log) != 1 || strcmp((const char *)rec, name + 16) != 0) {
+                fail_case(seed, 0, i, "Profiler", "tag name mismatch");
+                rc = 1;
+            }
+        }
+    }
+    if (rc == 0 && fread(rec, 1, 1, log) != 0) {
+        fail_case(seed, 0, n_want, "Profiler", "log too long");
+        rc = 1;
+    }
+    fclose(log);
+    return rc;
+}
+
+/*
+ * HeapCheck: a random alloc/free mix over three heaps (with OSAllocFixed and
+ * OSAddToHeap), checked at random intervals. port_OSCheckHeapIncremental and
+ * port_OSCheckHeaps must agree with OSCheckHeap, and on a clean heap the
+ * incremental check must never need a full walk after its first. Then a
+ * header of a just-touched cell is damaged: both must report the heap bad
+ * (and only that heap), and recover once the header is restored.
+ */
+static int test_HeapCheck(uint32_t seed) {
+    uint32_t rng = seed ? seed : 1;
+    enum { NHEAPS = 3, STEPS = 240, HEAP_SIZE = 0x20000 };
+
+    reset_all();
+    alloc_reset();
+    OSInitAlloc((void *)(uintptr_t)PORT_ARENA_LO, (void *)(uintptr_t)PORT_ARENA_HI, 8);
+    int heaps[NHEAPS];
+    for (int h = 0; h < NHEAPS; h++) {
+        const uint32_t base = PORT_ARENA_LO + 0x4000 + (uint32_t)h * 0x28000u;
+        heaps[h] = OSCreateHeap((void *)(uintptr_t)base, (void *)(uintptr_t)(base + HEAP_SIZE));
+        if (heaps[h] < 0) {
+            fail_case(seed, 0, 0, "HeapCheck", "heap setup failed");
+            return 1;
+        }
+    }
+    OSSetCurrentHeap(heaps[0]);
+
+    port_OSCheckHeapStats before, after;
+    port_OSCheckHeapCounters(&before);
+    long full[NHEAPS], par[NHEAPS];
+    int next_check = 0;
+
+    for (int step = 0; step < STEPS; step++) {
+        const int h = (int)(xorshift32(&rng) % NHEAPS);
+        const uint32_t r = xorshift32(&rng);
+        if (step == STEPS / 2) {
+            /* Grow heap 1 by a region right above heap 2. */
+            const uint32_t add = PORT_ARENA_LO + 0x4000 + NHEAPS * 0x28000u;
+            OSAddToHeap(heaps[1], (void *)(uintptr_t)add, (void *)(uintptr_t)(add + 0x8000));
+        } else if (g_alloc_count > 0 && (r & 3u) == 0u) {
+            const int idx = alloc_pick_index(&rng);
+            OSFreeToHeap(g_allocs[idx].heap, g_allocs[idx].port_ptr);
+            alloc_remove_index(idx);
+        } else if (g_alloc_count < MAX_ALLOCS) {
+            const uint32_t size = 1 + (xorshift32(&rng) % 0x1800u);
+            const int fixed = (r & 0x70u) == 0u;
+            void *p = fixed ? OSAllocFixed(size) : OSAllocFromHeap(heaps[h], size);
+            if (p) alloc_push(fixed ? heaps[0] : heaps[h], 0, p);
+        }
+
+        if (step < next_check) continue;
+        next_check = step + 1 + (int)(xorshift32(&rng) % 8u);
+        for (int i = 0; i < NHEAPS; i++) full[i] = OSCheckHeap(heaps[i]);
+        for (int i = 0; i < NHEAPS; i++) {
+            if (full[i] < 0) {
+                fail_case(seed, 0, step, "HeapCheck", "clean heap failed OSCheckHeap");
+                return 1;
+            }
+            if (port_OSCheckHeapIncremental(heaps[i]) != full[i]) {
+                fail_case(seed, 0, step, "HeapCheck", "incremental check mismatch");
+                return 1;
+            }
+        }
+        if (port_OSCheckHeaps(heaps, NHEAPS, par) != 0 || memcmp(par, full, sizeof(full)) != 0) {
+            fail_case(seed, 0, step, "HeapCheck", "parallel check mismatch");
+            return 1;
+        }
+    }
+    port_OSCheckHeapCounters(&after);
+    if (after.full - before.full != NHEAPS || after.cells == before.cells) {
+        fail_case(seed, 0, STEPS, "HeapCheck", "incremental check fell back to full walks");
+        return 1;
+    }
+
+    /* Damage a header the last call touched: the cell an allocation took or
+     * its split remainder, or the free cell a block went back into or that
+     * cell's successor. */
+    for (int round = 0; round < 8; round++) {
+        int h = (int)(xorshift32(&rng) % NHEAPS);
+        uint8_t *p = NULL;
+        uint32_t victim;
+        if ((round & 1) && g_alloc_count > 0) {
+            const int idx = alloc_pick_index(&rng);
+            const uint32_t ptr = (uint32_t)(uintptr_t)g_allocs[idx].port_ptr;
+            for (h = 0; heaps[h] != g_allocs[idx].heap; h++) {}
+            OSFreeToHeap(heaps[h], g_allocs[idx].port_ptr);
+            alloc_remove_index(idx);
+            const uint32_t hd = __gc_osalloc_heap_array + (uint32_t)heaps[h] * 12u;
+            uint32_t keep = load_u32be(hd + 4);
+            while (keep != 0 && !(keep < ptr && ptr < keep + port_cell_size(keep))) keep = port_cell_next(keep);
+            if (keep == 0) {
+                fail_case(seed, 0, round, "HeapCheck", "freed block not on the free list");
+                return 1;
+            }
+            victim = (port_cell_next(keep) != 0 && (xorshift32(&rng) & 1u)) ? port_cell_next(keep) : keep;
+        } else {
+            p = OSAllocFromHeap(heaps[h], 0x40 + (xorshift32(&rng) % 0x400u));
+            if (!p) continue;
+            const uint32_t cell = (uint32_t)(uintptr_t)p - 0x20u;
+            const uint32_t hd = __gc_osalloc_heap_array + (uint32_t)heaps[h] * 12u;
+            const uint32_t rest = cell + port_cell_size(cell); /* free remainder, if it split */
+            const int split = port_DLLookup(load_u32be(hd + 4), rest) != 0;
+            victim = (split && (xorshift32(&rng) & 1u)) ? rest : cell;
+        }
+        const uint32_t field = (xorshift32(&rng) % 3u) * 4u;
+        const uint32_t saved = load_u32be(victim + field);
+        static const uint32_t junk[3] = {0x80001000u, 0x80001000u, 0x20u};
+        store_u32be(victim + field, field == 8 ? saved + junk[2] : junk[field / 4]);
+
+        const long want = OSCheckHeap(heaps[h]);
+        long got_par[NHEAPS];
+        const int bad = port_OSCheckHeaps(heaps, NHEAPS, got_par);
+        if (want != -1 || port_OSCheckHeapIncremental(heaps[h]) != -1 || bad != 1 || got_par[h] != -1) {
+            fail_case(seed, 0, round, "HeapCheck", "damaged header not reported");
+            return 1;
+        }
+        store_u32be(victim + field, saved);
+        if (port_OSCheckHeapIncremental(heaps[h]) != OSCheckHeap(heaps[h]) || OSCheckHeap(heaps[h]) < 0) {
+            fail_case(seed, 0, round, "HeapCheck", "no recovery after repair");
+            return 1;
+        }
+        if (p) OSFreeToHeap(heaps[h], p);
+    }
+    return 0;
+}
+
 /* ── CLI ── */
 
 static void usage(const char *argv0) {
@@ -626,7 +1069,8 @@ static void usage(const char *argv0) {
         "\n"
         "ops:\n"
         "  DLAddFront  DLExtract  DLInsert  DLLookup\n"
-        "  OSAllocFromHeap  OSFreeToHeap  OSDestroyHeap  OSAddToHeap\n"
+        "  OSAllocFromHeap  OSFreeToHeap  OSDestroyHeap  OSAddToHeap  FreeIndex\n"
+        "  Profiler  HeapCheck\n"
         "  full\n",
         argv0);
 }
@@ -670,6 +1114,9 @@ int main(int argc, char **argv) {
     else if (strcmp(op, "DLLookup") == 0) fn_one = test_DLLookup;
     else if (strcmp(op, "OSDestroyHeap") == 0) fn_one = test_OSDestroyHeap;
     else if (strcmp(op, "OSAddToHeap") == 0) fn_one = test_OSAddToHeap;
+    else if (strcmp(op, "FreeIndex") == 0) fn_one = test_FreeIndex;
+    else if (strcmp(op, "Profiler") == 0) fn_one = test_Profiler;
+    else if (strcmp(op, "HeapCheck") == 0) fn_one = test_HeapCheck;
     else if (strcmp(op, "OSAllocFromHeap") == 0) { run_with_steps = 1; alloc_only = 1; }
     else if (strcmp(op, "OSFreeToHeap") == 0) { run_with_steps = 1; free_heavy = 1; }
     else if (strcmp(op, "full") == 0) { run_with_steps = 1; alloc_only = 0; }
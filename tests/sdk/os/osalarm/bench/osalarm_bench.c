@@ -0,0 +1,142 @@
+/*
+ * osalarm_bench.c — OSAlarm queue cost at large alarm counts
+ *
+ * Queues N alarms (a quarter periodic), then times two steady-state
+ * operations on the full queue:
+ *   set   — OSCancelAlarm + OSSetAlarm of a random alarm at a random tick
+ *   fire  — advance to the head, fire it; periodic alarms re-insert
+ * and reports ns/op for each N. tools/run_osalarm_bench.sh builds it twice,
+ * with the alarm index and with GC_OSALARM_LINEAR (the list walk).
+ *
+ * Usage: osalarm_bench [--max=N] [--ops=N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "OSAlarm.h"
+#include "gc_mem.h"
+
+#define GC_ALARM_BASE 0x80001000u
+#define ALARM_ADDR(i) (GC_ALARM_BASE + (uint32_t)(i) * PORT_ALARM_SIZE)
+#define SPAN          (1 << 24) /* ticks the fire times spread over */
+
+static uint32_t g_rng = 0x1234567u;
+static uint32_t xorshift32(void) {
+    uint32_t x = g_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rng = x;
+    return x;
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void store_u32be(uint32_t addr, uint32_t val) {
+    uint8_t *p = gc_mem_ptr(addr, 4);
+    p[0] = (uint8_t)(val >> 24);
+    p[1] = (uint8_t)(val >> 16);
+    p[2] = (uint8_t)(val >> 8);
+    p[3] = (uint8_t)val;
+}
+
+static uint32_t load_u32be(uint32_t addr) {
+    const uint8_t *p = gc_mem_ptr(addr, 4);
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static int64_t load_s64be(uint32_t addr) {
+    const uint8_t *p = gc_mem_ptr(addr, 8);
+    uint64_t v = 0;
+    int i;
+    for (i = 0; i < 8; i++) v = (v << 8) | p[i];
+    return (int64_t)v;
+}
+
+static void run(int n, int ops, uint8_t *ram) {
+    port_OSAlarmState st;
+    double t0, t_set, t_fire;
+    int i;
+
+    memset(ram, 0, (size_t)n * PORT_ALARM_SIZE);
+    port_OSAlarmInit(&st);
+    for (i = 0; i < n; i++) {
+        port_OSCreateAlarm(ALARM_ADDR(i));
+        store_u32be(ALARM_ADDR(i) + PORT_ALARM_TAG, (uint32_t)i);
+    }
+    /* Fill latest-first so the list walk build stays cheap too. */
+    for (i = n - 1; i >= 0; i--) {
+        const int64_t fire = (int64_t)i * (SPAN / n) + 1;
+        if ((i & 3) == 0) {
+            port_OSSetPeriodicAlarm(&st, ALARM_ADDR(i), fire, SPAN / 2 + (int64_t)(xorshift32() % SPAN));
+        } else {
+            port_OSSetAlarm(&st, ALARM_ADDR(i), fire);
+        }
+    }
+
+    t0 = now_sec();
+    for (i = 0; i < ops; i++) {
+        const uint32_t a = ALARM_ADDR(xorshift32() % (uint32_t)n);
+        port_OSCancelAlarm(&st, a);
+        port_OSSetAlarm(&st, a, (int64_t)(xorshift32() % SPAN) + 1);
+    }
+    t_set = now_sec() - t0;
+
+    t0 = now_sec();
+    for (i = 0; i < ops && st.queueHead != 0; i++) {
+        const uint32_t fired = st.queueHead;
+        st.systemTime = load_s64be(fired + PORT_ALARM_FIRE) + 1;
+        port_OSAlarmFireHead(&st);
+        if (load_u32be(fired + PORT_ALARM_HANDLER) == 0) {
+            /* One-shot fired: re-arm it so the queue stays at n. */
+            port_OSSetAlarm(&st, fired, (int64_t)(xorshift32() % SPAN) + 1);
+        }
+    }
+    t_fire = now_sec() - t0;
+
+    printf("%8d %12.0f %12.0f %10u\n", n, t_set / ops * 1e9, t_fire / (i ? i : 1) * 1e9,
+           gc_os_alarm_index_rebuilds);
+}
+
+int main(int argc, char **argv) {
+    int max = 50000, ops = 4000, a, n;
+    uint8_t *ram;
+
+    for (a = 1; a < argc; a++) {
+        if (strncmp(argv[a], "--max=", 6) == 0)
+            max = atoi(argv[a] + 6);
+        else if (strncmp(argv[a], "--ops=", 6) == 0)
+            ops = atoi(argv[a] + 6);
+        else {
+            fprintf(stderr, "Usage: osalarm_bench [--max=N] [--ops=N]\n");
+            return 2;
+        }
+    }
+    if (max < 1) max = 1;
+    if (ops < 1) ops = 1;
+
+    ram = (uint8_t *)malloc((size_t)max * PORT_ALARM_SIZE);
+    if (!ram) return 2;
+    gc_mem_set(GC_ALARM_BASE, (size_t)max * PORT_ALARM_SIZE, ram);
+
+#ifdef GC_OSALARM_LINEAR
+    printf("\n=== OSAlarm Bench: list walk (%d ops) ===\n", ops);
+#else
+    printf("\n=== OSAlarm Bench: alarm index (%d ops) ===\n", ops);
+#endif
+    printf("%8s %12s %12s %10s\n", "alarms", "set ns/op", "fire ns/op", "rebuilds");
+    for (n = 100; n <= max; n *= 10) {
+        run(n, ops, ram);
+        if (n < max && n * 10 > max) run(max, ops, ram);
+    }
+    free(ram);
+    return 0;
+}
@@ -10,6 +10,8 @@
  *   L2 — Fire parity: pop head (simulating decrementer), compare list state
  *   L3 — Properties: list always sorted, cancel idempotent, periodic re-insert
  *   L4 — Full integration: random mix of insert/cancel/fire
+ *   L5 — Alarm index: hundreds of alarms sharing fire times, re-arms and an
+ *        out-of-band unlink, checked against the oracle's walk
  */
 
 #include <stdio.h>
@@ -52,7 +54,7 @@ static const char *g_opt_op;
  * ORACLE — exact copy of decomp InsertAlarm/CancelAlarm (native ptrs)
  * ═══════════════════════════════════════════════════════════════════ */
 
-#define ORACLE_MAX_ALARMS 32
+#define ORACLE_MAX_ALARMS 512
 
 typedef struct oracle_OSAlarm oracle_OSAlarm;
 typedef void (*oracle_AlarmHandler)(void);
@@ -550,6 +552,95 @@ static int test_integration(uint32_t seed) {
     return 1;
 }
 
+/* ═══════════════════════════════════════════════════════════════════
+ * L5 — Alarm index (port finds insertion points through a host index)
+ * ═══════════════════════════════════════════════════════════════════ */
+
+/* One-shot or periodic on a coarse grid so many alarms share fire times. */
+static void index_arm(int idx) {
+    if (xorshift32() % 4 == 0) {
+        int64_t start = oracle_SystemTime + (int64_t)(xorshift32() % 64) * 16;
+        int64_t period = (int64_t)(1 + xorshift32() % 8) * 16;
+        oracle_OSSetPeriodicAlarm(&oracle_AlarmPool[idx], start, period);
+        port_OSSetPeriodicAlarm(&port_state, ALARM_ADDR(idx), start, period);
+    } else {
+        int64_t tick = (int64_t)(xorshift32() % 64) * 16 + 1;
+        oracle_OSSetAlarm(&oracle_AlarmPool[idx], tick);
+        port_OSSetAlarm(&port_state, ALARM_ADDR(idx), tick);
+    }
+    alarm_active[idx] = ACTIVE;
+}
+
+static int test_index(uint32_t seed) {
+    int n, i;
+    uint32_t rebuilds = gc_os_alarm_index_rebuilds;
+    g_rng = seed;
+    init_both();
+
+    n = 200 + (int)(xorshift32() % 300);
+    for (i = 0; i < n; i++) index_arm(i);
+    if (!compare_queues("L5-Fill")) return 0;
+
+    for (i = 0; i < 400; i++) {
+        int idx = (int)(xorshift32() % (uint32_t)n);
+
+        if (i == 200 && oracle_AlarmQueue.head) {
+            /* Unlink the head behind the port's back, as other code would. */
+            oracle_OSAlarm *oa = oracle_AlarmQueue.head;
+            uint32_t pa = port_state.queueHead;
+            uint32_t pn = test_load_u32be(pa + PORT_ALARM_NEXT);
+            oracle_AlarmQueue.head = oa->next;
+            if (oa->next) oa->next->prev = NULL; else oracle_AlarmQueue.tail = NULL;
+            oa->handler = 0;
+            port_state.queueHead = pn;
+            if (pn) test_store_u32be(pn + PORT_ALARM_PREV, 0); else port_state.queueTail = 0;
+            test_store_u32be(pa + PORT_ALARM_HANDLER, 0);
+            alarm_active[oa->id] = INACTIVE;
+        }
+
+        switch (xorshift32() % 4) {
+        case 0: /* Re-arm */
+            oracle_OSCancelAlarm(&oracle_AlarmPool[idx]);
+            port_OSCancelAlarm(&port_state, ALARM_ADDR(idx));
+            index_arm(idx);
+            break;
+        case 1: /* Cancel */
+            oracle_OSCancelAlarm(&oracle_AlarmPool[idx]);
+            port_OSCancelAlarm(&port_state, ALARM_ADDR(idx));
+            alarm_active[idx] = INACTIVE;
+            break;
+        case 2: /* Fire head */
+            if (oracle_AlarmQueue.head) {
+                oracle_SystemTime = oracle_AlarmQueue.head->fire;
+                port_state.systemTime = oracle_SystemTime;
+                {
+                    int oid = oracle_FireHead();
+                    int pid = port_FireHead();
+                    CHECK(oid == pid, "L5-Fire step %d: oracle=%d port=%d", i, oid, pid);
+                }
+            }
+            break;
+        case 3: /* Advance time */
+            oracle_SystemTime += (int64_t)(xorshift32() % 64);
+            port_state.systemTime = oracle_SystemTime;
+            break;
+        }
+
+        if ((i & 15) == 15 && !compare_queues("L5-Step")) return 0;
+    }
+
+    if (!compare_queues("L5-Index")) return 0;
+    CHECK(port_state.queueTail == 0 ||
+          test_load_u32be(port_state.queueTail + PORT_ALARM_NEXT) == 0,
+          "L5: tail has a successor");
+#ifndef GC_OSALARM_LINEAR
+    /* Once after init, once after the out-of-band unlink. */
+    CHECK(gc_os_alarm_index_rebuilds - rebuilds <= 2,
+          "L5: index rebuilt %u times", gc_os_alarm_index_rebuilds - rebuilds);
+#endif
+    return 1;
+}
+
 /* ═══════════════════════════════════════════════════════════════════
  * Runner
  * ═══════════════════════════════════════════════════════════════════ */
@@ -575,6 +666,9 @@ static int run_seed(uint32_t seed) {
     if (!g_opt_op || strstr("L4", g_opt_op) || strstr("FULL", g_opt_op) || strstr("MIX", g_opt_op)) {
         if (!test_integration(sub ^ 0xA1A20005u)) return 0;
     }
+    if (!g_opt_op || strstr("L5", g_opt_op) || strstr("INDEX", g_opt_op)) {
+        if (!test_index(sub ^ 0xA1A20006u)) return 0;
+    }
 
     return 1;
 }
@@ -596,7 +690,7 @@ int main(int argc, char **argv) {
         else {
             fprintf(stderr,
                     "Usage: osalarm_property_test [--seed=N] [--num-runs=N] "
-                    "[--op=L0|L1|L2|L3|L4|INSERT|CANCEL|FIRE|PERIODIC|FULL|MIX] [-v]\n");
+                    "[--op=L0|L1|L2|L3|L4|L5|INSERT|CANCEL|FIRE|PERIODIC|FULL|MIX|INDEX] [-v]\n");
             return 2;
         }
     }
@@ -0,0 +1,907 @@
+/*
+ * oslink_property_test.c — Property-based parity test for the REL linker
+ *
+ * Oracle: decomp Link / Relocate / Undo / OSUnlink, walking the relocation
+ *         streams of random REL images in its own copy of RAM
+ * Port:   port_OSLinkRel / port_OSUnlinkRel from src/sdk_port/os/OSModule.c
+ *         (fixup plans, or the stream walk with -DGC_OSLINK_NO_PLAN)
+ *
+ * After every operation both RAMs must be byte-identical, with the same
+ * module list, return values and unknown-relocation reports.
+ *
+ * Levels:
+ *   L0 — LINK: one module, imports of the main program and of itself
+ *   L1 — CHAIN: modules importing each other, linked in random order
+ *   L2 — UNLINK: Undo parity, branches sent to `unresolved`
+ *   L3 — RELOAD: unlink, reload the image elsewhere, relink; plan reuse,
+ *        a changed image gets a new plan, FlushPlans
+ *   L4 — MIX: random link/unlink/reload with bad versions and alignment
+ *   L5 — OVERLAY: overlays switched through the overlay cache, residents
+ *        moving under them; a hit must leave RAM as a full link would
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "OSModule.h"
+#include "gc_mem.h"
+
+/* ── xorshift32 PRNG ────────────────────────────────────────────── */
+static uint32_t g_rng;
+static uint32_t xorshift32(void) {
+    uint32_t x = g_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rng = x;
+    return x;
+}
+
+/* ── Counters ───────────────────────────────────────────────────── */
+static uint64_t g_total_checks;
+static uint64_t g_total_pass;
+static int       g_verbose;
+static const char *g_opt_op;
+
+#define CHECK(cond, ...) do { \
+    g_total_checks++; \
+    if (!(cond)) { \
+        printf("FAIL @ %s:%d: ", __FILE__, __LINE__); \
+        printf(__VA_ARGS__); printf("\n"); \
+        return 0; \
+    } \
+    g_total_pass++; \
+} while(0)
+
+/* ── SDK hooks ──────────────────────────────────────────────────── */
+static uint32_t g_reports;
+static uint32_t g_notify_link;
+static uint32_t g_notify_unlink;
+
+void OSReport(const char *msg, ...) { (void)msg; g_reports++; }
+void OSNotifyLink(void) { g_notify_link++; }
+void OSNotifyUnlink(void) { g_notify_unlink++; }
+
+/* ── RAM layout ─────────────────────────────────────────────────── */
+#define RAM_BASE   0x80000000u
+#define RAM_SIZE   0x60000u
+#define SLOT_BASE  (RAM_BASE + 0x1000u)
+#define SLOT_SIZE  0x6000u
+#define BSS_BASE   (RAM_BASE + 0x40000u)
+#define BSS_SIZE   0x2000u
+#define NUM_SLOTS  8
+#define MAX_MODS   6
+#define MAX_SECS   8
+
+static uint8_t port_ram[RAM_SIZE];
+static uint8_t oracle_ram[RAM_SIZE];
+
+/* ═══════════════════════════════════════════════════════════════════
+ * ORACLE — decomp OSLink.c over big-endian oracle_ram
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static uint8_t *o_ptr(uint32_t addr, uint32_t len) {
+    if (addr < RAM_BASE || addr - RAM_BASE > RAM_SIZE - len) return NULL;
+    return &oracle_ram[addr - RAM_BASE];
+}
+static uint32_t o_ld32(uint32_t a) {
+    const uint8_t *p = o_ptr(a, 4);
+    return p ? ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3] : 0;
+}
+static uint32_t o_ld16(uint32_t a) {
+    const uint8_t *p = o_ptr(a, 2);
+    return p ? ((uint32_t)p[0] << 8) | p[1] : 0;
+}
+static uint32_t o_ld8(uint32_t a) {
+    const uint8_t *p = o_ptr(a, 1);
+    return p ? p[0] : 0;
+}
+static void o_st32(uint32_t a, uint32_t v) {
+    uint8_t *p = o_ptr(a, 4);
+    if (!p) return;
+    p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16); p[2] = (uint8_t)(v >> 8); p[3] = (uint8_t)v;
+}
+static void o_st16(uint32_t a, uint32_t v) {
+    uint8_t *p = o_ptr(a, 2);
+    if (!p) return;
+    p[0] = (uint8_t)(v >> 8); p[1] = (uint8_t)v;
+}
+
+static struct { uint32_t head, tail; } oracle_ModuleList;
+static uint32_t oracle_StringTable;
+static uint32_t oracle_reports;
+
+#define O_SI(m, i)   (o_ld32((m) + PORT_REL_SECTION_INFO) + (i) * PORT_REL_SECTION_SIZE)
+#define O_OFFSET(o)  ((o) & ~PORT_REL_SECTION_EXEC)
+
+/* Relocate(newModule, module): patch module's references to newModule. */
+static void oracle_Relocate(uint32_t newModule, uint32_t module) {
+    uint32_t idNew = newModule ? o_ld32(newModule + PORT_REL_ID) : 0;
+    uint32_t imp, rel, p = 0, x, offset, siFlush = 0;
+
+    for (imp = o_ld32(module + PORT_REL_IMP_OFFSET);
+         imp < o_ld32(module + PORT_REL_IMP_OFFSET) + o_ld32(module + PORT_REL_IMP_SIZE);
+         imp += PORT_REL_IMP_ENTRY_SIZE) {
+        if (o_ld32(imp) == idNew) goto Found;
+    }
+    return;
+
+Found:
+    for (rel = o_ld32(imp + 4); o_ld8(rel + 2) != PORT_R_DOLPHIN_END; rel += PORT_REL_RELOC_SIZE) {
+        const uint32_t type = o_ld8(rel + 2);
+        const uint32_t section = o_ld8(rel + 3);
+        const uint32_t addend = o_ld32(rel + 4);
+
+        p += o_ld16(rel);
+        offset = idNew ? O_OFFSET(o_ld32(O_SI(newModule, section))) : 0;
+        switch (type) {
+        case PORT_R_PPC_NONE:
+            break;
+        case PORT_R_PPC_ADDR32:
+            x = offset + addend;
+            o_st32(p, x);
+            break;
+        case PORT_R_PPC_ADDR24:
+            x = offset + addend;
+            o_st32(p, (o_ld32(p) & ~0x03fffffcu) | (x & 0x03fffffcu));
+            break;
+        case PORT_R_PPC_ADDR16:
+            x = offset + addend;
+            o_st16(p, x);
+            break;
+        case PORT_R_PPC_ADDR16_LO:
+            x = offset + addend;
+            o_st16(p, x & 0xffffu);
+            break;
+        case PORT_R_PPC_ADDR16_HI:
+            x = offset + addend;
+            o_st16(p, (x >> 16) & 0xffffu);
+            break;
+        case PORT_R_PPC_ADDR16_HA:
+            x = offset + addend;
+            o_st16(p, ((x >> 16) + ((x & 0x8000u) ? 1u : 0u)) & 0xffffu);
+            break;
+        case PORT_R_PPC_ADDR14:
+        case PORT_R_PPC_ADDR14_BRTAKEN:
+        case PORT_R_PPC_ADDR14_BRNTAKEN:
+            x = offset + addend;
+            o_st32(p, (o_ld32(p) & ~0x0000fffcu) | (x & 0x0000fffcu));
+            break;
+        case PORT_R_PPC_REL24:
+            x = offset + addend - p;
+            o_st32(p, (o_ld32(p) & ~0x03fffffcu) | (x & 0x03fffffcu));
+            break;
+        case PORT_R_PPC_REL14:
+        case PORT_R_PPC_REL14_BRTAKEN:
+        case PORT_R_PPC_REL14_BRNTAKEN:
+            x = offset + addend - p;
+            o_st32(p, (o_ld32(p) & ~0x0000fffcu) | (x & 0x0000fffcu));
+            break;
+        case PORT_R_DOLPHIN_NOP:
+            break;
+        case PORT_R_DOLPHIN_SECTION:
+            siFlush = O_SI(module, section);
+            p = O_OFFSET(o_ld32(siFlush));
+            break;
+        default:
+            oracle_reports++;
+            break;
+        }
+    }
+    (void)siFlush;
+}
+
+/* Undo(newModule, module): module's references to newModule go away. */
+static void oracle_Undo(uint32_t newModule, uint32_t module) {
+    uint32_t idNew = o_ld32(newModule + PORT_REL_ID);
+    uint32_t imp, rel, p = 0, x;
+
+    for (imp = o_ld32(module + PORT_REL_IMP_OFFSET);
+         imp < o_ld32(module + PORT_REL_IMP_OFFSET) + o_ld32(module + PORT_REL_IMP_SIZE);
+         imp += PORT_REL_IMP_ENTRY_SIZE) {
+        if (o_ld32(imp) == idNew) goto Found;
+    }
+    return;
+
+Found:
+    for (rel = o_ld32(imp + 4); o_ld8(rel + 2) != PORT_R_DOLPHIN_END; rel += PORT_REL_RELOC_SIZE) {
+        const uint32_t type = o_ld8(rel + 2);
+        const uint32_t section = o_ld8(rel + 3);
+
+        p += o_ld16(rel);
+        switch (type) {
+        case PORT_R_PPC_NONE:
+        case PORT_R_DOLPHIN_NOP:
+            break;
+        case PORT_R_PPC_ADDR32:
+            o_st32(p, 0);
+            break;
+        case PORT_R_PPC_ADDR24:
+            o_st32(p, o_ld32(p) & ~0x03fffffcu);
+            break;
+        case PORT_R_PPC_ADDR16:
+        case PORT_R_PPC_ADDR16_LO:
+        case PORT_R_PPC_ADDR16_HI:
+        case PORT_R_PPC_ADDR16_HA:
+            o_st16(p, 0);
+            break;
+        case PORT_R_PPC_ADDR14:
+        case PORT_R_PPC_ADDR14_BRTAKEN:
+        case PORT_R_PPC_ADDR14_BRNTAKEN:
+        case PORT_R_PPC_REL14:
+        case PORT_R_PPC_REL14_BRTAKEN:
+        case PORT_R_PPC_REL14_BRNTAKEN:
+            o_st32(p, o_ld32(p) & ~0x0000fffcu);
+            break;
+        case PORT_R_PPC_REL24:
+            if (o_ld32(module + PORT_REL_UNRESOLVED)) {
+                x = o_ld32(module + PORT_REL_UNRESOLVED) - p;
+                o_st32(p, (o_ld32(p) & ~0x03fffffcu) | (x & 0x03fffffcu));
+            }
+            break;
+        case PORT_R_DOLPHIN_SECTION:
+            p = O_OFFSET(o_ld32(O_SI(module, section)));
+            break;
+        default:
+            oracle_reports++;
+            break;
+        }
+    }
+}
+
+static int oracle_Link(uint32_t newModule, uint32_t bss) {
+    const uint32_t version = o_ld32(newModule + PORT_REL_VERSION);
+    const uint32_t bss0 = bss;
+    uint32_t i, si, imp, m;
+
+    if (PORT_REL_VERSION_MAX < version ||
+        (2 <= version &&
+         ((o_ld32(newModule + PORT_REL_ALIGN) && newModule % o_ld32(newModule + PORT_REL_ALIGN) != 0) ||
+          (o_ld32(newModule + PORT_REL_BSS_ALIGN) && bss % o_ld32(newModule + PORT_REL_BSS_ALIGN) != 0)))) {
+        return 0;
+    }
+
+    /* EnqueueTail */
+    o_st32(newModule + PORT_REL_NEXT, 0);
+    o_st32(newModule + PORT_REL_PREV, oracle_ModuleList.tail);
+    if (oracle_ModuleList.tail) o_st32(oracle_ModuleList.tail + PORT_REL_NEXT, newModule);
+    else oracle_ModuleList.head = newModule;
+    oracle_ModuleList.tail = newModule;
+
+    o_st32(newModule + PORT_REL_SECTION_INFO, o_ld32(newModule + PORT_REL_SECTION_INFO) + newModule);
+    o_st32(newModule + PORT_REL_REL_OFFSET, o_ld32(newModule + PORT_REL_REL_OFFSET) + newModule);
+    o_st32(newModule + PORT_REL_IMP_OFFSET, o_ld32(newModule + PORT_REL_IMP_OFFSET) + newModule);
+    if (3 <= version) o_st32(newModule + PORT_REL_FIX_SIZE, o_ld32(newModule + PORT_REL_FIX_SIZE) + newModule);
+    for (i = 1; i < o_ld32(newModule + PORT_REL_NUM_SECTIONS); i++) {
+        si = O_SI(newModule, i);
+        if (o_ld32(si) != 0) {
+            o_st32(si, o_ld32(si) + newModule);
+        } else if (o_ld32(si + 4) != 0) {
+            o_st32(si, bss);
+            bss += (o_ld32(si + 4) + 31u) & ~31u;
+        }
+    }
+    for (imp = o_ld32(newModule + PORT_REL_IMP_OFFSET);
+         imp < o_ld32(newModule + PORT_REL_IMP_OFFSET) + o_ld32(newModule + PORT_REL_IMP_SIZE);
+         imp += PORT_REL_IMP_ENTRY_SIZE) {
+        o_st32(imp + 4, o_ld32(imp + 4) + newModule);
+    }
+    if (o_ld8(newModule + PORT_REL_PROLOG_SECTION)) {
+        o_st32(newModule + PORT_REL_PROLOG, o_ld32(newModule + PORT_REL_PROLOG) +
+               O_OFFSET(o_ld32(O_SI(newModule, o_ld8(newModule + PORT_REL_PROLOG_SECTION)))));
+    }
+    if (o_ld8(newModule + PORT_REL_EPILOG_SECTION)) {
+        o_st32(newModule + PORT_REL_EPILOG, o_ld32(newModule + PORT_REL_EPILOG) +
+               O_OFFSET(o_ld32(O_SI(newModule, o_ld8(newModule + PORT_REL_EPILOG_SECTION)))));
+    }
+    if (o_ld8(newModule + PORT_REL_UNRES_SECTION)) {
+        o_st32(newModule + PORT_REL_UNRESOLVED, o_ld32(newModule + PORT_REL_UNRESOLVED) +
+               O_OFFSET(o_ld32(O_SI(newModule, o_ld8(newModule + PORT_REL_UNRES_SECTION)))));
+    }
+    if (oracle_StringTable) {
+        o_st32(newModule + PORT_REL_NAME_OFFSET, o_ld32(newModule + PORT_REL_NAME_OFFSET) + oracle_StringTable);
+    }
+
+    oracle_Relocate(0, newModule);
+    for (m = oracle_ModuleList.head; m; m = o_ld32(m + PORT_REL_NEXT)) {
+        oracle_Relocate(newModule, m);
+        if (m != newModule) oracle_Relocate(m, newModule);
+    }
+
+    if (o_ld32(newModule + PORT_REL_BSS_SIZE)) {
+        uint8_t *p = o_ptr(bss0, o_ld32(newModule + PORT_REL_BSS_SIZE));
+        if (p) memset(p, 0, o_ld32(newModule + PORT_REL_BSS_SIZE));
+    }
+    return 1;
+}
+
+static int oracle_Unlink(uint32_t oldModule) {
+    const uint32_t prev = o_ld32(oldModule + PORT_REL_PREV);
+    const uint32_t next = o_ld32(oldModule + PORT_REL_NEXT);
+    uint32_t m;
+
+    if (oracle_ModuleList.head != oldModule && !prev && !next) return 0;
+    if (prev) o_st32(prev + PORT_REL_NEXT, next);
+    else oracle_ModuleList.head = next;
+    if (next) o_st32(next + PORT_REL_PREV, prev);
+    else oracle_ModuleList.tail = prev;
+    o_st32(oldModule + PORT_REL_PREV, 0);
+    o_st32(oldModule + PORT_REL_NEXT, 0);
+
+    for (m = oracle_ModuleList.head; m; m = o_ld32(m + PORT_REL_NEXT)) oracle_Undo(oldModule, m);
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * REL image generator
+ * ═══════════════════════════════════════════════════════════════════ */
+
+typedef struct {
+    uint32_t id;
+    uint32_t nsec;
+    uint32_t sec_size[MAX_SECS];
+    int      sec_bss[MAX_SECS];
+    int      sec_exec[MAX_SECS];
+} RelLayout;
+
+typedef struct {
+    uint8_t  img[SLOT_SIZE];
+    uint32_t size;
+    uint32_t bss_size;
+} RelImage;
+
+static RelLayout g_layout[MAX_MODS];
+static uint32_t  g_num_mods;
+static int       g_allow_bad;   /* bad versions / alignment in headers */
+static int       g_allow_junk;  /* NONE / NOP / unknown relocation types */
+
+static void be32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16); p[2] = (uint8_t)(v >> 8); p[3] = (uint8_t)v;
+}
+
+static void gen_layouts(uint32_t n) {
+    uint32_t m, s;
+
+    g_num_mods = n;
+    for (m = 0; m < n; m++) {
+        RelLayout *l = &g_layout[m];
+        l->id = 1u + m * 3u + (xorshift32() % 3u);
+        l->nsec = 2u + xorshift32() % (MAX_SECS - 1u);
+        l->sec_size[0] = 0;
+        l->sec_bss[0] = 0;
+        l->sec_exec[0] = 0;
+        for (s = 1; s < l->nsec; s++) {
+            l->sec_bss[s] = (xorshift32() % 4u) == 0;
+            l->sec_exec[s] = !l->sec_bss[s] && (xorshift32() & 1u);
+            l->sec_size[s] = 16u + 4u * (xorshift32() % 128u);
+            if (!l->sec_bss[s] && (xorshift32() % 8u) == 0) l->sec_size[s] = 0;
+        }
+    }
+}
+
+static const RelLayout *layout_by_id(uint32_t id) {
+    uint32_t m;
+    for (m = 0; m < g_num_mods; m++) if (g_layout[m].id == id) return &g_layout[m];
+    return NULL;
+}
+
+static uint32_t pick_type(void) {
+    static const uint8_t junk[] = {PORT_R_PPC_NONE, PORT_R_DOLPHIN_NOP, 14, 77, 200};
+    if (g_allow_junk && (xorshift32() % 16u) == 0) return junk[xorshift32() % sizeof(junk)];
+    return 1u + xorshift32() % 13u;
+}
+
+/* One relocation stream for an import of `tgt` (NULL = main program). */
+static uint32_t gen_stream(uint8_t *out, uint32_t room, const RelLayout *self, const RelLayout *tgt) {
+    uint32_t n = 0, count = xorshift32() % 48u, cur = 0, p = 0, i;
+
+    for (i = 0; i < count && (n + 2u) * PORT_REL_RELOC_SIZE <= room; i++) {
+        uint8_t *r = out + n * PORT_REL_RELOC_SIZE;
+        uint32_t type, step, size = cur ? self->sec_size[cur] : 0;
+
+        if (!cur || p + 8u > size || (xorshift32() % 12u) == 0) {
+            uint32_t s = 1u + xorshift32() % (self->nsec - 1u);
+            if (self->sec_bss[s] || self->sec_size[s] < 8u) continue;
+            r[0] = (uint8_t)xorshift32(); r[1] = (uint8_t)xorshift32();
+            r[2] = PORT_R_DOLPHIN_SECTION;
+            r[3] = (uint8_t)s;
+            be32(r + 4, xorshift32());
+            cur = s;
+            p = 0;
+            n++;
+            continue;
+        }
+        type = pick_type();
+        step = 2u * (xorshift32() % ((size - 4u - p) / 2u + 1u));
+        if (i == 0 || (xorshift32() % 4u) == 0) step = 0; /* same word again */
+        p += step;
+        r[0] = (uint8_t)(step >> 8); r[1] = (uint8_t)step;
+        r[2] = (uint8_t)type;
+        r[3] = (uint8_t)(tgt ? xorshift32() % tgt->nsec : xorshift32() % 4u);
+        be32(r + 4, (xorshift32() & 1u) ? xorshift32() : xorshift32() % 0x200u);
+        n++;
+    }
+    memset(out + n * PORT_REL_RELOC_SIZE, 0, PORT_REL_RELOC_SIZE);
+    out[n * PORT_REL_RELOC_SIZE + 2] = PORT_R_DOLPHIN_END;
+    return (n + 1u) * PORT_REL_RELOC_SIZE;
+}
+
+static void gen_image(RelImage *im, const RelLayout *l) {
+    uint8_t *img = im->img;
+    uint32_t imp_ids[MAX_MODS + 2], nimp = 0, i, s, off;
+    uint32_t bss = 0;
+
+    memset(img, 0, sizeof(im->img));
+    if ((xorshift32() % 3u) != 0) imp_ids[nimp++] = 0;
+    if ((xorshift32() % 2u) != 0) imp_ids[nimp++] = l->id;
+    for (i = 0; i < g_num_mods; i++) {
+        if (g_layout[i].id != l->id && (xorshift32() % 3u) != 0) imp_ids[nimp++] = g_layout[i].id;
+    }
+    if ((xorshift32() % 6u) == 0) imp_ids[nimp++] = 0x7777u; /* never loaded */
+    for (i = nimp; i > 1; i--) { /* shuffle */
+        const uint32_t j = xorshift32() % i, t = imp_ids[i - 1u];
+        imp_ids[i - 1u] = imp_ids[j];
+        imp_ids[j] = t;
+    }
+
+    be32(img + PORT_REL_ID, l->id);
+    be32(img + PORT_REL_NUM_SECTIONS, l->nsec);
+    be32(img + PORT_REL_SECTION_INFO, 0x4Cu);
+    be32(img + PORT_REL_NAME_OFFSET, xorshift32() % 0x100u);
+    be32(img + PORT_REL_NAME_SIZE, xorshift32() % 0x20u);
+    be32(img + PORT_REL_VERSION, 1u + xorshift32() % 3u);
+    if (g_allow_bad && (xorshift32() % 16u) == 0) be32(img + PORT_REL_VERSION, 4u);
+    if (g_allow_bad && (xorshift32() % 8u) == 0) {
+        be32(img + PORT_REL_ALIGN, 0x4000u);
+    } else {
+        be32(img + PORT_REL_ALIGN, (xorshift32() & 1u) ? 32u : 0u);
+    }
+    be32(img + PORT_REL_BSS_ALIGN, (g_allow_bad && (xorshift32() % 8u) == 0) ? 0x3000u : 32u);
+    be32(img + PORT_REL_FIX_SIZE, xorshift32() % 0x1000u);
+
+    /* Section table, import table, streams, then section bytes. */
+    off = 0x4Cu + l->nsec * PORT_REL_SECTION_SIZE;
+    be32(img + PORT_REL_IMP_OFFSET, off);
+    be32(img + PORT_REL_IMP_SIZE, nimp * PORT_REL_IMP_ENTRY_SIZE);
+    off += nimp * PORT_REL_IMP_ENTRY_SIZE;
+    be32(img + PORT_REL_REL_OFFSET, off);
+    for (i = 0; i < nimp; i++) {
+        const uint32_t room = (SLOT_SIZE - 0x1800u - off) / (nimp - i);
+        be32(img + 0x4Cu + l->nsec * PORT_REL_SECTION_SIZE + i * PORT_REL_IMP_ENTRY_SIZE, imp_ids[i]);
+        be32(img + 0x4Cu + l->nsec * PORT_REL_SECTION_SIZE + i * PORT_REL_IMP_ENTRY_SIZE + 4, off);
+        off += gen_stream(img + off, room, l, imp_ids[i] ? layout_by_id(imp_ids[i]) : NULL);
+    }
+    for (s = 1; s < l->nsec; s++) {
+        uint8_t *e = img + 0x4Cu + s * PORT_REL_SECTION_SIZE;
+        if (l->sec_bss[s]) {
+            be32(e, 0);
+            bss += (l->sec_size[s] + 31u) & ~31u;
+        } else if (l->sec_size[s]) {
+            off = (off + 3u) & ~3u;
+            be32(e, off | (l->sec_exec[s] ? PORT_REL_SECTION_EXEC : 0u));
+            for (i = 0; i < l->sec_size[s]; i++) img[off + i] = (uint8_t)xorshift32();
+            off += l->sec_size[s];
+        }
+        be32(e + 4, l->sec_size[s]);
+    }
+    {
+        static const uint32_t fields[3][2] = {
+            {PORT_REL_PROLOG_SECTION, PORT_REL_PROLOG},
+            {PORT_REL_EPILOG_SECTION, PORT_REL_EPILOG},
+            {PORT_REL_UNRES_SECTION, PORT_REL_UNRESOLVED},
+        };
+        for (i = 0; i < 3; i++) {
+            const uint32_t sec = (xorshift32() % 3u) ? 1u + xorshift32() % (l->nsec - 1u) : 0u;
+            img[fields[i][0]] = (uint8_t)sec;
+            be32(img + fields[i][1], sec ? 4u * (xorshift32() % 4u) : 0u);
+        }
+    }
+    im->bss_size = bss + ((xorshift32() & 1u) ? 32u : 0u);
+    be32(img + PORT_REL_BSS_SIZE, im->bss_size);
+    im->size = off;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Harness
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static port_OSModuleState port_state;
+static RelImage g_img[MAX_MODS];
+static uint32_t g_slot[MAX_MODS];  /* slot index the image sits in */
+static int      g_linked[MAX_MODS];
+static int      g_stale[MAX_MODS];  /* linked once: must be reloaded first */
+
+static uint32_t slot_addr(uint32_t s) { return SLOT_BASE + s * SLOT_SIZE; }
+static uint32_t bss_addr(uint32_t s)  { return BSS_BASE + s * BSS_SIZE; }
+
+static void reset_all(void) {
+    uint32_t i;
+    for (i = 0; i < RAM_SIZE; i++) port_ram[i] = (uint8_t)(i * 131u + 7u);
+    memcpy(oracle_ram, port_ram, RAM_SIZE);
+    port_OSModuleInit(&port_state);
+    oracle_ModuleList.head = oracle_ModuleList.tail = 0;
+    port_state.stringTable = oracle_StringTable = (xorshift32() & 1u) ? 0x80400000u : 0u;
+    g_reports = oracle_reports = 0;
+    memset(g_linked, 0, sizeof(g_linked));
+    memset(g_stale, 0, sizeof(g_stale));
+}
+
+static void load_image(uint32_t m, uint32_t slot) {
+    g_slot[m] = slot;
+    g_stale[m] = 0;
+    memcpy(&port_ram[slot_addr(slot) - RAM_BASE], g_img[m].img, g_img[m].size);
+    memcpy(&oracle_ram[slot_addr(slot) - RAM_BASE], g_img[m].img, g_img[m].size);
+}
+
+static int compare(const char *tag) {
+    uint32_t i;
+    if (memcmp(port_ram, oracle_ram, RAM_SIZE) != 0) {
+        for (i = 0; i < RAM_SIZE && port_ram[i] == oracle_ram[i]; i++) {}
+        CHECK(0, "%s: RAM differs at %08X (port %02X oracle %02X)", tag,
+              RAM_BASE + i, port_ram[i], oracle_ram[i]);
+    }
+    CHECK(port_state.head == oracle_ModuleList.head && port_state.tail == oracle_ModuleList.tail,
+          "%s: list head/tail %08X/%08X vs %08X/%08X", tag, port_state.head, port_state.tail,
+          oracle_ModuleList.head, oracle_ModuleList.tail);
+    CHECK(g_reports == oracle_reports, "%s: %u reports vs %u", tag, g_reports, oracle_reports);
+    return 1;
+}
+
+static int do_link(uint32_t m, uint32_t bss_slot, const char *tag) {
+    const uint32_t addr = slot_addr(g_slot[m]);
+    const uint32_t before = g_notify_link;
+    int o = oracle_Link(addr, bss_addr(bss_slot));
+    int p = port_OSLinkRel(&port_state, addr, bss_addr(bss_slot));
+
+    CHECK(o == p, "%s: link of id %u returned %d vs %d", tag, g_layout[m].id, p, o);
+    CHECK(g_notify_link - before == (uint32_t)p, "%s: OSNotifyLink count", tag);
+    if (p) g_linked[m] = g_stale[m] = 1;
+    return compare(tag);
+}
+
+static int do_unlink(uint32_t m, const char *tag) {
+    const uint32_t addr = slot_addr(g_slot[m]);
+    const uint32_t before = g_notify_unlink;
+    int o = oracle_Unlink(addr);
+    int p = port_OSUnlinkRel(&port_state, addr);
+
+    CHECK(o == p, "%s: unlink of id %u returned %d vs %d", tag, g_layout[m].id, p, o);
+    CHECK(g_notify_unlink - before == (uint32_t)p, "%s: OSNotifyUnlink count", tag);
+    if (p) g_linked[m] = 0;
+    return compare(tag);
+}
+
+static void setup(uint32_t nmods, int bad, int junk) {
+    uint32_t m;
+    g_allow_bad = bad;
+    g_allow_junk = junk;
+    reset_all();
+    gen_layouts(nmods);
+    for (m = 0; m < nmods; m++) {
+        gen_image(&g_img[m], &g_layout[m]);
+        load_image(m, m);
+    }
+}
+
+/* ── L0: single module ──────────────────────────────────────────── */
+static int test_link(uint32_t seed) {
+    g_rng = seed ? seed : 1;
+    setup(1, 0, 1);
+    if (!compare("L0-Load")) return 0;
+    return do_link(0, 0, "L0-Link");
+}
+
+/* ── L1: chain of modules ───────────────────────────────────────── */
+static int test_chain(uint32_t seed) {
+    uint32_t order[MAX_MODS], n, i;
+
+    g_rng = seed ? seed : 1;
+    n = 2u + xorshift32() % (MAX_MODS - 1u);
+    setup(n, 0, 1);
+    for (i = 0; i < n; i++) order[i] = i;
+    for (i = n; i > 1; i--) {
+        const uint32_t j = xorshift32() % i, t = order[i - 1u];
+        order[i - 1u] = order[j];
+        order[j] = t;
+    }
+    for (i = 0; i < n; i++) {
+        if (!do_link(order[i], order[i], "L1-Link")) return 0;
+    }
+    return 1;
+}
+
+/* ── L2: unlink ─────────────────────────────────────────────────── */
+static int test_unlink(uint32_t seed) {
+    uint32_t n, i, m;
+
+    g_rng = seed ? seed : 1;
+    n = 2u + xorshift32() % (MAX_MODS - 1u);
+    setup(n, 0, 1);
+    for (i = 0; i < n; i++) {
+        if (!do_link(i, i, "L2-Link")) return 0;
+    }
+    for (i = 0; i < n; i++) {
+        m = xorshift32() % n;
+        if (!do_unlink(m, "L2-Unlink")) return 0; /* may be a second unlink */
+    }
+    return 1;
+}
+
+/* ── L3: reload and relink ──────────────────────────────────────── */
+static int test_reload(uint32_t seed) {
+    port_OSLinkStats s0, s1;
+    uint32_t n, i, round;
+
+    g_rng = seed ? seed : 1;
+    n = 2u + xorshift32() % (MAX_MODS - 1u);
+    setup(n, 0, 0);
+    port_OSLinkFlushPlans();
+    for (i = 0; i < n; i++) {
+        if (!do_link(i, i, "L3-Link")) return 0;
+    }
+    for (round = 0; round < 6; round++) {
+        const uint32_t m = xorshift32() % n;
+        uint32_t slot = g_slot[m];
+        const int changed = (xorshift32() % 4u) == 0;
+        uint32_t k;
+
+        if (!do_unlink(m, "L3-Unlink")) return 0;
+        for (k = 0; k < 4; k++) { /* free slot, possibly the same one */
+            const uint32_t s = xorshift32() % NUM_SLOTS;
+            uint32_t j, used = 0;
+            for (j = 0; j < n; j++) if (j != m && g_slot[j] == s) used = 1;
+            if (!used) { slot = s; break; }
+        }
+        if (changed) {
+            /* Same id and layout, different relocations. */
+            gen_image(&g_img[m], &g_layout[m]);
+        }
+        load_image(m, slot);
+        port_OSLinkGetStats(&s0);
+        if (!do_link(m, xorshift32() % NUM_SLOTS, "L3-Relink")) return 0;
+        port_OSLinkGetStats(&s1);
+#ifndef GC_OSLINK_NO_PLAN
+        if (!changed) {
+            CHECK(s1.plan_hits == s0.plan_hits + 1 && s1.plan_built == s0.plan_built,
+                  "L3: reload of id %u did not reuse its plan", g_layout[m].id);
+        } else {
+            CHECK(s1.plan_built == s0.plan_built + 1 || s1.plan_hits == s0.plan_hits + 1,
+                  "L3: changed id %u neither built nor hit", g_layout[m].id);
+        }
+#else
+        CHECK(s1.plan_built == 0 && s1.plan_hits == 0, "L3: plans used without plans");
+#endif
+        CHECK(s1.links == s0.links + 1, "L3: link count");
+        if ((xorshift32() % 4u) == 0) port_OSLinkFlushPlans();
+    }
+    return 1;
+}
+
+/* ── L4: mix ────────────────────────────────────────────────────── */
+static int test_mix(uint32_t seed) {
+    uint32_t n, i;
+
+    g_rng = seed ? seed : 1;
+    n = 1u + xorshift32() % MAX_MODS;
+    setup(n, 1, 1);
+    for (i = 0; i < 40; i++) {
+        const uint32_t m = xorshift32() % n;
+        switch (xorshift32() % 3u) {
+        case 0:
+            if (!g_stale[m] && !do_link(m, xorshift32() % NUM_SLOTS, "L4-Link")) return 0;
+            break;
+        case 1:
+            if (!do_unlink(m, "L4-Unlink")) return 0;
+            break;
+        case 2:
+            if (!g_linked[m]) {
+                uint32_t j, used = 0, s = g_slot[m];
+                if ((xorshift32() & 1u) != 0) gen_image(&g_img[m], &g_layout[m]);
+                for (j = 0; j < n; j++) if (j != m && g_slot[j] == (m + n) % NUM_SLOTS) used = 1;
+                if (!used && (xorshift32() & 1u) != 0) s = (m + n) % NUM_SLOTS;
+                load_image(m, s);
+                if (!compare("L4-Load")) return 0;
+            }
+            break;
+        }
+    }
+    return 1;
+}
+
+/* ── L5: overlay cache ──────────────────────────────────────────── */
+
+static uint64_t g_ov_calls, g_ov_hits, g_ov_stale;
+
+/* A loader: the cache, else read the REL and link it. On a hit the oracle
+ * still reads and links the REL. Returns 0 on a check failure. */
+static int overlay_link(uint32_t m, uint32_t slot, uint32_t bss_slot, int *hit, const char *tag) {
+    const uint32_t addr = slot_addr(slot);
+    const uint32_t before = g_notify_link;
+
+    *hit = port_OSOverlayLink(&port_state, g_layout[m].id, addr, bss_addr(bss_slot));
+    if (!*hit) {
+        load_image(m, slot);
+        return do_link(m, bss_slot, tag);
+    }
+    g_slot[m] = slot;
+    memcpy(&oracle_ram[addr - RAM_BASE], g_img[m].img, g_img[m].size);
+    CHECK(oracle_Link(addr, bss_addr(bss_slot)) == 1, "%s: oracle refused a cached link", tag);
+    CHECK(g_notify_link - before == 1, "%s: OSNotifyLink count", tag);
+    g_linked[m] = g_stale[m] = 1;
+    return compare(tag);
+}
+
+static int test_overlay(uint32_t seed) {
+    port_OSOverlayStats st;
+    uint32_t n, r, i, calls = 0;
+    int in_slot[2] = {-1, -1}, hit;
+
+    g_rng = seed ? seed : 1;
+    n = 3u + xorshift32() % (MAX_MODS - 2u);
+    setup(n, 0, 1);
+    port_OSOverlayCacheInit((xorshift32() % 4u) == 0 ? 0x4000u : 0x100000u);
+
+    /* Modules 0..r-1 stay resident; the rest are overlays in slots 6, 7. */
+    r = 1u + xorshift32() % 2u;
+    for (i = 0; i < r; i++) {
+        if (!do_link(i, i, "L5-Resident")) return 0;
+    }
+    for (i = 0; i < 30; i++) {
+        const uint32_t o = r + xorshift32() % (n - r);
+        const uint32_t s = xorshift32() % 2u;
+        const uint32_t bss_slot = 4u + s + ((xorshift32() % 8u) == 0 ? 2u : 0u);
+        uint32_t k;
+
+        if ((xorshift32() % 8u) == 0) {
+            /* Move a resident: overlays importing it must not hit. */
+            const uint32_t j = xorshift32() % r;
+            if (!do_unlink(j, "L5-Unresident")) return 0;
+            load_image(j, g_slot[j] == j ? j + 2u : j);
+            if (!do_link(j, j, "L5-Reresident")) return 0;
+        }
+        for (k = 0; k < 2; k++) { /* switch: unload what is in the slot */
+            if (in_slot[k] >= 0 && (k == s || in_slot[k] == (int)o)) {
+                if (!do_unlink((uint32_t)in_slot[k], "L5-Unload")) return 0;
+                in_slot[k] = -1;
+            }
+        }
+        if (!overlay_link(o, 6u + s, bss_slot, &hit, "L5-Switch")) return 0;
+        calls++;
+        in_slot[s] = (int)o;
+        if ((xorshift32() % 8u) == 0) {
+            /* Already linked there: a second cached link is refused. */
+            CHECK(!port_OSOverlayLink(&port_state, g_layout[o].id, slot_addr(6u + s), bss_addr(bss_slot)),
+                  "L5: id %u linked twice from the cache", g_layout[o].id);
+            calls++;
+            if (!compare("L5-Twice")) return 0;
+        }
+
+        if (!hit && (xorshift32() % 3u) == 0) {
+            /* Nothing changed: unloading and loading again must hit. */
+            if (!do_unlink(o, "L5-Bounce")) return 0;
+            if (!overlay_link(o, 6u + s, bss_slot, &hit, "L5-Rehit")) return 0;
+            calls++;
+            port_OSOverlayGetStats(&st);
+            CHECK(hit || st.bytes + g_img[o].size > 0x4000u,
+                  "L5: id %u missed right after its capture", g_layout[o].id);
+        }
+    }
+
+    port_OSOverlayGetStats(&st);
+    CHECK(st.hits + st.misses == calls, "L5: %u hits + %u misses != %u calls", st.hits, st.misses, calls);
+    CHECK(st.stale <= st.misses, "L5: stale count");
+    CHECK(st.entries <= PORT_OSOVERLAY_MAX && st.bytes <= 0x100000u, "L5: over budget");
+    g_ov_calls += calls;
+    g_ov_hits += st.hits;
+    g_ov_stale += st.stale;
+    port_OSOverlayCacheInit(0);
+    return 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ * Runner
+ * ═══════════════════════════════════════════════════════════════════ */
+
+static int run_seed(uint32_t seed) {
+    uint32_t sub;
+
+    g_rng = seed;
+    sub = xorshift32();
+
+    if (!g_opt_op || strstr("L0", g_opt_op) || strstr("LINK", g_opt_op)) {
+        if (!test_link(sub ^ 0x0511A001u)) return 0;
+    }
+    if (!g_opt_op || strstr("L1", g_opt_op) || strstr("CHAIN", g_opt_op)) {
+        if (!test_chain(sub ^ 0x0511A002u)) return 0;
+    }
+    if (!g_opt_op || strstr("L2", g_opt_op) || strstr("UNLINK", g_opt_op)) {
+        if (!test_unlink(sub ^ 0x0511A003u)) return 0;
+    }
+    if (!g_opt_op || strstr("L3", g_opt_op) || strstr("RELOAD", g_opt_op)) {
+        if (!test_reload(sub ^ 0x0511A004u)) return 0;
+    }
+    if (!g_opt_op || strstr("L4", g_opt_op) || strstr("MIX", g_opt_op)) {
+        if (!test_mix(sub ^ 0x0511A005u)) return 0;
+    }
+    if (!g_opt_op || strstr("L5", g_opt_op) || strstr("OVERLAY", g_opt_op)) {
+        if (!test_overlay(sub ^ 0x0511A006u)) return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    uint32_t start_seed = 1;
+    int num_runs = 100;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+            start_seed = (uint32_t)strtoul(argv[i] + 7, NULL, 0);
+        else if (strncmp(argv[i], "--num-runs=", 11) == 0)
+            num_runs = atoi(argv[i] + 11);
+        else if (strncmp(argv[i], "--op=", 5) == 0)
+            g_opt_op = argv[i] + 5;
+        else if (strcmp(argv[i], "-v") == 0)
+            g_verbose = 1;
+        else {
+            fprintf(stderr,
+                    "Usage: oslink_property_test [--seed=N] [--num-runs=N] "
+                    "[--op=L0|L1|L2|L3|L4|L5|LINK|CHAIN|UNLINK|RELOAD|MIX|OVERLAY] [-v]\n");
+            return 2;
+        }
+    }
+
+    gc_mem_set(RAM_BASE, sizeof(port_ram), port_ram);
+
+#ifdef GC_OSLINK_NO_PLAN
+    printf("\n=== OSLink Property Test (stream walk) ===\n");
+#else
+    printf("\n=== OSLink Property Test (fixup plans) ===\n");
+#endif
+
+    for (i = 0; i < num_runs; i++) {
+        uint32_t seed = start_seed + (uint32_t)i;
+        uint64_t before = g_total_checks;
+
+        if (!run_seed(seed)) {
+            printf("  FAILED at seed %u\n", seed);
+            printf("\n--- Summary ---\n");
+            printf("Seeds:  %d (failed at %d)\n", i + 1, i + 1);
+            printf("Checks: %llu  (pass=%llu  fail=1)\n",
+                   (unsigned long long)g_total_checks, (unsigned long long)g_total_pass);
+            printf("\nRESULT: FAIL\n");
+            return 1;
+        }
+
+        if (g_verbose) {
+            printf("  seed %u: %llu checks OK\n",
+                   seed, (unsigned long long)(g_total_checks - before));
+        }
+        if ((i + 1) % 100 == 0) {
+            printf("  progress: seed %d/%d\n", i + 1, num_runs);
+        }
+    }
+
+    {
+        port_OSLinkStats st;
+        port_OSLinkGetStats(&st);
+        printf("\nLinker: %u links, %u unlinks, %u plans built, %u plan hits, %llu relocations, %u unknown\n",
+               st.links, st.unlinks, st.plan_built, st.plan_hits,
+               (unsigned long long)st.relocs, st.unknown);
+        if (g_ov_calls) {
+            printf("Overlay cache: %llu/%llu hits, %llu stale\n", (unsigned long long)g_ov_hits,
+                   (unsigned long long)g_ov_calls, (unsigned long long)g_ov_stale);
+        }
+    }
+
+    printf("\n--- Summary ---\n");
+    printf("Seeds:  %d\n", num_runs);
+    printf("Checks: %llu  (pass=%llu  fail=0)\n",
+           (unsigned long long)g_total_checks, (unsigned long long)g_total_pass);
+    printf("\nRESULT: %llu/%llu PASS\n",
+           (unsigned long long)g_total_pass, (unsigned long long)g_total_checks);
+
+    return 0;
+}
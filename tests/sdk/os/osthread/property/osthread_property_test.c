@@ -22,6 +22,8 @@
  *   L9: Message queue with threads (blocking sequences)
  *   L10: WaitCond/SignalCond (condition variable sequences)
  *   L11: Mutex invariant checks (__OSCheckMutex, __OSCheckDeadLock, __OSCheckMutexes)
+ *   L12: Fiber threads (bodies run on host fibers, ops issued from inside them)
+ *   L13: Scheduler trace (recorded spans against oracle state between ops)
  */
 #include <stdint.h>
 #include <stdio.h>
@@ -134,6 +136,7 @@ static void init_both(void)
     int i;
     init_gc_mem();
     oracle_OSThreadInit();
+    port_OSThreadShutdown(&g_ps);
     port_OSThreadInit(&g_ps, GC_BASE);
     memset(g_thread_created, 0, sizeof(g_thread_created));
     g_thread_created[0] = 1; /* default thread */
@@ -1702,6 +1705,501 @@ static int test_mutex_invariants(uint32_t seed)
     return fail;
 }
 
+/* ── L12: Fiber threads ──
+ *
+ * Thread bodies run on port fibers and issue the scheduler ops themselves,
+ * oracle first, then port; the port call is where the fiber switch
+ * happens. Each body checks on return from every op that it is the
+ * thread the oracle would be running, and that nothing of a higher
+ * priority is ready. The default thread (the host) sleeps on the last
+ * wait queue and, while idle, plays the interrupt waking the others.
+ */
+
+#define L12_HOST_WAITQ (MAX_TEST_WAITQ - 1)
+
+static uint32_t g_fiber_seed;
+static int g_fiber_fail;
+static int g_fiber_rounds[MAX_TEST_THREADS];
+
+static int fiber_check_self(int slot, const char *op)
+{
+    uint32_t self = PORT_THREAD_ADDR(&g_ps, slot);
+    int32_t prio = oracle_ThreadPool[slot].priority;
+
+    g_total_checks++;
+    if (g_ps.currentThread != self ||
+        oracle_CurrentThread != &oracle_ThreadPool[slot] ||
+        g_ps.running != slot ||
+        (int32_t)oracle_cntlzw(g_ps.runQueueBits) < prio) {
+        fprintf(stderr,
+            "  FAIL %s seed=%u slot=%d: current=0x%X running=%d "
+            "oracle=%d prio=%d RunQueueBits=0x%08X\n",
+            op, g_fiber_seed, slot, g_ps.currentThread, (int)g_ps.running,
+            oracle_CurrentThread ? oracle_CurrentThread->id : -1,
+            prio, g_ps.runQueueBits);
+        g_total_fail++;
+        return 1;
+    }
+    g_total_pass++;
+    return check(op, g_fiber_seed);
+}
+
+static void *fiber_body(void *arg)
+{
+    int slot = (int)(intptr_t)arg;
+    uint32_t val;
+
+    g_fiber_fail += fiber_check_self(slot, "L12-Enter");
+    while (g_fiber_rounds[slot]-- > 0 && g_fiber_fail == 0) {
+        uint32_t r = xorshift32() % 100;
+
+        if (r < 30) {
+            oracle_OSYieldThread();
+            port_OSYieldThread(&g_ps);
+            g_fiber_fail += fiber_check_self(slot, "L12-Yield");
+        } else if (r < 70) {
+            int wq = (int)(xorshift32() % L12_HOST_WAITQ);
+            oracle_OSSleepThread(&oracle_WaitQueues[wq]);
+            port_OSSleepThread(&g_ps, PORT_WAITQ_ADDR(&g_ps, wq));
+            g_fiber_fail += fiber_check_self(slot, "L12-Sleep");
+        } else {
+            int wq = (int)(xorshift32() % L12_HOST_WAITQ);
+            oracle_OSWakeupThread(&oracle_WaitQueues[wq]);
+            port_OSWakeupThread(&g_ps, PORT_WAITQ_ADDR(&g_ps, wq));
+            g_fiber_fail += fiber_check_self(slot, "L12-Wakeup");
+        }
+    }
+
+    /* Returning exits the port thread; the oracle has to be told here. */
+    val = 0xF1BE0000u | (uint32_t)slot;
+    oracle_OSExitThread(val);
+    return (void *)(uintptr_t)val;
+}
+
+static int test_fibers(uint32_t seed)
+{
+    int n_threads, i, iter, done;
+    int fail = 0;
+
+    init_both();
+    g_fiber_seed = seed;
+    g_fiber_fail = 0;
+
+    n_threads = (int)rand_range(2, 6);
+    for (i = 1; i <= n_threads; i++) {
+        int32_t prio = (int32_t)rand_range(8, 24);
+
+        g_fiber_rounds[i] = (int)rand_range(1, 16);
+        oracle_OSCreateThread(&oracle_ThreadPool[i], prio, 0);
+        if (!port_OSCreateThreadFiber(&g_ps, i, fiber_body,
+                                      (void *)(intptr_t)i, prio, 0)) {
+            fprintf(stderr, "  FAIL L12-Create seed=%u slot=%d\n", seed, i);
+            g_total_fail++; g_total_checks++;
+            return 1;
+        }
+        g_thread_created[i] = 1;
+        g_num_created++;
+    }
+    for (i = 1; i <= n_threads && fail == 0 && g_fiber_fail == 0; i++) {
+        oracle_OSResumeThread(&oracle_ThreadPool[i]);
+        port_OSResumeThread(&g_ps, PORT_THREAD_ADDR(&g_ps, i));
+        fail += check("L12-Resume", seed);
+    }
+
+    /* Host thread out of the way; run the fibers until they have all
+     * exited, waking their wait queues whenever everything sleeps. */
+    if (fail == 0 && g_fiber_fail == 0 &&
+        oracle_CurrentThread == &oracle_ThreadPool[0]) {
+        oracle_OSSleepThread(&oracle_WaitQueues[L12_HOST_WAITQ]);
+        port_OSSleepThread(&g_ps, PORT_WAITQ_ADDR(&g_ps, L12_HOST_WAITQ));
+        fail += check("L12-HostSleep", seed);
+    }
+    for (iter = 0; iter < 1000 && fail == 0 && g_fiber_fail == 0; iter++) {
+        for (done = 1, i = 1; i <= n_threads; i++) {
+            if (oracle_ThreadPool[i].state != ORACLE_OS_THREAD_STATE_MORIBUND)
+                done = 0;
+        }
+        if (done) break;
+        {
+            int wq = (int)(xorshift32() % L12_HOST_WAITQ);
+            oracle_OSWakeupThread(&oracle_WaitQueues[wq]);
+            port_OSWakeupThread(&g_ps, PORT_WAITQ_ADDR(&g_ps, wq));
+            fail += check("L12-HostWakeup", seed);
+        }
+    }
+    fail += g_fiber_fail;
+    if (fail) return fail;
+
+    oracle_OSWakeupThread(&oracle_WaitQueues[L12_HOST_WAITQ]);
+    port_OSWakeupThread(&g_ps, PORT_WAITQ_ADDR(&g_ps, L12_HOST_WAITQ));
+    fail += check("L12-HostWake", seed);
+    g_total_checks++;
+    if (fail || g_ps.running != PORT_FIBER_HOST ||
+        g_ps.currentThread != PORT_THREAD_ADDR(&g_ps, 0) || g_ps.switches == 0) {
+        fprintf(stderr,
+            "  FAIL L12-Done seed=%u: running=%d current=0x%X switches=%u\n",
+            seed, (int)g_ps.running, g_ps.currentThread, g_ps.switches);
+        g_total_fail++;
+        return 1;
+    }
+    g_total_pass++;
+
+    for (i = 1; i <= n_threads && fail == 0; i++) {
+        uint32_t oval = 0, pval = 0;
+        int rc_o = oracle_OSJoinThread(&oracle_ThreadPool[i], &oval);
+        int rc_p = port_OSJoinThread(&g_ps, PORT_THREAD_ADDR(&g_ps, i), &pval);
+
+        if (rc_o != 1 || rc_p != 1 || oval != pval) {
+            fprintf(stderr,
+                "  FAIL L12-Join seed=%u slot=%d: rc o=%d p=%d val o=0x%X p=0x%X\n",
+                seed, i, rc_o, rc_p, oval, pval);
+            g_total_fail++; g_total_checks++;
+            return 1;
+        }
+        fail += check("L12-Join", seed);
+    }
+
+    if (opt_verbose && fail == 0) {
+        printf("  L12-Fibers: %d threads, %u switches OK\n",
+               n_threads, g_ps.switches);
+    }
+    port_OSThreadShutdown(&g_ps);
+
+    return fail;
+}
+
+/* ── L13: Scheduler trace ──
+ *
+ * A random thread / mutex / message mix under a test clock that advances
+ * between ops. After each op the oracle state is snapshot; every interval
+ * between two ops must then be covered, for each thread, by exactly the
+ * span its oracle state implies (running, ready, or blocked on the right
+ * object) and by no other. Priority raises recorded at an op must be the
+ * threads whose oracle priority dropped during it.
+ */
+
+#define L13_MAX_STEPS 100
+
+typedef struct {
+    uint64_t t;
+    int cur;
+    uint32_t kind[MAX_TEST_THREADS];   /* expected span, 0 = none */
+    uint32_t obj[MAX_TEST_THREADS];
+    int32_t prio[MAX_TEST_THREADS];
+    int resumed;                       /* slot resumed by the op, or -1 */
+} TraceStep;
+
+static uint64_t g_trace_now;
+static uint64_t g_trace_t0;         /* clock at port_OSTraceStart; events are relative */
+static TraceStep g_steps[L13_MAX_STEPS + 1];
+static port_OSTraceEvent g_trace_ev[PORT_TRACE_RING];
+
+static uint64_t trace_clock(void *ctx)
+{
+    (void)ctx;
+    return g_trace_now;
+}
+
+/* Expected span of an oracle thread, as the port classifies its queue. */
+static uint32_t oracle_span(oracle_OSThread *ot, uint32_t *obj)
+{
+    oracle_OSThreadQueue *q = ot->queue;
+    int i;
+
+    *obj = 0;
+    if (ot == oracle_CurrentThread) return PORT_TRACE_RUN;
+    if (ot->state == ORACLE_OS_THREAD_STATE_READY)
+        return ot->suspend <= 0 ? PORT_TRACE_READY : 0;
+    if (ot->state != ORACLE_OS_THREAD_STATE_WAITING) return 0;
+    for (i = 0; i < ORACLE_MAX_WAIT_QUEUES; i++)
+        if (q == &oracle_WaitQueues[i]) { *obj = PORT_WAITQ_ADDR(&g_ps, i); return PORT_TRACE_WAIT; }
+    for (i = 0; i < ORACLE_MAX_MUTEXES; i++)
+        if (q == &oracle_MutexPool[i].queue) { *obj = PORT_MUTEX_ADDR(&g_ps, i); return PORT_TRACE_MUTEX; }
+    for (i = 0; i < ORACLE_MAX_CONDS; i++)
+        if (q == &oracle_CondPool[i].queue) { *obj = PORT_COND_ADDR(&g_ps, i); return PORT_TRACE_COND; }
+    for (i = 0; i < ORACLE_MAX_MSGQUEUES; i++) {
+        *obj = PORT_MSGQ_ADDR(&g_ps, i);
+        if (q == &oracle_MsgQPool[i].queueSend) return PORT_TRACE_MSG_SEND;
+        if (q == &oracle_MsgQPool[i].queueReceive) return PORT_TRACE_MSG_RECV;
+    }
+    *obj = 0;
+    return PORT_TRACE_WAIT;
+}
+
+static void trace_snapshot(TraceStep *st, int n_threads, int resumed)
+{
+    int i;
+    st->t = g_trace_now - g_trace_t0;
+    st->cur = oracle_CurrentThread ? oracle_CurrentThread->id : -1;
+    st->resumed = resumed;
+    for (i = 0; i <= n_threads; i++) {
+        st->kind[i] = oracle_span(&oracle_ThreadPool[i], &st->obj[i]);
+        st->prio[i] = oracle_ThreadPool[i].priority;
+    }
+}
+
+static int trace_fail(uint32_t seed, int slot, const char *what, int step)
+{
+    fprintf(stderr, "  FAIL L13-Trace seed=%u slot=%d step=%d: %s\n",
+            seed, slot, step, what);
+    g_total_fail++;
+    g_total_checks++;
+    return 1;
+}
+
+/* Spans of every slot against the snapshots steps[0..n_steps]. */
+static int trace_verify(uint32_t seed, int n_threads, int n_steps, uint64_t t_end)
+{
+    int slot, k;
+
+    for (slot = 0; slot <= n_threads; slot++) {
+        uint32_t dropped, n, e;
+
+        n = port_OSTraceRead(&g_ps, slot, g_trace_ev, PORT_TRACE_RING, &dropped);
+        if (dropped) return trace_fail(seed, slot, "ring overflow", -1);
+
+        /* Span ends and priority raises fall on op times. */
+        for (e = 0; e < n; e++) {
+            const port_OSTraceEvent *ev = &g_trace_ev[e];
+            int ok_ts = 0, ok_end = ev->ts + ev->dur == t_end;
+            for (k = 0; k <= n_steps; k++) {
+                ok_ts |= ev->ts == g_steps[k].t;
+                ok_end |= ev->ts + ev->dur == g_steps[k].t;
+            }
+            if (!ok_ts || !ok_end) return trace_fail(seed, slot, "span off the op times", -1);
+            if (ev->kind == PORT_TRACE_INVERSION) {
+                /* ops may share a time: any of them may have raised it */
+                int found = 0;
+                for (k = 1; k <= n_steps; k++)
+                    found |= g_steps[k].t == ev->ts &&
+                             (g_steps[k].prio[slot] < g_steps[k - 1].prio[slot] ||
+                              g_steps[k].resumed == slot);
+                if ((ev->arg & 0xFFu) >= ev->arg >> 8 || !found)
+                    return trace_fail(seed, slot, "unexpected inversion", -1);
+            }
+        }
+
+        /* Each interval between ops: exactly the expected span covers it. */
+        for (k = 0; k <= n_steps; k++) {
+            uint64_t a = g_steps[k].t;
+            uint64_t b = k < n_steps ? g_steps[k + 1].t : t_end;
+            int covering = 0;
+            uint32_t kind = 0, obj = 0;
+
+            if (a == b) continue;
+            for (e = 0; e < n; e++) {
+                const port_OSTraceEvent *ev = &g_trace_ev[e];
+                if (ev->kind != PORT_TRACE_INVERSION &&
+                    ev->ts <= a && b <= ev->ts + ev->dur) {
+                    covering++;
+                    kind = ev->kind;
+                    obj = ev->arg;
+                }
+            }
+            g_total_checks++;
+            if (g_steps[k].kind[slot] == 0 ? covering != 0 :
+                (covering != 1 || kind != g_steps[k].kind[slot] ||
+                 (kind > PORT_TRACE_READY && obj != g_steps[k].obj[slot]))) {
+                fprintf(stderr,
+                    "  FAIL L13-Trace seed=%u slot=%d step=%d: span kind %u obj 0x%X "
+                    "(x%d), expected %u obj 0x%X\n",
+                    seed, slot, k, kind, obj, covering,
+                    g_steps[k].kind[slot], g_steps[k].obj[slot]);
+                g_total_fail++;
+                return 1;
+            }
+            g_total_pass++;
+        }
+
+        /* Every priority drop that went through priority inheritance shows. */
+        for (k = 1; k <= n_steps; k++) {
+            int found = 0;
+            if (g_steps[k].prio[slot] >= g_steps[k - 1].prio[slot] ||
+                g_steps[k].resumed == slot)
+                continue;
+            for (e = 0; e < n; e++)
+                found |= g_trace_ev[e].kind == PORT_TRACE_INVERSION &&
+                         g_trace_ev[e].ts == g_steps[k].t &&
+                         (g_trace_ev[e].arg & 0xFFu) == (uint32_t)g_steps[k].prio[slot];
+            if (!found) return trace_fail(seed, slot, "missing inversion", k);
+        }
+    }
+    return 0;
+}
+
+/* The JSON export holds one event per recorded one, plus a name per slot. */
+static int trace_check_json(uint32_t seed, int n_threads)
+{
+    FILE *f = tmpfile();
+    char line[512];
+    uint32_t lines = 0, expect = 2, events = 0;
+    int slot, ok;
+
+    if (!f) return 0;
+    for (slot = 0; slot <= n_threads; slot++) {
+        uint32_t n = port_OSTraceRead(&g_ps, slot, g_trace_ev, PORT_TRACE_RING, NULL);
+        if (n) expect += n + 1;
+        events += n;
+    }
+    ok = port_OSTraceWriteJSON(&g_ps, f);
+    rewind(f);
+    while (fgets(line, sizeof(line), f)) {
+        if (lines == 0) ok &= strncmp(line, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 39) == 0;
+        lines++;
+    }
+    ok &= strcmp(line, "]}\n") == 0 && lines == expect;
+    fclose(f);
+    g_total_checks++;
+    if (!ok) {
+        fprintf(stderr, "  FAIL L13-JSON seed=%u: %u lines for %u events\n",
+                seed, lines, events);
+        g_total_fail++;
+        return 1;
+    }
+    g_total_pass++;
+    return 0;
+}
+
+static int test_trace(uint32_t seed)
+{
+    int n_threads, i, k, n_steps;
+    int fail = 0;
+    int32_t cap;
+    uint32_t n, dropped;
+
+    init_both();
+
+    n_threads = (int)rand_range(3, 8);
+    for (i = 1; i <= n_threads; i++) create_both(i, (int32_t)rand_range(4, 28), 1);
+    for (i = 1; i <= n_threads; i++) {
+        if (xorshift32() % 4 == 0) continue;   /* some start suspended */
+        oracle_OSResumeThread(&oracle_ThreadPool[i]);
+        port_OSResumeThread(&g_ps, PORT_THREAD_ADDR(&g_ps, i));
+    }
+    cap = (int32_t)rand_range(1, 3);
+    oracle_OSInitMessageQueue(&oracle_MsgQPool[0], cap);
+    port_OSInitMessageQueue(&g_ps, PORT_MSGQ_ADDR(&g_ps, 0), cap);
+    fail += check("L13-Init", seed);
+    if (fail) return fail;
+
+    g_trace_now = g_trace_t0 = 1000;
+    port_OSTraceStart(&g_ps, trace_clock, NULL);
+    trace_snapshot(&g_steps[0], n_threads, -1);
+
+    n_steps = (int)rand_range(40, L13_MAX_STEPS);
+    for (k = 1; k <= n_steps && fail == 0; k++) {
+        uint32_t r = xorshift32() % 100;
+        int running = oracle_CurrentThread != NULL &&
+                      oracle_CurrentThread->state == ORACLE_OS_THREAD_STATE_RUNNING;
+        int resumed = -1;
+
+        g_trace_now += rand_range(0, 50);   /* 0: ops at one time stay legal */
+        if (r < 25) {
+            int slot = (int)rand_range(1, (uint32_t)n_threads);
+            oracle_OSThread *ot = &oracle_ThreadPool[slot];
+
+            /* A cond waiter keeps its mutex for the deferred re-lock, and
+             * both models' Suspend/Resume would chase its owner (NULL). */
+            int cond_wait = ot->mutex && !ot->mutex->thread;
+
+            if (r < 15 && !cond_wait) {
+                oracle_OSResumeThread(ot);
+                port_OSResumeThread(&g_ps, PORT_THREAD_ADDR(&g_ps, slot));
+                resumed = slot;
+            } else if (r >= 15 && !cond_wait && ot != oracle_CurrentThread) {
+                oracle_OSSuspendThread(ot);
+                port_OSSuspendThread(&g_ps, PORT_THREAD_ADDR(&g_ps, slot));
+            }
+        } else if (r < 40) {
+            int wq = (int)(xorshift32() % MAX_TEST_WAITQ);
+            if (running) {
+                oracle_OSSleepThread(&oracle_WaitQueues[wq]);
+                port_OSSleepThread(&g_ps, PORT_WAITQ_ADDR(&g_ps, wq));
+            }
+        } else if (r < 55) {
+            int wq = (int)(xorshift32() % MAX_TEST_WAITQ);
+            oracle_OSWakeupThread(&oracle_WaitQueues[wq]);
+            port_OSWakeupThread(&g_ps, PORT_WAITQ_ADDR(&g_ps, wq));
+        } else if (r < 62) {
+            if (running) {
+                oracle_OSYieldThread();
+                port_OSYieldThread(&g_ps);
+            }
+        } else if (r < 77) {
+            int m = (int)(xorshift32() % 3);
+            if (running) {
+                oracle_OSLockMutex(&oracle_MutexPool[m]);
+                port_OSLockMutex(&g_ps, PORT_MUTEX_ADDR(&g_ps, m));
+            }
+        } else if (r < 85) {
+            int m = (int)(xorshift32() % 3);
+            if (running) {
+                oracle_OSUnlockMutex(&oracle_MutexPool[m]);
+                port_OSUnlockMutex(&g_ps, PORT_MUTEX_ADDR(&g_ps, m));
+            }
+        } else if (r < 90) {
+            int m = (int)(xorshift32() % 3);
+            if (running && oracle_MutexPool[m].thread == oracle_CurrentThread) {
+                oracle_OSWaitCond(&oracle_CondPool[0], &oracle_MutexPool[m]);
+                port_OSWaitCond(&g_ps, PORT_COND_ADDR(&g_ps, 0), PORT_MUTEX_ADDR(&g_ps, m));
+            } else {
+                oracle_OSSignalCond(&oracle_CondPool[0]);
+                port_OSSignalCond(&g_ps, PORT_COND_ADDR(&g_ps, 0));
+            }
+        } else if (running) {
+            uint32_t msg = xorshift32(), omsg, pmsg;
+            if (r & 1) {
+                oracle_OSSendMessage(&oracle_MsgQPool[0], msg, ORACLE_OS_MESSAGE_BLOCK);
+                port_OSSendMessage(&g_ps, PORT_MSGQ_ADDR(&g_ps, 0), msg, 1);
+            } else {
+                oracle_OSReceiveMessage(&oracle_MsgQPool[0], &omsg, ORACLE_OS_MESSAGE_BLOCK);
+                port_OSReceiveMessage(&g_ps, PORT_MSGQ_ADDR(&g_ps, 0), &pmsg, 1);
+            }
+        }
+        fail += check_pending("L13-Op", seed);
+        trace_snapshot(&g_steps[k], n_threads, resumed);
+    }
+    if (fail) return fail;
+
+    g_trace_now += rand_range(1, 50);
+    port_OSTraceStop(&g_ps);
+    fail += trace_verify(seed, n_threads, n_steps, g_trace_now - g_trace_t0);
+    if (fail == 0) fail += trace_check_json(seed, n_threads);
+    if (fail) return fail;
+
+    /* Ring wraparound: the default thread yielding alone, two events a yield. */
+    init_both();
+    g_trace_now = 0;
+    port_OSTraceStart(&g_ps, trace_clock, NULL);
+    for (i = 0; i < 700; i++) {
+        g_trace_now++;
+        port_OSYieldThread(&g_ps);
+    }
+    port_OSTraceStop(&g_ps);
+    n = port_OSTraceRead(&g_ps, 0, g_trace_ev, PORT_TRACE_RING, &dropped);
+    g_total_checks++;
+    if (n != PORT_TRACE_RING || dropped != 2 * 700 + 1 - PORT_TRACE_RING ||
+        g_trace_ev[n - 1].kind != PORT_TRACE_RUN || g_trace_ev[n - 1].ts != 700) {
+        fprintf(stderr, "  FAIL L13-Ring seed=%u: %u events, %u dropped\n",
+                seed, n, dropped);
+        g_total_fail++;
+        return 1;
+    }
+    for (i = 1; i < (int)n; i++) {
+        if (g_trace_ev[i].ts < g_trace_ev[i - 1].ts) {
+            fprintf(stderr, "  FAIL L13-Ring seed=%u: event %d out of order\n", seed, i);
+            g_total_fail++;
+            return 1;
+        }
+    }
+    g_total_pass++;
+
+    if (opt_verbose) {
+        printf("  L13-Trace: %d threads, %d ops OK\n", n_threads, n_steps);
+    }
+    return 0;
+}
+
 /* ── Run one seed ── */
 
 static int run_seed(uint32_t seed)
@@ -1797,6 +2295,20 @@ static int run_seed(uint32_t seed)
         fail += test_mutex_invariants(seed);
     }
 
+    /* L12: Fiber threads */
+    if (!opt_op || strstr("L12", opt_op) || strstr("FIBER", opt_op)) {
+        g_rng = seed ^ 0x0F1BE125u;
+        if (g_rng == 0) g_rng = 1;
+        fail += test_fibers(seed);
+    }
+
+    /* L13: Scheduler trace */
+    if (!opt_op || strstr("L13", opt_op) || strstr("TRACE", opt_op)) {
+        g_rng = seed ^ 0x7ACE5EEDu;
+        if (g_rng == 0) g_rng = 1;
+        fail += test_trace(seed);
+    }
+
     return fail;
 }
 
@@ -0,0 +1,126 @@
+/*
+ * stopwatch_profile_unit_test.c --- Unit test for the OSStopwatch profiler.
+ *
+ * Links src/sdk_port/os/OSStopwatch.c built with GC_OSSTOPWATCH_PROFILE and
+ * checks the registry against the stopwatches' own counters.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sdk_port/os/OSStopwatch.h"
+
+typedef struct OSStopwatch {
+    char *name;
+    uint64_t total;
+    uint32_t hits;
+    uint32_t running;
+    uint64_t last;
+    uint64_t min;
+    uint64_t max;
+} OSStopwatch;
+
+void OSInitStopwatch(OSStopwatch *sw, char *name);
+void OSStartStopwatch(OSStopwatch *sw);
+void OSStopStopwatch(OSStopwatch *sw);
+void OSResetStopwatch(OSStopwatch *sw);
+
+int OSReport(const char *msg, ...) { (void)msg; return 0; }
+
+static int g_failures = 0;
+
+static void expect(const char *label, int ok) {
+    if (!ok) {
+        fprintf(stderr, "FAIL %s\n", label);
+        g_failures++;
+    }
+}
+
+static const port_OSStopwatchProf *find(const char *name, port_OSStopwatchProf *buf) {
+    int i;
+    for (i = 0; i < port_OSStopwatchProfCount(); i++) {
+        if (port_OSStopwatchProfGet(i, buf) == 0 && strcmp(buf->name, name) == 0) return buf;
+    }
+    return NULL;
+}
+
+static void spin_us(long us) {
+    struct timespec a, b;
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    do {
+        clock_gettime(CLOCK_MONOTONIC, &b);
+    } while ((b.tv_sec - a.tv_sec) * 1000000L + (b.tv_nsec - a.tv_nsec) / 1000L < us);
+}
+
+int main(void) {
+    static OSStopwatch many[300];
+    OSStopwatch cpu, gpu, idle;
+    port_OSStopwatchProf p, q;
+    uint64_t ticks = 0;
+    uint32_t hits = 0;
+    char names[300][8];
+    int frame, i;
+
+    OSInitStopwatch(&cpu, (char *)"CPU");
+    OSInitStopwatch(&gpu, (char *)"GPU");
+    OSInitStopwatch(&idle, (char *)"IDLE");
+    expect("three registered", port_OSStopwatchProfCount() == 3);
+    expect("idle registered with zero hits",
+           find("IDLE", &p) != NULL && p.hits == 0 && p.host_min_ns == 0 && p.host_total_ns == 0);
+
+    /* A frame loop like HuPerf: start/stop each frame, reset every frame. */
+    for (frame = 0; frame < 20; frame++) {
+        OSStartStopwatch(&cpu);
+        spin_us(200);
+        OSStartStopwatch(&gpu);
+        OSStopStopwatch(&gpu);
+        OSStopStopwatch(&cpu);
+        OSStopStopwatch(&cpu); /* not running: no hit */
+        ticks += cpu.total;
+        hits += cpu.hits;
+        OSResetStopwatch(&cpu);
+        OSResetStopwatch(&gpu);
+    }
+    expect("reset keeps one entry per stopwatch", port_OSStopwatchProfCount() == 3);
+    expect("CPU found", find("CPU", &p) != NULL);
+    expect("CPU hits accumulate across resets", p.hits == 20 && hits == 20);
+    expect("CPU ticks match the stopwatch totals", p.ticks == ticks);
+    expect("CPU host time covers the spin", p.host_min_ns >= 200000u && p.host_total_ns >= 20u * 200000u);
+    expect("CPU min <= max", p.host_min_ns <= p.host_max_ns);
+    expect("GPU found", find("GPU", &q) != NULL);
+    expect("GPU hits", q.hits == 20);
+    expect("GPU nested inside CPU", q.host_total_ns < p.host_total_ns);
+    expect("get out of range", port_OSStopwatchProfGet(3, &p) == -1 && port_OSStopwatchProfGet(-1, &p) == -1);
+
+    /* Re-init under a new name renames the entry, keyed by address. */
+    OSInitStopwatch(&idle, (char *)"WAIT");
+    expect("rename", find("WAIT", &p) != NULL && find("IDLE", &q) == NULL);
+
+    /* The registry is bounded; stopwatches past it still work. */
+    for (i = 0; i < 300; i++) {
+        snprintf(names[i], sizeof(names[i]), "sw%d", i);
+        OSInitStopwatch(&many[i], names[i]);
+        OSStartStopwatch(&many[i]);
+        OSStopStopwatch(&many[i]);
+    }
+    expect("registry capped", port_OSStopwatchProfCount() == PORT_OSSTOPWATCH_PROF_MAX);
+    expect("unregistered stopwatch still counts", many[299].hits == 1);
+    expect("sw0 registered", find("sw0", &p) != NULL && p.hits == 1);
+
+    port_OSStopwatchProfDump(stdout);
+
+    port_OSStopwatchProfReset();
+    expect("reset empties", port_OSStopwatchProfCount() == 0);
+    OSStartStopwatch(&cpu);
+    OSStopStopwatch(&cpu);
+    expect("start registers", port_OSStopwatchProfCount() == 1 && find("CPU", &p) != NULL && p.hits == 1);
+
+    if (g_failures) {
+        fprintf(stderr, "stopwatch_profile_unit_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("stopwatch_profile_unit_test: PASS\n");
+    return 0;
+}
@@ -147,10 +147,10 @@ MUTATIONS = [
     # 6
     ("gx_clear_gp_metric_set_one",
      "gx_clear_gp_metric",
-     "GXClearGPMetric: set perf0 to 1 instead of 0",
-     "    gc_gx_gp_perf0 = 0;",
-     "    gc_gx_gp_perf0 = 1; // MUTANT",
-     2066, 1),  # in GXClearGPMetric (line ~2068)
+     "GXClearGPMetric: set metric 0 to 1 instead of 0",
+     "    gc_gx_gp_metric[0] = 0;",
+     "    gc_gx_gp_metric[0] = 1; // MUTANT",
+     0, 1),
     # 7
     ("gx_clear_mem_metric_loop_bound",
      "gx_clear_mem_metric",
@@ -169,9 +169,9 @@ MUTATIONS = [
     ("gx_clear_vcache_metric_set_one",
      "gx_clear_vcache_metric",
      "GXClearVCacheMetric: set to 1 instead of 0",
-     "    gc_gx_vcache_sel = 0;",
-     "    gc_gx_vcache_sel = 1; // MUTANT",
-     2080, 1),  # in GXClearVCacheMetric (~2082)
+     "    for (u32 i = 0; i < 3; i++) gc_gx_vcache_metrics[i] = 0;",
+     "    for (u32 i = 0; i < 3; i++) gc_gx_vcache_metrics[i] = 1; // MUTANT",
+     0, 1),
     # 10
     ("gx_clear_vtx_desc_wrong_dirty",
      "gx_clear_vtx_desc",
@@ -428,8 +428,8 @@ MUTATIONS = [
     ("gx_read_gp_metric_swap",
      "gx_read_gp_metric",
      "GXReadGPMetric: swap perf0/perf1 outputs",
-     "    if (met0) *met0 = gc_gx_gp_perf0;",
-     "    if (met0) *met0 = gc_gx_gp_perf1; // MUTANT",
+     "    if (met0) *met0 = gc_gx_gp_metric[0];",
+     "    if (met0) *met0 = gc_gx_gp_metric[1]; // MUTANT",
      0, 1),
     # 47
     ("gx_read_mem_metric_swap",
@@ -448,8 +448,8 @@ MUTATIONS = [
     # 49
     ("gx_read_vcache_metric_wrong_miss",
      "gx_read_vcache_metric",
-     "GXReadVCacheMetric: return 1 for miss instead of 0",
-     "    if (miss) *miss = 0;",
+     "GXReadVCacheMetric: return 1 for miss instead of the counter",
+     "    if (miss) *miss = gc_gx_vcache_metrics[1];",
      "    if (miss) *miss = 1; // MUTANT",
      0, 1),
     # 50
@@ -1,7 +1,7 @@
 #!/usr/bin/env bash
 set -euo pipefail
 
-# Mutation check for GXClearGPMetric: set perf0 to 1 instead of 0
+# Mutation check for GXClearGPMetric: set metric 0 to 1 instead of 0
 #
 # Usage:
 #   tools/mutations/gx_clear_gp_metric_set_one.sh <test_case_dir> [<test_case_dir2> ...]
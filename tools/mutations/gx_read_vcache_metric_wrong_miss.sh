@@ -1,7 +1,7 @@
 #!/usr/bin/env bash
 set -euo pipefail
 
-# Mutation check for GXReadVCacheMetric: return 1 for miss instead of 0
+# Mutation check for GXReadVCacheMetric: return 1 for miss instead of the counter
 #
 # Usage:
 #   tools/mutations/gx_read_vcache_metric_wrong_miss.sh <test_case_dir> [<test_case_dir2> ...]
@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""Summarize an OSAlloc profiler log (port_OSAllocProfStart).
+
+Per heap: call counts, peak live bytes and the frame it happened in, free
+space fragmentation at frame ends (1 - largest free cell / total free), a
+size-class histogram of allocations, a per-tag breakdown, and the blocks
+still live at the end of the log grouped by the frame that allocated them.
+
+The log layout is documented in src/sdk_port/os/OSAlloc.h.
+"""
+import argparse
+import struct
+import sys
+from collections import defaultdict
+from pathlib import Path
+
+MAGIC = b"OSAP"
+RECORD = struct.Struct("<BBHIII")
+
+ALLOC, FIXED, FREE, ADD, CREATE, DESTROY, HEAP, FRAME, NAME = range(1, 10)
+CLASSES = 20
+
+
+def size_class(size: int) -> int:
+    s = size >> 6
+    c = 0
+    while s > 1 and c < CLASSES - 1:
+        s >>= 1
+        c += 1
+    return c
+
+
+def class_label(c: int) -> str:
+    lo = 64 << c
+    if c == CLASSES - 1:
+        return f">={lo}"
+    return f"{lo}-{(128 << c) - 1}"
+
+
+class Heap:
+    def __init__(self):
+        self.size = None
+        self.allocs = 0
+        self.fixed = 0
+        self.failed = 0
+        self.frees = 0
+        self.live = {}  # user ptr -> (cell, size, tag, frame)
+        self.live_bytes = 0
+        self.peak_bytes = 0
+        self.peak_blocks = 0
+        self.peak_frame = 0
+        self.largest_failed = 0
+        self.classes = [[0, 0] for _ in range(CLASSES)]  # count, cell bytes
+        self.tags = defaultdict(lambda: [0, 0, 0, 0])  # allocs, bytes, live, peak live
+        self.frag = []  # (frame, free, largest, cells)
+
+
+def read_log(path: Path):
+    data = path.read_bytes()
+    if len(data) < 16 or data[:4] != MAGIC:
+        sys.exit(f"{path}: not an OSAlloc profiler log")
+    version, rec_size = struct.unpack_from("<II", data, 4)
+    if version != 1 or rec_size != RECORD.size:
+        sys.exit(f"{path}: unsupported log version {version} / record size {rec_size}")
+    names = {}
+    off = 16
+    while off + RECORD.size <= len(data):
+        kind, heap, tag, a, b, c = RECORD.unpack_from(data, off)
+        off += RECORD.size
+        if kind == NAME:
+            padded = (a + RECORD.size - 1) // RECORD.size * RECORD.size
+            names[tag] = data[off:off + a].decode("utf-8", "replace")
+            off += padded
+            continue
+        yield kind, heap, tag, a, b, c, names
+
+
+def summarize(path: Path, top: int, only_heap):
+    heaps = defaultdict(Heap)
+    names = {}
+    frame = 0
+    for kind, heap, tag, a, b, c, names in read_log(path):
+        if kind == FRAME:
+            frame = a + 1
+            continue
+        h = heaps[heap]
+        if kind in (ALLOC, FIXED):
+            if a == 0:
+                h.failed += 1
+                h.largest_failed = max(h.largest_failed, b)
+                continue
+            h.allocs += 1
+            h.fixed += kind == FIXED
+            h.live[a] = (c, b, tag, frame)
+            h.live_bytes += c
+            req = (b + 0x20 + 31) & ~31
+            h.classes[size_class(req)][0] += 1
+            h.classes[size_class(req)][1] += c
+            t = h.tags[tag]
+            t[0] += 1
+            t[1] += c
+            t[2] += c
+            t[3] = max(t[3], t[2])
+            if h.live_bytes > h.peak_bytes:
+                h.peak_bytes = h.live_bytes
+                h.peak_frame = frame
+            h.peak_blocks = max(h.peak_blocks, len(h.live))
+        elif kind == FREE:
+            h.frees += 1
+            if a not in h.live:
+                continue  # allocated before port_OSAllocProfStart
+            cell, _, alloc_tag, _ = h.live.pop(a)
+            h.live_bytes -= cell
+            h.tags[alloc_tag][2] -= cell
+        elif kind == CREATE:
+            heaps[heap] = Heap()
+            heaps[heap].size = b
+        elif kind == ADD:
+            h.size = (h.size or 0) + b
+        elif kind == DESTROY:
+            h.size = None
+        elif kind == HEAP:
+            h.frag.append((frame, a, b, c))
+
+    def tag_name(tag):
+        return names.get(tag, str(tag))
+
+    print(f"{path}: {frame} frame(s)")
+    for heap in sorted(heaps):
+        if heap == 0xFF or (only_heap is not None and heap != only_heap):
+            continue
+        h = heaps[heap]
+        size = "?" if h.size is None else f"{h.size:#x}"
+        print(f"\nheap {heap}: size {size}")
+        print(f"  allocs {h.allocs} (fixed {h.fixed})  failed {h.failed}  frees {h.frees}")
+        print(f"  peak live {h.peak_bytes:#x} bytes / {h.peak_blocks} blocks (frame {h.peak_frame})"
+              f"  end live {h.live_bytes:#x} bytes / {len(h.live)} blocks")
+        if h.size:
+            print(f"  peak use {100.0 * h.peak_bytes / h.size:.1f}%  headroom {h.size - h.peak_bytes:#x} bytes")
+        if h.failed:
+            print(f"  largest failed request {h.largest_failed:#x} bytes")
+
+        if h.frag:
+            fr = [(1.0 - largest / free if free else 0.0, f, free, largest, cells)
+                  for f, free, largest, cells in h.frag]
+            worst = max(fr)
+            avg = sum(x[0] for x in fr) / len(fr)
+            print(f"  fragmentation avg {avg:.3f}  worst {worst[0]:.3f} at frame {worst[1]}"
+                  f" (free {worst[2]:#x}, largest {worst[3]:#x}, {worst[4]} cells)")
+
+        print("  size class                 allocs  cell bytes")
+        for c, (count, nbytes) in enumerate(h.classes):
+            if count:
+                print(f"    {class_label(c):>24} {count:8} {nbytes:#11x}")
+
+        print("  tag                        allocs  cell bytes   peak live    end live")
+        for tag in sorted(h.tags):
+            t = h.tags[tag]
+            print(f"    {tag_name(tag):>24} {t[0]:8} {t[1]:#11x} {t[3]:#11x} {t[2]:#11x}")
+
+        if h.live:
+            by_frame = defaultdict(list)
+            for ptr, (cell, sz, tag, f) in h.live.items():
+                by_frame[f].append((cell, ptr, sz, tag))
+            print("  live at end, by allocating frame:")
+            for f in sorted(by_frame):
+                blocks = sorted(by_frame[f], reverse=True)
+                total = sum(x[0] for x in blocks)
+                print(f"    frame {f}: {len(blocks)} block(s), {total:#x} bytes")
+                for cell, ptr, sz, tag in blocks[:top]:
+                    print(f"      {ptr:#010x} size {sz:#x} cell {cell:#x} tag {tag_name(tag)}")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("log", type=Path)
+    ap.add_argument("--heap", type=int, default=None, help="only this heap")
+    ap.add_argument("--top", type=int, default=5, help="live blocks listed per frame (default 5)")
+    args = ap.parse_args()
+    summarize(args.log, args.top, args.heap)
+
+
+if __name__ == "__main__":
+    main()
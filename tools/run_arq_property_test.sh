@@ -72,6 +72,7 @@ echo "[arq-property-build] CC=$CC"
   "$test_src/arq_property_test.c" \
   "$port_src/arq.c" \
   "$gc_mem_src/gc_mem.c" \
+  "$gc_mem_src/gc_clock.c" \
   "${ld_gc_flags[@]}" \
   -o "$build_dir/arq_property_test"
 
@@ -0,0 +1,69 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Property test runner for the virtual clock (src/sdk_port/gc_clock.c).
+#
+# Oracle: naive scheduler inlined in the test file.
+# Port:   gc_clock.c, with OSAlarm.c attached as a clock source.
+#
+# Usage:
+#   tools/run_clock_property_test.sh [--seed=N] [--num-runs=N] [--op=L0..L4] [-v] [-Ox]
+
+repo_root="$(cd "$(dirname "$0")/.." && pwd)"
+build_dir="$repo_root/tests/build/clock_property"
+test_src="$repo_root/tests/sdk/os/clock/property"
+port_src="$repo_root/src/sdk_port/os"
+gc_mem_src="$repo_root/src/sdk_port"
+
+mkdir -p "$build_dir"
+
+args=()
+opt_flags=(-O1 -g)
+def_flags=()
+
+for arg in "$@"; do
+    case "$arg" in
+        -O*) opt_flags=("$arg") ;;
+        -D*) def_flags+=("$arg") ;;
+        *)   args+=("$arg") ;;
+    esac
+done
+
+ld_gc_flags=()
+case "$(uname -s)" in
+    Darwin) ld_gc_flags+=(-Wl,-dead_strip) ;;
+    *)      ld_gc_flags+=(-Wl,--gc-sections) ;;
+esac
+
+CC="${CC:-}"
+if [[ -z "$CC" ]]; then
+    for try in cc clang gcc; do
+        if command -v "$try" >/dev/null 2>&1; then CC="$try"; break; fi
+    done
+fi
+if [[ -z "$CC" ]]; then
+    for try in "/c/Program Files/LLVM/bin/clang" "/mingw64/bin/gcc"; do
+        if [[ -x "$try" ]]; then CC="$try"; break; fi
+    done
+fi
+if [[ -z "$CC" ]]; then
+    echo "ERROR: no C compiler found."
+    exit 2
+fi
+
+echo "[clock-property-build] CC=$CC"
+"$CC" "${opt_flags[@]}" "${def_flags[@]+"${def_flags[@]}"}" -ffunction-sections -fdata-sections \
+  -D_XOPEN_SOURCE=700 -D_CRT_SECURE_NO_WARNINGS \
+  -Wno-implicit-function-declaration \
+  -I"$port_src" \
+  -I"$gc_mem_src" \
+  "$test_src/gc_clock_property_test.c" \
+  "$port_src/OSAlarm.c" \
+  "$gc_mem_src/gc_clock.c" \
+  "$gc_mem_src/gc_mem.c" \
+  "${ld_gc_flags[@]}" \
+  -o "$build_dir/gc_clock_property_test"
+
+echo "[clock-property-build] OK -> $build_dir/gc_clock_property_test"
+echo ""
+"$build_dir/gc_clock_property_test" "${args[@]}"
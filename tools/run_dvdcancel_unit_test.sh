@@ -10,6 +10,7 @@ exe="$build_dir/dvdcancel_unit_test"
 cc -O2 -g0 -ffunction-sections -fdata-sections \
   -I"$repo_root/src" \
   "$repo_root/src/sdk_port/gc_mem.c" \
+  "$repo_root/src/sdk_port/gc_clock.c" \
   "$repo_root/src/sdk_port/dvd/DVD.c" \
   "$repo_root/tests/sdk/dvd/property/dvdcancel_unit_test.c" \
   -Wl,-dead_strip \
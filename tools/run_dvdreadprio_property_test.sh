@@ -49,6 +49,7 @@ echo "[dvdreadprio-property-build] CC=$CC"
   "$test_src/dvdreadprio_property_test.c" \
   "$dvd_src/DVD.c" \
   "$sdk_src/gc_mem.c" \
+  "$sdk_src/gc_clock.c" \
   "${ld_gc_flags[@]}" \
   -o "$build_dir/dvdreadprio_property_test"
 
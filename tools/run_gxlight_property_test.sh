@@ -58,6 +58,16 @@ echo "[gxlight-property-build] CC=$CC"
   -I"$gc_mem_src" \
   "$test_src/gxlight_property_test.c" \
   "$port_src/GX.c" \
+  "$port_src/gx_gp.c" \
+  "$port_src/gx_dl.c" \
+  "$port_src/gx_vtx.c" \
+  "$port_src/gx_xf.c" \
+  "$port_src/gx_raster.c" \
+  "$port_src/gx_texdec.c" \
+  "$port_src/gx_texcopy.c" \
+  "$port_src/gx_xfb.c" \
+  "$port_src/gx_tmem.c" \
+  "$port_src/gx_fifo.c" \
   "$gc_mem_src/gc_mem.c" \
   "${ld_gc_flags[@]}" \
   -o "$build_dir/gxlight_property_test"
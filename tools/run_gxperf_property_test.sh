@@ -0,0 +1,80 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Property test runner for the GX performance metrics.
+#
+# Builds a single host binary that contains BOTH:
+# - Oracle: closed-form vertex cache, pixel and copy counts
+# - Port:   GXRead*Metric counters fed from the pipeline (GX.c)
+#
+# Usage:
+#   tools/run_gxperf_property_test.sh [--seed=N] [--num-runs=N] [--op=L0..L2] [-v]
+
+repo_root="$(cd "$(dirname "$0")/.." && pwd)"
+build_dir="$repo_root/tests/build/gxperf_property"
+test_src="$repo_root/tests/sdk/gx/property"
+port_src="$repo_root/src/sdk_port/gx"
+gc_mem_src="$repo_root/src/sdk_port"
+
+mkdir -p "$build_dir"
+
+args=()
+opt_flags=(-O1 -g)
+
+for arg in "$@"; do
+    case "$arg" in
+        -O*) opt_flags=("$arg") ;;
+        *)   args+=("$arg") ;;
+    esac
+done
+
+ld_gc_flags=()
+case "$(uname -s)" in
+    Darwin) ld_gc_flags+=(-Wl,-dead_strip) ;;
+    *)      ld_gc_flags+=(-Wl,--gc-sections) ;;
+esac
+
+CC="${CC:-}"
+if [[ -z "$CC" ]]; then
+    for try in cc clang gcc; do
+        if command -v "$try" >/dev/null 2>&1; then CC="$try"; break; fi
+    done
+fi
+if [[ -z "$CC" ]]; then
+    for try in "/c/Program Files/LLVM/bin/clang" "/mingw64/bin/gcc"; do
+        if [[ -x "$try" ]]; then CC="$try"; break; fi
+    done
+fi
+if [[ -z "$CC" ]]; then
+    echo "ERROR: no C compiler found."
+    exit 2
+fi
+
+echo "[gxperf-property-build] CC=$CC"
+"$CC" "${opt_flags[@]}" -ffunction-sections -fdata-sections \
+  -D_XOPEN_SOURCE=700 -D_CRT_SECURE_NO_WARNINGS \
+  -Wno-implicit-function-declaration \
+  -DGC_GX_XF_THREADS -DGC_GX_RASTER_THREADS -pthread \
+  -I"$port_src" \
+  -I"$gc_mem_src" \
+  "$test_src/gxperf_property_test.c" \
+  "$port_src/GX.c" \
+  "$port_src/gx_gp.c" \
+  "$port_src/gx_dl.c" \
+  "$port_src/gx_vtx.c" \
+  "$port_src/gx_xf.c" \
+  "$port_src/gx_raster.c" \
+  "$port_src/gx_texdec.c" \
+  "$port_src/gx_texcopy.c" \
+  "$port_src/gx_xfb.c" \
+  "$port_src/gx_tmem.c" \
+  "$port_src/gx_fifo.c" \
+  "$gc_mem_src/gc_mem.c" \
+  "$gc_mem_src/os/OSCache.c" \
+  "${ld_gc_flags[@]}" \
+  -lm \
+  -o "$build_dir/gxperf_property_test"
+
+echo "[gxperf-property-build] OK -> $build_dir/gxperf_property_test"
+echo ""
+"$build_dir/gxperf_property_test" "${args[@]}"
@@ -52,6 +52,16 @@ echo "[gxtexture-property-build] CC=$CC"
   -I"$repo_root/src/sdk_port" \
   "$test_src/gxtexture_property_test.c" \
   "$repo_root/src/sdk_port/gx/GX.c" \
+  "$repo_root/src/sdk_port/gx/gx_gp.c" \
+  "$repo_root/src/sdk_port/gx/gx_dl.c" \
+  "$repo_root/src/sdk_port/gx/gx_vtx.c" \
+  "$repo_root/src/sdk_port/gx/gx_xf.c" \
+  "$repo_root/src/sdk_port/gx/gx_raster.c" \
+  "$repo_root/src/sdk_port/gx/gx_texdec.c" \
+  "$repo_root/src/sdk_port/gx/gx_texcopy.c" \
+  "$repo_root/src/sdk_port/gx/gx_xfb.c" \
+  "$repo_root/src/sdk_port/gx/gx_tmem.c" \
+  "$repo_root/src/sdk_port/gx/gx_fifo.c" \
   "$repo_root/src/sdk_port/gc_mem.c" \
   "${ld_gc_flags[@]}" \
   -o "$build_dir/gxtexture_property_test"
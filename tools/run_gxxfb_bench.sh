@@ -0,0 +1,56 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Benchmark runner for the GX EFB to XFB display copy.
+#
+# Builds the bench at -O2 with thread support and reports milliseconds per
+# 640x480 copy: reference, vector on one thread, vector on N threads.
+#
+# Usage:
+#   tools/run_gxxfb_bench.sh [--copies=N] [--threads=N]
+
+repo_root="$(cd "$(dirname "$0")/.." && pwd)"
+build_dir="$repo_root/tests/build/gxxfb_bench"
+bench_src="$repo_root/tests/sdk/gx/bench"
+port_src="$repo_root/src/sdk_port/gx"
+gc_mem_src="$repo_root/src/sdk_port"
+
+mkdir -p "$build_dir"
+
+CC="${CC:-}"
+if [[ -z "$CC" ]]; then
+    for try in cc clang gcc; do
+        if command -v "$try" >/dev/null 2>&1; then CC="$try"; break; fi
+    done
+fi
+if [[ -z "$CC" ]]; then
+    echo "ERROR: no C compiler found."
+    exit 2
+fi
+
+echo "[gxxfb-bench-build] CC=$CC"
+"$CC" -O2 -g \
+  -D_XOPEN_SOURCE=700 -D_CRT_SECURE_NO_WARNINGS \
+  -Wno-implicit-function-declaration \
+  -DGC_GX_XF_THREADS -DGC_GX_RASTER_THREADS -DGC_GX_XFB_THREADS -pthread \
+  -I"$port_src" \
+  -I"$gc_mem_src" \
+  "$bench_src/gxxfb_bench.c" \
+  "$port_src/GX.c" \
+  "$port_src/gx_gp.c" \
+  "$port_src/gx_dl.c" \
+  "$port_src/gx_vtx.c" \
+  "$port_src/gx_xf.c" \
+  "$port_src/gx_raster.c" \
+  "$port_src/gx_texdec.c" \
+  "$port_src/gx_texcopy.c" \
+  "$port_src/gx_xfb.c" \
+  "$port_src/gx_tmem.c" \
+  "$port_src/gx_fifo.c" \
+  "$gc_mem_src/gc_mem.c" \
+  "$gc_mem_src/os/OSCache.c" \
+  -lm \
+  -o "$build_dir/gxxfb_bench"
+
+echo "[gxxfb-bench-build] OK -> $build_dir/gxxfb_bench"
+"$build_dir/gxxfb_bench" "$@"
@@ -0,0 +1,56 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Benchmark runner for the batch Z16 compression kernels.
+#
+# Builds the bench at -O2 and reports Mpixels/s for each 16-bit Z format,
+# scalar GXCompressZ16/GXDecompressZ16 loop vs the batch kernels.
+#
+# Usage:
+#   tools/run_gxz16_bench.sh [--passes=N]
+
+repo_root="$(cd "$(dirname "$0")/.." && pwd)"
+build_dir="$repo_root/tests/build/gxz16_bench"
+bench_src="$repo_root/tests/sdk/gx/bench"
+port_src="$repo_root/src/sdk_port/gx"
+gc_mem_src="$repo_root/src/sdk_port"
+
+mkdir -p "$build_dir"
+
+CC="${CC:-}"
+if [[ -z "$CC" ]]; then
+    for try in cc clang gcc; do
+        if command -v "$try" >/dev/null 2>&1; then CC="$try"; break; fi
+    done
+fi
+if [[ -z "$CC" ]]; then
+    echo "ERROR: no C compiler found."
+    exit 2
+fi
+
+echo "[gxz16-bench-build] CC=$CC"
+"$CC" -O2 -g \
+  -D_XOPEN_SOURCE=700 -D_CRT_SECURE_NO_WARNINGS \
+  -Wno-implicit-function-declaration \
+  -I"$port_src" \
+  -I"$gc_mem_src" \
+  "$bench_src/gxz16_bench.c" \
+  "$port_src/GX.c" \
+  "$port_src/gx_gp.c" \
+  "$port_src/gx_dl.c" \
+  "$port_src/gx_vtx.c" \
+  "$port_src/gx_xf.c" \
+  "$port_src/gx_raster.c" \
+  "$port_src/gx_texdec.c" \
+  "$port_src/gx_texcopy.c" \
+  "$port_src/gx_xfb.c" \
+  "$port_src/gx_tmem.c" \
+  "$port_src/gx_fifo.c" \
+  "$port_src/gx_z16.c" \
+  "$gc_mem_src/gc_mem.c" \
+  "$gc_mem_src/os/OSCache.c" \
+  -lm \
+  -o "$build_dir/gxz16_bench"
+
+echo "[gxz16-bench-build] OK -> $build_dir/gxz16_bench"
+"$build_dir/gxz16_bench" "$@"
@@ -5,7 +5,8 @@ set -euo pipefail
 #
 # Builds a single host binary that contains BOTH:
 # - Oracle: decomp Z16 functions inlined in test file
-# - Port:   sdk_port GXCompressZ16/GXDecompressZ16 (GX.c)
+# - Port:   sdk_port GXCompressZ16/GXDecompressZ16 (GX.c) and the batch
+#           kernels (gx_z16.c)
 #
 # Usage:
 #   tools/run_gxz16_property_test.sh [--seed=N] [--num-runs=N] [-v]
@@ -58,6 +59,17 @@ echo "[gxz16-property-build] CC=$CC"
   -I"$gc_mem_src" \
   "$test_src/gxz16_property_test.c" \
   "$port_src/GX.c" \
+  "$port_src/gx_gp.c" \
+  "$port_src/gx_dl.c" \
+  "$port_src/gx_vtx.c" \
+  "$port_src/gx_xf.c" \
+  "$port_src/gx_raster.c" \
+  "$port_src/gx_texdec.c" \
+  "$port_src/gx_texcopy.c" \
+  "$port_src/gx_xfb.c" \
+  "$port_src/gx_tmem.c" \
+  "$port_src/gx_fifo.c" \
+  "$port_src/gx_z16.c" \
   "$gc_mem_src/gc_mem.c" \
   "${ld_gc_flags[@]}" \
   -o "$build_dir/gxz16_property_test"
@@ -199,6 +199,16 @@ case "$subsystem" in
 	      "$repo_root/src/sdk_port/os/OSStopwatch.c"
 	      "$repo_root/src/sdk_port/os/OSModule.c"
 	    )
+	    # GC_OS_STOPWATCH_PROFILE=path writes the stopwatch profiler table
+	    # (src/sdk_port/os/OSStopwatch.h) after the scenario.
+	    if [[ -n "${GC_OS_STOPWATCH_PROFILE:-}" ]]; then
+	      case "$GC_OS_STOPWATCH_PROFILE" in
+	        /*) ;;
+	        *) GC_OS_STOPWATCH_PROFILE="$PWD/$GC_OS_STOPWATCH_PROFILE" ;;
+	      esac
+	      export GC_OS_STOPWATCH_PROFILE
+	      extra_cflags+=(-DGC_OSSTOPWATCH_PROFILE=1)
+	    fi
 	    ;;
 	esac
 
@@ -238,7 +248,27 @@ case "$subsystem" in
   gx|os+dvd+vi+pad+gx|os+dvd+vi+pad+gx+mtx)
     port_srcs+=(
       "$repo_root/src/sdk_port/gx/GX.c"
+      "$repo_root/src/sdk_port/gx/gx_gp.c"
+      "$repo_root/src/sdk_port/gx/gx_dl.c"
+      "$repo_root/src/sdk_port/gx/gx_vtx.c"
+      "$repo_root/src/sdk_port/gx/gx_xf.c"
+      "$repo_root/src/sdk_port/gx/gx_raster.c"
+      "$repo_root/src/sdk_port/gx/gx_texdec.c"
+      "$repo_root/src/sdk_port/gx/gx_texcopy.c"
+      "$repo_root/src/sdk_port/gx/gx_xfb.c"
+      "$repo_root/src/sdk_port/gx/gx_tmem.c"
+      "$repo_root/src/sdk_port/gx/gx_fifo.c"
     )
+    # GC_GX_TRACE=path records the scenario's GX command stream (.gxtrace).
+    if [[ -n "${GC_GX_TRACE:-}" ]]; then
+      case "$GC_GX_TRACE" in
+        /*) ;;
+        *) GC_GX_TRACE="$PWD/$GC_GX_TRACE" ;;
+      esac
+      export GC_GX_TRACE
+      port_srcs+=("$repo_root/src/sdk_port/gx/gx_trace.c")
+      extra_cflags+=(-DGC_HOST_GX_TRACE=1)
+    fi
     ;;
 esac
 
@@ -351,6 +381,7 @@ cc "${opt_flags[@]}" -ffunction-sections -fdata-sections \
   "$repo_root/tests/harness/gc_host_ram.c" \
   "$repo_root/tests/harness/gc_host_runner.c" \
   "$repo_root/src/sdk_port/gc_mem.c" \
+  "$repo_root/src/sdk_port/gc_clock.c" \
   "${port_srcs[@]}" \
   "${extra_srcs[@]+${extra_srcs[@]}}" \
   "$SCENARIO_SRC" \
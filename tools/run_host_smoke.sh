@@ -29,6 +29,7 @@ cc -O2 -g \
   -I"$repo_root/src/sdk_port" \
   "$repo_root/tests/harness/gc_host_ram.c" \
   "$repo_root/src/sdk_port/gc_mem.c" \
+  "$repo_root/src/sdk_port/gc_clock.c" \
   "$repo_root/src/sdk_port/os/OSArena.c" \
   "$repo_root/src/sdk_port/os/OSCache.c" \
   "$repo_root/src/sdk_port/os/OSAlloc.c" \
@@ -43,6 +44,16 @@ cc -O2 -g \
   "$repo_root/src/sdk_port/vi/VI.c" \
   "$repo_root/src/sdk_port/pad/PAD.c" \
   "$repo_root/src/sdk_port/gx/GX.c" \
+  "$repo_root/src/sdk_port/gx/gx_gp.c" \
+  "$repo_root/src/sdk_port/gx/gx_dl.c" \
+  "$repo_root/src/sdk_port/gx/gx_vtx.c" \
+  "$repo_root/src/sdk_port/gx/gx_xf.c" \
+  "$repo_root/src/sdk_port/gx/gx_raster.c" \
+  "$repo_root/src/sdk_port/gx/gx_texdec.c" \
+  "$repo_root/src/sdk_port/gx/gx_texcopy.c" \
+  "$repo_root/src/sdk_port/gx/gx_xfb.c" \
+  "$repo_root/src/sdk_port/gx/gx_tmem.c" \
+  "$repo_root/src/sdk_port/gx/gx_fifo.c" \
   "$repo_root/src/sdk_port/dvd/DVD.c" \
   "$SCENARIO_SRC" \
   -o "$exe"
@@ -0,0 +1,50 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Benchmark runner for the OSAlarm queue.
+#
+# Builds the bench at -O2 twice, with the alarm index and with
+# GC_OSALARM_LINEAR (InsertAlarm's list walk), and reports ns/op for
+# set/cancel and fire/re-insert at 100 .. --max queued alarms.
+#
+# Usage:
+#   tools/run_osalarm_bench.sh [--max=N] [--ops=N]
+
+repo_root="$(cd "$(dirname "$0")/.." && pwd)"
+build_dir="$repo_root/tests/build/osalarm_bench"
+bench_src="$repo_root/tests/sdk/os/osalarm/bench"
+port_src="$repo_root/src/sdk_port/os"
+gc_mem_src="$repo_root/src/sdk_port"
+
+mkdir -p "$build_dir"
+
+CC="${CC:-}"
+if [[ -z "$CC" ]]; then
+    for try in cc clang gcc; do
+        if command -v "$try" >/dev/null 2>&1; then CC="$try"; break; fi
+    done
+fi
+if [[ -z "$CC" ]]; then
+    echo "ERROR: no C compiler found."
+    exit 2
+fi
+
+echo "[osalarm-bench-build] CC=$CC"
+for variant in index linear; do
+    defs=()
+    [[ "$variant" == linear ]] && defs+=(-DGC_OSALARM_LINEAR)
+    "$CC" -O2 -g "${defs[@]+"${defs[@]}"}" \
+      -D_XOPEN_SOURCE=700 -D_CRT_SECURE_NO_WARNINGS \
+      -Wno-implicit-function-declaration \
+      -I"$port_src" \
+      -I"$gc_mem_src" \
+      "$bench_src/osalarm_bench.c" \
+      "$port_src/OSAlarm.c" \
+      "$gc_mem_src/gc_clock.c" \
+      "$gc_mem_src/gc_mem.c" \
+      -o "$build_dir/osalarm_bench_$variant"
+done
+
+echo "[osalarm-bench-build] OK -> $build_dir/osalarm_bench_{index,linear}"
+"$build_dir/osalarm_bench_index" "$@"
+"$build_dir/osalarm_bench_linear" "$@"
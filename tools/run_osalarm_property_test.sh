@@ -7,7 +7,7 @@ set -euo pipefail
 # Port:   linked from src/sdk_port/os/OSAlarm.c.
 #
 # Usage:
-#   tools/run_osalarm_property_test.sh [--seed=N] [--num-runs=N] [-v]
+#   tools/run_osalarm_property_test.sh [--seed=N] [--num-runs=N] [-v] [-Ox] [-DGC_OSALARM_LINEAR]
 
 repo_root="$(cd "$(dirname "$0")/.." && pwd)"
 build_dir="$repo_root/tests/build/osalarm_property"
@@ -19,10 +19,12 @@ mkdir -p "$build_dir"
 
 args=()
 opt_flags=(-O1 -g)
+def_flags=()
 
 for arg in "$@"; do
     case "$arg" in
         -O*) opt_flags=("$arg") ;;
+        -D*) def_flags+=("$arg") ;;
         *)   args+=("$arg") ;;
     esac
 done
@@ -50,13 +52,14 @@ if [[ -z "$CC" ]]; then
 fi
 
 echo "[osalarm-property-build] CC=$CC"
-"$CC" "${opt_flags[@]}" -ffunction-sections -fdata-sections \
+"$CC" "${opt_flags[@]}" "${def_flags[@]+"${def_flags[@]}"}" -ffunction-sections -fdata-sections \
   -D_XOPEN_SOURCE=700 -D_CRT_SECURE_NO_WARNINGS \
   -Wno-implicit-function-declaration \
   -I"$port_src" \
   -I"$gc_mem_src" \
   "$test_src/osalarm_property_test.c" \
   "$port_src/OSAlarm.c" \
+  "$gc_mem_src/gc_clock.c" \
   "$gc_mem_src/gc_mem.c" \
   "${ld_gc_flags[@]}" \
   -o "$build_dir/osalarm_property_test"
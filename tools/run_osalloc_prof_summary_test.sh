@@ -0,0 +1,6 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+repo_root="$(cd "$(dirname "$0")/.." && pwd)"
+
+python3 "$repo_root/tests/sdk/os/os_alloc/property/osalloc_prof_summary_test.py"
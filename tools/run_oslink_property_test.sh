@@ -0,0 +1,71 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Property test runner for the REL linker (port_OSLinkRel in
+# src/sdk_port/os/OSModule.c).
+#
+# Oracle: decomp Link / Relocate / Undo inlined in the test file.
+# Port:   OSModule.c; pass -DGC_OSLINK_NO_PLAN to test the stream walk
+#         instead of fixup plans.
+#
+# Usage:
+#   tools/run_oslink_property_test.sh [--seed=N] [--num-runs=N] [--op=L0..L5] [-v] [-Ox] [-DGC_OSLINK_NO_PLAN]
+
+repo_root="$(cd "$(dirname "$0")/.." && pwd)"
+build_dir="$repo_root/tests/build/oslink_property"
+test_src="$repo_root/tests/sdk/os/oslink/property"
+port_src="$repo_root/src/sdk_port/os"
+gc_mem_src="$repo_root/src/sdk_port"
+
+mkdir -p "$build_dir"
+
+args=()
+opt_flags=(-O1 -g)
+def_flags=()
+
+for arg in "$@"; do
+    case "$arg" in
+        -O*) opt_flags=("$arg") ;;
+        -D*) def_flags+=("$arg") ;;
+        *)   args+=("$arg") ;;
+    esac
+done
+
+ld_gc_flags=()
+case "$(uname -s)" in
+    Darwin) ld_gc_flags+=(-Wl,-dead_strip) ;;
+    *)      ld_gc_flags+=(-Wl,--gc-sections) ;;
+esac
+
+CC="${CC:-}"
+if [[ -z "$CC" ]]; then
+    for try in cc clang gcc; do
+        if command -v "$try" >/dev/null 2>&1; then CC="$try"; break; fi
+    done
+fi
+if [[ -z "$CC" ]]; then
+    for try in "/c/Program Files/LLVM/bin/clang" "/mingw64/bin/gcc"; do
+        if [[ -x "$try" ]]; then CC="$try"; break; fi
+    done
+fi
+if [[ -z "$CC" ]]; then
+    echo "ERROR: no C compiler found."
+    exit 2
+fi
+
+echo "[oslink-property-build] CC=$CC"
+"$CC" "${opt_flags[@]}" "${def_flags[@]+"${def_flags[@]}"}" -ffunction-sections -fdata-sections \
+  -D_XOPEN_SOURCE=700 -D_CRT_SECURE_NO_WARNINGS \
+  -Wno-implicit-function-declaration \
+  -I"$port_src" \
+  -I"$gc_mem_src" \
+  -I"$repo_root/tests/workload/include" \
+  "$test_src/oslink_property_test.c" \
+  "$port_src/OSModule.c" \
+  "$gc_mem_src/gc_mem.c" \
+  "${ld_gc_flags[@]}" \
+  -o "$build_dir/oslink_property_test"
+
+echo "[oslink-property-build] OK -> $build_dir/oslink_property_test"
+echo ""
+"$build_dir/oslink_property_test" "${args[@]}"
@@ -58,6 +58,7 @@ echo "[padclamp-property-build] CC=$CC"
   "$test_src/padclamp_property_test.c" \
   "$port_src/PAD.c" \
   "$gc_mem_src/gc_mem.c" \
+  "$gc_mem_src/gc_clock.c" \
   "${ld_gc_flags[@]}" \
   -o "$build_dir/padclamp_property_test"
 
@@ -70,6 +70,8 @@ case "$suite" in
   os_module_queue)
     cc -O2 -g0 \
       -I"$repo_root/src" -I"$repo_root/src/sdk_port" -I"$repo_root/tests/workload/include" \
+      "$repo_root/src/sdk_port/gc_mem.c" \
+      "$repo_root/src/sdk_port/os/OSError.c" \
       "$repo_root/src/sdk_port/os/OSModule.c" \
       "$repo_root/tests/pbt/os/os_module_queue/os_module_queue_pbt.c" \
       -o "$build_dir/os_module_queue_pbt"
@@ -79,6 +81,7 @@ case "$suite" in
     cc -O2 -g0 \
       -I"$repo_root/src" -I"$repo_root/src/sdk_port" -I"$repo_root/tests/workload/include" \
       "$repo_root/src/sdk_port/gc_mem.c" \
+      "$repo_root/src/sdk_port/gc_clock.c" \
       "$repo_root/src/sdk_port/os/OSInterrupts.c" \
       "$repo_root/src/sdk_port/vi/VI.c" \
       "$repo_root/src/sdk_port/si/SI.c" \
@@ -91,6 +94,7 @@ case "$suite" in
     cc -O2 -g0 \
       -I"$repo_root/src" -I"$repo_root/src/sdk_port" -I"$repo_root/tests/workload/include" \
       "$repo_root/src/sdk_port/gc_mem.c" \
+      "$repo_root/src/sdk_port/gc_clock.c" \
       "$repo_root/src/sdk_port/os/OSInterrupts.c" \
       "$repo_root/src/sdk_port/vi/VI.c" \
       "$repo_root/src/sdk_port/si/SI.c" \
@@ -103,6 +107,7 @@ case "$suite" in
     cc -O2 -g0 \
       -I"$repo_root/src" -I"$repo_root/src/sdk_port" -I"$repo_root/tests/workload/include" \
       "$repo_root/src/sdk_port/gc_mem.c" \
+      "$repo_root/src/sdk_port/gc_clock.c" \
       "$repo_root/src/sdk_port/os/OSInterrupts.c" \
       "$repo_root/src/sdk_port/vi/VI.c" \
       "$repo_root/src/sdk_port/si/SI.c" \
@@ -115,6 +120,7 @@ case "$suite" in
     cc -O2 -g0 \
       -I"$repo_root/src" -I"$repo_root/src/sdk_port" -I"$repo_root/tests/workload/include" \
       "$repo_root/src/sdk_port/gc_mem.c" \
+      "$repo_root/src/sdk_port/gc_clock.c" \
       "$repo_root/src/sdk_port/pad/PAD.c" \
       "$repo_root/src/sdk_port/si/SI.c" \
       "$repo_root/src/sdk_port/vi/VI.c" \
@@ -128,6 +134,7 @@ case "$suite" in
     cc -O2 -g0 \
       -I"$repo_root/src" -I"$repo_root/src/sdk_port" -I"$repo_root/tests/workload/include" \
       "$repo_root/src/sdk_port/gc_mem.c" \
+      "$repo_root/src/sdk_port/gc_clock.c" \
       "$repo_root/src/sdk_port/os/OSInterrupts.c" \
       "$repo_root/src/sdk_port/vi/VI.c" \
       "$repo_root/tests/pbt/vi/vi_post_retrace_callback/vi_post_retrace_callback_pbt.c" \
@@ -138,6 +145,7 @@ case "$suite" in
     cc -O2 -g0 \
       -I"$repo_root/src" -I"$repo_root/src/sdk_port" -I"$repo_root/tests/workload/include" \
       "$repo_root/src/sdk_port/gc_mem.c" \
+      "$repo_root/src/sdk_port/gc_clock.c" \
       "$repo_root/src/sdk_port/pad/PAD.c" \
       "$repo_root/src/sdk_port/si/SI.c" \
       "$repo_root/src/sdk_port/vi/VI.c" \
@@ -151,6 +159,7 @@ case "$suite" in
     cc -O2 -g0 \
       -I"$repo_root/src" -I"$repo_root/src/sdk_port" \
       "$repo_root/src/sdk_port/gc_mem.c" \
+      "$repo_root/src/sdk_port/gc_clock.c" \
       "$repo_root/src/sdk_port/dvd/DVD.c" \
       "$repo_root/tests/pbt/dvd/dvd_read_prio/dvd_read_prio_pbt.c" \
       -o "$build_dir/dvd_read_prio_pbt"
@@ -160,6 +169,7 @@ case "$suite" in
     cc -O2 -g0 \
       -I"$repo_root/src" -I"$repo_root/src/sdk_port" \
       "$repo_root/src/sdk_port/gc_mem.c" \
+      "$repo_root/src/sdk_port/gc_clock.c" \
       "$repo_root/src/sdk_port/dvd/DVD.c" \
       "$repo_root/tests/pbt/dvd/dvd_read_async_prio/dvd_read_async_prio_pbt.c" \
       -o "$build_dir/dvd_read_async_prio_pbt"
@@ -169,6 +179,7 @@ case "$suite" in
     cc -O2 -g0 \
       -I"$repo_root/src" -I"$repo_root/src/sdk_port" \
       "$repo_root/src/sdk_port/gc_mem.c" \
+      "$repo_root/src/sdk_port/gc_clock.c" \
       "$repo_root/src/sdk_port/dvd/DVD.c" \
       "$repo_root/tests/pbt/dvd/dvd_convert_path/dvd_convert_path_pbt.c" \
       -o "$build_dir/dvd_convert_path_pbt"
@@ -179,6 +190,16 @@ case "$suite" in
       -I"$repo_root/src" -I"$repo_root/src/sdk_port" -I"$repo_root/tests/workload/include" \
       "$repo_root/src/sdk_port/gc_mem.c" \
       "$repo_root/src/sdk_port/gx/GX.c" \
+      "$repo_root/src/sdk_port/gx/gx_gp.c" \
+      "$repo_root/src/sdk_port/gx/gx_dl.c" \
+      "$repo_root/src/sdk_port/gx/gx_vtx.c" \
+      "$repo_root/src/sdk_port/gx/gx_xf.c" \
+      "$repo_root/src/sdk_port/gx/gx_raster.c" \
+      "$repo_root/src/sdk_port/gx/gx_texdec.c" \
+      "$repo_root/src/sdk_port/gx/gx_texcopy.c" \
+      "$repo_root/src/sdk_port/gx/gx_xfb.c" \
+      "$repo_root/src/sdk_port/gx/gx_tmem.c" \
+      "$repo_root/src/sdk_port/gx/gx_fifo.c" \
       "$repo_root/tests/pbt/gx/gx_texcopy_relation/gx_texcopy_relation_pbt.c" \
       -o "$build_dir/gx_texcopy_relation_pbt"
     "$build_dir/gx_texcopy_relation_pbt" "$iters" "$seed"
@@ -188,6 +209,16 @@ case "$suite" in
       -I"$repo_root/src" -I"$repo_root/src/sdk_port" -I"$repo_root/tests/workload/include" \
       "$repo_root/src/sdk_port/gc_mem.c" \
       "$repo_root/src/sdk_port/gx/GX.c" \
+      "$repo_root/src/sdk_port/gx/gx_gp.c" \
+      "$repo_root/src/sdk_port/gx/gx_dl.c" \
+      "$repo_root/src/sdk_port/gx/gx_vtx.c" \
+      "$repo_root/src/sdk_port/gx/gx_xf.c" \
+      "$repo_root/src/sdk_port/gx/gx_raster.c" \
+      "$repo_root/src/sdk_port/gx/gx_texdec.c" \
+      "$repo_root/src/sdk_port/gx/gx_texcopy.c" \
+      "$repo_root/src/sdk_port/gx/gx_xfb.c" \
+      "$repo_root/src/sdk_port/gx/gx_tmem.c" \
+      "$repo_root/src/sdk_port/gx/gx_fifo.c" \
       "$repo_root/tests/pbt/gx/gx_vtxdesc_packing/gx_vtxdesc_packing_pbt.c" \
       -o "$build_dir/gx_vtxdesc_packing_pbt"
     "$build_dir/gx_vtxdesc_packing_pbt" "$iters" "$seed"
@@ -197,6 +228,16 @@ case "$suite" in
       -I"$repo_root/src" -I"$repo_root/src/sdk_port" -I"$repo_root/tests/workload/include" \
       "$repo_root/src/sdk_port/gc_mem.c" \
       "$repo_root/src/sdk_port/gx/GX.c" \
+      "$repo_root/src/sdk_port/gx/gx_gp.c" \
+      "$repo_root/src/sdk_port/gx/gx_dl.c" \
+      "$repo_root/src/sdk_port/gx/gx_vtx.c" \
+      "$repo_root/src/sdk_port/gx/gx_xf.c" \
+      "$repo_root/src/sdk_port/gx/gx_raster.c" \
+      "$repo_root/src/sdk_port/gx/gx_texdec.c" \
+      "$repo_root/src/sdk_port/gx/gx_texcopy.c" \
+      "$repo_root/src/sdk_port/gx/gx_xfb.c" \
+      "$repo_root/src/sdk_port/gx/gx_tmem.c" \
+      "$repo_root/src/sdk_port/gx/gx_fifo.c" \
       "$repo_root/tests/pbt/gx/gx_alpha_tev_packing/gx_alpha_tev_packing_pbt.c" \
       -o "$build_dir/gx_alpha_tev_packing_pbt"
     "$build_dir/gx_alpha_tev_packing_pbt" "$iters" "$seed"
@@ -217,6 +258,7 @@ case "$suite" in
     cc -O2 -g0 \
       -I"$repo_root/src" -I"$repo_root/src/sdk_port" \
       "$repo_root/src/sdk_port/gc_mem.c" \
+      "$repo_root/src/sdk_port/gc_clock.c" \
       "$repo_root/src/sdk_port/dvd/DVD.c" \
       "$repo_root/tests/pbt/dvd/dvd_core_pbt.c" \
       -o "$build_dir/dvd_core_pbt"
@@ -39,6 +39,7 @@ echo "[property-build] dvdfs_property_test (CC=$CC)"
   -I"$repo_root/src/sdk_port" \
   "$repo_root/tests/sdk/dvd/dvdfs/property/dvdfs_property_test.c" \
   "$repo_root/src/sdk_port/gc_mem.c" \
+  "$repo_root/src/sdk_port/gc_clock.c" \
   "$repo_root/src/sdk_port/dvd/DVD.c" \
   "${ld_gc_flags[@]}" \
   -o "$exe"
@@ -71,6 +71,7 @@ fi
 echo "[property-build] osalloc_property_test (CC=$CC)"
 "$CC" "${opt_flags[@]}" -ffunction-sections -fdata-sections \
   -D_XOPEN_SOURCE=700 -D_CRT_SECURE_NO_WARNINGS \
+  -DGC_OSALLOC_CHECK_THREADS -pthread \
   -Wno-implicit-function-declaration \
   -I"$repo_root/tests" \
   -I"$repo_root/tests/harness" \
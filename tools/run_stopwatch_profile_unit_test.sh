@@ -0,0 +1,25 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+repo_root="$(cd "$(dirname "$0")/.." && pwd)"
+build_dir="$repo_root/tests/build/stopwatch_profile_unit"
+mkdir -p "$build_dir"
+
+exe="$build_dir/stopwatch_profile_unit_test"
+
+ld_gc_flags=()
+case "$(uname -s)" in
+    Darwin) ld_gc_flags+=(-Wl,-dead_strip) ;;
+    *)      ld_gc_flags+=(-Wl,--gc-sections) ;;
+esac
+
+cc -O2 -g0 -ffunction-sections -fdata-sections \
+  -D_XOPEN_SOURCE=700 -DGC_OSSTOPWATCH_PROFILE=1 \
+  -I"$repo_root/src" \
+  "$repo_root/src/sdk_port/gc_clock.c" \
+  "$repo_root/src/sdk_port/os/OSStopwatch.c" \
+  "$repo_root/tests/sdk/os/stopwatch/property/stopwatch_profile_unit_test.c" \
+  "${ld_gc_flags[@]}" \
+  -o "$exe"
+
+"$exe"